@@ -0,0 +1,166 @@
+#pragma once
+
+/**
+ * @file bench.hpp
+ * @brief Minimal benchmark harness for finevk-bench
+ *
+ * Each source file registers its benchmarks from a static Registrar; a
+ * benchmark receives the shared device context plus a State that times its
+ * body:
+ *
+ * @code
+ * void registerUploads() {
+ *     for (VkDeviceSize size : {4096ull, 65536ull}) {
+ *         bench::add("buffer/upload/" + std::to_string(size), [size](bench::Context& ctx, bench::State& state) {
+ *             auto buffer = ...;                  // Setup is not timed
+ *             state.setBytesPerIteration(size);
+ *             state.run([&] { buffer->upload(data, size); });
+ *         });
+ *     }
+ * }
+ * const bench::Registrar registrar(registerUploads);
+ * @endcode
+ *
+ * run() warms the body up, grows the batch size until one batch takes a
+ * tenth of the minimum time, then times ten batches and reports per
+ * iteration statistics over them. Results go to stdout and, with --json,
+ * to a file for regression tracking.
+ */
+
+#include <finevk/finevk.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace finevk {
+namespace bench {
+
+/// Device shared by every benchmark (headless, no validation)
+struct Context {
+    InstancePtr instance;
+    PhysicalDevice physicalDevice;
+    LogicalDevicePtr device;
+    CommandPoolPtr commandPool;
+};
+
+/// Statistics of one benchmark, per iteration
+struct Result {
+    std::string name;
+    uint64_t iterations = 0;
+    double medianNs = 0.0;
+    double meanNs = 0.0;
+    double minNs = 0.0;
+    double stddevNs = 0.0;
+    double bytesPerSecond = 0.0;   // 0 unless setBytesPerIteration() was called
+    double itemsPerSecond = 0.0;   // 0 unless setItemsPerIteration() was called
+    std::map<std::string, double> counters;
+    std::string skipped;           // Reason, if the benchmark could not run
+};
+
+/// Keep the compiler from discarding a value computed only for timing
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+    (void)*sink;
+#endif
+}
+
+/**
+ * @brief Timing state handed to a benchmark
+ */
+class State {
+public:
+    static constexpr uint32_t Samples = 10;
+
+    explicit State(double minTimeSeconds) : minTimeNs_(minTimeSeconds * 1e9) {}
+
+    /// Bytes processed by one iteration (reported as bytes/s)
+    void setBytesPerIteration(uint64_t bytes) { bytesPerIteration_ = bytes; }
+
+    /// Items processed by one iteration (reported as items/s)
+    void setItemsPerIteration(uint64_t items) { itemsPerIteration_ = items; }
+
+    /// Extra value reported alongside the timings
+    void counter(const std::string& name, double value) { counters_[name] = value; }
+
+    /// Mark the benchmark as not runnable on this device
+    void skip(std::string reason) { skipped_ = std::move(reason); }
+
+    /// Time body(), called repeatedly
+    template <typename F>
+    void run(F&& body) {
+        using Clock = std::chrono::steady_clock;
+        auto timeBatch = [&](uint64_t count) {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < count; i++) {
+                body();
+            }
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        };
+
+        // Warm up while growing the batch until it fills one sample
+        double targetNs = minTimeNs_ / Samples;
+        uint64_t batch = 1;
+        for (;;) {
+            double ns = timeBatch(batch);
+            if (ns >= targetNs || batch >= MaxBatch) {
+                break;
+            }
+            double scale = ns > 0.0 ? targetNs / ns * 1.2 : 10.0;
+            batch = std::min<uint64_t>(MaxBatch,
+                std::max<uint64_t>(batch * 2, static_cast<uint64_t>(static_cast<double>(batch) * scale)));
+        }
+
+        samples_.clear();
+        for (uint32_t s = 0; s < Samples; s++) {
+            samples_.push_back(timeBatch(batch) / static_cast<double>(batch));
+        }
+        iterations_ = batch * Samples;
+    }
+
+    /// Statistics of the last run()
+    Result result(const std::string& name) const;
+
+private:
+    static constexpr uint64_t MaxBatch = 1ull << 30;
+
+    double minTimeNs_;
+    uint64_t bytesPerIteration_ = 0;
+    uint64_t itemsPerIteration_ = 0;
+    uint64_t iterations_ = 0;
+    std::vector<double> samples_;
+    std::map<std::string, double> counters_;
+    std::string skipped_;
+};
+
+using Function = std::function<void(Context&, State&)>;
+
+struct Entry {
+    std::string name;
+    Function function;
+};
+
+/// Benchmarks registered so far, in registration order
+std::vector<Entry>& registry();
+
+/// Register a benchmark; names are "group/case[/parameter]"
+inline void add(std::string name, Function function) {
+    registry().push_back({std::move(name), std::move(function)});
+}
+
+/// Runs a registration function during static initialization
+struct Registrar {
+    explicit Registrar(void (*registerAll)()) { registerAll(); }
+};
+
+} // namespace bench
+} // namespace finevk
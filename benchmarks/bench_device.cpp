@@ -0,0 +1,173 @@
+/**
+ * @file bench_device.cpp
+ * @brief Allocator, buffer upload and descriptor update benchmarks
+ */
+
+#include "bench.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace finevk;
+
+namespace {
+
+std::string sizeName(VkDeviceSize bytes) {
+    if (bytes >= 1024 * 1024) {
+        return std::to_string(bytes / (1024 * 1024)) + "MiB";
+    }
+    if (bytes >= 1024) {
+        return std::to_string(bytes / 1024) + "KiB";
+    }
+    return std::to_string(bytes) + "B";
+}
+
+// ============================================================================
+// MemoryAllocator
+// ============================================================================
+
+void registerAllocator() {
+    // Sub-allocations from pooled blocks, with one size past the dedicated threshold
+    for (VkDeviceSize size : {256ull, 64ull * 1024, 1024ull * 1024, 32ull * 1024 * 1024}) {
+        for (MemoryUsage usage : {MemoryUsage::GpuOnly, MemoryUsage::CpuToGpu}) {
+            std::string name = std::string("allocator/allocate_free/") +
+                (usage == MemoryUsage::GpuOnly ? "gpu_only/" : "cpu_to_gpu/") + sizeName(size);
+
+            bench::add(name, [size, usage](bench::Context& ctx, bench::State& state) {
+                constexpr uint32_t Batch = 64;
+
+                VkMemoryRequirements requirements{};
+                requirements.size = size;
+                requirements.alignment = 256;
+                requirements.memoryTypeBits = ~0u;
+
+                MemoryAllocator& allocator = ctx.device->allocator();
+                std::vector<AllocationInfo> allocations;
+                allocations.reserve(Batch);
+
+                // Allocate a batch and free it newest first, so blocks fill and drain
+                state.setItemsPerIteration(Batch);
+                state.run([&] {
+                    for (uint32_t i = 0; i < Batch; i++) {
+                        allocations.push_back(allocator.allocate(requirements, usage));
+                    }
+                    while (!allocations.empty()) {
+                        allocator.free(allocations.back());
+                        allocations.pop_back();
+                    }
+                });
+            });
+        }
+    }
+}
+
+// ============================================================================
+// Buffer::upload
+// ============================================================================
+
+void registerUpload() {
+    for (VkDeviceSize size : {4ull * 1024, 64ull * 1024, 1024ull * 1024, 16ull * 1024 * 1024}) {
+        // Host-visible destination: a memcpy into the persistent mapping
+        bench::add("buffer/upload/mapped/" + sizeName(size), [size](bench::Context& ctx, bench::State& state) {
+            auto buffer = Buffer::create(ctx.device)
+                .size(size)
+                .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+                .memoryUsage(MemoryUsage::CpuToGpu)
+                .build();
+            std::vector<uint8_t> data(size, 0x5a);
+
+            state.setBytesPerIteration(size);
+            state.run([&] { buffer->upload(data.data(), size); });
+        });
+
+        // Device-local destination: staging buffer, copy and wait
+        bench::add("buffer/upload/staged/" + sizeName(size), [size](bench::Context& ctx, bench::State& state) {
+            auto buffer = Buffer::create(ctx.device)
+                .size(size)
+                .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+                .memoryUsage(MemoryUsage::GpuOnly)
+                .build();
+            std::vector<uint8_t> data(size, 0x5a);
+
+            state.setBytesPerIteration(size);
+            state.run([&] { buffer->upload(data.data(), size, 0, ctx.commandPool.get()); });
+        });
+    }
+}
+
+// ============================================================================
+// DescriptorWriter::update
+// ============================================================================
+
+void registerDescriptorWriter() {
+    // Writes per update() call: one vkUpdateDescriptorSets for the whole batch
+    for (uint32_t count : {1u, 16u, 256u}) {
+        bench::add("descriptors/update/" + std::to_string(count), [count](bench::Context& ctx, bench::State& state) {
+            auto layout = DescriptorSetLayout::create(ctx.device)
+                .uniformBuffer(0, VK_SHADER_STAGE_VERTEX_BIT)
+                .build();
+            auto pool = DescriptorPool::create(ctx.device)
+                .maxSets(count)
+                .poolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, count)
+                .build();
+            auto sets = pool->allocate(layout.get(), count);
+
+            auto uniforms = Buffer::create(ctx.device)
+                .size(256ull * count)
+                .usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+                .memoryUsage(MemoryUsage::CpuToGpu)
+                .build();
+
+            DescriptorWriter writer(ctx.device);
+            state.setItemsPerIteration(count);
+            state.run([&] {
+                for (uint32_t i = 0; i < count; i++) {
+                    writer.writeBuffer(sets[i], 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                       uniforms->handle(), 256ull * i, 256);
+                }
+                writer.update();
+            });
+        });
+
+        // Same sets through the layout's update template, one call per set
+        bench::add("descriptors/update_template/" + std::to_string(count), [count](bench::Context& ctx, bench::State& state) {
+            auto layout = DescriptorSetLayout::create(ctx.device)
+                .uniformBuffer(0, VK_SHADER_STAGE_VERTEX_BIT)
+                .build();
+            const DescriptorUpdateTemplate* tmpl = layout->updateTemplate();
+            if (!tmpl) {
+                state.skip("no descriptor update templates (Vulkan 1.0 device)");
+                return;
+            }
+            auto pool = DescriptorPool::create(ctx.device)
+                .maxSets(count)
+                .poolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, count)
+                .build();
+            auto sets = pool->allocate(layout.get(), count);
+
+            auto uniforms = Buffer::create(ctx.device)
+                .size(256ull * count)
+                .usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+                .memoryUsage(MemoryUsage::CpuToGpu)
+                .build();
+
+            std::vector<DescriptorInfo> data(count);
+            for (uint32_t i = 0; i < count; i++) {
+                data[i].buffer = {uniforms->handle(), 256ull * i, 256};
+            }
+
+            state.setItemsPerIteration(count);
+            state.run([&] {
+                for (uint32_t i = 0; i < count; i++) {
+                    tmpl->update(sets[i], &data[i]);
+                }
+            });
+        });
+    }
+}
+
+const bench::Registrar allocatorBenchmarks(registerAllocator);
+const bench::Registrar uploadBenchmarks(registerUpload);
+const bench::Registrar descriptorBenchmarks(registerDescriptorWriter);
+
+} // anonymous namespace
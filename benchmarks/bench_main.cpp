@@ -0,0 +1,303 @@
+/**
+ * @file bench_main.cpp
+ * @brief finevk-bench entry point: device setup, filtering and JSON output
+ *
+ * Usage:
+ *   finevk-bench [--filter <substring>] [--min-time <seconds>] [--json <path>] [--list]
+ *
+ * The JSON file holds one object per benchmark with per-iteration times in
+ * nanoseconds, so two runs can be diffed to catch regressions.
+ */
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+using namespace finevk;
+
+namespace finevk {
+namespace bench {
+
+std::vector<Entry>& registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+Result State::result(const std::string& name) const {
+    Result r;
+    r.name = name;
+    r.counters = counters_;
+    r.skipped = skipped_;
+    if (samples_.empty()) {
+        return r;
+    }
+
+    std::vector<double> sorted = samples_;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+
+    r.iterations = iterations_;
+    r.medianNs = n % 2 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    r.meanNs = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(n);
+    r.minNs = sorted.front();
+
+    double variance = 0.0;
+    for (double s : sorted) {
+        variance += (s - r.meanNs) * (s - r.meanNs);
+    }
+    r.stddevNs = n > 1 ? std::sqrt(variance / static_cast<double>(n - 1)) : 0.0;
+
+    if (r.medianNs > 0.0) {
+        r.bytesPerSecond = static_cast<double>(bytesPerIteration_) * 1e9 / r.medianNs;
+        r.itemsPerSecond = static_cast<double>(itemsPerIteration_) * 1e9 / r.medianNs;
+    }
+    return r;
+}
+
+} // namespace bench
+} // namespace finevk
+
+namespace {
+
+struct Options {
+    std::string filter;
+    std::string jsonPath;
+    double minTime = 0.5;
+    bool list = false;
+};
+
+void printUsage() {
+    std::cout << "Usage: finevk-bench [--filter <substring>] [--min-time <seconds>] "
+                 "[--json <path>] [--list]\n";
+}
+
+Options parseArgs(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(arg + " requires a value");
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--filter") {
+            options.filter = value();
+        } else if (arg == "--json") {
+            options.jsonPath = value();
+        } else if (arg == "--min-time") {
+            options.minTime = std::atof(value().c_str());
+            if (options.minTime <= 0.0) {
+                throw std::runtime_error("--min-time must be positive");
+            }
+        } else if (arg == "--list") {
+            options.list = true;
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+    return options;
+}
+
+bench::Context createContext() {
+    bench::Context ctx;
+
+    // No window and no validation: timings should reflect the library alone
+    ctx.instance = Instance::create()
+        .applicationName("finevk-bench")
+        .enableValidation(false)
+        .headless()
+        .build();
+
+    ctx.physicalDevice = ctx.instance->selectPhysicalDevice();
+    ctx.device = ctx.physicalDevice.createLogicalDevice().build();
+    ctx.commandPool = std::make_unique<CommandPool>(
+        ctx.device.get(),
+        ctx.device->graphicsQueue(),
+        CommandPoolFlags::Resettable);
+
+    return ctx;
+}
+
+std::string formatTime(double ns) {
+    char text[32];
+    if (ns >= 1e6) {
+        std::snprintf(text, sizeof(text), "%.3f ms", ns * 1e-6);
+    } else if (ns >= 1e3) {
+        std::snprintf(text, sizeof(text), "%.3f us", ns * 1e-3);
+    } else {
+        std::snprintf(text, sizeof(text), "%.1f ns", ns);
+    }
+    return text;
+}
+
+void printResult(const bench::Result& r) {
+    char line[256];
+    if (!r.skipped.empty()) {
+        std::snprintf(line, sizeof(line), "%-48s skipped: %s", r.name.c_str(), r.skipped.c_str());
+        std::cout << line << "\n";
+        return;
+    }
+
+    std::snprintf(line, sizeof(line), "%-48s %12s  (min %s, sd %s, %llu iterations)",
+                  r.name.c_str(), formatTime(r.medianNs).c_str(),
+                  formatTime(r.minNs).c_str(), formatTime(r.stddevNs).c_str(),
+                  static_cast<unsigned long long>(r.iterations));
+    std::cout << line;
+    if (r.bytesPerSecond > 0.0) {
+        std::snprintf(line, sizeof(line), "  %.2f GiB/s", r.bytesPerSecond / (1024.0 * 1024.0 * 1024.0));
+        std::cout << line;
+    }
+    if (r.itemsPerSecond > 0.0) {
+        std::snprintf(line, sizeof(line), "  %.3g items/s", r.itemsPerSecond);
+        std::cout << line;
+    }
+    for (const auto& [name, value] : r.counters) {
+        std::cout << "  " << name << "=" << value;
+    }
+    std::cout << "\n";
+}
+
+void writeJsonString(FILE* out, const std::string& text) {
+    std::fputc('"', out);
+    for (unsigned char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            std::fputc('\\', out);
+            std::fputc(ch, out);
+        } else if (ch < 0x20) {
+            std::fprintf(out, "\\u%04x", ch);
+        } else {
+            std::fputc(ch, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+bool writeJson(const std::string& path, const bench::Context& ctx,
+               const std::vector<bench::Result>& results) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        return false;
+    }
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::fputs("{\"context\":{\"date\":", out);
+    writeJsonString(out, date);
+    std::fputs(",\"device\":", out);
+    writeJsonString(out, ctx.physicalDevice.name());
+    std::fputs("},\n\"benchmarks\":[", out);
+
+    bool first = true;
+    for (const auto& r : results) {
+        std::fputs(first ? "\n{\"name\":" : ",\n{\"name\":", out);
+        first = false;
+        writeJsonString(out, r.name);
+        if (!r.skipped.empty()) {
+            std::fputs(",\"skipped\":", out);
+            writeJsonString(out, r.skipped);
+            std::fputc('}', out);
+            continue;
+        }
+        std::fprintf(out, ",\"iterations\":%llu,\"median_ns\":%.3f,\"mean_ns\":%.3f,"
+                          "\"min_ns\":%.3f,\"stddev_ns\":%.3f",
+                     static_cast<unsigned long long>(r.iterations),
+                     r.medianNs, r.meanNs, r.minNs, r.stddevNs);
+        if (r.bytesPerSecond > 0.0) {
+            std::fprintf(out, ",\"bytes_per_second\":%.1f", r.bytesPerSecond);
+        }
+        if (r.itemsPerSecond > 0.0) {
+            std::fprintf(out, ",\"items_per_second\":%.1f", r.itemsPerSecond);
+        }
+        for (const auto& [name, value] : r.counters) {
+            std::fputc(',', out);
+            writeJsonString(out, name);
+            std::fprintf(out, ":%.6g", value);
+        }
+        std::fputc('}', out);
+    }
+    std::fputs("\n]}\n", out);
+
+    bool ok = std::ferror(out) == 0;
+    return std::fclose(out) == 0 && ok;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        printUsage();
+        return 2;
+    }
+
+    std::vector<const bench::Entry*> selected;
+    for (const auto& entry : bench::registry()) {
+        if (options.filter.empty() || entry.name.find(options.filter) != std::string::npos) {
+            selected.push_back(&entry);
+        }
+    }
+
+    if (options.list) {
+        for (const auto* entry : selected) {
+            std::cout << entry->name << "\n";
+        }
+        return 0;
+    }
+
+    // Benchmark logs would interleave with the results
+    Logger::global().setMinLevel(LogLevel::Warning);
+
+    bench::Context ctx;
+    try {
+        ctx = createContext();
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create a Vulkan device: " << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "Device: " << ctx.physicalDevice.name() << "\n\n";
+
+    std::vector<bench::Result> results;
+    int failed = 0;
+    for (const auto* entry : selected) {
+        bench::State state(options.minTime);
+        try {
+            entry->function(ctx, state);
+        } catch (const std::exception& e) {
+            std::cerr << entry->name << " FAILED: " << e.what() << "\n";
+            failed++;
+            continue;
+        }
+        results.push_back(state.result(entry->name));
+        printResult(results.back());
+    }
+
+    ctx.device->waitIdle();
+
+    if (!options.jsonPath.empty()) {
+        if (!writeJson(options.jsonPath, ctx, results)) {
+            std::cerr << "Failed to write " << options.jsonPath << "\n";
+            return 1;
+        }
+        std::cout << "\nResults written to " << options.jsonPath << "\n";
+    }
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file bench_mesh.cpp
+ * @brief Mesh::Builder deduplication and OBJ import benchmarks
+ */
+
+#include "bench.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+using namespace finevk;
+
+namespace {
+
+Vertex gridVertex(uint32_t x, uint32_t y, uint32_t size) {
+    Vertex v{};
+    v.position = {static_cast<float>(x), 0.0f, static_cast<float>(y)};
+    v.texCoord = {static_cast<float>(x) / size, static_cast<float>(y) / size};
+    return v;
+}
+
+// A size x size quad grid where each interior vertex is shared by six triangles
+void addGrid(Mesh::Builder& builder, uint32_t size) {
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            builder.addQuad(gridVertex(x, y, size), gridVertex(x + 1, y, size),
+                            gridVertex(x + 1, y + 1, size), gridVertex(x, y + 1, size));
+        }
+    }
+}
+
+// Same grid as an OBJ file, written once per benchmark
+std::filesystem::path writeGridObj(uint32_t size) {
+    auto path = std::filesystem::temp_directory_path() /
+        ("finevk_bench_grid_" + std::to_string(size) + ".obj");
+    std::ofstream out(path);
+    for (uint32_t y = 0; y <= size; y++) {
+        for (uint32_t x = 0; x <= size; x++) {
+            out << "v " << x << " 0 " << y << "\n";
+            out << "vt " << static_cast<float>(x) / size << " " << static_cast<float>(y) / size << "\n";
+        }
+    }
+    out << "vn 0 1 0\n";
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            uint32_t i0 = y * (size + 1) + x + 1;  // OBJ indices are 1-based
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i1 + size + 1;
+            uint32_t i3 = i0 + size + 1;
+            out << "f " << i0 << "/" << i0 << "/1 " << i1 << "/" << i1 << "/1 "
+                << i2 << "/" << i2 << "/1 " << i3 << "/" << i3 << "/1\n";
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write " + path.string());
+    }
+    return path;
+}
+
+// ============================================================================
+// Mesh::Builder
+// ============================================================================
+
+void registerBuilder() {
+    for (uint32_t size : {32u, 256u}) {
+        for (bool dedup : {true, false}) {
+            std::string name = std::string("mesh/builder/") + (dedup ? "dedup/" : "no_dedup/") +
+                std::to_string(size) + "x" + std::to_string(size);
+
+            bench::add(name, [size, dedup](bench::Context& ctx, bench::State& state) {
+                state.setItemsPerIteration(2ull * size * size);  // Triangles
+                size_t vertices = 0;
+                state.run([&] {
+                    auto builder = Mesh::create(ctx.device)
+                        .attributes(VertexAttribute::Position | VertexAttribute::TexCoord)
+                        .enableDeduplication(dedup);
+                    addGrid(builder, size);
+                    vertices = builder.vertexCount();
+                    bench::doNotOptimize(vertices);
+                });
+                state.counter("vertices", static_cast<double>(vertices));
+            });
+        }
+    }
+}
+
+// ============================================================================
+// OBJ import
+// ============================================================================
+
+void registerObjImport() {
+    // Parse, deduplicate and upload; "cached" reads the binary cache instead
+    for (bool cached : {false, true}) {
+        std::string name = std::string("mesh/obj_import/") + (cached ? "cached" : "parse");
+
+        bench::add(name, [cached](bench::Context& ctx, bench::State& state) {
+            constexpr uint32_t Size = 128;
+            auto path = writeGridObj(Size);
+            auto cachePath = path;
+            cachePath += Mesh::CacheExtension;
+            std::filesystem::remove(cachePath);
+
+            state.setBytesPerIteration(std::filesystem::file_size(path));
+            state.run([&] {
+                auto mesh = Mesh::load(ctx.device, ctx.commandPool.get(), path.string())
+                    .cache(cached)
+                    .build();
+                bench::doNotOptimize(mesh);
+            });
+
+            std::filesystem::remove(cachePath);
+            std::filesystem::remove(path);
+        });
+    }
+}
+
+const bench::Registrar builderBenchmarks(registerBuilder);
+const bench::Registrar objBenchmarks(registerObjImport);
+
+} // anonymous namespace
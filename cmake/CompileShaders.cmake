@@ -12,6 +12,16 @@ if(NOT GLSLC)
     message(WARNING "glslc not found - shader compilation will be skipped")
 endif()
 
+# Task and mesh shaders (VK_EXT_mesh_shader) need SPIR-V 1.4
+function(shader_target_flags SHADER OUT_VAR)
+    get_filename_component(SHADER_EXT ${SHADER} LAST_EXT)
+    if(SHADER_EXT STREQUAL ".task" OR SHADER_EXT STREQUAL ".mesh")
+        set(${OUT_VAR} "--target-env=vulkan1.2" PARENT_SCOPE)
+    else()
+        set(${OUT_VAR} "" PARENT_SCOPE)
+    endif()
+endfunction()
+
 # Function to compile shaders for a target
 # Usage: compile_shaders(TARGET_NAME SHADER_DIR OUTPUT_DIR)
 function(compile_shaders TARGET SHADER_DIR OUTPUT_DIR)
@@ -28,18 +38,21 @@ function(compile_shaders TARGET SHADER_DIR OUTPUT_DIR)
         "${SHADER_DIR}/*.geom"
         "${SHADER_DIR}/*.tesc"
         "${SHADER_DIR}/*.tese"
+        "${SHADER_DIR}/*.task"
+        "${SHADER_DIR}/*.mesh"
     )
 
     set(SPIRV_FILES "")
 
     foreach(SHADER ${SHADER_SOURCES})
         get_filename_component(SHADER_NAME ${SHADER} NAME)
+        shader_target_flags(${SHADER} SHADER_FLAGS)
         set(OUTPUT "${OUTPUT_DIR}/${SHADER_NAME}.spv")
 
         add_custom_command(
             OUTPUT ${OUTPUT}
             COMMAND ${CMAKE_COMMAND} -E make_directory "${OUTPUT_DIR}"
-            COMMAND ${GLSLC} "${SHADER}" -o "${OUTPUT}"
+            COMMAND ${GLSLC} ${SHADER_FLAGS} "${SHADER}" -o "${OUTPUT}"
             DEPENDS ${SHADER}
             COMMENT "Compiling shader: ${SHADER_NAME}"
             VERBATIM
@@ -68,17 +81,20 @@ function(add_shader_library NAME)
         "${CMAKE_CURRENT_SOURCE_DIR}/*.geom"
         "${CMAKE_CURRENT_SOURCE_DIR}/*.tesc"
         "${CMAKE_CURRENT_SOURCE_DIR}/*.tese"
+        "${CMAKE_CURRENT_SOURCE_DIR}/*.task"
+        "${CMAKE_CURRENT_SOURCE_DIR}/*.mesh"
     )
 
     set(SPIRV_FILES "")
 
     foreach(SHADER ${SHADER_SOURCES})
         get_filename_component(SHADER_NAME ${SHADER} NAME)
+        shader_target_flags(${SHADER} SHADER_FLAGS)
         set(OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.spv")
 
         add_custom_command(
             OUTPUT ${OUTPUT}
-            COMMAND ${GLSLC} "${SHADER}" -o "${OUTPUT}"
+            COMMAND ${GLSLC} ${SHADER_FLAGS} "${SHADER}" -o "${OUTPUT}"
             DEPENDS ${SHADER}
             COMMENT "Compiling shader: ${SHADER_NAME}"
             VERBATIM
@@ -63,7 +63,7 @@ int main() {
         );
 
         // Allocate command buffers using device's default command pool
-        auto commandBuffers = device->defaultCommandPool()->allocate(window->framesInFlight());
+        auto commandBuffers = device->defaultCommandPool()->allocate(window->maxFramesInFlight());
 
         // Create framebuffers for the swap chain images
         finevk::SwapChainFramebuffers framebuffers(*window->swapChain(), *renderPass);
@@ -93,10 +93,8 @@ int main() {
         std::cout << "Texture loaded: " << texture->width() << "x" << texture->height()
                   << ", " << texture->mipLevels() << " mip levels\n";
 
-        // Create uniform buffers
-        auto uniformBuffer = UniformBuffer<MVPUniform>::create(
-            renderer->device(),
-            renderer->framesInFlight());
+        // Create uniform buffers (one per frame slot)
+        auto uniformBuffer = UniformBuffer<MVPUniform>::create(renderer->device());
 
         // Create descriptor set layout
         auto descriptorLayout = DescriptorSetLayout::create(renderer->device())
@@ -106,19 +104,19 @@ int main() {
 
         // Create descriptor pool
         auto descriptorPool = DescriptorPool::create(renderer->device())
-            .maxSets(renderer->framesInFlight())
-            .poolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, renderer->framesInFlight())
-            .poolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, renderer->framesInFlight())
+            .maxSets(renderer->maxFramesInFlight())
+            .poolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, renderer->maxFramesInFlight())
+            .poolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, renderer->maxFramesInFlight())
             .build();
 
         // Allocate descriptor sets
         auto descriptorSets = descriptorPool->allocate(
             descriptorLayout,
-            renderer->framesInFlight());
+            renderer->maxFramesInFlight());
 
         // Write descriptor sets
         DescriptorWriter writer(renderer->device());
-        for (uint32_t i = 0; i < renderer->framesInFlight(); i++) {
+        for (uint32_t i = 0; i < renderer->maxFramesInFlight(); i++) {
             writer.writeBuffer(
                 descriptorSets[i], 0,
                 VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
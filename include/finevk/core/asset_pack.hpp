@@ -0,0 +1,137 @@
+#pragma once
+
+#include "finevk/core/mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief Read-only archive of many assets in one memory-mapped file
+ *
+ * A pack is a header, a table of contents and the entries themselves, each
+ * starting on a 4 KiB boundary. Opening one maps the whole file once;
+ * entry() returns a span straight into the mapping, so loaders decode and
+ * memcpy into staging buffers from the page cache with no file opens or
+ * intermediate copies per asset.
+ *
+ * Lookups and spans are read-only and safe from any thread, so entries can
+ * be decoded in parallel (e.g. with ThreadPool::parallelFor over entries()).
+ * Spans stay valid for the lifetime of the pack.
+ *
+ * Usage:
+ * @code
+ * // Offline (or at first run)
+ * AssetPack::Writer()
+ *     .add("rock", AssetPack::Kind::Texture, "textures/rock.bc7.ktx2")
+ *     .add("crate", AssetPack::Kind::Mesh, "models/crate.obj.fvkmesh")
+ *     .write("assets.fvkpack");
+ *
+ * // At startup
+ * AssetPack pack("assets.fvkpack");
+ * auto rock = Texture::fromPack(device, pack, "rock", commandPool);
+ * auto crate = Mesh::fromPack(device, pack, "crate", commandPool);
+ * @endcode
+ */
+class AssetPack {
+public:
+    /// What an entry holds (recorded by the writer, checked by loaders)
+    enum class Kind : uint32_t {
+        Raw = 0,      ///< Opaque bytes
+        Mesh = 1,     ///< Binary mesh cache (Mesh::CacheExtension)
+        Texture = 2,  ///< KTX2/DDS container or an encoded image (PNG, JPEG, ...)
+    };
+
+    /// Alignment of every entry's offset in the file
+    static constexpr uint64_t EntryAlignment = 4096;
+
+    /// Conventional extension for pack files
+    static constexpr const char* Extension = ".fvkpack";
+
+    struct Entry {
+        std::string name;
+        Kind kind = Kind::Raw;
+        ByteSpan bytes;
+    };
+
+    /**
+     * @brief Assembles a pack file from files and in-memory blobs
+     */
+    class Writer {
+    public:
+        /// Add the contents of a file (read when write() runs)
+        Writer& add(const std::string& name, Kind kind, const std::string& path);
+
+        /// Add bytes (copied)
+        Writer& add(const std::string& name, Kind kind, const void* data, size_t size);
+
+        /// Number of entries added
+        size_t size() const { return entries_.size(); }
+
+        /**
+         * @brief Write the pack, replacing path atomically
+         * @throws std::runtime_error on duplicate names or I/O errors
+         */
+        void write(const std::string& path) const;
+
+    private:
+        struct Pending {
+            std::string name;
+            Kind kind;
+            std::string path;           // Empty for in-memory entries
+            std::vector<uint8_t> bytes;
+        };
+
+        std::vector<Pending> entries_;
+    };
+
+    /// Empty pack
+    AssetPack() = default;
+
+    /**
+     * @brief Map a pack file and read its table of contents
+     * @throws std::runtime_error if the file can't be mapped or is not a valid pack
+     */
+    explicit AssetPack(const std::string& path);
+
+    /// Find an entry by name (nullptr if absent)
+    const Entry* find(const std::string& name) const;
+
+    /**
+     * @brief Get an entry by name
+     * @throws std::runtime_error if absent
+     */
+    const Entry& entry(const std::string& name) const;
+
+    /// Check whether an entry exists
+    bool contains(const std::string& name) const { return find(name) != nullptr; }
+
+    /// All entries, in file order
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    /// Number of entries
+    size_t size() const { return entries_.size(); }
+
+    /// Path the pack was opened from
+    const std::string& path() const { return path_; }
+
+    // Non-copyable (spans point into the mapping)
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Movable (spans stay valid: the mapping itself does not move)
+    AssetPack(AssetPack&&) = default;
+    AssetPack& operator=(AssetPack&&) = default;
+
+private:
+    std::string path_;
+    MappedFile file_;
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, size_t> index_;
+};
+
+} // namespace finevk
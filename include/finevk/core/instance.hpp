@@ -66,6 +66,9 @@ public:
         /// Add multiple instance extensions
         Builder& addExtensions(const std::vector<const char*>& extensions);
 
+        /// No windows: skip GLFW initialization and its surface extensions (for HeadlessRenderer)
+        Builder& headless(bool enable = true);
+
         /// Build the Instance object
         InstancePtr build();
 
@@ -76,6 +79,7 @@ public:
         uint32_t engineVersion_ = VK_MAKE_VERSION(1, 0, 0);
         uint32_t apiVersion_ = VK_API_VERSION_1_2;
         bool validationEnabled_ = true;
+        bool headless_ = false;
         std::vector<const char*> extensions_;
 
         std::vector<const char*> getRequiredExtensions() const;
@@ -91,6 +95,9 @@ public:
     /// Check if validation layers are enabled
     bool validationEnabled() const { return validationEnabled_; }
 
+    /// Check if the instance was built without window support
+    bool isHeadless() const { return headless_; }
+
     /// Create a surface for a GLFW window (low-level, prefer createWindow())
     SurfacePtr createSurface(GLFWwindow* window);
 
@@ -129,6 +136,7 @@ private:
 
     VkInstance instance_ = VK_NULL_HANDLE;
     bool validationEnabled_ = false;
+    bool headless_ = false;
     DebugMessengerPtr debugMessenger_;
 };
 
@@ -3,8 +3,18 @@
 #include <string>
 #include <string_view>
 #include <cstdio>
+#include <cstdint>
+#include <atomic>
+#include <memory>
 #include <vulkan/vulkan.h>
 
+// Levels below this are compiled out of the FINEVK_* macros, arguments
+// included (0 = Trace ... 5 = Fatal; set through the CMake option of the
+// same name). Error and Fatal are always kept.
+#ifndef FINEVK_MIN_LOG_LEVEL
+#define FINEVK_MIN_LOG_LEVEL 0
+#endif
+
 namespace finevk {
 
 // Log levels
@@ -27,13 +37,37 @@ enum class LogCategory {
     Performance // Performance warnings
 };
 
-// Simple logging interface - can be expanded later with sinks
+/**
+ * @brief Process-wide logger writing to stdout (below Warning) and stderr
+ *
+ * The FINEVK_* macros check isEnabled() before evaluating the message, so
+ * a filtered call never builds its string. With setAsync(true), log()
+ * copies the message into a fixed ring of records (lock-free, multiple
+ * producers) and returns; a background thread formats and writes them.
+ * Messages up to InlineMessageSize bytes are stored in the record itself;
+ * longer ones reuse a string kept with the slot, so steady-state logging
+ * doesn't allocate. When the ring is full new records are dropped and
+ * counted rather than blocking the caller; the writer reports the count.
+ * Fatal messages are flushed before log() returns.
+ */
 class Logger {
 public:
     static Logger& global();
 
-    void setMinLevel(LogLevel level) { minLevel_ = level; }
-    LogLevel minLevel() const { return minLevel_; }
+    /// Records the asynchronous ring holds
+    static constexpr size_t QueueCapacity = 4096;
+
+    /// Message bytes stored without a heap string
+    static constexpr size_t InlineMessageSize = 192;
+
+    void setMinLevel(LogLevel level) { minLevel_.store(level, std::memory_order_relaxed); }
+    LogLevel minLevel() const { return minLevel_.load(std::memory_order_relaxed); }
+
+    /// True if a message at this level would be written (runtime and compile-time filters)
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= (FINEVK_MIN_LOG_LEVEL < 4 ? FINEVK_MIN_LOG_LEVEL : 4) &&
+               level >= minLevel_.load(std::memory_order_relaxed);
+    }
 
     void log(LogLevel level, LogCategory category, std::string_view message,
              const char* file = nullptr, int line = 0);
@@ -51,22 +85,77 @@ public:
                        VkDebugUtilsMessageTypeFlagsEXT type,
                        const VkDebugUtilsMessengerCallbackDataEXT* data);
 
+    /**
+     * @brief Write from a background thread instead of the caller's
+     *
+     * Disabling writes out what is queued and stops the thread. Toggle from
+     * one thread, e.g. at startup and shutdown.
+     */
+    void setAsync(bool enable);
+    bool isAsync() const { return async_.load(std::memory_order_relaxed); }
+
+    /// Block until every message logged so far has been written
+    void flush();
+
+    /// Messages dropped because the asynchronous ring was full
+    uint64_t droppedCount() const;
+
+    ~Logger();
+
+    // Non-copyable
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
 private:
     Logger() = default;
-    LogLevel minLevel_ = LogLevel::Debug;
+    struct AsyncState;
+
+    AsyncState& asyncState();
+
+    std::atomic<LogLevel> minLevel_{LogLevel::Debug};
+    std::atomic<bool> async_{false};
+    std::unique_ptr<AsyncState> asyncState_;  // Created on first setAsync(true), kept until exit
 
     static const char* levelToString(LogLevel level);
     static const char* categoryToString(LogCategory category);
 };
 
-// Logging macros with file/line info
+// Logging macros with file/line info; the message is only evaluated if the level is enabled
 #define FINEVK_LOG(level, category, msg) \
-    finevk::Logger::global().log(level, category, msg, __FILE__, __LINE__)
+    do { \
+        if (finevk::Logger::global().isEnabled(level)) { \
+            finevk::Logger::global().log(level, category, msg, __FILE__, __LINE__); \
+        } \
+    } while (0)
+
+// Compiled-out level: the message stays an unevaluated operand, so variables
+// only used for logging don't trigger unused warnings
+#define FINEVK_LOG_STRIPPED(category, msg) do { (void)sizeof(category); (void)sizeof(msg); } while (0)
 
+#if FINEVK_MIN_LOG_LEVEL <= 0
 #define FINEVK_TRACE(category, msg)   FINEVK_LOG(finevk::LogLevel::Trace, category, msg)
+#else
+#define FINEVK_TRACE(category, msg)   FINEVK_LOG_STRIPPED(category, msg)
+#endif
+
+#if FINEVK_MIN_LOG_LEVEL <= 1
 #define FINEVK_DEBUG(category, msg)   FINEVK_LOG(finevk::LogLevel::Debug, category, msg)
+#else
+#define FINEVK_DEBUG(category, msg)   FINEVK_LOG_STRIPPED(category, msg)
+#endif
+
+#if FINEVK_MIN_LOG_LEVEL <= 2
 #define FINEVK_INFO(category, msg)    FINEVK_LOG(finevk::LogLevel::Info, category, msg)
+#else
+#define FINEVK_INFO(category, msg)    FINEVK_LOG_STRIPPED(category, msg)
+#endif
+
+#if FINEVK_MIN_LOG_LEVEL <= 3
 #define FINEVK_WARN(category, msg)    FINEVK_LOG(finevk::LogLevel::Warning, category, msg)
+#else
+#define FINEVK_WARN(category, msg)    FINEVK_LOG_STRIPPED(category, msg)
+#endif
+
 #define FINEVK_ERROR(category, msg)   FINEVK_LOG(finevk::LogLevel::Error, category, msg)
 #define FINEVK_FATAL(category, msg)   FINEVK_LOG(finevk::LogLevel::Fatal, category, msg)
 
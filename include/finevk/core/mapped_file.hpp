@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace finevk {
+
+/**
+ * @brief Non-owning view of bytes (a slice of a mapping or any buffer)
+ */
+struct ByteSpan {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    bool empty() const { return size == 0; }
+};
+
+/**
+ * @brief Read-only memory-mapped file
+ *
+ * Maps a whole file into the address space so loaders can copy straight
+ * from the page cache (e.g. into a staging buffer) without an intermediate
+ * read buffer. The mapping is released on destruction.
+ *
+ * Usage:
+ * @code
+ * MappedFile file("model.obj.fvkmesh");
+ * std::memcpy(staging->mappedPtr(), file.data() + offset, size);
+ * @endcode
+ */
+class MappedFile {
+public:
+    /// Empty mapping
+    MappedFile() = default;
+
+    /// Map a file; throws std::runtime_error if it can't be opened or mapped
+    explicit MappedFile(const std::string& path);
+
+    /// Destructor - unmaps the file
+    ~MappedFile();
+
+    // Non-copyable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Movable
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// Mapped bytes (nullptr when empty)
+    const uint8_t* data() const { return data_; }
+
+    /// File size in bytes
+    size_t size() const { return size_; }
+
+    /// The whole mapping as a span
+    ByteSpan span() const { return {data_, size_}; }
+
+    /// Check whether a file is mapped
+    explicit operator bool() const { return data_ != nullptr; }
+
+private:
+    void close();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+} // namespace finevk
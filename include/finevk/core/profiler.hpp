@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief One completed CPU profiler scope
+ */
+struct ProfileEvent {
+    const char* name = nullptr;
+    uint64_t startNs = 0;       ///< Since Profiler::now()'s epoch
+    uint64_t durationNs = 0;
+    uint32_t thread = 0;        ///< Profiler thread index (see Profiler::threadNames())
+};
+
+/**
+ * @brief Frame time percentiles over Profiler's frame history
+ */
+struct FrameTimeStats {
+    size_t frames = 0;          ///< Frames in the history (0 until two markFrame() calls)
+    float mean = 0.0f;          ///< Milliseconds
+    float p50 = 0.0f;
+    float p90 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+};
+
+/**
+ * @brief Lightweight CPU instrumentation with per-thread event rings
+ *
+ * FINEVK_PROFILE_SCOPE(name) times the enclosing block. Each thread writes
+ * its events into its own fixed-size ring (the oldest events are
+ * overwritten), so recording takes no locks; collect() and
+ * writeChromeTrace() copy the rings from any thread.
+ *
+ * Recording is off until setEnabled(true); a disabled scope costs one
+ * relaxed atomic load. Building with FINEVK_ENABLE_PROFILING undefined
+ * (CMake option of the same name) compiles the macros out entirely, and
+ * FINEVK_PROFILE_TRACY forwards them to Tracy zones instead of the rings.
+ *
+ * markFrame() keeps a history of frame times for percentiles whether or
+ * not scopes are being recorded (and in every build). GameLoop calls it
+ * once per frame through FINEVK_PROFILE_FRAME().
+ *
+ * Debug builds can count heap allocations (allocationCount()) to check
+ * that a steady-state frame allocates nothing: lastFrameAllocations()
+ * should read 0 once caches and pools have warmed up.
+ *
+ * Scope names are stored as pointers: use string literals.
+ *
+ * Usage:
+ * @code
+ * Profiler::setEnabled(true);
+ *
+ * void World::update() {
+ *     FINEVK_PROFILE_SCOPE("World::update");
+ *     ...
+ * }
+ *
+ * // Later
+ * Profiler::global().writeChromeTrace("trace.json");  // chrome://tracing, Perfetto
+ * FrameTimeStats stats = Profiler::global().frameStats();
+ * @endcode
+ */
+class Profiler {
+public:
+    static Profiler& global();
+
+    /// Events kept per thread before the oldest are overwritten
+    static constexpr size_t EventsPerThread = 8192;
+
+    /// Frames kept for frameStats()
+    static constexpr size_t FrameHistory = 1024;
+
+    /// Start or stop recording scopes (frame times are always kept)
+    static void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Monotonic nanoseconds since the profiler's epoch
+    static uint64_t now();
+
+    /// Record a completed scope on the calling thread
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    /// Name the calling thread in traces (default: "Thread N")
+    static void setThreadName(const std::string& name);
+
+    /// Mark a frame boundary; the time since the previous mark is one frame
+    static void markFrame();
+
+    /// Percentiles of the last FrameHistory frame times
+    FrameTimeStats frameStats() const;
+
+    /**
+     * @brief Heap allocations made by the process so far
+     *
+     * Counts every call to the global operator new when built with
+     * FINEVK_COUNT_ALLOCATIONS (CMake option of the same name, which
+     * replaces the global allocation functions); always 0 otherwise.
+     */
+    static uint64_t allocationCount();
+
+    /// True when allocationCount() is counting
+    static constexpr bool countsAllocations() {
+#ifdef FINEVK_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// Allocations between the last two markFrame() calls (0 without FINEVK_COUNT_ALLOCATIONS)
+    uint64_t lastFrameAllocations() const;
+
+    /// Forget recorded frame times
+    void resetFrameStats();
+
+    /// Copy every thread's recorded events, oldest first per thread
+    std::vector<ProfileEvent> collect() const;
+
+    /// Names of the threads that recorded events, indexed by ProfileEvent::thread
+    std::vector<std::string> threadNames() const;
+
+    /// Drop all recorded events (frame times are kept)
+    void clear();
+
+    /**
+     * @brief Write recorded events as Chrome trace event JSON
+     *
+     * Opens in chrome://tracing, Perfetto and Speedscope.
+     *
+     * @return false if the file couldn't be written
+     */
+    bool writeChromeTrace(const std::string& path) const;
+
+    // Non-copyable
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+private:
+    Profiler() = default;
+
+    struct ThreadRing;
+    struct State;
+    static State& state();
+    static ThreadRing& threadRing();
+
+    static inline std::atomic<bool> enabled_{false};
+};
+
+/**
+ * @brief RAII timer behind FINEVK_PROFILE_SCOPE
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name_(Profiler::isEnabled() ? name : nullptr)
+        , start_(name_ ? Profiler::now() : 0) {}
+
+    ~ProfileScope() {
+        if (name_) {
+            Profiler::record(name_, start_, Profiler::now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+
+} // namespace finevk
+
+#define FINEVK_PROFILE_CONCAT_INNER(a, b) a##b
+#define FINEVK_PROFILE_CONCAT(a, b) FINEVK_PROFILE_CONCAT_INNER(a, b)
+
+#if defined(FINEVK_PROFILE_TRACY)
+#include <tracy/Tracy.hpp>
+#define FINEVK_PROFILE_SCOPE(name)  ZoneScopedN(name)
+#define FINEVK_PROFILE_FUNCTION()   ZoneScoped
+#define FINEVK_PROFILE_FRAME()      do { FrameMark; finevk::Profiler::markFrame(); } while (0)
+#define FINEVK_PROFILE_THREAD(name) tracy::SetThreadName(name)
+#elif defined(FINEVK_ENABLE_PROFILING)
+#define FINEVK_PROFILE_SCOPE(name) \
+    finevk::ProfileScope FINEVK_PROFILE_CONCAT(finevkProfileScope_, __LINE__)(name)
+#define FINEVK_PROFILE_FUNCTION()   FINEVK_PROFILE_SCOPE(__func__)
+#define FINEVK_PROFILE_FRAME()      finevk::Profiler::markFrame()
+#define FINEVK_PROFILE_THREAD(name) finevk::Profiler::setThreadName(name)
+#else
+#define FINEVK_PROFILE_SCOPE(name)  ((void)0)
+#define FINEVK_PROFILE_FUNCTION()   ((void)0)
+#define FINEVK_PROFILE_FRAME()      finevk::Profiler::markFrame()  // Frame stats stay available
+#define FINEVK_PROFILE_THREAD(name) ((void)0)
+#endif
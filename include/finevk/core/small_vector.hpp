@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace finevk {
+
+/**
+ * @brief Vector with room for N elements inline before it touches the heap
+ *
+ * For short per-call lists (clear values, barriers, descriptor sets) that
+ * would otherwise allocate a std::vector per draw or per frame. Past N
+ * elements storage moves to the heap and grows by doubling, like
+ * std::vector; clear() keeps whatever capacity it has. Moving a vector
+ * that is still inline moves its elements, so pointers into it don't
+ * survive a move either way.
+ *
+ * Converts to Span for CommandBuffer calls.
+ *
+ * Usage:
+ * @code
+ * SmallVector<VkClearValue, 2> clearValues;
+ * clearValues.push_back(colorClear);
+ * clearValues.push_back(depthClear);
+ * cmd.beginRenderPass(renderPass, framebuffer, area, clearValues);
+ * @endcode
+ */
+template<typename T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs inline room for at least one element");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    explicit SmallVector(size_t count, const T& value = T()) {
+        assign(count, value);
+    }
+
+    SmallVector(std::initializer_list<T> list) {
+        reserve(list.size());
+        for (const T& value : list) {
+            emplace_back(value);
+        }
+    }
+
+    SmallVector(const SmallVector& other) {
+        reserve(other.size_);
+        for (const T& value : other) {
+            emplace_back(value);
+        }
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        takeFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (const T& value : other) {
+                emplace_back(value);
+            }
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            releaseHeap();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        clear();
+        releaseHeap();
+    }
+
+    // Element access
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T& operator[](size_t index) { return data_[index]; }
+    const T& operator[](size_t index) const { return data_[index]; }
+    T& front() { return data_[0]; }
+    const T& front() const { return data_[0]; }
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    /// True while the elements live in the inline buffer
+    bool isInline() const { return data_ == inlineData(); }
+
+    /// Inline capacity
+    static constexpr size_t inlineCapacity() { return N; }
+
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            grow(capacity);
+        }
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            T value(std::forward<Args>(args)...);  // args may point into the old storage
+            grow(capacity_ * 2);
+            T* slot = new (data_ + size_) T(std::move(value));
+            size_++;
+            return *slot;
+        }
+        T* slot = new (data_ + size_) T(std::forward<Args>(args)...);
+        size_++;
+        return *slot;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() {
+        size_--;
+        data_[size_].~T();
+    }
+
+    void resize(size_t count, const T& value = T()) {
+        while (size_ > count) {
+            pop_back();
+        }
+        reserve(count);
+        while (size_ < count) {
+            emplace_back(value);
+        }
+    }
+
+    void assign(size_t count, const T& value) {
+        clear();
+        resize(count, value);
+    }
+
+    /// Destroy the elements; capacity (inline or heap) is kept
+    void clear() {
+        for (size_t i = 0; i < size_; i++) {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+
+private:
+    T* inlineData() { return reinterpret_cast<T*>(inline_); }
+    const T* inlineData() const { return reinterpret_cast<const T*>(inline_); }
+
+    void grow(size_t capacity) {
+        capacity = std::max(capacity, capacity_ + 1);
+        T* storage = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        for (size_t i = 0; i < size_; i++) {
+            new (storage + i) T(std::move_if_noexcept(data_[i]));
+            data_[i].~T();
+        }
+        releaseHeap();
+        data_ = storage;
+        capacity_ = capacity;
+    }
+
+    void releaseHeap() {
+        if (!isInline()) {
+            ::operator delete(data_);
+            data_ = inlineData();
+            capacity_ = N;
+        }
+    }
+
+    /// Take other's elements (heap storage is stolen); expects this empty and inline
+    void takeFrom(SmallVector& other) {
+        if (other.isInline()) {
+            for (size_t i = 0; i < other.size_; i++) {
+                new (data_ + i) T(std::move(other.data_[i]));
+            }
+            size_ = other.size_;
+            other.clear();
+        } else {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inlineData();
+            other.size_ = 0;
+            other.capacity_ = N;
+        }
+    }
+
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    T* data_ = inlineData();
+    size_t size_ = 0;
+    size_t capacity_ = N;
+};
+
+} // namespace finevk
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+namespace finevk {
+
+/**
+ * @brief Non-owning view of a contiguous array (pointer + count)
+ *
+ * Stand-in for C++20 std::span in hot-path parameters. Converts from
+ * std::vector, std::array, SmallVector, C arrays and brace lists, so
+ * call sites keep writing {barrier} or {} without building a vector.
+ * A brace list lives until the end of the full expression; don't keep
+ * a Span to one.
+ *
+ * Usage:
+ * @code
+ * void bind(Span<const VkDescriptorSet> sets);
+ *
+ * bind({materialSet, frameSet});       // No allocation
+ * bind(setsVector);                    // Views the vector's storage
+ * bind({sets.data(), sets.size()});    // Pointer + count
+ * @endcode
+ */
+template<typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    constexpr Span() = default;
+    constexpr Span(T* data, size_t size) : data_(data), size_(size) {}
+
+    template<size_t N>
+    constexpr Span(T (&array)[N]) : data_(array), size_(N) {}
+
+    /// Any container with contiguous data() and size() (vector, array, SmallVector, Span)
+    template<typename Container,
+             typename = std::enable_if_t<
+                 !std::is_same_v<std::remove_cv_t<std::remove_reference_t<Container>>, Span> &&
+                 std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>>>
+    constexpr Span(Container&& container)
+        : data_(container.data()), size_(static_cast<size_t>(container.size())) {}
+
+    /// Brace list (read-only spans only)
+    constexpr Span(std::initializer_list<value_type> list)
+        : size_(list.size()) {
+        data_ = list.begin();  // Points at the caller's brace list, alive for the full expression
+    }
+
+    constexpr T* data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+
+    constexpr T& operator[](size_t index) const { return data_[index]; }
+    constexpr T& front() const { return data_[0]; }
+    constexpr T& back() const { return data_[size_ - 1]; }
+
+    constexpr iterator begin() const { return data_; }
+    constexpr iterator end() const { return data_ + size_; }
+
+    /// Elements [offset, offset + count), clamped to the view
+    constexpr Span subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const {
+        if (offset > size_) {
+            offset = size_;
+        }
+        if (count > size_ - offset) {
+            count = size_ - offset;
+        }
+        return Span(data_ + offset, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace finevk
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief Fixed-size worker thread pool
+ *
+ * Small general-purpose pool for CPU-side parallel work (command recording,
+ * culling, asset decoding). Workers are started once and reused, avoiding
+ * per-frame thread creation.
+ *
+ * Usage:
+ * @code
+ * ThreadPool pool(4);
+ * auto result = pool.submit([] { return expensiveWork(); });
+ *
+ * pool.parallelFor(items.size(), [&](size_t begin, size_t end, uint32_t chunk) {
+ *     for (size_t i = begin; i < end; ++i) process(items[i]);
+ * });
+ * @endcode
+ */
+class ThreadPool {
+public:
+    /// Create a pool (threads == 0 uses hardware concurrency)
+    explicit ThreadPool(uint32_t threads = 0);
+
+    /// Shared pool sized to hardware concurrency
+    static ThreadPool& global();
+
+    /// Number of worker threads
+    uint32_t threadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+    /// Queue a task; returns a future for its result
+    template<typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+        std::future<R> future = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    /**
+     * @brief Split [0, count) into at most maxChunks contiguous chunks and run them in parallel
+     *
+     * The calling thread runs the last chunk itself. Blocks until every chunk
+     * has finished and rethrows the first exception. fn receives
+     * (begin, end, chunkIndex); chunk indices are dense from 0.
+     *
+     * Do not call from inside a task running on the same pool: the caller
+     * blocks on chunks that may be queued behind it.
+     *
+     * @return Number of chunks used
+     */
+    uint32_t parallelFor(size_t count,
+                         const std::function<void(size_t, size_t, uint32_t)>& fn,
+                         uint32_t maxChunks = 0);
+
+    /// Destructor - finishes queued tasks and joins workers
+    ~ThreadPool();
+
+    // Non-copyable
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    void enqueue(std::function<void()> task);
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+} // namespace finevk
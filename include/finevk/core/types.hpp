@@ -18,6 +18,7 @@ class ImageView;
 class SwapChain;
 class RenderPass;
 class GraphicsPipeline;
+class ComputePipeline;
 class PipelineLayout;
 class ShaderModule;
 class Framebuffer;
@@ -25,14 +26,28 @@ class CommandPool;
 class CommandBuffer;
 class DescriptorSetLayout;
 class DescriptorPool;
+class DescriptorUpdateTemplate;
 class Semaphore;
 class Fence;
 class Sampler;
+class SamplerCache;
 class Texture;
 class Mesh;
 class Window;
 class RenderTarget;
 class Material;
+class UploadManager;
+class UniformRing;
+class BindlessTable;
+class DescriptorAllocator;
+class TextureStreamer;
+class MipGenerator;
+class VirtualTexture;
+class GpuProfiler;
+class AsyncCompute;
+class ImageReadback;
+class AssetLoader;
+class DynamicResolution;
 
 // Smart pointer typedefs for ownership
 using InstancePtr = std::unique_ptr<Instance>;
@@ -46,6 +61,7 @@ using SwapChainPtr = std::unique_ptr<SwapChain>;
 using RenderPassPtr = std::unique_ptr<RenderPass>;
 using PipelinePtr = std::unique_ptr<GraphicsPipeline>;
 using GraphicsPipelinePtr = std::unique_ptr<GraphicsPipeline>;
+using ComputePipelinePtr = std::unique_ptr<ComputePipeline>;
 using PipelineLayoutPtr = std::unique_ptr<PipelineLayout>;
 using ShaderModulePtr = std::unique_ptr<ShaderModule>;
 using FramebufferPtr = std::unique_ptr<Framebuffer>;
@@ -53,6 +69,7 @@ using CommandPoolPtr = std::unique_ptr<CommandPool>;
 using CommandBufferPtr = std::unique_ptr<CommandBuffer>;
 using DescriptorSetLayoutPtr = std::unique_ptr<DescriptorSetLayout>;
 using DescriptorPoolPtr = std::unique_ptr<DescriptorPool>;
+using DescriptorUpdateTemplatePtr = std::unique_ptr<DescriptorUpdateTemplate>;
 using SemaphorePtr = std::unique_ptr<Semaphore>;
 using FencePtr = std::unique_ptr<Fence>;
 using SamplerPtr = std::unique_ptr<Sampler>;
@@ -60,10 +77,24 @@ using WindowPtr = std::unique_ptr<Window>;
 using RenderTargetPtr = std::unique_ptr<RenderTarget>;
 using MaterialPtr = std::unique_ptr<Material>;
 using TexturePtr = std::unique_ptr<Texture>;
+using UploadManagerPtr = std::unique_ptr<UploadManager>;
+using UniformRingPtr = std::unique_ptr<UniformRing>;
+using BindlessTablePtr = std::unique_ptr<BindlessTable>;
+using DescriptorAllocatorPtr = std::unique_ptr<DescriptorAllocator>;
+using TextureStreamerPtr = std::unique_ptr<TextureStreamer>;
+using MipGeneratorPtr = std::unique_ptr<MipGenerator>;
+using VirtualTexturePtr = std::unique_ptr<VirtualTexture>;
+using GpuProfilerPtr = std::unique_ptr<GpuProfiler>;
+using AsyncComputePtr = std::unique_ptr<AsyncCompute>;
+using ImageReadbackPtr = std::unique_ptr<ImageReadback>;
+using AssetLoaderPtr = std::unique_ptr<AssetLoader>;
+using DynamicResolutionPtr = std::unique_ptr<DynamicResolution>;
 
 // Shared pointer typedefs for shared resources
 using TextureRef = std::shared_ptr<Texture>;
 using MeshRef = std::shared_ptr<Mesh>;
 using ShaderRef = std::shared_ptr<ShaderModule>;
+using SamplerRef = std::shared_ptr<Sampler>;
+using GraphicsPipelineRef = std::shared_ptr<GraphicsPipeline>;
 
 } // namespace finevk
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/logical_device.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandPool;
+class CommandBuffer;
+class Buffer;
+class Image;
+class Fence;
+
+/**
+ * @brief Direction of a queue-family ownership transfer
+ */
+enum class QueueHandoff {
+    ComputeToGraphics,  ///< Compute results consumed by graphics (culling, particles, mips)
+    GraphicsToCompute   ///< Graphics output consumed by compute (e.g. depth for Hi-Z)
+};
+
+/**
+ * @brief Compute work submitted on the compute queue, overlapping graphics
+ *
+ * Records into one command buffer per frame in flight on the device's
+ * compute queue and submits it with Queue::submitAfter(), so it can wait on
+ * graphics timeline points and hands back a TimelinePoint that graphics
+ * submissions wait on in turn (SimpleRenderer::waitFor(), or
+ * Queue::submitAfter() directly). Graphics and compute then overlap on the
+ * GPU instead of serializing on one queue.
+ *
+ * Without a separate compute queue family (or without timeline semaphores)
+ * the work goes to the graphics queue instead and isAsync() is false; the
+ * same code still runs, it just doesn't overlap.
+ *
+ * Resources shared between the queues use EXCLUSIVE sharing, so when the
+ * families differ they change owner with a release barrier on the source
+ * queue followed by an acquire barrier on the destination queue, and the
+ * acquiring submission must wait on the releasing one. release() and
+ * acquire() record both halves; on a single family release() records
+ * nothing and acquire() records an ordinary barrier.
+ *
+ * Not thread-safe: record and submit from one thread.
+ *
+ * Usage:
+ * @code
+ * auto compute = AsyncCompute::create(device).build();
+ *
+ * // Each frame
+ * CommandBuffer& cmd = compute->begin();
+ * cmd.bindPipeline(*cullPipeline);
+ * cmd.dispatch(groups, 1, 1);
+ * compute->release(cmd, *drawBuffer, QueueHandoff::ComputeToGraphics,
+ *                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+ * TimelinePoint culled = compute->submit();
+ *
+ * renderer->beginFrame();
+ * compute->acquire(renderer->getCommandBuffer(), *drawBuffer, QueueHandoff::ComputeToGraphics,
+ *                  VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+ * renderer->waitFor(culled, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+ * @endcode
+ */
+class AsyncCompute {
+public:
+    /**
+     * @brief Builder for creating AsyncCompute objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Number of command buffers cycled (default: the device's maxFramesInFlight())
+        Builder& framesInFlight(uint32_t count);
+
+        /// Force the graphics queue even if a compute queue exists
+        Builder& useGraphicsQueue(bool enable = true);
+
+        /// Build the scheduler
+        AsyncComputePtr build();
+
+    private:
+        LogicalDevice* device_;
+        uint32_t framesInFlight_ = 0;
+        bool useGraphicsQueue_ = false;
+    };
+
+    /// Create a builder for async compute
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /**
+     * @brief Begin recording the next compute batch
+     *
+     * Waits until the batch that last used this slot has completed, resets
+     * its pool and begins the command buffer for one-time submit.
+     *
+     * @throws std::runtime_error if a batch is already being recorded
+     */
+    CommandBuffer& begin();
+
+    /**
+     * @brief End and submit the batch begun by begin()
+     *
+     * The batch waits for every point in waits (typically the graphics work
+     * that produced its inputs) at waitStages.
+     *
+     * @return Point that completes with the batch (on the graphics timeline
+     *         when not async; value 0 without timelines)
+     */
+    TimelinePoint submit(const std::vector<TimelinePoint>& waits = {},
+                         VkPipelineStageFlags waitStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    /// Point of the last submitted batch
+    TimelinePoint lastSubmitted() const { return {queue_, last_}; }
+
+    /// Block until every submitted batch has completed
+    void waitIdle();
+
+    /**
+     * @brief Record the release half of a buffer ownership transfer
+     *
+     * Recorded on the source queue's command buffer (the compute batch for
+     * ComputeToGraphics) after its last write. No-op on a single family.
+     */
+    void release(CommandBuffer& cmd, const Buffer& buffer, QueueHandoff handoff,
+                 VkPipelineStageFlags srcStage, VkAccessFlags srcAccess) const;
+
+    /**
+     * @brief Record the acquire half of a buffer ownership transfer
+     *
+     * Recorded on the destination queue's command buffer before the first
+     * use; the submission must wait on the releasing batch. On a single
+     * family this is a plain memory barrier from all earlier writes.
+     */
+    void acquire(CommandBuffer& cmd, const Buffer& buffer, QueueHandoff handoff,
+                 VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) const;
+
+    /// Release an image (all mips and layers), changing its layout on the way
+    void release(CommandBuffer& cmd, const Image& image, QueueHandoff handoff,
+                 VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                 VkImageLayout oldLayout, VkImageLayout newLayout,
+                 VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT) const;
+
+    /// Acquire an image released with the same layouts
+    void acquire(CommandBuffer& cmd, const Image& image, QueueHandoff handoff,
+                 VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+                 VkImageLayout oldLayout, VkImageLayout newLayout,
+                 VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT) const;
+
+    /// True if batches run on a separate compute queue
+    bool isAsync() const { return ownershipTransfer_; }
+
+    /// True if shared resources need release/acquire barriers
+    bool needsOwnershipTransfer() const { return ownershipTransfer_; }
+
+    /// Queue batches are submitted to
+    Queue* queue() const { return queue_; }
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    uint32_t framesInFlight() const { return static_cast<uint32_t>(slots_.size()); }
+
+    /// Destructor - waits for in-flight batches
+    ~AsyncCompute();
+
+    // Non-copyable
+    AsyncCompute(const AsyncCompute&) = delete;
+    AsyncCompute& operator=(const AsyncCompute&) = delete;
+
+private:
+    friend class Builder;
+    AsyncCompute() = default;
+
+    struct Slot {
+        std::unique_ptr<CommandPool> pool;
+        CommandBufferPtr cmd;
+        std::unique_ptr<Fence> fence;   // Only without a queue timeline
+        uint64_t value = 0;             // Timeline value of the last batch
+    };
+
+    void waitSlot(Slot& slot);
+    void families(QueueHandoff handoff, uint32_t& src, uint32_t& dst) const;
+
+    LogicalDevice* device_ = nullptr;
+    Queue* queue_ = nullptr;
+    uint32_t graphicsFamily_ = 0;
+    bool ownershipTransfer_ = false;
+
+    std::vector<Slot> slots_;
+    Slot* recording_ = nullptr;
+    uint64_t next_ = 0;
+    uint64_t last_ = 0;
+};
+
+} // namespace finevk
@@ -1,21 +1,33 @@
 #pragma once
 
 #include "finevk/device/memory.hpp"
+#include "finevk/device/command.hpp"
 #include "finevk/core/types.hpp"
 
 #include <vulkan/vulkan.h>
+#include <functional>
 #include <memory>
+#include <optional>
 
 namespace finevk {
 
 class LogicalDevice;
-class CommandPool;
 
 /**
  * @brief Vulkan buffer wrapper with memory management
+ *
+ * A relocatable buffer may be moved to other memory by
+ * MemoryAllocator::defragment(); handle() then changes between frames, so
+ * look it up when recording rather than caching it, and rewrite
+ * descriptors that reference the buffer from the relocation callback.
+ * Only GpuOnly buffers without a host mapping are moved, and they must not
+ * be written while movePending().
  */
-class Buffer {
+class Buffer : private Relocatable {
 public:
+    /// Called after a relocatable buffer switched to a new VkBuffer
+    using RelocationCallback = std::function<void(Buffer&)>;
+
     /**
      * @brief Builder for creating Buffer objects
      */
@@ -32,6 +44,12 @@ public:
         /// Set memory usage hint
         Builder& memoryUsage(MemoryUsage memUsage);
 
+        /// Set the statistics category (default: inferred from usage flags)
+        Builder& category(MemoryCategory category);
+
+        /// Let the defragmenter move this buffer (adds transfer src/dst usage; GpuOnly only)
+        Builder& relocatable(bool enable = true);
+
         /// Build the buffer
         BufferPtr build();
 
@@ -40,6 +58,8 @@ public:
         VkDeviceSize size_ = 0;
         VkBufferUsageFlags usage_ = 0;
         MemoryUsage memUsage_ = MemoryUsage::GpuOnly;
+        std::optional<MemoryCategory> category_;
+        bool relocatable_ = false;
     };
 
     /// Create a builder for a buffer
@@ -57,7 +77,7 @@ public:
     static BufferPtr createIndexBuffer(LogicalDevice& device, VkDeviceSize size) { return createIndexBuffer(&device, size); }
     static BufferPtr createIndexBuffer(const LogicalDevicePtr& device, VkDeviceSize size) { return createIndexBuffer(device.get(), size); }
 
-    /// Create a uniform buffer (CPU-visible for frequent updates)
+    /// Create a uniform buffer (GpuDirectWrite: written straight into VRAM where the device allows)
     static BufferPtr createUniformBuffer(LogicalDevice* device, VkDeviceSize size);
     static BufferPtr createUniformBuffer(LogicalDevice& device, VkDeviceSize size) { return createUniformBuffer(&device, size); }
     static BufferPtr createUniformBuffer(const LogicalDevicePtr& device, VkDeviceSize size) { return createUniformBuffer(device.get(), size); }
@@ -82,20 +102,57 @@ public:
     /// Get mapped pointer (nullptr if not mapped)
     void* mappedPtr() const { return allocation_.mappedPtr; }
 
+    /// Check if the defragmenter may move this buffer
+    bool isRelocatable() const { return relocatable_; }
+
+    /// True between a move's copy and its commit; writes then would be lost
+    bool movePending() const { return movingBuffer_ != VK_NULL_HANDLE; }
+
+    /**
+     * @brief Set the callback run after each relocation
+     *
+     * Runs on the thread calling MemoryAllocator::defragment() with the
+     * allocator locked, so it must not create or free resources; updating
+     * descriptor sets is fine.
+     */
+    void setRelocationCallback(RelocationCallback callback) { relocationCallback_ = std::move(callback); }
+
     /// Map the buffer memory (returns existing mapping if already mapped)
     void* map();
 
     /// Unmap the buffer memory
     void unmap();
 
+    /// True if the memory is host coherent, so mapped access needs no flush() / invalidate()
+    bool isCoherent() const;
+
+    /**
+     * @brief Make CPU writes through mappedPtr() visible to the GPU
+     *
+     * Needed for non-coherent memory (CpuOnly, GpuToCpu on many drivers)
+     * before submitting work that reads the range; a no-op otherwise. The
+     * range is widened to nonCoherentAtomSize. upload() flushes for you.
+     */
+    void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    /// Make GPU writes visible to mappedPtr() reads; call after the writing submit's fence, before reading
+    void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
     /// Upload data to the buffer
-    /// For GPU-only buffers, this uses an internal staging buffer
+    /// Mappable buffers (including GpuDirectWrite) are written directly;
+    /// GPU-only buffers use an internal staging buffer.
+    /// Uploads and copyFrom() throw while movePending().
     void upload(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
 
     /// Upload data using a provided command pool for staging
     void upload(const void* data, VkDeviceSize size, VkDeviceSize offset,
                 CommandPool* commandPool);
 
+    /// Upload without blocking; the returned ticket keeps the staging buffer
+    /// alive until the copy finishes (empty ticket for mappable buffers)
+    SubmitTicket uploadAsync(const void* data, VkDeviceSize size, VkDeviceSize offset,
+                             CommandPool* commandPool);
+
     /// Copy data from a staging buffer
     void copyFrom(Buffer& src, VkDeviceSize size, CommandPool* commandPool);
 
@@ -115,12 +172,26 @@ private:
     Buffer() = default;
 
     void cleanup();
+    void takeRelocation(Buffer& other);
+    void checkWritable() const;
+
+    // Relocatable
+    const AllocationInfo& allocation() const override { return allocation_; }
+    bool beginMove(CommandBuffer& cmd, const AllocationInfo& target) override;
+    std::function<void()> commitMove() override;
+    std::function<void()> cancelMove() override;
 
     LogicalDevice* device_ = nullptr;
     VkBuffer buffer_ = VK_NULL_HANDLE;
     VkDeviceSize size_ = 0;
+    VkBufferUsageFlags usage_ = 0;
     AllocationInfo allocation_;
     MemoryUsage memoryUsage_ = MemoryUsage::GpuOnly;
+
+    bool relocatable_ = false;
+    VkBuffer movingBuffer_ = VK_NULL_HANDLE;      // New handle while a move is pending
+    AllocationInfo movingAllocation_;
+    RelocationCallback relocationCallback_;
 };
 
 } // namespace finevk
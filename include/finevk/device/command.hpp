@@ -1,11 +1,14 @@
 #pragma once
 
 #include "finevk/core/types.hpp"
+#include "finevk/core/span.hpp"
+#include "finevk/core/small_vector.hpp"
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 #include <vector>
 #include <memory>
+#include <functional>
 
 namespace finevk {
 
@@ -16,6 +19,7 @@ class Image;
 class GraphicsPipeline;
 class PipelineLayout;
 class RenderTarget;
+class GpuProfiler;
 
 /**
  * @brief Command pool flags
@@ -91,8 +95,57 @@ private:
     VkCommandPool pool_ = VK_NULL_HANDLE;
 };
 
+/**
+ * @brief Commands recorded into a command buffer
+ *
+ * Counted by the CommandBuffer methods themselves (commands recorded
+ * through handle() directly are not seen). Reset by begin() and
+ * beginSecondary(). triangles assumes triangle lists and only covers
+ * direct draws; pipeline statistics queries (GpuProfiler) give exact
+ * GPU-side counts.
+ */
+struct CommandStats {
+    uint32_t draws = 0;             ///< Direct draw calls
+    uint32_t indirectDraws = 0;     ///< Indirect draw calls (each may issue many draws)
+    uint32_t dispatches = 0;
+    uint64_t instances = 0;         ///< Summed over direct draws
+    uint64_t triangles = 0;         ///< Summed over direct draws
+    uint32_t pipelineBinds = 0;
+    uint32_t descriptorBinds = 0;   ///< vkCmdBindDescriptorSets calls
+    uint32_t vertexBufferBinds = 0;
+    uint32_t indexBufferBinds = 0;
+    uint32_t pushConstants = 0;
+    uint32_t barriers = 0;          ///< vkCmdPipelineBarrier calls
+    uint32_t renderPasses = 0;
+    uint32_t secondaries = 0;       ///< Secondary command buffers executed
+    uint32_t transfers = 0;         ///< Copies and fills
+    uint64_t transferBytes = 0;     ///< Bytes of buffer-to-buffer copies
+
+    CommandStats& operator+=(const CommandStats& other) {
+        draws += other.draws;
+        indirectDraws += other.indirectDraws;
+        dispatches += other.dispatches;
+        instances += other.instances;
+        triangles += other.triangles;
+        pipelineBinds += other.pipelineBinds;
+        descriptorBinds += other.descriptorBinds;
+        vertexBufferBinds += other.vertexBufferBinds;
+        indexBufferBinds += other.indexBufferBinds;
+        pushConstants += other.pushConstants;
+        barriers += other.barriers;
+        renderPasses += other.renderPasses;
+        secondaries += other.secondaries;
+        transfers += other.transfers;
+        transferBytes += other.transferBytes;
+        return *this;
+    }
+};
+
 /**
  * @brief Vulkan command buffer wrapper
+ *
+ * Array parameters are Spans, so recording never allocates: pass brace
+ * lists ({set}, {} for none), vectors, SmallVectors or pointer + count.
  */
 class CommandBuffer {
 public:
@@ -107,6 +160,30 @@ public:
     void end();
     void reset();
 
+    /**
+     * @brief Begin a secondary command buffer that continues a render pass
+     *
+     * Fills VkCommandBufferInheritanceInfo for the given render pass/subpass.
+     * framebuffer may be VK_NULL_HANDLE, but passing it lets drivers optimize.
+     */
+    void beginSecondary(VkRenderPass renderPass, uint32_t subpass,
+                        VkFramebuffer framebuffer = VK_NULL_HANDLE,
+                        VkCommandBufferUsageFlags flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+    /**
+     * @brief Begin a secondary that inherits the primary's current render pass
+     *
+     * The primary must be inside a render pass begun with
+     * VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. Viewport and scissor last
+     * set on the primary are replayed (dynamic state is not inherited).
+     */
+    void beginSecondary(const CommandBuffer& primary,
+                        VkCommandBufferUsageFlags flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+    /// Execute secondary command buffers from this primary
+    void executeCommands(Span<const VkCommandBuffer> secondaries);
+    void executeCommands(CommandBuffer& secondary);
+
     // Pipeline binding
     void bindPipeline(VkPipelineBindPoint bindPoint, VkPipeline pipeline);
 
@@ -121,23 +198,31 @@ public:
         VkPipelineBindPoint bindPoint,
         VkPipelineLayout layout,
         uint32_t firstSet,
-        const std::vector<VkDescriptorSet>& sets,
-        const std::vector<uint32_t>& dynamicOffsets = {});
+        Span<const VkDescriptorSet> sets,
+        Span<const uint32_t> dynamicOffsets = {});
 
     /// Bind descriptor sets for graphics (accepts reference, pointer, or smart pointer)
+    /// dynamicOffsets: one per dynamic binding in the sets, in binding order
     void bindDescriptorSets(
         PipelineLayout& layout,
         uint32_t firstSet,
-        const std::vector<VkDescriptorSet>& sets);
+        Span<const VkDescriptorSet> sets,
+        Span<const uint32_t> dynamicOffsets = {});
     void bindDescriptorSets(
         PipelineLayout* layout,
         uint32_t firstSet,
-        const std::vector<VkDescriptorSet>& sets) { bindDescriptorSets(*layout, firstSet, sets); }
+        Span<const VkDescriptorSet> sets,
+        Span<const uint32_t> dynamicOffsets = {}) {
+        bindDescriptorSets(*layout, firstSet, sets, dynamicOffsets);
+    }
     template<typename T>
     void bindDescriptorSets(
         const std::unique_ptr<T>& layout,
         uint32_t firstSet,
-        const std::vector<VkDescriptorSet>& sets) { bindDescriptorSets(*layout, firstSet, sets); }
+        Span<const VkDescriptorSet> sets,
+        Span<const uint32_t> dynamicOffsets = {}) {
+        bindDescriptorSets(*layout, firstSet, sets, dynamicOffsets);
+    }
 
     /// Bind a single descriptor set for graphics (accepts reference, pointer, or smart pointer)
     void bindDescriptorSet(PipelineLayout& layout, VkDescriptorSet set, uint32_t setIndex = 0);
@@ -149,12 +234,25 @@ public:
         bindDescriptorSet(*layout, set, setIndex);
     }
 
+    /// Bind a single descriptor set with one dynamic uniform/storage binding
+    void bindDescriptorSet(PipelineLayout& layout, VkDescriptorSet set, uint32_t setIndex,
+                           uint32_t dynamicOffset);
+    void bindDescriptorSet(PipelineLayout* layout, VkDescriptorSet set, uint32_t setIndex,
+                           uint32_t dynamicOffset) {
+        bindDescriptorSet(*layout, set, setIndex, dynamicOffset);
+    }
+    template<typename T>
+    void bindDescriptorSet(const std::unique_ptr<T>& layout, VkDescriptorSet set, uint32_t setIndex,
+                           uint32_t dynamicOffset) {
+        bindDescriptorSet(*layout, set, setIndex, dynamicOffset);
+    }
+
     // Vertex/index binding
     void bindVertexBuffer(Buffer& buffer, VkDeviceSize offset = 0);
     void bindVertexBuffers(
         uint32_t firstBinding,
-        const std::vector<VkBuffer>& buffers,
-        const std::vector<VkDeviceSize>& offsets);
+        Span<const VkBuffer> buffers,
+        Span<const VkDeviceSize> offsets);
     void bindIndexBuffer(Buffer& buffer, VkIndexType type, VkDeviceSize offset = 0);
 
     // Dynamic state
@@ -165,6 +263,21 @@ public:
     void setScissor(int32_t x, int32_t y, uint32_t width, uint32_t height);
     void setViewportAndScissor(uint32_t width, uint32_t height);
 
+    /**
+     * @brief Set the per-draw fragment size (VK_KHR_fragment_shading_rate)
+     *
+     * One fragment shader invocation covers a width x height pixel block
+     * for later draws with GraphicsPipeline::Builder::dynamicFragmentShadingRate().
+     * {1, 1} restores full rate; unsupported sizes are clamped by the
+     * driver. The combiners keep this rate over primitive and attachment
+     * rates by default.
+     *
+     * @throws std::runtime_error if fragment shading rate wasn't enabled
+     */
+    void setFragmentShadingRate(VkExtent2D fragmentSize,
+                                VkFragmentShadingRateCombinerOpKHR primitiveCombiner = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+                                VkFragmentShadingRateCombinerOpKHR attachmentCombiner = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR);
+
     // Draw commands
     void draw(uint32_t vertexCount, uint32_t instanceCount = 1,
               uint32_t firstVertex = 0, uint32_t firstInstance = 0);
@@ -172,6 +285,25 @@ public:
                      uint32_t firstIndex = 0, int32_t vertexOffset = 0,
                      uint32_t firstInstance = 0);
 
+    // Indirect draws (VkDrawIndirectCommand / VkDrawIndexedIndirectCommand records in buffer)
+    void drawIndirect(Buffer& buffer, VkDeviceSize offset, uint32_t drawCount,
+                      uint32_t stride = sizeof(VkDrawIndirectCommand));
+    void drawIndexedIndirect(Buffer& buffer, VkDeviceSize offset, uint32_t drawCount,
+                             uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
+
+    /// Draw count read from countBuffer; requires the drawIndirectCount feature
+    void drawIndexedIndirectCount(Buffer& buffer, VkDeviceSize offset,
+                                  Buffer& countBuffer, VkDeviceSize countOffset,
+                                  uint32_t maxDrawCount,
+                                  uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
+
+    // Compute
+    void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
+
+    /// Fill a buffer range with a repeated 32-bit value (outside render passes)
+    void fillBuffer(Buffer& buffer, uint32_t data,
+                    VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
     // Push constants
     void pushConstants(
         VkPipelineLayout layout,
@@ -185,7 +317,7 @@ public:
         VkRenderPass renderPass,
         VkFramebuffer framebuffer,
         VkRect2D renderArea,
-        const std::vector<VkClearValue>& clearValues,
+        Span<const VkClearValue> clearValues,
         VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
     /**
@@ -201,7 +333,8 @@ public:
     void beginRenderPass(
         RenderTarget& renderTarget,
         const glm::vec4& clearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
-        float clearDepth = 1.0f);
+        float clearDepth = 1.0f,
+        VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
     void beginRenderPass(RenderTarget* renderTarget, const glm::vec4& clearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), float clearDepth = 1.0f) {
         beginRenderPass(*renderTarget, clearColor, clearDepth);
     }
@@ -213,6 +346,27 @@ public:
     void endRenderPass();
     void nextSubpass(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
+    /**
+     * @brief Begin rendering without a render pass (VK_KHR_dynamic_rendering)
+     *
+     * Needs LogicalDevice::supportsDynamicRendering(); attachments must
+     * already be in the layouts the info names. Counts as a render pass in
+     * stats(). Secondaries can't inherit dynamic rendering here, so record
+     * inline.
+     *
+     * @throws std::runtime_error if dynamic rendering wasn't enabled
+     */
+    void beginRendering(const VkRenderingInfoKHR& info);
+    void endRendering();
+
+    /// Render pass currently being recorded (VK_NULL_HANDLE outside a render pass)
+    VkRenderPass activeRenderPass() const { return activeRenderPass_; }
+    VkFramebuffer activeFramebuffer() const { return activeFramebuffer_; }
+    uint32_t activeSubpass() const { return activeSubpass_; }
+
+    /// Contents mode of the current subpass
+    VkSubpassContents activeSubpassContents() const { return activeContents_; }
+
     // Copy operations
     void copyBuffer(Buffer& src, Buffer& dst, VkDeviceSize size,
                     VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
@@ -230,9 +384,48 @@ public:
         VkPipelineStageFlags srcStageMask,
         VkPipelineStageFlags dstStageMask,
         VkDependencyFlags dependencyFlags,
-        const std::vector<VkMemoryBarrier>& memoryBarriers,
-        const std::vector<VkBufferMemoryBarrier>& bufferMemoryBarriers,
-        const std::vector<VkImageMemoryBarrier>& imageMemoryBarriers);
+        Span<const VkMemoryBarrier> memoryBarriers,
+        Span<const VkBufferMemoryBarrier> bufferMemoryBarriers,
+        Span<const VkImageMemoryBarrier> imageMemoryBarriers);
+
+    /// Global memory barrier between two stages
+    void memoryBarrier(VkPipelineStageFlags srcStageMask, VkAccessFlags srcAccessMask,
+                       VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask);
+
+    /**
+     * @brief Synchronization2 barrier with per-barrier stage masks
+     *
+     * Records vkCmdPipelineBarrier2 with LogicalDevice::supportsSynchronization2().
+     * Without it, one vkCmdPipelineBarrier is recorded instead, waiting on
+     * the union of every barrier's masks (see legacyStageMask()), so callers
+     * can use this path unconditionally.
+     */
+    void pipelineBarrier2(const VkDependencyInfoKHR& dependency);
+
+    void pipelineBarrier2(
+        Span<const VkMemoryBarrier2KHR> memoryBarriers,
+        Span<const VkBufferMemoryBarrier2KHR> bufferMemoryBarriers,
+        Span<const VkImageMemoryBarrier2KHR> imageMemoryBarriers,
+        VkDependencyFlags dependencyFlags = 0);
+
+    /// Global synchronization2 memory barrier
+    void memoryBarrier2(VkPipelineStageFlags2KHR srcStageMask, VkAccessFlags2KHR srcAccessMask,
+                        VkPipelineStageFlags2KHR dstStageMask, VkAccessFlags2KHR dstAccessMask);
+
+    // GPU profiling
+
+    /// Attach a profiler that beginScope()/endScope() record into (nullptr detaches)
+    void setProfiler(GpuProfiler* profiler) { profiler_ = profiler; }
+    GpuProfiler* profiler() const { return profiler_; }
+
+    /// Open a named GPU timing scope (no-op without a profiler; name must outlive it)
+    void beginScope(const char* name);
+
+    /// Close the innermost GPU timing scope
+    void endScope();
+
+    /// Commands recorded since the last begin (see CommandStats)
+    const CommandStats& stats() const { return stats_; }
 
     /// Destructor
     ~CommandBuffer();
@@ -250,9 +443,223 @@ private:
     CommandBuffer(CommandPool* pool, VkCommandBuffer buffer);
 
     void cleanup();
+    void beginInherited(VkRenderPass renderPass, uint32_t subpass, VkFramebuffer framebuffer,
+                        VkCommandBufferUsageFlags flags, VkQueryPipelineStatisticFlags pipelineStatistics);
 
     CommandPool* pool_ = nullptr;
     VkCommandBuffer buffer_ = VK_NULL_HANDLE;
+
+    // Recorded state needed to set up secondaries
+    VkRenderPass activeRenderPass_ = VK_NULL_HANDLE;
+    VkFramebuffer activeFramebuffer_ = VK_NULL_HANDLE;
+    uint32_t activeSubpass_ = 0;
+    VkSubpassContents activeContents_ = VK_SUBPASS_CONTENTS_INLINE;
+    VkViewport viewport_{};
+    VkRect2D scissor_{};
+    bool hasViewport_ = false;
+    bool hasScissor_ = false;
+
+    GpuProfiler* profiler_ = nullptr;
+    CommandStats stats_;
+};
+
+/**
+ * @brief Nearest VkPipelineStageFlags for a synchronization2 stage mask
+ *
+ * Stages new in synchronization2 (copy, index input, ...) widen to the
+ * original stage containing them. An empty mask becomes none, which should
+ * be TOP_OF_PIPE for a source scope and BOTTOM_OF_PIPE for a destination.
+ */
+VkPipelineStageFlags legacyStageMask(VkPipelineStageFlags2KHR stages, VkPipelineStageFlags none);
+
+/// Nearest VkAccessFlags for a synchronization2 access mask
+VkAccessFlags legacyAccessMask(VkAccessFlags2KHR access);
+
+/**
+ * @brief Barriers collected and recorded as one synchronization2 barrier
+ *
+ * Each barrier keeps its own stage masks, so batching many transitions
+ * into one command doesn't widen any of them (on the fallback path the
+ * masks are merged). A few barriers of each kind are stored inline; reuse
+ * one batch for larger sets to avoid per-frame allocation.
+ *
+ * Usage:
+ * @code
+ * BarrierBatch barriers;
+ * barriers.buffer(*vertexBuffer, VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+ *                 VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR);
+ * barriers.image(*texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+ *                VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+ *                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+ * barriers.record(cmd);  // One barrier command, then empty again
+ * @endcode
+ */
+class BarrierBatch {
+public:
+    /// Global memory dependency
+    BarrierBatch& memory(VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+                         VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess);
+
+    /// Buffer range dependency (whole buffer by default)
+    BarrierBatch& buffer(const Buffer& buffer,
+                         VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+                         VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess,
+                         VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    /// Image layout transition and dependency over all mips and layers
+    BarrierBatch& image(const Image& image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                        VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+                        VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess,
+                        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+
+    /// Add a fully specified image barrier (e.g. a single mip or a queue transfer)
+    BarrierBatch& image(const VkImageMemoryBarrier2KHR& barrier);
+
+    /// Record everything added so far as one barrier and clear the batch
+    void record(CommandBuffer& cmd);
+
+    bool empty() const { return memory_.empty() && buffers_.empty() && images_.empty(); }
+    void clear();
+
+private:
+    SmallVector<VkMemoryBarrier2KHR, 2> memory_;
+    SmallVector<VkBufferMemoryBarrier2KHR, 4> buffers_;
+    SmallVector<VkImageMemoryBarrier2KHR, 4> images_;
+};
+
+/**
+ * @brief Per-frame, per-thread command pools
+ *
+ * Holds one pool per (frame-in-flight, recording thread). beginFrame() resets
+ * every pool of that frame with a single vkResetCommandPool, so command
+ * buffers are never reset individually. Buffers allocated from a pool are
+ * cached and handed out again on later frames.
+ *
+ * Each thread index must only be used by one thread at a time; no locking is
+ * done. Call beginFrame() only after the frame's fence has signaled.
+ *
+ * Usage:
+ * @code
+ * FrameCommandPools pools(device, device->graphicsQueue(), 0, workerCount);  // 0 = device's max
+ *
+ * // Each frame, after waiting for the frame's fence:
+ * pools.beginFrame(frameIndex);
+ * CommandBuffer& secondary = pools.acquire(threadIndex, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+ * @endcode
+ */
+class FrameCommandPools {
+public:
+    /// framesInFlight 0 uses LogicalDevice::maxFramesInFlight()
+    FrameCommandPools(LogicalDevice* device, Queue* queue,
+                      uint32_t framesInFlight, uint32_t threadCount,
+                      CommandPoolFlags flags = CommandPoolFlags::Transient);
+    FrameCommandPools(const LogicalDevicePtr& device, Queue* queue,
+                      uint32_t framesInFlight, uint32_t threadCount,
+                      CommandPoolFlags flags = CommandPoolFlags::Transient)
+        : FrameCommandPools(device.get(), queue, framesInFlight, threadCount, flags) {}
+
+    /// Reset all pools for a frame and make it current
+    void beginFrame(uint32_t frameIndex);
+
+    /// Get a command buffer for the current frame (valid until that frame's next beginFrame)
+    CommandBuffer& acquire(uint32_t thread,
+                           VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+    /// Pool used by a thread for the current frame
+    CommandPool& pool(uint32_t thread);
+
+    /// Summed stats of every buffer acquired for the current frame (call after recording)
+    CommandStats stats() const;
+
+    uint32_t threadCount() const { return threadCount_; }
+    uint32_t framesInFlight() const { return framesInFlight_; }
+    uint32_t currentFrame() const { return currentFrame_; }
+
+    // Non-copyable
+    FrameCommandPools(const FrameCommandPools&) = delete;
+    FrameCommandPools& operator=(const FrameCommandPools&) = delete;
+
+private:
+    struct Slot {
+        CommandPoolPtr pool;  // Declared first so it is destroyed after its buffers
+        std::vector<CommandBufferPtr> primaries;
+        std::vector<CommandBufferPtr> secondaries;
+        size_t usedPrimaries = 0;
+        size_t usedSecondaries = 0;
+    };
+
+    Slot& slot(uint32_t thread);
+
+    uint32_t framesInFlight_;
+    uint32_t threadCount_;
+    uint32_t currentFrame_ = 0;
+    std::vector<Slot> slots_;  // [frame * threadCount + thread]
+};
+
+/**
+ * @brief Handle to an asynchronous GPU submission
+ *
+ * Returned by ImmediateCommands::submitAsync(). Owns the submission's fence and
+ * command buffer, plus any resources attached with keepAlive(), and releases
+ * them once the GPU has finished. Tickets are cheap to copy (shared state).
+ *
+ * Retirement (freeing the command buffer) happens on whichever thread observes
+ * completion or drops the last copy, so use tickets on the thread that owns
+ * the originating CommandPool.
+ *
+ * Usage:
+ * @code
+ * auto imm = pool.beginImmediate();
+ * imm.cmd().copyBuffer(*staging, *dst, size);
+ * SubmitTicket ticket = imm.submitAsync();
+ * ticket.keepAlive(std::move(staging));
+ * ticket.then([]{ std::cout << "upload done\n"; });
+ *
+ * // Later, e.g. once per frame:
+ * if (ticket.isComplete()) { ... }
+ * @endcode
+ */
+class SubmitTicket {
+public:
+    /// Empty ticket (always complete)
+    SubmitTicket() = default;
+
+    /// Check whether the GPU finished this submission (non-blocking).
+    /// Runs pending then() callbacks and releases resources on completion.
+    bool isComplete() const;
+
+    /// Query the fence only (no callbacks run, safe to call under locks)
+    bool isSignaled() const;
+
+    /// Block until the submission completes
+    void wait(uint64_t timeout = UINT64_MAX) const;
+
+    /// Run a callback once the submission completes (immediately if already done)
+    void then(std::function<void()> callback) const;
+
+    /// Keep a resource alive until the submission completes
+    template<typename T>
+    void keepAlive(T resource) const {
+        if (!state_) {
+            return;  // Nothing in flight, resource can die now
+        }
+        auto holder = std::make_shared<T>(std::move(resource));
+        then([holder]() mutable { holder.reset(); });
+    }
+
+    /// Get the fence signaled by the submission (VK_NULL_HANDLE for empty ticket)
+    VkFence fence() const;
+
+    /// Check if this ticket refers to a submission
+    bool valid() const { return state_ != nullptr; }
+
+private:
+    friend class ImmediateCommands;
+
+    struct State;
+    void retire() const;
+
+    std::shared_ptr<State> state_;
 };
 
 /**
@@ -265,9 +672,19 @@ public:
     /// Access the command buffer for recording
     CommandBuffer& cmd() { return *cmd_; }
 
-    /// Explicit submit (optional - destructor will do it if not called)
+    /// Explicit submit (optional - destructor will do it if not called).
+    /// Blocks on this submission's fence only, not on the whole queue.
     void submit();
 
+    /// Submit without waiting; returns a ticket to poll, wait or chain on
+    SubmitTicket submitAsync();
+
+    /// Submit without waiting, with semaphore dependencies (e.g. cross-queue handoff)
+    SubmitTicket submitAsync(
+        const std::vector<VkSemaphore>& waitSemaphores,
+        const std::vector<VkPipelineStageFlags>& waitStages,
+        const std::vector<VkSemaphore>& signalSemaphores);
+
     /// Destructor - submits if not already done
     ~ImmediateCommands();
 
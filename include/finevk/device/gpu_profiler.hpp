@@ -0,0 +1,240 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class Queue;
+class CommandBuffer;
+
+/**
+ * @brief GPU time of one profiler scope
+ *
+ * Scopes are listed in the order they were begun, so a parent always comes
+ * before its children.
+ */
+struct GpuScopeTiming {
+    const char* name = nullptr;
+    uint32_t depth = 0;             ///< 0 for top-level scopes
+    int32_t parent = -1;            ///< Index of the enclosing scope, -1 if none
+    double milliseconds = 0.0;
+};
+
+/**
+ * @brief Pipeline statistics counted between beginFrame() and endFrame()
+ */
+struct PipelineStatistics {
+    uint64_t inputVertices = 0;         ///< Vertices fetched by input assembly
+    uint64_t inputPrimitives = 0;
+    uint64_t vertexInvocations = 0;
+    uint64_t clippingPrimitives = 0;    ///< Primitives reaching the clipper
+    uint64_t fragmentInvocations = 0;
+    uint64_t computeInvocations = 0;
+};
+
+/**
+ * @brief GPU timings of one completed frame
+ */
+struct GpuFrameTimings {
+    uint64_t frame = 0;             ///< Profiler frame number (0 until the first readback)
+    double totalMilliseconds = 0.0; ///< beginFrame() to endFrame()
+    std::vector<GpuScopeTiming> scopes;
+
+    PipelineStatistics pipeline;    ///< Valid if hasPipelineStatistics
+    bool hasPipelineStatistics = false;
+
+    /// Summed time of every scope with this name (0 if none)
+    double milliseconds(const char* name) const;
+};
+
+/**
+ * @brief GPU timestamp profiler with nested, named scopes
+ *
+ * Each frame in flight has its own timestamp query pool. beginFrame() reads
+ * back the results that slot recorded last time around (its fence has
+ * signaled, so they are ready without waiting; a frame whose queries are
+ * still not available is skipped rather than waited for), resets the pool
+ * and writes the frame's start timestamp. Scopes write a timestamp at
+ * begin and end, and ticks are converted with the device's timestampPeriod.
+ *
+ * results() therefore lags the frame being recorded by framesInFlight
+ * frames. With pipelineStatistics() enabled, a pipeline statistics query
+ * also spans each frame (vertex, primitive, fragment and compute counts). On devices or queues without timestamp support the profiler is
+ * inert: every call is a no-op and results() stays empty.
+ *
+ * Scope names are stored as pointers, so pass string literals (or strings
+ * that outlive the profiler). Scopes are recorded through the command
+ * buffer the profiler is attached to; with no profiler attached they cost
+ * one null check.
+ *
+ * Usage:
+ * @code
+ * auto profiler = GpuProfiler::create(device).build();
+ *
+ * // Each frame, after the frame's fence has signaled, outside a render pass
+ * profiler->beginFrame(cmd, frameIndex);
+ * cmd.setProfiler(profiler.get());
+ * {
+ *     GpuProfiler::Scope scope(cmd, "opaque");
+ *     ...
+ * }
+ * profiler->endFrame(cmd);
+ *
+ * for (const auto& scope : profiler->results().scopes) {
+ *     printf("%*s%s %.3f ms\n", scope.depth * 2, "", scope.name, scope.milliseconds);
+ * }
+ * @endcode
+ */
+class GpuProfiler {
+public:
+    /**
+     * @brief Builder for creating GpuProfiler objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Most scopes recorded per frame; further scopes are dropped (default: 64)
+        Builder& maxScopes(uint32_t count);
+
+        /// Number of query pools (default: the device's maxFramesInFlight())
+        Builder& framesInFlight(uint32_t count);
+
+        /// Queue the profiled command buffers are submitted to (default: graphics)
+        Builder& queue(Queue* queue);
+
+        /**
+         * @brief Also count pipeline statistics over each frame (default: off)
+         *
+         * Needs LogicalDeviceBuilder::enablePipelineStatistics(); ignored
+         * with a warning otherwise. Secondaries begun from a profiled
+         * primary inherit the query.
+         */
+        Builder& pipelineStatistics(bool enable = true);
+
+        /// Build the profiler
+        GpuProfilerPtr build();
+
+    private:
+        LogicalDevice* device_;
+        Queue* queue_ = nullptr;
+        uint32_t maxScopes_ = 64;
+        uint32_t framesInFlight_ = 0;
+        bool pipelineStatistics_ = false;
+    };
+
+    /// Create a builder for a GPU profiler
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /**
+     * @brief RAII scope on a command buffer's attached profiler
+     *
+     * Does nothing if the command buffer has no profiler.
+     */
+    class Scope {
+    public:
+        Scope(CommandBuffer& cmd, const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        CommandBuffer& cmd_;
+    };
+
+    /**
+     * @brief Start recording a frame
+     *
+     * Call once per frame with the frame's primary command buffer, after the
+     * frame's fence has signaled and outside any render pass.
+     */
+    void beginFrame(CommandBuffer& cmd, uint32_t frameIndex);
+
+    /// Write the frame's end timestamp; closes any scopes left open
+    void endFrame(CommandBuffer& cmd);
+
+    /**
+     * @brief Open a scope nested in the currently open one
+     *
+     * Allowed inside render passes. No-op between frames or once maxScopes
+     * is reached.
+     */
+    void beginScope(CommandBuffer& cmd, const char* name);
+
+    /// Close the innermost open scope
+    void endScope(CommandBuffer& cmd);
+
+    /// Timings of the newest frame read back
+    const GpuFrameTimings& results() const { return results_; }
+
+    /// Stop or resume recording (results() keeps the last frame while disabled)
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool isEnabled() const { return enabled_; }
+
+    /// False if the device or queue can't write timestamps
+    bool isSupported() const { return !slots_.empty(); }
+
+    /// Statistics counted by the frame query (0 without pipelineStatistics())
+    VkQueryPipelineStatisticFlags pipelineStatisticsFlags() const { return statisticsFlags_; }
+
+    /// Nanoseconds per timestamp tick
+    float timestampPeriod() const { return timestampPeriod_; }
+
+    uint32_t maxScopes() const { return maxScopes_; }
+    uint32_t framesInFlight() const { return static_cast<uint32_t>(slots_.size()); }
+
+    /// Destructor
+    ~GpuProfiler();
+
+    // Non-copyable
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+private:
+    friend class Builder;
+    GpuProfiler() = default;
+
+    struct ScopeRecord {
+        const char* name;
+        uint32_t depth;
+        int32_t parent;
+        uint32_t beginQuery;
+        uint32_t endQuery;          // UINT32_MAX while open
+    };
+
+    struct Slot {
+        VkQueryPool pool = VK_NULL_HANDLE;
+        VkQueryPool statisticsPool = VK_NULL_HANDLE;  // One query over the frame
+        std::vector<ScopeRecord> scopes;
+        uint32_t usedQueries = 0;
+        uint64_t frame = 0;
+        bool pending = false;       // Recorded and not yet read back
+    };
+
+    void readBack(Slot& slot);
+    void writeTimestamp(CommandBuffer& cmd, VkPipelineStageFlagBits stage, uint32_t& query);
+
+    LogicalDevice* device_ = nullptr;
+    std::vector<Slot> slots_;
+    Slot* current_ = nullptr;       // Slot being recorded (nullptr between frames)
+    std::vector<int32_t> open_;     // Open scope indices, -1 for dropped scopes
+    std::vector<uint64_t> readback_;
+    GpuFrameTimings results_;
+    uint64_t frameCounter_ = 0;
+    uint64_t timestampMask_ = ~0ull;
+    float timestampPeriod_ = 1.0f;
+    VkQueryPipelineStatisticFlags statisticsFlags_ = 0;
+    uint32_t maxScopes_ = 0;
+    bool enabled_ = true;
+    bool warnedOverflow_ = false;
+};
+
+} // namespace finevk
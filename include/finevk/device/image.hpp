@@ -4,7 +4,9 @@
 #include "finevk/core/types.hpp"
 
 #include <vulkan/vulkan.h>
+#include <functional>
 #include <memory>
+#include <optional>
 
 namespace finevk {
 
@@ -13,9 +15,19 @@ class ImageView;
 
 /**
  * @brief Vulkan image wrapper with memory management
+ *
+ * A relocatable image may be moved to other memory by
+ * MemoryAllocator::defragment(). handle() and the default view() change
+ * between frames (the old ones stay valid for frames already recorded),
+ * so rewrite descriptors and recreate custom views from the relocation
+ * callback. Only GpuOnly images without a host mapping are moved, and they
+ * must not be written while movePending().
  */
-class Image {
+class Image : private Relocatable {
 public:
+    /// Called after a relocatable image switched to a new VkImage
+    using RelocationCallback = std::function<void(Image&)>;
+
     /**
      * @brief Builder for creating Image objects
      */
@@ -47,6 +59,21 @@ public:
         /// Set memory usage hint
         Builder& memoryUsage(MemoryUsage memUsage);
 
+        /// Set image create flags (e.g. VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT)
+        Builder& flags(VkImageCreateFlags flags);
+
+        /// Set the statistics category (default: inferred from usage flags)
+        Builder& category(MemoryCategory category);
+
+        /**
+         * @brief Let the defragmenter move this image (adds transfer src/dst usage)
+         *
+         * The image must be in layout (e.g. VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+         * whenever MemoryAllocator::defragment() is called; moves copy
+         * every mip level and layer and leave both copies in that layout.
+         */
+        Builder& relocatable(VkImageLayout layout);
+
         /// Build the image
         ImagePtr build();
 
@@ -60,6 +87,9 @@ public:
         uint32_t arrayLayers_ = 1;
         VkImageTiling tiling_ = VK_IMAGE_TILING_OPTIMAL;
         MemoryUsage memUsage_ = MemoryUsage::GpuOnly;
+        VkImageCreateFlags flags_ = 0;
+        std::optional<MemoryCategory> category_;
+        VkImageLayout relocatableLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
     };
 
     /// Create a builder for an image
@@ -80,7 +110,7 @@ public:
         return createTexture2D(device.get(), width, height, format, mipLevels);
     }
 
-    /// Create a depth buffer image
+    /// Create a depth buffer image (MemoryUsage::Transient: attachment-only, not sampleable)
     static ImagePtr createDepthBuffer(
         LogicalDevice* device,
         uint32_t width, uint32_t height,
@@ -92,7 +122,7 @@ public:
         return createDepthBuffer(device.get(), width, height, samples);
     }
 
-    /// Create a color attachment image
+    /// Create a color attachment image (MemoryUsage::Transient, e.g. an MSAA target resolved in the pass)
     static ImagePtr createColorAttachment(
         LogicalDevice* device,
         uint32_t width, uint32_t height,
@@ -126,9 +156,18 @@ public:
     /// Get number of mip levels
     uint32_t mipLevels() const { return mipLevels_; }
 
+    /// Get number of array layers
+    uint32_t arrayLayers() const { return arrayLayers_; }
+
     /// Get sample count
     VkSampleCountFlagBits samples() const { return samples_; }
 
+    /// Get usage flags the image was created with
+    VkImageUsageFlags usage() const { return usage_; }
+
+    /// Get create flags the image was created with
+    VkImageCreateFlags flags() const { return flags_; }
+
     /**
      * @brief Get the default view for this image (whole image, matching format)
      *
@@ -151,6 +190,16 @@ public:
      */
     ImageViewPtr createView(VkImageAspectFlags aspectMask);
 
+    /**
+     * @brief Create a view of a mip range, optionally reinterpreting the format
+     *
+     * A viewFormat other than the image's requires VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT
+     * (e.g. a UNORM storage view of an sRGB texture). Images with several
+     * array layers get a 2D array view of all layers.
+     */
+    ImageViewPtr createView(VkImageAspectFlags aspectMask, uint32_t baseMipLevel,
+                            uint32_t levelCount, VkFormat viewFormat = VK_FORMAT_UNDEFINED);
+
     /**
      * @brief Create a depth buffer matching this image's dimensions
      *
@@ -162,9 +211,45 @@ public:
         VkFormat format = VK_FORMAT_UNDEFINED,
         VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_FLAG_BITS_MAX_ENUM);
 
+    /**
+     * @brief Transition every subresource on the host (VK_EXT_host_image_copy)
+     *
+     * Needs VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT usage and
+     * LogicalDevice::supportsHostImageCopy(); the GPU must not be using the
+     * image. No command buffer or submit is involved.
+     */
+    void transitionLayoutOnHost(VkImageLayout oldLayout, VkImageLayout newLayout);
+
+    /**
+     * @brief Copy tightly packed texels from host memory into one mip level
+     *
+     * The image must be in layout, one of the device's host copy
+     * destination layouts (see transitionLayoutOnHost()). Every array layer
+     * is written, stored one after another in data. The copy is done when
+     * this returns and becomes visible to the GPU with the next submit.
+     * Throws while movePending().
+     * Any thread may call this while no other thread uses the image.
+     */
+    void copyFromHost(const void* data, uint32_t mipLevel, VkImageLayout layout);
+
     /// Check if image was created with external memory (e.g., swap chain image)
     bool ownsMemory() const { return ownsMemory_; }
 
+    /// Check if the defragmenter may move this image
+    bool isRelocatable() const { return relocatable_; }
+
+    /// True between a move's copy and its commit; writes then would be lost
+    bool movePending() const { return movingImage_ != VK_NULL_HANDLE; }
+
+    /**
+     * @brief Set the callback run after each relocation
+     *
+     * Runs on the thread calling MemoryAllocator::defragment() with the
+     * allocator locked, so it must not create or free resources other than
+     * image views; updating descriptor sets is fine.
+     */
+    void setRelocationCallback(RelocationCallback callback) { relocationCallback_ = std::move(callback); }
+
     /// Destructor
     ~Image();
 
@@ -185,16 +270,33 @@ private:
     Image(LogicalDevice* device, VkImage image, VkFormat format, VkExtent3D extent);
 
     void cleanup();
+    void takeRelocation(Image& other);
+
+    // Relocatable
+    const AllocationInfo& allocation() const override { return allocation_; }
+    bool beginMove(CommandBuffer& cmd, const AllocationInfo& target) override;
+    std::function<void()> commitMove() override;
+    std::function<void()> cancelMove() override;
 
     LogicalDevice* device_ = nullptr;
     VkImage image_ = VK_NULL_HANDLE;
     VkFormat format_ = VK_FORMAT_UNDEFINED;
     VkExtent3D extent_ = {0, 0, 0};
     uint32_t mipLevels_ = 1;
+    uint32_t arrayLayers_ = 1;
     VkSampleCountFlagBits samples_ = VK_SAMPLE_COUNT_1_BIT;
+    VkImageUsageFlags usage_ = 0;
+    VkImageCreateFlags flags_ = 0;
     AllocationInfo allocation_;
     bool ownsMemory_ = true;
     ImageViewPtr defaultView_;  // Cached default view, created on first access
+
+    bool relocatable_ = false;
+    VkImageTiling tiling_ = VK_IMAGE_TILING_OPTIMAL;
+    VkImageLayout relocatableLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImage movingImage_ = VK_NULL_HANDLE;         // New handle while a move is pending
+    AllocationInfo movingAllocation_;
+    RelocationCallback relocationCallback_;
 };
 
 /**
@@ -4,8 +4,11 @@
 #include "finevk/device/physical_device.hpp"
 
 #include <vulkan/vulkan.h>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <functional>
 
 namespace finevk {
@@ -13,6 +16,9 @@ namespace finevk {
 class Surface;
 class Queue;
 class MemoryAllocator;
+class PipelineCache;
+class SamplerCache;
+class PipelineRegistry;
 
 /**
  * @brief Queue type enumeration
@@ -49,9 +55,103 @@ public:
     /// Get the transfer queue (nullptr if not dedicated)
     Queue* transferQueue() const { return transferQueue_; }
 
+    /// Core features enabled at creation
+    const VkPhysicalDeviceFeatures& enabledFeatures() const { return enabledFeatures_; }
+
+    /// Vulkan 1.2 features enabled at creation (all false if none were requested)
+    const VkPhysicalDeviceVulkan12Features& enabledVulkan12Features() const { return enabledFeatures12_; }
+
+    /// True if VK_EXT_mesh_shader task and mesh stages were enabled at creation
+    bool supportsMeshShading() const { return cmdDrawMeshTasks_ != nullptr; }
+
+    /// vkCmdDrawMeshTasksEXT (nullptr without mesh shading)
+    PFN_vkCmdDrawMeshTasksEXT cmdDrawMeshTasks() const { return cmdDrawMeshTasks_; }
+
+    /**
+     * @brief Frames the CPU may record ahead of the GPU
+     *
+     * The single source for per-frame ring sizes: Window cycles this many
+     * frame slots, and DeferredDisposer (through GameLoop) waits this many
+     * frames without a timeline.
+     */
+    uint32_t framesInFlight() const { return framesInFlight_; }
+
+    /**
+     * @brief Capacity of per-frame resources, fixed at creation
+     *
+     * Per-frame resources created with a frame count of 0 (the default for
+     * UniformBuffer, Material, UniformRing, DescriptorAllocator,
+     * FrameCommandPools, GpuCuller, VirtualTexture and SimpleRenderer) size
+     * themselves to this, so setFramesInFlight() never has to resize them.
+     */
+    uint32_t maxFramesInFlight() const { return maxFramesInFlight_; }
+
+    /**
+     * @brief Change frames in flight at runtime (between frames)
+     *
+     * Waits for the device to go idle so no frame slot is in use, then
+     * switches; Window picks the new count up at its next beginFrame().
+     *
+     * @throws std::runtime_error if count is 0 or above maxFramesInFlight()
+     */
+    void setFramesInFlight(uint32_t count);
+
+    /// True if VK_KHR_present_id and VK_KHR_present_wait were enabled at creation
+    bool supportsPresentWait() const { return waitForPresent_ != nullptr; }
+
+    /// vkWaitForPresentKHR (nullptr without present wait)
+    PFN_vkWaitForPresentKHR waitForPresent() const { return waitForPresent_; }
+
+    /// True if multiview rendering was enabled at creation
+    bool supportsMultiview() const { return multiview_; }
+
+    /// True if VK_KHR_dynamic_rendering was enabled at creation
+    bool supportsDynamicRendering() const { return cmdBeginRendering_ != nullptr; }
+
+    /// vkCmdBeginRenderingKHR / vkCmdEndRenderingKHR (nullptr without dynamic rendering)
+    PFN_vkCmdBeginRenderingKHR cmdBeginRendering() const { return cmdBeginRendering_; }
+    PFN_vkCmdEndRenderingKHR cmdEndRendering() const { return cmdEndRendering_; }
+
+    /// True if VK_KHR_synchronization2 was enabled at creation
+    bool supportsSynchronization2() const { return queueSubmit2_ != nullptr; }
+
+    /// vkQueueSubmit2KHR / vkCmdPipelineBarrier2KHR (nullptr without synchronization2)
+    PFN_vkQueueSubmit2KHR queueSubmit2() const { return queueSubmit2_; }
+    PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2() const { return cmdPipelineBarrier2_; }
+
+    /// True if VK_KHR_fragment_shading_rate was enabled at creation
+    bool supportsFragmentShadingRate() const { return cmdSetFragmentShadingRate_ != nullptr; }
+
+    /// vkCmdSetFragmentShadingRateKHR (nullptr without fragment shading rate)
+    PFN_vkCmdSetFragmentShadingRateKHR cmdSetFragmentShadingRate() const { return cmdSetFragmentShadingRate_; }
+
+    /// True if VK_EXT_host_image_copy was enabled at creation
+    bool supportsHostImageCopy() const { return copyMemoryToImage_ != nullptr; }
+
+    /// vkCopyMemoryToImageEXT / vkTransitionImageLayoutEXT (nullptr without host image copy)
+    PFN_vkCopyMemoryToImageEXT copyMemoryToImage() const { return copyMemoryToImage_; }
+    PFN_vkTransitionImageLayoutEXT transitionImageLayout() const { return transitionImageLayout_; }
+
+    /// True if VK_EXT_memory_budget was enabled (see MemoryAllocator::budget())
+    bool supportsMemoryBudget() const { return memoryBudget_; }
+
+    /// True if pipeline statistics and inherited queries were enabled at creation
+    bool supportsPipelineStatistics() const {
+        return enabledFeatures_.pipelineStatisticsQuery == VK_TRUE && enabledFeatures_.inheritedQueries == VK_TRUE;
+    }
+
     /// Get the memory allocator
     MemoryAllocator& allocator() { return *allocator_; }
 
+    /// Get the device pipeline cache (used by pipeline builders by default)
+    PipelineCache& pipelineCache() { return *pipelineCache_; }
+
+    /// Get the device sampler cache (shared samplers, see Sampler::Builder::buildShared())
+    SamplerCache& samplerCache() { return *samplerCache_; }
+
+    /// Get the device pipeline registry (shared pipelines, see GraphicsPipeline::Builder::buildShared())
+    PipelineRegistry& pipelineRegistry() { return *pipelineRegistry_; }
+
     /**
      * @brief Get the default command pool
      *
@@ -118,16 +218,63 @@ private:
     // Memory allocator
     std::unique_ptr<MemoryAllocator> allocator_;
 
+    // Pipeline cache (persisted on destruction if a directory was configured)
+    std::unique_ptr<PipelineCache> pipelineCache_;
+
+    // Shared samplers keyed on their create state
+    std::unique_ptr<SamplerCache> samplerCache_;
+
+    // Shared graphics pipelines keyed on their builder state
+    std::unique_ptr<PipelineRegistry> pipelineRegistry_;
+
     // Default resources (lazily created)
     CommandPoolPtr defaultCommandPool_;
 
+    // Frame pipelining depth
+    uint32_t framesInFlight_ = 2;
+    uint32_t maxFramesInFlight_ = 3;
+
+    // Features enabled at creation
+    VkPhysicalDeviceFeatures enabledFeatures_{};
+    VkPhysicalDeviceVulkan12Features enabledFeatures12_{};
+    bool memoryBudget_ = false;
+    bool multiview_ = false;
+
+    // Extension entry points (loaded when their extension was enabled)
+    PFN_vkCmdDrawMeshTasksEXT cmdDrawMeshTasks_ = nullptr;
+    PFN_vkWaitForPresentKHR waitForPresent_ = nullptr;
+    PFN_vkCmdBeginRenderingKHR cmdBeginRendering_ = nullptr;
+    PFN_vkCmdEndRenderingKHR cmdEndRendering_ = nullptr;
+    PFN_vkQueueSubmit2KHR queueSubmit2_ = nullptr;
+    PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2_ = nullptr;
+    PFN_vkCmdSetFragmentShadingRateKHR cmdSetFragmentShadingRate_ = nullptr;
+    PFN_vkCopyMemoryToImageEXT copyMemoryToImage_ = nullptr;
+    PFN_vkTransitionImageLayoutEXT transitionImageLayout_ = nullptr;
+
     // Destruction callbacks for dependent objects
     std::vector<std::pair<size_t, DestructionCallback>> destructionCallbacks_;
     size_t nextCallbackId_ = 1;
 };
 
+/**
+ * @brief A point on a queue's submission timeline
+ *
+ * Complete once the GPU has finished every submission up to and including
+ * value. The default (value 0) is always complete.
+ */
+struct TimelinePoint {
+    const Queue* queue = nullptr;
+    uint64_t value = 0;
+
+    bool isComplete() const;
+};
+
 /**
  * @brief Vulkan queue wrapper
+ *
+ * When the device supports timeline semaphores, every submit() also
+ * signals the queue's timeline with the next value, so GPU progress can be
+ * queried per submission (lastSubmitted(), isComplete()) without fences.
  */
 class Queue {
 public:
@@ -140,20 +287,72 @@ public:
     /// Get the queue type
     QueueType type() const { return type_; }
 
-    /// Submit command buffers
-    void submit(const VkSubmitInfo& submitInfo, VkFence fence = VK_NULL_HANDLE);
+    /// Submit command buffers; returns the timeline value signaled (0 without timeline)
+    uint64_t submit(const VkSubmitInfo& submitInfo, VkFence fence = VK_NULL_HANDLE);
+
+    /// Submit several batches in one vkQueueSubmit (one timeline value for all)
+    uint64_t submit(const VkSubmitInfo* submitInfos, uint32_t count, VkFence fence = VK_NULL_HANDLE);
+
+    /**
+     * @brief Submit batches with vkQueueSubmit2 (VK_KHR_synchronization2)
+     *
+     * Like submit(), the queue timeline is signaled after the last batch.
+     *
+     * @throws std::runtime_error without LogicalDevice::supportsSynchronization2()
+     */
+    uint64_t submit2(const VkSubmitInfo2KHR* submitInfos, uint32_t count, VkFence fence = VK_NULL_HANDLE);
+
+    /// True if submit2() is available
+    bool supportsSubmit2() const { return queueSubmit2_ != nullptr; }
 
     /// Convenience: submit single command buffer
-    void submit(
+    uint64_t submit(
         VkCommandBuffer commandBuffer,
         const std::vector<VkSemaphore>& waitSemaphores = {},
         const std::vector<VkPipelineStageFlags>& waitStages = {},
         const std::vector<VkSemaphore>& signalSemaphores = {},
         VkFence fence = VK_NULL_HANDLE);
 
+    /**
+     * @brief Submit a single command buffer after other queues' timeline points
+     *
+     * Every point in waitPoints becomes a timeline semaphore wait at
+     * waitStages, so this queue can consume work another queue produced
+     * (e.g. async compute results) without a CPU round trip. Points that
+     * have already completed are skipped; binary semaphores can be mixed in.
+     */
+    uint64_t submitAfter(
+        VkCommandBuffer commandBuffer,
+        const std::vector<TimelinePoint>& waitPoints,
+        VkPipelineStageFlags waitStages,
+        const std::vector<VkSemaphore>& waitSemaphores = {},
+        const std::vector<VkPipelineStageFlags>& semaphoreStages = {},
+        const std::vector<VkSemaphore>& signalSemaphores = {},
+        VkFence fence = VK_NULL_HANDLE);
+
     /// Wait for queue to become idle
     void waitIdle();
 
+    /// Timeline semaphore signaled by every submission (VK_NULL_HANDLE if unsupported)
+    VkSemaphore timeline() const { return timeline_; }
+
+    /// Value signaled by the most recent submission (0 before the first)
+    uint64_t lastSubmitted() const { return lastSubmitted_.load(std::memory_order_acquire); }
+
+    /// Point reached once everything submitted so far has completed
+    TimelinePoint lastSubmittedPoint() const { return {this, lastSubmitted()}; }
+
+    /// Highest timeline value the GPU has completed (queries the semaphore when behind)
+    uint64_t completedValue() const;
+
+    /// True once the submission that signaled value has completed
+    bool isComplete(uint64_t value) const {
+        return value <= completed_.load(std::memory_order_acquire) || value <= completedValue();
+    }
+
+    /// Block until the submission that signaled value has completed
+    void waitFor(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
     /// Present a swap chain image
     VkResult present(
         VkSwapchainKHR swapChain,
@@ -165,9 +364,25 @@ private:
     friend class LogicalDeviceBuilder;
     Queue(VkQueue queue, uint32_t familyIndex, QueueType type);
 
+    void createTimeline(VkDevice device);
+    void destroyTimeline();
+
     VkQueue queue_ = VK_NULL_HANDLE;
     uint32_t familyIndex_ = 0;
     QueueType type_ = QueueType::Graphics;
+
+    // Timeline values are assigned in submission order under submitMutex_
+    VkDevice device_ = VK_NULL_HANDLE;
+    VkSemaphore timeline_ = VK_NULL_HANDLE;
+    std::mutex submitMutex_;
+    std::atomic<uint64_t> lastSubmitted_{0};
+    mutable std::atomic<uint64_t> completed_{0};
+
+    PFN_vkQueueSubmit2KHR queueSubmit2_ = nullptr;
 };
 
+inline bool TimelinePoint::isComplete() const {
+    return value == 0 || !queue || queue->isComplete(value);
+}
+
 } // namespace finevk
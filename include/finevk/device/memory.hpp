@@ -1,11 +1,19 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <array>
 #include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace finevk {
 
 class LogicalDevice;
+class CommandBuffer;
+class Queue;
 
 /**
  * @brief Memory usage hint for allocation
@@ -13,10 +21,45 @@ class LogicalDevice;
 enum class MemoryUsage {
     GpuOnly,    // Device local, fastest for GPU
     CpuToGpu,   // Host visible, for staging/uniforms
-    GpuToCpu,   // Host visible, for readback
-    CpuOnly     // Host visible + cached
+    GpuToCpu,   // Host visible + cached where available (may be non-coherent), for readback
+    CpuOnly,    // Host visible + cached where available (may be non-coherent)
+    Transient,  // Lazily allocated where supported, else device local; attachment-only images
+    GpuDirectWrite  // Device local + host visible (resizable BAR, UMA) while its heap has budget, else CpuToGpu
 };
 
+/**
+ * @brief Kind of resource an allocation is bound to
+ *
+ * Linear (buffers, linear-tiled images) and optimal-tiled images are placed
+ * in separate blocks so bufferImageGranularity never has to be padded for.
+ */
+enum class ResourceKind {
+    Linear,     // Buffers and VK_IMAGE_TILING_LINEAR images
+    Optimal     // VK_IMAGE_TILING_OPTIMAL images
+};
+
+/**
+ * @brief What an allocation is used for, for memory statistics
+ *
+ * Buffer and Image infer it from their usage flags unless their builders
+ * are given one explicitly.
+ */
+enum class MemoryCategory {
+    Other,
+    Mesh,       // Vertex and index buffers
+    Texture,    // Sampled images
+    Uniform,    // Uniform and storage buffers
+    Staging,    // Host-visible transfer sources
+    Attachment  // Color and depth attachments
+};
+
+constexpr size_t MemoryCategoryCount = 6;
+
+/// Lowercase name of a category ("mesh", "texture", ...) for logs and telemetry
+const char* memoryCategoryName(MemoryCategory category);
+
+struct MemoryBlock;
+
 /**
  * @brief Information about a memory allocation
  */
@@ -24,43 +67,371 @@ struct AllocationInfo {
     VkDeviceMemory memory = VK_NULL_HANDLE;
     VkDeviceSize offset = 0;
     VkDeviceSize size = 0;
+    VkDeviceSize alignment = 1;
     void* mappedPtr = nullptr;  // nullptr if not host-visible or not mapped
+    MemoryBlock* block = nullptr;  // Owning block, nullptr for dedicated allocations
+    uint32_t memoryType = 0;
+    MemoryCategory category = MemoryCategory::Other;
+};
+
+/**
+ * @brief Allocator accounting for one heap, memory type or category
+ *
+ * reserved counts VkDeviceMemory (block capacity plus dedicated
+ * allocations); it stays 0 for categories, since blocks are shared.
+ */
+struct MemoryStats {
+    VkDeviceSize allocated = 0;         ///< Bytes in live allocations
+    VkDeviceSize peakAllocated = 0;     ///< Highest allocated since creation or resetPeaks()
+    VkDeviceSize reserved = 0;
+    VkDeviceSize peakReserved = 0;
+    uint32_t allocationCount = 0;
 };
 
 /**
- * @brief Simple memory allocator for Vulkan resources
+ * @brief Budget of one memory heap
+ *
+ * With VK_EXT_memory_budget (enabled automatically when available) budget
+ * and usage come from the driver and include other processes' pressure and
+ * memory this allocator doesn't own. Without it budget is an estimate of
+ * 80% of the heap and usage is this allocator's reserved bytes.
+ */
+struct MemoryBudget {
+    VkDeviceSize heapSize = 0;
+    VkDeviceSize budget = 0;    ///< Bytes this process can use before oversubscribing
+    VkDeviceSize usage = 0;     ///< Bytes this process currently uses on the heap
+    bool fromDriver = false;    ///< True if reported by VK_EXT_memory_budget
+
+    /// Bytes left before usage reaches budget
+    VkDeviceSize available() const { return budget > usage ? budget - usage : 0; }
+};
+
+/**
+ * @brief Resource whose memory MemoryAllocator::defragment() may move
+ *
+ * Implemented by Buffer and Image built with relocatable(). A move takes
+ * three steps: beginMove() creates a second handle bound to the target
+ * allocation and records a GPU copy into it; once the copy has completed
+ * commitMove() makes the new handle current and returns a function that
+ * destroys the old one, which the allocator runs when no frame in flight
+ * can still use it. cancelMove() drops a move that won't be committed and
+ * returns the new handle's destroyer, retired the same way since the copy
+ * into it may still be running.
+ *
+ * Between beginMove() and commitMove() the copy is already recorded, so
+ * anything written to the old memory in that window is lost. Only GpuOnly
+ * resources without a host mapping are relocatable (there is no CPU
+ * pointer to go stale), and they must not be written, on the CPU or the
+ * GPU, while the move is pending (see Buffer::movePending()).
+ */
+class Relocatable {
+public:
+    virtual ~Relocatable() = default;
+
+    /// Current allocation
+    virtual const AllocationInfo& allocation() const = 0;
+
+    /// Create the new handle on target and record the copy; false if it can't move
+    virtual bool beginMove(CommandBuffer& cmd, const AllocationInfo& target) = 0;
+
+    /// Switch to the new handle and allocation; returns the old handle's destroyer
+    virtual std::function<void()> commitMove() = 0;
+
+    /// Detach the new handle of an uncommitted move; returns its destroyer (the allocator frees its memory)
+    virtual std::function<void()> cancelMove() = 0;
+};
+
+/**
+ * @brief How much work one MemoryAllocator::defragment() call may record
+ */
+struct DefragmentLimits {
+    VkDeviceSize maxBytesPerPass = 16ull * 1024 * 1024;
+    uint32_t maxMovesPerPass = 64;
+    float maxBlockUsage = 0.5f;     ///< Only blocks used below this fraction are evacuated
+};
+
+/**
+ * @brief What one MemoryAllocator::defragment() call did
+ */
+struct DefragmentStats {
+    uint32_t movesRecorded = 0;     ///< Copies recorded into the command buffer
+    VkDeviceSize bytesRecorded = 0;
+    uint32_t movesCommitted = 0;    ///< Resources switched to their new memory
+    uint32_t movesPending = 0;      ///< Copies recorded and not committed yet
+};
+
+/**
+ * @brief Memory allocator for Vulkan resources
+ *
+ * By default resources are sub-allocated from large per-memory-type blocks
+ * (first-fit free list with coalescing). Host-visible blocks are persistently
+ * mapped, so AllocationInfo::mappedPtr points at the resource's own range.
+ * Requests larger than half a block get a dedicated VkDeviceMemory.
+ *
+ * allocateForBuffer() and allocateForImage() also ask the driver
+ * (VkMemoryDedicatedRequirements): resources that require a dedicated
+ * allocation always get one, and resources it prefers to be dedicated
+ * (typically render targets) get one from dedicatedThreshold() up. Small
+ * resources keep sharing blocks.
  *
- * Currently uses simple dedicated allocations. Can be enhanced later
- * with sub-allocation and memory pools for better performance.
+ * Long sessions that stream resources in and out leave blocks sparsely
+ * used. defragment(), called once per frame, gradually moves relocatable
+ * resources (see Relocatable) out of the sparsest block into fuller ones so
+ * emptied blocks can be released.
  */
 class MemoryAllocator {
 public:
+    /// Default block size for sub-allocation (clamped to 1/8 of the heap)
+    static constexpr VkDeviceSize DefaultBlockSize = 64ull * 1024 * 1024;
+
     explicit MemoryAllocator(LogicalDevice* device);
     ~MemoryAllocator();
 
     /// Allocate memory for a buffer or image
     AllocationInfo allocate(
         const VkMemoryRequirements& requirements,
-        MemoryUsage usage);
+        MemoryUsage usage,
+        ResourceKind kind = ResourceKind::Linear,
+        MemoryCategory category = MemoryCategory::Other);
+
+    /// Allocate memory for a buffer, honouring the driver's dedicated-allocation preference
+    AllocationInfo allocateForBuffer(
+        VkBuffer buffer,
+        MemoryUsage usage,
+        MemoryCategory category = MemoryCategory::Other);
+
+    /// Allocate memory for an image, honouring the driver's dedicated-allocation preference
+    AllocationInfo allocateForImage(
+        VkImage image,
+        MemoryUsage usage,
+        ResourceKind kind,
+        MemoryCategory category = MemoryCategory::Other);
 
     /// Free a previously allocated memory block
     void free(const AllocationInfo& allocation);
 
+    /// Map an allocation (persistent blocks return base + offset)
+    void* map(AllocationInfo& allocation);
+
+    /// Unmap an allocation (no-op for sub-allocations of mapped blocks)
+    void unmap(AllocationInfo& allocation);
+
+    /// True if host writes and device writes are visible without flush()/invalidate()
+    bool isCoherent(const AllocationInfo& allocation) const;
+
+    /**
+     * @brief Make host writes to a mapped range visible to the device
+     *
+     * offset and size are relative to the allocation and are widened to
+     * nonCoherentAtomSize; allocations in non-coherent memory are aligned
+     * to it, so the widened range never reaches a neighbour. Call after
+     * writing and before the submit that reads the data. No-op for
+     * coherent memory.
+     */
+    void flush(const AllocationInfo& allocation,
+               VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+    /// Make device writes to a mapped range visible to the host (after the fence; no-op if coherent)
+    void invalidate(const AllocationInfo& allocation,
+                    VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+    /// Enable/disable sub-allocation (default: enabled). Affects new allocations only.
+    void setPoolingEnabled(bool enabled) { poolingEnabled_ = enabled; }
+    bool isPoolingEnabled() const { return poolingEnabled_; }
+
+    /// Set preferred block size for new blocks
+    void setBlockSize(VkDeviceSize size) { blockSize_ = size; }
+    VkDeviceSize blockSize() const { return blockSize_; }
+
+    /// Smallest resource the driver merely prefers dedicated that gets its own memory (default: 1MB)
+    void setDedicatedThreshold(VkDeviceSize size) { dedicatedThreshold_ = size; }
+    VkDeviceSize dedicatedThreshold() const { return dedicatedThreshold_; }
+
     /// Get statistics
     size_t totalAllocated() const { return totalAllocated_; }
     size_t allocationCount() const { return allocationCount_; }
 
+    /// Number of VkDeviceMemory objects currently alive (blocks + dedicated)
+    size_t deviceMemoryCount() const { return deviceMemoryCount_; }
+
+    /// Bytes reserved from the driver (block capacity + dedicated sizes)
+    size_t totalReserved() const { return totalReserved_; }
+
+    /// Accounting for one memory heap (index into VkPhysicalDeviceMemoryProperties::memoryHeaps)
+    MemoryStats heapStats(uint32_t heap) const;
+
+    /// Accounting for one memory type
+    MemoryStats typeStats(uint32_t memoryType) const;
+
+    /// Accounting for one category (reserved is always 0)
+    MemoryStats categoryStats(MemoryCategory category) const;
+
+    /// Restart peak tracking from the current values
+    void resetPeaks();
+
+    /// Heap a memory type lives in
+    uint32_t heapIndex(uint32_t memoryType) const;
+
+    /// Heap that allocations with this usage land in
+    uint32_t heapIndex(MemoryUsage usage) const;
+
+    /**
+     * @brief True if the device has memory that is both device local and host visible
+     *
+     * All of VRAM with resizable BAR, all memory on integrated (UMA) GPUs,
+     * or a 256MB window on other discrete GPUs. MemoryUsage::GpuDirectWrite
+     * allocations land there, so the CPU writes straight into memory the GPU
+     * reads at full speed, with no staging copy; without it they fall back
+     * to CpuToGpu. The memory is write-combined: write it sequentially and
+     * don't read it back on the CPU.
+     */
+    bool supportsDirectWrite() const;
+
+    /**
+     * @brief Current budget of a heap
+     *
+     * Queries the driver on every call (cheap, but not free); streaming code
+     * should check once per frame and back off while available() is low,
+     * rather than failing allocations.
+     */
+    MemoryBudget budget(uint32_t heap) const;
+    MemoryBudget budget(MemoryUsage usage) const { return budget(heapIndex(usage)); }
+
+    /// Budgets of every heap from a single driver query
+    std::vector<MemoryBudget> budgets() const;
+
+    /// Let defragment() move a resource (called by relocatable Buffer and Image)
+    void registerRelocatable(Relocatable* resource);
+
+    /**
+     * @brief Stop moving a resource (call before destroying it)
+     *
+     * Cancels its pending move; the new handle and memory are retired like
+     * a committed move's old ones. Returns true if a move was pending: its
+     * copy may still be reading the resource, so pass the resource's own
+     * handle and memory to retire() instead of destroying them.
+     */
+    bool unregisterRelocatable(Relocatable* resource);
+
+    /// Track a relocatable resource, and its pending move, at a new address (C++ moves)
+    void transferRelocatable(Relocatable* from, Relocatable* to);
+
+    /// Run destroy and free allocation once no frame in flight can use them
+    void retire(std::function<void()> destroy, const AllocationInfo& allocation);
+
+    /**
+     * @brief Run one incremental defragmentation step
+     *
+     * Call once per frame, outside a render pass, with a command buffer that
+     * is submitted to queue before the next call (typically at the start of
+     * the frame's command buffer). Each call frees the memory of moves no
+     * frame can use anymore, commits moves whose copies the GPU has
+     * finished, and when nothing is pending records copies that evacuate
+     * the sparsest block into fuller blocks of the same memory type, within
+     * limits. New blocks are never created for a move.
+     *
+     * A move finishes within a few frames: with the queue's timeline as
+     * soon as the GPU is done, without one after maxFramesInFlight() calls.
+     * Contents written to a resource after its copy was recorded and before
+     * the commit are lost: while movesPending is non-zero, don't write to
+     * relocatable resources (Buffer uploads and Image::copyFromHost() throw
+     * while their own move is pending). Make resources relocatable that
+     * stay unchanged after upload (static meshes, textures).
+     */
+    DefragmentStats defragment(CommandBuffer& cmd, Queue* queue, const DefragmentLimits& limits = {});
+
     // Non-copyable
     MemoryAllocator(const MemoryAllocator&) = delete;
     MemoryAllocator& operator=(const MemoryAllocator&) = delete;
 
 private:
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    uint32_t findDirectWriteType(uint32_t typeFilter, VkDeviceSize size) const;
+    uint32_t chooseMemoryType(uint32_t typeFilter, MemoryUsage usage, VkDeviceSize size) const;
     VkMemoryPropertyFlags getMemoryProperties(MemoryUsage usage) const;
+    VkDeviceSize preferredBlockSize(uint32_t memoryType) const;
+    bool mappedRange(const AllocationInfo& allocation, VkDeviceSize offset, VkDeviceSize size,
+                     VkMappedMemoryRange& range) const;
+
+    // resource names the buffer or image being allocated for (may be nullptr);
+    // dedicated forces a VkDeviceMemory of its own
+    AllocationInfo allocate(const VkMemoryRequirements& requirements, MemoryUsage usage,
+                            ResourceKind kind, MemoryCategory category,
+                            const VkMemoryDedicatedAllocateInfo* resource, bool dedicated);
+    bool wantsDedicated(const VkMemoryRequirements& requirements,
+                        const VkMemoryDedicatedRequirements& dedicated) const;
+
+    AllocationInfo allocateDedicated(VkDeviceSize size, uint32_t memoryType, bool hostVisible,
+                                     const VkMemoryDedicatedAllocateInfo* resource);
+    MemoryBlock* createBlock(VkDeviceSize size, uint32_t memoryType,
+                             ResourceKind kind, bool hostVisible);
+    void destroyBlock(MemoryBlock* block);
+    void freeLocked(const AllocationInfo& allocation);
+
+    // Defragmentation steps (call with mutex_ held)
+    bool moveComplete(const Queue* queue, uint64_t& value, uint32_t& framesLeft) const;
+    void recordMoves(CommandBuffer& cmd, const DefragmentLimits& limits, DefragmentStats& stats);
+
+    // Updates per-type, per-heap and per-category stats (call with mutex_ held)
+    void trackAllocated(uint32_t memoryType, MemoryCategory category, VkDeviceSize size, bool add);
+    void trackReserved(uint32_t memoryType, VkDeviceSize size, bool add);
 
     LogicalDevice* device_;
+    bool poolingEnabled_ = true;
+    VkDeviceSize blockSize_ = DefaultBlockSize;
+    VkDeviceSize dedicatedThreshold_ = 1024 * 1024;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<MemoryBlock>> blocks_;
+
     size_t totalAllocated_ = 0;
     size_t allocationCount_ = 0;
+    size_t deviceMemoryCount_ = 0;
+    size_t totalReserved_ = 0;
+
+    std::array<MemoryStats, VK_MAX_MEMORY_TYPES> typeStats_{};
+    std::array<MemoryStats, VK_MAX_MEMORY_HEAPS> heapStats_{};
+    std::array<MemoryStats, MemoryCategoryCount> categoryStats_{};
+
+    // Defragmentation. Timeline values of 0 are assigned at the next
+    // defragment() call, once the command buffer has been submitted.
+    struct PendingMove {
+        Relocatable* resource;
+        AllocationInfo target;
+    };
+    struct RetiredMove {
+        std::function<void()> destroy;
+        AllocationInfo allocation;
+        uint64_t value;
+        uint32_t framesLeft;
+    };
+    std::vector<Relocatable*> relocatables_;
+    std::vector<PendingMove> pendingMoves_;
+    uint64_t pendingValue_ = 0;
+    uint32_t pendingFramesLeft_ = 0;
+    std::vector<RetiredMove> retiredMoves_;
+};
+
+/**
+ * @brief Block of device memory that resources are carved from
+ */
+struct MemoryBlock {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    VkDeviceSize used = 0;
+    uint32_t memoryType = 0;
+    ResourceKind kind = ResourceKind::Linear;
+    void* mappedBase = nullptr;
+    uint32_t allocationCount = 0;
+
+    /// Free ranges keyed by offset (adjacent ranges are always merged)
+    std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+
+    /// Find and reserve an aligned range; returns false if nothing fits
+    bool tryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset);
+
+    /// Return a range to the free list, merging with neighbours
+    void release(VkDeviceSize offset, VkDeviceSize size);
 };
 
 } // namespace finevk
@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <optional>
+#include <string>
 #include <functional>
 #include <unordered_map>
 #include <memory>
@@ -33,6 +34,18 @@ enum class MSAAPreference {
 struct DeviceCapabilities {
     VkPhysicalDeviceProperties properties;
     VkPhysicalDeviceFeatures features;
+    VkPhysicalDeviceVulkan12Features features12{};  // Zeroed if the device is below Vulkan 1.2
+    VkPhysicalDeviceMeshShaderFeaturesEXT meshShader{};  // Zeroed without VK_EXT_mesh_shader
+    VkPhysicalDevicePresentIdFeaturesKHR presentId{};      // Zeroed without VK_KHR_present_id
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWait{};  // Zeroed without VK_KHR_present_wait
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRendering{};  // Zeroed without VK_KHR_dynamic_rendering
+    VkPhysicalDeviceMultiviewFeatures multiview{};          // Core in Vulkan 1.1 (VK_KHR_multiview)
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2{};  // Zeroed without VK_KHR_synchronization2
+    VkPhysicalDeviceMultiviewProperties multiviewProperties{};
+    VkPhysicalDeviceFragmentShadingRateFeaturesKHR fragmentShadingRate{};  // Zeroed without VK_KHR_fragment_shading_rate
+    VkPhysicalDeviceFragmentShadingRatePropertiesKHR fragmentShadingRateProperties{};
+    VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopy{};  // Zeroed without VK_EXT_host_image_copy
+    std::vector<VkImageLayout> hostImageCopyDstLayouts;        // Layouts host copies may write into
     VkPhysicalDeviceMemoryProperties memory;
     std::vector<VkQueueFamilyProperties> queueFamilies;
     std::vector<VkExtensionProperties> extensions;
@@ -42,6 +55,19 @@ struct DeviceCapabilities {
     bool supportsGeometryShader() const;
     bool supportsTessellation() const;
     bool supportsWideLines() const;
+    bool supportsDrawIndirectCount() const;
+    bool supportsDescriptorIndexing() const;  // Features a bindless sampled-image array needs
+    bool supportsMeshShader() const;          // VK_EXT_mesh_shader with task and mesh stages
+    bool supportsTimelineSemaphore() const;   // Enabled automatically; see Queue::timeline()
+    bool supportsPresentWait() const;         // VK_KHR_present_id + VK_KHR_present_wait
+    bool supportsDynamicRendering() const;    // VK_KHR_dynamic_rendering (render passes without VkRenderPass)
+    bool supportsMultiview() const;           // Several array layers rendered in one pass
+    bool supportsSynchronization2() const;    // VK_KHR_synchronization2 (vkQueueSubmit2, 64-bit stage masks)
+    bool supportsFragmentShadingRate() const; // VK_KHR_fragment_shading_rate with per-draw (pipeline) rates
+    bool supportsHostImageCopy() const;       // VK_EXT_host_image_copy into shader-read-only images
+    bool supportsPipelineStatistics() const;  // Pipeline statistics queries spanning secondaries
+    bool supportsMemoryBudget() const;        // VK_EXT_memory_budget; enabled automatically
+    bool supportsLazilyAllocatedMemory() const;  // Memory type for MemoryUsage::Transient (tile-based GPUs)
     VkSampleCountFlagBits maxSampleCount() const;
 
     // Queue family queries
@@ -57,6 +83,10 @@ struct DeviceCapabilities {
     VkFormatProperties formatProperties(VkPhysicalDevice device, VkFormat format) const;
     bool supportsBlitting(VkPhysicalDevice device, VkFormat format) const;
     bool supportsLinearTiling(VkPhysicalDevice device, VkFormat format, VkFormatFeatureFlags features) const;
+    bool supportsSampling(VkPhysicalDevice device, VkFormat format) const;
+    // Optimal-tiled sampled 2D images of this format take host copies without
+    // slowing device access (not cached; safe to call from any thread)
+    bool supportsHostImageTransfer(VkPhysicalDevice device, VkFormat format) const;
 
     // MSAA selection
     VkSampleCountFlagBits selectMSAA(MSAAPreference pref,
@@ -132,6 +162,14 @@ public:
     /// Get cached device capabilities
     const DeviceCapabilities& capabilities() const { return capabilities_; }
 
+    /**
+     * @brief Pick the first format that can be sampled with linear filtering
+     *
+     * Candidates are in order of preference, e.g. BC7, then ASTC 4x4, then
+     * ETC2 for the same asset. Returns VK_FORMAT_UNDEFINED if none qualify.
+     */
+    VkFormat selectSampledFormat(const std::vector<VkFormat>& candidates) const;
+
     /// Query swap chain support for a surface
     SwapChainSupport querySwapChainSupport(VkSurfaceKHR surface) const;
 
@@ -181,25 +219,141 @@ public:
     /// Enable a device feature using a lambda
     LogicalDeviceBuilder& enableFeature(std::function<void(VkPhysicalDeviceFeatures&)> enabler);
 
+    /// Enable a Vulkan 1.2 feature using a lambda (chained via VkPhysicalDeviceFeatures2)
+    LogicalDeviceBuilder& enableVulkan12Feature(
+        std::function<void(VkPhysicalDeviceVulkan12Features&)> enabler);
+
     /// Enable anisotropic filtering if available
     LogicalDeviceBuilder& enableAnisotropy();
 
+    /// Enable multiDrawIndirect and drawIndirectCount if available
+    LogicalDeviceBuilder& enableIndirectDraw();
+
+    /**
+     * @brief Enable descriptor indexing for bindless sampled images if available
+     *
+     * Turns on runtime descriptor arrays, non-uniform sampled image
+     * indexing, partially bound and update-after-bind sampled image
+     * bindings (plus update-unused-while-pending when supported). Check
+     * LogicalDevice::enabledVulkan12Features().descriptorIndexing afterwards.
+     */
+    LogicalDeviceBuilder& enableDescriptorIndexing();
+
     /// Enable sample rate shading if available
     LogicalDeviceBuilder& enableSampleRateShading();
 
+    /**
+     * @brief Enable VK_EXT_mesh_shader task and mesh stages if available
+     *
+     * Check LogicalDevice::supportsMeshShading() afterwards; without it,
+     * mesh shader pipelines and Mesh::drawMeshlets() use the vertex path.
+     */
+    LogicalDeviceBuilder& enableMeshShader();
+
+    /**
+     * @brief Enable VK_KHR_present_id and VK_KHR_present_wait if available
+     *
+     * Lets Window::waitForFrame() wait for frames to reach the display,
+     * for just-in-time frame starts. Check LogicalDevice::supportsPresentWait().
+     */
+    LogicalDeviceBuilder& enablePresentWait();
+
+    /**
+     * @brief Enable VK_KHR_dynamic_rendering if available
+     *
+     * RenderTarget::Builder::dynamicRendering() then begins rendering without
+     * a VkRenderPass or framebuffers. Check LogicalDevice::supportsDynamicRendering().
+     */
+    LogicalDeviceBuilder& enableDynamicRendering();
+
+    /**
+     * @brief Enable multiview rendering if available
+     *
+     * Needed by RenderTarget::Builder::multiview(), which draws every array
+     * layer of a target (shadow cascades, cubemap faces) in one pass. Check
+     * LogicalDevice::supportsMultiview().
+     */
+    LogicalDeviceBuilder& enableMultiview();
+
+    /**
+     * @brief Enable VK_KHR_synchronization2 if available
+     *
+     * SubmitBatch then submits with vkQueueSubmit2 and
+     * CommandBuffer::pipelineBarrier2() records per-barrier stage masks.
+     * Without it both fall back to the original commands. Check
+     * LogicalDevice::supportsSynchronization2().
+     */
+    LogicalDeviceBuilder& enableSynchronization2();
+
+    /**
+     * @brief Enable VK_KHR_fragment_shading_rate if available
+     *
+     * Turns on per-draw shading rates: pipelines built with
+     * GraphicsPipeline::Builder::dynamicFragmentShadingRate() take their
+     * rate from CommandBuffer::setFragmentShadingRate(), so low-detail draws
+     * can shade one fragment per 2x2 (or larger) pixel block. Check
+     * LogicalDevice::supportsFragmentShadingRate().
+     */
+    LogicalDeviceBuilder& enableFragmentShadingRate();
+
+    /**
+     * @brief Enable VK_EXT_host_image_copy if available
+     *
+     * Lets Image::copyFromHost() write texels straight from host memory into
+     * optimal-tiled images, with no staging buffer, command buffer or queue
+     * submit. Texture::fromMemory(), AssetLoader and TextureStreamer then
+     * upload supported formats this way, on whichever thread decoded them.
+     * Check LogicalDevice::supportsHostImageCopy().
+     */
+    LogicalDeviceBuilder& enableHostImageCopy();
+
+    /**
+     * @brief Enable pipeline statistics queries if available
+     *
+     * Turns on pipelineStatisticsQuery and inheritedQueries, so a query can
+     * stay active across secondary command buffers. Needed by
+     * GpuProfiler::Builder::pipelineStatistics(); check
+     * LogicalDevice::supportsPipelineStatistics() afterwards.
+     */
+    LogicalDeviceBuilder& enablePipelineStatistics();
+
     /// Set the surface for present queue selection
     LogicalDeviceBuilder& surface(Surface* surface);
     LogicalDeviceBuilder& surface(Surface& s) { return surface(&s); }
     LogicalDeviceBuilder& surface(const SurfacePtr& s) { return surface(s.get()); }
 
+    /// Persist the pipeline cache in this directory (default: in-memory only)
+    LogicalDeviceBuilder& pipelineCacheDirectory(const std::string& directory);
+
+    /**
+     * @brief Frames the CPU may record ahead of the GPU (default: 2, up to 3)
+     *
+     * Per-frame resources are sized for maxCount, so
+     * LogicalDevice::setFramesInFlight() can later switch between 1 and
+     * maxCount without reallocating. maxCount 0 means max(count, 3).
+     */
+    LogicalDeviceBuilder& framesInFlight(uint32_t count, uint32_t maxCount = 0);
+
     /// Build the logical device
     LogicalDevicePtr build();
 
 private:
     PhysicalDevice* physical_;
     Surface* surface_ = nullptr;
+    std::string pipelineCacheDirectory_;
+    uint32_t framesInFlight_ = 2;
+    uint32_t maxFramesInFlight_ = 3;
     std::vector<const char*> extensions_;
     VkPhysicalDeviceFeatures enabledFeatures_{};
+    VkPhysicalDeviceVulkan12Features enabledFeatures12_{};
+    bool useFeatures12_ = false;
+    bool meshShader_ = false;
+    bool presentWait_ = false;
+    bool dynamicRendering_ = false;
+    bool multiview_ = false;
+    bool synchronization2_ = false;
+    bool fragmentShadingRate_ = false;
+    bool hostImageCopy_ = false;
 };
 
 } // namespace finevk
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+
+/**
+ * @brief Vulkan pipeline cache with optional on-disk persistence
+ *
+ * LogicalDevice owns one PipelineCache that GraphicsPipeline::Builder uses by
+ * default. When a cache directory is configured, the blob is loaded from a
+ * file named after the GPU's vendor ID, device ID and driver version, and
+ * saved back when the device is destroyed. A stale or foreign blob (header
+ * or pipelineCacheUUID mismatch) is ignored and the cache starts empty.
+ *
+ * Usage:
+ * @code
+ * auto device = physicalDevice.createLogicalDevice()
+ *     .surface(surface)
+ *     .pipelineCacheDirectory("cache")
+ *     .build();
+ * // Pipelines built from now on hit the cache; saved automatically on exit.
+ * @endcode
+ */
+class PipelineCache {
+public:
+    /// Create an empty cache, or load from directory if non-empty
+    explicit PipelineCache(LogicalDevice* device, const std::string& directory = "");
+
+    /// Get the Vulkan pipeline cache handle
+    VkPipelineCache handle() const { return cache_; }
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    /// File used for persistence (empty if in-memory only)
+    const std::string& filePath() const { return filePath_; }
+
+    /// True if the cache was seeded from disk
+    bool loadedFromDisk() const { return loadedFromDisk_; }
+
+    /// Get the current cache blob
+    std::vector<uint8_t> data() const;
+
+    /// Write the cache blob to filePath() (no-op if in-memory only)
+    bool save() const;
+
+    /// Write the cache blob to a specific file
+    bool save(const std::string& path) const;
+
+    /// Build the persistence file name for this device's properties
+    static std::string fileName(const VkPhysicalDeviceProperties& properties);
+
+    /// Destructor
+    ~PipelineCache();
+
+    // Non-copyable
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+private:
+    bool isCompatible(const std::vector<uint8_t>& blob) const;
+
+    LogicalDevice* device_ = nullptr;
+    VkPipelineCache cache_ = VK_NULL_HANDLE;
+    std::string filePath_;
+    bool loadedFromDisk_ = false;
+};
+
+} // namespace finevk
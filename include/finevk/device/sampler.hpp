@@ -3,7 +3,11 @@
 #include "finevk/core/types.hpp"
 
 #include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 
 namespace finevk {
 
@@ -47,6 +51,16 @@ public:
         /// Build the sampler
         SamplerPtr build();
 
+        /**
+         * @brief Get the shared sampler for this state from the device's SamplerCache
+         *
+         * Builders with identical state return the same sampler.
+         */
+        SamplerRef buildShared();
+
+        /// Create info the sampler is built from
+        const VkSamplerCreateInfo& createInfo() const { return createInfo_; }
+
     private:
         LogicalDevice* device_;
         VkSamplerCreateInfo createInfo_{};
@@ -86,6 +100,7 @@ public:
 
 private:
     friend class Builder;
+    friend class SamplerCache;
     Sampler() = default;
 
     void cleanup();
@@ -94,4 +109,58 @@ private:
     VkSampler sampler_ = VK_NULL_HANDLE;
 };
 
+/**
+ * @brief Device-level cache of shared samplers
+ *
+ * Samplers are keyed on their full create state (filters, address modes,
+ * anisotropy, mip LOD range and bias, compare op, border color), so every
+ * material asking for the same sampling shares one VkSampler and the count
+ * stays far below maxSamplerAllocationCount. Each LogicalDevice owns one
+ * (LogicalDevice::samplerCache()); Sampler::Builder::buildShared() goes
+ * through it.
+ *
+ * Returned samplers are reference counted. The cache keeps its own
+ * reference, so a sampler outlives its last user until trim(); samplers
+ * still referenced when the device is destroyed are released with it and
+ * their handles become VK_NULL_HANDLE.
+ *
+ * Usage:
+ * @code
+ * SamplerRef shadow = Sampler::create(device)
+ *     .filter(VK_FILTER_LINEAR)
+ *     .addressMode(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE)
+ *     .compareOp(VK_COMPARE_OP_LESS_OR_EQUAL)
+ *     .buildShared();
+ * @endcode
+ */
+class SamplerCache {
+public:
+    explicit SamplerCache(LogicalDevice* device);
+
+    /// Get (creating on first use) the sampler for a builder's state; thread-safe
+    SamplerRef get(const Sampler::Builder& builder);
+    SamplerRef get(const VkSamplerCreateInfo& createInfo);
+
+    /// Number of distinct samplers held
+    size_t size() const;
+
+    /// Destroy samplers nothing outside the cache references; returns the number destroyed
+    size_t trim();
+
+    ~SamplerCache();
+
+    // Non-copyable
+    SamplerCache(const SamplerCache&) = delete;
+    SamplerCache& operator=(const SamplerCache&) = delete;
+
+private:
+    using Key = std::array<uint32_t, 16>;
+
+    static Key makeKey(const VkSamplerCreateInfo& createInfo);
+
+    LogicalDevice* device_;
+    mutable std::mutex mutex_;
+    std::map<Key, SamplerRef> samplers_;
+};
+
 } // namespace finevk
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/logical_device.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace finevk {
+
+class CommandBuffer;
+
+/**
+ * @brief Command buffers and semaphore operations submitted in one call
+ *
+ * Collects a frame's command buffers (uploads, compute, secondaries'
+ * primaries, the frame itself) together with their waits and signals, and
+ * hands them to the queue in a single vkQueueSubmit2 with
+ * LogicalDevice::supportsSynchronization2(), or a single vkQueueSubmit
+ * otherwise. Either way the submission advances the queue timeline once.
+ *
+ * Work is grouped into batches: waits gate every command buffer of their
+ * batch, so start a new one with next() for work that must not wait (e.g.
+ * uploads ahead of a frame that waits for the swap chain image). Waits take
+ * synchronization2 stage masks, so a wait can block just the stage that
+ * consumes it; the fallback widens masks with legacyStageMask().
+ *
+ * Reuse one SubmitBatch per queue: submit() clears it but keeps capacity.
+ * Not thread-safe.
+ *
+ * Usage:
+ * @code
+ * SubmitBatch batch(device->graphicsQueue());
+ *
+ * batch.add(uploadCmd);
+ * batch.next()
+ *      .wait(imageAvailable, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR)
+ *      .wait(computeDone, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR)
+ *      .add(frameCmd)
+ *      .signal(renderFinished)
+ *      .fence(inFlight);
+ * uint64_t value = batch.submit();
+ * @endcode
+ */
+class SubmitBatch {
+public:
+    /// Create an empty batch for a queue
+    explicit SubmitBatch(Queue* queue);
+    explicit SubmitBatch(Queue& queue) : SubmitBatch(&queue) {}
+
+    /// Start another batch in the same submission
+    SubmitBatch& next();
+
+    /// Append a command buffer to the current batch
+    SubmitBatch& add(VkCommandBuffer commandBuffer);
+    SubmitBatch& add(const CommandBuffer& commandBuffer);
+
+    /// Wait for a binary semaphore before the current batch's stages
+    SubmitBatch& wait(VkSemaphore semaphore, VkPipelineStageFlags2KHR stages);
+
+    /// Wait for a timeline point (skipped if already complete)
+    SubmitBatch& wait(const TimelinePoint& point, VkPipelineStageFlags2KHR stages);
+
+    /// Signal a binary semaphore once the current batch's stages finish
+    SubmitBatch& signal(VkSemaphore semaphore,
+                        VkPipelineStageFlags2KHR stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+
+    /// Fence signaled when the whole submission completes
+    SubmitBatch& fence(VkFence fence);
+
+    /**
+     * @brief Submit everything collected in one call and clear the batch
+     *
+     * @return Queue timeline value signaled (0 without timeline, or if the
+     *         batch was empty and nothing was submitted)
+     */
+    uint64_t submit();
+
+    /// Drop everything collected without submitting
+    void clear();
+
+    /// True if nothing would be submitted
+    bool empty() const;
+
+    /// Command buffers collected over all batches
+    uint32_t commandBufferCount() const { return static_cast<uint32_t>(commandBuffers_.size()); }
+
+    /// Number of batches (VkSubmitInfo2 structures) collected
+    uint32_t batchCount() const { return static_cast<uint32_t>(batches_.size()); }
+
+    /// Queue this batch submits to
+    Queue* queue() const { return queue_; }
+
+private:
+    // First element of each array belonging to a batch; counts follow from the next batch
+    struct Range {
+        uint32_t commandBuffers;
+        uint32_t waits;
+        uint32_t signals;
+    };
+
+    uint64_t submitLegacy();
+
+    Queue* queue_;
+    std::vector<Range> batches_;
+    std::vector<VkCommandBufferSubmitInfoKHR> commandBuffers_;
+    std::vector<VkSemaphoreSubmitInfoKHR> waits_;
+    std::vector<VkSemaphoreSubmitInfoKHR> signals_;
+    VkFence fence_ = VK_NULL_HANDLE;
+
+    // Scratch for building the submission (kept to avoid per-frame allocation)
+    std::vector<VkSubmitInfo2KHR> submits2_;
+    std::vector<VkSubmitInfo> submits_;
+    std::vector<VkTimelineSemaphoreSubmitInfo> timelineInfos_;
+    std::vector<VkCommandBuffer> handles_;
+    std::vector<VkSemaphore> semaphores_;
+    std::vector<VkPipelineStageFlags> stages_;
+    std::vector<uint64_t> values_;
+};
+
+} // namespace finevk
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/command.hpp"
+
+#include <vulkan/vulkan.h>
+#include <deque>
+#include <vector>
+#include <memory>
+
+namespace finevk {
+
+class LogicalDevice;
+class Buffer;
+class Image;
+
+/**
+ * @brief Batched uploads through a persistent staging ring
+ *
+ * UploadManager copies source data into a persistently mapped staging ring
+ * and records the GPU copies into a single batch. flush() submits the batch
+ * on the dedicated transfer queue when the device has one, then hands
+ * ownership of the destination resources to the graphics queue family.
+ * Without a dedicated transfer queue the batch goes to the graphics queue.
+ *
+ * Ring space is reclaimed as batches complete. Uploads larger than half the
+ * ring get a one-off staging buffer, which lives until its batch finishes.
+ *
+ * Not thread-safe: use from one thread (typically the render thread).
+ *
+ * Usage:
+ * @code
+ * auto uploads = UploadManager::create(device).ringSize(32 * 1024 * 1024).build();
+ *
+ * uploads->uploadBuffer(*vertexBuffer, vertices.data(), vertexBytes);
+ * uploads->uploadImage(*image, pixels, imageBytes);
+ * SubmitTicket ticket = uploads->flush();
+ *
+ * // Once per frame:
+ * uploads->collect();
+ * @endcode
+ */
+class UploadManager {
+public:
+    /**
+     * @brief Builder for creating UploadManager objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Set staging ring size in bytes (default: 16MB)
+        Builder& ringSize(VkDeviceSize bytes);
+
+        /// Force use of the graphics queue even if a transfer queue exists
+        Builder& useGraphicsQueue(bool enable = true);
+
+        /// Build the upload manager
+        UploadManagerPtr build();
+
+    private:
+        LogicalDevice* device_;
+        VkDeviceSize ringSize_ = 16 * 1024 * 1024;
+        bool useGraphicsQueue_ = false;
+    };
+
+    /// Create a builder for an upload manager
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /**
+     * @brief Queue a buffer upload
+     *
+     * Data is copied into the staging ring immediately; the GPU copy is
+     * recorded on the next flush(). Destination must have TRANSFER_DST usage.
+     */
+    void uploadBuffer(Buffer& dst, const void* data, VkDeviceSize size,
+                      VkDeviceSize dstOffset = 0);
+
+    /**
+     * @brief Queue an image upload for one mip level and array layer
+     *
+     * Pixel data must be tightly packed, color aspect only. The uploaded
+     * subresource is transitioned from UNDEFINED (previous contents are
+     * discarded) and ends in finalLayout after flush().
+     */
+    void uploadImage(Image& dst, const void* data, VkDeviceSize size,
+                     uint32_t mipLevel = 0, uint32_t arrayLayer = 0,
+                     VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /**
+     * @brief Submit all queued copies as one batch
+     *
+     * The returned ticket completes once the data is usable on the graphics
+     * queue. Returns an empty (already complete) ticket if nothing is queued.
+     */
+    SubmitTicket flush();
+
+    /// Reclaim ring space from completed batches (non-blocking)
+    void collect();
+
+    /// Flush and block until every batch has completed
+    void waitIdle();
+
+    /// Bytes queued but not yet flushed
+    VkDeviceSize pendingBytes() const { return pendingBytes_; }
+
+    /// Number of submitted batches still in flight
+    size_t batchesInFlight() const { return inFlight_.size(); }
+
+    /// True if copies run on a dedicated transfer queue
+    bool usesTransferQueue() const { return ownershipTransfer_; }
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    /// Destructor - waits for in-flight batches
+    ~UploadManager();
+
+    // Non-copyable, non-movable (pools and ring are tied to this instance)
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+
+private:
+    friend class Builder;
+    UploadManager() = default;
+
+    struct BufferCopy {
+        VkBuffer src;
+        VkBuffer dst;
+        VkBufferCopy region;
+    };
+
+    struct ImageCopy {
+        VkBuffer src;
+        VkImage dst;
+        VkBufferImageCopy region;
+        VkImageLayout finalLayout;
+    };
+
+    struct Batch {
+        SubmitTicket ticket;
+        VkDeviceSize ringEnd;  // Ring head when the batch was flushed
+    };
+
+    /// Copy data into the ring (or a one-off buffer); returns the source buffer
+    VkBuffer stage(const void* data, VkDeviceSize size, VkDeviceSize& outOffset);
+
+    /// Reserve ring space, flushing and waiting for old batches if full
+    VkDeviceSize reserve(VkDeviceSize size);
+
+    LogicalDevice* device_ = nullptr;
+    std::unique_ptr<CommandPool> transferPool_;
+    std::unique_ptr<CommandPool> graphicsPool_;
+    bool ownershipTransfer_ = false;
+
+    BufferPtr ring_;
+    VkDeviceSize ringSize_ = 0;
+    VkDeviceSize head_ = 0;
+    VkDeviceSize tail_ = 0;
+    VkDeviceSize dirtyStart_ = 0;  // Ring head at the last flush(); the batch's data follows it
+
+    std::vector<BufferCopy> pendingBuffers_;
+    std::vector<ImageCopy> pendingImages_;
+    std::vector<BufferPtr> pendingStaging_;
+    VkDeviceSize pendingBytes_ = 0;
+
+    std::deque<Batch> inFlight_;
+};
+
+} // namespace finevk
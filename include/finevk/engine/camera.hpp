@@ -4,6 +4,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <array>
+#include <cstdint>
 
 namespace finevk {
 
@@ -38,6 +39,10 @@ struct AABB {
  *
  * Contains pre-computed matrices and frustum planes needed by render systems.
  * Extracted from Camera for efficient passing to RenderAgent.
+ *
+ * version lets consumers skip work for a camera that didn't change:
+ * RenderAgent::updateCamera() keeps its culling, sorting and LOD results,
+ * and UniformBuffer::update(frameIndex, data, version) skips the copy.
  */
 struct CameraState {
     glm::mat4 view{1.0f};
@@ -48,8 +53,19 @@ struct CameraState {
     /// Frustum planes in world space (left, right, bottom, top, near, far)
     /// Planes point inward (negative half-space is inside frustum)
     std::array<glm::vec4, 6> frustumPlanes;
+
+    /// Bumped by Camera::updateState() on every change; 0 for hand-built states
+    uint64_t version = 0;
 };
 
+/**
+ * @brief Extract normalized frustum planes from a view-projection matrix
+ *
+ * Same planes and order as CameraState::frustumPlanes. Uses SSE or NEON
+ * where available; for states built by hand (shadow cascades, probes).
+ */
+void extractFrustumPlanes(const glm::mat4& viewProjection, std::array<glm::vec4, 6>& planes);
+
 /**
  * @brief Camera with movement and orientation helpers
  *
@@ -68,7 +84,7 @@ struct CameraState {
  * // In game loop:
  * camera.moveForward(speed * dt);
  * camera.rotateYaw(mouseDeltaX * sensitivity);
- * camera.updateState();
+ * camera.updateState();  // Free when nothing moved
  *
  * // Pass to render agent:
  * renderAgent.updateCamera(camera.state());
@@ -174,13 +190,21 @@ public:
      * @brief Update camera state (matrices and frustum)
      *
      * Call after any position/orientation changes and before using state().
-     * Recomputes view matrix, view-projection matrix, and extracts frustum planes.
+     * Movement and orientation changes mark the view dirty, projection
+     * changes the projection; only dirty matrices are rebuilt, and the
+     * view-projection and frustum planes only if either was. Setters given
+     * their current values mark nothing.
+     *
+     * @return True if the state changed (state().version was bumped)
      */
-    void updateState();
+    bool updateState();
 
     /// Get current camera state (call updateState() first if camera moved)
     const CameraState& state() const { return state_; }
 
+    /// True if a change is waiting for updateState()
+    bool isDirty() const { return viewDirty_ || projectionDirty_; }
+
     /// Get current position
     const glm::vec3& position() const { return position_; }
 
@@ -194,7 +218,7 @@ public:
     glm::vec3 right() const { return glm::cross(forward_, up_); }
 
 private:
-    void extractFrustumPlanes();
+    void updateProjection();
 
     // Position and orientation
     glm::vec3 position_{0.0f, 0.0f, 0.0f};
@@ -214,8 +238,11 @@ private:
     float orthoBottom_ = -1.0f;
     float orthoTop_ = 1.0f;
 
-    // Computed state
+    // Computed state, rebuilt lazily by updateState()
     CameraState state_;
+    bool viewDirty_ = true;
+    bool projectionDirty_ = false;
+    bool hasProjection_ = false;    // Identity until a projection is set
 };
 
 } // namespace finevk
@@ -1,9 +1,15 @@
 #pragma once
 
-#include <functional>
-#include <vector>
-#include <mutex>
+#include "finevk/device/command.hpp"
+#include "finevk/device/logical_device.hpp"
+
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace finevk {
 
@@ -11,13 +17,24 @@ namespace finevk {
  * @brief Thread-safe deferred resource disposal
  *
  * DeferredDisposer safely destroys Vulkan resources after the GPU is done using them.
- * Resources are queued for disposal and destroyed after a specified number of frames.
+ * With retireOn(queue), a plain dispose() waits for the queue's timeline
+ * semaphore to pass the last submission made before the next processFrame(),
+ * so resources are freed exactly when the GPU is done instead of after a
+ * guessed number of frames. Without a queue (or a timeline-capable device)
+ * they're destroyed after defaultFrameDelay() frames (GameLoop keeps that at
+ * the device's frames in flight); an explicit frameDelay always counts frames.
  *
  * **When to use**:
  * - Resource was used in a submitted command buffer (GPU may still be using it)
  * - Avoiding fence waits during swap chain recreation
  * - Cross-thread resource release (queue for render thread disposal)
  *
+ * Queueing is wait-free from any thread: entries go onto an intrusive
+ * multi-producer queue and deleters up to 48 bytes are stored inline, so
+ * the only allocation is the entry itself. The thread calling processFrame()
+ * and the dispose/count methods sorts them into a ring of per-frame buckets,
+ * making both queueing and processing O(1) amortized per resource.
+ *
  * **When NOT to use**:
  * - CPU-only helpers (just let them destruct normally)
  * - Never-submitted resources (immediate destruction is safe)
@@ -25,7 +42,9 @@ namespace finevk {
  *
  * Usage:
  * @code
- * // Queue for deferred deletion (will be destroyed after 2 frames by default)
+ * disposer.retireOn(device->graphicsQueue());  // GameLoop does this
+ *
+ * // Queue for deferred deletion (destroyed once the GPU finishes this frame)
  * disposer.dispose([buffer = std::move(buffer)]() mutable {
  *     buffer.reset();  // Destroy after GPU is done
  * });
@@ -48,34 +67,105 @@ public:
     /// Constructor for instance-based usage
     DeferredDisposer() = default;
 
+    /// Destructor - releases pending deleters without running them
+    ~DeferredDisposer();
+
     // Thread-safe
     DeferredDisposer(const DeferredDisposer&) = delete;
     DeferredDisposer& operator=(const DeferredDisposer&) = delete;
 
+    /**
+     * @brief Retire plain dispose() calls on a queue's timeline
+     *
+     * Entries wait for the queue's last submission as of the next
+     * processFrame() to complete. nullptr, or a queue without a timeline
+     * semaphore, restores the default frame delay; entries still waiting on the
+     * previous queue are converted to it. The queue must outlive the
+     * disposer or be unset first.
+     */
+    void retireOn(const Queue* queue);
+
+    /// Frames dispose() waits without a retire timeline (default: 2)
+    void setDefaultFrameDelay(uint32_t frames) { defaultDelay_.store(frames, std::memory_order_relaxed); }
+    uint32_t defaultFrameDelay() const { return defaultDelay_.load(std::memory_order_relaxed); }
+
     /**
      * @brief Queue a resource for deferred disposal
      *
-     * The deleter will be called after frameDelay frames have passed.
-     * Thread-safe - can be called from any thread.
+     * The deleter runs once the GPU has finished everything submitted up to
+     * the next processFrame() on the retireOn() queue, or after
+     * defaultFrameDelay() frames without one. Wait-free - can be called from any thread.
+     *
+     * @param deleter Callable destroying the resource (moved in)
+     */
+    template<typename F>
+    void dispose(F&& deleter) {
+        Node* node = new Node();
+        node->deleter.emplace(std::forward<F>(deleter));
+        node->retire = true;
+        enqueue(node, 0);
+    }
+
+    /**
+     * @brief Queue a resource for disposal after a fixed number of frames
+     *
+     * @param deleter Callable destroying the resource (moved in)
+     * @param frameDelay Number of frames to wait before disposal
+     */
+    template<typename F>
+    void dispose(F&& deleter, uint32_t frameDelay) {
+        Node* node = new Node();
+        node->deleter.emplace(std::forward<F>(deleter));
+        enqueue(node, frameDelay);
+    }
+
+    /**
+     * @brief Queue a resource for disposal once a condition holds
+     *
+     * The deleter runs the first time isReady() returns true after frameDelay
+     * frames. isReady is called from the processing thread with its lock
+     * held, so it must not call the processing methods (queueing is fine).
+     */
+    template<typename P, typename F>
+    void disposeWhen(P&& isReady, F&& deleter, uint32_t frameDelay = 0) {
+        Node* node = new Node();
+        node->isReady.emplace(std::forward<P>(isReady));
+        node->deleter.emplace(std::forward<F>(deleter));
+        enqueue(node, frameDelay);
+    }
+
+    /**
+     * @brief Queue a resource for disposal once a GPU submission completes
      *
-     * @param deleter Function to destroy the resource
-     * @param frameDelay Number of frames to wait before disposal (default: 2)
+     * Use for staging buffers and other resources referenced by a
+     * submitAsync() submission, instead of guessing a frame delay.
      */
-    void dispose(std::function<void()> deleter, uint32_t frameDelay = 2);
+    template<typename F>
+    void disposeAfter(const SubmitTicket& ticket, F&& deleter) {
+        disposeWhen([ticket]() { return ticket.isSignaled(); }, std::forward<F>(deleter));
+    }
+
+    /// Queue a resource for disposal once a queue timeline reaches point
+    template<typename F>
+    void disposeAfter(const TimelinePoint& point, F&& deleter) {
+        disposeWhen([point]() { return point.isComplete(); }, std::forward<F>(deleter));
+    }
 
     /**
      * @brief Mark that a frame has passed
      *
-     * Decrements the frame counter for all pending disposals.
-     * Call once per frame, typically from GameLoop.
+     * Advances the frame counter and moves the bucket of the new frame to
+     * the ready list, and tags dispose() entries queued since the last call
+     * with the retire queue's last submitted value. Call once per frame
+     * after submitting, typically from GameLoop.
      */
     void processFrame();
 
     /**
      * @brief Try to dispose one ready resource (non-blocking)
      *
-     * Checks if any resource is ready for disposal (frameDelay reached 0)
-     * and destroys exactly one if available. Returns immediately if none ready.
+     * Checks if any resource is ready for disposal (frameDelay reached 0 or
+     * its timeline value completed) and destroys exactly one if available. Returns immediately if none ready.
      *
      * Designed to be called in a loop with time budget checking:
      * @code
@@ -112,23 +202,99 @@ public:
      *
      * Thread-safe query of how many resources are queued.
      */
-    size_t pendingCount() const;
+    size_t pendingCount() const { return pendingCount_.load(std::memory_order_relaxed); }
 
     /**
      * @brief Get count of ready disposals
      *
      * Thread-safe query of how many resources are ready for disposal now.
+     * Evaluates the conditions of disposeWhen() entries past their delay.
      */
     size_t readyCount() const;
 
 private:
-    struct PendingDisposal {
-        std::function<void()> deleter;
-        uint32_t framesRemaining;
+    /// Move-only-by-placement callable with inline storage (heap beyond 48 bytes)
+    template<typename R>
+    class Callable {
+    public:
+        Callable() = default;
+        ~Callable() { reset(); }
+        Callable(const Callable&) = delete;
+        Callable& operator=(const Callable&) = delete;
+
+        template<typename F>
+        void emplace(F&& f) {
+            using Fn = std::decay_t<F>;
+            reset();
+            if constexpr (sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t)) {
+                new (storage_) Fn(std::forward<F>(f));
+                invoke_ = [](void* p) -> R { return (*static_cast<Fn*>(p))(); };
+                destroy_ = [](void* p) { static_cast<Fn*>(p)->~Fn(); };
+            } else {
+                new (storage_) Fn*(new Fn(std::forward<F>(f)));
+                invoke_ = [](void* p) -> R { return (**static_cast<Fn**>(p))(); };
+                destroy_ = [](void* p) { delete *static_cast<Fn**>(p); };
+            }
+        }
+
+        explicit operator bool() const { return invoke_ != nullptr; }
+        R operator()() { return invoke_(storage_); }
+
+        void reset() {
+            if (destroy_) {
+                destroy_(storage_);
+            }
+            invoke_ = nullptr;
+            destroy_ = nullptr;
+        }
+
+    private:
+        static constexpr size_t kInlineSize = 48;
+        alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+        R (*invoke_)(void*) = nullptr;
+        void (*destroy_)(void*) = nullptr;
+    };
+
+    struct Node {
+        std::atomic<Node*> next{nullptr};  // Incoming queue link (producers)
+        Node* link = nullptr;              // Bucket / ready list link (processing thread)
+        uint64_t readyFrame = 0;
+        uint64_t retireValue = 0;          // Timeline value, once tagged
+        bool retire = false;               // Waits on the retire queue's timeline
+        Callable<bool> isReady;            // Optional extra readiness condition
+        Callable<void> deleter;
     };
 
-    mutable std::mutex mutex_;
-    std::vector<PendingDisposal> pending_;
+    /// Power of two; delays up to this many frames are visited once
+    static constexpr size_t kBucketCount = 8;
+
+    void enqueue(Node* node, uint32_t frameDelay);
+    Node* popIncoming() const;
+    void drainIncoming() const;
+    void place(Node* node) const;
+    void tagUntagged();
+    void releaseTimeline() const;
+    Node* takeReady() const;
+    void run(Node* node, const char* what);
+
+    // Incoming: Vyukov intrusive MPSC queue, producers exchange the head
+    mutable std::atomic<Node*> head_{&stub_};
+    mutable Node* tail_ = &stub_;
+    mutable Node stub_;
+
+    std::atomic<uint64_t> frame_{0};
+    std::atomic<uint32_t> defaultDelay_{2};  // dispose() without a retire timeline
+    std::atomic<size_t> pendingCount_{0};
+
+    // Processing side, serialized by processMutex_ (producers never take it)
+    mutable std::mutex processMutex_;
+    mutable Node* buckets_[kBucketCount] = {};
+    mutable Node* ready_ = nullptr;        // Past their delay, no condition
+    mutable Node* conditional_ = nullptr;  // Past their delay, condition pending
+    const Queue* retireQueue_ = nullptr;   // Has a timeline when set
+    mutable Node* untagged_ = nullptr;     // dispose() entries awaiting a timeline value
+    mutable Node* timelineHead_ = nullptr; // Tagged entries, oldest (lowest value) first
+    mutable Node* timelineTail_ = nullptr;
 };
 
 } // namespace finevk
@@ -14,6 +14,15 @@
 #include "finevk/engine/game_loop.hpp"
 #include "finevk/engine/camera.hpp"
 #include "finevk/engine/render_agent.hpp"
+#include "finevk/engine/static_batch.hpp"
+#include "finevk/engine/gpu_culler.hpp"
+#include "finevk/engine/hiz_pyramid.hpp"
+#include "finevk/engine/particle_system.hpp"
+#include "finevk/engine/frustum_cull.hpp"
+#include "finevk/engine/spatial_index.hpp"
+#include "finevk/engine/job_system.hpp"
+#include "finevk/engine/radix_sort.hpp"
+#include "finevk/engine/snapshot_buffer.hpp"
 
 namespace finevk {
 
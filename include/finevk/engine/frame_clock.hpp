@@ -9,6 +9,7 @@ namespace finevk {
  *
  * FrameClock provides high-resolution timing for frame delta calculations
  * and FPS tracking. It uses std::chrono for platform-independent timing.
+ * For frame time percentiles (p50/p99) see Profiler::frameStats().
  */
 class FrameClock {
 public:
@@ -32,6 +33,15 @@ public:
     /// Sleep for a specified duration in seconds
     static void sleep(float seconds);
 
+    /**
+     * @brief Sleep accurately: OS sleep for all but the last spinSeconds, then spin
+     *
+     * OS sleeps commonly overshoot by a millisecond or more, which is enough
+     * to miss a refresh at high framerates. Spinning the final stretch
+     * trades a little CPU time for wakeups within microseconds.
+     */
+    static void sleepPrecise(float seconds, float spinSeconds = 0.002f);
+
 private:
     using Clock = std::chrono::high_resolution_clock;
     using TimePoint = std::chrono::time_point<Clock>;
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "finevk/engine/camera.hpp"
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief World-space bounds stored as structure-of-arrays for batch culling
+ *
+ * Keeps min/max x/y/z in six parallel float arrays so the frustum test can
+ * check 8 (AVX) or 4 (SSE/NEON) boxes per iteration. Arrays are padded to a
+ * multiple of 8; padding entries never report visible.
+ *
+ * Usage:
+ * @code
+ * BoundsSoA bounds;
+ * bounds.resize(renderables.size());
+ * for (size_t i = 0; i < renderables.size(); i++) {
+ *     bounds.set(i, renderables[i].worldBounds());   // Only when transforms change
+ * }
+ *
+ * std::vector<uint64_t> visible;
+ * bounds.cull(camera.frustumPlanes, visible);
+ * bool isVisible = BoundsSoA::test(visible, 42);
+ * @endcode
+ */
+class BoundsSoA {
+public:
+    /// Resize to count boxes (new boxes are empty at the origin)
+    void resize(size_t count);
+
+    /// Remove all boxes
+    void clear() { resize(0); }
+
+    /// Number of boxes
+    size_t size() const { return count_; }
+
+    /// Set one box
+    void set(size_t index, const AABB& bounds);
+
+    /// Read one box back
+    AABB get(size_t index) const;
+
+    /**
+     * @brief Frustum-test every box
+     *
+     * Writes one bit per box into mask (bit i of word i/64 set = intersects
+     * or inside). Same plane convention as AABB::intersectsFrustum.
+     */
+    void cull(const std::array<glm::vec4, 6>& frustumPlanes, std::vector<uint64_t>& mask) const;
+
+    /**
+     * @brief Frustum-test boxes [begin, end) into an existing mask
+     *
+     * For splitting one cull across threads: mask must already hold
+     * (size() + 63) / 64 zeroed words and begin must be a multiple of 64, so
+     * ranges never share a word.
+     */
+    void cull(const std::array<glm::vec4, 6>& frustumPlanes, std::vector<uint64_t>& mask,
+              size_t begin, size_t end) const;
+
+    /// Most views cullViews() tests at once (one bit each in a view mask)
+    static constexpr size_t MaxViews = 32;
+
+    /**
+     * @brief Frustum-test every box against several views in one pass
+     *
+     * Each block of boxes is loaded once and tested against every frustum
+     * while it is in cache. viewMasks gets one word per box (bit v set =
+     * visible in view v) and anyMask the union, laid out as in cull().
+     *
+     * @throws std::invalid_argument for more than MaxViews frusta
+     */
+    void cullViews(const std::vector<std::array<glm::vec4, 6>>& frusta,
+                   std::vector<uint64_t>& anyMask, std::vector<uint32_t>& viewMasks) const;
+
+    /**
+     * @brief Multi-view test of boxes [begin, end) into existing masks
+     *
+     * Same splitting rules as the ranged cull(): anyMask must hold
+     * (size() + 63) / 64 zeroed words, viewMasks size() zeroed words, and
+     * begin must be a multiple of 64.
+     */
+    void cullViews(const std::vector<std::array<glm::vec4, 6>>& frusta,
+                   std::vector<uint64_t>& anyMask, std::vector<uint32_t>& viewMasks,
+                   size_t begin, size_t end) const;
+
+    /// Check a box's bit in a mask produced by cull()
+    static bool test(const std::vector<uint64_t>& mask, size_t index) {
+        return (mask[index >> 6] >> (index & 63)) & 1u;
+    }
+
+    /// Name of the compiled kernel ("avx", "sse", "neon" or "scalar")
+    static const char* simdPath();
+
+private:
+    std::vector<float> minX_, minY_, minZ_;
+    std::vector<float> maxX_, maxY_, maxZ_;
+    size_t count_ = 0;
+};
+
+} // namespace finevk
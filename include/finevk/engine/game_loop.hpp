@@ -2,13 +2,27 @@
 
 #include "finevk/engine/frame_clock.hpp"
 #include "finevk/engine/deferred_disposer.hpp"
+#include "finevk/engine/snapshot_buffer.hpp"
 #include "finevk/window/window.hpp"
 #include "finevk/rendering/render_target.hpp"
+#include "finevk/high/simple_renderer.hpp"
+#include <atomic>
 #include <functional>
 #include <exception>
+#include <mutex>
+#include <thread>
 
 namespace finevk {
 
+/**
+ * @brief Counters of one GameLoop frame
+ */
+struct FrameStats {
+    uint64_t frame = 0;             ///< frameNumber() of the frame
+    double cpuMilliseconds = 0.0;   ///< runFrame() work, excluding pacing sleep
+    RenderStats render;             ///< From setStatsRenderer() (zero without one)
+};
+
 /**
  * @brief Game loop with fixed timestep logic and variable framerate rendering
  *
@@ -57,6 +71,23 @@ namespace finevk {
  * });
  * loop.run();
  * @endcode
+ *
+ * Threaded simulation (setThreadedSimulation(true)): onFixedUpdate runs on
+ * its own thread at the fixed rate and must only touch simulation state.
+ * Everything rendering needs crosses over through a SnapshotBuffer; the
+ * render thread interpolates between its previous() and current() with
+ * the interpolation factor passed to onRender.
+ * @code
+ * void onFixedUpdate(float dt) override {        // simulation thread
+ *     world_.step(dt);
+ *     snapshots_.write() = world_.renderState();
+ *     snapshots_.publish(simulationTick());
+ * }
+ * void onRender(float dt, float alpha) override {  // main thread
+ *     snapshots_.update();
+ *     draw(lerp(snapshots_.previous(), snapshots_.current(), alpha));
+ * }
+ * @endcode
  */
 class GameLoop {
 public:
@@ -113,6 +144,36 @@ public:
         targetFrameTime_ = (fps > 0.0f) ? (1.0f / fps) : 0.0f;
     }
 
+    /// Spin the last part of each pacing sleep for accuracy (0 = plain sleep) (default: 0.002)
+    void setPacingSpin(float seconds) { pacingSpin_ = seconds; }
+
+    /**
+     * @brief Wait for the GPU (and display) before polling input (default: off)
+     *
+     * Each frame starts with Window::waitForFrame(queuedPresents), so input
+     * is polled right before rendering rather than before a fence wait.
+     * With present wait enabled on the device, queuedPresents 0 starts each
+     * frame once the previous one is on screen (lowest latency, but a frame
+     * that overruns a refresh halves the rate); 1 keeps one frame queued.
+     */
+    void setLowLatency(bool enable, uint32_t queuedPresents = 1) {
+        lowLatency_ = enable;
+        queuedPresents_ = queuedPresents;
+    }
+
+    /**
+     * @brief Run onFixedUpdate on a dedicated simulation thread (default: off)
+     *
+     * Takes effect at the next run(). The thread ticks at the fixed
+     * timestep independently of the framerate; exceptions it throws are
+     * handed to onError on the main thread. See the class docs for how
+     * state crosses threads.
+     */
+    void setThreadedSimulation(bool enable) { threadedSimulation_ = enable; }
+
+    /// Renderer whose frameStats() are copied into frameStats() (non-owning, nullptr = none)
+    void setStatsRenderer(SimpleRenderer* renderer) { statsRenderer_ = renderer; }
+
     // =========================================================================
     // Listener Setters
     // =========================================================================
@@ -158,6 +219,9 @@ public:
      *
      * Called automatically by run() if not done explicitly.
      * Can be called manually to separate setup from blocking run().
+     * Points the disposer at the graphics queue's timeline (see
+     * DeferredDisposer::retireOn()) and routes Window::retire(), which
+     * swap chain recreation uses, through it.
      */
     virtual void setup();
 
@@ -173,6 +237,7 @@ public:
      * @brief Clean up resources
      *
      * Called automatically by destructor if not done explicitly.
+     * Detaches the disposer from the graphics queue.
      */
     virtual void shutdown();
 
@@ -202,6 +267,21 @@ public:
     /// Get current frame number
     uint64_t frameNumber() const { return frameNumber_; }
 
+    /// Check if low-latency mode is on
+    bool isLowLatency() const { return lowLatency_; }
+
+    /// Check if onFixedUpdate is running on the simulation thread
+    bool isSimulationThreaded() const { return simThread_.joinable(); }
+
+    /// Number of completed fixed updates this run (the current tick's index inside onFixedUpdate)
+    uint64_t simulationTick() const { return simTick_.load(std::memory_order_acquire); }
+
+    /// Counters of the last completed frame (draws, binds, GPU time, pipeline statistics)
+    const FrameStats& frameStats() const { return frameStats_; }
+
+    /// Measured input-to-present / input-to-display latency (see Window::latency())
+    const FrameLatency& latency() const { return window_->latency(); }
+
     // =========================================================================
     // Virtual Methods (Override Points)
     // =========================================================================
@@ -218,6 +298,7 @@ protected:
      * @brief Fixed timestep update for game logic
      *
      * Called at fixed rate (e.g., 60 Hz). Use for physics, AI, game rules.
+     * With threaded simulation this runs on the simulation thread.
      * Default: Calls fixedUpdateListener_ if set.
      *
      * @param fixedDt Fixed delta time in seconds
@@ -280,7 +361,7 @@ protected:
      *
      * Called every gcInterval_ frames.
      * Default implementation:
-     * 1. Calls disposer_->processFrame() to decrement frame counters
+     * 1. Calls disposer_->processFrame() to advance the disposal frame
      * 2. Calls gcListener_ if set
      * 3. Calls disposer_->tryDisposeOne() in loop until time budget exhausted
      *
@@ -324,6 +405,13 @@ private:
     // Run one frame of the game loop
     void runFrame(float dt);
 
+    // Threaded simulation
+    void startSimulation();
+    void stopSimulation();
+    void simulationLoop();
+    float simulationInterpolation() const;
+    bool handleSimulationError();
+
     // Non-owning references
     Window* window_ = nullptr;
     RenderTarget* renderTarget_ = nullptr;
@@ -333,9 +421,21 @@ private:
     FrameClock clock_;
     float fixedTimestep_ = 1.0f / 60.0f;
     float targetFrameTime_ = 0.0f;  // 0 = unlimited
+    float pacingSpin_ = 0.002f;
+    bool lowLatency_ = false;
+    uint32_t queuedPresents_ = 1;
     float accumulator_ = 0.0f;
     int maxUpdatesPerFrame_ = 5;
 
+    // Simulation thread (fixed updates); the tick time is steady_clock ticks
+    bool threadedSimulation_ = false;
+    std::thread simThread_;
+    std::atomic<bool> simRunning_{false};
+    std::atomic<uint64_t> simTick_{0};
+    std::atomic<int64_t> simTickTime_{0};
+    std::mutex simErrorMutex_;
+    std::exception_ptr simError_;
+
     // State
     bool isSetup_ = false;
     bool isRunning_ = false;
@@ -343,6 +443,10 @@ private:
     bool shouldQuit_ = false;
     uint64_t frameNumber_ = 0;
 
+    // Statistics
+    SimpleRenderer* statsRenderer_ = nullptr;
+    FrameStats frameStats_;
+
     // Garbage collection
     int gcInterval_ = 60;
     int gcCounter_ = 0;
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/engine/camera.hpp"
+#include "finevk/rendering/descriptors.hpp"
+#include "finevk/rendering/pipeline.hpp"
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandBuffer;
+class HiZPyramid;
+struct Renderable;
+
+/**
+ * @brief GPU-driven frustum culling with multi-draw indirect output
+ *
+ * GpuCuller keeps every renderable's world bounds, draw parameters and
+ * transform in storage buffers. Each frame a compute shader (gpu_cull.comp)
+ * tests the bounds against the camera frustum and appends a
+ * VkDrawIndexedIndirectCommand per visible object into its draw group;
+ * draw() then issues one vkCmdDrawIndexedIndirectCount per group.
+ *
+ * A draw group is a set of renderables sharing pipeline, layout, material,
+ * vertex/index buffer and index type (meshes from one MeshBatch share
+ * buffers). Transforms are bound as an instance-rate vertex binding and
+ * fetched with firstInstance = object index, so pipelines must declare it
+ * with RenderAgent::addInstanceAttributes().
+ *
+ * Without the drawIndirectCount feature the command buffer is zero-filled
+ * before culling and every slot of a group is drawn; culled slots are empty
+ * draws.
+ *
+ * With occlusion() culling runs in two phases (gpu_cull_occlusion.comp)
+ * against a HiZPyramid. cull() draws, through draw(), the objects that were
+ * visible last frame and pass the previous pyramid; after the pyramid has
+ * been rebuilt from that depth, cullLate() tests every object against it
+ * and drawLate() draws the visible ones the first phase skipped, so newly
+ * disoccluded objects appear the same frame. A per-object visibility buffer
+ * carries the result to the next frame.
+ *
+ * Usage:
+ * @code
+ * auto cullShader = ShaderModule::fromFile(device, "shaders/gpu_cull.comp.spv");
+ * auto culler = GpuCuller::create(device).shader(cullShader).build();
+ *
+ * culler->setScene(renderablePointers);       // When the scene changes
+ * culler->cull(cmd, frameIndex, cameraState); // Outside the render pass
+ * // ... begin render pass ...
+ * culler->draw(cmd);
+ * @endcode
+ *
+ * Two-phase occlusion culling (the target is built with sampledDepth()):
+ * @code
+ * culler->cull(cmd, frameIndex, cameraState);
+ * target->begin(cmd);
+ * culler->draw(cmd);
+ * target->end(cmd);
+ * pyramid->record(cmd, frameIndex, *target->depthImage());
+ * culler->cullLate(cmd);
+ * target->resume(cmd);
+ * culler->drawLate(cmd);
+ * target->end(cmd);
+ * @endcode
+ */
+class GpuCuller {
+public:
+    /**
+     * @brief Builder for creating GpuCuller objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Compiled gpu_cull.comp (required)
+        Builder& shader(ShaderModule* module);
+        Builder& shader(const ShaderModulePtr& module) { return shader(module.get()); }
+
+        /// Number of frames in flight (default: the device's maxFramesInFlight())
+        Builder& framesInFlight(uint32_t count);
+
+        /// Vertex binding the transforms are bound to (default: 1)
+        Builder& instanceBinding(uint32_t binding);
+
+        /**
+         * @brief Enable two-phase occlusion culling
+         *
+         * @param module Compiled gpu_cull_occlusion.comp (replaces shader())
+         * @param pyramid Pyramid rebuilt each frame between cull() and
+         *                cullLate(); must outlive the culler
+         */
+        Builder& occlusion(ShaderModule* module, HiZPyramid* pyramid);
+        Builder& occlusion(const ShaderModulePtr& module, HiZPyramid* pyramid) {
+            return occlusion(module.get(), pyramid);
+        }
+
+        /// Build the culler
+        std::unique_ptr<GpuCuller> build();
+
+    private:
+        LogicalDevice* device_;
+        ShaderModule* shader_ = nullptr;
+        ShaderModule* occlusionShader_ = nullptr;
+        HiZPyramid* pyramid_ = nullptr;
+        uint32_t framesInFlight_ = 0;
+        uint32_t instanceBinding_ = 1;
+    };
+
+    /// Create a builder for a GPU culler
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /**
+     * @brief Replace the scene
+     *
+     * Computes world bounds and draw groups on the CPU. Each object draws
+     * its Renderable::lod. Per-frame buffers are refreshed lazily the next
+     * time each frame slot is culled.
+     */
+    void setScene(const std::vector<const Renderable*>& objects);
+
+    /**
+     * @brief Record the culling dispatch for a frame
+     *
+     * Must be recorded outside a render pass, after the frame's fence has
+     * signaled. Includes the barriers that make the output visible to
+     * indirect draws. With occlusion() this is the first phase.
+     */
+    void cull(CommandBuffer& cmd, uint32_t frameIndex, const CameraState& camera);
+
+    /// Record the indirect draws for the frame last passed to cull()
+    void draw(CommandBuffer& cmd);
+
+    /**
+     * @brief Record the second occlusion phase for the frame last passed to cull()
+     *
+     * Outside a render pass, after HiZPyramid::record() for the frame.
+     */
+    void cullLate(CommandBuffer& cmd);
+
+    /// Record the second phase's indirect draws
+    void drawLate(CommandBuffer& cmd);
+
+    /// True if built with occlusion()
+    bool usesOcclusion() const { return pyramid_ != nullptr; }
+
+    /// Number of objects in the scene
+    uint32_t objectCount() const { return static_cast<uint32_t>(objects_.size()); }
+
+    /// Number of draw groups (indirect draw calls per frame)
+    uint32_t groupCount() const { return static_cast<uint32_t>(groups_.size()); }
+
+    /// True if draws use vkCmdDrawIndexedIndirectCount
+    bool usesDrawCount() const { return useDrawCount_; }
+
+    /// Destructor
+    ~GpuCuller();
+
+    // Non-copyable
+    GpuCuller(const GpuCuller&) = delete;
+    GpuCuller& operator=(const GpuCuller&) = delete;
+
+private:
+    friend class Builder;
+    GpuCuller() = default;
+
+    /// Matches CullObject in gpu_cull.comp (std430)
+    struct CullObject {
+        glm::vec4 boundsMin;
+        glm::vec4 boundsMax;
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t group;
+    };
+
+    /// Matches CullParams push constants in gpu_cull.comp
+    struct CullParams {
+        glm::vec4 planes[6];
+        uint32_t objectCount;
+    };
+
+    /// Matches OcclusionParams push constants in gpu_cull_occlusion.comp
+    struct OcclusionParams {
+        glm::mat4 viewProjection;
+        glm::vec2 depthSize;
+        uint32_t objectCount;
+        uint32_t phase;
+    };
+
+    struct DrawGroup {
+        const Renderable* first;  // State source for the group
+        uint32_t offset;          // First command slot
+        uint32_t count;           // Objects in the group
+    };
+
+    struct Frame {
+        BufferPtr objects;
+        BufferPtr groupOffsets;
+        BufferPtr transforms;
+        BufferPtr commands;
+        BufferPtr counts;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;  // Early phase with occlusion
+        uint64_t version = 0;  // Scene version uploaded to this slot
+
+        // Occlusion: second phase output and the resources last written to the sets
+        BufferPtr lateCommands;
+        BufferPtr lateCounts;
+        VkDescriptorSet lateSet = VK_NULL_HANDLE;
+        const Buffer* visibility = nullptr;
+        VkImageView earlyPyramid = VK_NULL_HANDLE;
+        VkImageView latePyramid = VK_NULL_HANDLE;
+    };
+
+    /// Upload scene data to a frame slot, growing its buffers if needed
+    void refresh(Frame& frame);
+
+    /// Grow the shared visibility buffer and point the frame's sets at it
+    void bindVisibility(Frame& frame);
+
+    /// Record one occlusion phase's dispatch
+    void dispatchOcclusion(CommandBuffer& cmd, VkDescriptorSet set, uint32_t phase);
+
+    /// Record indirect draws from one command/count buffer pair
+    void drawGroups(CommandBuffer& cmd, Buffer& commands, Buffer& counts);
+
+    LogicalDevice* device_ = nullptr;
+    uint32_t instanceBinding_ = 1;
+    bool useDrawCount_ = false;
+    bool multiDraw_ = false;
+
+    DescriptorSetLayoutPtr setLayout_;
+    DescriptorPoolPtr descriptorPool_;
+    PipelineLayoutPtr pipelineLayout_;
+    ComputePipelinePtr pipeline_;
+
+    std::vector<CullObject> objects_;
+    std::vector<glm::mat4> transforms_;
+    std::vector<uint32_t> groupOffsets_;
+    std::vector<DrawGroup> groups_;
+    uint64_t version_ = 1;
+
+    std::vector<Frame> frames_;
+    uint32_t currentFrame_ = 0;
+
+    // Occlusion culling
+    HiZPyramid* pyramid_ = nullptr;
+    glm::mat4 viewProjection_{1.0f};  // Camera of the last cull()
+    BufferPtr visibility_;            // Shared by all frames, one uint per object
+    uint64_t visibilityVersion_ = 0;  // Scene version visibility_ was cleared for
+    std::vector<std::pair<uint64_t, BufferPtr>> retiredVisibility_;  // (cull count, buffer)
+    uint64_t cullCount_ = 0;
+};
+
+} // namespace finevk
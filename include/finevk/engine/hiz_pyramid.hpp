@@ -0,0 +1,193 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/engine/camera.hpp"
+#include "finevk/rendering/descriptors.hpp"
+#include "finevk/rendering/pipeline.hpp"
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandBuffer;
+class Image;
+
+/**
+ * @brief Hierarchical depth (Hi-Z) pyramid for occlusion culling
+ *
+ * record() reduces a depth buffer into an R32_SFLOAT mip chain with one
+ * compute dispatch per level (hiz_build.comp). Level 0 is half the depth
+ * buffer's size and every texel holds the farthest depth it covers, so an
+ * object whose nearest depth lies behind the texels under its screen
+ * rectangle is hidden. Standard depth only (0 near, 1 far).
+ *
+ * Each frame in flight owns its pyramid, so a slot is rewritten only after
+ * its fence has signaled while later frames sample the previous one. The
+ * depth buffer must be single-sample with VK_IMAGE_USAGE_SAMPLED_BIT and in
+ * VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL; a RenderTarget built
+ * with sampledDepth() leaves it that way after end().
+ *
+ * GPU path: GpuCuller::Builder::occlusion() tests bounds against view() in
+ * two phases. CPU path: with readback(), a coarse level is copied back each
+ * frame and isOccluded() tests against the newest copy that has arrived
+ * (framesInFlight frames old), for RenderAgent::setOcclusionCulling().
+ *
+ * Usage:
+ * @code
+ * auto hizShader = ShaderModule::fromFile(device, "shaders/hiz_build.comp.spv");
+ * auto pyramid = HiZPyramid::create(device).shader(hizShader).build();
+ *
+ * // Each frame, after the depth pass ended
+ * pyramid->record(cmd, frameIndex, *target->depthImage());
+ * @endcode
+ */
+class HiZPyramid {
+public:
+    /**
+     * @brief Builder for creating HiZPyramid objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Compiled hiz_build.comp (required)
+        Builder& shader(ShaderModule* module);
+        Builder& shader(const ShaderModulePtr& module) { return shader(module.get()); }
+
+        /// Number of frames in flight (default: the device's maxFramesInFlight())
+        Builder& framesInFlight(uint32_t count);
+
+        /**
+         * @brief Copy a coarse level back to the host each frame (CPU culling)
+         *
+         * The largest level no wider or taller than maxSize is read back.
+         */
+        Builder& readback(bool enable = true, uint32_t maxSize = 64);
+
+        /// Build the pyramid
+        std::unique_ptr<HiZPyramid> build();
+
+    private:
+        LogicalDevice* device_;
+        ShaderModule* shader_ = nullptr;
+        uint32_t framesInFlight_ = 0;
+        bool readback_ = false;
+        uint32_t readbackSize_ = 64;
+    };
+
+    /// Create a builder for a Hi-Z pyramid
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /**
+     * @brief Build the frame's pyramid from a depth buffer
+     *
+     * Must be recorded outside a render pass, after the frame's fence has
+     * signaled. Delivers the slot's previous readback first. Includes the
+     * barriers that make the pyramid visible to compute and fragment
+     * shaders and lets later depth writes wait for the reads.
+     */
+    void record(CommandBuffer& cmd, uint32_t frameIndex, Image& depth);
+
+    /// True once record() has been called
+    bool valid() const { return current_ != nullptr; }
+
+    /// Full mip chain of the last recorded pyramid (VK_IMAGE_LAYOUT_GENERAL)
+    VkImageView view() const;
+
+    /// Nearest-filtering, clamp-to-edge sampler for view()
+    VkSampler sampler() const;
+
+    /// Mip levels of the last recorded pyramid
+    uint32_t levels() const;
+
+    /// Size of the depth buffer the last recorded pyramid was built from
+    VkExtent2D depthExtent() const;
+
+    /**
+     * @brief Test world bounds against the newest readback (CPU path)
+     *
+     * False with no readback yet and for boxes crossing the near plane.
+     * The copy is a few frames old, so objects may pop in late after
+     * being disoccluded; use the GPU path where that matters.
+     */
+    bool isOccluded(const AABB& bounds, const glm::mat4& viewProjection) const;
+
+    /// Incremented whenever a new readback arrives
+    uint64_t readbackVersion() const { return readbackVersion_; }
+
+    uint32_t framesInFlight() const { return static_cast<uint32_t>(slots_.size()); }
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    /// Destructor
+    ~HiZPyramid();
+
+    // Non-copyable
+    HiZPyramid(const HiZPyramid&) = delete;
+    HiZPyramid& operator=(const HiZPyramid&) = delete;
+
+private:
+    friend class Builder;
+    HiZPyramid() = default;
+
+    /// Matches Params push constants in hiz_build.comp
+    struct BuildParams {
+        glm::ivec2 sourceSize;
+        glm::ivec2 targetSize;
+    };
+
+    struct Slot {
+        ImagePtr image;
+        ImageViewPtr view;
+        std::vector<ImageViewPtr> levelViews;
+        std::vector<VkDescriptorSet> levelSets;
+        VkExtent2D depthExtent{};
+
+        VkImage depthImage = VK_NULL_HANDLE;  // Source the level 0 set reads
+        ImageViewPtr depthView;
+
+        // Replaced resources, still sampled by the frame after this slot's last use
+        std::vector<ImagePtr> retiredImages;
+        std::vector<ImageViewPtr> retiredViews;
+
+        BufferPtr readback;
+        uint32_t readbackLevel = 0;
+        VkExtent2D readbackExtent{};
+        bool readbackPending = false;
+    };
+
+    /// Recreate a slot's images for a new depth size
+    void resize(Slot& slot, VkExtent2D depthExtent);
+
+    /// Copy a slot's finished readback into the CPU copy
+    void deliver(Slot& slot);
+
+    LogicalDevice* device_ = nullptr;
+    bool readbackEnabled_ = false;
+    uint32_t readbackSize_ = 64;
+
+    DescriptorSetLayoutPtr setLayout_;
+    DescriptorPoolPtr descriptorPool_;
+    PipelineLayoutPtr pipelineLayout_;
+    ComputePipelinePtr pipeline_;
+    SamplerRef sampler_;
+
+    std::vector<Slot> slots_;
+    Slot* current_ = nullptr;
+
+    // Newest readback (CPU path)
+    std::vector<float> cpuDepth_;
+    VkExtent2D cpuExtent_{};
+    VkExtent2D cpuDepthExtent_{};
+    uint32_t cpuLevel_ = 0;
+    uint64_t readbackVersion_ = 0;
+};
+
+} // namespace finevk
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief Work-stealing job system for per-frame engine work
+ *
+ * Each worker owns a queue: it pushes and pops its own jobs LIFO (cache
+ * warm) and steals FIFO from the others when it runs dry. Threads outside
+ * the system submit to a shared queue that every worker steals from.
+ *
+ * Unlike ThreadPool, waiting is cooperative: wait() runs queued jobs until
+ * its counter reaches zero, so jobs may themselves call parallelFor() or
+ * wait on sub-jobs without deadlocking.
+ *
+ * Usage:
+ * @code
+ * JobSystem& jobs = JobSystem::global();
+ *
+ * // Per-chunk outputs merge without locks
+ * std::vector<std::vector<Item>> partial(JobSystem::chunkCount(items.size(), 1024));
+ * jobs.parallelFor(items.size(), 1024, [&](size_t begin, size_t end, uint32_t chunk) {
+ *     for (size_t i = begin; i < end; ++i) {
+ *         if (keep(items[i])) partial[chunk].push_back(items[i]);
+ *     }
+ * });
+ *
+ * jobs.parallelSort(keys.begin(), keys.end(), std::less<>());
+ * @endcode
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * @brief Completion counter for a group of jobs
+     *
+     * Incremented by run(), decremented as each job finishes. The first
+     * exception thrown by a job is kept and rethrown by wait().
+     */
+    class Counter {
+    public:
+        bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+        std::atomic<uint32_t> pending_{0};
+        std::mutex errorMutex_;
+        std::exception_ptr error_;
+    };
+
+    /// Create a job system (threads == 0 uses hardware concurrency - 1, at least 1)
+    explicit JobSystem(uint32_t threads = 0);
+
+    /// Shared job system sized to the machine
+    static JobSystem& global();
+
+    /// Number of worker threads (the waiting thread also runs jobs)
+    uint32_t threadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+    /// Queue a job, tracked by counter if given
+    void run(Job job, Counter* counter = nullptr);
+
+    /// Run queued jobs until counter reaches zero; rethrows the first job exception
+    void wait(Counter& counter);
+
+    /**
+     * @brief Split [0, count) into chunks of grain items and run them in parallel
+     *
+     * The calling thread takes part. fn receives (begin, end, chunkIndex);
+     * chunk indices are dense from 0, so per-chunk outputs indexed by chunk
+     * need no locking. Safe to call from inside a job.
+     *
+     * @return Number of chunks (chunkCount(count, grain))
+     */
+    uint32_t parallelFor(size_t count, size_t grain,
+                         const std::function<void(size_t, size_t, uint32_t)>& fn);
+
+    /// Chunks parallelFor() uses for count items
+    static uint32_t chunkCount(size_t count, size_t grain) {
+        grain = std::max<size_t>(grain, 1);
+        return static_cast<uint32_t>((count + grain - 1) / grain);
+    }
+
+    /**
+     * @brief Sort [first, last) by sorting chunks in parallel and merging pairwise
+     *
+     * Not stable. Ranges of at most grain elements are sorted inline.
+     */
+    template<typename RandomIt, typename Compare>
+    void parallelSort(RandomIt first, RandomIt last, Compare comp, size_t grain = 4096);
+
+    /// Destructor - finishes queued jobs and joins workers
+    ~JobSystem();
+
+    // Non-copyable
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;  // Owner uses the back, thieves the front
+    };
+
+    /// Run one job from the own queue or a victim's; false if none found
+    bool tryRunOne();
+
+    /// Queue the calling thread pushes to (its own, or the shared one)
+    uint32_t localQueue() const;
+
+    void workerLoop(uint32_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues_;  // Workers, then the shared queue
+    std::vector<std::thread> workers_;
+    std::atomic<uint32_t> queued_{0};
+    std::atomic<bool> stopping_{false};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+};
+
+template<typename RandomIt, typename Compare>
+void JobSystem::parallelSort(RandomIt first, RandomIt last, Compare comp, size_t grain) {
+    size_t count = static_cast<size_t>(last - first);
+    grain = std::max<size_t>(grain, 2);
+    if (count <= grain || workers_.empty()) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // A few chunks per thread balances uneven sort times
+    size_t chunks = std::min<size_t>(chunkCount(count, grain), (threadCount() + 1) * 2);
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t c = 0; c <= chunks; c++) {
+        bounds[c] = count * c / chunks;
+    }
+
+    parallelFor(chunks, 1, [&](size_t begin, size_t end, uint32_t) {
+        for (size_t c = begin; c < end; c++) {
+            std::sort(first + bounds[c], first + bounds[c + 1], comp);
+        }
+    });
+
+    // Merge neighbouring runs until one remains
+    for (size_t width = 1; width < chunks; width *= 2) {
+        size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        parallelFor(pairs, 1, [&](size_t begin, size_t end, uint32_t) {
+            for (size_t p = begin; p < end; p++) {
+                size_t lo = p * 2 * width;
+                size_t mid = std::min(lo + width, chunks);
+                size_t hi = std::min(lo + 2 * width, chunks);
+                if (mid < hi) {
+                    std::inplace_merge(first + bounds[lo], first + bounds[mid],
+                                       first + bounds[hi], comp);
+                }
+            }
+        });
+    }
+}
+
+} // namespace finevk
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/engine/camera.hpp"
+#include "finevk/engine/deferred_disposer.hpp"
+#include "finevk/rendering/descriptors.hpp"
+#include "finevk/rendering/pipeline.hpp"
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandBuffer;
+class Buffer;
+class ParticleSystem;
+
+using ParticleSystemPtr = std::unique_ptr<ParticleSystem>;
+
+/**
+ * @brief Spawn parameters for a burst or a continuous emitter
+ *
+ * Particles start at a random point within radius of position, moving at
+ * velocity plus a random offset up to spread. Color and size blend from
+ * start to end over the particle's life.
+ */
+struct ParticleEmitter {
+    glm::vec3 position{0.0f};
+    float radius = 0.0f;
+    glm::vec3 velocity{0.0f, 1.0f, 0.0f};
+    float spread = 0.5f;
+    glm::vec4 startColor{1.0f};
+    glm::vec4 endColor{1.0f, 1.0f, 1.0f, 0.0f};
+    float lifetime = 2.0f;          ///< Seconds
+    float lifetimeJitter = 0.0f;    ///< Random +/- seconds
+    float startSize = 0.1f;
+    float endSize = 0.1f;
+    float rate = 0.0f;              ///< Particles per second (addEmitter() only)
+};
+
+/**
+ * @brief GPU-resident particle simulation drawn with one indirect call
+ *
+ * Particles live in storage buffers the CPU never touches after build():
+ * particle_update.comp emits into free slots, integrates velocity, gravity
+ * and drag, returns expired slots to a free list and compacts survivors
+ * into the draw list, whose length becomes the instance count of a
+ * VkDrawIndirectCommand. Emitter settings travel as push constants, so a
+ * frame's CPU-to-GPU traffic is a few hundred bytes however many particles
+ * are alive.
+ *
+ * Simulation follows GameLoop's fixed timestep: fixedUpdate() closes a
+ * step (continuous emitters spawn rate * dt particles, queued bursts go
+ * out with it) and record() runs the steps queued since the last frame on
+ * the GPU, at most maxStepsPerFrame() of them (the rest are merged into
+ * the last one). fixedUpdate(), burst() and the emitter methods may be
+ * called from the simulation thread while record() runs on the render
+ * thread.
+ *
+ * With sortShader(), particle_sort.comp orders the draw list back to front
+ * after every frame's steps with the stable 8-bit LSD radix sort of
+ * radixSort(), on view depth keys mapped like sortableFloatBits(), so
+ * alpha-blended particles composite correctly. The sort always runs all
+ * four passes over capacity() keys' worth of blocks.
+ *
+ * Drawing is up to the application: bind particleBuffer() and
+ * drawListBuffer() as storage buffers in the vertex shader and expand
+ * each instance into a camera-facing quad from gl_VertexIndex (no vertex
+ * or index buffers). Instance i draws particles[drawList[i]], laid out as:
+ * @code
+ * struct Particle {
+ *     vec4 position;      // xyz world position, w current size
+ *     vec4 velocity;      // xyz velocity, w age in seconds
+ *     vec4 color;         // Current color
+ *     vec4 startColor;
+ *     vec4 endColor;
+ *     vec4 life;          // x lifetime, y start size, z end size
+ * };
+ * @endcode
+ *
+ * GPU buffers are handed to the disposer when the system is destroyed, so
+ * it may go away while frames using it are still in flight.
+ *
+ * Usage:
+ * @code
+ * auto particles = ParticleSystem::create(device)
+ *     .updateShader(updateShader)           // particle_update.comp.spv
+ *     .sortShader(sortShader)               // particle_sort.comp.spv (optional)
+ *     .maxParticles(65536)
+ *     .build();
+ * uint32_t smoke = particles->addEmitter(smokeSettings);
+ *
+ * void onFixedUpdate(float dt) override {
+ *     particles->fixedUpdate(dt);
+ * }
+ *
+ * // Each frame, outside the render pass
+ * particles->record(cmd, camera.state());
+ *
+ * // In the transparent pass, with the particle pipeline and its set bound
+ * particles->draw(cmd);
+ * @endcode
+ */
+class ParticleSystem {
+public:
+    /**
+     * @brief Builder for creating ParticleSystem objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Compiled particle_update.comp (required)
+        Builder& updateShader(ShaderModule* module);
+        Builder& updateShader(const ShaderModulePtr& module) { return updateShader(module.get()); }
+
+        /// Compiled particle_sort.comp; enables back-to-front sorting
+        Builder& sortShader(ShaderModule* module);
+        Builder& sortShader(const ShaderModulePtr& module) { return sortShader(module.get()); }
+
+        /// Particle capacity; emits beyond it are dropped (default: 65536)
+        Builder& maxParticles(uint32_t count);
+
+        /// Vertex count of each instance in draw() (default: 6, two triangles)
+        Builder& verticesPerParticle(uint32_t count);
+
+        /// Acceleration applied to every particle (default: (0, -9.81, 0))
+        Builder& gravity(const glm::vec3& acceleration);
+
+        /// Fraction of velocity lost per second (default: 0)
+        Builder& drag(float perSecond);
+
+        /// Fixed steps simulated per record() before the rest are merged (default: 4)
+        Builder& maxStepsPerFrame(uint32_t count);
+
+        /// Disposer retiring the GPU buffers on destruction (default: global)
+        Builder& disposer(DeferredDisposer* disposer);
+
+        /// Build the particle system
+        ParticleSystemPtr build();
+
+    private:
+        LogicalDevice* device_;
+        ShaderModule* updateShader_ = nullptr;
+        ShaderModule* sortShader_ = nullptr;
+        uint32_t maxParticles_ = 65536;
+        uint32_t verticesPerParticle_ = 6;
+        glm::vec3 gravity_{0.0f, -9.81f, 0.0f};
+        float drag_ = 0.0f;
+        uint32_t maxStepsPerFrame_ = 4;
+        DeferredDisposer* disposer_ = &DeferredDisposer::global();
+    };
+
+    /// Create a builder for a particle system
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /// Add a continuous emitter (spawns rate particles per second); returns its id
+    uint32_t addEmitter(const ParticleEmitter& emitter);
+
+    /// Replace an emitter's settings (e.g. to follow a moving object)
+    void setEmitter(uint32_t id, const ParticleEmitter& emitter);
+
+    /// Stop an emitter; its particles live out their lifetimes
+    void removeEmitter(uint32_t id);
+
+    /// Spawn count particles with the next fixed step
+    void burst(const ParticleEmitter& emitter, uint32_t count);
+
+    /**
+     * @brief Close a fixed simulation step
+     *
+     * Call from GameLoop::onFixedUpdate(). Only queues the step; record()
+     * simulates it on the GPU.
+     */
+    void fixedUpdate(float dt);
+
+    /**
+     * @brief Simulate the queued steps and sort the draw list
+     *
+     * Must be recorded outside a render pass. Includes the barriers that
+     * order it after the previous frame's draw() and make the results
+     * visible to draw()'s indirect read and the vertex shader. Records
+     * nothing when no step is queued (the last state is drawn again).
+     */
+    void record(CommandBuffer& cmd, const CameraState& camera);
+
+    /// Draw every live particle (one indirect, instanced draw)
+    void draw(CommandBuffer& cmd);
+
+    /// Kill every particle at the next record() (render thread)
+    void clear();
+
+    /// Particle storage buffer for the vertex shader
+    Buffer& particleBuffer() const { return *gpu_->particles; }
+
+    /// Draw-ordered particle indices for the vertex shader
+    Buffer& drawListBuffer() const { return *gpu_->drawList; }
+
+    /// Particle capacity
+    uint32_t capacity() const { return capacity_; }
+
+    /// True if draw() is sorted back to front
+    bool sorted() const { return gpu_->sortPipeline != nullptr; }
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    /// Destructor - retires the GPU buffers through the disposer
+    ~ParticleSystem();
+
+    // Non-copyable
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+private:
+    friend class Builder;
+    ParticleSystem() = default;
+
+    /// Matches Params push constants in particle_update.comp
+    struct UpdateParams {
+        glm::vec4 viewRow;
+        glm::vec4 gravityDrag;
+        glm::vec4 emitPosition;
+        glm::vec4 emitVelocity;
+        glm::vec4 startColor;
+        glm::vec4 endColor;
+        glm::vec4 lifeSize;
+        uint32_t mode;
+        uint32_t count;
+        uint32_t seed;
+        float dt;
+    };
+
+    /// Matches SortParams push constants in particle_sort.comp
+    struct SortParams {
+        uint32_t mode;
+        uint32_t shift;
+        uint32_t blocks;
+    };
+
+    struct Emit {
+        ParticleEmitter emitter;
+        uint32_t count;
+    };
+
+    struct Step {
+        float dt = 0.0f;
+        std::vector<Emit> emits;
+    };
+
+    struct EmitterSlot {
+        ParticleEmitter emitter;
+        float carry = 0.0f;     // Fractional particles owed to the next step
+        bool active = false;
+    };
+
+    /// GPU objects, retired together through the disposer
+    struct Gpu {
+        BufferPtr particles;
+        BufferPtr deadList;
+        BufferPtr aliveLists;
+        BufferPtr counters;
+        BufferPtr drawCommand;
+        BufferPtr sortKeys;
+        BufferPtr drawList;
+        BufferPtr scratchKeys;
+        BufferPtr scratchValues;
+        BufferPtr histogram;
+
+        DescriptorSetLayoutPtr updateLayout;
+        DescriptorSetLayoutPtr sortLayout;
+        DescriptorPoolPtr descriptorPool;
+        PipelineLayoutPtr updatePipelineLayout;
+        PipelineLayoutPtr sortPipelineLayout;
+        ComputePipelinePtr updatePipeline;
+        ComputePipelinePtr sortPipeline;
+        VkDescriptorSet updateSet = VK_NULL_HANDLE;
+        VkDescriptorSet sortSets[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};  // Draw list -> scratch, back
+    };
+
+    void dispatchUpdate(CommandBuffer& cmd, UpdateParams& params, uint32_t mode, uint32_t groups);
+    void recordSort(CommandBuffer& cmd);
+
+    LogicalDevice* device_ = nullptr;
+    DeferredDisposer* disposer_ = nullptr;
+    std::unique_ptr<Gpu> gpu_;
+    uint32_t capacity_ = 0;
+    uint32_t verticesPerParticle_ = 6;
+    glm::vec3 gravity_{0.0f};
+    float drag_ = 0.0f;
+    uint32_t maxStepsPerFrame_ = 4;
+
+    bool needsReset_ = true;
+    uint32_t seed_ = 0;
+
+    // Shared with the simulation thread
+    std::mutex mutex_;
+    std::vector<EmitterSlot> emitters_;
+    std::vector<Emit> bursts_;
+    std::vector<Step> pending_;
+    std::vector<Step> recording_;   // Swapped with pending_ by record()
+};
+
+} // namespace finevk
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief Value tagged with a 32-bit sort key
+ */
+template<typename T>
+struct SortItem {
+    uint32_t key;
+    T value;
+};
+
+/// Map a float onto a uint32 with the same ordering (negative values included)
+inline uint32_t sortableFloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // Negative: flip everything; positive: flip the sign bit
+    return bits ^ ((bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+/**
+ * @brief Stable LSD radix sort on key, ascending, 8 bits per pass
+ *
+ * Linear in items.size(). Passes where every key has the same byte are
+ * skipped, so keys with a narrow range (e.g. depths of one scene) usually
+ * take two or three passes. scratch is reused between calls.
+ */
+template<typename T>
+void radixSort(std::vector<SortItem<T>>& items, std::vector<SortItem<T>>& scratch) {
+    size_t count = items.size();
+    if (count < 2) {
+        return;
+    }
+    scratch.resize(count);
+
+    // All four histograms in one read
+    uint32_t histograms[4][256] = {};
+    for (const auto& item : items) {
+        histograms[0][item.key & 0xFF]++;
+        histograms[1][(item.key >> 8) & 0xFF]++;
+        histograms[2][(item.key >> 16) & 0xFF]++;
+        histograms[3][item.key >> 24]++;
+    }
+
+    SortItem<T>* src = items.data();
+    SortItem<T>* dst = scratch.data();
+    for (uint32_t pass = 0; pass < 4; pass++) {
+        uint32_t* histogram = histograms[pass];
+        uint32_t shift = pass * 8;
+        if (histogram[(src[0].key >> shift) & 0xFF] == count) {
+            continue;  // Every key has this byte
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < 256; bucket++) {
+            uint32_t n = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != items.data()) {
+        items.swap(scratch);
+    }
+}
+
+/**
+ * @brief Insertion sort on key, ascending, giving up after maxMoves element moves
+ *
+ * Fast path for nearly sorted input such as last frame's order. On failure
+ * the items are a permutation of the input (partially sorted).
+ *
+ * @return true if fully sorted
+ */
+template<typename T>
+bool insertionSortBounded(std::vector<SortItem<T>>& items, size_t maxMoves) {
+    size_t moves = 0;
+    for (size_t i = 1; i < items.size(); i++) {
+        if (items[i - 1].key <= items[i].key) {
+            continue;
+        }
+
+        SortItem<T> item = items[i];
+        size_t j = i;
+        while (j > 0 && items[j - 1].key > item.key) {
+            items[j] = items[j - 1];
+            j--;
+            if (++moves > maxMoves) {
+                items[j] = item;
+                return false;
+            }
+        }
+        items[j] = item;
+    }
+    return true;
+}
+
+} // namespace finevk
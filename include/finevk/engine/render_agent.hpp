@@ -5,11 +5,27 @@
 #include "finevk/high/material.hpp"
 #include "finevk/rendering/pipeline.hpp"
 #include "finevk/device/command.hpp"
+#include "finevk/core/thread_pool.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/engine/gpu_culler.hpp"
+#include "finevk/engine/hiz_pyramid.hpp"
+#include "finevk/engine/frustum_cull.hpp"
+#include "finevk/engine/spatial_index.hpp"
+#include "finevk/engine/job_system.hpp"
+#include "finevk/engine/radix_sort.hpp"
+#include <algorithm>
 #include <vector>
+#include <deque>
 #include <memory>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
 
 namespace finevk {
 
+class StaticBatch;
+
 /**
  * @brief Renderable object bundle
  *
@@ -20,10 +36,13 @@ struct Renderable {
     Mesh* mesh = nullptr;
     Material* material = nullptr;
     GraphicsPipeline* pipeline = nullptr;
+    GraphicsPipeline* depthPipeline = nullptr;  // Depth-only variant for RenderAgent::renderDepthPrepass()
     PipelineLayout* pipelineLayout = nullptr;
     glm::mat4 transform = glm::mat4(1.0f);
     AABB localBounds;  // Bounding box in local/model space
     bool isTransparent = false;
+    uint32_t objectId = 0;  // Pushed with the transform (e.g. for picking)
+    uint32_t lod = 0;       // Mesh detail level drawn (chosen by RenderAgent with LOD selection)
 
     /// Compute world-space AABB (applies transform to localBounds)
     AABB worldBounds() const {
@@ -37,13 +56,42 @@ struct Renderable {
     }
 };
 
+/**
+ * @brief Stable reference to a renderable owned by a RenderAgent
+ *
+ * Returned by RenderAgent::add(). Stays valid until the renderable is
+ * removed or the agent is cleared; stale handles are detected by generation
+ * and ignored.
+ */
+struct RenderableHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    /// Check if this handle was ever assigned (does not check staleness)
+    bool valid() const { return index != UINT32_MAX; }
+
+    bool operator==(const RenderableHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const RenderableHandle& other) const { return !(*this == other); }
+};
+
 /**
  * @brief Example rendering system with automatic culling and sorting
  *
  * RenderAgent demonstrates best practices for organizing rendering:
  * - Separates opaque and transparent geometry
- * - Performs frustum culling (optional)
+ * - Updates moved, hidden or removed objects incrementally through handles
+ * - Performs frustum culling (optional, brute force or through a BVH)
+ * - Sorts opaque objects by pipeline/material/mesh and skips redundant binds
+ * - Optionally orders opaque objects front to back or lays down a depth prepass
+ * - Optionally merges identical mesh/material/pipeline runs into instanced draws
+ * - Optionally culls opaque geometry on the GPU with multi-draw indirect
+ * - Optionally culls against a Hi-Z depth pyramid (two-phase on the GPU, readback on the CPU)
+ * - Optionally picks mesh detail levels from projected size
+ * - Draws static scenery merged by StaticBatch as a few clustered meshes
  * - Sorts transparent objects back-to-front
+ * - Optionally spreads culling and sorting over a JobSystem
  * - Provides phase-based rendering (opaque → transparent → UI)
  *
  * **Design Intent**: This is an example pattern, not a mandatory framework.
@@ -91,11 +139,197 @@ public:
         if (frustumCullingEnabled_ != enabled) {
             frustumCullingEnabled_ = enabled;
             needsRecompute_ = true;
+            boundsDirty_ = true;
         }
     }
 
     bool isFrustumCullingEnabled() const { return frustumCullingEnabled_; }
 
+    /// Enable/disable state sorting of opaque geometry (default: enabled)
+    void setStateSortingEnabled(bool enabled) {
+        if (stateSortingEnabled_ != enabled) {
+            stateSortingEnabled_ = enabled;
+            needsRecompute_ = true;
+        }
+    }
+
+    bool isStateSortingEnabled() const { return stateSortingEnabled_; }
+
+    /**
+     * @brief Order opaque geometry roughly front to back (default: disabled)
+     *
+     * Within each pipeline and material bucket of the state sort, objects
+     * are ordered by distance to the camera (to within about 1%) before
+     * mesh, so early depth testing rejects more hidden fragments. Costs some
+     * mesh rebinds and splits instanced batches, and isn't needed after a
+     * depth prepass. Without state sorting the whole list is ordered by
+     * distance. Opaque geometry under GPU culling is unaffected.
+     */
+    void setFrontToBackSorting(bool enabled) {
+        if (frontToBack_ != enabled) {
+            frontToBack_ = enabled;
+            needsRecompute_ = true;
+        }
+    }
+
+    bool isFrontToBackSorting() const { return frontToBack_; }
+
+    /**
+     * @brief Record renderDepthPrepass() ahead of renderOpaque() in render() (default: disabled)
+     *
+     * Both render() overloads draw the prepass in the same render pass,
+     * right before the opaque phase. Ignored under GPU culling.
+     */
+    void setDepthPrepass(bool enabled) { depthPrepass_ = enabled; }
+
+    bool isDepthPrepassEnabled() const { return depthPrepass_; }
+
+    /**
+     * @brief Cull through a dynamic AABB tree instead of testing every object
+     *
+     * The tree rejects and accepts whole clusters of objects at once, which
+     * pays off for large scenes where most objects are off screen. It is
+     * updated incrementally: new renderables are inserted and moved ones
+     * are only reinserted once they leave their enlarged leaf box. Results
+     * are conservative by the tree's margin. Default: disabled (the SIMD
+     * brute-force test is faster for small scenes). Opaque geometry under
+     * GPU culling is unaffected.
+     */
+    void setSpatialIndexEnabled(bool enabled);
+
+    bool isSpatialIndexEnabled() const { return spatialIndexEnabled_; }
+
+    /// The spatial index (populated while enabled)
+    const AABBTree& spatialIndex() const { return spatialIndex_; }
+
+    /**
+     * @brief Run culling and sorting on a job system
+     *
+     * Brute-force culling is split into chunks of grain renderables (rounded
+     * up to a multiple of 64); each chunk fills its own visible lists, which
+     * are concatenated in chunk order, so the result matches the serial
+     * path. Opaque state sorting uses JobSystem::parallelSort(), transparent
+     * depth keys are computed in parallel. Scenes under 2 * grain stay serial.
+     * nullptr (default) keeps everything on the calling thread.
+     */
+    void setJobSystem(JobSystem* jobs, size_t grain = 4096) {
+        jobs_ = jobs;
+        parallelGrain_ = std::max<size_t>((grain + 63) / 64 * 64, 64);
+    }
+
+    JobSystem* jobSystem() const { return jobs_; }
+
+    /**
+     * @brief Pick a mesh detail level per renderable from its screen size
+     *
+     * Visible renderables whose mesh has LODs (Mesh::Builder::generateLods())
+     * draw the coarsest level whose error, projected with the bounds' size
+     * on screen, stays under maxError (fraction of the screen height; 0.001
+     * is about one pixel at 1080p). A level only changes once the error
+     * crosses maxError by the hysteresis fraction, so objects near a
+     * threshold don't pop back and forth. Re-evaluated after updateCamera().
+     * Disabling resets every renderable to level 0.
+     */
+    void setLodSelection(bool enabled, float maxError = 0.001f, float hysteresis = 0.25f);
+
+    bool isLodSelectionEnabled() const { return lodSelection_; }
+
+    /// Minimum renderables per secondary command buffer in parallel rendering (default: 64)
+    void setParallelBatchSize(size_t size) { parallelBatchSize_ = size ? size : 1; }
+
+    size_t parallelBatchSize() const { return parallelBatchSize_; }
+
+    /**
+     * @brief Enable automatic instancing
+     *
+     * Consecutive visible renderables with the same mesh, material, pipeline
+     * and layout are drawn with one instanced draw. Every renderable's
+     * transform is written to a per-frame instance buffer bound at the given
+     * vertex binding, so all pipelines used with this agent must declare it
+     * (see addInstanceAttributes()). Call beginFrame() every frame.
+     * framesInFlight 0 uses LogicalDevice::maxFramesInFlight().
+     */
+    void enableInstancing(LogicalDevice* device, uint32_t framesInFlight, uint32_t binding = 1);
+    void enableInstancing(const LogicalDevicePtr& device, uint32_t framesInFlight, uint32_t binding = 1) {
+        enableInstancing(device.get(), framesInFlight, binding);
+    }
+
+    /// Disable automatic instancing and release the instance buffers
+    void disableInstancing();
+
+    bool isInstancingEnabled() const { return instanceDevice_ != nullptr; }
+
+    /**
+     * @brief Declare the per-instance transform on a pipeline
+     *
+     * Adds an instance-rate binding with a mat4 (64 bytes) at binding,
+     * read by the vertex shader as four vec4 attributes starting at
+     * firstLocation.
+     */
+    static void addInstanceAttributes(GraphicsPipeline::Builder& builder,
+                                      uint32_t binding = 1, uint32_t firstLocation = 4);
+
+    /**
+     * @brief Draw through a bindless table
+     *
+     * The table's set is bound at setIndex whenever a renderable's pipeline
+     * layout changes. Materials registered with the table
+     * (Material::registerBindless()) are not bound per draw; their index is
+     * pushed as ObjectPushConstants::materialIndex instead. Pass nullptr to
+     * go back to per-material descriptor sets.
+     */
+    void setBindlessTable(BindlessTable* table, uint32_t setIndex = 0) {
+        bindless_ = table;
+        bindlessSet_ = setIndex;
+    }
+
+    BindlessTable* bindlessTable() const { return bindless_; }
+
+    /**
+     * @brief Cull and draw opaque geometry on the GPU
+     *
+     * Opaque renderables are handed to the culler whenever the scene is
+     * dirty; frustum culling runs in recordCulling() and renderOpaque()
+     * issues the indirect draws. Transparent geometry stays on the CPU path
+     * (it needs sorting). opaqueCount() then reports all opaque renderables.
+     */
+    void enableGpuCulling(std::unique_ptr<GpuCuller> culler);
+
+    /// Return to CPU culling of opaque geometry
+    void disableGpuCulling();
+
+    bool isGpuCullingEnabled() const { return gpuCuller_ != nullptr; }
+    GpuCuller* gpuCuller() const { return gpuCuller_.get(); }
+
+    /**
+     * @brief Record the GPU culling dispatch (GPU culling only)
+     *
+     * Record outside the render pass, before renderOpaque()/render(), after
+     * updateCamera() and once the frame's fence has signaled.
+     */
+    void recordCulling(CommandBuffer& cmd, uint32_t frameIndex);
+
+    /**
+     * @brief Record the second occlusion culling phase (GPU culling with occlusion())
+     *
+     * Record outside the render pass, after renderOpaque() and
+     * HiZPyramid::record(); renderOpaqueLate() then draws what it found.
+     */
+    void recordLateCulling(CommandBuffer& cmd);
+
+    /**
+     * @brief Cull CPU-path geometry against a Hi-Z pyramid readback
+     *
+     * Objects culled on the CPU are also dropped when
+     * HiZPyramid::isOccluded() reports them hidden (single camera only; with
+     * several views only frustum culling runs). The pyramid needs
+     * readback(); visibility is recomputed whenever a new readback arrives.
+     * Pass nullptr to disable. Not owned.
+     */
+    void setOcclusionCulling(const HiZPyramid* pyramid);
+
+    const HiZPyramid* occlusionCulling() const { return occlusion_; }
+
     // =========================================================================
     // Geometry Management
     // =========================================================================
@@ -105,20 +339,66 @@ public:
      *
      * The Renderable is copied into internal storage. Mesh and Material
      * are non-owning pointers - caller must ensure they remain valid.
+     *
+     * @return Handle for later setTransform()/setVisible()/remove() calls
+     */
+    RenderableHandle add(const Renderable& renderable);
+
+    /**
+     * @brief Add every cluster of a StaticBatch
+     *
+     * Each cluster is an ordinary renderable (culled, sorted and instanced
+     * like any other), so static scenery costs a draw per cluster instead of
+     * per object. The batch must outlive the handles.
+     */
+    std::vector<RenderableHandle> addBatch(const StaticBatch& batch);
+
+    /**
+     * @brief Remove a renderable
+     *
+     * Only the renderable's own list entry and spatial index leaf are
+     * touched. Its slot (and index) is reused by a later add().
+     */
+    void remove(RenderableHandle handle);
+
+    /**
+     * @brief Move a renderable
+     *
+     * Updates its cached bounds and re-tests it against the current frustum
+     * without re-culling the rest of the scene.
      */
-    void add(const Renderable& renderable);
+    void setTransform(RenderableHandle handle, const glm::mat4& transform);
+
+    /// Show or hide a renderable without removing it
+    void setVisible(RenderableHandle handle, bool visible);
+
+    /// Check if a renderable is shown (false for stale handles)
+    bool isVisible(RenderableHandle handle) const;
+
+    /// Check if a handle still refers to a live renderable
+    bool contains(RenderableHandle handle) const;
+
+    /// Get a live renderable (nullptr for stale handles)
+    const Renderable* find(RenderableHandle handle) const;
 
     /**
      * @brief Remove all renderables
+     *
+     * Invalidates every handle.
      */
     void clear();
 
     /**
      * @brief Mark dirty (forces recompute on next render)
      *
-     * Call when world geometry changes (objects added/removed/moved).
+     * Call when something not covered by the handle API changes, e.g. a
+     * mesh's bounds. Moves should go through setTransform() instead.
      */
-    void markDirty() { needsRecompute_ = true; }
+    void markDirty() {
+        needsRecompute_ = true;
+        sceneDirty_ = true;
+        boundsDirty_ = true;
+    }
 
     // =========================================================================
     // Camera Update
@@ -127,25 +407,88 @@ public:
     /**
      * @brief Update camera state
      *
-     * Stores reference to camera state and triggers transparent object
-     * resorting if camera position changed significantly.
+     * Stores reference to camera state. A state from Camera carries a
+     * version: culling, sorting and LOD selection rerun when it changed
+     * (moves, turns and projection changes alike) and are kept otherwise.
+     * A hand-built state (version 0) triggers transparent object resorting
+     * if camera position changed significantly.
      *
      * Call before rendering each frame.
      */
     void updateCamera(const CameraState& cameraState);
 
+    /**
+     * @brief Cull once for several views drawn in one multiview pass
+     *
+     * Renderables visible in any view are listed and drawn once; shaders
+     * pick the view with gl_ViewIndex (see RenderTarget::Builder::multiview()),
+     * so recording costs about the same as for one view. viewMask() tells
+     * which views each renderable reaches. Brute-force culling tests every
+     * view per block of bounds in a single traversal; the spatial index is
+     * queried once per view. The views are copied; the first one drives
+     * transparent sorting and LOD selection. GPU culling still tests only
+     * the first view, so leave it off for multiview passes. updateCamera()
+     * goes back to a single view.
+     *
+     * @throws std::invalid_argument for no views or more than BoundsSoA::MaxViews
+     */
+    void updateViews(const std::vector<CameraState>& views);
+
+    /// Views culled per frame (1 after updateCamera())
+    uint32_t viewCount() const { return views_.empty() ? 1u : static_cast<uint32_t>(views_.size()); }
+
+    /// Views a renderable is visible in (bit v = view v; 0 if culled, hidden or stale)
+    uint32_t viewMask(RenderableHandle handle) const;
+
+    /// Number of listed renderables visible in one view
+    size_t visibleInView(uint32_t view) const;
+
+    /**
+     * @brief Select the frame-in-flight slot for instance data
+     *
+     * Only needed with instancing. Call after the frame's fence has signaled,
+     * before any render call of that frame.
+     */
+    void beginFrame(uint32_t frameIndex);
+
     // =========================================================================
     // Rendering Phases
     // =========================================================================
 
+    /**
+     * @brief Render opaque depth only
+     *
+     * Draws every visible opaque renderable that has a depthPipeline with
+     * that pipeline instead of its own; material, push constants and
+     * instancing are as in renderOpaque(). A depth pipeline shares the
+     * renderable's layout, vertex input and vertex shader (or declares
+     * gl_Position invariant) and writes depth only, so main pipelines set up
+     * with configureForDepthPrepass() shade each pixel once. Renderables
+     * without a depthPipeline are skipped and need a depth-writing main
+     * pipeline. Does nothing under GPU culling.
+     */
+    void renderDepthPrepass(CommandBuffer& cmd);
+
+    /**
+     * @brief Depth state for a main pipeline drawn after renderDepthPrepass()
+     *
+     * Depth test with VK_COMPARE_OP_EQUAL and depth writes off: only the
+     * fragments that won the prepass are shaded.
+     */
+    static void configureForDepthPrepass(GraphicsPipeline::Builder& builder);
+
     /**
      * @brief Render opaque geometry
      *
-     * Renders all non-transparent objects that pass frustum culling.
-     * Order is arbitrary (no sorting needed for opaque).
+     * Renders all non-transparent objects that pass frustum culling,
+     * ordered by state key so pipeline, material and mesh binds are only
+     * issued when they change.
      */
     void renderOpaque(CommandBuffer& cmd);
 
+    /// Draw opaque geometry found by recordLateCulling() (GPU occlusion culling only)
+    void renderOpaqueLate(CommandBuffer& cmd);
+
     /**
      * @brief Render transparent geometry
      *
@@ -166,56 +509,303 @@ public:
      * @brief Render all phases in order
      *
      * Convenience method that calls:
-     * 1. renderOpaque(cmd)
-     * 2. renderTransparent(cmd)
-     * 3. renderUI(cmd)
+     * 1. renderDepthPrepass(cmd) (with setDepthPrepass())
+     * 2. renderOpaque(cmd)
+     * 3. renderTransparent(cmd)
+     * 4. renderUI(cmd)
+     *
+     * Each phase is a GPU profiler scope ("depth prepass", "opaque",
+     * "transparent", "ui") when cmd has a GpuProfiler attached.
      */
     void render(CommandBuffer& cmd);
 
+    /**
+     * @brief Render all phases, recording draws on worker threads
+     *
+     * Splits visible renderables into contiguous chunks, records each chunk
+     * into a secondary command buffer from pools (thread slot = chunk index),
+     * then executes them from the primary in order, so transparent sorting
+     * is preserved. renderUI() is recorded into a secondary on the calling
+     * thread.
+     *
+     * The primary must be inside a render pass begun with
+     * VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS, with viewport and scissor
+     * already set (they are replayed into each secondary). pools.beginFrame()
+     * must have been called for the current frame.
+     *
+     * Phases are not profiled here: a primary in a secondary-contents subpass
+     * can't write timestamps, so profile around the whole render pass instead.
+     */
+    void render(CommandBuffer& primary, FrameCommandPools& pools,
+                ThreadPool& threads = ThreadPool::global());
+
     // =========================================================================
     // Statistics
     // =========================================================================
 
-    size_t totalObjects() const { return renderables_.size(); }
+    size_t totalObjects() const { return renderables_.size() - freeSlots_.size(); }
     size_t visibleObjects() const { return opaqueVisible_.size() + transparentSorted_.size(); }
     size_t culledObjects() const { return totalObjects() - visibleObjects(); }
     size_t opaqueCount() const { return opaqueVisible_.size(); }
     size_t transparentCount() const { return transparentSorted_.size(); }
 
+    /// Draw calls issued for visible geometry (fewer than visibleObjects() when instancing)
+    size_t drawCount() const {
+        return isInstancingEnabled() ? opaqueBatches_.size() + transparentBatches_.size()
+                                     : visibleObjects();
+    }
+
 protected:
     /**
      * @brief Perform culling and sorting
      *
-     * Called automatically before rendering if needsRecompute_ is true.
-     * - Frustum culls all objects (if enabled)
+     * Called through ensureCurrent() before rendering if needsRecompute_ is true.
+     * - Frustum culls all objects (if enabled) with the SIMD BoundsSoA kernel,
+     *   or queries the AABB tree when the spatial index is enabled
      * - Separates opaque and transparent
-     * - Sorts transparent back-to-front
+     * - Sorts opaque by state key
+     * - Flags transparent for back-to-front sorting
      */
     void cullAndSort();
 
+    /**
+     * @brief Bring lists up to date before drawing
+     *
+     * Runs cullAndSort() when a full recompute is pending; otherwise only
+     * applies what incremental updates left behind (transparent order,
+     * instancing batches, GPU culler scene).
+     */
+    void ensureCurrent();
+
+    /**
+     * @brief State last bound into a command buffer
+     *
+     * Used to skip redundant binds between consecutive renderables. Start
+     * with a fresh BindState for every command buffer.
+     */
+    struct BindState {
+        const GraphicsPipeline* pipeline = nullptr;
+        const Material* material = nullptr;
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        const Mesh* mesh = nullptr;
+        bool instancesBound = false;
+        bool depthOnly = false;  // Draw with depthPipeline (skipping renderables without one)
+    };
+
+    /**
+     * @brief Run of consecutive renderables drawn as one instanced draw
+     *
+     * Covers list[first, first + count); the instance data is at the same
+     * positions in the frame's instance buffer (offset by instanceBase).
+     */
+    struct DrawBatch {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
     /**
      * @brief Render a single renderable
      *
-     * Helper method for rendering. Binds material, pushes transform,
-     * and issues draw call.
+     * Helper method for rendering. Binds material, pushes transform and
+     * objectId as ObjectPushConstants if the layout declares them, and
+     * issues draw call.
      */
     void renderOne(CommandBuffer& cmd, const Renderable& renderable);
 
+    /// Render a single renderable, binding only state that differs from state
+    void renderOne(CommandBuffer& cmd, const Renderable& renderable, BindState& state);
+
+    /**
+     * @brief 64-bit sort key: pipeline (bits 63-42), material (41-21), mesh (20-0)
+     *
+     * Components are dense IDs assigned per cull, so equal state yields
+     * adjacent keys regardless of pointer values.
+     */
+    uint64_t stateKey(const Renderable& renderable);
+
+    /// Bind only the state that differs; returns false if the renderable can't be drawn
+    bool bindState(CommandBuffer& cmd, const Renderable& renderable, BindState& state);
+
+    /// Push transform, objectId and bindless material index if the layout declares ObjectPushConstants
+    static void pushObject(CommandBuffer& cmd, const Renderable& renderable);
+
+    /// Draw batches[begin, end) of list, fetching instances from instanceBase onward
+    void drawBatches(CommandBuffer& cmd, const std::vector<const Renderable*>& list,
+                     const std::vector<DrawBatch>& batches, size_t begin, size_t end,
+                     uint32_t instanceBase, BindState& state);
+
+    /// Group consecutive renderables with identical state into batches
+    static void buildBatches(const std::vector<const Renderable*>& list,
+                             std::vector<DrawBatch>& out);
+
+    /// Bring the AABB tree up to date with renderables_ (insert new, move changed)
+    void updateSpatialIndex();
+
+    /// True when CPU culling goes through the AABB tree
+    bool usesSpatialIndex() const {
+        return spatialIndexEnabled_ && frustumCullingEnabled_ && !gpuCuller_;
+    }
+
+    /// Resolve a handle to a live slot index (UINT32_MAX if stale)
+    uint32_t slotOf(RenderableHandle handle) const;
+
+    /// Refresh a slot's cached bounds (SoA entry or tree leaf)
+    void updateBounds(uint32_t slot);
+
+    /// Whether a slot belongs in the visible lists right now (also records its views)
+    bool passesCull(uint32_t slot);
+
+    /// True if CPU occlusion culling hides a slot
+    bool isOccluded(uint32_t slot) const;
+
+    /// Mask with a bit for every view culled
+    uint32_t allViews() const {
+        return viewCount() >= 32 ? ~0u : (1u << viewCount()) - 1;
+    }
+
+    /// Key opaque lists are ordered by (state key, or slot index when unsorted;
+    /// camera distance included with front-to-back sorting)
+    uint64_t listKey(uint32_t slot);
+
+    /// Insert a slot into / remove it from the visible lists
+    void listSlot(uint32_t slot);
+    void unlistSlot(uint32_t slot);
+
+    /**
+     * @brief Sort transparent back-to-front
+     *
+     * Keys are computed once per object: squared camera distance (same order
+     * as view-space distance, no sqrt) as quantized float bits. Last order is
+     * kept, so a bounded insertion sort usually finishes; otherwise a radix
+     * sort runs in linear time.
+     */
+    void sortTransparent();
+
+    /// True when a pass over count items should go through the job system
+    bool runsParallel(size_t count) const { return jobs_ && count >= parallelGrain_ * 2; }
+
+    /// Brute-force cull every slot into the visible lists (serial or per chunk)
+    void cullBruteForce();
+
+    /// Update Renderable::lod of listed renderables from the camera
+    void selectLods();
+
+    /// Detail level for a mesh at a projected bounding radius, starting from current
+    uint32_t chooseLod(const Mesh& mesh, uint32_t current, float projectedSize) const;
+
+    /// Append a slot to the end of its visible list (full pass only; keeps keys unsorted)
+    void appendSlot(uint32_t slot);
+
+    /// Write this frame's instance transforms (once per frame)
+    void prepareInstances();
+
+    /// Record count items into secondaries in parallel and append them to out (in order)
+    void recordParallel(size_t count,
+                        const std::function<void(CommandBuffer&, size_t, size_t)>& record,
+                        const CommandBuffer& primary, FrameCommandPools& pools,
+                        ThreadPool& threads, std::vector<VkCommandBuffer>& out);
+
 private:
-    // All renderables
-    std::vector<Renderable> renderables_;
+    enum class Listing : uint8_t { None, Opaque, Transparent };
 
-    // Culled and sorted views (pointers into renderables_)
+    /// Bookkeeping per renderable slot (parallel to renderables_)
+    struct Slot {
+        uint32_t generation = 0;
+        int32_t proxy = AABBTree::NullNode;  // Leaf in spatialIndex_
+        Listing listing = Listing::None;     // Which visible list holds it
+        uint32_t views = 0;                  // Views it is visible in while listed
+        uint64_t key = 0;                    // Its opaqueKeys_ entry while listed opaque
+        bool alive = true;
+        bool visible = true;
+    };
+
+    // All renderables (deque: references stay valid as it grows)
+    std::deque<Renderable> renderables_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> freeSlots_;
+    uint32_t generationBase_ = 0;  // First generation for new slots (bumped by clear)
+
+    // Culled and sorted views (pointers into renderables_); opaqueKeys_
+    // holds listKey() of each opaque entry, ascending
     std::vector<const Renderable*> opaqueVisible_;
+    std::vector<uint64_t> opaqueKeys_;
     std::vector<const Renderable*> transparentSorted_;
+    bool transparentDirty_ = false;
+    bool batchesDirty_ = false;
+
+    // Parallel culling: per-chunk visible slots, merged in chunk order
+    struct ChunkLists {
+        std::vector<uint32_t> opaque;
+        std::vector<uint32_t> transparent;
+    };
+    JobSystem* jobs_ = nullptr;
+    size_t parallelGrain_ = 4096;
+    std::vector<ChunkLists> chunkLists_;
+    std::vector<SortItem<const Renderable*>> transparentKeys_;
+    std::vector<SortItem<const Renderable*>> transparentScratch_;
+    std::vector<std::pair<uint64_t, const Renderable*>> sortScratch_;  // Opaque state sort
+
+    // Secondaries of the last parallel render (kept so recording doesn't allocate)
+    std::vector<VkCommandBuffer> secondaries_;
 
     // Camera state reference
     const CameraState* cameraState_ = nullptr;
     glm::vec3 lastCameraPos_{0.0f};
+    uint64_t cameraVersion_ = 0;  // CameraState::version last culled for
+
+    // Multiview culling (empty for a single camera); cameraState_ points at views_[0]
+    std::vector<CameraState> views_;
+    std::vector<std::array<glm::vec4, 6>> viewPlanes_;
+    std::vector<uint32_t> viewBits_;  // Per-slot view masks from the brute-force pass
+
+    // Cached world bounds (rebuilt only when geometry changes) and cull result
+    BoundsSoA worldBounds_;
+    std::vector<uint64_t> visibleMask_;
+    bool boundsDirty_ = true;
+
+    // Optional BVH (leaf user data = slot index) and its query result
+    AABBTree spatialIndex_;
+    std::vector<uint32_t> visibleIndices_;
+    bool spatialIndexEnabled_ = false;
+
+    // Dense IDs for state sort keys (reset by cullAndSort, extended by incremental adds)
+    std::unordered_map<const void*, uint32_t> stateIds_;
 
     // Flags
     bool frustumCullingEnabled_ = true;
+    bool stateSortingEnabled_ = true;
+    bool frontToBack_ = false;
+    bool depthPrepass_ = false;
     bool needsRecompute_ = true;
+
+    // LOD selection
+    bool lodSelection_ = false;
+    bool lodsDirty_ = false;
+    float lodMaxError_ = 0.001f;
+    float lodHysteresis_ = 0.25f;
+
+    size_t parallelBatchSize_ = 64;
+
+    // Bindless table bound once per layout change (not owned)
+    BindlessTable* bindless_ = nullptr;
+    uint32_t bindlessSet_ = 0;
+
+    // Instancing (enabled when instanceDevice_ is set)
+    LogicalDevice* instanceDevice_ = nullptr;
+    uint32_t instanceBinding_ = 1;
+    std::vector<BufferPtr> instanceBuffers_;  // One per frame in flight
+    uint32_t frameIndex_ = 0;
+    bool instancesPrepared_ = false;
+    std::vector<DrawBatch> opaqueBatches_;
+    std::vector<DrawBatch> transparentBatches_;
+
+    // GPU culling (opaque only)
+    std::unique_ptr<GpuCuller> gpuCuller_;
+    bool sceneDirty_ = true;  // Geometry changed since the culler's last setScene()
+
+    // CPU occlusion culling (not owned) and the readback last culled against
+    const HiZPyramid* occlusion_ = nullptr;
+    uint64_t occlusionVersion_ = 0;
 };
 
 } // namespace finevk
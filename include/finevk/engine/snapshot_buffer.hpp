@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace finevk {
+
+/**
+ * @brief Lock-free handoff of simulation state to the render thread
+ *
+ * One producer (the simulation thread) and one consumer (the render thread)
+ * share four copies of T: the producer writes one, the consumer holds the
+ * two newest it has taken (previous and current, for interpolation), and
+ * the fourth sits in a shared slot swapped with a single atomic exchange.
+ * Neither side ever waits; if the simulation publishes twice between two
+ * updates, the older snapshot is skipped.
+ *
+ * T is everything rendering needs from the simulation (transforms, camera,
+ * animation state) and nothing else; it's copied into write() each tick,
+ * so keep it a plain value type.
+ *
+ * Usage:
+ * @code
+ * SnapshotBuffer<WorldState> snapshots;
+ *
+ * // Simulation thread (GameLoop::onFixedUpdate in threaded mode)
+ * snapshots.write() = world.state();
+ * snapshots.publish(tick);
+ *
+ * // Render thread (GameLoop::onRender)
+ * snapshots.update();
+ * draw(lerp(snapshots.previous(), snapshots.current(), interpolation));
+ * @endcode
+ */
+template<typename T>
+class SnapshotBuffer {
+public:
+    SnapshotBuffer() = default;
+
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    // =========================================================================
+    // Producer (simulation thread)
+    // =========================================================================
+
+    /// Snapshot being written; holds an older snapshot's contents, so overwrite fully
+    T& write() { return slots_[writeIndex_].value; }
+
+    /// Hand the written snapshot to the consumer and start a new one
+    void publish(uint64_t tick = 0) {
+        slots_[writeIndex_].tick = tick;
+        uint8_t old = shared_.exchange(static_cast<uint8_t>(writeIndex_ | kFresh),
+                                       std::memory_order_acq_rel);
+        writeIndex_ = old & kIndexMask;
+    }
+
+    // =========================================================================
+    // Consumer (render thread)
+    // =========================================================================
+
+    /**
+     * @brief Take the newest published snapshot, if any
+     *
+     * The old current() becomes previous(). Returns false (and changes
+     * nothing) if nothing was published since the last update.
+     */
+    bool update() {
+        if (!(shared_.load(std::memory_order_relaxed) & kFresh)) {
+            return false;
+        }
+        uint8_t old = shared_.exchange(previousIndex_, std::memory_order_acq_rel);
+        previousIndex_ = currentIndex_;
+        currentIndex_ = old & kIndexMask;
+        return true;
+    }
+
+    /// Newest snapshot taken by update() (default-constructed before the first)
+    const T& current() const { return slots_[currentIndex_].value; }
+
+    /// Snapshot taken by the update() before that
+    const T& previous() const { return slots_[previousIndex_].value; }
+
+    /// Tick passed to publish() for current() and previous()
+    uint64_t currentTick() const { return slots_[currentIndex_].tick; }
+    uint64_t previousTick() const { return slots_[previousIndex_].tick; }
+
+private:
+    struct Slot {
+        T value{};
+        uint64_t tick = 0;
+    };
+
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;  // Shared slot holds an unread snapshot
+
+    Slot slots_[4];
+    uint8_t writeIndex_ = 3;                // Producer only
+    uint8_t previousIndex_ = 0;             // Consumer only
+    uint8_t currentIndex_ = 1;              // Consumer only
+    std::atomic<uint8_t> shared_{2};
+};
+
+} // namespace finevk
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "finevk/engine/camera.hpp"
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief Dynamic AABB tree for hierarchical frustum culling
+ *
+ * Bounding volume hierarchy with incremental insert, remove and move, in
+ * the style of Box2D's dynamic tree. Leaves store "fat" boxes (enlarged by
+ * a margin) so small movements don't restructure the tree. Each leaf
+ * carries a user value, typically an index into the caller's objects.
+ *
+ * Frustum queries reject whole subtrees outside any plane and accept whole
+ * subtrees fully inside without testing their leaves.
+ *
+ * Usage:
+ * @code
+ * AABBTree tree;
+ * int32_t proxy = tree.insert(object.worldBounds(), objectIndex);
+ * tree.move(proxy, newBounds);   // When the object moves
+ *
+ * tree.queryFrustum(camera.frustumPlanes, [&](uint32_t index) {
+ *     visible.push_back(index);
+ * });
+ * @endcode
+ */
+class AABBTree {
+public:
+    static constexpr int32_t NullNode = -1;
+
+    /// Create a tree (margin enlarges leaf boxes to absorb small moves)
+    explicit AABBTree(float margin = 0.1f) : margin_(margin) {}
+
+    /// Insert a box; returns a proxy id that stays valid until remove()
+    int32_t insert(const AABB& bounds, uint32_t userData);
+
+    /// Remove a proxy
+    void remove(int32_t proxy);
+
+    /**
+     * @brief Update a proxy's bounds
+     * @return true if the leaf was reinserted (bounds left its fat box)
+     */
+    bool move(int32_t proxy, const AABB& bounds);
+
+    /// User value of a proxy
+    uint32_t userData(int32_t proxy) const { return nodes_[proxy].userData; }
+
+    /// Fat bounds stored for a proxy
+    const AABB& fatBounds(int32_t proxy) const { return nodes_[proxy].bounds; }
+
+    /// Remove everything
+    void clear();
+
+    /// Number of proxies
+    uint32_t size() const { return leafCount_; }
+
+    /// Height of the tree (0 when empty or a single leaf)
+    int32_t height() const { return root_ == NullNode ? 0 : nodes_[root_].height; }
+
+    /**
+     * @brief Visit the user value of every leaf that intersects the frustum
+     *
+     * Same plane convention as AABB::intersectsFrustum. Leaves are tested with
+     * their fat boxes, so results are conservative by up to margin.
+     */
+    template<typename Visitor>
+    void queryFrustum(const std::array<glm::vec4, 6>& planes, Visitor&& visit) const;
+
+    /// Visit every leaf's user value in a subtree
+    template<typename Visitor>
+    void visitAll(int32_t node, Visitor&& visit) const;
+
+private:
+    struct Node {
+        AABB bounds;
+        int32_t parent = NullNode;  // Next free node while on the free list
+        int32_t child1 = NullNode;
+        int32_t child2 = NullNode;
+        int32_t height = -1;        // -1 = free, 0 = leaf
+        uint32_t userData = 0;
+
+        bool isLeaf() const { return child1 == NullNode; }
+    };
+
+    enum class Containment { Outside, Intersects, Inside };
+
+    static Containment classify(const AABB& box, const std::array<glm::vec4, 6>& planes);
+
+    int32_t allocateNode();
+    void freeNode(int32_t node);
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    int32_t balance(int32_t node);
+
+    std::vector<Node> nodes_;
+    int32_t root_ = NullNode;
+    int32_t freeList_ = NullNode;
+    uint32_t leafCount_ = 0;
+    float margin_;
+    mutable std::vector<int32_t> stack_;  // Traversal scratch
+};
+
+template<typename Visitor>
+void AABBTree::visitAll(int32_t node, Visitor&& visit) const {
+    size_t base = stack_.size();
+    stack_.push_back(node);
+    while (stack_.size() > base) {
+        int32_t n = stack_.back();
+        stack_.pop_back();
+        const Node& current = nodes_[n];
+        if (current.isLeaf()) {
+            visit(current.userData);
+        } else {
+            stack_.push_back(current.child1);
+            stack_.push_back(current.child2);
+        }
+    }
+}
+
+template<typename Visitor>
+void AABBTree::queryFrustum(const std::array<glm::vec4, 6>& planes, Visitor&& visit) const {
+    if (root_ == NullNode) {
+        return;
+    }
+
+    stack_.clear();
+    stack_.push_back(root_);
+    while (!stack_.empty()) {
+        int32_t n = stack_.back();
+        stack_.pop_back();
+        const Node& node = nodes_[n];
+
+        Containment c = classify(node.bounds, planes);
+        if (c == Containment::Outside) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            visit(node.userData);
+        } else if (c == Containment::Inside) {
+            visitAll(n, visit);
+        } else {
+            stack_.push_back(node.child1);
+            stack_.push_back(node.child2);
+        }
+    }
+}
+
+} // namespace finevk
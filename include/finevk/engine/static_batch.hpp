@@ -0,0 +1,152 @@
+#pragma once
+
+#include "finevk/engine/render_agent.hpp"
+#include "finevk/high/mesh.hpp"
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandPool;
+class UploadManager;
+class StaticBatch;
+
+using StaticBatchPtr = std::unique_ptr<StaticBatch>;
+
+/**
+ * @brief Static scenery merged into a few large pre-transformed meshes
+ *
+ * Level geometry made of thousands of small props that never move costs a
+ * draw (and a bind check, push constant and cull test) per prop. A
+ * StaticBatch bakes each source's transform into its vertices and merges
+ * sources with the same pipeline, depth pipeline, layout, material and
+ * vertex attributes. Merged geometry is split into clusters on a world
+ * grid (a source goes to the cell holding its bounds' center), so frustum
+ * and occlusion culling still reject off-screen parts of the level; each
+ * cluster becomes one Renderable with an identity transform and the
+ * cluster's world bounds. All cluster meshes share one vertex and index
+ * buffer (MeshBatch::sharedBuffers()) and are uploaded in one submission.
+ *
+ * Sources are CPU geometry: Mesh::Builder filled through Mesh::create(),
+ * or one from Mesh::load() (parsed once per builder at build()). The same
+ * builder may be added many times with different transforms. Merged draws
+ * push no per-prop objectId (clusters use 0), and meshes get no detail
+ * levels; keep props that need either as regular renderables. Geometry
+ * must be triangle lists. Transparent sources are rejected, since merged
+ * triangles can't be sorted back to front.
+ *
+ * Usage:
+ * @code
+ * auto rock = Mesh::load(device, pool, "models/rock.obj");
+ * auto statics = StaticBatch::create(device)
+ *     .clusterSize(32.0f)
+ *     .add(rock, rockRenderable)          // Renderable supplies state and transform
+ *     .add(rock, otherRockRenderable)
+ *     .build(pool);
+ * auto handles = renderAgent.addBatch(*statics);  // The batch owns the meshes
+ * @endcode
+ */
+class StaticBatch {
+public:
+    /**
+     * @brief Builder for creating StaticBatch objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Edge length of the world grid cells clusters are split by (default: 32)
+        Builder& clusterSize(float size);
+
+        /**
+         * @brief Vertices per cluster before a cell starts another one (default: 65535)
+         *
+         * The default keeps clusters on 16-bit indices. A single source above
+         * the limit still gets a cluster of its own.
+         */
+        Builder& maxClusterVertices(uint32_t count);
+
+        /// Run Mesh::Builder::optimize() on every cluster (default: false)
+        Builder& optimize(bool enable = true);
+
+        /**
+         * @brief Add a static object
+         *
+         * Vertices come from geometry (which must stay alive until build());
+         * state supplies the transform and the pipeline, depth pipeline,
+         * layout and material it is drawn with. Its mesh, localBounds, lod
+         * and objectId are not used.
+         *
+         * @throws std::invalid_argument if state is transparent or has no pipeline
+         */
+        Builder& add(const Mesh::Builder& geometry, const Renderable& state);
+
+        /// Objects added so far
+        size_t sourceCount() const { return sources_.size(); }
+
+        /// Merge, then upload with one immediate submission
+        StaticBatchPtr build(CommandPool* commandPool);
+        StaticBatchPtr build(CommandPool& commandPool) { return build(&commandPool); }
+
+        /**
+         * @brief Merge, then queue the uploads on an UploadManager
+         *
+         * The uploads are flushed before this returns; wait for ticket()
+         * before drawing.
+         */
+        StaticBatchPtr build(UploadManager& uploads);
+
+    private:
+        struct Source {
+            const Mesh::Builder* geometry;
+            Renderable state;
+        };
+
+        /// Merge the sources into cluster builders (one per output Renderable)
+        StaticBatchPtr merge(std::vector<Mesh::Builder>& clusters) const;
+
+        LogicalDevice* device_;
+        float clusterSize_ = 32.0f;
+        uint32_t maxClusterVertices_ = 65535;
+        bool optimize_ = false;
+        std::vector<Source> sources_;
+    };
+
+    /// Create a builder for a static batch
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /// One renderable per cluster, ready for RenderAgent::add()
+    const std::vector<Renderable>& renderables() const { return renderables_; }
+
+    /// Cluster meshes (owned by the batch; renderables() point at them)
+    const std::vector<MeshRef>& meshes() const { return meshes_; }
+
+    /// Number of clusters (draws)
+    size_t clusterCount() const { return renderables_.size(); }
+
+    /// Number of objects merged
+    size_t sourceCount() const { return sourceCount_; }
+
+    /// Upload submission (valid after build(UploadManager&))
+    const SubmitTicket& ticket() const { return ticket_; }
+
+    // Non-copyable (renderables point into meshes_)
+    StaticBatch(const StaticBatch&) = delete;
+    StaticBatch& operator=(const StaticBatch&) = delete;
+
+private:
+    friend class Builder;
+    StaticBatch() = default;
+
+    std::vector<Renderable> renderables_;
+    std::vector<MeshRef> meshes_;
+    size_t sourceCount_ = 0;
+    SubmitTicket ticket_;
+};
+
+} // namespace finevk
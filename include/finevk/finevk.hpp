@@ -5,9 +5,15 @@
 
 // Core foundation (Layer 1)
 #include "finevk/core/logging.hpp"
+#include "finevk/core/profiler.hpp"
+#include "finevk/core/span.hpp"
+#include "finevk/core/small_vector.hpp"
 #include "finevk/core/instance.hpp"
 #include "finevk/core/surface.hpp"
 #include "finevk/core/debug.hpp"
+#include "finevk/core/thread_pool.hpp"
+#include "finevk/core/mapped_file.hpp"
+#include "finevk/core/asset_pack.hpp"
 
 // Window Management
 #include "finevk/window/window.hpp"
@@ -20,22 +26,42 @@
 #include "finevk/device/image.hpp"
 #include "finevk/device/sampler.hpp"
 #include "finevk/device/command.hpp"
+#include "finevk/device/upload_manager.hpp"
+#include "finevk/device/pipeline_cache.hpp"
+#include "finevk/device/gpu_profiler.hpp"
+#include "finevk/device/async_compute.hpp"
+#include "finevk/device/submit_batch.hpp"
 
 // Rendering Infrastructure (Layer 3)
 #include "finevk/rendering/swapchain.hpp"
 #include "finevk/rendering/renderpass.hpp"
 #include "finevk/rendering/framebuffer.hpp"
 #include "finevk/rendering/pipeline.hpp"
+#include "finevk/rendering/pipeline_batch.hpp"
 #include "finevk/rendering/sync.hpp"
 #include "finevk/rendering/descriptors.hpp"
+#include "finevk/rendering/descriptor_allocator.hpp"
 #include "finevk/rendering/render_target.hpp"
+#include "finevk/rendering/render_graph.hpp"
 
 // High-Level Abstractions (Layer 4)
 #include "finevk/high/texture.hpp"
+#include "finevk/high/texture_container.hpp"
+#include "finevk/high/texture_array.hpp"
+#include "finevk/high/texture_streamer.hpp"
+#include "finevk/high/mip_generator.hpp"
+#include "finevk/high/virtual_texture.hpp"
 #include "finevk/high/mesh.hpp"
+#include "finevk/high/mesh_optimizer.hpp"
 #include "finevk/high/uniform_buffer.hpp"
+#include "finevk/high/uniform_ring.hpp"
+#include "finevk/high/bindless.hpp"
 #include "finevk/high/format_utils.hpp"
 #include "finevk/high/simple_renderer.hpp"
+#include "finevk/high/headless_renderer.hpp"
+#include "finevk/high/image_readback.hpp"
+#include "finevk/high/asset_loader.hpp"
+#include "finevk/high/dynamic_resolution.hpp"
 #include "finevk/high/material.hpp"
 
 // Forward declarations and common types
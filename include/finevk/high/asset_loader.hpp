@@ -0,0 +1,244 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/high/mesh.hpp"
+#include "finevk/high/texture.hpp"
+
+#include <vulkan/vulkan.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class ThreadPool;
+
+/**
+ * @brief An asset that is still loading
+ *
+ * get() is nullptr until the asset has been decoded on a worker thread and
+ * its upload has completed, then the finished asset. Owned by the caller
+ * through a shared_ptr; the loader only touches it from update(), so query
+ * it on the render thread.
+ */
+template<typename T>
+class AsyncAsset {
+public:
+    using Ref = std::shared_ptr<T>;
+
+    /// The asset once isReady(), else nullptr
+    const Ref& get() const { return asset_; }
+
+    /// True once the asset is uploaded and usable
+    bool isReady() const { return ready_; }
+
+    /// True if loading failed (error() says why)
+    bool failed() const { return failed_; }
+
+    /// Failure reason (empty unless failed())
+    const std::string& error() const { return error_; }
+
+    /// Source path, or empty for in-memory sources
+    const std::string& path() const { return path_; }
+
+    /**
+     * @brief Run a callback from AssetLoader::update() once the asset is ready
+     *
+     * Runs immediately if already ready; never runs if loading fails.
+     */
+    void onReady(std::function<void(const Ref&)> callback) {
+        if (ready_) {
+            callback(asset_);
+        } else if (!failed_) {
+            callbacks_.push_back(std::move(callback));
+        }
+    }
+
+private:
+    friend class AssetLoader;
+
+    std::string path_;
+    Ref asset_;
+    bool ready_ = false;
+    bool failed_ = false;
+    std::string error_;
+    std::vector<std::function<void(const Ref&)>> callbacks_;
+};
+
+using AsyncTextureRef = std::shared_ptr<AsyncAsset<Texture>>;
+using AsyncMeshRef = std::shared_ptr<AsyncAsset<Mesh>>;
+
+/**
+ * @brief Builds textures and meshes off the render thread
+ *
+ * load() (or Texture::Builder::buildAsync() / Mesh::Builder::buildAsync())
+ * returns immediately with an AsyncAsset. A ThreadPool worker does the file
+ * I/O and CPU work: image decoding and a box-filtered mip chain, KTX2/DDS
+ * parsing, OBJ parsing or the mesh cache read, and vertex packing. update(),
+ * called once per frame on the render thread, creates the GPU resources for
+ * finished jobs and queues their copies on the UploadManager up to a
+ * per-frame byte budget, all in one flush(), then marks completed uploads
+ * ready.
+ *
+ * Usage:
+ * @code
+ * auto loader = AssetLoader::create(device, uploads.get()).build();
+ *
+ * auto rock = Texture::load(device, commandPool, "textures/rock.png")
+ *     .generateMipmaps()
+ *     .srgb()
+ *     .buildAsync(*loader);
+ * auto crate = Mesh::load(device, commandPool, "models/crate.obj")
+ *     .cache()
+ *     .buildAsync(*loader);
+ *
+ * // Once per frame on the render thread
+ * loader->update();
+ * if (crate->isReady()) { ... draw crate->get() ... }
+ * @endcode
+ */
+class AssetLoader {
+public:
+    /**
+     * @brief Builder for creating AssetLoader objects
+     */
+    class Builder {
+    public:
+        Builder(LogicalDevice* device, UploadManager* uploads);
+
+        /// Bytes handed to the UploadManager per update() (default: 16 MiB)
+        Builder& frameBudget(VkDeviceSize bytes);
+
+        /// Pool for load jobs (default: ThreadPool::global())
+        Builder& threads(ThreadPool* pool);
+
+        /// Build the loader
+        AssetLoaderPtr build();
+
+    private:
+        LogicalDevice* device_;
+        UploadManager* uploads_;
+        VkDeviceSize frameBudget_ = 16 * 1024 * 1024;
+        ThreadPool* threads_ = nullptr;
+    };
+
+    /// Create a builder for an asset loader
+    static Builder create(LogicalDevice* device, UploadManager* uploads);
+    static Builder create(const LogicalDevicePtr& device, UploadManager* uploads) {
+        return create(device.get(), uploads);
+    }
+
+    /**
+     * @brief Start loading a texture
+     *
+     * Memory sources are copied before this returns. mipGenerator() is not
+     * used: mips are filtered on the worker thread (stb_image sources) or
+     * taken from the file (KTX2/DDS). With host image copy enabled and a
+     * format that supports it (see canUploadFromHost()), the worker also
+     * copies the texels into the image, so update() hands the texture out
+     * without going through the UploadManager or the frame budget.
+     */
+    AsyncTextureRef load(const Texture::Builder& builder);
+
+    /// Start building a mesh (the builder is copied)
+    AsyncMeshRef load(const Mesh::Builder& builder);
+
+    /**
+     * @brief Per-frame step (render thread)
+     *
+     * Marks completed uploads ready (running onReady callbacks), then queues
+     * finished jobs for upload until the frame budget is spent. One asset
+     * larger than the budget is still queued when nothing else was this
+     * frame, so big assets can't starve.
+     */
+    void update();
+
+    /// Block until every requested asset is ready or failed (loading screens, shutdown)
+    void waitIdle();
+
+    /// Assets requested but not yet ready or failed
+    size_t pendingCount() const { return pending_; }
+
+    /// Bytes queued for upload by the last update()
+    VkDeviceSize lastFrameBytes() const { return lastFrameBytes_; }
+
+    /// Per-frame upload budget
+    VkDeviceSize frameBudget() const { return frameBudget_; }
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    /// Destructor - waits for uploads in flight, drops unfinished jobs
+    ~AssetLoader();
+
+    // Non-copyable
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+private:
+    friend class Builder;
+    AssetLoader() = default;
+
+    // Output of a load job, ready for upload
+    struct Prepared {
+        AsyncTextureRef texture;
+        AsyncMeshRef mesh;
+
+        // Texture: mip chain, level 0 first
+        uint32_t width = 0;
+        uint32_t height = 0;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        std::vector<std::vector<uint8_t>> mips;
+        ImagePtr image;  // Already filled by a host image copy (mips then empty)
+
+        // Mesh: the builder that packed it uploads it
+        std::shared_ptr<Mesh::Builder> builder;
+        Mesh::Builder::PackedData packed;
+
+        VkDeviceSize bytes = 0;
+        std::string error;  // Non-empty: the job failed
+    };
+
+    // Shared with load jobs so they never touch a destroyed loader
+    struct Inbox {
+        std::mutex mutex;
+        std::deque<Prepared> prepared;
+        bool closed = false;
+        size_t hostCopies = 0;  // Jobs writing into images; the destructor waits for them
+        std::condition_variable idle;
+    };
+
+    struct Upload {
+        AsyncTextureRef texture;
+        AsyncMeshRef mesh;
+        ImagePtr image;
+        MeshRef meshAsset;
+        SubmitTicket ticket;
+    };
+
+    void startUpload(Prepared& prepared);
+    void finish(Upload& upload);
+    void fail(Prepared& prepared);
+    bool canSample(VkFormat format) const;
+
+    LogicalDevice* device_ = nullptr;
+    UploadManager* uploads_ = nullptr;
+    ThreadPool* threads_ = nullptr;
+    VkDeviceSize frameBudget_ = 0;
+    VkDeviceSize lastFrameBytes_ = 0;
+    size_t pending_ = 0;
+
+    std::shared_ptr<Inbox> inbox_;
+    std::deque<Prepared> waiting_;  // Prepared, over this frame's budget
+    std::vector<Upload> uploading_;
+};
+
+} // namespace finevk
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/buffer.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class DescriptorSetLayout;
+class DescriptorPool;
+class CommandBuffer;
+class ImageView;
+class Sampler;
+
+/**
+ * @brief Bindless descriptor table for textures and material parameters
+ *
+ * One descriptor set holding a large update-after-bind array of combined
+ * image samplers (binding 0) and a storage buffer of fixed-stride material
+ * parameter blocks (binding 1). Textures and materials register once and
+ * get an index; the set is bound once per command buffer and draws select
+ * their data by index (ObjectPushConstants::materialIndex), so there is no
+ * per-object descriptor set or descriptor update.
+ *
+ * Textures and materials registered through registerBindless() give their
+ * slots back when destroyed and keep a raw pointer to the table until
+ * then, so the table must outlive every Texture and Material registered
+ * with it.
+ *
+ * Requires LogicalDeviceBuilder::enableDescriptorIndexing().
+ *
+ * Usage:
+ * @code
+ * auto bindless = BindlessTable::create(device)
+ *     .maxTextures(4096)
+ *     .materials<MaterialParams>(1024)
+ *     .build();
+ *
+ * uint32_t albedo = texture->registerBindless(*bindless, sampler.get());
+ * material->registerBindless(*bindless, MaterialParams{albedo, ...});
+ *
+ * auto layout = PipelineLayout::create(device)
+ *     .addDescriptorSetLayout(bindless->layout()->handle())
+ *     .addObjectPushConstants(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+ *     .build();
+ * @endcode
+ *
+ * Matching GLSL (GL_EXT_nonuniform_qualifier):
+ * @code
+ * layout(set = 0, binding = 0) uniform sampler2D textures[];
+ * layout(set = 0, binding = 1) readonly buffer Materials { MaterialParams materials[]; };
+ * // texture(textures[nonuniformEXT(materials[object.materialIndex].albedo)], uv)
+ * @endcode
+ */
+class BindlessTable {
+public:
+    /// Returned for unregistered textures and materials
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    /**
+     * @brief Builder for creating BindlessTable objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Size of the texture array (default: 4096, clamped to device limits)
+        Builder& maxTextures(uint32_t count);
+
+        /**
+         * @brief Material parameter block size and capacity
+         *
+         * stride must equal the std430 array stride of the GLSL struct.
+         * Default: no material buffer.
+         */
+        Builder& materials(VkDeviceSize stride, uint32_t count);
+
+        /// Material parameter blocks of type T
+        template<typename T>
+        Builder& materials(uint32_t count) { return materials(sizeof(T), count); }
+
+        /// Shader stages that see the table (default: all graphics)
+        Builder& stages(VkShaderStageFlags stages);
+
+        /// Build the table
+        BindlessTablePtr build();
+
+    private:
+        LogicalDevice* device_;
+        uint32_t maxTextures_ = 4096;
+        VkDeviceSize materialStride_ = 0;
+        uint32_t maxMaterials_ = 0;
+        VkShaderStageFlags stages_ = VK_SHADER_STAGE_ALL_GRAPHICS;
+    };
+
+    /// Create a builder for a bindless table
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    // =========================================================================
+    // Textures
+    // =========================================================================
+
+    /**
+     * @brief Write a texture into a free array slot
+     * @return Index for the shader's texture array
+     * @throws std::runtime_error if the array is full
+     */
+    uint32_t addTexture(ImageView* view, Sampler* sampler,
+                        VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /// Point an existing slot at a different image (e.g. a streamed-in mip chain)
+    void updateTexture(uint32_t index, ImageView* view, Sampler* sampler,
+                       VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /**
+     * @brief Return a slot to the free list
+     *
+     * The slot may be handed out again by the next addTexture(), so only
+     * remove a texture once no frame in flight samples it.
+     *
+     * @throws std::runtime_error if the slot is not in use
+     */
+    void removeTexture(uint32_t index);
+
+    /// removeTexture() for destructors: warns instead of throwing if the slot is not in use
+    void releaseTexture(uint32_t index) noexcept;
+
+    /// Slots currently in use
+    uint32_t textureCount() const { return textureCount_; }
+
+    /// Size of the texture array
+    uint32_t maxTextures() const { return maxTextures_; }
+
+    // =========================================================================
+    // Material parameters
+    // =========================================================================
+
+    /**
+     * @brief Copy a parameter block into a free material slot
+     * @param size Bytes to copy (at most the stride)
+     * @return Index for the shader's material array
+     * @throws std::runtime_error if the buffer is full or was not configured
+     */
+    uint32_t addMaterial(const void* data, VkDeviceSize size);
+
+    template<typename T>
+    uint32_t addMaterial(const T& params) { return addMaterial(&params, sizeof(T)); }
+
+    /**
+     * @brief Overwrite a material's parameters
+     *
+     * Written straight into the mapped buffer: frames still in flight see
+     * the new contents, so change parameters only between frames that
+     * would otherwise disagree, or version them through a new slot.
+     */
+    void updateMaterial(uint32_t index, const void* data, VkDeviceSize size);
+
+    template<typename T>
+    void updateMaterial(uint32_t index, const T& params) { updateMaterial(index, &params, sizeof(T)); }
+
+    /// Return a material slot to the free list (same rules as removeTexture())
+    void removeMaterial(uint32_t index);
+
+    /// removeMaterial() for destructors: warns instead of throwing if the slot is not in use
+    void releaseMaterial(uint32_t index) noexcept;
+
+    /// Material block stride in bytes
+    VkDeviceSize materialStride() const { return materialStride_; }
+
+    /// Material capacity
+    uint32_t maxMaterials() const { return maxMaterials_; }
+
+    // =========================================================================
+    // Binding
+    // =========================================================================
+
+    /// Descriptor set layout to add to pipeline layouts
+    DescriptorSetLayout* layout() const { return layout_.get(); }
+
+    /// The single descriptor set
+    VkDescriptorSet descriptorSet() const { return set_; }
+
+    /// Bind the table's set (once per command buffer and pipeline layout change)
+    void bind(CommandBuffer& cmd, VkPipelineLayout pipelineLayout, uint32_t setIndex = 0) const;
+
+    /// Destructor
+    ~BindlessTable();
+
+    // Non-copyable
+    BindlessTable(const BindlessTable&) = delete;
+    BindlessTable& operator=(const BindlessTable&) = delete;
+
+private:
+    friend class Builder;
+    BindlessTable() = default;
+
+    void writeTexture(uint32_t index, ImageView* view, Sampler* sampler, VkImageLayout layout);
+
+    LogicalDevice* device_ = nullptr;
+    DescriptorSetLayoutPtr layout_;
+    DescriptorPoolPtr pool_;
+    VkDescriptorSet set_ = VK_NULL_HANDLE;
+
+    uint32_t maxTextures_ = 0;
+    uint32_t textureCount_ = 0;
+    uint32_t nextTexture_ = 0;
+    std::vector<uint32_t> freeTextures_;
+    std::vector<bool> textureUsed_;     // Per slot, catches double removes
+
+    BufferPtr materialBuffer_;
+    uint8_t* materialData_ = nullptr;
+    VkDeviceSize materialStride_ = 0;
+    uint32_t maxMaterials_ = 0;
+    uint32_t nextMaterial_ = 0;
+    std::vector<uint32_t> freeMaterials_;
+    std::vector<bool> materialUsed_;
+};
+
+} // namespace finevk
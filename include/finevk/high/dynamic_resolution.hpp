@@ -0,0 +1,200 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/rendering/render_target.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandBuffer;
+class Window;
+class GpuProfiler;
+
+/**
+ * @brief Dynamic resolution scaling for GPU-bound frames
+ *
+ * Owns an off-screen RenderTarget the size of the window. Each frame the
+ * scene renders into its top-left renderExtent() region, at a scale picked
+ * from measured GPU time, and upscale() blits that region with linear
+ * filtering onto the current swap chain image, which it leaves in
+ * PRESENT_SRC. UI drawn at full resolution can follow through the window's
+ * own target with RenderTarget::resume() (a window target without depth).
+ *
+ * update() aims for targetFrameTime(). GPU time is taken to grow with the
+ * pixel count, so each timing is divided by the squared scale of the frame
+ * it measured (framesInFlight begins earlier) into a smoothed full
+ * resolution cost, and the scale is sqrt(target / cost). Changes below a
+ * small threshold are skipped so the resolution doesn't flicker.
+ *
+ * The swap chain needs VK_IMAGE_USAGE_TRANSFER_DST_BIT, which SwapChain
+ * requests wherever the surface supports it. The attachments follow window
+ * resizes; the old ones go to Window::retire(). Shaders sampling color()
+ * afterwards scale their UVs by uvScaleX() and uvScaleY().
+ *
+ * Usage:
+ * @code
+ * auto resolution = DynamicResolution::create(window)
+ *     .targetFrameTime(16.6)
+ *     .enableDepth()
+ *     .build();
+ *
+ * // Each frame
+ * resolution->update(*profiler);
+ * resolution->begin(cmd, {0.1f, 0.1f, 0.1f});
+ * ... draw the scene with pipelines built for resolution->target() ...
+ * resolution->end(cmd);
+ * resolution->upscale(cmd);
+ * @endcode
+ */
+class DynamicResolution {
+public:
+    /**
+     * @brief Builder for creating DynamicResolution objects
+     */
+    class Builder {
+    public:
+        explicit Builder(Window* window);
+
+        /// Range of the render scale (default: 0.5 to 1)
+        Builder& scaleRange(float minScale, float maxScale);
+
+        /// GPU time per frame to hold, in milliseconds (default: 16.6)
+        Builder& targetFrameTime(double milliseconds);
+
+        /// Color format of the scene target (default: the swap chain's)
+        Builder& colorFormat(VkFormat format);
+
+        /// Enable depth buffer with auto-selected format
+        Builder& enableDepth();
+
+        /// Enable depth buffer with specific format
+        Builder& depthFormat(VkFormat format);
+
+        /// Render without a RenderPass where supported (see RenderTarget::Builder)
+        Builder& dynamicRendering(bool enable = true);
+
+        /**
+         * @brief Build the dynamic resolution target
+         *
+         * @throws std::runtime_error if the swap chain images can't be blitted to
+         */
+        DynamicResolutionPtr build();
+
+    private:
+        Window* window_;
+        float minScale_ = 0.5f;
+        float maxScale_ = 1.0f;
+        double targetMilliseconds_ = 16.6;
+        VkFormat colorFormat_ = VK_FORMAT_UNDEFINED;
+        VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
+        bool enableDepth_ = false;
+        bool dynamicRendering_ = false;
+    };
+
+    /// Create a builder for a dynamic resolution target
+    static Builder create(Window* window);
+    static Builder create(Window& window) { return create(&window); }
+    static Builder create(const WindowPtr& window) { return create(window.get()); }
+
+    /**
+     * @brief Feed one frame's GPU time and pick the next render scale
+     *
+     * Call before begin(), with the timing of the frame recorded
+     * framesInFlight frames ago (what GpuProfiler::results() holds then).
+     * Non-positive timings are ignored.
+     */
+    void update(double gpuMilliseconds);
+
+    /// Feed the profiler's newest frame (GpuFrameTimings::totalMilliseconds); each frame counts once
+    void update(const GpuProfiler& profiler);
+
+    /// Begin the scene pass at the current scale (recreates the target after a resize)
+    void begin(CommandBuffer& cmd, const ClearColor& clearColor, float clearDepth = 1.0f);
+
+    /// End the scene pass
+    void end(CommandBuffer& cmd);
+
+    /**
+     * @brief Blit the rendered region onto the current swap chain image
+     *
+     * Record after end() and outside a render pass. Leaves the swap chain
+     * image in PRESENT_SRC and color() back in COLOR_ATTACHMENT_OPTIMAL.
+     */
+    void upscale(CommandBuffer& cmd);
+
+    /// Set the scale directly (clamped to the range; update() carries on from it)
+    void setScale(float scale);
+
+    /// Current render scale
+    float scale() const { return scale_; }
+
+    float minScale() const { return minScale_; }
+    float maxScale() const { return maxScale_; }
+
+    /// GPU time update() aims for, in milliseconds
+    double targetFrameTime() const { return targetMilliseconds_; }
+    void setTargetFrameTime(double milliseconds) { targetMilliseconds_ = milliseconds; }
+
+    /// Smoothed GPU time estimate at scale 1, in milliseconds (0 before the first sample)
+    double fullResolutionFrameTime() const { return fullCostMilliseconds_; }
+
+    /// Scene target; replaced after a window resize (pipelines built for it stay compatible)
+    RenderTarget* target() const { return target_.get(); }
+
+    /// Full-size color image the scene renders into
+    Image* color() const { return colorImage_.get(); }
+
+    /// Region of color() the current frame covers
+    VkExtent2D renderExtent() const;
+
+    /// renderExtent() over the full extent, for sampling color() in later passes
+    float uvScaleX() const;
+    float uvScaleY() const;
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    /// Destructor
+    ~DynamicResolution();
+
+    // Non-copyable
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+private:
+    friend class Builder;
+    DynamicResolution() = default;
+
+    /// Create the color image and target at the swap chain's extent
+    void createTarget();
+
+    LogicalDevice* device_ = nullptr;
+    Window* window_ = nullptr;
+
+    VkFormat colorFormat_ = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
+    bool enableDepth_ = false;
+    bool dynamicRendering_ = false;
+    VkFilter filter_ = VK_FILTER_LINEAR;
+
+    ImagePtr colorImage_;
+    RenderTargetPtr target_;
+    VkExtent2D extent_{};
+
+    float minScale_ = 0.5f;
+    float maxScale_ = 1.0f;
+    float scale_ = 1.0f;
+    double targetMilliseconds_ = 16.6;
+    double fullCostMilliseconds_ = 0.0;
+    uint64_t profilerFrame_ = 0;  // Last GpuProfiler frame fed to update()
+
+    // Scale of each recent begin(), to match timings to the frame they measured
+    static constexpr uint32_t ScaleHistory = 4;
+    float scaleHistory_[ScaleHistory] = {1.0f, 1.0f, 1.0f, 1.0f};
+    uint64_t frameCount_ = 0;
+};
+
+} // namespace finevk
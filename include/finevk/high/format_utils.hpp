@@ -197,6 +197,91 @@ inline uint32_t bytesPerPixel(VkFormat format) {
     }
 }
 
+/// Check if format is block-compressed (BC, ETC2/EAC or ASTC)
+inline bool isCompressed(VkFormat format) {
+    return (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK);
+}
+
+/// Get the texel block extent of a format (1x1 for uncompressed formats)
+inline VkExtent2D blockExtent(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
+            return {5, 4};
+        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
+            return {5, 5};
+        case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
+            return {6, 5};
+        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+            return {6, 6};
+        case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
+            return {8, 5};
+        case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
+            return {8, 6};
+        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+            return {8, 8};
+        case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
+            return {10, 5};
+        case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
+            return {10, 6};
+        case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
+            return {10, 8};
+        case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
+            return {10, 10};
+        case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
+            return {12, 10};
+        case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
+            return {12, 12};
+        default:
+            // BC, ETC2/EAC and ASTC 4x4 all use 4x4 blocks
+            return isCompressed(format) ? VkExtent2D{4, 4} : VkExtent2D{1, 1};
+    }
+}
+
+/// Get bytes per texel block (bytesPerPixel() for uncompressed formats)
+inline uint32_t bytesPerBlock(VkFormat format) {
+    switch (format) {
+        // 8 byte blocks
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+            return 8;
+
+        default:
+            // Remaining BC, ETC2 RGBA8, EAC RG11 and every ASTC size are 16 bytes
+            return isCompressed(format) ? 16 : bytesPerPixel(format);
+    }
+}
+
+/// Get the tightly packed byte size of one mip level of a 2D image (0 if unknown)
+inline VkDeviceSize levelSize(VkFormat format, uint32_t width, uint32_t height) {
+    VkExtent2D block = blockExtent(format);
+    VkDeviceSize blocksX = (width + block.width - 1) / block.width;
+    VkDeviceSize blocksY = (height + block.height - 1) / block.height;
+    return blocksX * blocksY * bytesPerBlock(format);
+}
+
 /// Get image aspect flags for a format
 inline VkImageAspectFlags aspectFlags(VkFormat format) {
     if (hasDepth(format) && hasStencil(format)) {
@@ -231,6 +316,19 @@ inline const char* formatName(VkFormat format) {
         case VK_FORMAT_D32_SFLOAT: return "D32_SFLOAT";
         case VK_FORMAT_D24_UNORM_S8_UINT: return "D24_UNORM_S8_UINT";
         case VK_FORMAT_D32_SFLOAT_S8_UINT: return "D32_SFLOAT_S8_UINT";
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK: return "BC1_RGBA_UNORM";
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: return "BC1_RGBA_SRGB";
+        case VK_FORMAT_BC3_UNORM_BLOCK: return "BC3_UNORM";
+        case VK_FORMAT_BC3_SRGB_BLOCK: return "BC3_SRGB";
+        case VK_FORMAT_BC4_UNORM_BLOCK: return "BC4_UNORM";
+        case VK_FORMAT_BC5_UNORM_BLOCK: return "BC5_UNORM";
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK: return "BC6H_UFLOAT";
+        case VK_FORMAT_BC7_UNORM_BLOCK: return "BC7_UNORM";
+        case VK_FORMAT_BC7_SRGB_BLOCK: return "BC7_SRGB";
+        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK: return "ETC2_R8G8B8A8_UNORM";
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK: return "ETC2_R8G8B8A8_SRGB";
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK: return "ASTC_4x4_UNORM";
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK: return "ASTC_4x4_SRGB";
         default: return "UNKNOWN";
     }
 }
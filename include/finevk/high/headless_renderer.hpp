@@ -0,0 +1,216 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/high/simple_renderer.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/logical_device.hpp"
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class Image;
+class Fence;
+class RenderPass;
+class RenderTarget;
+class FrameCommandPools;
+class SubmitBatch;
+
+/**
+ * @brief SimpleRenderer without a window: renders into a ring of images
+ *
+ * For benchmarks and regression runs on machines without a display server.
+ * Each frame slot owns a color image, an off-screen RenderTarget on it and a
+ * fence; beginFrame() waits for the slot, so frames overlap exactly like
+ * SimpleRenderer's but nothing is acquired or presented and the frame rate
+ * is bounded by the GPU alone. Frame timing is deterministic (no vsync, no
+ * compositor), which is what a benchmark wants.
+ *
+ * The device needs no surface or swap chain extension; pair it with
+ * Instance::Builder::headless() to skip GLFW entirely. Color images are
+ * created with TRANSFER_SRC and SAMPLED usage and finish each frame in
+ * COLOR_ATTACHMENT_OPTIMAL, so a frame can be read back or sampled.
+ *
+ * The RendererConfig is the same as SimpleRenderer's; MSAA is not
+ * supported and renders at 1x. Pipelines built against renderPass() work
+ * with every slot's target (the passes are compatible).
+ *
+ * Usage:
+ * @code
+ * auto instance = Instance::create().headless().build();
+ * auto device = instance->selectPhysicalDevice().createLogicalDevice().build();
+ * auto renderer = HeadlessRenderer::create(device, 1920, 1080);
+ *
+ * for (uint32_t i = 0; i < frameCount; i++) {
+ *     auto result = renderer->beginFrame();
+ *     renderer->beginRenderPass({0.0f, 0.0f, 0.0f, 1.0f});
+ *     // Draw...
+ *     renderer->endRenderPass();
+ *     renderer->endFrame();
+ * }
+ * renderer->waitIdle();
+ * @endcode
+ */
+class HeadlessRenderer {
+public:
+    /**
+     * @brief Create a headless renderer
+     * @param device Logical device (no surface required)
+     * @param width Render width in pixels
+     * @param height Render height in pixels
+     * @param config Renderer configuration (depth buffer, frame pools, profiling)
+     * @param colorFormat Format of the rendered images
+     */
+    static std::unique_ptr<HeadlessRenderer> create(
+        LogicalDevice* device, uint32_t width, uint32_t height,
+        const RendererConfig& config = {},
+        VkFormat colorFormat = VK_FORMAT_R8G8B8A8_UNORM);
+    static std::unique_ptr<HeadlessRenderer> create(
+        LogicalDevice& device, uint32_t width, uint32_t height,
+        const RendererConfig& config = {},
+        VkFormat colorFormat = VK_FORMAT_R8G8B8A8_UNORM) {
+        return create(&device, width, height, config, colorFormat);
+    }
+    static std::unique_ptr<HeadlessRenderer> create(
+        const LogicalDevicePtr& device, uint32_t width, uint32_t height,
+        const RendererConfig& config = {},
+        VkFormat colorFormat = VK_FORMAT_R8G8B8A8_UNORM) {
+        return create(device.get(), width, height, config, colorFormat);
+    }
+
+    /// Get the logical device
+    LogicalDevice* device() const { return device_; }
+
+    /// Render pass compatible with every slot's target (nullptr with dynamic rendering)
+    RenderPass* renderPass() const;
+
+    /// Render target of the current (or, between frames, the last) frame
+    RenderTarget* renderTarget() const;
+
+    /// Color image of a frame slot
+    Image* colorImage(uint32_t slot) const;
+
+    /// Color image of the current (or, between frames, the last) frame
+    Image* currentColorImage() const { return colorImage(currentSlot_); }
+
+    /// Get the per-frame pools (nullptr unless RendererConfig::frameCommandPools)
+    FrameCommandPools* frameCommandPools() const { return framePools_.get(); }
+
+    /// Get the frame's GPU profiler (nullptr unless RendererConfig::gpuProfiling)
+    GpuProfiler* gpuProfiler() const { return gpuProfiler_.get(); }
+
+    /// Same as SimpleRenderer::readback(); read the slot's colorImage() after endRenderPass()
+    ImageReadback& readback();
+
+    /// Counters of the last frame ended by endFrame()
+    const RenderStats& frameStats() const { return frameStats_; }
+
+    /// Frames ended so far
+    uint64_t frameCount() const { return frameCount_; }
+
+    /// Same as SimpleRenderer::acquireCommandBuffer()
+    CommandBuffer& acquireCommandBuffer(uint32_t thread = 0,
+        VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    /// Same as SimpleRenderer::waitFor()
+    void waitFor(const TimelinePoint& point, VkPipelineStageFlags2KHR stages);
+
+    /// Same as SimpleRenderer::submission()
+    SubmitBatch& submission();
+
+    /// Get frames in flight count (follows LogicalDevice::setFramesInFlight())
+    uint32_t framesInFlight() const { return device_->framesInFlight(); }
+
+    /// Frame slots allocated
+    uint32_t maxFramesInFlight() const { return static_cast<uint32_t>(slots_.size()); }
+
+    /// Get current frame slot (0 to framesInFlight-1)
+    uint32_t currentFrame() const { return currentSlot_; }
+
+    /// Get render extent
+    VkExtent2D extent() const { return extent_; }
+
+    /// Get color image format
+    VkFormat colorFormat() const { return colorFormat_; }
+
+    /// Get depth format (VK_FORMAT_UNDEFINED if no depth)
+    VkFormat depthFormat() const;
+
+    /**
+     * @brief Begin a new frame
+     *
+     * Waits for the frame that last used the next slot and begins its
+     * command buffer. Always succeeds; imageIndex is the slot.
+     */
+    FrameBeginResult beginFrame();
+
+    /// Begin the slot's render target (after beginFrame())
+    void beginRenderPass(const glm::vec4& clearColor = {0.0f, 0.0f, 0.0f, 1.0f});
+
+    /// End the render pass
+    void endRenderPass();
+
+    /**
+     * @brief End and submit the frame
+     *
+     * Submits in one call like SimpleRenderer::endFrame(), signaling the
+     * slot's fence instead of presenting.
+     *
+     * @return true if a frame was in progress
+     */
+    bool endFrame();
+
+    /// Point that completes with the last submitted frame (value 0 without timeline)
+    TimelinePoint lastFrame() const { return {device_->graphicsQueue(), lastFrameValue_}; }
+
+    /// Wait for every submitted frame
+    void waitIdle();
+
+    /// Destructor - waits for frames in flight
+    ~HeadlessRenderer();
+
+    // Non-copyable
+    HeadlessRenderer(const HeadlessRenderer&) = delete;
+    HeadlessRenderer& operator=(const HeadlessRenderer&) = delete;
+
+private:
+    HeadlessRenderer() = default;
+
+    struct Slot {
+        ImagePtr color;
+        RenderTargetPtr target;
+        FencePtr fence;
+        CommandBufferPtr cmd;  // Unless frame-ring mode
+    };
+
+    RendererConfig config_;
+    LogicalDevice* device_ = nullptr;
+    VkExtent2D extent_{};
+    VkFormat colorFormat_ = VK_FORMAT_UNDEFINED;
+
+    std::vector<Slot> slots_;
+    uint32_t currentSlot_ = 0;
+    uint64_t frameCount_ = 0;
+    uint64_t lastFrameValue_ = 0;
+
+    std::unique_ptr<FrameCommandPools> framePools_;  // Frame-ring mode
+    CommandBuffer* frameCmd_ = nullptr;
+    std::vector<VkCommandBuffer> extraPrimaries_;
+    std::vector<TimelinePoint> frameWaits_;
+    std::vector<VkPipelineStageFlags2KHR> frameWaitStages_;
+    std::unique_ptr<SubmitBatch> frameSubmit_;
+    GpuProfilerPtr gpuProfiler_;
+    ImageReadbackPtr readback_;
+    RenderStats frameStats_;
+    bool frameInProgress_ = false;
+
+    size_t deviceDestructionCallbackId_ = 0;
+};
+
+} // namespace finevk
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/buffer.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandBuffer;
+class Image;
+class RenderTarget;
+
+/**
+ * @brief Pixels of a completed readback, valid only during the callback
+ *
+ * Rows are tightly packed (rowPitch = width * bytes per pixel).
+ */
+struct ReadbackView {
+    const uint8_t* data = nullptr;
+    VkDeviceSize size = 0;
+    VkExtent2D extent{};
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t rowPitch = 0;
+};
+
+/**
+ * @brief Owned copy of a completed readback, delivered through a future
+ */
+struct ReadbackImage {
+    std::vector<uint8_t> pixels;
+    VkExtent2D extent{};
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t rowPitch = 0;
+};
+
+/**
+ * @brief Asynchronous image-to-host copies recorded into the frame
+ *
+ * Each frame in flight owns a persistently mapped MemoryUsage::GpuToCpu
+ * buffer. read() records, into the frame's command buffer, a transition to
+ * TRANSFER_SRC, a copy into the frame's buffer, the transition back and a
+ * host-read barrier, and queues the callback. beginFrame() for that slot
+ * comes after the frame's fence has signaled, so it hands the bytes to the
+ * callbacks straight from the mapping without waiting or stalling the
+ * pipeline; results arrive framesInFlight frames after they were recorded.
+ *
+ * Buffers grow to the largest frame's total and are then reused; a frame
+ * that needs more keeps its old buffer until the slot comes round again.
+ * Record outside a render pass. Mip 0, layer 0 of color and depth images
+ * are supported; the image needs VK_IMAGE_USAGE_TRANSFER_SRC_BIT.
+ *
+ * SimpleRenderer and HeadlessRenderer own one (readback()) and call
+ * beginFrame() for you.
+ *
+ * Usage:
+ * @code
+ * auto readback = ImageReadback::create(device).build();
+ *
+ * // Each frame, after the frame's fence has signaled
+ * readback->beginFrame(frameIndex);
+ * ... render into target ...
+ * readback->read(cmd, *target, [](const ReadbackView& pixels) {
+ *     savePng("frame.png", pixels.data, pixels.extent);
+ * });
+ *
+ * // GPU picking: one texel of an ID target, as a future
+ * auto picked = readback->read(cmd, *idImage, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+ *                              VkRect2D{{mouseX, mouseY}, {1, 1}});
+ * @endcode
+ */
+class ImageReadback {
+public:
+    using Callback = std::function<void(const ReadbackView&)>;
+
+    /**
+     * @brief Builder for creating ImageReadback objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Bytes reserved per frame up front (default: 0, grown on demand)
+        Builder& initialSize(VkDeviceSize bytes);
+
+        /// Number of frame buffers (default: the device's maxFramesInFlight())
+        Builder& framesInFlight(uint32_t count);
+
+        /// Build the readback ring
+        ImageReadbackPtr build();
+
+    private:
+        LogicalDevice* device_;
+        VkDeviceSize initialSize_ = 0;
+        uint32_t framesInFlight_ = 0;
+    };
+
+    /// Create a builder for image readback
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /**
+     * @brief Deliver the readbacks this slot recorded last time around
+     *
+     * Call once per frame after the frame's fence has signaled and before
+     * recording any read() for the frame.
+     */
+    void beginFrame(uint32_t frameIndex);
+
+    /**
+     * @brief Copy a region of an image back to the host
+     *
+     * @param cmd Frame command buffer (outside a render pass)
+     * @param image Source image (TRANSFER_SRC usage)
+     * @param layout Layout the image is in; it is returned to it after the copy
+     * @param region Texels to copy (clamped to the image)
+     * @param callback Called from beginFrame() once the frame has completed
+     */
+    void read(CommandBuffer& cmd, Image& image, VkImageLayout layout,
+              const VkRect2D& region, Callback callback);
+
+    /// Copy the whole image
+    void read(CommandBuffer& cmd, Image& image, VkImageLayout layout, Callback callback);
+
+    /// Copy an off-screen render target's color image (after end())
+    void read(CommandBuffer& cmd, const RenderTarget& target, Callback callback);
+
+    /// Future variants: the pixels are copied out of the mapping on delivery
+    std::future<ReadbackImage> read(CommandBuffer& cmd, Image& image, VkImageLayout layout,
+                                    const VkRect2D& region);
+    std::future<ReadbackImage> read(CommandBuffer& cmd, Image& image, VkImageLayout layout);
+    std::future<ReadbackImage> read(CommandBuffer& cmd, const RenderTarget& target);
+
+    /**
+     * @brief Deliver everything pending, in recording order
+     *
+     * Only call once every frame that recorded a read() has completed,
+     * e.g. after HeadlessRenderer::waitIdle() or LogicalDevice::waitIdle().
+     */
+    void deliverAll();
+
+    /// Readbacks recorded but not yet delivered
+    size_t pendingCount() const;
+
+    /// Bytes of GpuToCpu memory held by the ring
+    VkDeviceSize memoryUsed() const;
+
+    uint32_t framesInFlight() const { return static_cast<uint32_t>(slots_.size()); }
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    ~ImageReadback() = default;
+
+    // Non-copyable
+    ImageReadback(const ImageReadback&) = delete;
+    ImageReadback& operator=(const ImageReadback&) = delete;
+
+private:
+    friend class Builder;
+    ImageReadback() = default;
+
+    struct Request {
+        const Buffer* buffer;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        VkExtent2D extent;
+        VkFormat format;
+        uint32_t rowPitch;
+        Callback callback;
+    };
+
+    struct Slot {
+        BufferPtr buffer;
+        std::vector<BufferPtr> outgrown;  // Smaller buffers still holding this frame's copies
+        VkDeviceSize used = 0;
+        std::vector<Request> requests;
+    };
+
+    void deliver(Slot& slot);
+    BufferPtr createBuffer(VkDeviceSize size) const;
+
+    LogicalDevice* device_ = nullptr;
+    std::vector<Slot> slots_;
+    Slot* current_ = nullptr;
+};
+
+} // namespace finevk
@@ -2,6 +2,7 @@
 
 #include "finevk/core/types.hpp"
 #include "finevk/high/uniform_buffer.hpp"
+#include "finevk/high/bindless.hpp"
 
 #include <vulkan/vulkan.h>
 #include <memory>
@@ -15,24 +16,33 @@ namespace finevk {
 class LogicalDevice;
 class DescriptorSetLayout;
 class DescriptorPool;
+class DescriptorAllocator;
+class DescriptorLayoutCache;
 class CommandBuffer;
 class Texture;
 class Sampler;
+union DescriptorInfo;
 
 /**
  * @brief High-level material system that encapsulates descriptor management
  *
  * Material manages:
- * - Descriptor set layout
- * - Descriptor pool
+ * - Descriptor set layout (or a shared one from a DescriptorLayoutCache)
+ * - Descriptor pool (or sets from a shared DescriptorAllocator)
  * - Descriptor sets (per-frame)
  * - Uniform buffers (per-frame)
  * - Texture bindings
  * - Automatic frame selection
  *
+ * Once every binding has been written, descriptor changes go through the
+ * layout's update template (DescriptorSetLayout::updateTemplate()): each
+ * frame's descriptors are kept in one packed array and a set is rewritten
+ * in a single call. Until then, or without template support, a change is
+ * applied to all frames in one batched vkUpdateDescriptorSets.
+ *
  * Usage:
  * @code
- * auto material = Material::create(device, framesInFlight)
+ * auto material = Material::create(device)
  *     .uniform<MVPUniform>(0, VK_SHADER_STAGE_VERTEX_BIT)
  *     .texture(1, VK_SHADER_STAGE_FRAGMENT_BIT)
  *     .build();
@@ -54,16 +64,16 @@ public:
     /**
      * @brief Create a builder for a material
      * @param device Logical device
-     * @param framesInFlight Number of frames in flight (for per-frame resources)
+     * @param framesInFlight Per-frame copies (default 0: LogicalDevice::maxFramesInFlight())
      */
-    static Builder create(LogicalDevice* device, uint32_t framesInFlight);
-    static Builder create(LogicalDevice& device, uint32_t framesInFlight);
-    static Builder create(const LogicalDevicePtr& device, uint32_t framesInFlight);
+    static Builder create(LogicalDevice* device, uint32_t framesInFlight = 0);
+    static Builder create(LogicalDevice& device, uint32_t framesInFlight = 0);
+    static Builder create(const LogicalDevicePtr& device, uint32_t framesInFlight = 0);
 
     /**
      * @brief Get the descriptor set layout
      */
-    DescriptorSetLayout* layout() const { return layout_.get(); }
+    DescriptorSetLayout* layout() const { return layoutRef_; }
 
     /**
      * @brief Get descriptor set for a specific frame
@@ -117,6 +127,37 @@ public:
      */
     void bind(CommandBuffer& cmd, VkPipelineLayout pipelineLayout, uint32_t setIndex = 0);
 
+    /**
+     * @brief Store this material's parameters in a bindless table
+     *
+     * Once registered, RenderAgent skips bind() for this material and
+     * pushes bindlessIndex() as ObjectPushConstants::materialIndex instead.
+     * Calling again with the same table updates the parameters in place; a
+     * different table moves the material there. The slot is removed when
+     * the material is destroyed, so table must outlive it; don't also
+     * removeMaterial() the index yourself.
+     *
+     * @return The material's index in the table's parameter buffer
+     */
+    template<typename T>
+    uint32_t registerBindless(BindlessTable& table, const T& params) {
+        if (bindlessTable_ == &table) {
+            table.updateMaterial(bindlessIndex_, params);
+        } else {
+            uint32_t index = table.addMaterial(params);
+            releaseBindless();
+            bindlessTable_ = &table;
+            bindlessIndex_ = index;
+        }
+        return bindlessIndex_;
+    }
+
+    /// Check if the material draws through a bindless table
+    bool isBindless() const { return bindlessTable_ != nullptr; }
+
+    /// Index in the bindless table's parameter buffer (BindlessTable::InvalidIndex if none)
+    uint32_t bindlessIndex() const { return bindlessIndex_; }
+
     /**
      * @brief Get the owning device
      */
@@ -143,19 +184,38 @@ private:
     Material() = default;
 
     void cleanup();
+    void releaseBindless() noexcept;
+
+    // Write one descriptor for every frame from frameInfos_ (framesInFlight_ entries)
+    void writeBinding(uint32_t binding, VkDescriptorType type);
 
     LogicalDevice* device_ = nullptr;
     uint32_t framesInFlight_ = 0;
     uint32_t currentFrame_ = 0;
 
-    // Descriptor resources
+    // Descriptor resources (layout_/pool_ empty when shared through a cache/allocator)
     DescriptorSetLayoutPtr layout_;
+    DescriptorSetLayout* layoutRef_ = nullptr;
     DescriptorPoolPtr pool_;
+    DescriptorAllocator* allocator_ = nullptr;
     std::vector<VkDescriptorSet> descriptorSets_;
 
     // Per-binding uniform buffers (indexed by binding number)
     // Each binding maps to a vector of buffers (one per frame)
     std::unordered_map<uint32_t, std::vector<BufferPtr>> uniformBuffers_;
+
+    // Template data: framesInFlight_ packed arrays of the template's descriptorCount()
+    std::vector<DescriptorInfo> descriptorData_;
+    std::vector<bool> written_;  // Per template element: written at least once
+    uint32_t unwritten_ = 0;
+
+    // Scratch reused by writeBinding()
+    std::vector<DescriptorInfo> frameInfos_;
+    std::vector<VkWriteDescriptorSet> writes_;
+
+    // Bindless registration (not owned)
+    BindlessTable* bindlessTable_ = nullptr;
+    uint32_t bindlessIndex_ = BindlessTable::InvalidIndex;
 };
 
 /**
@@ -184,6 +244,22 @@ public:
      */
     Builder& texture(uint32_t binding, VkShaderStageFlags stages);
 
+    /**
+     * @brief Allocate descriptor sets from a shared allocator instead of a private pool
+     *
+     * The allocator must outlive the material; sets are freed back to it
+     * on destruction.
+     */
+    Builder& allocator(DescriptorAllocator* allocator);
+
+    /**
+     * @brief Share the descriptor set layout through a cache
+     *
+     * Materials with identical bindings then use one layout handle. The
+     * cache must outlive the material.
+     */
+    Builder& layoutCache(DescriptorLayoutCache* cache);
+
     /**
      * @brief Build the material
      */
@@ -203,6 +279,8 @@ private:
     LogicalDevice* device_;
     uint32_t framesInFlight_;
     std::vector<BindingInfo> bindings_;
+    DescriptorAllocator* allocator_ = nullptr;
+    DescriptorLayoutCache* layoutCache_ = nullptr;
 };
 
 // Inline definitions (after Builder is complete)
@@ -1,14 +1,16 @@
 #pragma once
 
 #include "finevk/core/types.hpp"
+#include "finevk/core/mapped_file.hpp"
+#include "finevk/device/command.hpp"
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <functional>
 
 namespace finevk {
@@ -17,6 +19,11 @@ class LogicalDevice;
 class CommandPool;
 class CommandBuffer;
 class Buffer;
+class UploadManager;
+class MeshBatch;
+class AssetPack;
+class AssetLoader;
+template<typename T> class AsyncAsset;
 
 /**
  * @brief Standard vertex attribute flags
@@ -27,6 +34,13 @@ enum class VertexAttribute : uint32_t {
     TexCoord = 1 << 2,  // vec2
     Color    = 1 << 3,  // vec3
     Tangent  = 1 << 4,  // vec4 (xyz = tangent, w = handedness)
+
+    // Compact encodings, combined with the attribute they change
+    QuantizedPosition = 1 << 8,   // RGBA16 unorm within the mesh bounds (Mesh::dequantizeTransform())
+    OctNormal         = 1 << 9,   // RG16 snorm octahedral (fvkOctDecode() in shaders/vertex_decode.glsl)
+    HalfTexCoord      = 1 << 10,  // RG16 float
+    Color8            = 1 << 11,  // RGBA8 unorm
+    Compact           = 0xF00,    // All of the above
 };
 
 inline VertexAttribute operator|(VertexAttribute a, VertexAttribute b) {
@@ -57,7 +71,7 @@ struct Vertex {
     static std::vector<VkVertexInputAttributeDescription> attributeDescriptions(
         VertexAttribute attrs);
 
-    /// Calculate stride for given attributes
+    /// Calculate stride for given attributes (and their encodings)
     static uint32_t stride(VertexAttribute attrs);
 };
 
@@ -68,6 +82,28 @@ class Mesh {
 public:
     class Builder;
 
+    /// Index range of one level of detail within the mesh's indices
+    struct Lod {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        float error = 0.0f;  ///< Deviation from level 0, relative to the bounding radius
+    };
+
+    /// One entry of meshletBuffer() (std430: vec4 sphere, vec4 cone, uvec4 ranges)
+    struct GpuMeshlet {
+        float center[3];
+        float radius;
+        float coneAxis[3];
+        float coneCutoff;       ///< See MeshOptimizer::MeshletBounds
+        uint32_t vertexOffset;  ///< In meshletDataBuffer() words
+        uint32_t triangleOffset;
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+    };
+
+    /// Meshlets handled by one workgroup of shaders/meshlet.task
+    static constexpr uint32_t MeshletsPerTaskGroup = 32;
+
     /// Create a mesh builder
     static Builder create(LogicalDevice* device);
     static Builder create(LogicalDevice& device);
@@ -106,15 +142,64 @@ public:
         return fromOBJ(device.get(), path, commandPool, attrs);
     }
 
-    /// Get vertex buffer
+    /// Extension of binary mesh caches written beside their source OBJ
+    static constexpr const char* CacheExtension = ".fvkmesh";
+
+    /**
+     * @brief Load a binary mesh cache written by Builder::writeCache()
+     *
+     * The file is memory-mapped and its packed vertex and index data copied
+     * straight into one staging buffer; nothing is parsed or deduplicated.
+     * Attributes and index type are the ones stored in the file.
+     */
+    static MeshRef fromCache(LogicalDevice* device, const std::string& path, CommandPool* commandPool);
+    static MeshRef fromCache(LogicalDevice& device, const std::string& path, CommandPool& commandPool) {
+        return fromCache(&device, path, &commandPool);
+    }
+    static MeshRef fromCache(const LogicalDevicePtr& device, const std::string& path, CommandPool* commandPool) {
+        return fromCache(device.get(), path, commandPool);
+    }
+
+    /**
+     * @brief Load a mesh cache already in memory (e.g. a mapped AssetPack entry)
+     *
+     * Copies from bytes straight into staging; bytes must be 8-byte aligned.
+     * @throws std::runtime_error if bytes are not a valid mesh cache
+     */
+    static MeshRef fromCache(LogicalDevice* device, ByteSpan bytes, CommandPool* commandPool);
+
+    /**
+     * @brief Load a mesh entry (AssetPack::Kind::Mesh, a mesh cache) of an asset pack
+     * @throws std::runtime_error if the entry is missing, of another kind or invalid
+     */
+    static MeshRef fromPack(LogicalDevice* device, const AssetPack& pack, const std::string& name,
+                            CommandPool* commandPool);
+    static MeshRef fromPack(const LogicalDevicePtr& device, const AssetPack& pack, const std::string& name,
+                            CommandPool* commandPool) {
+        return fromPack(device.get(), pack, name, commandPool);
+    }
+
+    /// Get vertex buffer (may be shared with other meshes of a MeshBatch)
     Buffer* vertexBuffer() const { return vertexBuffer_.get(); }
 
-    /// Get index buffer
+    /// Get index buffer (may be shared with other meshes of a MeshBatch)
     Buffer* indexBuffer() const { return indexBuffer_.get(); }
 
-    /// Get number of indices
+    /// Byte offset of this mesh's vertices within vertexBuffer() (a multiple of the stride)
+    VkDeviceSize vertexOffset() const { return vertexOffset_; }
+
+    /// Byte offset of this mesh's indices within indexBuffer()
+    VkDeviceSize indexOffset() const { return indexOffset_; }
+
+    /// Get number of indices (level 0)
     uint32_t indexCount() const { return indexCount_; }
 
+    /// Number of detail levels (1 without Builder::generateLods())
+    uint32_t lodCount() const { return static_cast<uint32_t>(lods_.size()); }
+
+    /// Index range of a detail level; level 0 is the full mesh
+    const Lod& lod(uint32_t level) const { return lods_[std::min(level, lodCount() - 1)]; }
+
     /// Get index type (16 or 32 bit)
     VkIndexType indexType() const { return indexType_; }
 
@@ -130,11 +215,50 @@ public:
     /// Get bounding box center
     glm::vec3 center() const { return (boundsMin_ + boundsMax_) * 0.5f; }
 
+    /**
+     * @brief Maps VertexAttribute::QuantizedPosition values back to object space
+     *
+     * Scale and offset from the unit cube to the bounds; identity for float
+     * positions. Apply to positions only (model * dequantizeTransform()),
+     * since the non-uniform scale would skew normals.
+     */
+    glm::mat4 dequantizeTransform() const;
+
     /// Bind mesh to command buffer
     void bind(CommandBuffer& cmd) const;
 
-    /// Draw mesh
-    void draw(CommandBuffer& cmd, uint32_t instanceCount = 1) const;
+    /// Draw mesh (firstInstance offsets instance-rate vertex attributes)
+    void draw(CommandBuffer& cmd, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+
+    /// Draw one detail level (clamped to the coarsest)
+    void drawLod(CommandBuffer& cmd, uint32_t level, uint32_t instanceCount = 1,
+                 uint32_t firstInstance = 0) const;
+
+    /// True if built with Builder::meshlets() on a device with mesh shading
+    bool hasMeshlets() const { return meshletCount_ > 0; }
+
+    /// Number of meshlets (0 without meshlets)
+    uint32_t meshletCount() const { return meshletCount_; }
+
+    /// GpuMeshlet per meshlet (storage buffer; nullptr without meshlets)
+    Buffer* meshletBuffer() const { return meshletBuffer_.get(); }
+
+    /**
+     * @brief Meshlet vertex and triangle data (storage buffer; nullptr without meshlets)
+     *
+     * One uint per meshlet vertex (index into the mesh's vertices), then one
+     * uint per triangle packing three local indices (bits 0-7, 8-15, 16-23).
+     * GpuMeshlet offsets index this array of words.
+     */
+    Buffer* meshletDataBuffer() const { return meshletDataBuffer_.get(); }
+
+    /**
+     * @brief Draw through the task/mesh pipeline, one task workgroup per MeshletsPerTaskGroup
+     *
+     * Falls back to bind() + draw() without meshlets, matching the vertex
+     * fallback of GraphicsPipeline::Builder::meshShader().
+     */
+    void drawMeshlets(CommandBuffer& cmd) const;
 
     /// Destructor
     ~Mesh() = default;
@@ -151,13 +275,21 @@ private:
     friend class Builder;
     Mesh() = default;
 
-    BufferPtr vertexBuffer_;
-    BufferPtr indexBuffer_;
+    std::shared_ptr<Buffer> vertexBuffer_;
+    std::shared_ptr<Buffer> indexBuffer_;
+    VkDeviceSize vertexOffset_ = 0;
+    VkDeviceSize indexOffset_ = 0;
     uint32_t indexCount_ = 0;
     VkIndexType indexType_ = VK_INDEX_TYPE_UINT16;
     VertexAttribute attributes_ = VertexAttribute::Position;
     glm::vec3 boundsMin_{0.0f};
     glm::vec3 boundsMax_{0.0f};
+    std::vector<Lod> lods_;
+
+    std::shared_ptr<Buffer> meshletBuffer_;
+    std::shared_ptr<Buffer> meshletDataBuffer_;
+    uint32_t meshletCount_ = 0;
+    PFN_vkCmdDrawMeshTasksEXT cmdDrawMeshTasks_ = nullptr;
 };
 
 /**
@@ -176,12 +308,66 @@ public:
     /// Force 32-bit indices
     Builder& use32BitIndices(bool use = true);
 
+    /**
+     * @brief Cache the loaded OBJ beside it as "<path>.fvkmesh" (load() only)
+     *
+     * Later builds map the cache instead of parsing the OBJ. It is rebuilt
+     * when the source is newer or was cached with other attributes or index
+     * width.
+     */
+    Builder& cache(bool enable = true);
+
+    /**
+     * @brief Reorder triangles and vertices at build time (default: false)
+     *
+     * Runs MeshOptimizer's vertex cache, overdraw and vertex fetch passes.
+     * Unreferenced vertices are dropped. Needs a triangle list. The ACMR
+     * before and after is logged and available from acmrBefore()/acmrAfter().
+     */
+    Builder& optimize(bool enable = true);
+
+    /**
+     * @brief Generate simplified detail levels at build time (default: 1, none)
+     *
+     * Level i aims for reduction^i of the triangles of level 0, simplified
+     * from level 0 by MeshOptimizer::simplify() and appended to the same
+     * index buffer; all levels share the vertices. Generation stops early
+     * when a level would exceed maxError (relative to the bounding radius)
+     * or barely shrinks. Needs a triangle list.
+     */
+    Builder& generateLods(uint32_t levels = 4, float reduction = 0.5f, float maxError = 0.1f);
+
+    /**
+     * @brief Split level 0 into meshlets for mesh shader rendering (default: false)
+     *
+     * Only on devices with LogicalDevice::supportsMeshShading(); elsewhere
+     * this does nothing and Mesh::drawMeshlets() draws indexed. Meshlets
+     * carry bounding spheres and normal cones for task shader culling, and
+     * the vertex buffer becomes readable as a storage buffer. Combine with
+     * optimize() for compact meshlets. The bundled shaders/meshlet.task and
+     * meshlet.mesh expect the default limits and attributes. Builds with
+     * meshlets don't read the binary mesh cache.
+     */
+    Builder& meshlets(bool enable = true, uint32_t maxVertices = 64, uint32_t maxTriangles = 124);
+
+    /// Average cache miss ratio before optimization (0 until optimize() ran)
+    float acmrBefore() const { return acmrBefore_; }
+
+    /// Average cache miss ratio after optimization (0 until optimize() ran)
+    float acmrAfter() const { return acmrAfter_; }
+
+    /// Write the packed mesh as a binary cache readable by Mesh::fromCache()
+    void writeCache(const std::string& path);
+
     /// Add a vertex, returns index
     uint32_t addVertex(const Vertex& v);
 
-    /// Add a vertex with automatic deduplication
+    /// Add a vertex with automatic deduplication (exact match on all fields)
     uint32_t addUniqueVertex(const Vertex& v);
 
+    /// Reserve space for expected vertex and index counts (also sizes the dedup table)
+    Builder& reserve(size_t vertices, size_t indices = 0);
+
     /// Add a triangle by indices
     Builder& addTriangle(uint32_t i0, uint32_t i1, uint32_t i2);
 
@@ -215,13 +401,65 @@ public:
     MeshRef build(CommandPool* commandPool = nullptr);
     MeshRef build(CommandPool& commandPool) { return build(&commandPool); }
 
+    /**
+     * @brief Build the mesh, queueing its uploads on an UploadManager
+     *
+     * Copies are not submitted until uploads.flush(); the mesh must not be
+     * drawn before the flush ticket completes.
+     */
+    MeshRef build(UploadManager& uploads);
+
+    /**
+     * @brief Build on a loader's worker threads
+     *
+     * OBJ parsing (or the cache read) and packing run on the loader's
+     * ThreadPool; the upload is batched with others by AssetLoader::update().
+     * The builder is copied, so it can be reused or dropped right away.
+     */
+    std::shared_ptr<AsyncAsset<Mesh>> buildAsync(AssetLoader& loader) const;
+
 private:
     friend class Mesh;
+    friend class MeshBatch;
+    friend class AssetLoader;
+    friend class StaticBatch;
     Builder(LogicalDevice* device, CommandPool* commandPool, const std::string& path);
 
-    void packVertexData(std::vector<float>& packed) const;
+    /// CPU-side result of building, ready for upload
+    struct PackedData {
+        std::vector<uint8_t> vertices;
+        std::vector<uint8_t> indices;  // uint16 or uint32 depending on indexType
+        VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+        uint32_t indexCount = 0;       // All levels
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        std::vector<Mesh::Lod> lods;   // At least level 0
+        std::vector<Mesh::GpuMeshlet> meshlets;
+        std::vector<uint32_t> meshletData;  // Vertex indices, then packed triangles
+
+        VkDeviceSize vertexBytes() const { return vertices.size(); }
+    };
+
+    PackedData pack();
+    MeshRef upload(const PackedData& packed, UploadManager& uploads) const;
+    bool readCache(PackedData& packed) const;
+    MeshRef finish(const PackedData& packed,
+                   std::shared_ptr<Buffer> vertexBuffer, VkDeviceSize vertexOffset,
+                   std::shared_ptr<Buffer> indexBuffer, VkDeviceSize indexOffset) const;
+
+    void packVertexData(std::vector<uint8_t>& packed, const glm::vec3& boundsMin,
+                        const glm::vec3& boundsMax) const;
     void calculateBounds(glm::vec3& minBounds, glm::vec3& maxBounds) const;
     void loadOBJ(const std::string& path);
+    void optimizeIndices();
+    void buildLods(PackedData& packed, std::vector<uint32_t>& indices) const;
+    void buildMeshlets(PackedData& packed) const;
+    bool wantsMeshlets() const;
+    std::string cachePath() const { return loadPath_ + CacheExtension; }
+    bool openCache(MappedFile& file) const;
+    static void writeCache(const PackedData& packed, VertexAttribute attrs, uint32_t flags,
+                           const std::string& path);
+    uint32_t cacheFlags() const;
 
     LogicalDevice* device_;
     CommandPool* commandPool_ = nullptr;  // For load() path
@@ -231,12 +469,92 @@ private:
                             VertexAttribute::TexCoord;
     bool deduplicate_ = false;
     bool use32BitIndices_ = false;
+    bool cache_ = false;
+    bool optimize_ = false;
+    uint32_t lodLevels_ = 1;
+    float lodReduction_ = 0.5f;
+    float lodMaxError_ = 0.1f;
+    bool meshlets_ = false;
+    uint32_t meshletVertices_ = 64;
+    uint32_t meshletTriangles_ = 124;
+    float acmrBefore_ = 0.0f;
+    float acmrAfter_ = 0.0f;
 
     std::vector<Vertex> vertices_;
     std::vector<uint32_t> indices_;
 
-    // For deduplication
-    std::unordered_map<size_t, uint32_t> vertexMap_;
+    // For deduplication: open addressing with linear probing, power-of-two
+    // capacity. Keeps the hash so probes rarely compare whole vertices.
+    struct DedupSlot {
+        uint32_t index = UINT32_MAX;  // UINT32_MAX = empty
+        uint32_t hash = 0;
+    };
+    void growDedupTable(size_t vertices);
+
+    std::vector<DedupSlot> dedupSlots_;
+    size_t dedupCount_ = 0;
+};
+
+/**
+ * @brief Builds many meshes with one upload submission
+ *
+ * OBJ parsing and vertex packing run on worker threads, then all vertex and
+ * index data is uploaded in a single submission. By default every mesh is
+ * sub-allocated from one shared vertex buffer and one shared index buffer.
+ * Mesh::bind() applies the per-mesh offsets, so callers draw as usual.
+ *
+ * Usage:
+ * @code
+ * MeshBatch batch(device);
+ * for (const auto& path : paths) {
+ *     batch.add(Mesh::load(device, pool, path));
+ * }
+ * std::vector<MeshRef> meshes = batch.build(pool);
+ * @endcode
+ */
+class MeshBatch {
+public:
+    explicit MeshBatch(LogicalDevice* device);
+    explicit MeshBatch(LogicalDevice& device) : MeshBatch(&device) {}
+    explicit MeshBatch(const LogicalDevicePtr& device) : MeshBatch(device.get()) {}
+
+    /// Share one vertex and one index buffer between all meshes (default: true)
+    MeshBatch& sharedBuffers(bool enable = true);
+
+    /// Worker threads for CPU-side preparation (0 = hardware concurrency)
+    MeshBatch& threads(uint32_t count);
+
+    /// Add a builder; returns its index in the result of build()
+    size_t add(Mesh::Builder builder);
+
+    /// Number of builders queued
+    size_t size() const { return builders_.size(); }
+
+    /**
+     * @brief Build all meshes through an UploadManager and flush it
+     *
+     * Returns immediately; ticket() completes when the data is on the GPU.
+     */
+    std::vector<MeshRef> build(UploadManager& uploads);
+
+    /// Build all meshes with one staging buffer and one blocking submission
+    std::vector<MeshRef> build(CommandPool* commandPool);
+    std::vector<MeshRef> build(CommandPool& commandPool) { return build(&commandPool); }
+
+    /// Ticket of the last build(UploadManager&) flush
+    const SubmitTicket& ticket() const { return ticket_; }
+
+private:
+    using UploadFn = std::function<void(Buffer&, const void*, VkDeviceSize, VkDeviceSize)>;
+
+    std::vector<Mesh::Builder::PackedData> packAll();
+    std::vector<MeshRef> createMeshes(const UploadFn& upload);
+
+    LogicalDevice* device_;
+    bool sharedBuffers_ = true;
+    uint32_t threads_ = 0;
+    std::vector<Mesh::Builder> builders_;
+    SubmitTicket ticket_;
 };
 
 // Inline overloads (defined after Builder is complete)
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "finevk/high/mesh.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief Index and vertex reordering for faster triangle-list rendering
+ *
+ * The passes are meant to run in order: vertex cache, then overdraw, then
+ * vertex fetch. Mesh::Builder::optimize() runs all three at build time, and
+ * Mesh::Builder::generateLods() uses simplify() for its detail levels.
+ *
+ * buildMeshlets() splits a triangle list for Mesh::Builder::meshlets().
+ *
+ * Usage:
+ * @code
+ * float before = MeshOptimizer::acmr(indices, vertices.size());
+ * MeshOptimizer::optimizeVertexCache(indices, vertices.size());
+ * MeshOptimizer::optimizeOverdraw(indices, vertices);
+ * MeshOptimizer::optimizeVertexFetch(indices, vertices);
+ * float after = MeshOptimizer::acmr(indices, vertices.size());
+ * @endcode
+ */
+namespace MeshOptimizer {
+
+/// FIFO cache size used for ACMR measurements and overdraw clustering
+constexpr uint32_t DefaultCacheSize = 16;
+
+/**
+ * @brief Average cache miss ratio: vertex shader invocations per triangle
+ *
+ * Simulates a FIFO post-transform cache. 3.0 means no reuse; well ordered
+ * dense meshes reach 0.6-0.7.
+ */
+float acmr(const std::vector<uint32_t>& indices, size_t vertexCount,
+           uint32_t cacheSize = DefaultCacheSize);
+
+/**
+ * @brief Reorder triangles for post-transform cache reuse (Forsyth)
+ *
+ * Greedily emits the triangle whose vertices score highest, favouring
+ * vertices recently used (modelled as a 32-entry LRU cache) and
+ * vertices with few triangles left. Linear in the triangle count.
+ */
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+/**
+ * @brief Reorder clusters of triangles so likely occluders draw first
+ *
+ * Splits the cache-ordered list into clusters wherever that costs little
+ * cache reuse, then sorts clusters by how far they face away from the mesh
+ * centre. The result is kept only if ACMR grows by at most threshold
+ * (1.05 = 5%). Run after optimizeVertexCache().
+ */
+void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                      float threshold = 1.05f);
+
+/**
+ * @brief Renumber vertices in first-use order so vertex fetch is sequential
+ *
+ * Reorders vertices to match and drops vertices no index refers to. Run
+ * last, since it changes vertex numbering but not triangle order.
+ */
+void optimizeVertexFetch(std::vector<uint32_t>& indices, std::vector<Vertex>& vertices);
+
+/**
+ * @brief Reduce the triangle count by quadric error edge collapse
+ *
+ * Vertices are collapsed onto neighbours rather than moved, so the result
+ * indexes the same vertex array and can share its vertex buffer. Vertices on
+ * open borders, non-manifold edges and attribute seams (several vertices at
+ * one position) never move, which keeps outlines and UV charts intact.
+ * Collapses that would flip a triangle are skipped.
+ *
+ * Stops at targetIndexCount or when the next collapse would move the
+ * surface by more than maxError (object space), whichever comes first.
+ *
+ * @param resultError Receives the largest error of any collapse made
+ * @return The simplified triangle list
+ */
+std::vector<uint32_t> simplify(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                               size_t targetIndexCount, float maxError, float* resultError = nullptr);
+
+/// One meshlet: ranges into Meshlets::vertices and Meshlets::triangles
+struct Meshlet {
+    uint32_t vertexOffset = 0;
+    uint32_t triangleOffset = 0;    ///< In triangles (3 local indices each)
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+};
+
+/**
+ * @brief Culling data of one meshlet
+ *
+ * The meshlet is entirely back-facing from camera position c when
+ * dot(center - c, coneAxis) >= coneCutoff * length(center - c) + radius.
+ * A cutoff of 1 means the normals spread too far to ever cull.
+ */
+struct MeshletBounds {
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+    glm::vec3 coneAxis{0.0f, 0.0f, 1.0f};
+    float coneCutoff = 1.0f;
+};
+
+/// Result of buildMeshlets()
+struct Meshlets {
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;    ///< One per meshlet
+    std::vector<uint32_t> vertices;       ///< Mesh vertex indices, per meshlet
+    std::vector<uint8_t> triangles;       ///< Indices into the meshlet's vertices
+};
+
+/// Meshlet limits that fit mesh shader output limits on all vendors
+constexpr uint32_t DefaultMeshletVertices = 64;
+constexpr uint32_t DefaultMeshletTriangles = 124;
+
+/**
+ * @brief Split a triangle list into meshlets for mesh shader rendering
+ *
+ * Triangles are taken in order and a new meshlet starts whenever the next
+ * one would exceed either limit, so run optimizeVertexCache() first for
+ * compact meshlets. maxVertices is at most 256.
+ */
+Meshlets buildMeshlets(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                       uint32_t maxVertices = DefaultMeshletVertices,
+                       uint32_t maxTriangles = DefaultMeshletTriangles);
+
+} // namespace MeshOptimizer
+
+} // namespace finevk
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/command.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandPool;
+class Image;
+
+/**
+ * @brief Compute-shader mip chain generation in a single dispatch per image
+ *
+ * Replaces one blit and one barrier per level with mip_downsample.comp:
+ * each workgroup reduces a 64x64 tile through six levels in shared memory,
+ * and the last workgroup to finish (found with an atomic counter) reduces
+ * the remaining levels, so one dispatch writes up to 12 levels (4096x4096
+ * down to 1x1). Larger images take one extra dispatch per 6 levels.
+ *
+ * Many images can be recorded into one command buffer with a single pair
+ * of layout barriers, e.g. after a batched UploadManager flush that only
+ * uploaded level 0 of each. Images must be RGBA8 (UNORM or sRGB), created
+ * with RequiredUsage and requiredFlags(format).
+ *
+ * Usage:
+ * @code
+ * auto mipShader = ShaderModule::fromFile(device, "shaders/mip_downsample.comp.spv");
+ * auto mips = MipGenerator::create(device).shader(mipShader).build();
+ *
+ * for (auto& image : images) {
+ *     uploads->uploadImage(*image, pixels, size);   // Level 0 only
+ * }
+ * uploads->flush();
+ * SubmitTicket ticket = mips->generate(graphicsPool, imagePointers);
+ * @endcode
+ */
+class MipGenerator {
+public:
+    /**
+     * @brief Builder for creating MipGenerator objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Compiled mip_downsample.comp (required)
+        Builder& shader(ShaderModule* module);
+        Builder& shader(const ShaderModulePtr& module) { return shader(module.get()); }
+
+        /// Build the generator
+        MipGeneratorPtr build();
+
+    private:
+        LogicalDevice* device_;
+        ShaderModule* shader_ = nullptr;
+    };
+
+    /// Create a builder for a mip generator
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /// Levels a single dispatch can write
+    static constexpr uint32_t MaxLevelsPerDispatch = 12;
+
+    /// Usage images need on top of TRANSFER_DST and SAMPLED
+    static constexpr VkImageUsageFlags RequiredUsage = VK_IMAGE_USAGE_STORAGE_BIT;
+
+    /// Create flags images of this format need (MUTABLE_FORMAT for sRGB)
+    static VkImageCreateFlags requiredFlags(VkFormat format);
+
+    /// Check whether an image can be processed (single-layer, format, usage and flags)
+    bool supports(const Image& image) const;
+
+    /// GPU resources of one recording; keep alive until the submission completes
+    struct Batch;
+    using BatchRef = std::shared_ptr<Batch>;
+
+    /**
+     * @brief Record mip generation for several images into one command buffer
+     *
+     * Level 0 of each image must hold data in oldLayout; all other levels
+     * are overwritten. Every level ends in finalLayout. Images with a single
+     * level are skipped. Must be recorded outside a render pass on a queue
+     * with compute support.
+     *
+     * @return Resources the commands reference; release after completion
+     *         (e.g. SubmitTicket::keepAlive)
+     */
+    BatchRef record(CommandBuffer& cmd, const std::vector<Image*>& images,
+                    VkImageLayout oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /**
+     * @brief Generate mips for several images in one submission (non-blocking)
+     *
+     * The default oldLayout matches UploadManager::uploadImage().
+     */
+    SubmitTicket generate(CommandPool* pool, const std::vector<Image*>& images,
+                          VkImageLayout oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    /// Destructor
+    ~MipGenerator();
+
+    // Non-copyable
+    MipGenerator(const MipGenerator&) = delete;
+    MipGenerator& operator=(const MipGenerator&) = delete;
+
+private:
+    friend class Builder;
+    MipGenerator() = default;
+
+    /// Matches Params push constants in mip_downsample.comp
+    struct Params {
+        uint32_t levelCount;
+        uint32_t srgb;
+        uint32_t counterIndex;
+    };
+
+    /// One dispatch: levels base+1 .. base+count of an image
+    struct Pass {
+        Image* image;
+        uint32_t base;
+        uint32_t count;
+        uint32_t round;  // Passes of one image run in successive rounds
+    };
+
+    static std::vector<Pass> planPasses(const std::vector<Image*>& images);
+
+    LogicalDevice* device_ = nullptr;
+    bool storageSupported_ = false;  // RGBA8 UNORM storage images
+    DescriptorSetLayoutPtr setLayout_;
+    PipelineLayoutPtr pipelineLayout_;
+    ComputePipelinePtr pipeline_;
+};
+
+} // namespace finevk
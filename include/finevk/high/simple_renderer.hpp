@@ -4,6 +4,10 @@
 #include "finevk/window/window.hpp"
 #include "finevk/high/mesh.hpp"
 #include "finevk/high/uniform_buffer.hpp"
+#include "finevk/high/image_readback.hpp"
+#include "finevk/device/gpu_profiler.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/logical_device.hpp"
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
@@ -23,6 +27,8 @@ class RenderPass;
 class GraphicsPipeline;
 class CommandPool;
 class CommandBuffer;
+class FrameCommandPools;
+class SubmitBatch;
 class SwapChainFramebuffers;
 class DescriptorSetLayout;
 class DescriptorPool;
@@ -49,6 +55,37 @@ enum class MSAALevel {
 struct RendererConfig {
     bool enableDepthBuffer = true;
     MSAALevel msaa = MSAALevel::Off;  // Default: no MSAA for maximum compatibility
+
+    /// Frame-ring mode: one transient pool per frame in flight (and per
+    /// recording thread), reset wholesale once the frame's fence signals,
+    /// instead of resetting individual command buffers
+    bool frameCommandPools = false;
+
+    /// Recording threads served by the frame pools (frame-ring mode only)
+    uint32_t recordingThreads = 1;
+
+    /// Time the frame on the GPU: a GpuProfiler is attached to the frame's
+    /// command buffer, so CommandBuffer::beginScope() calls are recorded
+    bool gpuProfiling = false;
+
+    /// Also count pipeline statistics (vertex and fragment invocations)
+    /// over each frame; implies gpuProfiling. The device needs
+    /// LogicalDeviceBuilder::enablePipelineStatistics()
+    bool pipelineStatistics = false;
+};
+
+/**
+ * @brief Per-frame rendering counters
+ *
+ * commands covers the frame's main command buffer, plus every buffer handed
+ * out by acquireCommandBuffer() in frame-ring mode. The GPU figures come
+ * from the profiler and lag by framesInFlight frames (0 without it).
+ */
+struct RenderStats {
+    CommandStats commands;
+    double gpuMilliseconds = 0.0;
+    PipelineStatistics pipeline;        ///< Valid if hasPipelineStatistics
+    bool hasPipelineStatistics = false;
 };
 
 /**
@@ -123,9 +160,57 @@ public:
     /// Get the command pool (device's default pool)
     CommandPool* commandPool() const { return commandPool_; }
 
-    /// Get frames in flight count
+    /// Get the per-frame pools (nullptr unless RendererConfig::frameCommandPools)
+    FrameCommandPools* frameCommandPools() const { return framePools_.get(); }
+
+    /// Get the frame's GPU profiler (nullptr unless RendererConfig::gpuProfiling)
+    GpuProfiler* gpuProfiler() const { return gpuProfiler_.get(); }
+
+    /// Readback ring delivered by beginFrame() (created on first use)
+    ImageReadback& readback();
+
+    /// Counters of the last frame ended by endFrame()
+    const RenderStats& frameStats() const { return frameStats_; }
+
+    /**
+     * @brief Hand out another command buffer for the current frame
+     *
+     * Frame-ring mode only. Buffers come from the frame's pool for the given
+     * recording thread and stay valid until this frame slot comes around
+     * again. Secondaries are executed by the caller; primaries must be
+     * recorded by the caller and are submitted by endFrame() ahead of the
+     * frame's main command buffer. Primaries must be acquired on the
+     * render thread.
+     */
+    CommandBuffer& acquireCommandBuffer(uint32_t thread = 0,
+        VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    /**
+     * @brief Make the current frame's submission wait for a timeline point
+     *
+     * For work on other queues the frame consumes, e.g. an AsyncCompute
+     * batch: the frame waits at stages, so earlier stages still overlap.
+     * Applies to the frame in progress only.
+     */
+    void waitFor(const TimelinePoint& point, VkPipelineStageFlags2KHR stages);
+
+    /**
+     * @brief Work submitted together with the current frame
+     *
+     * endFrame() submits this batch and the frame in one call. Command
+     * buffers added here run ahead of the frame and don't wait for the swap
+     * chain image, so graphics-queue uploads or compute join the frame's
+     * submission instead of taking their own. Applies to the frame in
+     * progress only.
+     */
+    SubmitBatch& submission();
+
+    /// Get frames in flight count (may change at runtime, see LogicalDevice::setFramesInFlight())
     uint32_t framesInFlight() const;
 
+    /// Frame slots to size per-frame resources for
+    uint32_t maxFramesInFlight() const;
+
     /// Get current frame index (0 to framesInFlight-1)
     uint32_t currentFrame() const;
 
@@ -160,8 +245,11 @@ public:
      * Must be called after beginFrame() and before drawing.
      *
      * @param clearColor Color to clear the framebuffer to
+     * @param contents Use VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS when
+     *        drawing through secondaries (e.g. parallel RenderAgent::render)
      */
-    void beginRenderPass(const glm::vec4& clearColor = {0.0f, 0.0f, 0.0f, 1.0f});
+    void beginRenderPass(const glm::vec4& clearColor = {0.0f, 0.0f, 0.0f, 1.0f},
+                         VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
     /**
      * @brief End the render pass
@@ -197,7 +285,8 @@ public:
     /**
      * @brief Get the default sampler
      *
-     * Creates a trilinear filtered sampler with anisotropic filtering.
+     * A trilinear filtered sampler with anisotropic filtering, shared
+     * through the device's SamplerCache.
      */
     Sampler* defaultSampler();
 
@@ -220,6 +309,7 @@ private:
     void createDepthResources();
     void createFramebuffers();
     void recreateResources();
+    void retireResources();
     void cleanupResources();
     VkSampleCountFlagBits selectMsaaSamples(MSAALevel level);
 
@@ -230,6 +320,7 @@ private:
     // Core objects owned by SimpleRenderer
     RenderPassPtr renderPass_;
     std::unique_ptr<SwapChainFramebuffers> framebuffers_;
+    uint64_t swapChainGeneration_ = 0;  // Swap chain framebuffers_ were built for
 
     // Non-owning reference to device's default command pool
     CommandPool* commandPool_ = nullptr;
@@ -247,11 +338,20 @@ private:
     // Frame state
     uint32_t currentImageIndex_ = 0;
     std::vector<CommandBufferPtr> commandBuffers_;
+    std::unique_ptr<FrameCommandPools> framePools_;  // Frame-ring mode
+    CommandBuffer* frameCmd_ = nullptr;              // Main command buffer of the current frame
+    std::vector<VkCommandBuffer> extraPrimaries_;    // Submitted before frameCmd_
+    std::vector<TimelinePoint> frameWaits_;          // Timeline waits of the current frame
+    std::vector<VkPipelineStageFlags2KHR> frameWaitStages_;
+    std::unique_ptr<SubmitBatch> frameSubmit_;       // Cleared by each submission
+    GpuProfilerPtr gpuProfiler_;                     // Records into frameCmd_ only
+    ImageReadbackPtr readback_;
+    RenderStats frameStats_;
     bool frameInProgress_ = false;
     std::optional<FrameInfo> currentFrameInfo_;
 
     // Default resources
-    SamplerPtr defaultSampler_;
+    SamplerRef defaultSampler_;  // From the device's SamplerCache
 
     // Device destruction callback registration
     size_t deviceDestructionCallbackId_ = 0;
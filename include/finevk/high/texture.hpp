@@ -1,23 +1,37 @@
 #pragma once
 
 #include "finevk/core/types.hpp"
+#include "finevk/core/span.hpp"
 #include "finevk/device/image.hpp"
 
 #include <vulkan/vulkan.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace finevk {
 
 class LogicalDevice;
 class CommandPool;
 class Buffer;
+class Sampler;
+class BindlessTable;
+class MipGenerator;
+class AssetPack;
+class AssetLoader;
+template<typename T> class AsyncAsset;
+struct TextureContainer;
+struct ByteSpan;
 
 /**
  * @brief High-level texture abstraction combining Image and ImageView
  *
  * Provides convenient loading from files and memory with automatic
- * staging buffer management and optional mipmap generation.
+ * staging buffer management and optional mipmap generation. On devices
+ * built with LogicalDeviceBuilder::enableHostImageCopy(), supported formats
+ * skip the staging buffer and queue submit: texels are copied from host
+ * memory straight into the image (mips filtered on the CPU unless a
+ * MipGenerator is given).
  *
  * Usage (builder pattern - recommended):
  * @code
@@ -59,17 +73,20 @@ public:
     /**
      * @brief Load texture from file (legacy API)
      * @param device Logical device
-     * @param path Path to image file (supports PNG, JPEG, TGA, BMP, etc.)
+     * @param path Path to image file (supports PNG, JPEG, TGA, BMP, etc.;
+     *             .ktx2/.dds keep their own format and baked mips)
      * @param commandPool Command pool for upload operations
      * @param generateMipmaps Generate mipmap chain
      * @param srgb Use sRGB format (gamma-correct)
+     * @param mipGenerator Generate mips with one compute dispatch instead of blits
      */
     static TextureRef fromFile(
         LogicalDevice* device,
         const std::string& path,
         CommandPool* commandPool,
         bool generateMipmaps = true,
-        bool srgb = true);
+        bool srgb = true,
+        MipGenerator* mipGenerator = nullptr);
     static TextureRef fromFile(LogicalDevice& device, const std::string& path, CommandPool& commandPool, bool generateMipmaps = true, bool srgb = true) {
         return fromFile(&device, path, &commandPool, generateMipmaps, srgb);
     }
@@ -86,6 +103,7 @@ public:
      * @param commandPool Command pool for upload operations
      * @param generateMipmaps Generate mipmap chain
      * @param srgb Use sRGB format (gamma-correct)
+     * @param mipGenerator Generate mips with one compute dispatch instead of blits
      */
     static TextureRef fromMemory(
         LogicalDevice* device,
@@ -94,7 +112,8 @@ public:
         uint32_t height,
         CommandPool* commandPool,
         bool generateMipmaps = true,
-        bool srgb = true);
+        bool srgb = true,
+        MipGenerator* mipGenerator = nullptr);
     static TextureRef fromMemory(LogicalDevice& device, const void* data, uint32_t width, uint32_t height, CommandPool& commandPool, bool generateMipmaps = true, bool srgb = true) {
         return fromMemory(&device, data, width, height, &commandPool, generateMipmaps, srgb);
     }
@@ -102,6 +121,78 @@ public:
         return fromMemory(device.get(), data, width, height, commandPool, generateMipmaps, srgb);
     }
 
+    /**
+     * @brief Create a texture from a parsed KTX2/DDS container
+     *
+     * Uploads every baked mip level as stored, so block-compressed data stays
+     * compressed in VRAM. Throws if the device can't sample the format with
+     * linear filtering.
+     */
+    static TextureRef fromContainer(
+        LogicalDevice* device,
+        const TextureContainer& container,
+        CommandPool* commandPool);
+    static TextureRef fromContainer(LogicalDevice& device, const TextureContainer& container, CommandPool& commandPool) {
+        return fromContainer(&device, container, &commandPool);
+    }
+    static TextureRef fromContainer(const LogicalDevicePtr& device, const TextureContainer& container, CommandPool* commandPool) {
+        return fromContainer(device.get(), container, commandPool);
+    }
+
+    /**
+     * @brief Decode an encoded image (PNG, JPEG, TGA, BMP, ...) held in memory
+     *
+     * Decodes straight from the bytes, e.g. a mapped AssetPack entry.
+     */
+    static TextureRef fromEncoded(
+        LogicalDevice* device,
+        ByteSpan bytes,
+        CommandPool* commandPool,
+        bool generateMipmaps = true,
+        bool srgb = true,
+        MipGenerator* mipGenerator = nullptr);
+
+    /**
+     * @brief Load a texture entry of an asset pack
+     *
+     * KTX2/DDS entries upload their baked levels from the mapping (mip
+     * options are ignored, as for fromFile()); other entries are decoded
+     * with fromEncoded().
+     *
+     * @throws std::runtime_error if the entry is missing or not AssetPack::Kind::Texture
+     */
+    static TextureRef fromPack(
+        LogicalDevice* device,
+        const AssetPack& pack,
+        const std::string& name,
+        CommandPool* commandPool,
+        bool generateMipmaps = true,
+        bool srgb = true,
+        MipGenerator* mipGenerator = nullptr);
+    static TextureRef fromPack(const LogicalDevicePtr& device, const AssetPack& pack, const std::string& name,
+                               CommandPool* commandPool, bool generateMipmaps = true, bool srgb = true) {
+        return fromPack(device.get(), pack, name, commandPool, generateMipmaps, srgb);
+    }
+
+    /**
+     * @brief Load the first variant of an asset whose format the device supports
+     *
+     * Only file headers are read to decide, e.g.:
+     * @code
+     * auto rock = Texture::fromCompressedVariants(device,
+     *     {"rock.bc7.ktx2", "rock.astc.ktx2", "rock.etc2.ktx2"}, commandPool);
+     * @endcode
+     * @throws std::runtime_error if no candidate can be sampled
+     */
+    static TextureRef fromCompressedVariants(
+        LogicalDevice* device,
+        const std::vector<std::string>& paths,
+        CommandPool* commandPool,
+        bool srgb = true);
+    static TextureRef fromCompressedVariants(const LogicalDevicePtr& device, const std::vector<std::string>& paths, CommandPool* commandPool, bool srgb = true) {
+        return fromCompressedVariants(device.get(), paths, commandPool, srgb);
+    }
+
     /**
      * @brief Create a 1x1 solid color texture
      */
@@ -131,25 +222,53 @@ public:
     /// Get number of mip levels
     uint32_t mipLevels() const { return image_->mipLevels(); }
 
+    /// Get number of array layers (TextureArrayBuilder textures have several)
+    uint32_t layers() const { return image_->arrayLayers(); }
+
     /// Get texture format
     VkFormat format() const { return image_->format(); }
 
-    /// Destructor
-    ~Texture() = default;
+    /**
+     * @brief Add this texture to a bindless table
+     *
+     * Calling again with the same table rewrites the slot (e.g. a new
+     * sampler); a different table moves the texture there. The slot is
+     * removed when the texture is destroyed, so table must outlive it; don't
+     * also removeTexture() the index yourself.
+     *
+     * @return The texture's array index (also available as bindlessIndex())
+     */
+    uint32_t registerBindless(BindlessTable& table, Sampler* sampler);
+
+    /// Index in the bindless table registered with (UINT32_MAX if none)
+    uint32_t bindlessIndex() const { return bindlessIndex_; }
+
+    /// Destructor - returns the bindless slot, if any
+    ~Texture();
 
     // Non-copyable
     Texture(const Texture&) = delete;
     Texture& operator=(const Texture&) = delete;
 
     // Movable
-    Texture(Texture&&) noexcept = default;
-    Texture& operator=(Texture&&) noexcept = default;
+    Texture(Texture&& other) noexcept;
+    Texture& operator=(Texture&& other) noexcept;
 
 private:
+    friend class TextureStreamer;
+    friend class AssetLoader;
+    friend class TextureArrayBuilder;
+    friend class TextureAtlasBuilder;
     Texture() = default;
 
+    void releaseBindless() noexcept;
+
     ImagePtr image_;
     ImageViewPtr view_;
+
+    // Bindless registration (not owned)
+    BindlessTable* bindlessTable_ = nullptr;
+    uint32_t bindlessIndex_ = UINT32_MAX;
 };
 
 /**
@@ -163,11 +282,26 @@ public:
     /// Use sRGB format for gamma-correct rendering (default: false)
     Builder& srgb(bool enable = true);
 
+    /// Generate mipmaps with a compute MipGenerator instead of blits
+    Builder& mipGenerator(MipGenerator* generator);
+
     /// Build the texture
     TextureRef build();
 
+    /**
+     * @brief Build on a loader's worker threads
+     *
+     * File reads, decoding and mip generation (a CPU box filter, so
+     * mipGenerator() is not used) run on the loader's ThreadPool; the upload
+     * is batched with others by AssetLoader::update(), or done on the worker
+     * with a host image copy where supported. Memory sources are copied
+     * before this returns.
+     */
+    std::shared_ptr<AsyncAsset<Texture>> buildAsync(AssetLoader& loader) const;
+
 private:
     friend class Texture;
+    friend class AssetLoader;
 
     // Constructor for file loading
     Builder(LogicalDevice* device, CommandPool* commandPool, const std::string& path);
@@ -193,6 +327,7 @@ private:
     // Options
     bool generateMipmaps_ = false;
     bool srgb_ = false;
+    MipGenerator* mipGenerator_ = nullptr;
 };
 
 // Inline definitions (after Builder is complete)
@@ -220,7 +355,35 @@ inline Texture::Builder Texture::load(const LogicalDevicePtr& device, CommandPoo
 uint32_t calculateMipLevels(uint32_t width, uint32_t height);
 
 /**
- * @brief Generate mipmaps for an image using blitting
+ * @brief Next mip level of a tightly packed RGBA8 image on the CPU
+ *
+ * 2x2 box filter; odd edges reuse the last row/column. For loaders that
+ * build the mip chain off the render thread (TextureStreamer, AssetLoader).
+ */
+std::vector<uint8_t> downsampleRGBA8(const std::vector<uint8_t>& src, uint32_t width, uint32_t height);
+
+/**
+ * @brief True if uploadFromHost() can create textures of this format
+ *
+ * Needs LogicalDeviceBuilder::enableHostImageCopy() and a format the device
+ * host-copies without slowing sampling. Safe to call from any thread.
+ */
+bool canUploadFromHost(LogicalDevice* device, VkFormat format);
+
+/**
+ * @brief Create a sampled 2D image filled straight from host memory
+ *
+ * The VK_EXT_host_image_copy path of Texture::fromMemory(), fromContainer(),
+ * AssetLoader and TextureStreamer: levels[i] is mip i, tightly packed, and
+ * the image is left in SHADER_READ_ONLY_OPTIMAL. No staging buffer, command
+ * buffer or submit, so a worker thread can do it right after decoding.
+ * Check canUploadFromHost() first.
+ */
+ImagePtr uploadFromHost(LogicalDevice* device, VkFormat format, uint32_t width, uint32_t height,
+                        Span<const void* const> levels);
+
+/**
+ * @brief Generate mipmaps for an image using blitting (all array layers)
  */
 void generateMipmaps(
     CommandPool* commandPool,
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandPool;
+
+/**
+ * @brief Packs many same-sized RGBA8 images into the layers of one texture
+ *
+ * All layers go up in a single staging buffer and copy, and the result is
+ * one image, one view and one descriptor (sampler2DArray) for all of them,
+ * so meshes using different layers can share a material and batch into
+ * one draw. The handle returned by add() is the layer index.
+ *
+ * Usage:
+ * @code
+ * TextureArrayBuilder blocks(device, 16, 16);
+ * uint32_t grass = blocks.addFile("grass.png");
+ * uint32_t stone = blocks.addFile("stone.png");
+ * TextureRef blockArray = blocks.generateMipmaps().build(commandPool);
+ * // Shader: texture(blockTextures, vec3(uv, layer))
+ * @endcode
+ */
+class TextureArrayBuilder {
+public:
+    /// Every layer is width x height texels
+    TextureArrayBuilder(LogicalDevice* device, uint32_t width, uint32_t height);
+    TextureArrayBuilder(LogicalDevice& device, uint32_t width, uint32_t height)
+        : TextureArrayBuilder(&device, width, height) {}
+    TextureArrayBuilder(const LogicalDevicePtr& device, uint32_t width, uint32_t height)
+        : TextureArrayBuilder(device.get(), width, height) {}
+
+    /// Use sRGB format (default: true)
+    TextureArrayBuilder& srgb(bool enable = true);
+
+    /// Generate a mip chain for every layer (default: false)
+    TextureArrayBuilder& generateMipmaps(bool enable = true);
+
+    /// Add a layer from width x height RGBA8 texels (copied); returns its index
+    uint32_t add(const void* rgba);
+
+    /// Add a layer from an image file; throws if its size doesn't match
+    uint32_t addFile(const std::string& path);
+
+    /// Layers added so far
+    uint32_t layerCount() const { return static_cast<uint32_t>(layers_.size()); }
+
+    /// Upload all layers in one submission (waits for completion)
+    TextureRef build(CommandPool* commandPool);
+    TextureRef build(CommandPool& commandPool) { return build(&commandPool); }
+
+private:
+    LogicalDevice* device_;
+    uint32_t width_;
+    uint32_t height_;
+    bool srgb_ = true;
+    bool generateMipmaps_ = false;
+    std::vector<std::vector<uint8_t>> layers_;
+};
+
+/**
+ * @brief Packs RGBA8 images of any size into one atlas texture
+ *
+ * Images are shelf-packed (tallest first) into the smallest power-of-two
+ * square that fits, up to maxSize. Each image is surrounded by padding
+ * filled with its own edge texels so filtering doesn't bleed between
+ * neighbours; with mipmaps, the chain stops at the level where the padding
+ * would shrink below one texel. The whole atlas is uploaded with one copy.
+ *
+ * Usage:
+ * @code
+ * TextureAtlasBuilder atlas(device);
+ * uint32_t icon = atlas.addFile("icon.png");
+ * TextureRef texture = atlas.build(commandPool);
+ * const auto& rect = atlas.region(icon);   // rect.uvMin / rect.uvMax
+ * @endcode
+ */
+class TextureAtlasBuilder {
+public:
+    /// Placement of one image in the atlas
+    struct Region {
+        uint32_t x = 0;         ///< Texel offset of the image (inside its padding)
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        float uvMin[2] = {0.0f, 0.0f};
+        float uvMax[2] = {0.0f, 0.0f};
+    };
+
+    /// Largest atlas side in texels (default: 4096)
+    explicit TextureAtlasBuilder(LogicalDevice* device, uint32_t maxSize = 4096);
+    explicit TextureAtlasBuilder(LogicalDevice& device, uint32_t maxSize = 4096)
+        : TextureAtlasBuilder(&device, maxSize) {}
+    explicit TextureAtlasBuilder(const LogicalDevicePtr& device, uint32_t maxSize = 4096)
+        : TextureAtlasBuilder(device.get(), maxSize) {}
+
+    /// Use sRGB format (default: true)
+    TextureAtlasBuilder& srgb(bool enable = true);
+
+    /// Generate mipmaps, limited by the padding (default: false)
+    TextureAtlasBuilder& generateMipmaps(bool enable = true);
+
+    /// Edge texels around each image (default: 2)
+    TextureAtlasBuilder& padding(uint32_t texels);
+
+    /// Add an image from RGBA8 texels (copied); returns its handle
+    uint32_t add(const void* rgba, uint32_t width, uint32_t height);
+
+    /// Add an image from a file; returns its handle
+    uint32_t addFile(const std::string& path);
+
+    /// Images added so far
+    uint32_t count() const { return static_cast<uint32_t>(images_.size()); }
+
+    /// Pack and upload in one submission (waits for completion)
+    TextureRef build(CommandPool* commandPool);
+    TextureRef build(CommandPool& commandPool) { return build(&commandPool); }
+
+    /// Placement of an image; valid after build()
+    const Region& region(uint32_t handle) const { return regions_[handle]; }
+
+    /// Atlas side in texels; valid after build()
+    uint32_t size() const { return size_; }
+
+private:
+    struct Source {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> texels;
+    };
+
+    /// Shelf-pack every padded image into a side x side square
+    bool pack(uint32_t side, uint32_t align);
+
+    LogicalDevice* device_;
+    uint32_t maxSize_;
+    uint32_t padding_ = 2;
+    bool srgb_ = true;
+    bool generateMipmaps_ = false;
+    uint32_t size_ = 0;
+    std::vector<Source> images_;
+    std::vector<Region> regions_;
+};
+
+} // namespace finevk
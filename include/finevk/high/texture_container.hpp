@@ -0,0 +1,82 @@
+#pragma once
+
+#include "finevk/core/mapped_file.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief A 2D texture read from a KTX2 or DDS container with its baked mips
+ *
+ * Holds the file bytes (or, from fromView(), points at them) and, per mip
+ * level, where that level's tightly packed data lives in them, so
+ * block-compressed data (BC1-BC7, ETC2/EAC, ASTC) goes to the GPU as-is. Parsing is pure CPU work and safe on any
+ * thread. Only single-layer, single-face 2D images are accepted; KTX2
+ * supercompression (BasisLZ, Zstandard) must be resolved offline.
+ *
+ * Usage:
+ * @code
+ * auto container = TextureContainer::fromFile("textures/rock.ktx2");
+ * for (uint32_t i = 0; i < container.mipLevels(); i++) {
+ *     upload(container.levelData(i), container.levels[i].size);
+ * }
+ * @endcode
+ */
+struct TextureContainer {
+    struct Level {
+        size_t offset = 0;   // Into bytes
+        size_t size = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<Level> levels;   // Level 0 (largest) first
+    std::vector<uint8_t> bytes;
+    ByteSpan source;             // Non-owning file bytes when bytes is empty (fromView())
+
+    /// Number of mip levels in the file
+    uint32_t mipLevels() const { return static_cast<uint32_t>(levels.size()); }
+
+    /// Start of a level's data
+    const uint8_t* levelData(uint32_t level) const {
+        return (bytes.empty() ? source.data : bytes.data()) + levels[level].offset;
+    }
+
+    /// Total bytes of all levels
+    size_t dataSize() const;
+
+    /**
+     * @brief Load a .ktx2 or .dds file (detected by its magic bytes)
+     * @param srgb For legacy DDS FourCC formats, which don't record color space
+     * @throws std::runtime_error on I/O errors or unsupported content
+     */
+    static TextureContainer fromFile(const std::string& path, bool srgb = true);
+
+    /// Parse a container already in memory (takes ownership of the bytes)
+    static TextureContainer fromMemory(std::vector<uint8_t> bytes, bool srgb = true);
+
+    /**
+     * @brief Parse a container in place (e.g. an AssetPack entry)
+     *
+     * Nothing is copied; the bytes must outlive the container.
+     */
+    static TextureContainer fromView(ByteSpan bytes, bool srgb = true);
+
+    /// Check whether bytes start with a KTX2 or DDS header (by their magic bytes)
+    static bool isContainerData(ByteSpan bytes);
+
+    /// Read only the header of a .ktx2 or .dds file and return its format
+    static VkFormat peekFormat(const std::string& path, bool srgb = true);
+
+    /// Check whether a path names a KTX2 or DDS file (by extension)
+    static bool isContainerPath(const std::string& path);
+};
+
+} // namespace finevk
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/image.hpp"
+
+#include <vulkan/vulkan.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandPool;
+class ThreadPool;
+
+/**
+ * @brief A texture that is still loading
+ *
+ * texture() returns the streamer's placeholder until the real image has
+ * been decoded and uploaded, then the real texture. Owned by the caller
+ * through a shared_ptr; the streamer only touches it from update().
+ */
+class StreamedTexture {
+public:
+    /// Current texture: the placeholder until isReady()
+    const TextureRef& texture() const { return ready_ ? texture_ : placeholder_; }
+
+    /// True once the real texture is in place
+    bool isReady() const { return ready_; }
+
+    /// True if decoding failed (texture() stays the placeholder)
+    bool failed() const { return failed_; }
+
+    /// Source path
+    const std::string& path() const { return path_; }
+
+    /**
+     * @brief Run a callback from TextureStreamer::update() once the real texture is in place
+     *
+     * Use it to rewrite descriptors that captured the placeholder (respecting
+     * frames still in flight). Runs immediately if already ready.
+     */
+    void onReady(std::function<void(const TextureRef&)> callback);
+
+private:
+    friend class TextureStreamer;
+
+    std::string path_;
+    TextureRef placeholder_;
+    TextureRef texture_;
+    bool ready_ = false;
+    bool failed_ = false;
+    std::vector<std::function<void(const TextureRef&)>> callbacks_;
+};
+
+using StreamedTextureRef = std::shared_ptr<StreamedTexture>;
+
+/**
+ * @brief Loads textures in the background without stalling frames
+ *
+ * load() returns immediately with a StreamedTexture showing a placeholder.
+ * A ThreadPool worker decodes the file and builds the mip chain on the CPU
+ * (box filter), so the graphics queue never runs blits for it. update(),
+ * called once per frame on the render thread, hands decoded images to the
+ * UploadManager (dedicated transfer queue when the device has one) up to a
+ * per-frame byte budget, and swaps finished uploads in.
+ *
+ * On devices built with LogicalDeviceBuilder::enableHostImageCopy(), the
+ * worker copies supported formats straight into the image as well (see
+ * uploadFromHost()); update() then swaps those in without an upload or
+ * any of the frame budget.
+ *
+ * Usage:
+ * @code
+ * auto streamer = TextureStreamer::create(device, uploads.get())
+ *     .frameBudget(8 * 1024 * 1024)
+ *     .build();
+ *
+ * auto albedo = streamer->load("textures/rock.png");
+ * material->setTexture(1, albedo->texture(), sampler);   // placeholder for now
+ * albedo->onReady([&](const TextureRef& t) { pendingRebinds.push_back(t); });
+ *
+ * // Once per frame on the render thread
+ * streamer->update();
+ * @endcode
+ */
+class TextureStreamer {
+public:
+    /**
+     * @brief Builder for creating TextureStreamer objects
+     */
+    class Builder {
+    public:
+        Builder(LogicalDevice* device, UploadManager* uploads);
+
+        /// Bytes handed to the UploadManager per update() (default: 8 MiB)
+        Builder& frameBudget(VkDeviceSize bytes);
+
+        /// Pool for decode jobs (default: ThreadPool::global())
+        Builder& threads(ThreadPool* pool);
+
+        /// Texture shown while loading (default: 1x1 mid grey)
+        Builder& placeholder(TextureRef texture);
+
+        /// Command pool for creating the default placeholder (default: device pool)
+        Builder& commandPool(CommandPool* pool);
+
+        /// Build the streamer
+        TextureStreamerPtr build();
+
+    private:
+        LogicalDevice* device_;
+        UploadManager* uploads_;
+        VkDeviceSize frameBudget_ = 8 * 1024 * 1024;
+        ThreadPool* threads_ = nullptr;
+        TextureRef placeholder_;
+        CommandPool* commandPool_ = nullptr;
+    };
+
+    /// Create a builder for a texture streamer
+    static Builder create(LogicalDevice* device, UploadManager* uploads);
+    static Builder create(const LogicalDevicePtr& device, UploadManager* uploads) {
+        return create(device.get(), uploads);
+    }
+
+    /**
+     * @brief Start loading a texture file
+     * @param path Image file (PNG, JPEG, TGA, BMP, ... via stb_image), or a
+     *             .ktx2/.dds file uploaded in its stored format with its baked mips
+     * @param srgb Use an sRGB format
+     * @param generateMipmaps Build the full mip chain on the decode thread (stb_image files)
+     */
+    StreamedTextureRef load(const std::string& path, bool srgb = true, bool generateMipmaps = true);
+
+    /**
+     * @brief Per-frame step (render thread)
+     *
+     * Swaps in completed uploads (running onReady callbacks), then queues
+     * decoded images for upload until the frame budget is spent. One image
+     * larger than the budget is still queued when nothing else was this
+     * frame, so big textures can't starve.
+     */
+    void update();
+
+    /// Block until every requested texture is ready or failed (loading screens, shutdown)
+    void waitIdle();
+
+    /// Textures requested but not yet ready or failed
+    size_t pendingCount() const { return pending_; }
+
+    /// Bytes queued for upload by the last update()
+    VkDeviceSize lastFrameBytes() const { return lastFrameBytes_; }
+
+    /// Per-frame upload budget
+    VkDeviceSize frameBudget() const { return frameBudget_; }
+
+    /// Texture shown while loading
+    const TextureRef& placeholder() const { return placeholder_; }
+
+    /// Destructor - waits for uploads in flight, drops unfinished decodes
+    ~TextureStreamer();
+
+    // Non-copyable
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+private:
+    friend class Builder;
+    TextureStreamer() = default;
+
+    // Output of a decode job: mip chain, level 0 first
+    struct Decoded {
+        StreamedTextureRef target;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        bool srgb = true;
+        VkFormat format = VK_FORMAT_UNDEFINED;  // From a KTX2/DDS file; else RGBA8
+
+        std::vector<std::vector<uint8_t>> mips;
+        ImagePtr image;  // Already filled by a host image copy (mips then empty)
+        VkDeviceSize bytes = 0;
+        bool failed = false;
+    };
+
+    // Shared with decode jobs so they never touch a destroyed streamer
+    struct Inbox {
+        std::mutex mutex;
+        std::deque<Decoded> decoded;
+        bool closed = false;
+        size_t hostCopies = 0;  // Jobs writing into images; the destructor waits for them
+        std::condition_variable idle;
+    };
+
+    struct Upload {
+        StreamedTextureRef target;
+        ImagePtr image;
+        SubmitTicket ticket;
+    };
+
+    void startUpload(Decoded& decoded);
+    void finish(Upload& upload);
+    bool canSample(VkFormat format) const;
+
+    LogicalDevice* device_ = nullptr;
+    UploadManager* uploads_ = nullptr;
+    ThreadPool* threads_ = nullptr;
+    TextureRef placeholder_;
+    VkDeviceSize frameBudget_ = 0;
+    VkDeviceSize lastFrameBytes_ = 0;
+    size_t pending_ = 0;
+
+    std::shared_ptr<Inbox> inbox_;
+    std::deque<Decoded> waiting_;  // Decoded, over this frame's budget
+    std::vector<Upload> uploading_;
+};
+
+} // namespace finevk
@@ -2,17 +2,17 @@
 
 #include "finevk/core/types.hpp"
 #include "finevk/device/buffer.hpp"
+#include "finevk/device/logical_device.hpp"
 
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <cstring>
 
 namespace finevk {
 
-class LogicalDevice;
-
 /**
  * @brief Type-safe uniform buffer with per-frame copies
  *
@@ -28,16 +28,20 @@ public:
     /**
      * @brief Create uniform buffers for each frame in flight
      * @param device Logical device
-     * @param frameCount Number of frames in flight (typically 2-3)
+     * @param frameCount Per-frame copies (default 0: LogicalDevice::maxFramesInFlight())
      */
     static std::unique_ptr<UniformBuffer<T>> create(
         LogicalDevice* device,
-        uint32_t frameCount = 2) {
+        uint32_t frameCount = 0) {
 
+        if (frameCount == 0) {
+            frameCount = device->maxFramesInFlight();
+        }
         auto ub = std::unique_ptr<UniformBuffer<T>>(new UniformBuffer<T>());
         ub->device_ = device;
         ub->frameCount_ = frameCount;
         ub->buffers_.reserve(frameCount);
+        ub->versions_.assign(frameCount, 0);
 
         for (uint32_t i = 0; i < frameCount; i++) {
             auto buffer = Buffer::createUniformBuffer(device, sizeof(T));
@@ -56,7 +60,27 @@ public:
         if (frameIndex >= frameCount_) {
             return;
         }
-        std::memcpy(buffers_[frameIndex]->mappedPtr(), &data, sizeof(T));
+        buffers_[frameIndex]->upload(&data, sizeof(T));
+        versions_[frameIndex] = 0;
+    }
+
+    /**
+     * @brief Update a frame's copy unless it already holds this version
+     *
+     * For data derived from a versioned source such as CameraState::version:
+     * each frame copy remembers the version it was last written with, so a
+     * still camera costs no copies once every frame in flight has caught up.
+     * Feed a buffer from one source only; version 0 always uploads.
+     *
+     * @return True if the data was uploaded
+     */
+    bool update(uint32_t frameIndex, const T& data, uint64_t version) {
+        if (frameIndex >= frameCount_ || (version != 0 && versions_[frameIndex] == version)) {
+            return false;
+        }
+        buffers_[frameIndex]->upload(&data, sizeof(T));
+        versions_[frameIndex] = version;
+        return true;
     }
 
     /**
@@ -105,6 +129,7 @@ private:
     LogicalDevice* device_ = nullptr;
     uint32_t frameCount_ = 0;
     std::vector<BufferPtr> buffers_;
+    std::vector<uint64_t> versions_;  // Source version each copy holds (0: unversioned)
 };
 
 /**
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+#include "finevk/device/buffer.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <cstring>
+
+namespace finevk {
+
+class LogicalDevice;
+class DescriptorWriter;
+
+/**
+ * @brief Per-frame linear allocator for dynamic uniform data
+ *
+ * One persistently mapped buffer split into a region per frame in flight.
+ * Each frame, allocations bump a pointer through that frame's region,
+ * aligned to minUniformBufferOffsetAlignment. The returned offset is the
+ * dynamic offset for a VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC binding,
+ * so per-draw data costs a memcpy and an offset instead of a buffer and a
+ * descriptor update.
+ *
+ * Usage:
+ * @code
+ * auto ring = UniformRing::create(device).frameSize(4 * 1024 * 1024).build();
+ *
+ * // Once: binding declared as UNIFORM_BUFFER_DYNAMIC, range = one object
+ * DescriptorWriter writer(device);
+ * ring->write(writer, set, 0, sizeof(ObjectData));
+ * writer.update();
+ *
+ * // Per frame (after the frame's fence has signaled)
+ * ring->beginFrame(frameIndex);
+ * for (auto& object : objects) {
+ *     uint32_t offset = ring->push(object.data);
+ *     cmd.bindDescriptorSet(layout, set, 0, offset);
+ *     mesh->draw(cmd);
+ * }
+ * ring->flush();
+ * @endcode
+ */
+class UniformRing {
+public:
+    /**
+     * @brief Builder for creating UniformRing objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Bytes available per frame (default: 1 MiB)
+        Builder& frameSize(VkDeviceSize bytes);
+
+        /// Number of frame regions (default: the device's maxFramesInFlight())
+        Builder& framesInFlight(uint32_t count);
+
+        /// Build the ring
+        UniformRingPtr build();
+
+    private:
+        LogicalDevice* device_;
+        VkDeviceSize frameSize_ = 1024 * 1024;
+        uint32_t framesInFlight_ = 0;
+    };
+
+    /// Create a builder for a uniform ring
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /**
+     * @brief Sub-range handed out by allocate()
+     *
+     * offset is from the start of the buffer, ready to pass as a dynamic offset.
+     */
+    struct Allocation {
+        void* data = nullptr;
+        uint32_t offset = 0;
+        VkDeviceSize size = 0;
+    };
+
+    /**
+     * @brief Start writing a frame's region
+     *
+     * Call once per frame after the frame's fence has signaled; everything
+     * allocated for this slot last time around is discarded.
+     */
+    void beginFrame(uint32_t frameIndex);
+
+    /**
+     * @brief Allocate size bytes in the current frame's region
+     * @throws std::runtime_error if the region is exhausted
+     */
+    Allocation allocate(VkDeviceSize size);
+
+    /**
+     * @brief Make this frame's writes visible to the GPU
+     *
+     * Flushes what was allocated since beginFrame() or the last flush();
+     * call once after the frame's writes, before submitting. A no-op when
+     * the ring landed in coherent memory.
+     */
+    void flush();
+
+    /// Copy data into a new allocation; returns its dynamic offset
+    template<typename T>
+    uint32_t push(const T& data) {
+        Allocation allocation = allocate(sizeof(T));
+        std::memcpy(allocation.data, &data, sizeof(T));
+        return allocation.offset;
+    }
+
+    /**
+     * @brief Queue a UNIFORM_BUFFER_DYNAMIC write of this ring
+     *
+     * The descriptor covers range bytes at offset 0; the dynamic offset
+     * selects the object at bind time. range must not exceed
+     * maxUniformBufferRange.
+     */
+    void write(DescriptorWriter& writer, VkDescriptorSet set, uint32_t binding,
+               VkDeviceSize range) const;
+
+    /// Descriptor info for a UNIFORM_BUFFER_DYNAMIC binding (offset 0, given range)
+    VkDescriptorBufferInfo descriptorInfo(VkDeviceSize range) const;
+
+    /// The backing buffer
+    Buffer* buffer() const { return buffer_.get(); }
+
+    /// Allocation alignment (minUniformBufferOffsetAlignment)
+    VkDeviceSize alignment() const { return alignment_; }
+
+    /// Bytes per frame region
+    VkDeviceSize frameSize() const { return frameSize_; }
+
+    /// Bytes allocated so far this frame
+    VkDeviceSize used() const { return head_ - frameStart_; }
+
+    /// Number of frame regions
+    uint32_t framesInFlight() const { return framesInFlight_; }
+
+    /// Destructor
+    ~UniformRing() = default;
+
+    // Non-copyable
+    UniformRing(const UniformRing&) = delete;
+    UniformRing& operator=(const UniformRing&) = delete;
+
+private:
+    friend class Builder;
+    UniformRing() = default;
+
+    BufferPtr buffer_;
+    uint8_t* mapped_ = nullptr;
+    VkDeviceSize alignment_ = 256;
+    VkDeviceSize frameSize_ = 0;
+    uint32_t framesInFlight_ = 0;
+    VkDeviceSize frameStart_ = 0;
+    VkDeviceSize head_ = 0;
+    VkDeviceSize flushed_ = 0;  // Everything before this in the frame region has been flushed
+};
+
+} // namespace finevk
@@ -0,0 +1,304 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandBuffer;
+class ThreadPool;
+
+/**
+ * @brief Software virtual texture: page table, physical page cache and GPU feedback
+ *
+ * A virtual texture is a huge square mip-mapped image split into pages. Only
+ * the pages the camera actually samples live in VRAM, in a fixed-size cache
+ * texture (an atlas of page slots), so memory is bounded by the cache size
+ * rather than the asset size.
+ *
+ * - Indirection texture: R8G8B8A8_UINT, one texel per virtual page per mip,
+ *   holding (slot x, slot y, resident level, valid). Pages that aren't
+ *   resident point at their nearest resident ancestor, so sampling falls
+ *   back to a coarser level instead of failing.
+ * - Feedback: shaders (shaders/virtual_texture.glsl) append the pages they
+ *   wanted to a per-frame host-visible buffer, deduplicated with a per-page
+ *   frame stamp. update() reads the list once the frame's fence signaled.
+ * - Streaming: missing pages are produced by a PageProvider on a ThreadPool
+ *   worker (disk read, decode, procedural generation, ...), then copied into
+ *   least-recently-used cache slots on the render thread, a bounded number
+ *   per frame. The single top-level page is pinned.
+ *
+ * Pages are stored with a border of neighbouring texels so bilinear
+ * filtering never bleeds across slots. Sampling writes storage buffers from
+ * fragment shaders, so the device needs fragmentStoresAndAtomics.
+ *
+ * Usage:
+ * @code
+ * auto terrain = VirtualTexture::create(device)
+ *     .virtualSize(65536)
+ *     .pageSize(128, 4)
+ *     .cacheSlots(32, 32)
+ *     .provider([&](const VirtualTexture::PageRequest& page, uint8_t* texels) {
+ *         return tiles.read(page.level, page.x, page.y, texels);
+ *     })
+ *     .build();
+ *
+ * // Per frame, after the frame's fence, outside the render pass
+ * terrain->update(cmd, frameIndex);
+ * terrain->bind(cmd, pipelineLayout, 2, frameIndex);
+ * @endcode
+ */
+class VirtualTexture {
+public:
+    /// A page to produce: level 0 is the finest
+    struct PageRequest {
+        uint32_t level;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    /**
+     * @brief Fills one page including its border
+     *
+     * Writes slotSize() x slotSize() RGBA8 texels, row-major, covering the
+     * page's texels at its level plus border() texels on every side (clamp
+     * at the image edge). Level l is (virtual size >> l) texels wide. Called concurrently on worker threads. Return
+     * false if the page couldn't be produced; it is retried when requested again.
+     */
+    using PageProvider = std::function<bool(const PageRequest& page, uint8_t* texels)>;
+
+    /**
+     * @brief Builder for creating VirtualTexture objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Level 0 width and height in texels: pageSize times a power of two (required)
+        Builder& virtualSize(uint32_t texels);
+
+        /// Page size in texels and border texels per side (default: 128, 4)
+        Builder& pageSize(uint32_t texels, uint32_t border = 4);
+
+        /// Physical cache size in page slots, at most 256 each (default: 16 x 16)
+        Builder& cacheSlots(uint32_t columns, uint32_t rows);
+
+        /// Page texel format: RGBA8 sRGB or UNORM (default: sRGB)
+        Builder& srgb(bool enable = true);
+
+        /// Source of page texels (required)
+        Builder& provider(PageProvider provider);
+
+        /// Pool for provider jobs (default: ThreadPool::global())
+        Builder& threads(ThreadPool* pool);
+
+        /// Pages copied into the cache per update() (default: 16)
+        Builder& uploadsPerFrame(uint32_t count);
+
+        /// Distinct page requests kept per frame (default: 4096)
+        Builder& feedbackCapacity(uint32_t count);
+
+        /// Number of frames in flight (default: the device's maxFramesInFlight())
+        Builder& framesInFlight(uint32_t count);
+
+        /// Build the virtual texture
+        VirtualTexturePtr build();
+
+    private:
+        LogicalDevice* device_;
+        uint32_t size_ = 0;
+        uint32_t pageSize_ = 128;
+        uint32_t border_ = 4;
+        uint32_t cacheColumns_ = 16;
+        uint32_t cacheRows_ = 16;
+        bool srgb_ = true;
+        PageProvider provider_;
+        ThreadPool* threads_ = nullptr;
+        uint32_t uploadsPerFrame_ = 16;
+        uint32_t feedbackCapacity_ = 4096;
+        uint32_t framesInFlight_ = 0;
+    };
+
+    /// Create a builder for a virtual texture
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    /// Most mip levels a virtual texture can have (12-bit page coordinates)
+    static constexpr uint32_t MaxLevels = 13;
+
+    /**
+     * @brief Per-frame step (render thread, outside a render pass)
+     *
+     * Call after frameIndex's fence has signaled. Reads that frame's
+     * feedback, starts provider jobs for missing pages, records cache and
+     * indirection uploads into cmd and resets the feedback buffer for reuse.
+     */
+    void update(CommandBuffer& cmd, uint32_t frameIndex);
+
+    /// Bind the descriptor set for a frame (cache, indirection, params, feedback)
+    void bind(CommandBuffer& cmd, VkPipelineLayout pipelineLayout, uint32_t setIndex,
+              uint32_t frameIndex) const;
+
+    /// Descriptor set layout matching shaders/virtual_texture.glsl
+    DescriptorSetLayout* layout() const { return layout_.get(); }
+
+    /// Descriptor set for a frame in flight
+    VkDescriptorSet descriptorSet(uint32_t frameIndex) const { return frames_[frameIndex].set; }
+
+    /// Side of a cache slot in texels (page plus borders)
+    uint32_t slotSize() const { return pageSize_ + 2 * border_; }
+
+    /// Page size in texels (without border)
+    uint32_t pageSize() const { return pageSize_; }
+
+    /// Border texels on each side of a page
+    uint32_t border() const { return border_; }
+
+    /// Number of mip levels of the virtual image
+    uint32_t levelCount() const { return static_cast<uint32_t>(levels_.size()); }
+
+    /// Pages currently in the cache
+    size_t residentPages() const { return resident_.size(); }
+
+    /// Pages being produced by the provider
+    size_t pendingPages() const { return loading_.size(); }
+
+    /// Requests reported by the last update() (after deduplication)
+    size_t lastRequestCount() const { return lastRequests_; }
+
+    /// Physical cache texture
+    Image* cache() const { return cache_.get(); }
+
+    /// Indirection texture (one mip per virtual level)
+    Image* indirection() const { return indirection_.get(); }
+
+    /// Destructor - drops unfinished provider results
+    ~VirtualTexture();
+
+    // Non-copyable
+    VirtualTexture(const VirtualTexture&) = delete;
+    VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+private:
+    friend class Builder;
+    VirtualTexture() = default;
+
+    static constexpr uint32_t kNoPage = UINT32_MAX;
+
+    /// Matches VtParams in virtual_texture.glsl (std140)
+    struct Params {
+        glm::vec2 cacheSize;        // Texels
+        float virtualSize;          // Level 0 texels per side
+        uint32_t pageCount;         // Level 0 pages per side
+        uint32_t pageSize;
+        uint32_t border;
+        uint32_t levelCount;
+        uint32_t feedbackCapacity;
+        glm::uvec4 levelOffsets[4]; // Stamp index of each level's first page
+    };
+
+    /// Header of a feedback buffer, followed by feedbackCapacity packed pages
+    struct FeedbackHeader {
+        uint32_t count;
+        uint32_t frame;
+        uint32_t pad[2];
+    };
+
+    struct Level {
+        uint32_t pages;                // Per side
+        std::vector<uint32_t> table;   // Packed indirection texels
+        uint32_t dirtyMinX, dirtyMinY, dirtyMaxX, dirtyMaxY;  // Inclusive; min > max when clean
+    };
+
+    struct Slot {
+        uint32_t page = kNoPage;
+        uint64_t lastUsed = 0;
+        bool pinned = false;
+    };
+
+    struct Loaded {
+        uint32_t page;
+        std::vector<uint8_t> texels;
+        bool ok;
+    };
+
+    struct Upload {
+        uint32_t slot;
+        const uint8_t* texels;
+    };
+
+    // Shared with provider jobs so they never touch a destroyed texture
+    struct Inbox {
+        std::mutex mutex;
+        std::deque<Loaded> loaded;
+        bool closed = false;
+    };
+
+    struct Frame {
+        BufferPtr feedback;
+        BufferPtr staging;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+    };
+
+    static uint32_t pack(uint32_t level, uint32_t x, uint32_t y) { return (level << 24) | (y << 12) | x; }
+    static PageRequest unpack(uint32_t page) { return {page >> 24, page & 0xFFF, (page >> 12) & 0xFFF}; }
+
+    static uint32_t entry(uint32_t slotX, uint32_t slotY, uint32_t level) {
+        return slotX | (slotY << 8) | (level << 16) | (1u << 24);
+    }
+
+    void readFeedback(Frame& frame);
+    void startLoads();
+    bool touch(uint32_t page);
+    std::vector<uint32_t> collectSlots(size_t count);
+    void makeResident(uint32_t page, uint32_t slot);
+    void evict(uint32_t slot);
+    uint32_t resolve(uint32_t level, uint32_t x, uint32_t y) const;
+    void setEntries(uint32_t page, uint32_t match, uint32_t value);
+    void recordUploads(CommandBuffer& cmd, Buffer& staging, const std::vector<Upload>& uploads,
+                       bool initial);
+
+    LogicalDevice* device_ = nullptr;
+    PageProvider provider_;
+    ThreadPool* threads_ = nullptr;
+    uint32_t pageSize_ = 0;
+    uint32_t border_ = 0;
+    uint32_t cacheColumns_ = 0;
+    uint32_t uploadsPerFrame_ = 0;
+    uint32_t feedbackCapacity_ = 0;
+    uint32_t maxLoading_ = 0;
+    uint64_t frameCounter_ = 0;
+    size_t lastRequests_ = 0;
+
+    std::vector<Level> levels_;
+    std::vector<Slot> slots_;
+    std::unordered_map<uint32_t, uint32_t> resident_;  // Page -> slot
+    std::unordered_set<uint32_t> loading_;
+    std::vector<uint32_t> wanted_;                     // Missing pages seen in feedback
+    std::deque<Loaded> ready_;                         // Produced, waiting for a slot
+    std::shared_ptr<Inbox> inbox_;
+
+    ImagePtr cache_;
+    ImagePtr indirection_;
+    SamplerPtr cacheSampler_;
+    SamplerPtr indirectionSampler_;
+    BufferPtr params_;
+    BufferPtr stamps_;
+    DescriptorSetLayoutPtr layout_;
+    DescriptorPoolPtr pool_;
+    std::vector<Frame> frames_;
+};
+
+} // namespace finevk
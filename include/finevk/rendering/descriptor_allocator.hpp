@@ -0,0 +1,218 @@
+#pragma once
+
+#include "finevk/core/types.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class DescriptorSetLayout;
+class DescriptorPool;
+
+/**
+ * @brief Deduplicates descriptor set layouts by their bindings
+ *
+ * Identical binding lists (same binding numbers, types, counts and stages,
+ * in any order) map to one DescriptorSetLayout owned by the cache, so
+ * thousands of materials with the same shape share a layout handle and,
+ * through DescriptorAllocator, the same pools. Layouts with binding flags
+ * or immutable samplers are not cached; build those directly.
+ *
+ * Usage:
+ * @code
+ * DescriptorLayoutCache layouts(device);
+ * DescriptorSetLayout* layout = layouts.get({
+ *     {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+ *     {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr},
+ * });
+ * @endcode
+ */
+class DescriptorLayoutCache {
+public:
+    explicit DescriptorLayoutCache(LogicalDevice* device);
+    explicit DescriptorLayoutCache(LogicalDevice& device) : DescriptorLayoutCache(&device) {}
+    explicit DescriptorLayoutCache(const LogicalDevicePtr& device) : DescriptorLayoutCache(device.get()) {}
+
+    /// Get (creating on first use) the layout for these bindings; thread-safe
+    DescriptorSetLayout* get(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
+    /// Number of distinct layouts created
+    size_t size() const;
+
+    /// Destroy all cached layouts (none may still be in use)
+    void clear();
+
+    ~DescriptorLayoutCache();
+
+    // Non-copyable
+    DescriptorLayoutCache(const DescriptorLayoutCache&) = delete;
+    DescriptorLayoutCache& operator=(const DescriptorLayoutCache&) = delete;
+
+private:
+    LogicalDevice* device_;
+    mutable std::mutex mutex_;
+    std::map<std::vector<uint32_t>, DescriptorSetLayoutPtr> layouts_;
+};
+
+/**
+ * @brief Growable descriptor set allocator
+ *
+ * Persistent sets come from pools grouped by layout signature (the
+ * descriptor counts per type). Each pool is sized for a whole number of
+ * such sets, and a new, larger pool is created when the current ones
+ * return VK_ERROR_OUT_OF_POOL_MEMORY or VK_ERROR_FRAGMENTED_POOL, so
+ * exhaustion is never fatal. Persistent sets can be freed individually.
+ *
+ * Transient sets come from per-frame pools with general-purpose sizes;
+ * beginFrame() resets all of a frame's pools in one call, which is much
+ * cheaper than freeing sets one by one.
+ *
+ * Usage:
+ * @code
+ * auto descriptors = DescriptorAllocator::create(device).build();
+ *
+ * // Long-lived (e.g. per material)
+ * VkDescriptorSet set = descriptors->allocate(layout);
+ *
+ * // Per frame, after the frame's fence has signaled
+ * descriptors->beginFrame(frameIndex);
+ * VkDescriptorSet scratch = descriptors->allocateTransient(layout);
+ * @endcode
+ */
+class DescriptorAllocator {
+public:
+    /**
+     * @brief Builder for creating DescriptorAllocator objects
+     */
+    class Builder {
+    public:
+        explicit Builder(LogicalDevice* device);
+
+        /// Sets in the first pool of each layout signature (default: 16)
+        Builder& setsPerPool(uint32_t count);
+
+        /// Cap for pool growth; each new pool doubles until this (default: 1024)
+        Builder& maxSetsPerPool(uint32_t count);
+
+        /// Number of frames with transient pools (default: the device's maxFramesInFlight())
+        Builder& framesInFlight(uint32_t count);
+
+        /// Sets per transient pool (default: 256)
+        Builder& transientSetsPerPool(uint32_t count);
+
+        /// Build the allocator
+        DescriptorAllocatorPtr build();
+
+    private:
+        LogicalDevice* device_;
+        uint32_t setsPerPool_ = 16;
+        uint32_t maxSetsPerPool_ = 1024;
+        uint32_t framesInFlight_ = 0;
+        uint32_t transientSetsPerPool_ = 256;
+    };
+
+    /// Create a builder for a descriptor allocator
+    static Builder create(LogicalDevice* device);
+    static Builder create(LogicalDevice& device) { return create(&device); }
+    static Builder create(const LogicalDevicePtr& device) { return create(device.get()); }
+
+    // =========================================================================
+    // Persistent sets
+    // =========================================================================
+
+    /// Allocate a set that lives until free() or destruction; thread-safe
+    VkDescriptorSet allocate(DescriptorSetLayout* layout);
+    VkDescriptorSet allocate(DescriptorSetLayout& layout) { return allocate(&layout); }
+    VkDescriptorSet allocate(const DescriptorSetLayoutPtr& layout) { return allocate(layout.get()); }
+
+    /// Allocate count sets with the same layout
+    std::vector<VkDescriptorSet> allocate(DescriptorSetLayout* layout, uint32_t count);
+
+    /// Return a persistent set to its pool (the GPU must be done with it)
+    void free(VkDescriptorSet set);
+
+    /// Return several persistent sets
+    void free(const std::vector<VkDescriptorSet>& sets);
+
+    // =========================================================================
+    // Transient sets
+    // =========================================================================
+
+    /**
+     * @brief Reset the transient pools of a frame
+     *
+     * Call once per frame after the frame's fence has signaled; every set
+     * allocated with allocateTransient() for this slot becomes invalid.
+     */
+    void beginFrame(uint32_t frameIndex);
+
+    /// Allocate a set valid until this frame slot's next beginFrame(); thread-safe
+    VkDescriptorSet allocateTransient(DescriptorSetLayout* layout);
+    VkDescriptorSet allocateTransient(DescriptorSetLayout& layout) { return allocateTransient(&layout); }
+    VkDescriptorSet allocateTransient(const DescriptorSetLayoutPtr& layout) {
+        return allocateTransient(layout.get());
+    }
+
+    // =========================================================================
+    // Statistics
+    // =========================================================================
+
+    /// Pools created for persistent sets (all signatures)
+    size_t poolCount() const;
+
+    /// Pools created for transient sets (all frames)
+    size_t transientPoolCount() const;
+
+    /// Persistent sets currently allocated
+    size_t allocatedSets() const;
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    ~DescriptorAllocator();
+
+    // Non-copyable
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+private:
+    friend class Builder;
+    DescriptorAllocator() = default;
+
+    // Pools sharing one layout signature
+    struct PoolFamily {
+        std::vector<VkDescriptorPoolSize> perSet;  // Descriptor counts of one set
+        std::vector<DescriptorPoolPtr> pools;
+        size_t current = 0;
+        uint32_t nextSets = 0;  // Size of the next pool
+    };
+
+    struct FramePools {
+        std::vector<DescriptorPoolPtr> pools;
+        size_t current = 0;
+    };
+
+    static std::vector<uint32_t> signatureOf(const DescriptorSetLayout& layout);
+    DescriptorPoolPtr createFamilyPool(PoolFamily& family);
+    DescriptorPoolPtr createTransientPool();
+
+    LogicalDevice* device_ = nullptr;
+    uint32_t setsPerPool_ = 0;
+    uint32_t maxSetsPerPool_ = 0;
+    uint32_t transientSetsPerPool_ = 0;
+
+    mutable std::mutex mutex_;
+    std::map<std::vector<uint32_t>, PoolFamily> families_;
+    std::unordered_map<VkDescriptorSet, DescriptorPool*> owners_;  // Persistent set -> pool
+
+    std::vector<FramePools> frames_;
+    uint32_t frameIndex_ = 0;
+};
+
+} // namespace finevk
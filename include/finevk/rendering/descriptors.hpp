@@ -15,9 +15,14 @@ class Sampler;
 class PipelineLayout;
 class CommandBuffer;
 class SimpleRenderer;
+class DescriptorUpdateTemplate;
 
 /**
  * @brief Vulkan descriptor set layout wrapper
+ *
+ * On devices with Vulkan 1.1, build() also creates an update template over
+ * every binding (updateTemplate()), so sets of this layout can be rewritten
+ * from one packed array of DescriptorInfo in a single call.
  */
 class DescriptorSetLayout {
 public:
@@ -45,12 +50,26 @@ public:
         /// Add a storage image binding
         Builder& storageImage(uint32_t binding, VkShaderStageFlags stageFlags);
 
+        /**
+         * @brief Set descriptor indexing flags for a binding added earlier
+         *
+         * e.g. VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT. UPDATE_AFTER_BIND
+         * flags also need updateAfterBindPool() and a pool built with
+         * DescriptorPool::Builder::updateAfterBind().
+         */
+        Builder& bindingFlags(uint32_t binding, VkDescriptorBindingFlags flags);
+
+        /// Create the layout with VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT
+        Builder& updateAfterBindPool(bool enable = true);
+
         /// Build the descriptor set layout
         DescriptorSetLayoutPtr build();
 
     private:
         LogicalDevice* device_;
         std::vector<VkDescriptorSetLayoutBinding> bindings_;
+        std::vector<VkDescriptorBindingFlags> bindingFlags_;  // Parallel to bindings_
+        bool updateAfterBindPool_ = false;
     };
 
     /// Create a builder for a descriptor set layout
@@ -67,6 +86,9 @@ public:
     /// Get bindings for this layout (for pool auto-sizing)
     const std::vector<VkDescriptorSetLayoutBinding>& bindings() const { return bindings_; }
 
+    /// Update template over all bindings (nullptr if unsupported by the device or a binding type)
+    const DescriptorUpdateTemplate* updateTemplate() const { return updateTemplate_.get(); }
+
     /// Destructor
     ~DescriptorSetLayout();
 
@@ -87,6 +109,7 @@ private:
     LogicalDevice* device_ = nullptr;
     VkDescriptorSetLayout layout_ = VK_NULL_HANDLE;
     std::vector<VkDescriptorSetLayoutBinding> bindings_;  // Store for pool auto-sizing
+    DescriptorUpdateTemplatePtr updateTemplate_;
 };
 
 /**
@@ -110,6 +133,9 @@ public:
         /// Allow freeing individual descriptor sets
         Builder& allowFree(bool allow = true);
 
+        /// Allow sets from update-after-bind layouts (VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
+        Builder& updateAfterBind(bool enable = true);
+
         /// Build the descriptor pool
         DescriptorPoolPtr build();
 
@@ -118,6 +144,7 @@ public:
         uint32_t maxSets_ = 100;
         std::vector<VkDescriptorPoolSize> poolSizes_;
         bool allowFree_ = false;
+        bool updateAfterBind_ = false;
     };
 
     /// Create a builder for a descriptor pool
@@ -154,6 +181,15 @@ public:
     /// Allocate descriptor sets with different layouts
     std::vector<VkDescriptorSet> allocate(const std::vector<DescriptorSetLayout*>& layouts);
 
+    /**
+     * @brief Allocate without throwing
+     *
+     * Returns the vkAllocateDescriptorSets result, e.g.
+     * VK_ERROR_OUT_OF_POOL_MEMORY when the pool is exhausted.
+     */
+    VkResult tryAllocate(const VkDescriptorSetLayout* layouts, uint32_t count,
+                         VkDescriptorSet* out);
+
     /// Free a descriptor set (only if pool was created with allowFree)
     void free(VkDescriptorSet set);
 
@@ -183,6 +219,10 @@ private:
 
 /**
  * @brief Helper for writing descriptor sets
+ *
+ * Writes are collected and applied in one vkUpdateDescriptorSets. update()
+ * and clear() keep the storage, so a writer kept across frames stops
+ * allocating once it has seen its largest batch (or after reserve()).
  */
 class DescriptorWriter {
 public:
@@ -190,6 +230,9 @@ public:
     explicit DescriptorWriter(LogicalDevice& device) : DescriptorWriter(&device) {}
     explicit DescriptorWriter(const LogicalDevicePtr& device) : DescriptorWriter(device.get()) {}
 
+    /// Reserve storage for a batch of this many writes
+    DescriptorWriter& reserve(size_t writes);
+
     /// Write a buffer to a descriptor set
     DescriptorWriter& writeBuffer(VkDescriptorSet set, uint32_t binding,
                                   VkDescriptorType type,
@@ -219,15 +262,103 @@ public:
     void clear();
 
 private:
+    static constexpr uint32_t ImageInfoBit = 1u << 31;  // Set in infoIndices_ for image writes
+
     void fixupPointers();  // Fixup pointers after all writes are added
 
     LogicalDevice* device_;
     std::vector<VkWriteDescriptorSet> writes_;
     std::vector<VkDescriptorBufferInfo> bufferInfos_;
     std::vector<VkDescriptorImageInfo> imageInfos_;
-    // Track which info each write uses (index into bufferInfos_ or imageInfos_, -1 if not applicable)
-    std::vector<int> bufferInfoIndices_;
-    std::vector<int> imageInfoIndices_;
+    // Index of each write's info in bufferInfos_, or in imageInfos_ when ImageInfoBit is set
+    std::vector<uint32_t> infoIndices_;
+};
+
+/**
+ * @brief One descriptor in the packed array read by a DescriptorUpdateTemplate
+ */
+union DescriptorInfo {
+    VkDescriptorImageInfo image;    ///< Samplers, sampled/storage images, input attachments
+    VkDescriptorBufferInfo buffer;  ///< Uniform and storage buffers (dynamic or not)
+    VkBufferView texelBuffer;       ///< Uniform and storage texel buffers
+
+    DescriptorInfo() : image{} {}
+};
+
+/**
+ * @brief Descriptor update template over every binding of a layout
+ *
+ * Describes all of a layout's descriptors as one packed array of
+ * DescriptorInfo, element indexOf(binding, arrayElement) per descriptor.
+ * update() hands the whole array to vkUpdateDescriptorSetWithTemplate, so
+ * rewriting a set costs one call with no VkWriteDescriptorSet structures
+ * to build or pointers to fix up. Keep one array per set and change only
+ * the elements that differ.
+ *
+ * Every descriptor in the array is written, so all of them must be valid
+ * (or the binding must be PARTIALLY_BOUND). DescriptorSetLayout creates one
+ * for itself; see DescriptorSetLayout::updateTemplate().
+ *
+ * Usage:
+ * @code
+ * const DescriptorUpdateTemplate* tmpl = layout->updateTemplate();
+ * std::vector<DescriptorInfo> data(tmpl->descriptorCount());
+ * data[tmpl->indexOf(0)].buffer = {uniforms->handle(), 0, sizeof(Uniforms)};
+ * data[tmpl->indexOf(1)].image = {sampler->handle(), view->handle(),
+ *                                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+ * tmpl->update(set, data);
+ * @endcode
+ */
+class DescriptorUpdateTemplate {
+public:
+    /**
+     * @brief Create a template for a layout's bindings
+     * @throws std::runtime_error if unsupported (see isSupported())
+     */
+    static DescriptorUpdateTemplatePtr create(const DescriptorSetLayout* layout);
+    static DescriptorUpdateTemplatePtr create(const DescriptorSetLayout& layout) { return create(&layout); }
+    static DescriptorUpdateTemplatePtr create(const DescriptorSetLayoutPtr& layout) { return create(layout.get()); }
+
+    /// True if the device and every binding type can use templates
+    static bool isSupported(const LogicalDevice* device,
+                            const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
+    /// Get the Vulkan template handle
+    VkDescriptorUpdateTemplate handle() const { return template_; }
+
+    /// Elements in the packed array update() reads
+    uint32_t descriptorCount() const { return descriptorCount_; }
+
+    /**
+     * @brief Index of a descriptor in the packed array
+     * @throws std::runtime_error if the layout has no such binding or element
+     */
+    uint32_t indexOf(uint32_t binding, uint32_t arrayElement = 0) const;
+
+    /// Write every descriptor of set from data (descriptorCount() elements)
+    void update(VkDescriptorSet set, const DescriptorInfo* data) const;
+    void update(VkDescriptorSet set, const std::vector<DescriptorInfo>& data) const;
+
+    /// Destructor
+    ~DescriptorUpdateTemplate();
+
+    // Non-copyable
+    DescriptorUpdateTemplate(const DescriptorUpdateTemplate&) = delete;
+    DescriptorUpdateTemplate& operator=(const DescriptorUpdateTemplate&) = delete;
+
+private:
+    DescriptorUpdateTemplate() = default;
+
+    struct Range {
+        uint32_t binding;
+        uint32_t first;   // Index of the binding's element 0
+        uint32_t count;
+    };
+
+    LogicalDevice* device_ = nullptr;
+    VkDescriptorUpdateTemplate template_ = VK_NULL_HANDLE;
+    std::vector<Range> ranges_;  // Sorted by binding
+    uint32_t descriptorCount_ = 0;
 };
 
 /**
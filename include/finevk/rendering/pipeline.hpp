@@ -3,9 +3,14 @@
 #include "finevk/core/types.hpp"
 
 #include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
 
 namespace finevk {
 
@@ -34,6 +39,9 @@ public:
     /// Get the owning device
     LogicalDevice* device() const { return device_; }
 
+    /// Hash of the SPIR-V, so modules loaded twice from the same code share pipelines
+    uint64_t codeHash() const { return codeHash_; }
+
     /// Destructor
     ~ShaderModule();
 
@@ -52,8 +60,68 @@ private:
 
     LogicalDevice* device_ = nullptr;
     VkShaderModule module_ = VK_NULL_HANDLE;
+    uint64_t codeHash_ = 0;
+};
+
+/**
+ * @brief Specialization constant values for one shader stage
+ *
+ * Values for `layout(constant_id = N) const` declarations, fixed when the
+ * pipeline is built so the driver compiles loop counts and feature toggles
+ * as constants. One SPIR-V module then serves every variant instead of a
+ * permutation per combination. Every value is 4 bytes (GLSL int, uint,
+ * float, bool); setting an ID again replaces its value. Matching GLSL:
+ * @code
+ * layout(constant_id = 0) const uint LIGHT_COUNT = 4;
+ * layout(constant_id = 1) const bool USE_SHADOWS = true;
+ * @endcode
+ */
+class SpecializationConstants {
+public:
+    SpecializationConstants& set(uint32_t constantId, uint32_t value);
+    SpecializationConstants& set(uint32_t constantId, int32_t value);
+    SpecializationConstants& set(uint32_t constantId, float value);
+    SpecializationConstants& set(uint32_t constantId, bool value);  // Stored as VkBool32
+
+    /// Take every value from other, replacing IDs set in both
+    SpecializationConstants& merge(const SpecializationConstants& other);
+
+    bool empty() const { return entries_.empty(); }
+    size_t size() const { return entries_.size(); }
+
+    /// Info pointing into this object; valid while it lives unchanged
+    VkSpecializationInfo info() const;
+
+private:
+    SpecializationConstants& setRaw(uint32_t constantId, uint32_t bits);
+
+    std::vector<VkSpecializationMapEntry> entries_;
+    std::vector<uint32_t> data_;
 };
 
+/**
+ * @brief Standard per-draw push constant block
+ *
+ * Model matrix, object ID and bindless material index (see BindlessTable),
+ * pushed once per draw by RenderAgent when
+ * the layout declares it (PipelineLayout::Builder::addObjectPushConstants()).
+ * 80 bytes, well inside the 128 bytes every device guarantees. Matching GLSL:
+ * @code
+ * layout(push_constant) uniform ObjectPushConstants {
+ *     mat4 model;
+ *     uint objectId;
+ *     uint materialIndex;
+ * } object;
+ * @endcode
+ */
+struct ObjectPushConstants {
+    glm::mat4 model{1.0f};
+    uint32_t objectId = 0;
+    uint32_t materialIndex = 0;
+    uint32_t reserved[2] = {};  // Pads to a 16-byte multiple
+};
+static_assert(sizeof(ObjectPushConstants) == 80, "ObjectPushConstants must match the GLSL block");
+
 /**
  * @brief Vulkan pipeline layout wrapper
  */
@@ -73,6 +141,14 @@ public:
         Builder& addPushConstantRange(VkShaderStageFlags stages,
                                       uint32_t offset, uint32_t size);
 
+        /**
+         * @brief Declare the standard ObjectPushConstants block at offset 0
+         *
+         * Other push constant ranges must start at sizeof(ObjectPushConstants)
+         * or later.
+         */
+        Builder& addObjectPushConstants(VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT);
+
         /// Build the pipeline layout
         PipelineLayoutPtr build();
 
@@ -80,6 +156,7 @@ public:
         LogicalDevice* device_;
         std::vector<VkDescriptorSetLayout> setLayouts_;
         std::vector<VkPushConstantRange> pushConstantRanges_;
+        VkShaderStageFlags objectStages_ = 0;
     };
 
     /// Create a builder for a pipeline layout
@@ -114,6 +191,17 @@ public:
         vkCmdPushConstants(cmd, layout_, stages, offset, sizeof(T), &data);
     }
 
+    /// Stages the ObjectPushConstants block is visible to (0 if not declared)
+    VkShaderStageFlags objectPushConstantStages() const { return objectStages_; }
+
+    /// Check if the layout declares the standard ObjectPushConstants block
+    bool hasObjectPushConstants() const { return objectStages_ != 0; }
+
+    /// Push the standard per-draw block (layout must declare it)
+    void pushObject(VkCommandBuffer cmd, const ObjectPushConstants& object) const {
+        pushConstants(cmd, objectStages_, object);
+    }
+
     /// Destructor
     ~PipelineLayout();
 
@@ -133,6 +221,7 @@ private:
 
     LogicalDevice* device_ = nullptr;
     VkPipelineLayout layout_ = VK_NULL_HANDLE;
+    VkShaderStageFlags objectStages_ = 0;
 };
 
 /**
@@ -155,6 +244,36 @@ public:
         Builder& fragmentShader(ShaderModule& module, const char* entryPoint = "main") { return fragmentShader(&module, entryPoint); }
         Builder& fragmentShader(const ShaderModulePtr& module, const char* entryPoint = "main") { return fragmentShader(module.get(), entryPoint); }
 
+        /**
+         * @brief Task and mesh stages (VK_EXT_mesh_shader), used instead of the vertex stage
+         *
+         * If the device has mesh shading (LogicalDevice::supportsMeshShading()),
+         * build() uses these and ignores vertex input and input assembly.
+         * Otherwise it falls back to the vertex shader, so set both to run
+         * everywhere; see usesMeshShader(). The task stage is optional.
+         */
+        Builder& taskShader(ShaderModule* module, const char* entryPoint = "main");
+        Builder& taskShader(ShaderModule& module, const char* entryPoint = "main") { return taskShader(&module, entryPoint); }
+        Builder& taskShader(const ShaderModulePtr& module, const char* entryPoint = "main") { return taskShader(module.get(), entryPoint); }
+        Builder& meshShader(ShaderModule* module, const char* entryPoint = "main");
+        Builder& meshShader(ShaderModule& module, const char* entryPoint = "main") { return meshShader(&module, entryPoint); }
+        Builder& meshShader(const ShaderModulePtr& module, const char* entryPoint = "main") { return meshShader(module.get(), entryPoint); }
+
+        /**
+         * @brief Set a specialization constant for every stage in stages
+         *
+         * Use the stage bits of the shaders set above, e.g.
+         * VK_SHADER_STAGE_FRAGMENT_BIT, or several to share a value. IDs a
+         * shader doesn't declare are ignored.
+         */
+        Builder& constant(VkShaderStageFlags stages, uint32_t constantId, uint32_t value);
+        Builder& constant(VkShaderStageFlags stages, uint32_t constantId, int32_t value);
+        Builder& constant(VkShaderStageFlags stages, uint32_t constantId, float value);
+        Builder& constant(VkShaderStageFlags stages, uint32_t constantId, bool value);
+
+        /// Set several constants for every stage in stages
+        Builder& specialization(VkShaderStageFlags stages, const SpecializationConstants& constants);
+
         // Vertex input
         Builder& vertexBinding(uint32_t binding, uint32_t stride,
                                VkVertexInputRate inputRate = VK_VERTEX_INPUT_RATE_VERTEX);
@@ -199,19 +318,72 @@ public:
         Builder& dynamicState(VkDynamicState state);
         Builder& dynamicViewportAndScissor();
 
+        /**
+         * @brief Take the fragment size from CommandBuffer::setFragmentShadingRate()
+         *
+         * Adds VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR when the device has
+         * LogicalDevice::supportsFragmentShadingRate() and does nothing
+         * otherwise, so the pipeline builds everywhere. Command buffers must
+         * set a rate before drawing with it.
+         */
+        Builder& dynamicFragmentShadingRate();
+
         // Subpass
         Builder& subpass(uint32_t index);
 
+        /**
+         * @brief Attachment formats for dynamic rendering (VK_KHR_dynamic_rendering)
+         *
+         * Chains VkPipelineRenderingCreateInfoKHR and builds without a render
+         * pass, so the pipeline works with any target of these formats and
+         * survives resizes and render pass changes. Blend state is repeated
+         * for each color attachment. Needs LogicalDevice::supportsDynamicRendering().
+         */
+        Builder& renderingFormats(const std::vector<VkFormat>& colorFormats,
+                                  VkFormat depthFormat = VK_FORMAT_UNDEFINED,
+                                  VkFormat stencilFormat = VK_FORMAT_UNDEFINED);
+
+        /// Views drawn with dynamic rendering multiview (render pass pipelines take it from the pass)
+        Builder& viewMask(uint32_t mask);
+
+        /// Color attachments of the render pass subpass (default: 1; 0 for depth-only passes)
+        Builder& colorAttachmentCount(uint32_t count);
+
+        /// Use a specific pipeline cache (default: the device's PipelineCache)
+        Builder& cache(VkPipelineCache cache);
+
         /// Build the graphics pipeline
         GraphicsPipelinePtr build();
 
+        /**
+         * @brief Get the shared pipeline for this state from the device's PipelineRegistry
+         *
+         * Builders with identical state return the same pipeline; see PipelineRegistry.
+         */
+        GraphicsPipelineRef buildShared();
+
+        /**
+         * @brief Everything build() reads, flattened for comparison
+         *
+         * Shaders by codeHash() and entry point, the layout by handle, the
+         * render pass by RenderPass::compatibilityHash(); the pipeline cache
+         * is left out since it doesn't change the result.
+         */
+        std::vector<uint64_t> stateKey() const;
+
     private:
+        void addStage(std::vector<VkPipelineShaderStageCreateInfo>& stages, VkShaderStageFlagBits stage,
+                      ShaderModule* module, const char* entryPoint);
+
         LogicalDevice* device_;
         RenderPass* renderPass_;
         PipelineLayout* layout_;
 
         // Shader stages
         std::vector<VkPipelineShaderStageCreateInfo> shaderStages_;
+        std::vector<VkPipelineShaderStageCreateInfo> meshStages_;  // Task/mesh, replace vertex
+        std::vector<std::pair<VkShaderStageFlagBits, SpecializationConstants>> constants_;
+        std::vector<std::pair<VkShaderModule, uint64_t>> moduleHashes_;  // ShaderModule::codeHash() per handle
 
         // Vertex input
         std::vector<VkVertexInputBindingDescription> vertexBindings_;
@@ -251,6 +423,17 @@ public:
 
         std::vector<VkDynamicState> dynamicStates_;
         uint32_t subpass_ = 0;
+
+        // Dynamic rendering (used instead of renderPass_ when set)
+        bool dynamicRendering_ = false;
+        std::vector<VkFormat> colorFormats_;
+        VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
+        VkFormat stencilFormat_ = VK_FORMAT_UNDEFINED;
+        uint32_t viewMask_ = 0;
+        uint32_t colorAttachmentCount_ = 1;
+
+        VkPipelineCache cache_ = VK_NULL_HANDLE;
+        bool useDeviceCache_ = true;
     };
 
     /// Create a builder for a graphics pipeline
@@ -261,7 +444,11 @@ public:
     static Builder create(LogicalDevice* device, RenderPass* renderPass, const PipelineLayoutPtr& layout) { return create(device, renderPass, layout.get()); }
     static Builder create(LogicalDevice* device, RenderPass* renderPass, PipelineLayout& layout) { return create(device, renderPass, &layout); }
 
-    /// Create a builder using RenderTarget (auto-configures MSAA and gets RenderPass)
+    /// Create a builder without a render pass; set renderingFormats() before build()
+    static Builder create(LogicalDevice* device, PipelineLayout* layout) { return create(device, static_cast<RenderPass*>(nullptr), layout); }
+    static Builder create(const LogicalDevicePtr& device, const PipelineLayoutPtr& layout) { return create(device.get(), layout.get()); }
+
+    /// Create a builder using RenderTarget (auto-configures MSAA and the RenderPass or rendering formats)
     static Builder create(LogicalDevice* device, RenderTarget* renderTarget, PipelineLayout* layout);
     static Builder create(LogicalDevice& device, RenderTarget& renderTarget, PipelineLayout& layout) { return create(&device, &renderTarget, &layout); }
     static Builder create(const LogicalDevicePtr& device, const RenderTargetPtr& renderTarget, const PipelineLayoutPtr& layout) { return create(device.get(), renderTarget.get(), layout.get()); }
@@ -274,6 +461,12 @@ public:
     /// Get the owning device
     LogicalDevice* device() const { return device_; }
 
+    /// True if built from task/mesh stages; draw with Mesh::drawMeshlets()
+    bool usesMeshShader() const { return usesMeshShader_; }
+
+    /// Hash of the builder's stateKey(); equal for pipelines built from equal state (cheap sort key)
+    uint64_t stateHash() const { return stateHash_; }
+
     /// Bind this pipeline to a command buffer
     void bind(VkCommandBuffer cmd) const {
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
@@ -292,10 +485,151 @@ public:
 
 private:
     friend class Builder;
+    friend class PipelineRegistry;
     GraphicsPipeline() = default;
 
     void cleanup();
 
+    LogicalDevice* device_ = nullptr;
+    VkPipeline pipeline_ = VK_NULL_HANDLE;
+    bool usesMeshShader_ = false;
+    uint64_t stateHash_ = 0;
+};
+
+/**
+ * @brief Device-level registry of shared graphics pipelines
+ *
+ * Pipelines are keyed on the full builder state (GraphicsPipeline::Builder::
+ * stateKey()): shader code and entry points, specialization constants,
+ * vertex layout, fixed-function and dynamic state, and render pass
+ * compatibility or dynamic rendering formats. Materials using the same
+ * shaders, and rebuilds after RenderTarget::recreate(), get the existing
+ * VkPipeline back instead of compiling another. Each LogicalDevice owns
+ * one (LogicalDevice::pipelineRegistry()); GraphicsPipeline::Builder::
+ * buildShared() goes through it.
+ *
+ * Returned pipelines are reference counted. The registry keeps its own
+ * reference, so a pipeline outlives its last user until trim(); pipelines
+ * still referenced when the device is destroyed are released with it and
+ * their handles become VK_NULL_HANDLE. Layouts are matched by handle, so
+ * trim() before destroying a layout whose pipelines are no longer used.
+ *
+ * Usage:
+ * @code
+ * GraphicsPipelineRef pipeline = GraphicsPipeline::create(device, target, layout)
+ *     .vertexShader(vert)
+ *     .fragmentShader(frag)
+ *     .enableDepth()
+ *     .buildShared();
+ * @endcode
+ */
+class PipelineRegistry {
+public:
+    explicit PipelineRegistry(LogicalDevice* device);
+
+    /// Get (building on first use) the pipeline for a builder's state; thread-safe
+    GraphicsPipelineRef get(GraphicsPipeline::Builder& builder);
+
+    /// Number of distinct pipelines held
+    size_t size() const;
+
+    /// Lookups answered with an existing pipeline
+    uint64_t hits() const;
+
+    /// Destroy pipelines nothing outside the registry references; returns the number destroyed
+    size_t trim();
+
+    ~PipelineRegistry();
+
+    // Non-copyable
+    PipelineRegistry(const PipelineRegistry&) = delete;
+    PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+private:
+    using Key = std::vector<uint64_t>;
+
+    LogicalDevice* device_;
+    mutable std::mutex mutex_;
+    std::map<Key, GraphicsPipelineRef> pipelines_;
+    uint64_t hits_ = 0;
+};
+
+/**
+ * @brief Vulkan compute pipeline wrapper
+ */
+class ComputePipeline {
+public:
+    /**
+     * @brief Builder for creating ComputePipeline objects
+     */
+    class Builder {
+    public:
+        Builder(LogicalDevice* device, PipelineLayout* layout);
+
+        /// Set the compute shader stage
+        Builder& shader(ShaderModule* module, const char* entryPoint = "main");
+        Builder& shader(ShaderModule& module, const char* entryPoint = "main") { return shader(&module, entryPoint); }
+        Builder& shader(const ShaderModulePtr& module, const char* entryPoint = "main") { return shader(module.get(), entryPoint); }
+
+        /// Set a specialization constant (e.g. a workgroup size or loop count)
+        Builder& constant(uint32_t constantId, uint32_t value) { constants_.set(constantId, value); return *this; }
+        Builder& constant(uint32_t constantId, int32_t value) { constants_.set(constantId, value); return *this; }
+        Builder& constant(uint32_t constantId, float value) { constants_.set(constantId, value); return *this; }
+        Builder& constant(uint32_t constantId, bool value) { constants_.set(constantId, value); return *this; }
+
+        /// Set several specialization constants
+        Builder& specialization(const SpecializationConstants& constants) { constants_.merge(constants); return *this; }
+
+        /// Use a specific pipeline cache (default: the device's PipelineCache)
+        Builder& cache(VkPipelineCache cache);
+
+        /// Build the compute pipeline
+        ComputePipelinePtr build();
+
+    private:
+        LogicalDevice* device_;
+        PipelineLayout* layout_;
+        ShaderModule* module_ = nullptr;
+        const char* entryPoint_ = "main";
+        SpecializationConstants constants_;
+        VkPipelineCache cache_ = VK_NULL_HANDLE;
+        bool useDeviceCache_ = true;
+    };
+
+    /// Create a builder for a compute pipeline
+    static Builder create(LogicalDevice* device, PipelineLayout* layout);
+    static Builder create(LogicalDevice& device, PipelineLayout& layout) { return create(&device, &layout); }
+    static Builder create(const LogicalDevicePtr& device, const PipelineLayoutPtr& layout) { return create(device.get(), layout.get()); }
+    static Builder create(LogicalDevice* device, const PipelineLayoutPtr& layout) { return create(device, layout.get()); }
+
+    /// Get the Vulkan pipeline handle
+    VkPipeline handle() const { return pipeline_; }
+
+    /// Get the owning device
+    LogicalDevice* device() const { return device_; }
+
+    /// Bind this pipeline to a command buffer
+    void bind(VkCommandBuffer cmd) const {
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+    }
+
+    /// Destructor
+    ~ComputePipeline();
+
+    // Non-copyable
+    ComputePipeline(const ComputePipeline&) = delete;
+    ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+    // Movable
+    ComputePipeline(ComputePipeline&& other) noexcept;
+    ComputePipeline& operator=(ComputePipeline&& other) noexcept;
+
+private:
+    friend class Builder;
+    ComputePipeline() = default;
+
+    void cleanup();
+
     LogicalDevice* device_ = nullptr;
     VkPipeline pipeline_ = VK_NULL_HANDLE;
 };
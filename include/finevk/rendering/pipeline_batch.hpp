@@ -0,0 +1,121 @@
+#pragma once
+
+#include "finevk/rendering/pipeline.hpp"
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace finevk {
+
+/**
+ * @brief Handle to a pipeline being compiled by a PipelineBatch
+ *
+ * Cheap to copy. Until the pipeline is ready, get() returns nullptr and
+ * getOr() returns the supplied fallback, so rendering can start with a
+ * simpler pipeline while the real one compiles.
+ */
+class PipelineHandle {
+public:
+    PipelineHandle() = default;
+
+    /// Check if compilation finished (successfully or not), non-blocking
+    bool ready() const;
+
+    /// Check if compilation failed
+    bool failed() const;
+
+    /// Get the pipeline if ready, nullptr otherwise (or on failure)
+    GraphicsPipeline* get() const;
+
+    /// Get the pipeline if ready, otherwise the fallback
+    GraphicsPipeline* getOr(GraphicsPipeline* fallback) const {
+        GraphicsPipeline* pipeline = get();
+        return pipeline ? pipeline : fallback;
+    }
+
+    /// Block until compiled; rethrows the compilation error on failure
+    GraphicsPipeline& wait() const;
+
+    /// Take ownership of the compiled pipeline (blocks until compiled)
+    GraphicsPipelinePtr take();
+
+    /// Check if this handle refers to a queued pipeline
+    bool valid() const { return state_ != nullptr; }
+
+private:
+    friend class PipelineBatch;
+
+    struct State {
+        std::promise<void> promise;
+        std::shared_future<void> future;
+        GraphicsPipelinePtr pipeline;
+        std::exception_ptr error;
+        std::atomic<bool> done{false};
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Compiles many graphics pipelines across worker threads
+ *
+ * Collect fully configured builders with add(), then call compile() to build
+ * them on a small worker pool. vkCreateGraphicsPipelines is thread-safe with
+ * respect to the shared device PipelineCache, so workers populate one cache.
+ * Shader modules, render passes and layouts referenced by the builders must
+ * stay alive until the batch finishes.
+ *
+ * Usage:
+ * @code
+ * PipelineBatch batch;
+ * auto litHandle = batch.add(GraphicsPipeline::create(device, renderPass, layout)
+ *     .vertexShader(litVert).fragmentShader(litFrag) ...);
+ * batch.compile();
+ *
+ * // Each frame until ready:
+ * cmd.bindPipeline(*litHandle.getOr(unlitPipeline.get()));
+ * @endcode
+ */
+class PipelineBatch {
+public:
+    /// Create a batch (threads == 0 uses hardware concurrency)
+    explicit PipelineBatch(uint32_t threads = 0);
+
+    /// Queue a builder for compilation
+    PipelineHandle add(GraphicsPipeline::Builder builder);
+
+    /// Start compiling all queued builders on worker threads (non-blocking)
+    void compile();
+
+    /// Block until every compile() started so far has finished
+    void wait();
+
+    /// Number of pipelines queued or still compiling
+    size_t pendingCount() const;
+
+    /// Destructor - waits for outstanding compilations
+    ~PipelineBatch();
+
+    // Non-copyable (workers reference the batch)
+    PipelineBatch(const PipelineBatch&) = delete;
+    PipelineBatch& operator=(const PipelineBatch&) = delete;
+
+private:
+    struct Job {
+        GraphicsPipeline::Builder builder;
+        std::shared_ptr<PipelineHandle::State> state;
+    };
+
+    void runJobs(std::shared_ptr<std::vector<Job>> jobs,
+                 std::shared_ptr<std::atomic<size_t>> next);
+
+    uint32_t threads_;
+    std::vector<Job> queued_;
+    std::vector<std::future<void>> workers_;
+    std::vector<std::shared_ptr<PipelineHandle::State>> inFlight_;
+};
+
+} // namespace finevk
@@ -0,0 +1,341 @@
+#pragma once
+
+#include "finevk/device/memory.hpp"
+#include "finevk/core/types.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace finevk {
+
+class LogicalDevice;
+class CommandBuffer;
+class Image;
+class Buffer;
+
+/**
+ * @brief How a render graph pass uses a resource
+ *
+ * Each access implies the pipeline stage, access mask and (for images)
+ * layout the graph synchronizes for. Buffer-only accesses are marked.
+ */
+enum class GraphAccess {
+    ColorAttachment,    // COLOR_ATTACHMENT_OPTIMAL
+    DepthAttachment,    // Depth test and write
+    DepthRead,          // Read-only depth test, DEPTH_STENCIL_READ_ONLY_OPTIMAL
+    SampledFragment,    // Sampled in fragment shaders, SHADER_READ_ONLY_OPTIMAL
+    SampledCompute,     // Sampled in compute shaders, SHADER_READ_ONLY_OPTIMAL
+    Storage,            // Storage image or buffer in compute shaders, GENERAL
+    TransferSrc,
+    TransferDst,
+    VertexInput,        // Vertex or index buffer
+    Indirect,           // Indirect draw or dispatch arguments
+    Uniform             // Uniform buffer in any shader stage
+};
+
+/**
+ * @brief Description of an image the graph creates and owns
+ */
+struct GraphImageDesc {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    uint32_t mipLevels = 1;
+
+    bool operator==(const GraphImageDesc& other) const {
+        return width == other.width && height == other.height && format == other.format &&
+               samples == other.samples && mipLevels == other.mipLevels;
+    }
+    bool operator!=(const GraphImageDesc& other) const { return !(*this == other); }
+};
+
+/// Handle to an image declared in a RenderGraph (valid until reset())
+struct GraphImage {
+    uint32_t index = UINT32_MAX;
+    bool valid() const { return index != UINT32_MAX; }
+};
+
+/// Handle to a buffer imported into a RenderGraph (valid until reset())
+struct GraphBuffer {
+    uint32_t index = UINT32_MAX;
+    bool valid() const { return index != UINT32_MAX; }
+};
+
+/**
+ * @brief Per-frame render graph with automatic barriers and transient aliasing
+ *
+ * Each frame, declare resources and passes, then compile() and execute():
+ *
+ * - Passes declare what they read and write. compile() culls passes whose
+ *   outputs nothing uses: only writes to imported resources (and passes
+ *   marked sideEffect()) count as outputs.
+ * - execute() runs the remaining passes in declaration order. Before each
+ *   pass it records one batched pipeline barrier holding every layout
+ *   transition and memory dependency the pass needs. Nothing is recorded
+ *   for read-after-read in the same layout.
+ * - Graph-owned images (createImage()) only live from their first to their
+ *   last use. Images whose lifetimes don't overlap share memory. Physical
+ *   images are cached and only rebuilt when the frame's set of images or
+ *   lifetimes changes. Contents never carry over between frames.
+ *
+ * Passes record their own render passes. Attachments are in the declared
+ * layout when a pass starts, so render passes should use that layout as
+ * both initial and final layout. Imported images are returned to their
+ * final layout after the last pass that uses them. The graph assumes a
+ * single queue, and work recorded before execute() must be made visible by
+ * the caller.
+ *
+ * Usage:
+ * @code
+ * graph.reset();
+ * auto hdr = graph.createImage("hdr", {width, height, VK_FORMAT_R16G16B16A16_SFLOAT});
+ * auto bloom = graph.createImage("bloom", {width / 2, height / 2, VK_FORMAT_R16G16B16A16_SFLOAT});
+ * auto backbuffer = graph.importImage("backbuffer", swapImage, swapView, format, extent,
+ *                                     VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+ *
+ * graph.addPass("scene", [&](RenderGraph::Context& ctx) { drawScene(ctx.cmd(), ctx.view(hdr)); })
+ *     .write(hdr, GraphAccess::ColorAttachment);
+ * graph.addPass("bloom", [&](RenderGraph::Context& ctx) { ... })
+ *     .read(hdr, GraphAccess::SampledCompute)
+ *     .write(bloom, GraphAccess::Storage);
+ * graph.addPass("tonemap", [&](RenderGraph::Context& ctx) { ... })
+ *     .read(hdr, GraphAccess::SampledFragment)
+ *     .read(bloom, GraphAccess::SampledFragment)
+ *     .write(backbuffer, GraphAccess::ColorAttachment);
+ *
+ * graph.compile();
+ * graph.execute(cmd);
+ * @endcode
+ */
+class RenderGraph {
+public:
+    /**
+     * @brief What a pass sees while it records
+     */
+    class Context {
+    public:
+        CommandBuffer& cmd() const { return cmd_; }
+
+        VkImage image(GraphImage handle) const;
+        VkImageView view(GraphImage handle) const;
+        VkExtent2D extent(GraphImage handle) const;
+        VkFormat format(GraphImage handle) const;
+        VkBuffer buffer(GraphBuffer handle) const;
+
+    private:
+        friend class RenderGraph;
+        Context(const RenderGraph& graph, CommandBuffer& cmd) : graph_(graph), cmd_(cmd) {}
+
+        const RenderGraph& graph_;
+        CommandBuffer& cmd_;
+    };
+
+    using ExecuteFn = std::function<void(Context&)>;
+
+    /**
+     * @brief Declares the resources of one pass (returned by addPass())
+     *
+     * A resource used twice by one pass (e.g. read and written as a loaded
+     * color attachment) must use one layout.
+     */
+    class PassBuilder {
+    public:
+        PassBuilder& read(GraphImage image, GraphAccess access);
+        PassBuilder& write(GraphImage image, GraphAccess access);
+        PassBuilder& read(GraphBuffer buffer, GraphAccess access);
+        PassBuilder& write(GraphBuffer buffer, GraphAccess access);
+
+        /// Never cull this pass (e.g. readbacks, queries)
+        PassBuilder& sideEffect();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph* graph, uint32_t pass) : graph_(graph), pass_(pass) {}
+
+        RenderGraph* graph_;
+        uint32_t pass_;
+    };
+
+    /// Counts from the last compile() and execute()
+    struct Stats {
+        uint32_t passes = 0;                ///< Passes executed
+        uint32_t culledPasses = 0;
+        uint32_t barriers = 0;              ///< Batched vkCmdPipelineBarrier calls
+        uint32_t imageBarriers = 0;
+        uint32_t bufferBarriers = 0;
+        VkDeviceSize transientMemory = 0;   ///< Bytes backing graph-owned images
+        VkDeviceSize transientRequested = 0;///< Bytes they would need without aliasing
+    };
+
+    explicit RenderGraph(LogicalDevice* device);
+    ~RenderGraph();
+
+    /// Forget the previous frame's passes and resources (physical images are kept)
+    void reset();
+
+    /// Declare an image owned by the graph; its usage flags come from the passes
+    GraphImage createImage(const char* name, const GraphImageDesc& desc);
+
+    /**
+     * @brief Import an image that lives outside the graph
+     *
+     * @param currentLayout Layout the image is in when execute() starts
+     * @param finalLayout Layout to leave it in (VK_IMAGE_LAYOUT_UNDEFINED: last used)
+     */
+    GraphImage importImage(const char* name, Image& image,
+                           VkImageLayout currentLayout, VkImageLayout finalLayout);
+
+    /// Import a raw image such as a swap chain image
+    GraphImage importImage(const char* name, VkImage image, VkImageView view,
+                           VkFormat format, VkExtent2D extent,
+                           VkImageLayout currentLayout, VkImageLayout finalLayout);
+
+    /// Import a buffer that lives outside the graph
+    GraphBuffer importBuffer(const char* name, Buffer& buffer);
+
+    /// Add a pass; execute runs during execute() unless the pass is culled
+    PassBuilder addPass(const char* name, ExecuteFn execute);
+
+    /// Cull unused passes and create or reuse physical images
+    void compile();
+
+    /// Record every surviving pass with its barriers into cmd
+    void execute(CommandBuffer& cmd);
+
+    /// Check if a pass survived the last compile()
+    bool isActive(const char* passName) const;
+
+    const Stats& stats() const { return stats_; }
+
+    // Non-copyable
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+private:
+    struct Use {
+        uint32_t resource;
+        bool image;
+        bool read;
+        bool write;
+        VkPipelineStageFlags stages;
+        VkAccessFlags access;
+        VkImageLayout layout;
+    };
+
+    struct Pass {
+        const char* name;
+        ExecuteFn execute;
+        std::vector<Use> uses;
+        bool sideEffect = false;
+        bool culled = false;
+        uint32_t refCount = 0;
+    };
+
+    // Synchronization state of a resource while executing
+    struct State {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStages = 0;   // Last write (or layout transition)
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;    // Reads since, already made visible
+        VkAccessFlags readAccess = 0;
+        bool touched = false;
+    };
+
+    struct ImageResource {
+        const char* name;
+        GraphImageDesc desc;
+        VkImageUsageFlags usage = 0;
+        bool imported = false;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t arrayLayers = 1;
+        VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        std::vector<uint32_t> writers;
+        uint32_t refCount = 0;
+        uint32_t firstPass = UINT32_MAX;    // Over active passes
+        uint32_t lastPass = 0;
+        uint32_t physical = UINT32_MAX;
+        State state;
+    };
+
+    struct BufferResource {
+        const char* name;
+        VkBuffer buffer;
+        std::vector<uint32_t> writers;
+        uint32_t refCount = 0;
+        State state;
+    };
+
+    // Memory shared by graph-owned images with disjoint lifetimes. The
+    // stages and writes of its latest occupant carry across frames.
+    struct Slot {
+        AllocationInfo allocation;
+        VkMemoryRequirements requirements{};
+        std::vector<std::pair<uint32_t, uint32_t>> lifetimes;
+        VkPipelineStageFlags stages = 0;
+        VkAccessFlags writeAccess = 0;
+    };
+
+    struct PhysicalImage {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t slot = 0;
+    };
+
+    // Graph-owned images as compile() last built them
+    struct Plan {
+        GraphImageDesc desc;
+        VkImageUsageFlags usage;
+        uint32_t firstPass;
+        uint32_t lastPass;
+        bool operator==(const Plan& other) const {
+            return desc == other.desc && usage == other.usage &&
+                   firstPass == other.firstPass && lastPass == other.lastPass;
+        }
+    };
+
+    struct Physical {
+        std::vector<Plan> plan;
+        std::vector<PhysicalImage> images;
+        std::vector<Slot> slots;
+        VkDeviceSize requested = 0;     // Summed image sizes before aliasing
+    };
+
+    // Physical images replaced by a rebuild, kept until frames using them finish
+    struct Retired {
+        Physical physical;
+        uint32_t framesLeft;
+    };
+
+    void use(uint32_t pass, uint32_t resource, bool image, GraphAccess access, bool write);
+    void cull();
+    void buildPhysical(const std::vector<uint32_t>& transients, std::vector<Plan> plan);
+    void destroyPhysical(Physical& physical);
+
+    // Adds what a pass's use needs to the pending barrier batch
+    void syncImage(ImageResource& resource, const Use& use);
+    void syncBuffer(BufferResource& resource, const Use& use);
+    void flushBarriers(CommandBuffer& cmd);
+
+    LogicalDevice* device_;
+    std::vector<Pass> passes_;
+    std::vector<ImageResource> images_;
+    std::vector<BufferResource> buffers_;
+    Physical physical_;
+    std::vector<Retired> retired_;
+    Stats stats_;
+    bool compiled_ = false;
+
+    // Pending barrier batch (reused to avoid per-frame allocation)
+    std::vector<VkImageMemoryBarrier> imageBarriers_;
+    std::vector<VkBufferMemoryBarrier> bufferBarriers_;
+    VkPipelineStageFlags srcStages_ = 0;
+    VkPipelineStageFlags dstStages_ = 0;
+};
+
+} // namespace finevk
@@ -75,6 +75,21 @@ struct ClearColor {
  *     .enableDepth()
  *     .build();
  * @endcode
+ *
+ * Depth-only off-screen targets (shadow maps) take just a depthAttachment();
+ * an attached depth image is stored and left in
+ * DEPTH_STENCIL_READ_ONLY_OPTIMAL for sampling, as is an owned one with
+ * sampledDepth() (e.g. for a HiZPyramid). Such targets can also resume()
+ * rendering on top of what a pass left behind. With multiview(n), every
+ * attachment has n array layers and each draw reaches all of them in one
+ * pass (shadow cascades, cubemap faces); shaders index per-view data with
+ * gl_ViewIndex.
+ *
+ * With dynamicRendering() on a device that has it, no RenderPass or
+ * Framebuffers are created: begin() transitions the attachments and calls
+ * vkCmdBeginRenderingKHR directly, and a resize only recreates the depth
+ * buffer. Pipelines made with GraphicsPipeline::create(device, target, layout)
+ * pick up the attachment formats instead of the render pass.
  */
 class RenderTarget {
 public:
@@ -96,9 +111,12 @@ public:
     static RenderTargetPtr create(Window& window, bool enableDepth = false) { return create(&window, enableDepth); }
     static RenderTargetPtr create(const WindowPtr& window, bool enableDepth = false) { return create(window.get(), enableDepth); }
 
-    /// Get the render pass
+    /// Get the render pass (nullptr with dynamic rendering)
     RenderPass* renderPass() const { return renderPass_.get(); }
 
+    /// True if begin() uses dynamic rendering instead of a render pass
+    bool usesDynamicRendering() const { return dynamicRendering_; }
+
     /// Get the current framebuffer (for window targets, selects based on current frame)
     Framebuffer* currentFramebuffer() const;
 
@@ -111,6 +129,25 @@ public:
     /// Get the extent
     VkExtent2D extent() const { return extent_; }
 
+    /**
+     * @brief Render into the top-left part of the attachments only
+     *
+     * begin() and resume() limit the render area, viewport and scissor to
+     * renderExtent(), so the GPU shades fewer pixels while the attachments
+     * keep their full size. The scaled region is then upscaled by the
+     * caller (see DynamicResolution). Takes effect at the next begin().
+     *
+     * @param scale Fraction of each dimension, in (0, 1] (default 1)
+     * @throws std::runtime_error outside that range
+     */
+    void setRenderScale(float scale);
+
+    /// Current render scale (1 = full extent)
+    float renderScale() const { return renderScale_; }
+
+    /// Region begin() renders to: extent() times renderScale(), rounded up
+    VkExtent2D renderExtent() const;
+
     /// Get MSAA sample count
     VkSampleCountFlagBits msaaSamples() const { return msaaSamples_; }
 
@@ -120,9 +157,30 @@ public:
     /// Get the depth format (VK_FORMAT_UNDEFINED if no depth)
     VkFormat depthFormat() const { return depthFormat_; }
 
+    /// The depth format if it has a stencil aspect, else VK_FORMAT_UNDEFINED
+    VkFormat stencilFormat() const;
+
+    /// Check if this target has a color attachment (false for depth-only targets)
+    bool hasColor() const { return colorFormat_ != VK_FORMAT_UNDEFINED; }
+
+    /// Views rendered per pass (bit i = array layer i; 0 without multiview)
+    uint32_t viewMask() const { return viewMask_; }
+
+    /// Number of views rendered per pass (1 without multiview)
+    uint32_t viewCount() const;
+
+    /// Off-screen color image rendered to (nullptr for window and depth-only targets)
+    Image* colorImage() const { return colorImage_; }
+
     /// Check if this target has a depth buffer
     bool hasDepth() const { return depthFormat_ != VK_FORMAT_UNDEFINED; }
 
+    /// Depth image rendered to (owned or attached; nullptr without depth)
+    Image* depthImage() const { return depthTarget(); }
+
+    /// True if depth is stored and left in DEPTH_STENCIL_READ_ONLY_OPTIMAL (attached or sampledDepth())
+    bool storesDepth() const { return externalDepth_ != nullptr || sampledDepth_; }
+
     /// Get the window (nullptr for off-screen targets)
     Window* window() const { return window_; }
 
@@ -141,6 +199,18 @@ public:
      */
     void begin(CommandBuffer& cmd, const ClearColor& clearColor, float clearDepth = 1.0f);
 
+    /**
+     * @brief Begin another pass that keeps the current color and depth
+     *
+     * For work that has to run between passes of one frame, such as the
+     * Hi-Z build between the early and late draws of two-phase occlusion
+     * culling. Uses the same framebuffer (or attachments) as begin(), so
+     * pipelines built for the target work unchanged.
+     *
+     * @throws std::runtime_error unless storesDepth() (or the target has no depth)
+     */
+    void resume(CommandBuffer& cmd);
+
     /**
      * @brief End render pass
      */
@@ -149,7 +219,9 @@ public:
     /**
      * @brief Recreate resources after resize
      *
-     * For window targets, this is called automatically when the window resizes.
+     * For window targets, this is called automatically when the window resizes
+     * (begin() sees a new SwapChain::generation()), and the old depth image and
+     * framebuffers go to Window::retire() so frames in flight can finish.
      * For off-screen targets, call this if you change the backing image.
      */
     void recreate();
@@ -172,17 +244,24 @@ private:
     void createRenderPass();
     void createFramebuffers();
     void createDepthResources();
+    RenderPassPtr buildRenderPass(bool load) const;
+    void beginDynamic(CommandBuffer& cmd, const ClearColor& clearColor, float clearDepth, bool load);
+
+    /// Depth image rendered to (owned or attached; nullptr without depth)
+    Image* depthTarget() const { return depthImage_ ? depthImage_.get() : externalDepth_; }
     void cleanup();
     void setupWindowResizeCallback();
 
     LogicalDevice* device_ = nullptr;
     Window* window_ = nullptr;  // Non-owning, for window-based targets
 
-    // Off-screen color attachment (non-owning)
+    // Off-screen color and depth attachments (non-owning)
     Image* colorImage_ = nullptr;
+    Image* externalDepth_ = nullptr;
 
     // Owned resources
     RenderPassPtr renderPass_;
+    RenderPassPtr resumePass_;  // Load-op variant for resume() (stored depth only)
     std::vector<FramebufferPtr> framebuffers_;
     ImagePtr depthImage_;       // Owned depth buffer (if enableDepth)
     ImagePtr msaaColorImage_;   // Owned MSAA color image (if MSAA enabled)
@@ -192,6 +271,11 @@ private:
     VkFormat colorFormat_ = VK_FORMAT_UNDEFINED;
     VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
     VkSampleCountFlagBits msaaSamples_ = VK_SAMPLE_COUNT_1_BIT;
+    bool dynamicRendering_ = false;
+    bool sampledDepth_ = false;
+    uint32_t viewMask_ = 0;
+    float renderScale_ = 1.0f;
+    uint64_t swapChainGeneration_ = 0;  // Window targets: swap chain the framebuffers were built for
 
     // Window resize callback ID (for cleanup)
     size_t resizeCallbackId_ = 0;
@@ -225,7 +309,12 @@ public:
     /// Enable depth buffer with specific format
     Builder& depthFormat(VkFormat format);
 
-    /// Set custom depth attachment (use existing depth buffer)
+    /**
+     * @brief Set custom depth attachment (use existing depth buffer)
+     *
+     * The image is stored and ends in DEPTH_STENCIL_READ_ONLY_OPTIMAL. With
+     * no color attachment this makes a depth-only target, such as a shadow map.
+     */
     Builder& depthAttachment(Image* image);
     Builder& depthAttachment(Image& image) { return depthAttachment(&image); }
     Builder& depthAttachment(const ImagePtr& image) { return depthAttachment(image.get()); }
@@ -233,6 +322,37 @@ public:
     /// Set MSAA sample count
     Builder& msaa(VkSampleCountFlagBits samples);
 
+    /**
+     * @brief Keep the owned depth buffer after each pass for sampling
+     *
+     * The depth buffer gets SAMPLED usage and regular device memory instead
+     * of lazily allocated memory, is stored, and ends each pass in
+     * DEPTH_STENCIL_READ_ONLY_OPTIMAL like an attached one. Enables depth
+     * (D32_SFLOAT) if no format was chosen.
+     *
+     * @throws std::runtime_error from build() with MSAA
+     */
+    Builder& sampledDepth(bool enable = true);
+
+    /**
+     * @brief Render without a RenderPass or Framebuffers where supported
+     *
+     * Needs LogicalDeviceBuilder::enableDynamicRendering(); without it the
+     * target falls back to a render pass, so the same code runs everywhere.
+     */
+    Builder& dynamicRendering(bool enable = true);
+
+    /**
+     * @brief Render viewCount array layers in one pass (off-screen only)
+     *
+     * Attached images need at least viewCount array layers; an owned depth
+     * buffer is created with that many.
+     *
+     * @throws std::runtime_error from build() without LogicalDeviceBuilder::enableMultiview(),
+     *         above the device's view limit, or for window targets
+     */
+    Builder& multiview(uint32_t viewCount);
+
     /// Build the render target
     RenderTargetPtr build();
 
@@ -244,6 +364,9 @@ private:
     VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
     VkSampleCountFlagBits msaaSamples_ = VK_SAMPLE_COUNT_1_BIT;
     bool enableDepth_ = false;
+    bool sampledDepth_ = false;
+    bool dynamicRendering_ = false;
+    uint32_t viewCount_ = 1;
 };
 
 // Inline definitions (after Builder is complete)
@@ -39,7 +39,9 @@ public:
             VkFormat format,
             VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
             VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-            VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE);
+            VkAttachmentStoreOp storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            VkImageLayout finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED);
 
         /// Add a resolve attachment (for MSAA)
         Builder& addResolveAttachment(
@@ -64,6 +66,17 @@ public:
         /// Add standard external dependency for presentation
         Builder& addPresentationDependency();
 
+        /**
+         * @brief Render to several array layers at once (multiview)
+         *
+         * Bit i of viewMask renders view i into layer i of every attachment;
+         * shaders pick their view with gl_ViewIndex. correlationMask hints
+         * which views are spatially close (e.g. shadow cascades). The
+         * framebuffer keeps 1 layer; its views must cover the layers.
+         * Needs LogicalDevice::supportsMultiview().
+         */
+        Builder& multiview(uint32_t viewMask, uint32_t correlationMask = 0);
+
         /// Build the render pass
         RenderPassPtr build();
 
@@ -75,6 +88,8 @@ public:
         VkAttachmentReference depthRef_{};
         bool hasDepth_ = false;
         std::vector<VkSubpassDependency> dependencies_;
+        uint32_t viewMask_ = 0;
+        uint32_t correlationMask_ = 0;
     };
 
     /// Create a builder for a render pass
@@ -102,6 +117,16 @@ public:
     /// Get the owning device
     LogicalDevice* device() const { return device_; }
 
+    /**
+     * @brief Hash of what pipeline compatibility depends on
+     *
+     * Attachment formats and sample counts, the subpass references,
+     * dependencies and view masks; load/store ops and layouts are left
+     * out, as the spec allows. Equal for render passes pipelines can be
+     * shared between.
+     */
+    uint64_t compatibilityHash() const { return compatibilityHash_; }
+
     /// Destructor
     ~RenderPass();
 
@@ -121,6 +146,7 @@ private:
 
     LogicalDevice* device_ = nullptr;
     VkRenderPass renderPass_ = VK_NULL_HANDLE;
+    uint64_t compatibilityHash_ = 0;
 };
 
 } // namespace finevk
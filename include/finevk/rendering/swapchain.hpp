@@ -4,6 +4,7 @@
 #include "finevk/device/physical_device.hpp"
 
 #include <vulkan/vulkan.h>
+#include <functional>
 #include <vector>
 #include <memory>
 
@@ -41,10 +42,10 @@ public:
         /// Set preferred surface format
         Builder& preferredFormat(VkSurfaceFormatKHR format);
 
-        /// Set preferred present mode
+        /// Set preferred present mode (falls back to the closest supported one)
         Builder& preferredPresentMode(VkPresentModeKHR mode);
 
-        /// Set preferred image count (min images in swap chain)
+        /// Set preferred image count (min images in swap chain; 0 = recommendedImageCount())
         Builder& imageCount(uint32_t count);
 
         /// Enable/disable vsync (chooses FIFO vs MAILBOX)
@@ -61,7 +62,7 @@ public:
         Surface* surface_;
         VkSurfaceFormatKHR preferredFormat_ = {VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
         VkPresentModeKHR preferredPresentMode_ = VK_PRESENT_MODE_MAILBOX_KHR;
-        uint32_t imageCount_ = 3;
+        uint32_t imageCount_ = 0;
         bool vsync_ = true;
         SwapChain* oldSwapChain_ = nullptr;
     };
@@ -85,6 +86,9 @@ public:
     /// Get the swap chain extent
     VkExtent2D extent() const { return extent_; }
 
+    /// Usage the images were created with (TRANSFER_DST is added where the surface supports it)
+    VkImageUsageFlags imageUsage() const { return imageUsage_; }
+
     /// Get the number of images
     uint32_t imageCount() const { return static_cast<uint32_t>(images_.size()); }
 
@@ -98,13 +102,60 @@ public:
     AcquireResult acquireNextImage(VkSemaphore signalSemaphore,
                                    uint64_t timeout = UINT64_MAX);
 
-    /// Present an image to the screen
+    /// Present an image to the screen (tagged with the next present id under present wait)
     VkResult present(Queue* queue, uint32_t imageIndex,
                      VkSemaphore waitSemaphore);
 
-    /// Recreate the swap chain (e.g., after window resize)
+    /// Id of the last present, counting from 1; restarts when the swap chain is recreated
+    uint64_t lastPresentId() const { return lastPresentId_; }
+
+    /**
+     * @brief Block until the present with this id has reached the display
+     *
+     * Returns false on timeout, or immediately without present wait support
+     * (LogicalDeviceBuilder::enablePresentWait()) or for id 0.
+     */
+    bool waitForPresent(uint64_t presentId, uint64_t timeout = UINT64_MAX);
+
+    /// Recreate the swap chain (e.g., after window resize); waits for the device to go idle
     void recreate(uint32_t width, uint32_t height);
 
+    /**
+     * @brief Recreate the swap chain without waiting for the device
+     *
+     * The new swap chain is created from the old one (oldSwapchain), so
+     * frames still in flight keep rendering to and presenting the old
+     * images. The old handle and its image views are handed back instead
+     * of destroyed: run (or drop) the returned callable once the GPU has
+     * finished the frames submitted so far, e.g. through Window::retire().
+     */
+    std::function<void()> recreateDeferred(uint32_t width, uint32_t height);
+
+    /// Get the present mode in use
+    VkPresentModeKHR presentMode() const { return presentMode_; }
+
+    /// Check whether the surface supports a present mode
+    bool supportsPresentMode(VkPresentModeKHR mode) const;
+
+    /**
+     * @brief Switch present mode at runtime
+     *
+     * Recreates the swap chain at the current extent, handing the old one to
+     * vkCreateSwapchainKHR so the switch doesn't tear down the surface.
+     * Unsupported modes fall back like the builder: MAILBOX and IMMEDIATE to
+     * each other, then FIFO. Nothing happens if mode and count are unchanged.
+     *
+     * @param imageCount Min images for the new mode (0 = recommendedImageCount())
+     * @return Present mode actually selected
+     */
+    VkPresentModeKHR setPresentMode(VkPresentModeKHR mode, uint32_t imageCount = 0);
+
+    /// Images worth requesting for a mode: 3 for MAILBOX, 2 for FIFO and IMMEDIATE
+    static uint32_t recommendedImageCount(VkPresentModeKHR mode);
+
+    /// Incremented on every recreation; compare to detect stale framebuffers
+    uint64_t generation() const { return generation_; }
+
     /// Check if swap chain needs recreation
     bool needsRecreation() const { return needsRecreation_; }
 
@@ -125,6 +176,7 @@ private:
 
     void createImageViews();
     void cleanup();
+    std::vector<ImageViewPtr> createReplacement(uint32_t width, uint32_t height);  // Returns the old views
 
     LogicalDevice* device_ = nullptr;
     Surface* surface_ = nullptr;
@@ -132,6 +184,10 @@ private:
     VkSurfaceFormatKHR format_{};
     VkExtent2D extent_{};
     VkPresentModeKHR presentMode_ = VK_PRESENT_MODE_FIFO_KHR;
+    VkImageUsageFlags imageUsage_ = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    uint32_t requestedImageCount_ = 0;
+    uint64_t generation_ = 0;
+    uint64_t lastPresentId_ = 0;
 
     std::vector<VkImage> images_;
     std::vector<ImageViewPtr> imageViews_;
@@ -7,11 +7,14 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
+#include <array>
+#include <chrono>
 #include <memory>
 #include <functional>
 #include <string>
 #include <string_view>
 #include <optional>
+#include <vector>
 
 namespace finevk {
 
@@ -89,7 +92,10 @@ struct WindowConfig {
     bool resizable = true;
     bool fullscreen = false;
     bool vsync = true;
-    uint32_t framesInFlight = 2;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;  // MAX_ENUM = FIFO/MAILBOX from vsync
+    uint32_t swapChainImages = 0;  // 0 = SwapChain::recommendedImageCount() for the mode
+    uint32_t framesInFlight = 0;  // 0 = the device's LogicalDevice::framesInFlight()
+    std::chrono::milliseconds resizeDebounce{0};  // Quiet time before a resize recreates the swap chain
 };
 
 /**
@@ -108,6 +114,18 @@ struct FrameInfo {
     VkFence inFlightFence = VK_NULL_HANDLE;       // CPU-GPU sync for this frame
 };
 
+/**
+ * @brief Measured input latency, in seconds (smoothed over recent frames)
+ *
+ * Input time is the last pollEvents() before the frame was presented.
+ */
+struct FrameLatency {
+    float inputToPresent = 0.0f;   ///< Input poll to vkQueuePresentKHR
+    float inputToDisplay = 0.0f;   ///< Input poll to the image reaching the display (present wait only)
+    float frameWait = 0.0f;        ///< Time blocked in waitForFrame()
+    uint64_t presents = 0;         ///< Frames presented so far
+};
+
 /**
  * @brief Platform-abstracted window with Vulkan surface and swap chain
  *
@@ -159,9 +177,18 @@ public:
         /// Enable/disable vsync
         Builder& vsync(bool enabled = true);
 
-        /// Set frames in flight (for swap chain)
+        /// Request a present mode explicitly (overrides vsync)
+        Builder& presentMode(VkPresentModeKHR mode);
+
+        /// Set swap chain image count (default: tuned to the present mode)
+        Builder& swapChainImages(uint32_t count);
+
+        /// Set frames in flight; applied to the device by bindDevice() (default: the device's)
         Builder& framesInFlight(uint32_t count);
 
+        /// Delay swap chain recreation until resize events pause this long (default: 0)
+        Builder& resizeDebounce(std::chrono::milliseconds delay);
+
         /// Build the window
         WindowPtr build();
 
@@ -221,6 +248,55 @@ public:
     /// Get swap chain image format
     VkFormat format() const;
 
+    /**
+     * @brief Switch present mode without recreating the window or surface
+     *
+     * FIFO caps to the refresh rate, FIFO_RELAXED tears only when a frame is
+     * late, MAILBOX renders uncapped without tearing and IMMEDIATE tears for
+     * the lowest latency. Before bindDevice() this only updates the config.
+     *
+     * @return Present mode actually selected (see SwapChain::setPresentMode())
+     */
+    VkPresentModeKHR setPresentMode(VkPresentModeKHR mode);
+
+    /// Present mode in use (or requested, before bindDevice())
+    VkPresentModeKHR presentMode() const;
+
+    /// Switch between FIFO (true) and MAILBOX (false) at runtime
+    void setVsync(bool enabled);
+
+    // ========================================================================
+    // Resource retirement
+    // ========================================================================
+
+    /// Receives destroy callables for resources frames in flight may still use
+    using RetireHandler = std::function<void(std::function<void()> destroy)>;
+
+    /**
+     * @brief Destroy a resource once the frames submitted so far are done
+     *
+     * Resizes go through here instead of a device-wide waitIdle(): the old
+     * swap chain, and the framebuffers and attachments SimpleRenderer and
+     * RenderTarget rebuild, keep existing until the GPU has finished with
+     * them while new frames already use the replacements. Without a handler
+     * the window keeps them until the graphics queue timeline passes the
+     * current submission and every frame slot has cycled, checked from
+     * beginFrame(); releaseDeviceResources() destroys what remains.
+     */
+    void retire(std::function<void()> destroy);
+
+    /**
+     * @brief Forward retire() to another disposal mechanism
+     *
+     * E.g. DeferredDisposer (GameLoop installs its own). Pass nullptr to
+     * return to the window's own list. The handler must keep the callables
+     * until the GPU is done and run them before the device is destroyed.
+     */
+    void setRetireHandler(RetireHandler handler) { retireHandler_ = std::move(handler); }
+
+    /// Resources retired to the window's own list and not yet destroyed
+    size_t retiredCount() const { return retired_.size(); }
+
     // ========================================================================
     // Device binding
     // ========================================================================
@@ -252,8 +328,11 @@ public:
      */
     void releaseDeviceResources();
 
-    /// Get the number of frames in flight
-    uint32_t framesInFlight() const { return config_.framesInFlight; }
+    /// Get the number of frames in flight (follows LogicalDevice::setFramesInFlight())
+    uint32_t framesInFlight() const;
+
+    /// Frame slots allocated; size per-frame resources to this (LogicalDevice::maxFramesInFlight())
+    uint32_t maxFramesInFlight() const;
 
     /// Get the current frame index (0 to framesInFlight-1)
     uint32_t currentFrame() const { return currentFrameIndex_; }
@@ -278,6 +357,26 @@ public:
      */
     std::optional<FrameInfo> beginFrame();
 
+    /**
+     * @brief Block until the next beginFrame() can start without waiting
+     *
+     * For low-latency loops: call before pollEvents() so input is sampled
+     * after the wait instead of before it. Waits for the frame slot's fence
+     * and, when the device has present wait (LogicalDeviceBuilder::enablePresentWait()),
+     * until at most queuedPresents earlier frames are still waiting for the
+     * display, so the frame starts just in time for the next refresh.
+     *
+     * @param queuedPresents Frames allowed to remain queued for display
+     *        (0 = wait for the last frame to be displayed)
+     */
+    void waitForFrame(uint32_t queuedPresents = 0);
+
+    /// True if waitForFrame() can wait for the display (present wait enabled)
+    bool hasPresentWait() const;
+
+    /// Measured input latency
+    const FrameLatency& latency() const { return latency_; }
+
     /**
      * @brief Present the current frame
      *
@@ -357,6 +456,7 @@ private:
     void cleanup();
     void cleanupSwapChain();
     void recreateSwapChain();
+    void releaseRetired(bool all);
 
     // Static GLFW callbacks (forward to instance methods)
     static void glfwKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
@@ -369,6 +469,8 @@ private:
     // Modifier conversion (Key and MouseButton use GLFW constants directly)
     static Modifier glfwModsToModifier(int glfwMods);
 
+    using Clock = std::chrono::steady_clock;
+
     // Core state
     Instance* instance_ = nullptr;
     LogicalDevice* device_ = nullptr;  // Non-owning, set by bindDevice()
@@ -388,6 +490,23 @@ private:
     uint32_t currentFrameIndex_ = 0;
     uint32_t currentImageIndex_ = 0;
     bool framebufferResized_ = false;
+    Clock::time_point resizeTime_{};  // Last framebuffer size event (debounce)
+
+    // Resources waiting for frames in flight (without a retire handler)
+    struct Retired {
+        std::function<void()> destroy;
+        uint64_t value;       // Graphics queue timeline value (0 without timeline)
+        uint32_t framesLeft;  // beginFrame() calls still to pass
+    };
+    std::vector<Retired> retired_;
+    RetireHandler retireHandler_;
+
+    // Latency tracking: poll time of each recent present, indexed by present id
+    static constexpr size_t kLatencyHistory = 8;
+    Clock::time_point lastPollTime_{};
+    std::array<Clock::time_point, kLatencyHistory> presentPollTimes_{};
+    uint64_t displayedPresentId_ = 0;
+    FrameLatency latency_;
 
     // Device destruction callback registration
     size_t deviceDestructionCallbackId_ = 0;
@@ -0,0 +1,19 @@
+// Decoders for Mesh's compact vertex encodings.
+//
+//   #include "vertex_decode.glsl"
+//   layout(location = 1) in vec2 inNormal;   // VertexAttribute::OctNormal
+//   ...
+//   vec3 normal = fvkOctDecode(inNormal);
+//
+// QuantizedPosition needs no decoding here: multiply Mesh::dequantizeTransform()
+// into the model matrix used for positions. HalfTexCoord and Color8 are
+// expanded by the vertex fetch and read as vec2 / vec3 as usual.
+
+// Inverse of the octahedral encoding in Mesh::Builder (RG16 snorm)
+vec3 fvkOctDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
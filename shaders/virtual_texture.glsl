@@ -0,0 +1,86 @@
+// Virtual texture sampling for VirtualTexture.
+// Include from a fragment shader after choosing the descriptor set:
+//
+//   #define VT_SET 2
+//   #include "virtual_texture.glsl"
+//   ...
+//   vec4 albedo = vtSample(uv);
+//
+// Every sample also reports the page it wanted (1 in 16 pixels, rotating
+// per frame, one report per page per frame), which VirtualTexture::update()
+// turns into streaming requests. Needs fragmentStoresAndAtomics.
+
+#ifndef VT_SET
+#define VT_SET 0
+#endif
+
+layout(set = VT_SET, binding = 0) uniform sampler2D vtCache;
+layout(set = VT_SET, binding = 1) uniform usampler2D vtIndirection;
+
+layout(std140, set = VT_SET, binding = 2) uniform VtParams {
+    vec2 cacheSize;         // Texels
+    float virtualSize;      // Level 0 texels per side
+    uint pageCount;         // Level 0 pages per side
+    uint pageSize;
+    uint border;
+    uint levelCount;
+    uint feedbackCapacity;
+    uvec4 levelOffsets[4];  // Stamp index of each level's first page
+} vtParams;
+
+layout(std430, set = VT_SET, binding = 3) buffer VtFeedback {
+    uint count;
+    uint frame;
+    uint pad0;
+    uint pad1;
+    uint pages[];           // level << 24 | y << 12 | x
+} vtFeedback;
+
+layout(std430, set = VT_SET, binding = 4) buffer VtStamps {
+    uint stamps[];          // Last frame each page was reported
+} vtStamps;
+
+uint vtPagesAt(uint level) {
+    return max(vtParams.pageCount >> level, 1u);
+}
+
+// Level wanted by the screen-space footprint of uv (no trilinear blend)
+uint vtLevel(vec2 uv) {
+    vec2 texel = uv * vtParams.virtualSize;
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+    return uint(clamp(lod, 0.0, float(vtParams.levelCount - 1u)));
+}
+
+void vtRequest(uint level, uvec2 page) {
+    uvec2 pixel = uvec2(gl_FragCoord.xy) & 3u;
+    if (pixel.x + pixel.y * 4u != (vtFeedback.frame & 15u)) {
+        return;
+    }
+    uint index = vtParams.levelOffsets[level / 4u][level % 4u] + page.y * vtPagesAt(level) + page.x;
+    if (atomicExchange(vtStamps.stamps[index], vtFeedback.frame) == vtFeedback.frame) {
+        return;
+    }
+    uint slot = atomicAdd(vtFeedback.count, 1u);
+    if (slot < vtParams.feedbackCapacity) {
+        vtFeedback.pages[slot] = (level << 24) | (page.y << 12) | page.x;
+    }
+}
+
+vec4 vtSample(vec2 uv) {
+    uv = clamp(uv, vec2(0.0), vec2(1.0));
+    uint level = vtLevel(uv);
+    uint pages = vtPagesAt(level);
+    uvec2 page = min(uvec2(uv * float(pages)), uvec2(pages - 1u));
+    vtRequest(level, page);
+
+    // (slot x, slot y, resident level, valid); may be a coarser ancestor
+    uvec4 entry = texelFetch(vtIndirection, ivec2(page), int(level));
+    uvec2 resident = page >> (entry.b - level);
+    vec2 inPage = uv * float(vtPagesAt(entry.b)) - vec2(resident);
+
+    float slotSize = float(vtParams.pageSize + 2u * vtParams.border);
+    vec2 texel = vec2(entry.rg) * slotSize + float(vtParams.border) + inPage * float(vtParams.pageSize);
+    return textureLod(vtCache, texel / vtParams.cacheSize, 0.0);
+}
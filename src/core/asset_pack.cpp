@@ -0,0 +1,220 @@
+#include "finevk/core/asset_pack.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace finevk {
+
+namespace {
+
+// ============================================================================
+// Pack file format
+// ============================================================================
+
+// Header, then entryCount TocEntry records, then the names (not
+// terminated), then each entry's bytes at an EntryAlignment boundary.
+// Native byte order.
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t namesOffset;  // From the start of the file
+    uint64_t namesSize;
+};
+
+struct TocEntry {
+    uint64_t offset;      // From the start of the file, EntryAlignment aligned
+    uint64_t size;
+    uint64_t nameOffset;  // Into the names
+    uint32_t nameLength;
+    uint32_t kind;        // AssetPack::Kind
+};
+
+constexpr char kPackMagic[4] = {'F', 'V', 'K', 'P'};
+constexpr uint32_t kPackVersion = 1;
+
+uint64_t alignEntry(uint64_t offset) {
+    return (offset + AssetPack::EntryAlignment - 1) & ~(AssetPack::EntryAlignment - 1);
+}
+
+} // namespace
+
+// ============================================================================
+// AssetPack::Writer implementation
+// ============================================================================
+
+AssetPack::Writer& AssetPack::Writer::add(const std::string& name, Kind kind, const std::string& path) {
+    entries_.push_back({name, kind, path, {}});
+    return *this;
+}
+
+AssetPack::Writer& AssetPack::Writer::add(const std::string& name, Kind kind, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    entries_.push_back({name, kind, {}, std::vector<uint8_t>(bytes, bytes + size)});
+    return *this;
+}
+
+void AssetPack::Writer::write(const std::string& path) const {
+    std::unordered_set<std::string> names;
+    for (const auto& pending : entries_) {
+        if (!names.insert(pending.name).second) {
+            throw std::runtime_error("AssetPack: duplicate entry name: " + pending.name);
+        }
+    }
+
+    // Lay out the table of contents first; file sizes are taken now
+    std::vector<TocEntry> toc(entries_.size());
+    std::string namesBlob;
+    for (size_t i = 0; i < entries_.size(); i++) {
+        const auto& pending = entries_[i];
+        uint64_t size = pending.bytes.size();
+        if (!pending.path.empty()) {
+            std::error_code ec;
+            size = std::filesystem::file_size(pending.path, ec);
+            if (ec) {
+                throw std::runtime_error("AssetPack: failed to read " + pending.path);
+            }
+        }
+        toc[i].size = size;
+        toc[i].nameOffset = namesBlob.size();
+        toc[i].nameLength = static_cast<uint32_t>(pending.name.size());
+        toc[i].kind = static_cast<uint32_t>(pending.kind);
+        namesBlob += pending.name;
+    }
+
+    PackHeader header{};
+    std::memcpy(header.magic, kPackMagic, sizeof(kPackMagic));
+    header.version = kPackVersion;
+    header.entryCount = static_cast<uint32_t>(toc.size());
+    header.namesOffset = sizeof(PackHeader) + toc.size() * sizeof(TocEntry);
+    header.namesSize = namesBlob.size();
+
+    uint64_t offset = header.namesOffset + header.namesSize;
+    for (auto& entry : toc) {
+        entry.offset = alignEntry(offset);
+        offset = entry.offset + entry.size;
+    }
+
+    // Write beside the target and rename, so readers never map a partial file
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(toc.data()),
+                  static_cast<std::streamsize>(toc.size() * sizeof(TocEntry)));
+        out.write(namesBlob.data(), static_cast<std::streamsize>(namesBlob.size()));
+
+        uint64_t position = header.namesOffset + header.namesSize;
+        const std::vector<char> padding(EntryAlignment, 0);
+        std::vector<char> chunk(1 << 20);
+        for (size_t i = 0; i < entries_.size() && out; i++) {
+            const auto& pending = entries_[i];
+            out.write(padding.data(), static_cast<std::streamsize>(toc[i].offset - position));
+
+            if (pending.path.empty()) {
+                out.write(reinterpret_cast<const char*>(pending.bytes.data()),
+                          static_cast<std::streamsize>(pending.bytes.size()));
+            } else {
+                std::ifstream in(pending.path, std::ios::binary);
+                uint64_t remaining = toc[i].size;
+                while (in && remaining > 0) {
+                    auto count = static_cast<std::streamsize>(std::min<uint64_t>(remaining, chunk.size()));
+                    in.read(chunk.data(), count);
+                    out.write(chunk.data(), in.gcount());
+                    remaining -= static_cast<uint64_t>(in.gcount());
+                }
+                if (remaining > 0) {
+                    out.close();
+                    std::remove(temp.c_str());
+                    throw std::runtime_error("AssetPack: failed to read " + pending.path);
+                }
+            }
+            position = toc[i].offset + toc[i].size;
+        }
+        if (!out) {
+            out.close();
+            std::remove(temp.c_str());
+            throw std::runtime_error("AssetPack: failed to write " + path);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        std::remove(temp.c_str());
+        throw std::runtime_error("AssetPack: failed to write " + path);
+    }
+}
+
+// ============================================================================
+// AssetPack implementation
+// ============================================================================
+
+AssetPack::AssetPack(const std::string& path)
+    : path_(path)
+    , file_(path) {
+
+    auto invalid = [&](const std::string& reason) {
+        return std::runtime_error("Invalid asset pack (" + reason + "): " + path);
+    };
+
+    const uint8_t* data = file_.data();
+    size_t size = file_.size();
+    if (size < sizeof(PackHeader)) {
+        throw invalid("truncated header");
+    }
+    PackHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kPackMagic, sizeof(kPackMagic)) != 0 || header.version != kPackVersion) {
+        throw invalid("unknown format or version");
+    }
+    uint64_t tocEnd = sizeof(PackHeader) + static_cast<uint64_t>(header.entryCount) * sizeof(TocEntry);
+    if (tocEnd > size || header.namesOffset < tocEnd ||
+        header.namesOffset > size || header.namesSize > size - header.namesOffset) {
+        throw invalid("truncated table of contents");
+    }
+
+    const auto* names = reinterpret_cast<const char*>(data + header.namesOffset);
+    entries_.reserve(header.entryCount);
+    index_.reserve(header.entryCount);
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        TocEntry toc;
+        std::memcpy(&toc, data + sizeof(PackHeader) + i * sizeof(TocEntry), sizeof(toc));
+        if (toc.nameOffset > header.namesSize || toc.nameLength > header.namesSize - toc.nameOffset) {
+            throw invalid("entry " + std::to_string(i) + " has a bad name");
+        }
+        if (toc.offset % EntryAlignment != 0 || toc.offset > size || toc.size > size - toc.offset) {
+            throw invalid("entry " + std::to_string(i) + " lies outside the file");
+        }
+
+        Entry entry;
+        entry.name.assign(names + toc.nameOffset, toc.nameLength);
+        entry.kind = static_cast<Kind>(toc.kind);
+        entry.bytes = {data + toc.offset, static_cast<size_t>(toc.size)};
+        if (!index_.emplace(entry.name, entries_.size()).second) {
+            throw invalid("duplicate entry " + entry.name);
+        }
+        entries_.push_back(std::move(entry));
+    }
+}
+
+const AssetPack::Entry* AssetPack::find(const std::string& name) const {
+    auto it = index_.find(name);
+    return it != index_.end() ? &entries_[it->second] : nullptr;
+}
+
+const AssetPack::Entry& AssetPack::entry(const std::string& name) const {
+    const Entry* found = find(name);
+    if (!found) {
+        throw std::runtime_error("Asset pack has no entry '" + name + "': " + path_);
+    }
+    return *found;
+}
+
+} // namespace finevk
@@ -67,12 +67,19 @@ Instance::Builder& Instance::Builder::addExtensions(const std::vector<const char
     return *this;
 }
 
-std::vector<const char*> Instance::Builder::getRequiredExtensions() const {
-    // Get GLFW required extensions
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+Instance::Builder& Instance::Builder::headless(bool enable) {
+    headless_ = enable;
+    return *this;
+}
 
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+std::vector<const char*> Instance::Builder::getRequiredExtensions() const {
+    // Get GLFW required extensions (surface support; none without windows)
+    std::vector<const char*> extensions;
+    if (!headless_) {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
 
     // Add user-requested extensions
     extensions.insert(extensions.end(), extensions_.begin(), extensions_.end());
@@ -107,8 +114,8 @@ bool Instance::Builder::checkValidationLayerSupport() const {
 }
 
 InstancePtr Instance::Builder::build() {
-    // Initialize GLFW if not already done
-    if (!glfwInit()) {
+    // Initialize GLFW if not already done (fails without a display server)
+    if (!headless_ && !glfwInit()) {
         throw std::runtime_error("Failed to initialize GLFW");
     }
 
@@ -171,6 +178,7 @@ InstancePtr Instance::Builder::build() {
     auto instance = InstancePtr(new Instance());
     instance->instance_ = vkInstance;
     instance->validationEnabled_ = validationEnabled_;
+    instance->headless_ = headless_;
 
     // Create debug messenger if validation is enabled
     if (validationEnabled_) {
@@ -195,6 +203,7 @@ Instance::~Instance() {
 Instance::Instance(Instance&& other) noexcept
     : instance_(other.instance_)
     , validationEnabled_(other.validationEnabled_)
+    , headless_(other.headless_)
     , debugMessenger_(std::move(other.debugMessenger_)) {
     other.instance_ = VK_NULL_HANDLE;
 }
@@ -204,6 +213,7 @@ Instance& Instance::operator=(Instance&& other) noexcept {
         cleanup();
         instance_ = other.instance_;
         validationEnabled_ = other.validationEnabled_;
+        headless_ = other.headless_;
         debugMessenger_ = std::move(other.debugMessenger_);
         other.instance_ = VK_NULL_HANDLE;
     }
@@ -222,10 +232,16 @@ void Instance::cleanup() {
 }
 
 SurfacePtr Instance::createSurface(GLFWwindow* window) {
+    if (headless_) {
+        throw std::runtime_error("Instance::createSurface: instance was built headless");
+    }
     return Surface::fromGLFW(this, window);
 }
 
 WindowPtr Instance::createWindow(const char* title, uint32_t width, uint32_t height) {
+    if (headless_) {
+        throw std::runtime_error("Instance::createWindow: instance was built headless");
+    }
     return Window::create(this)
         .title(title)
         .size(width, height)
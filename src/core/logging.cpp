@@ -1,48 +1,279 @@
 #include "finevk/core/logging.hpp"
 
 #include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace finevk {
 
-Logger& Logger::global() {
-    static Logger instance;
-    return instance;
-}
-
-void Logger::log(LogLevel level, LogCategory category, std::string_view message,
-                 const char* file, int line) {
-    if (level < minLevel_) {
-        return;
-    }
+namespace {
 
-    // Get current time
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
+// Format: [TIME.ms] [LEVEL] [CATEGORY] message (file:line)
+void writeLine(FILE* out, std::chrono::system_clock::time_point when,
+               const char* level, const char* category, std::string_view message,
+               const char* file, int line) {
+    auto time = std::chrono::system_clock::to_time_t(when);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+        when.time_since_epoch()) % 1000;
 
     char timeStr[32];
     std::strftime(timeStr, sizeof(timeStr), "%H:%M:%S", std::localtime(&time));
 
-    // Select output stream based on level
-    FILE* out = (level >= LogLevel::Warning) ? stderr : stdout;
-
-    // Format: [TIME.ms] [LEVEL] [CATEGORY] message
     if (file && line > 0) {
         std::fprintf(out, "[%s.%03d] [%-7s] [%-11s] %.*s (%s:%d)\n",
-                     timeStr, static_cast<int>(ms.count()),
-                     levelToString(level), categoryToString(category),
+                     timeStr, static_cast<int>(ms.count()), level, category,
                      static_cast<int>(message.size()), message.data(),
                      file, line);
     } else {
         std::fprintf(out, "[%s.%03d] [%-7s] [%-11s] %.*s\n",
-                     timeStr, static_cast<int>(ms.count()),
-                     levelToString(level), categoryToString(category),
+                     timeStr, static_cast<int>(ms.count()), level, category,
                      static_cast<int>(message.size()), message.data());
     }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Asynchronous backend
+// ============================================================================
+
+// Bounded multi-producer ring (sequence numbers per cell, after Vyukov's
+// bounded queue) with the writer thread as its only consumer
+struct Logger::AsyncState {
+    struct Record {
+        LogLevel level = LogLevel::Info;
+        LogCategory category = LogCategory::Core;
+        std::chrono::system_clock::time_point time;
+        const char* file = nullptr;
+        int line = 0;
+        size_t length = 0;
+        char text[InlineMessageSize];
+        std::string overflow;  // Longer messages; keeps its capacity for the slot's next use
+
+        std::string_view message() const {
+            return length <= InlineMessageSize ? std::string_view(text, length) : std::string_view(overflow);
+        }
+    };
+
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        Record record;
+    };
+
+    static constexpr size_t Mask = QueueCapacity - 1;
+    static_assert((QueueCapacity & Mask) == 0, "Logger::QueueCapacity must be a power of two");
+
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos = 0;      // Consumer only
+    std::atomic<size_t> written{0};         // Records written, for flush()
+    std::atomic<uint64_t> dropped{0};
+    uint64_t droppedReported = 0;           // Consumer only
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;           // Writer waits for records
+    std::condition_variable flushed;        // flush() waits for the writer
+    std::atomic<bool> sleeping{false};
+    bool stop = false;                      // Guarded by mutex
+
+    AsyncState() : cells(new Cell[QueueCapacity]) {
+        for (size_t i = 0; i < QueueCapacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(LogLevel level, LogCategory category, std::string_view message,
+              const char* file, int line) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & Mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;  // Full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        Record& record = cell->record;
+        record.level = level;
+        record.category = category;
+        record.time = std::chrono::system_clock::now();
+        record.file = file;
+        record.line = line;
+        record.length = message.size();
+        if (message.size() <= InlineMessageSize) {
+            std::memcpy(record.text, message.data(), message.size());
+        } else {
+            record.overflow.assign(message.data(), message.size());
+        }
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        // Pairs with the writer's store to sleeping before its last look at the ring
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_one();
+        }
+        return true;
+    }
+
+    bool hasRecord() const {
+        const Cell& cell = cells[dequeuePos & Mask];
+        return cell.sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+    }
+
+    // Write everything published so far; returns the number written
+    size_t drain() {
+        size_t count = 0;
+        bool wroteStdout = false;
+        bool wroteStderr = false;
+        while (hasRecord()) {
+            Cell& cell = cells[dequeuePos & Mask];
+            const Record& record = cell.record;
+            FILE* out = (record.level >= LogLevel::Warning) ? stderr : stdout;
+            writeLine(out, record.time, levelToString(record.level), categoryToString(record.category),
+                      record.message(), record.file, record.line);
+            if (out == stderr) {
+                wroteStderr = true;
+            } else {
+                wroteStdout = true;
+            }
+            cell.sequence.store(dequeuePos + QueueCapacity, std::memory_order_release);
+            dequeuePos++;
+            count++;
+        }
+
+        uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+        if (droppedNow != droppedReported) {
+            std::fprintf(stderr, "[Logger] %llu messages dropped (queue full)\n",
+                         static_cast<unsigned long long>(droppedNow - droppedReported));
+            droppedReported = droppedNow;
+            wroteStderr = true;
+        }
+        if (wroteStdout) {
+            std::fflush(stdout);
+        }
+        if (wroteStderr) {
+            std::fflush(stderr);
+        }
+        return count;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            lock.unlock();
+            size_t count = drain();
+            lock.lock();
+            if (count > 0) {
+                written.fetch_add(count, std::memory_order_release);
+                flushed.notify_all();
+            }
+            if (stop) {
+                return;
+            }
+
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!hasRecord()) {
+                // The timeout bounds latency if a producer missed the flag
+                wake.wait_for(lock, std::chrono::milliseconds(50));
+            }
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+};
+
+Logger& Logger::global() {
+    static Logger instance;
+    return instance;
+}
+
+Logger::~Logger() {
+    setAsync(false);
+}
+
+Logger::AsyncState& Logger::asyncState() {
+    if (!asyncState_) {
+        asyncState_ = std::make_unique<AsyncState>();
+    }
+    return *asyncState_;
+}
+
+void Logger::setAsync(bool enable) {
+    if (enable == async_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    AsyncState& state = asyncState();
+    if (enable) {
+        state.stop = false;
+        state.writer = std::thread([&state]() { state.run(); });
+        async_.store(true, std::memory_order_release);
+        return;
+    }
+
+    // New messages go straight out; the writer drains the ring and exits
+    async_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.stop = true;
+        state.wake.notify_one();
+    }
+    state.writer.join();
+    state.written.fetch_add(state.drain(), std::memory_order_release);  // Stragglers published after the last pass
+}
+
+void Logger::flush() {
+    if (async_.load(std::memory_order_acquire)) {
+        AsyncState& state = *asyncState_;
+        size_t target = state.enqueuePos.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.wake.notify_one();
+        state.flushed.wait(lock, [&state, target]() {
+            return state.written.load(std::memory_order_acquire) >= target;
+        });
+        return;
+    }
+    std::fflush(stdout);
+    std::fflush(stderr);
+}
+
+uint64_t Logger::droppedCount() const {
+    return asyncState_ ? asyncState_->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+void Logger::log(LogLevel level, LogCategory category, std::string_view message,
+                 const char* file, int line) {
+    if (!isEnabled(level)) {
+        return;
+    }
+
+    if (async_.load(std::memory_order_acquire)) {
+        asyncState_->push(level, category, message, file, line);
+        if (level == LogLevel::Fatal) {
+            flush();
+        }
+        return;
+    }
 
+    // Select output stream based on level
+    FILE* out = (level >= LogLevel::Warning) ? stderr : stdout;
+    writeLine(out, std::chrono::system_clock::now(), levelToString(level), categoryToString(category),
+              message, file, line);
     std::fflush(out);
 }
 
@@ -84,6 +315,10 @@ void Logger::vulkanMessage(VkDebugUtilsMessageSeverityFlagBitsEXT severity,
         level = LogLevel::Trace;
     }
 
+    // Verbose validation output is usually filtered; skip it before touching the message
+    if (!isEnabled(level)) {
+        return;
+    }
     log(level, LogCategory::Vulkan, data->pMessage);
 }
 
@@ -0,0 +1,322 @@
+#include "finevk/core/profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace finevk {
+
+namespace {
+
+const auto kEpoch = std::chrono::steady_clock::now();
+
+// Constant-initialized, so allocations during static initialization count too
+std::atomic<uint64_t> gAllocations{0};
+
+void writeJsonString(FILE* out, const char* text) {
+    std::fputc('"', out);
+    for (const char* c = text ? text : ""; *c; c++) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\') {
+            std::fputc('\\', out);
+            std::fputc(ch, out);
+        } else if (ch < 0x20) {
+            std::fprintf(out, "\\u%04x", ch);
+        } else {
+            std::fputc(ch, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+} // namespace
+
+// ============================================================================
+// Shared state
+// ============================================================================
+
+/*
+ * Single writer (the owning thread), any number of readers. The writer
+ * announces an index in writing before touching its slot and commits it in
+ * head afterwards, so a reader that copied a slot while it was being reused
+ * sees writing moved past it and drops the copy (a seqlock over the ring).
+ */
+struct Profiler::ThreadRing {
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> duration{0};
+    };
+
+    std::unique_ptr<Slot[]> slots{new Slot[EventsPerThread]};
+    std::atomic<uint64_t> writing{0};   // Index being written + 1
+    std::atomic<uint64_t> head{0};      // Events committed
+    std::atomic<uint64_t> cleared{0};   // Events before this were dropped by clear()
+    uint32_t index = 0;
+    std::string name;                   // Guarded by State::mutex
+};
+
+struct Profiler::State {
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;  // Kept after threads exit
+
+    mutable std::mutex frameMutex;
+    float frameTimes[FrameHistory] = {};  // Milliseconds
+    size_t frameCount = 0;
+    size_t frameNext = 0;
+    uint64_t lastFrameMark = 0;
+    uint64_t lastFrameAllocationMark = 0;
+    uint64_t lastFrameAllocations = 0;
+};
+
+Profiler::State& Profiler::state() {
+    // Leaked so threads still recording during static destruction stay safe
+    static State* instance = new State();
+    return *instance;
+}
+
+Profiler& Profiler::global() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::ThreadRing& Profiler::threadRing() {
+    thread_local ThreadRing* ring = nullptr;
+    if (!ring) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.rings.push_back(std::make_unique<ThreadRing>());
+        ring = s.rings.back().get();
+        ring->index = static_cast<uint32_t>(s.rings.size() - 1);
+        ring->name = "Thread " + std::to_string(ring->index);
+    }
+    return *ring;
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - kEpoch).count());
+}
+
+void Profiler::record(const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadRing& ring = threadRing();
+    uint64_t index = ring.head.load(std::memory_order_relaxed);
+
+    ring.writing.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ThreadRing::Slot& slot = ring.slots[index % EventsPerThread];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(startNs, std::memory_order_relaxed);
+    slot.duration.store(endNs - startNs, std::memory_order_relaxed);
+
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadRing& ring = threadRing();
+    std::lock_guard<std::mutex> lock(state().mutex);
+    ring.name = name;
+}
+
+void Profiler::markFrame() {
+    State& s = state();
+    uint64_t time = now();
+
+    uint64_t allocations = allocationCount();
+
+    std::lock_guard<std::mutex> lock(s.frameMutex);
+    if (s.lastFrameMark != 0) {
+        s.frameTimes[s.frameNext] = static_cast<float>(time - s.lastFrameMark) * 1e-6f;
+        s.frameNext = (s.frameNext + 1) % FrameHistory;
+        s.frameCount = std::min(s.frameCount + 1, FrameHistory);
+        s.lastFrameAllocations = allocations - s.lastFrameAllocationMark;
+    }
+    s.lastFrameMark = time;
+    s.lastFrameAllocationMark = allocations;
+}
+
+uint64_t Profiler::allocationCount() {
+    return gAllocations.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+FrameTimeStats Profiler::frameStats() const {
+    State& s = state();
+    std::vector<float> times;
+    {
+        std::lock_guard<std::mutex> lock(s.frameMutex);
+        times.assign(s.frameTimes, s.frameTimes + s.frameCount);
+    }
+
+    FrameTimeStats stats;
+    stats.frames = times.size();
+    if (times.empty()) {
+        return stats;
+    }
+
+    std::sort(times.begin(), times.end());
+    double sum = 0.0;
+    for (float t : times) {
+        sum += t;
+    }
+
+    // Nearest rank
+    auto percentile = [&times](float p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * static_cast<float>(times.size())));
+        return times[std::min(times.size(), std::max<size_t>(rank, 1)) - 1];
+    };
+
+    stats.mean = static_cast<float>(sum / static_cast<double>(times.size()));
+    stats.p50 = percentile(0.50f);
+    stats.p90 = percentile(0.90f);
+    stats.p99 = percentile(0.99f);
+    stats.max = times.back();
+    return stats;
+}
+
+void Profiler::resetFrameStats() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.frameMutex);
+    s.frameCount = 0;
+    s.frameNext = 0;
+    s.lastFrameMark = 0;
+    s.lastFrameAllocations = 0;
+}
+
+uint64_t Profiler::lastFrameAllocations() const {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.frameMutex);
+    return s.lastFrameAllocations;
+}
+
+std::vector<ProfileEvent> Profiler::collect() const {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    std::vector<ProfileEvent> events;
+    for (const auto& ring : s.rings) {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = head > EventsPerThread ? head - EventsPerThread : 0;
+        begin = std::max(begin, ring->cleared.load(std::memory_order_relaxed));
+
+        size_t first = events.size();
+        for (uint64_t i = begin; i < head; i++) {
+            const ThreadRing::Slot& slot = ring->slots[i % EventsPerThread];
+            ProfileEvent event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.startNs = slot.start.load(std::memory_order_relaxed);
+            event.durationNs = slot.duration.load(std::memory_order_relaxed);
+            event.thread = ring->index;
+            events.push_back(event);
+        }
+
+        // Drop copies of slots the writer reused meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t writing = ring->writing.load(std::memory_order_relaxed);
+        if (writing > EventsPerThread && writing - EventsPerThread > begin) {
+            size_t stale = static_cast<size_t>(std::min(writing - EventsPerThread, head) - begin);
+            events.erase(events.begin() + first, events.begin() + first + stale);
+        }
+    }
+    return events;
+}
+
+std::vector<std::string> Profiler::threadNames() const {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::vector<std::string> names;
+    names.reserve(s.rings.size());
+    for (const auto& ring : s.rings) {
+        names.push_back(ring->name);
+    }
+    return names;
+}
+
+void Profiler::clear() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (auto& ring : s.rings) {
+        ring->cleared.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::vector<ProfileEvent> events = collect();
+    std::vector<std::string> names = threadNames();
+
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        return false;
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", out);
+    bool first = true;
+    for (size_t i = 0; i < names.size(); i++) {
+        std::fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":",
+                     first ? "" : ",\n", i);
+        writeJsonString(out, names[i].c_str());
+        std::fputs("}}", out);
+        first = false;
+    }
+    for (const auto& event : events) {
+        std::fputs(first ? "{\"name\":" : ",\n{\"name\":", out);
+        writeJsonString(out, event.name);
+        std::fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     event.thread, static_cast<double>(event.startNs) * 1e-3,
+                     static_cast<double>(event.durationNs) * 1e-3);
+        first = false;
+    }
+    std::fputs("\n]}\n", out);
+
+    bool ok = std::ferror(out) == 0;
+    return std::fclose(out) == 0 && ok;
+}
+
+} // namespace finevk
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+#ifdef FINEVK_COUNT_ALLOCATIONS
+
+// The array and nothrow forms of the defaults forward to these
+void* operator new(std::size_t size) {
+    finevk::gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    for (;;) {
+        if (void* ptr = std::malloc(size)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#endif
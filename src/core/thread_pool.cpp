@@ -0,0 +1,105 @@
+#include "finevk/core/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace finevk {
+
+ThreadPool::ThreadPool(uint32_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(threads);
+    for (uint32_t i = 0; i < threads; i++) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool instance;
+    return instance;
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;  // Stopping and drained
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+uint32_t ThreadPool::parallelFor(size_t count,
+                                 const std::function<void(size_t, size_t, uint32_t)>& fn,
+                                 uint32_t maxChunks) {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Workers plus the calling thread
+    uint32_t chunks = maxChunks ? maxChunks : threadCount() + 1;
+    chunks = static_cast<uint32_t>(std::min<size_t>(chunks, count));
+
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    chunks = static_cast<uint32_t>((count + chunkSize - 1) / chunkSize);
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunks - 1);
+    for (uint32_t c = 0; c + 1 < chunks; c++) {
+        size_t begin = c * chunkSize;
+        size_t end = std::min(count, begin + chunkSize);
+        futures.push_back(submit([&fn, begin, end, c]() { fn(begin, end, c); }));
+    }
+
+    // Run the last chunk here; wait for the rest even if it throws
+    std::exception_ptr error;
+    try {
+        size_t begin = static_cast<size_t>(chunks - 1) * chunkSize;
+        fn(begin, count, chunks - 1);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return chunks;
+}
+
+} // namespace finevk
@@ -0,0 +1,244 @@
+#include "finevk/device/async_compute.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/rendering/sync.hpp"
+#include "finevk/core/logging.hpp"
+#include "finevk/core/profiler.hpp"
+
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+VkImageSubresourceRange wholeImage(VkImageAspectFlags aspect) {
+    VkImageSubresourceRange range{};
+    range.aspectMask = aspect;
+    range.baseMipLevel = 0;
+    range.levelCount = VK_REMAINING_MIP_LEVELS;
+    range.baseArrayLayer = 0;
+    range.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    return range;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// AsyncCompute::Builder implementation
+// ============================================================================
+
+AsyncCompute::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+AsyncCompute::Builder& AsyncCompute::Builder::framesInFlight(uint32_t count) {
+    framesInFlight_ = count;
+    return *this;
+}
+
+AsyncCompute::Builder& AsyncCompute::Builder::useGraphicsQueue(bool enable) {
+    useGraphicsQueue_ = enable;
+    return *this;
+}
+
+AsyncComputePtr AsyncCompute::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("AsyncCompute requires a device");
+    }
+
+    Queue* graphicsQueue = device_->graphicsQueue();
+    Queue* computeQueue = useGraphicsQueue_ ? nullptr : device_->computeQueue();
+
+    // Cross-queue ordering relies on timeline waits, so without them stay on
+    // the graphics queue where submission order and barriers suffice
+    if (computeQueue && (computeQueue->timeline() == VK_NULL_HANDLE ||
+                         graphicsQueue->timeline() == VK_NULL_HANDLE)) {
+        FINEVK_WARN(LogCategory::Core, "AsyncCompute: no timeline semaphores, compute runs on the graphics queue");
+        computeQueue = nullptr;
+    }
+
+    auto compute = AsyncComputePtr(new AsyncCompute());
+    compute->device_ = device_;
+    compute->graphicsFamily_ = graphicsQueue->familyIndex();
+    compute->ownershipTransfer_ = computeQueue != nullptr &&
+        computeQueue->familyIndex() != graphicsQueue->familyIndex();
+    compute->queue_ = compute->ownershipTransfer_ ? computeQueue : graphicsQueue;
+
+    uint32_t framesInFlight = framesInFlight_ != 0 ? framesInFlight_ : device_->maxFramesInFlight();
+    compute->slots_.resize(framesInFlight);
+    for (auto& slot : compute->slots_) {
+        slot.pool = std::make_unique<CommandPool>(device_, compute->queue_, CommandPoolFlags::Transient);
+        slot.cmd = slot.pool->allocate();
+        if (compute->queue_->timeline() == VK_NULL_HANDLE) {
+            slot.fence = std::make_unique<Fence>(device_, true);
+        }
+    }
+
+    FINEVK_DEBUG(LogCategory::Core,
+        std::string("AsyncCompute created on the ") +
+        (compute->ownershipTransfer_ ? "compute queue" : "graphics queue"));
+
+    return compute;
+}
+
+AsyncCompute::Builder AsyncCompute::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+// ============================================================================
+// AsyncCompute implementation
+// ============================================================================
+
+AsyncCompute::~AsyncCompute() {
+    if (device_ != nullptr) {
+        waitIdle();
+    }
+}
+
+void AsyncCompute::waitSlot(Slot& slot) {
+    if (slot.fence) {
+        slot.fence->wait();
+    } else if (slot.value != 0) {
+        queue_->waitFor(slot.value);
+    }
+}
+
+CommandBuffer& AsyncCompute::begin() {
+    if (recording_) {
+        throw std::runtime_error("AsyncCompute::begin called while a batch is being recorded");
+    }
+
+    Slot& slot = slots_[next_ % slots_.size()];
+    {
+        FINEVK_PROFILE_SCOPE("AsyncCompute::waitSlot");
+        waitSlot(slot);
+    }
+    slot.pool->reset();
+    slot.cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    recording_ = &slot;
+    return *slot.cmd;
+}
+
+TimelinePoint AsyncCompute::submit(const std::vector<TimelinePoint>& waits,
+                                   VkPipelineStageFlags waitStages) {
+    if (!recording_) {
+        throw std::runtime_error("AsyncCompute::submit called without begin");
+    }
+
+    Slot& slot = *recording_;
+    recording_ = nullptr;
+    next_++;
+
+    slot.cmd->end();
+    VkFence fence = VK_NULL_HANDLE;
+    if (slot.fence) {
+        slot.fence->reset();
+        fence = slot.fence->handle();
+    }
+    slot.value = queue_->submitAfter(slot.cmd->handle(), waits, waitStages, {}, {}, {}, fence);
+    last_ = slot.value;
+    return {queue_, slot.value};
+}
+
+void AsyncCompute::waitIdle() {
+    for (auto& slot : slots_) {
+        if (&slot != recording_) {
+            waitSlot(slot);
+        }
+    }
+}
+
+// ============================================================================
+// Ownership transfers
+// ============================================================================
+
+void AsyncCompute::families(QueueHandoff handoff, uint32_t& src, uint32_t& dst) const {
+    uint32_t compute = queue_->familyIndex();
+    src = handoff == QueueHandoff::ComputeToGraphics ? compute : graphicsFamily_;
+    dst = handoff == QueueHandoff::ComputeToGraphics ? graphicsFamily_ : compute;
+}
+
+void AsyncCompute::release(CommandBuffer& cmd, const Buffer& buffer, QueueHandoff handoff,
+                           VkPipelineStageFlags srcStage, VkAccessFlags srcAccess) const {
+    if (!ownershipTransfer_) {
+        return;
+    }
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = 0;
+    families(handoff, barrier.srcQueueFamilyIndex, barrier.dstQueueFamilyIndex);
+    barrier.buffer = buffer.handle();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    cmd.pipelineBarrier(srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, {}, {barrier}, {});
+}
+
+void AsyncCompute::acquire(CommandBuffer& cmd, const Buffer& buffer, QueueHandoff handoff,
+                           VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) const {
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.dstAccessMask = dstAccess;
+    barrier.buffer = buffer.handle();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    if (ownershipTransfer_) {
+        // Visibility comes with the release; this half only takes ownership
+        barrier.srcAccessMask = 0;
+        families(handoff, barrier.srcQueueFamilyIndex, barrier.dstQueueFamilyIndex);
+    } else {
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, dstStage, 0, {}, {barrier}, {});
+}
+
+void AsyncCompute::release(CommandBuffer& cmd, const Image& image, QueueHandoff handoff,
+                           VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                           VkImageLayout oldLayout, VkImageLayout newLayout,
+                           VkImageAspectFlags aspect) const {
+    if (!ownershipTransfer_) {
+        return;
+    }
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    families(handoff, barrier.srcQueueFamilyIndex, barrier.dstQueueFamilyIndex);
+    barrier.image = image.handle();
+    barrier.subresourceRange = wholeImage(aspect);
+    cmd.pipelineBarrier(srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, {}, {}, {barrier});
+}
+
+void AsyncCompute::acquire(CommandBuffer& cmd, const Image& image, QueueHandoff handoff,
+                           VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+                           VkImageLayout oldLayout, VkImageLayout newLayout,
+                           VkImageAspectFlags aspect) const {
+    // With a transfer both halves name the same layouts and the transition
+    // happens once; on a single family this barrier performs it
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.image = image.handle();
+    barrier.subresourceRange = wholeImage(aspect);
+    if (ownershipTransfer_) {
+        barrier.srcAccessMask = 0;
+        families(handoff, barrier.srcQueueFamilyIndex, barrier.dstQueueFamilyIndex);
+    } else {
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, dstStage, 0, {}, {}, {barrier});
+}
+
+} // namespace finevk
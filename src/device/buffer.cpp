@@ -31,6 +31,33 @@ Buffer::Builder& Buffer::Builder::memoryUsage(MemoryUsage memUsage) {
     return *this;
 }
 
+Buffer::Builder& Buffer::Builder::category(MemoryCategory category) {
+    category_ = category;
+    return *this;
+}
+
+Buffer::Builder& Buffer::Builder::relocatable(bool enable) {
+    relocatable_ = enable;
+    return *this;
+}
+
+namespace {
+
+MemoryCategory inferCategory(VkBufferUsageFlags usage, MemoryUsage memUsage) {
+    if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
+        return MemoryCategory::Mesh;
+    }
+    if (usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+        return MemoryCategory::Uniform;
+    }
+    if ((usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT) && memUsage != MemoryUsage::GpuOnly) {
+        return MemoryCategory::Staging;
+    }
+    return MemoryCategory::Other;
+}
+
+} // anonymous namespace
+
 BufferPtr Buffer::Builder::build() {
     if (size_ == 0) {
         throw std::runtime_error("Buffer size must be greater than 0");
@@ -39,10 +66,23 @@ BufferPtr Buffer::Builder::build() {
         throw std::runtime_error("Buffer usage must be specified");
     }
 
+    // Writes to host-visible memory can't follow a move, so only GPU-only buffers are moved
+    bool relocatable = relocatable_;
+    if (relocatable && memUsage_ != MemoryUsage::GpuOnly) {
+        FINEVK_WARN(LogCategory::Core, "Only GpuOnly buffers can be relocated, ignoring relocatable()");
+        relocatable = false;
+    }
+
+    // Moves copy the contents buffer to buffer
+    VkBufferUsageFlags usage = usage_;
+    if (relocatable) {
+        usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    }
+
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     bufferInfo.size = size_;
-    bufferInfo.usage = usage_;
+    bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
     VkBuffer vkBuffer;
@@ -51,14 +91,11 @@ BufferPtr Buffer::Builder::build() {
         throw std::runtime_error("Failed to create buffer");
     }
 
-    // Get memory requirements
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(device_->handle(), vkBuffer, &memRequirements);
-
-    // Allocate memory
+    // Allocate memory (dedicated if the driver asks for it)
     AllocationInfo allocation;
     try {
-        allocation = device_->allocator().allocate(memRequirements, memUsage_);
+        allocation = device_->allocator().allocateForBuffer(vkBuffer, memUsage_,
+            category_.value_or(inferCategory(usage_, memUsage_)));
     } catch (...) {
         vkDestroyBuffer(device_->handle(), vkBuffer, nullptr);
         throw;
@@ -76,9 +113,17 @@ BufferPtr Buffer::Builder::build() {
     buffer->device_ = device_;
     buffer->buffer_ = vkBuffer;
     buffer->size_ = size_;
+    buffer->usage_ = usage;
     buffer->allocation_ = allocation;
     buffer->memoryUsage_ = memUsage_;
 
+    // Dedicated allocations have no block to compact; mapped ones (unified
+    // memory) would leave cached mappedPtr() values pointing at the old range
+    if (relocatable && allocation.block && !allocation.mappedPtr) {
+        buffer->relocatable_ = true;
+        device_->allocator().registerRelocatable(buffer.get());
+    }
+
     return buffer;
 }
 
@@ -110,7 +155,7 @@ BufferPtr Buffer::createUniformBuffer(LogicalDevice* device, VkDeviceSize size)
     return create(device)
         .size(size)
         .usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
-        .memoryUsage(MemoryUsage::CpuToGpu)
+        .memoryUsage(MemoryUsage::GpuDirectWrite)
         .build();
 }
 
@@ -130,8 +175,11 @@ Buffer::Buffer(Buffer&& other) noexcept
     : device_(other.device_)
     , buffer_(other.buffer_)
     , size_(other.size_)
+    , usage_(other.usage_)
     , allocation_(other.allocation_)
-    , memoryUsage_(other.memoryUsage_) {
+    , memoryUsage_(other.memoryUsage_)
+    , relocationCallback_(std::move(other.relocationCallback_)) {
+    takeRelocation(other);
     other.buffer_ = VK_NULL_HANDLE;
     other.allocation_ = {};
 }
@@ -142,22 +190,99 @@ Buffer& Buffer::operator=(Buffer&& other) noexcept {
         device_ = other.device_;
         buffer_ = other.buffer_;
         size_ = other.size_;
+        usage_ = other.usage_;
         allocation_ = other.allocation_;
         memoryUsage_ = other.memoryUsage_;
+        relocationCallback_ = std::move(other.relocationCallback_);
+        takeRelocation(other);
         other.buffer_ = VK_NULL_HANDLE;
         other.allocation_ = {};
     }
     return *this;
 }
 
+void Buffer::takeRelocation(Buffer& other) {
+    // The allocator tracks relocatable buffers by address; a pending move comes along
+    if (other.relocatable_) {
+        movingBuffer_ = other.movingBuffer_;
+        movingAllocation_ = other.movingAllocation_;
+        other.movingBuffer_ = VK_NULL_HANDLE;
+        other.movingAllocation_ = {};
+        other.relocatable_ = false;
+        relocatable_ = true;
+        device_->allocator().transferRelocatable(&other, this);
+    }
+}
+
 void Buffer::cleanup() {
+    bool copying = false;
+    if (relocatable_) {
+        copying = device_->allocator().unregisterRelocatable(this);  // Cancels a pending move
+        relocatable_ = false;
+    }
     if (buffer_ != VK_NULL_HANDLE && device_ != nullptr) {
-        vkDestroyBuffer(device_->handle(), buffer_, nullptr);
-        device_->allocator().free(allocation_);
+        if (copying) {
+            // The cancelled move's copy may still be reading this buffer
+            VkDevice device = device_->handle();
+            VkBuffer buffer = buffer_;
+            device_->allocator().retire([device, buffer]() { vkDestroyBuffer(device, buffer, nullptr); },
+                                        allocation_);
+        } else {
+            vkDestroyBuffer(device_->handle(), buffer_, nullptr);
+            device_->allocator().free(allocation_);
+        }
         buffer_ = VK_NULL_HANDLE;
     }
 }
 
+bool Buffer::beginMove(CommandBuffer& cmd, const AllocationInfo& target) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size_;
+    bufferInfo.usage = usage_;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer moving;
+    if (vkCreateBuffer(device_->handle(), &bufferInfo, nullptr, &moving) != VK_SUCCESS) {
+        return false;
+    }
+    if (vkBindBufferMemory(device_->handle(), moving, target.memory, target.offset) != VK_SUCCESS) {
+        vkDestroyBuffer(device_->handle(), moving, nullptr);
+        return false;
+    }
+
+    VkBufferCopy region{};
+    region.size = size_;
+    vkCmdCopyBuffer(cmd.handle(), buffer_, moving, 1, &region);
+
+    movingBuffer_ = moving;
+    movingAllocation_ = target;
+    return true;
+}
+
+std::function<void()> Buffer::commitMove() {
+    VkDevice device = device_->handle();
+    VkBuffer old = buffer_;
+
+    buffer_ = movingBuffer_;
+    allocation_ = movingAllocation_;
+    movingBuffer_ = VK_NULL_HANDLE;
+    movingAllocation_ = {};
+
+    if (relocationCallback_) {
+        relocationCallback_(*this);
+    }
+    return [device, old]() { vkDestroyBuffer(device, old, nullptr); };
+}
+
+std::function<void()> Buffer::cancelMove() {
+    VkDevice device = device_->handle();
+    VkBuffer moving = movingBuffer_;
+    movingBuffer_ = VK_NULL_HANDLE;
+    movingAllocation_ = {};
+    return [device, moving]() { vkDestroyBuffer(device, moving, nullptr); };
+}
+
 void* Buffer::map() {
     if (allocation_.mappedPtr) {
         return allocation_.mappedPtr;
@@ -167,28 +292,42 @@ void* Buffer::map() {
         throw std::runtime_error("Cannot map GPU-only buffer");
     }
 
-    void* data;
-    VkResult result = vkMapMemory(device_->handle(), allocation_.memory,
-                                  allocation_.offset, size_, 0, &data);
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error("Failed to map buffer memory");
-    }
-
-    allocation_.mappedPtr = data;
-    return data;
+    // Maps only this buffer's range; pooled allocations reuse the block mapping
+    return device_->allocator().map(allocation_);
 }
 
 void Buffer::unmap() {
+    device_->allocator().unmap(allocation_);
+}
+
+bool Buffer::isCoherent() const {
+    return device_->allocator().isCoherent(allocation_);
+}
+
+void Buffer::flush(VkDeviceSize offset, VkDeviceSize size) {
+    if (allocation_.mappedPtr) {
+        device_->allocator().flush(allocation_, offset, size);
+    }
+}
+
+void Buffer::invalidate(VkDeviceSize offset, VkDeviceSize size) {
     if (allocation_.mappedPtr) {
-        vkUnmapMemory(device_->handle(), allocation_.memory);
-        allocation_.mappedPtr = nullptr;
+        device_->allocator().invalidate(allocation_, offset, size);
+    }
+}
+
+void Buffer::checkWritable() const {
+    if (movePending()) {
+        throw std::runtime_error("Cannot write to a buffer while its relocation is pending");
     }
 }
 
 void Buffer::upload(const void* data, VkDeviceSize dataSize, VkDeviceSize offset) {
+    checkWritable();
     if (isMappable()) {
         // Direct copy for CPU-visible buffers
         std::memcpy(static_cast<char*>(allocation_.mappedPtr) + offset, data, dataSize);
+        flush(offset, dataSize);
     } else {
         // Need staging buffer - but we don't have a command pool here
         throw std::runtime_error(
@@ -199,19 +338,45 @@ void Buffer::upload(const void* data, VkDeviceSize dataSize, VkDeviceSize offset
 
 void Buffer::upload(const void* data, VkDeviceSize dataSize, VkDeviceSize offset,
                     CommandPool* commandPool) {
+    checkWritable();
     if (isMappable()) {
         // Direct copy for CPU-visible buffers
         std::memcpy(static_cast<char*>(allocation_.mappedPtr) + offset, data, dataSize);
+        flush(offset, dataSize);
     } else {
         // Create staging buffer and copy
         auto staging = createStagingBuffer(device_, dataSize);
         std::memcpy(staging->mappedPtr(), data, dataSize);
 
-        copyFrom(*staging, dataSize, commandPool);
+        auto imm = commandPool->beginImmediate();
+        imm.cmd().copyBuffer(*staging, *this, dataSize, 0, offset);
+        imm.submit();
     }
 }
 
+SubmitTicket Buffer::uploadAsync(const void* data, VkDeviceSize dataSize, VkDeviceSize offset,
+                                 CommandPool* commandPool) {
+    checkWritable();
+    if (isMappable()) {
+        std::memcpy(static_cast<char*>(allocation_.mappedPtr) + offset, data, dataSize);
+        flush(offset, dataSize);
+        return SubmitTicket();
+    }
+
+    auto staging = createStagingBuffer(device_, dataSize);
+    std::memcpy(staging->mappedPtr(), data, dataSize);
+
+    auto imm = commandPool->beginImmediate();
+    imm.cmd().copyBuffer(*staging, *this, dataSize, 0, offset);
+    SubmitTicket ticket = imm.submitAsync();
+
+    // Staging memory must outlive the copy
+    ticket.keepAlive(std::move(staging));
+    return ticket;
+}
+
 void Buffer::copyFrom(Buffer& src, VkDeviceSize copySize, CommandPool* commandPool) {
+    checkWritable();
     auto imm = commandPool->beginImmediate();
     imm.cmd().copyBuffer(src, *this, copySize);
     imm.submit();
@@ -2,10 +2,12 @@
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/buffer.hpp"
 #include "finevk/device/image.hpp"
+#include "finevk/device/gpu_profiler.hpp"
 #include "finevk/rendering/pipeline.hpp"
 #include "finevk/rendering/render_target.hpp"
 #include "finevk/rendering/renderpass.hpp"
 #include "finevk/rendering/framebuffer.hpp"
+#include "finevk/rendering/sync.hpp"
 #include "finevk/core/logging.hpp"
 
 #include <stdexcept>
@@ -107,6 +109,74 @@ void CommandPool::reset() {
     vkResetCommandPool(device_->handle(), pool_, 0);
 }
 
+// ============================================================================
+// FrameCommandPools implementation
+// ============================================================================
+
+FrameCommandPools::FrameCommandPools(LogicalDevice* device, Queue* queue,
+                                     uint32_t framesInFlight, uint32_t threadCount,
+                                     CommandPoolFlags flags)
+    : framesInFlight_(framesInFlight != 0 ? framesInFlight : device->maxFramesInFlight())
+    , threadCount_(threadCount) {
+    if (threadCount == 0) {
+        throw std::runtime_error("FrameCommandPools requires at least one thread");
+    }
+
+    slots_.resize(static_cast<size_t>(framesInFlight_) * threadCount);
+    for (auto& slot : slots_) {
+        slot.pool = std::make_unique<CommandPool>(device, queue, flags);
+    }
+}
+
+void FrameCommandPools::beginFrame(uint32_t frameIndex) {
+    currentFrame_ = frameIndex % framesInFlight_;
+
+    for (uint32_t t = 0; t < threadCount_; t++) {
+        Slot& s = slot(t);
+        s.pool->reset();
+        s.usedPrimaries = 0;
+        s.usedSecondaries = 0;
+    }
+}
+
+CommandBuffer& FrameCommandPools::acquire(uint32_t thread, VkCommandBufferLevel level) {
+    Slot& s = slot(thread);
+
+    bool secondary = (level == VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    auto& cache = secondary ? s.secondaries : s.primaries;
+    size_t& used = secondary ? s.usedSecondaries : s.usedPrimaries;
+
+    if (used == cache.size()) {
+        cache.push_back(s.pool->allocate(level));
+    }
+    return *cache[used++];
+}
+
+CommandPool& FrameCommandPools::pool(uint32_t thread) {
+    return *slot(thread).pool;
+}
+
+CommandStats FrameCommandPools::stats() const {
+    CommandStats total;
+    for (uint32_t t = 0; t < threadCount_; t++) {
+        const Slot& s = slots_[static_cast<size_t>(currentFrame_) * threadCount_ + t];
+        for (size_t i = 0; i < s.usedPrimaries; i++) {
+            total += s.primaries[i]->stats();
+        }
+        for (size_t i = 0; i < s.usedSecondaries; i++) {
+            total += s.secondaries[i]->stats();
+        }
+    }
+    return total;
+}
+
+FrameCommandPools::Slot& FrameCommandPools::slot(uint32_t thread) {
+    if (thread >= threadCount_) {
+        throw std::runtime_error("FrameCommandPools thread index out of range");
+    }
+    return slots_[static_cast<size_t>(currentFrame_) * threadCount_ + thread];
+}
+
 // ============================================================================
 // CommandBuffer implementation
 // ============================================================================
@@ -121,7 +191,17 @@ CommandBuffer::~CommandBuffer() {
 
 CommandBuffer::CommandBuffer(CommandBuffer&& other) noexcept
     : pool_(other.pool_)
-    , buffer_(other.buffer_) {
+    , buffer_(other.buffer_)
+    , activeRenderPass_(other.activeRenderPass_)
+    , activeFramebuffer_(other.activeFramebuffer_)
+    , activeSubpass_(other.activeSubpass_)
+    , activeContents_(other.activeContents_)
+    , viewport_(other.viewport_)
+    , scissor_(other.scissor_)
+    , hasViewport_(other.hasViewport_)
+    , hasScissor_(other.hasScissor_)
+    , profiler_(other.profiler_)
+    , stats_(other.stats_) {
     other.buffer_ = VK_NULL_HANDLE;
 }
 
@@ -130,6 +210,16 @@ CommandBuffer& CommandBuffer::operator=(CommandBuffer&& other) noexcept {
         cleanup();
         pool_ = other.pool_;
         buffer_ = other.buffer_;
+        activeRenderPass_ = other.activeRenderPass_;
+        activeFramebuffer_ = other.activeFramebuffer_;
+        activeSubpass_ = other.activeSubpass_;
+        activeContents_ = other.activeContents_;
+        viewport_ = other.viewport_;
+        scissor_ = other.scissor_;
+        hasViewport_ = other.hasViewport_;
+        hasScissor_ = other.hasScissor_;
+        profiler_ = other.profiler_;
+        stats_ = other.stats_;
         other.buffer_ = VK_NULL_HANDLE;
     }
     return *this;
@@ -151,6 +241,12 @@ void CommandBuffer::begin(VkCommandBufferUsageFlags flags) {
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to begin recording command buffer");
     }
+
+    activeRenderPass_ = VK_NULL_HANDLE;
+    activeFramebuffer_ = VK_NULL_HANDLE;
+    hasViewport_ = false;
+    hasScissor_ = false;
+    stats_ = {};
 }
 
 void CommandBuffer::end() {
@@ -162,69 +258,155 @@ void CommandBuffer::end() {
 
 void CommandBuffer::reset() {
     vkResetCommandBuffer(buffer_, 0);
+    activeRenderPass_ = VK_NULL_HANDLE;
+    activeFramebuffer_ = VK_NULL_HANDLE;
+    hasViewport_ = false;
+    hasScissor_ = false;
+}
+
+void CommandBuffer::beginSecondary(VkRenderPass renderPass, uint32_t subpass,
+                                   VkFramebuffer framebuffer,
+                                   VkCommandBufferUsageFlags flags) {
+    beginInherited(renderPass, subpass, framebuffer, flags, 0);
+}
+
+void CommandBuffer::beginInherited(VkRenderPass renderPass, uint32_t subpass,
+                                   VkFramebuffer framebuffer, VkCommandBufferUsageFlags flags,
+                                   VkQueryPipelineStatisticFlags pipelineStatistics) {
+    VkCommandBufferInheritanceInfo inheritance{};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = renderPass;
+    inheritance.subpass = subpass;
+    inheritance.framebuffer = framebuffer;
+    inheritance.pipelineStatistics = pipelineStatistics;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = flags;
+    if (renderPass != VK_NULL_HANDLE) {
+        beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    }
+    beginInfo.pInheritanceInfo = &inheritance;
+
+    VkResult result = vkBeginCommandBuffer(buffer_, &beginInfo);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording secondary command buffer");
+    }
+
+    hasViewport_ = false;
+    hasScissor_ = false;
+    stats_ = {};
+}
+
+void CommandBuffer::beginSecondary(const CommandBuffer& primary, VkCommandBufferUsageFlags flags) {
+    // An active frame statistics query must be declared as inherited
+    VkQueryPipelineStatisticFlags statistics =
+        primary.profiler_ ? primary.profiler_->pipelineStatisticsFlags() : 0;
+    beginInherited(primary.activeRenderPass_, primary.activeSubpass_,
+                   primary.activeFramebuffer_, flags, statistics);
+
+    if (primary.hasViewport_) {
+        setViewport(primary.viewport_);
+    }
+    if (primary.hasScissor_) {
+        setScissor(primary.scissor_);
+    }
+}
+
+void CommandBuffer::executeCommands(Span<const VkCommandBuffer> secondaries) {
+    if (!secondaries.empty()) {
+        vkCmdExecuteCommands(buffer_, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+        stats_.secondaries += static_cast<uint32_t>(secondaries.size());
+    }
+}
+
+void CommandBuffer::executeCommands(CommandBuffer& secondary) {
+    vkCmdExecuteCommands(buffer_, 1, &secondary.buffer_);
+    stats_.secondaries++;
 }
 
 void CommandBuffer::bindPipeline(VkPipelineBindPoint bindPoint, VkPipeline pipeline) {
     vkCmdBindPipeline(buffer_, bindPoint, pipeline);
+    stats_.pipelineBinds++;
 }
 
 void CommandBuffer::bindPipeline(GraphicsPipeline& pipeline) {
     vkCmdBindPipeline(buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.handle());
+    stats_.pipelineBinds++;
 }
 
 void CommandBuffer::bindDescriptorSets(
     VkPipelineBindPoint bindPoint,
     VkPipelineLayout layout,
     uint32_t firstSet,
-    const std::vector<VkDescriptorSet>& sets,
-    const std::vector<uint32_t>& dynamicOffsets) {
+    Span<const VkDescriptorSet> sets,
+    Span<const uint32_t> dynamicOffsets) {
 
     vkCmdBindDescriptorSets(
         buffer_, bindPoint, layout, firstSet,
         static_cast<uint32_t>(sets.size()), sets.data(),
         static_cast<uint32_t>(dynamicOffsets.size()),
         dynamicOffsets.empty() ? nullptr : dynamicOffsets.data());
+    stats_.descriptorBinds++;
 }
 
 void CommandBuffer::bindDescriptorSets(
     PipelineLayout& layout,
     uint32_t firstSet,
-    const std::vector<VkDescriptorSet>& sets) {
+    Span<const VkDescriptorSet> sets,
+    Span<const uint32_t> dynamicOffsets) {
 
     vkCmdBindDescriptorSets(
         buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, layout.handle(), firstSet,
-        static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+        static_cast<uint32_t>(sets.size()), sets.data(),
+        static_cast<uint32_t>(dynamicOffsets.size()),
+        dynamicOffsets.empty() ? nullptr : dynamicOffsets.data());
+    stats_.descriptorBinds++;
 }
 
 void CommandBuffer::bindDescriptorSet(PipelineLayout& layout, VkDescriptorSet set, uint32_t setIndex) {
     vkCmdBindDescriptorSets(
         buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, layout.handle(),
         setIndex, 1, &set, 0, nullptr);
+    stats_.descriptorBinds++;
+}
+
+void CommandBuffer::bindDescriptorSet(PipelineLayout& layout, VkDescriptorSet set, uint32_t setIndex,
+                                      uint32_t dynamicOffset) {
+    vkCmdBindDescriptorSets(
+        buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, layout.handle(),
+        setIndex, 1, &set, 1, &dynamicOffset);
+    stats_.descriptorBinds++;
 }
 
 void CommandBuffer::bindVertexBuffer(Buffer& buffer, VkDeviceSize offset) {
     VkBuffer buffers[] = {buffer.handle()};
     VkDeviceSize offsets[] = {offset};
     vkCmdBindVertexBuffers(buffer_, 0, 1, buffers, offsets);
+    stats_.vertexBufferBinds++;
 }
 
 void CommandBuffer::bindVertexBuffers(
     uint32_t firstBinding,
-    const std::vector<VkBuffer>& buffers,
-    const std::vector<VkDeviceSize>& offsets) {
+    Span<const VkBuffer> buffers,
+    Span<const VkDeviceSize> offsets) {
 
     vkCmdBindVertexBuffers(
         buffer_, firstBinding,
         static_cast<uint32_t>(buffers.size()),
         buffers.data(), offsets.data());
+    stats_.vertexBufferBinds++;
 }
 
 void CommandBuffer::bindIndexBuffer(Buffer& buffer, VkIndexType type, VkDeviceSize offset) {
     vkCmdBindIndexBuffer(buffer_, buffer.handle(), offset, type);
+    stats_.indexBufferBinds++;
 }
 
 void CommandBuffer::setViewport(const VkViewport& viewport) {
     vkCmdSetViewport(buffer_, 0, 1, &viewport);
+    viewport_ = viewport;
+    hasViewport_ = true;
 }
 
 void CommandBuffer::setViewport(float x, float y, float width, float height,
@@ -241,6 +423,8 @@ void CommandBuffer::setViewport(float x, float y, float width, float height,
 
 void CommandBuffer::setScissor(const VkRect2D& scissor) {
     vkCmdSetScissor(buffer_, 0, 1, &scissor);
+    scissor_ = scissor;
+    hasScissor_ = true;
 }
 
 void CommandBuffer::setScissor(int32_t x, int32_t y, uint32_t width, uint32_t height) {
@@ -255,15 +439,62 @@ void CommandBuffer::setViewportAndScissor(uint32_t width, uint32_t height) {
     setScissor(0, 0, width, height);
 }
 
+void CommandBuffer::setFragmentShadingRate(VkExtent2D fragmentSize,
+                                           VkFragmentShadingRateCombinerOpKHR primitiveCombiner,
+                                           VkFragmentShadingRateCombinerOpKHR attachmentCombiner) {
+    auto setFn = pool_->device()->cmdSetFragmentShadingRate();
+    if (!setFn) {
+        throw std::runtime_error("Fragment shading rate not enabled on this device");
+    }
+    const VkFragmentShadingRateCombinerOpKHR combiners[2] = {primitiveCombiner, attachmentCombiner};
+    setFn(buffer_, &fragmentSize, combiners);
+}
+
 void CommandBuffer::draw(uint32_t vertexCount, uint32_t instanceCount,
                          uint32_t firstVertex, uint32_t firstInstance) {
     vkCmdDraw(buffer_, vertexCount, instanceCount, firstVertex, firstInstance);
+    stats_.draws++;
+    stats_.instances += instanceCount;
+    stats_.triangles += static_cast<uint64_t>(vertexCount / 3) * instanceCount;
 }
 
 void CommandBuffer::drawIndexed(uint32_t indexCount, uint32_t instanceCount,
                                 uint32_t firstIndex, int32_t vertexOffset,
                                 uint32_t firstInstance) {
     vkCmdDrawIndexed(buffer_, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    stats_.draws++;
+    stats_.instances += instanceCount;
+    stats_.triangles += static_cast<uint64_t>(indexCount / 3) * instanceCount;
+}
+
+void CommandBuffer::drawIndirect(Buffer& buffer, VkDeviceSize offset,
+                                 uint32_t drawCount, uint32_t stride) {
+    vkCmdDrawIndirect(buffer_, buffer.handle(), offset, drawCount, stride);
+    stats_.indirectDraws++;
+}
+
+void CommandBuffer::drawIndexedIndirect(Buffer& buffer, VkDeviceSize offset,
+                                        uint32_t drawCount, uint32_t stride) {
+    vkCmdDrawIndexedIndirect(buffer_, buffer.handle(), offset, drawCount, stride);
+    stats_.indirectDraws++;
+}
+
+void CommandBuffer::drawIndexedIndirectCount(Buffer& buffer, VkDeviceSize offset,
+                                             Buffer& countBuffer, VkDeviceSize countOffset,
+                                             uint32_t maxDrawCount, uint32_t stride) {
+    vkCmdDrawIndexedIndirectCount(buffer_, buffer.handle(), offset,
+                                  countBuffer.handle(), countOffset, maxDrawCount, stride);
+    stats_.indirectDraws++;
+}
+
+void CommandBuffer::dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+    vkCmdDispatch(buffer_, groupCountX, groupCountY, groupCountZ);
+    stats_.dispatches++;
+}
+
+void CommandBuffer::fillBuffer(Buffer& buffer, uint32_t data, VkDeviceSize offset, VkDeviceSize size) {
+    vkCmdFillBuffer(buffer_, buffer.handle(), offset, size, data);
+    stats_.transfers++;
 }
 
 void CommandBuffer::pushConstants(
@@ -273,13 +504,14 @@ void CommandBuffer::pushConstants(
     uint32_t size,
     const void* data) {
     vkCmdPushConstants(buffer_, layout, stageFlags, offset, size, data);
+    stats_.pushConstants++;
 }
 
 void CommandBuffer::beginRenderPass(
     VkRenderPass renderPass,
     VkFramebuffer framebuffer,
     VkRect2D renderArea,
-    const std::vector<VkClearValue>& clearValues,
+    Span<const VkClearValue> clearValues,
     VkSubpassContents contents) {
 
     VkRenderPassBeginInfo renderPassInfo{};
@@ -291,20 +523,29 @@ void CommandBuffer::beginRenderPass(
     renderPassInfo.pClearValues = clearValues.data();
 
     vkCmdBeginRenderPass(buffer_, &renderPassInfo, contents);
+    stats_.renderPasses++;
+
+    activeRenderPass_ = renderPass;
+    activeFramebuffer_ = framebuffer;
+    activeSubpass_ = 0;
+    activeContents_ = contents;
 }
 
 void CommandBuffer::beginRenderPass(
     RenderTarget& renderTarget,
     const glm::vec4& clearColor,
-    float clearDepth) {
+    float clearDepth,
+    VkSubpassContents contents) {
 
     // Build clear values
-    std::vector<VkClearValue> clearValues;
+    SmallVector<VkClearValue, 2> clearValues;
 
-    // Color clear
-    VkClearValue colorClear{};
-    colorClear.color = {{clearColor.r, clearColor.g, clearColor.b, clearColor.a}};
-    clearValues.push_back(colorClear);
+    // Color clear (depth-only targets have none)
+    if (renderTarget.hasColor()) {
+        VkClearValue colorClear{};
+        colorClear.color = {{clearColor.r, clearColor.g, clearColor.b, clearColor.a}};
+        clearValues.push_back(colorClear);
+    }
 
     // Depth clear if render target has depth
     if (renderTarget.hasDepth()) {
@@ -313,6 +554,14 @@ void CommandBuffer::beginRenderPass(
         clearValues.push_back(depthClear);
     }
 
+    if (renderTarget.usesDynamicRendering()) {
+        if (contents != VK_SUBPASS_CONTENTS_INLINE) {
+            throw std::runtime_error("Dynamic rendering targets record inline, not into secondaries");
+        }
+        renderTarget.begin(*this, ClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a), clearDepth);
+        return;
+    }
+
     // Get render area from render target extent
     VkRect2D renderArea{};
     renderArea.offset = {0, 0};
@@ -323,15 +572,34 @@ void CommandBuffer::beginRenderPass(
         renderTarget.renderPass()->handle(),
         renderTarget.currentFramebuffer()->handle(),
         renderArea,
-        clearValues);
+        clearValues,
+        contents);
 }
 
 void CommandBuffer::endRenderPass() {
     vkCmdEndRenderPass(buffer_);
+    activeRenderPass_ = VK_NULL_HANDLE;
+    activeFramebuffer_ = VK_NULL_HANDLE;
 }
 
 void CommandBuffer::nextSubpass(VkSubpassContents contents) {
     vkCmdNextSubpass(buffer_, contents);
+    activeSubpass_++;
+    activeContents_ = contents;
+}
+
+void CommandBuffer::beginRendering(const VkRenderingInfoKHR& info) {
+    auto beginFn = pool_->device()->cmdBeginRendering();
+    if (!beginFn) {
+        throw std::runtime_error("Dynamic rendering not enabled on this device");
+    }
+    beginFn(buffer_, &info);
+    stats_.renderPasses++;
+    activeContents_ = VK_SUBPASS_CONTENTS_INLINE;
+}
+
+void CommandBuffer::endRendering() {
+    pool_->device()->cmdEndRendering()(buffer_);
 }
 
 void CommandBuffer::copyBuffer(Buffer& src, Buffer& dst, VkDeviceSize size,
@@ -341,6 +609,8 @@ void CommandBuffer::copyBuffer(Buffer& src, Buffer& dst, VkDeviceSize size,
     copyRegion.dstOffset = dstOffset;
     copyRegion.size = size;
     vkCmdCopyBuffer(buffer_, src.handle(), dst.handle(), 1, &copyRegion);
+    stats_.transfers++;
+    stats_.transferBytes += size;
 }
 
 void CommandBuffer::copyBufferToImage(Buffer& src, Image& dst, VkImageLayout dstLayout) {
@@ -356,6 +626,7 @@ void CommandBuffer::copyBufferToImage(Buffer& src, Image& dst, VkImageLayout dst
     region.imageExtent = dst.extent();
 
     vkCmdCopyBufferToImage(buffer_, src.handle(), dst.handle(), dstLayout, 1, &region);
+    stats_.transfers++;
 }
 
 void CommandBuffer::transitionImageLayout(
@@ -375,7 +646,7 @@ void CommandBuffer::transitionImageLayout(
     barrier.subresourceRange.baseMipLevel = 0;
     barrier.subresourceRange.levelCount = image.mipLevels();
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = image.arrayLayers();
 
     VkPipelineStageFlags sourceStage;
     VkPipelineStageFlags destinationStage;
@@ -425,15 +696,16 @@ void CommandBuffer::transitionImageLayout(
         0, nullptr,
         0, nullptr,
         1, &barrier);
+    stats_.barriers++;
 }
 
 void CommandBuffer::pipelineBarrier(
     VkPipelineStageFlags srcStageMask,
     VkPipelineStageFlags dstStageMask,
     VkDependencyFlags dependencyFlags,
-    const std::vector<VkMemoryBarrier>& memoryBarriers,
-    const std::vector<VkBufferMemoryBarrier>& bufferMemoryBarriers,
-    const std::vector<VkImageMemoryBarrier>& imageMemoryBarriers) {
+    Span<const VkMemoryBarrier> memoryBarriers,
+    Span<const VkBufferMemoryBarrier> bufferMemoryBarriers,
+    Span<const VkImageMemoryBarrier> imageMemoryBarriers) {
 
     vkCmdPipelineBarrier(
         buffer_,
@@ -445,12 +717,262 @@ void CommandBuffer::pipelineBarrier(
         bufferMemoryBarriers.empty() ? nullptr : bufferMemoryBarriers.data(),
         static_cast<uint32_t>(imageMemoryBarriers.size()),
         imageMemoryBarriers.empty() ? nullptr : imageMemoryBarriers.data());
+    stats_.barriers++;
+}
+
+void CommandBuffer::memoryBarrier(VkPipelineStageFlags srcStageMask, VkAccessFlags srcAccessMask,
+                                  VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask) {
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccessMask;
+    barrier.dstAccessMask = dstAccessMask;
+    vkCmdPipelineBarrier(buffer_, srcStageMask, dstStageMask, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    stats_.barriers++;
+}
+
+void CommandBuffer::pipelineBarrier2(const VkDependencyInfoKHR& dependency) {
+    if (PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2 = pool_->device()->cmdPipelineBarrier2()) {
+        cmdPipelineBarrier2(buffer_, &dependency);
+        stats_.barriers++;
+        return;
+    }
+
+    // Fallback: one original barrier over the union of every scope
+    VkPipelineStageFlags2KHR srcStages = 0;
+    VkPipelineStageFlags2KHR dstStages = 0;
+    SmallVector<VkMemoryBarrier, 4> memoryBarriers(dependency.memoryBarrierCount);
+    for (uint32_t i = 0; i < dependency.memoryBarrierCount; i++) {
+        const auto& barrier2 = dependency.pMemoryBarriers[i];
+        srcStages |= barrier2.srcStageMask;
+        dstStages |= barrier2.dstStageMask;
+        auto& barrier = memoryBarriers[i];
+        barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = legacyAccessMask(barrier2.srcAccessMask);
+        barrier.dstAccessMask = legacyAccessMask(barrier2.dstAccessMask);
+    }
+    SmallVector<VkBufferMemoryBarrier, 4> bufferBarriers(dependency.bufferMemoryBarrierCount);
+    for (uint32_t i = 0; i < dependency.bufferMemoryBarrierCount; i++) {
+        const auto& barrier2 = dependency.pBufferMemoryBarriers[i];
+        srcStages |= barrier2.srcStageMask;
+        dstStages |= barrier2.dstStageMask;
+        auto& barrier = bufferBarriers[i];
+        barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = legacyAccessMask(barrier2.srcAccessMask);
+        barrier.dstAccessMask = legacyAccessMask(barrier2.dstAccessMask);
+        barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+        barrier.buffer = barrier2.buffer;
+        barrier.offset = barrier2.offset;
+        barrier.size = barrier2.size;
+    }
+    SmallVector<VkImageMemoryBarrier, 4> imageBarriers(dependency.imageMemoryBarrierCount);
+    for (uint32_t i = 0; i < dependency.imageMemoryBarrierCount; i++) {
+        const auto& barrier2 = dependency.pImageMemoryBarriers[i];
+        srcStages |= barrier2.srcStageMask;
+        dstStages |= barrier2.dstStageMask;
+        auto& barrier = imageBarriers[i];
+        barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = legacyAccessMask(barrier2.srcAccessMask);
+        barrier.dstAccessMask = legacyAccessMask(barrier2.dstAccessMask);
+        barrier.oldLayout = barrier2.oldLayout;
+        barrier.newLayout = barrier2.newLayout;
+        barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+        barrier.image = barrier2.image;
+        barrier.subresourceRange = barrier2.subresourceRange;
+    }
+
+    pipelineBarrier(legacyStageMask(srcStages, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
+                    legacyStageMask(dstStages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT),
+                    dependency.dependencyFlags, memoryBarriers, bufferBarriers, imageBarriers);
+}
+
+void CommandBuffer::pipelineBarrier2(
+    Span<const VkMemoryBarrier2KHR> memoryBarriers,
+    Span<const VkBufferMemoryBarrier2KHR> bufferMemoryBarriers,
+    Span<const VkImageMemoryBarrier2KHR> imageMemoryBarriers,
+    VkDependencyFlags dependencyFlags) {
+
+    VkDependencyInfoKHR dependency{};
+    dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependency.dependencyFlags = dependencyFlags;
+    dependency.memoryBarrierCount = static_cast<uint32_t>(memoryBarriers.size());
+    dependency.pMemoryBarriers = memoryBarriers.empty() ? nullptr : memoryBarriers.data();
+    dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferMemoryBarriers.size());
+    dependency.pBufferMemoryBarriers = bufferMemoryBarriers.empty() ? nullptr : bufferMemoryBarriers.data();
+    dependency.imageMemoryBarrierCount = static_cast<uint32_t>(imageMemoryBarriers.size());
+    dependency.pImageMemoryBarriers = imageMemoryBarriers.empty() ? nullptr : imageMemoryBarriers.data();
+    pipelineBarrier2(dependency);
+}
+
+void CommandBuffer::memoryBarrier2(VkPipelineStageFlags2KHR srcStageMask, VkAccessFlags2KHR srcAccessMask,
+                                   VkPipelineStageFlags2KHR dstStageMask, VkAccessFlags2KHR dstAccessMask) {
+    VkMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+    barrier.srcStageMask = srcStageMask;
+    barrier.srcAccessMask = srcAccessMask;
+    barrier.dstStageMask = dstStageMask;
+    barrier.dstAccessMask = dstAccessMask;
+
+    VkDependencyInfoKHR dependency{};
+    dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependency.memoryBarrierCount = 1;
+    dependency.pMemoryBarriers = &barrier;
+    pipelineBarrier2(dependency);
+}
+
+void CommandBuffer::beginScope(const char* name) {
+    if (profiler_) {
+        profiler_->beginScope(*this, name);
+    }
+}
+
+void CommandBuffer::endScope() {
+    if (profiler_) {
+        profiler_->endScope(*this);
+    }
+}
+
+// ============================================================================
+// Synchronization2 helpers
+// ============================================================================
+
+VkPipelineStageFlags legacyStageMask(VkPipelineStageFlags2KHR stages, VkPipelineStageFlags none) {
+    // The original stages keep their bit positions in the low 32 bits
+    auto legacy = static_cast<VkPipelineStageFlags>(stages & 0xFFFFFFFFull);
+    if (stages & (VK_PIPELINE_STAGE_2_COPY_BIT_KHR | VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+                  VK_PIPELINE_STAGE_2_BLIT_BIT_KHR | VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR)) {
+        legacy |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+    if (stages & (VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR)) {
+        legacy |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    }
+    if (stages & VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR) {
+        legacy |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT |
+                  VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT | VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT;
+    }
+    constexpr VkPipelineStageFlags2KHR known = 0xFFFFFFFFull |
+        VK_PIPELINE_STAGE_2_COPY_BIT_KHR | VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+        VK_PIPELINE_STAGE_2_BLIT_BIT_KHR | VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR |
+        VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR |
+        VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR;
+    if (stages & ~known) {
+        legacy |= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    return legacy != 0 ? legacy : none;
+}
+
+VkAccessFlags legacyAccessMask(VkAccessFlags2KHR access) {
+    auto legacy = static_cast<VkAccessFlags>(access & 0xFFFFFFFFull);
+    if (access & (VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR)) {
+        legacy |= VK_ACCESS_SHADER_READ_BIT;
+    }
+    if (access & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR) {
+        legacy |= VK_ACCESS_SHADER_WRITE_BIT;
+    }
+    return legacy;
+}
+
+// ============================================================================
+// BarrierBatch implementation
+// ============================================================================
+
+BarrierBatch& BarrierBatch::memory(VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+                                   VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess) {
+    VkMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+    memory_.push_back(barrier);
+    return *this;
+}
+
+BarrierBatch& BarrierBatch::buffer(const Buffer& buffer,
+                                   VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+                                   VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess,
+                                   VkDeviceSize offset, VkDeviceSize size) {
+    VkBufferMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer.handle();
+    barrier.offset = offset;
+    barrier.size = size;
+    buffers_.push_back(barrier);
+    return *this;
+}
+
+BarrierBatch& BarrierBatch::image(const Image& image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                  VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+                                  VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess,
+                                  VkImageAspectFlags aspect) {
+    VkImageMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image.handle();
+    barrier.subresourceRange.aspectMask = aspect;
+    barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    images_.push_back(barrier);
+    return *this;
+}
+
+BarrierBatch& BarrierBatch::image(const VkImageMemoryBarrier2KHR& barrier) {
+    images_.push_back(barrier);
+    return *this;
+}
+
+void BarrierBatch::record(CommandBuffer& cmd) {
+    if (empty()) {
+        return;
+    }
+    cmd.pipelineBarrier2(memory_, buffers_, images_);
+    clear();
+}
+
+void BarrierBatch::clear() {
+    memory_.clear();
+    buffers_.clear();
+    images_.clear();
 }
 
 // ============================================================================
 // ImmediateCommands implementation
 // ============================================================================
 
+struct SubmitTicket::State {
+    FencePtr fence;
+    CommandBufferPtr cmd;
+    std::vector<std::function<void()>> callbacks;
+    bool complete = false;
+
+    ~State() {
+        // Never free a command buffer the GPU may still be executing
+        if (!complete && fence) {
+            fence->wait();
+        }
+        for (auto& callback : callbacks) {
+            callback();
+        }
+    }
+};
+
 ImmediateCommands::ImmediateCommands(CommandPool* pool, CommandBufferPtr cmd)
     : pool_(pool), cmd_(std::move(cmd)) {
 }
@@ -486,18 +1008,87 @@ void ImmediateCommands::submit() {
         return;
     }
 
+    submitAsync().wait();
+}
+
+SubmitTicket ImmediateCommands::submitAsync() {
+    return submitAsync({}, {}, {});
+}
+
+SubmitTicket ImmediateCommands::submitAsync(
+    const std::vector<VkSemaphore>& waitSemaphores,
+    const std::vector<VkPipelineStageFlags>& waitStages,
+    const std::vector<VkSemaphore>& signalSemaphores) {
+
+    if (submitted_) {
+        return SubmitTicket();
+    }
+
     cmd_->end();
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    VkCommandBuffer buffer = cmd_->handle();
-    submitInfo.pCommandBuffers = &buffer;
+    auto state = std::make_shared<SubmitTicket::State>();
+    state->fence = std::make_unique<Fence>(pool_->device());
 
-    pool_->queue()->submit(submitInfo);
-    pool_->queue()->waitIdle();
+    pool_->queue()->submit(cmd_->handle(), waitSemaphores, waitStages,
+                           signalSemaphores, state->fence->handle());
 
+    state->cmd = std::move(cmd_);
     submitted_ = true;
+
+    SubmitTicket ticket;
+    ticket.state_ = std::move(state);
+    return ticket;
+}
+
+// ============================================================================
+// SubmitTicket implementation
+// ============================================================================
+
+void SubmitTicket::retire() const {
+    state_->complete = true;
+    state_->cmd.reset();
+
+    auto callbacks = std::move(state_->callbacks);
+    state_->callbacks.clear();
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+bool SubmitTicket::isComplete() const {
+    if (!state_) {
+        return true;
+    }
+    if (!state_->complete && state_->fence->isSignaled()) {
+        retire();
+    }
+    return state_->complete;
+}
+
+bool SubmitTicket::isSignaled() const {
+    return !state_ || state_->complete || state_->fence->isSignaled();
+}
+
+void SubmitTicket::wait(uint64_t timeout) const {
+    if (!state_ || state_->complete) {
+        return;
+    }
+    state_->fence->wait(timeout);
+    if (state_->fence->isSignaled()) {
+        retire();
+    }
+}
+
+void SubmitTicket::then(std::function<void()> callback) const {
+    if (!state_ || isComplete()) {
+        callback();
+        return;
+    }
+    state_->callbacks.push_back(std::move(callback));
+}
+
+VkFence SubmitTicket::fence() const {
+    return state_ ? state_->fence->handle() : VK_NULL_HANDLE;
 }
 
 } // namespace finevk
@@ -0,0 +1,292 @@
+#include "finevk/device/gpu_profiler.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace finevk {
+
+namespace {
+
+// Queries 0 and 1 time the whole frame; each scope takes the next two
+constexpr uint32_t kFrameBeginQuery = 0;
+constexpr uint32_t kFrameEndQuery = 1;
+constexpr uint32_t kFirstScopeQuery = 2;
+
+// Results come back in bit order, matching PipelineStatistics' fields
+constexpr VkQueryPipelineStatisticFlags kStatisticsFlags =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+constexpr uint32_t kStatisticsCount = 6;
+
+} // namespace
+
+double GpuFrameTimings::milliseconds(const char* name) const {
+    double total = 0.0;
+    for (const auto& scope : scopes) {
+        if (scope.name == name || (scope.name && name && std::strcmp(scope.name, name) == 0)) {
+            total += scope.milliseconds;
+        }
+    }
+    return total;
+}
+
+// ============================================================================
+// GpuProfiler::Builder implementation
+// ============================================================================
+
+GpuProfiler::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+GpuProfiler::Builder& GpuProfiler::Builder::maxScopes(uint32_t count) {
+    maxScopes_ = count;
+    return *this;
+}
+
+GpuProfiler::Builder& GpuProfiler::Builder::framesInFlight(uint32_t count) {
+    framesInFlight_ = count;
+    return *this;
+}
+
+GpuProfiler::Builder& GpuProfiler::Builder::queue(Queue* queue) {
+    queue_ = queue;
+    return *this;
+}
+
+GpuProfiler::Builder& GpuProfiler::Builder::pipelineStatistics(bool enable) {
+    pipelineStatistics_ = enable;
+    return *this;
+}
+
+GpuProfilerPtr GpuProfiler::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("GpuProfiler requires a device");
+    }
+    uint32_t framesInFlight = framesInFlight_ != 0 ? framesInFlight_ : device_->maxFramesInFlight();
+    Queue* queue = queue_ ? queue_ : device_->graphicsQueue();
+
+    auto profiler = GpuProfilerPtr(new GpuProfiler());
+    profiler->device_ = device_;
+    profiler->maxScopes_ = maxScopes_;
+
+    const auto& caps = device_->physicalDevice()->capabilities();
+    profiler->timestampPeriod_ = caps.properties.limits.timestampPeriod;
+    uint32_t validBits = queue ? caps.queueFamilies[queue->familyIndex()].timestampValidBits : 0;
+    if (validBits == 0 || profiler->timestampPeriod_ <= 0.0f) {
+        FINEVK_WARN(LogCategory::Core, "GpuProfiler: timestamps not supported on this queue, profiling disabled");
+        return profiler;
+    }
+    profiler->timestampMask_ = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    uint32_t queryCount = kFirstScopeQuery + 2 * maxScopes_;
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = queryCount;
+
+    if (pipelineStatistics_ && !device_->supportsPipelineStatistics()) {
+        FINEVK_WARN(LogCategory::Core, "GpuProfiler: pipeline statistics not enabled on this device, not counted");
+    } else if (pipelineStatistics_) {
+        profiler->statisticsFlags_ = kStatisticsFlags;
+    }
+
+    VkQueryPoolCreateInfo statisticsInfo{};
+    statisticsInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    statisticsInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    statisticsInfo.queryCount = 1;
+    statisticsInfo.pipelineStatistics = profiler->statisticsFlags_;
+
+    profiler->slots_.resize(framesInFlight);
+    for (auto& slot : profiler->slots_) {
+        if (vkCreateQueryPool(device_->handle(), &poolInfo, nullptr, &slot.pool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create timestamp query pool");
+        }
+        if (profiler->statisticsFlags_ != 0 &&
+            vkCreateQueryPool(device_->handle(), &statisticsInfo, nullptr, &slot.statisticsPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create pipeline statistics query pool");
+        }
+        slot.scopes.reserve(maxScopes_);
+    }
+    profiler->open_.reserve(16);
+    profiler->readback_.resize(queryCount);
+    profiler->results_.scopes.reserve(maxScopes_);
+
+    return profiler;
+}
+
+GpuProfiler::Builder GpuProfiler::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+// ============================================================================
+// GpuProfiler implementation
+// ============================================================================
+
+GpuProfiler::~GpuProfiler() {
+    for (auto& slot : slots_) {
+        if (slot.pool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device_->handle(), slot.pool, nullptr);
+        }
+        if (slot.statisticsPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device_->handle(), slot.statisticsPool, nullptr);
+        }
+    }
+}
+
+void GpuProfiler::beginFrame(CommandBuffer& cmd, uint32_t frameIndex) {
+    current_ = nullptr;
+    open_.clear();
+    if (!enabled_ || slots_.empty()) {
+        return;
+    }
+
+    Slot& slot = slots_[frameIndex % slots_.size()];
+    if (slot.pending) {
+        readBack(slot);
+    }
+
+    vkCmdResetQueryPool(cmd.handle(), slot.pool, 0, kFirstScopeQuery + 2 * maxScopes_);
+    slot.scopes.clear();
+    slot.usedQueries = kFirstScopeQuery;
+    slot.frame = ++frameCounter_;
+    slot.pending = false;
+
+    vkCmdWriteTimestamp(cmd.handle(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.pool, kFrameBeginQuery);
+    if (slot.statisticsPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(cmd.handle(), slot.statisticsPool, 0, 1);
+        vkCmdBeginQuery(cmd.handle(), slot.statisticsPool, 0, 0);
+    }
+    current_ = &slot;
+}
+
+void GpuProfiler::endFrame(CommandBuffer& cmd) {
+    if (!current_) {
+        return;
+    }
+    while (!open_.empty()) {
+        endScope(cmd);
+    }
+    if (current_->statisticsPool != VK_NULL_HANDLE) {
+        vkCmdEndQuery(cmd.handle(), current_->statisticsPool, 0);
+    }
+    vkCmdWriteTimestamp(cmd.handle(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, current_->pool, kFrameEndQuery);
+    current_->pending = true;
+    current_ = nullptr;
+}
+
+void GpuProfiler::writeTimestamp(CommandBuffer& cmd, VkPipelineStageFlagBits stage, uint32_t& query) {
+    query = current_->usedQueries++;
+    vkCmdWriteTimestamp(cmd.handle(), stage, current_->pool, query);
+}
+
+void GpuProfiler::beginScope(CommandBuffer& cmd, const char* name) {
+    if (!current_) {
+        return;
+    }
+    if (current_->scopes.size() >= maxScopes_) {
+        if (!warnedOverflow_) {
+            FINEVK_WARN(LogCategory::Core, "GpuProfiler: more than " + std::to_string(maxScopes_) +
+                        " scopes in a frame, extra scopes dropped");
+            warnedOverflow_ = true;
+        }
+        open_.push_back(-1);
+        return;
+    }
+
+    ScopeRecord record{};
+    record.name = name;
+    record.depth = static_cast<uint32_t>(open_.size());
+    record.parent = -1;
+    for (auto it = open_.rbegin(); it != open_.rend(); ++it) {
+        if (*it >= 0) {
+            record.parent = *it;
+            break;
+        }
+    }
+    record.endQuery = UINT32_MAX;
+    writeTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, record.beginQuery);
+
+    open_.push_back(static_cast<int32_t>(current_->scopes.size()));
+    current_->scopes.push_back(record);
+}
+
+void GpuProfiler::endScope(CommandBuffer& cmd) {
+    if (!current_ || open_.empty()) {
+        return;
+    }
+    int32_t index = open_.back();
+    open_.pop_back();
+    if (index >= 0) {
+        writeTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, current_->scopes[index].endQuery);
+    }
+}
+
+void GpuProfiler::readBack(Slot& slot) {
+    slot.pending = false;
+
+    // Never wait: if any result isn't available yet (VK_NOT_READY) the
+    // frame is skipped and results() keeps the previous one
+    VkResult result = vkGetQueryPoolResults(
+        device_->handle(), slot.pool, 0, slot.usedQueries,
+        slot.usedQueries * sizeof(uint64_t), readback_.data(), sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return;
+    }
+
+    auto ticks = [this](uint32_t begin, uint32_t end) {
+        uint64_t delta = (readback_[end] - readback_[begin]) & timestampMask_;
+        return static_cast<double>(delta) * timestampPeriod_ * 1e-6;
+    };
+
+    results_.frame = slot.frame;
+    results_.totalMilliseconds = ticks(kFrameBeginQuery, kFrameEndQuery);
+    results_.scopes.clear();
+    for (const auto& record : slot.scopes) {
+        GpuScopeTiming timing;
+        timing.name = record.name;
+        timing.depth = record.depth;
+        timing.parent = record.parent;
+        timing.milliseconds = record.endQuery != UINT32_MAX ? ticks(record.beginQuery, record.endQuery) : 0.0;
+        results_.scopes.push_back(timing);
+    }
+
+    results_.hasPipelineStatistics = false;
+    if (slot.statisticsPool != VK_NULL_HANDLE) {
+        uint64_t counts[kStatisticsCount] = {};
+        if (vkGetQueryPoolResults(device_->handle(), slot.statisticsPool, 0, 1, sizeof(counts), counts,
+                                  sizeof(counts), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+            results_.pipeline.inputVertices = counts[0];
+            results_.pipeline.inputPrimitives = counts[1];
+            results_.pipeline.vertexInvocations = counts[2];
+            results_.pipeline.clippingPrimitives = counts[3];
+            results_.pipeline.fragmentInvocations = counts[4];
+            results_.pipeline.computeInvocations = counts[5];
+            results_.hasPipelineStatistics = true;
+        }
+    }
+}
+
+// ============================================================================
+// GpuProfiler::Scope implementation
+// ============================================================================
+
+GpuProfiler::Scope::Scope(CommandBuffer& cmd, const char* name)
+    : cmd_(cmd) {
+    cmd_.beginScope(name);
+}
+
+GpuProfiler::Scope::~Scope() {
+    cmd_.endScope();
+}
+
+} // namespace finevk
@@ -1,9 +1,13 @@
 #include "finevk/device/image.hpp"
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/physical_device.hpp"
+#include "finevk/device/command.hpp"
 #include "finevk/core/logging.hpp"
 
+#include <algorithm>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 namespace finevk {
 
@@ -55,13 +59,78 @@ Image::Builder& Image::Builder::memoryUsage(MemoryUsage memUsg) {
     return *this;
 }
 
+Image::Builder& Image::Builder::flags(VkImageCreateFlags flg) {
+    flags_ = flg;
+    return *this;
+}
+
+Image::Builder& Image::Builder::category(MemoryCategory category) {
+    category_ = category;
+    return *this;
+}
+
+Image::Builder& Image::Builder::relocatable(VkImageLayout layout) {
+    relocatableLayout_ = layout;
+    return *this;
+}
+
+namespace {
+
+MemoryCategory inferCategory(VkImageUsageFlags usage) {
+    if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) {
+        return MemoryCategory::Attachment;
+    }
+    if (usage & VK_IMAGE_USAGE_SAMPLED_BIT) {
+        return MemoryCategory::Texture;
+    }
+    return MemoryCategory::Other;
+}
+
+// Aspects a whole-image copy covers
+VkImageAspectFlags copyAspects(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        case VK_FORMAT_S8_UINT:
+            return VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
+} // anonymous namespace
+
 ImagePtr Image::Builder::build() {
     if (extent_.width == 0 || extent_.height == 0) {
         throw std::runtime_error("Image extent must be non-zero");
     }
 
+    // Transient images live only inside render passes (never sampled, copied or stored)
+    constexpr VkImageUsageFlags attachmentUsage =
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+        VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    bool transient = memUsage_ == MemoryUsage::Transient;
+    if (transient && (usage_ & ~attachmentUsage) != 0) {
+        throw std::runtime_error("MemoryUsage::Transient images may only be used as attachments");
+    }
+    bool relocatable = relocatableLayout_ != VK_IMAGE_LAYOUT_UNDEFINED;
+    if (relocatable && transient) {
+        FINEVK_WARN(LogCategory::Core, "Transient images can't be relocated, ignoring relocatable()");
+        relocatable = false;
+    } else if (relocatable && memUsage_ != MemoryUsage::GpuOnly) {
+        FINEVK_WARN(LogCategory::Core, "Only GpuOnly images can be relocated, ignoring relocatable()");
+        relocatable = false;
+    }
+
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.flags = flags_;
     imageInfo.imageType = extent_.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
     imageInfo.extent = extent_;
     imageInfo.mipLevels = mipLevels_;
@@ -70,6 +139,12 @@ ImagePtr Image::Builder::build() {
     imageInfo.tiling = tiling_;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     imageInfo.usage = usage_;
+    if (transient) {
+        imageInfo.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    }
+    if (relocatable) {
+        imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageInfo.samples = samples_;
 
@@ -79,14 +154,12 @@ ImagePtr Image::Builder::build() {
         throw std::runtime_error("Failed to create image");
     }
 
-    // Get memory requirements
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(device_->handle(), vkImage, &memRequirements);
-
-    // Allocate memory
+    // Allocate memory (dedicated if the driver asks for it, as many do for attachments)
     AllocationInfo allocation;
     try {
-        allocation = device_->allocator().allocate(memRequirements, memUsage_);
+        allocation = device_->allocator().allocateForImage(vkImage, memUsage_,
+            tiling_ == VK_IMAGE_TILING_OPTIMAL ? ResourceKind::Optimal : ResourceKind::Linear,
+            category_.value_or(inferCategory(usage_)));
     } catch (...) {
         vkDestroyImage(device_->handle(), vkImage, nullptr);
         throw;
@@ -106,9 +179,21 @@ ImagePtr Image::Builder::build() {
     image->format_ = format_;
     image->extent_ = extent_;
     image->mipLevels_ = mipLevels_;
+    image->arrayLayers_ = arrayLayers_;
     image->samples_ = samples_;
+    image->usage_ = imageInfo.usage;
+    image->flags_ = flags_;
     image->allocation_ = allocation;
     image->ownsMemory_ = true;
+    image->tiling_ = tiling_;
+
+    // Dedicated allocations have no block to compact; mapped ones (unified
+    // memory, linear tiling) may be written through the mapping
+    if (relocatable && allocation.block && !allocation.mappedPtr) {
+        image->relocatable_ = true;
+        image->relocatableLayout_ = relocatableLayout_;
+        device_->allocator().registerRelocatable(image.get());
+    }
 
     return image;
 }
@@ -149,7 +234,7 @@ ImagePtr Image::createDepthBuffer(
         .format(depthFormat)
         .usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
         .samples(samples)
-        .memoryUsage(MemoryUsage::GpuOnly)
+        .memoryUsage(MemoryUsage::Transient)
         .build();
 }
 
@@ -162,9 +247,9 @@ ImagePtr Image::createColorAttachment(
     return create(device)
         .extent(width, height)
         .format(format)
-        .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+        .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
         .samples(samples)
-        .memoryUsage(MemoryUsage::GpuOnly)
+        .memoryUsage(MemoryUsage::Transient)
         .build();
 }
 
@@ -187,10 +272,17 @@ Image::Image(Image&& other) noexcept
     , format_(other.format_)
     , extent_(other.extent_)
     , mipLevels_(other.mipLevels_)
+    , arrayLayers_(other.arrayLayers_)
     , samples_(other.samples_)
+    , usage_(other.usage_)
+    , flags_(other.flags_)
     , allocation_(other.allocation_)
     , ownsMemory_(other.ownsMemory_)
-    , defaultView_(std::move(other.defaultView_)) {
+    , defaultView_(std::move(other.defaultView_))
+    , tiling_(other.tiling_)
+    , relocatableLayout_(other.relocatableLayout_)
+    , relocationCallback_(std::move(other.relocationCallback_)) {
+    takeRelocation(other);
     other.image_ = VK_NULL_HANDLE;
     other.allocation_ = {};
 }
@@ -203,38 +295,230 @@ Image& Image::operator=(Image&& other) noexcept {
         format_ = other.format_;
         extent_ = other.extent_;
         mipLevels_ = other.mipLevels_;
+        arrayLayers_ = other.arrayLayers_;
         samples_ = other.samples_;
+        usage_ = other.usage_;
+        flags_ = other.flags_;
         allocation_ = other.allocation_;
         ownsMemory_ = other.ownsMemory_;
         defaultView_ = std::move(other.defaultView_);
+        tiling_ = other.tiling_;
+        relocatableLayout_ = other.relocatableLayout_;
+        relocationCallback_ = std::move(other.relocationCallback_);
+        takeRelocation(other);
         other.image_ = VK_NULL_HANDLE;
         other.allocation_ = {};
     }
     return *this;
 }
 
+void Image::takeRelocation(Image& other) {
+    // The allocator tracks relocatable images by address; a pending move comes along
+    if (other.relocatable_) {
+        movingImage_ = other.movingImage_;
+        movingAllocation_ = other.movingAllocation_;
+        other.movingImage_ = VK_NULL_HANDLE;
+        other.movingAllocation_ = {};
+        other.relocatable_ = false;
+        relocatable_ = true;
+        device_->allocator().transferRelocatable(&other, this);
+    }
+}
+
 void Image::cleanup() {
+    bool copying = false;
+    if (relocatable_) {
+        copying = device_->allocator().unregisterRelocatable(this);  // Cancels a pending move
+        relocatable_ = false;
+    }
+
     // Destroy the default view first (it references this image)
     defaultView_.reset();
 
     if (image_ != VK_NULL_HANDLE && device_ != nullptr && ownsMemory_) {
-        vkDestroyImage(device_->handle(), image_, nullptr);
-        device_->allocator().free(allocation_);
+        if (copying) {
+            // The cancelled move's copy may still be reading this image
+            VkDevice device = device_->handle();
+            VkImage image = image_;
+            device_->allocator().retire([device, image]() { vkDestroyImage(device, image, nullptr); },
+                                        allocation_);
+        } else {
+            vkDestroyImage(device_->handle(), image_, nullptr);
+            device_->allocator().free(allocation_);
+        }
         image_ = VK_NULL_HANDLE;
     }
 }
 
+bool Image::beginMove(CommandBuffer& cmd, const AllocationInfo& target) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.flags = flags_;
+    imageInfo.imageType = extent_.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+    imageInfo.extent = extent_;
+    imageInfo.mipLevels = mipLevels_;
+    imageInfo.arrayLayers = arrayLayers_;
+    imageInfo.format = format_;
+    imageInfo.tiling = tiling_;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage_;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = samples_;
+
+    VkImage moving;
+    if (vkCreateImage(device_->handle(), &imageInfo, nullptr, &moving) != VK_SUCCESS) {
+        return false;
+    }
+    if (vkBindImageMemory(device_->handle(), moving, target.memory, target.offset) != VK_SUCCESS) {
+        vkDestroyImage(device_->handle(), moving, nullptr);
+        return false;
+    }
+
+    VkImageAspectFlags aspects = copyAspects(format_);
+    VkImageSubresourceRange range{aspects, 0, mipLevels_, 0, arrayLayers_};
+
+    // Old image: steady layout -> transfer source, new image: -> transfer destination
+    VkImageMemoryBarrier barriers[2]{};
+    for (auto& barrier : barriers) {
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange = range;
+    }
+    barriers[0].image = image_;
+    barriers[0].oldLayout = relocatableLayout_;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[1].image = moving;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd.handle(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 2, barriers);
+
+    std::vector<VkImageCopy> regions(mipLevels_);
+    for (uint32_t mip = 0; mip < mipLevels_; mip++) {
+        VkImageCopy& region = regions[mip];
+        region.srcSubresource = {aspects, mip, 0, arrayLayers_};
+        region.dstSubresource = region.srcSubresource;
+        region.extent = {std::max(extent_.width >> mip, 1u),
+                         std::max(extent_.height >> mip, 1u),
+                         std::max(extent_.depth >> mip, 1u)};
+    }
+    vkCmdCopyImage(cmd.handle(), image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   moving, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   static_cast<uint32_t>(regions.size()), regions.data());
+
+    // Both back to the steady layout
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].newLayout = relocatableLayout_;
+    barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].newLayout = relocatableLayout_;
+    barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    vkCmdPipelineBarrier(cmd.handle(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0, 0, nullptr, 0, nullptr, 2, barriers);
+
+    movingImage_ = moving;
+    movingAllocation_ = target;
+    return true;
+}
+
+std::function<void()> Image::commitMove() {
+    VkDevice device = device_->handle();
+    VkImage old = image_;
+    // Frames already recorded may still sample through the old default view
+    std::shared_ptr<ImageView> oldView(defaultView_.release());
+
+    image_ = movingImage_;
+    allocation_ = movingAllocation_;
+    movingImage_ = VK_NULL_HANDLE;
+    movingAllocation_ = {};
+
+    if (relocationCallback_) {
+        relocationCallback_(*this);
+    }
+    return [device, old, oldView]() mutable {
+        oldView.reset();
+        vkDestroyImage(device, old, nullptr);
+    };
+}
+
+std::function<void()> Image::cancelMove() {
+    VkDevice device = device_->handle();
+    VkImage moving = movingImage_;
+    movingImage_ = VK_NULL_HANDLE;
+    movingAllocation_ = {};
+    return [device, moving]() { vkDestroyImage(device, moving, nullptr); };
+}
+
+void Image::transitionLayoutOnHost(VkImageLayout oldLayout, VkImageLayout newLayout) {
+    auto transition = device_->transitionImageLayout();
+    if (!transition || !(usage_ & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT)) {
+        throw std::runtime_error("Image::transitionLayoutOnHost needs host image copy and HOST_TRANSFER usage");
+    }
+
+    VkHostImageLayoutTransitionInfoEXT info{};
+    info.sType = VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT;
+    info.image = image_;
+    info.oldLayout = oldLayout;
+    info.newLayout = newLayout;
+    info.subresourceRange = {copyAspects(format_), 0, mipLevels_, 0, arrayLayers_};
+    if (transition(device_->handle(), 1, &info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to transition image layout on the host");
+    }
+}
+
+void Image::copyFromHost(const void* data, uint32_t mipLevel, VkImageLayout layout) {
+    auto copy = device_->copyMemoryToImage();
+    if (!copy || !(usage_ & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT)) {
+        throw std::runtime_error("Image::copyFromHost needs host image copy and HOST_TRANSFER usage");
+    }
+    if (movePending()) {
+        throw std::runtime_error("Image::copyFromHost: relocation pending, the write would be lost");
+    }
+    if (mipLevel >= mipLevels_) {
+        throw std::runtime_error("Image::copyFromHost: mip level out of range");
+    }
+
+    VkMemoryToImageCopyEXT region{};
+    region.sType = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT;
+    region.pHostPointer = data;
+    region.imageSubresource = {copyAspects(format_), mipLevel, 0, arrayLayers_};
+    region.imageExtent = {std::max(extent_.width >> mipLevel, 1u),
+                          std::max(extent_.height >> mipLevel, 1u),
+                          std::max(extent_.depth >> mipLevel, 1u)};
+
+    VkCopyMemoryToImageInfoEXT info{};
+    info.sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT;
+    info.dstImage = image_;
+    info.dstImageLayout = layout;
+    info.regionCount = 1;
+    info.pRegions = &region;
+    if (copy(device_->handle(), &info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to copy memory to image on the host");
+    }
+}
+
 ImageViewPtr Image::createView(VkImageAspectFlags aspectMask) {
+    return createView(aspectMask, 0, mipLevels_);
+}
+
+ImageViewPtr Image::createView(VkImageAspectFlags aspectMask, uint32_t baseMipLevel,
+                               uint32_t levelCount, VkFormat viewFormat) {
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = image_;
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = format_;
+    viewInfo.viewType = arrayLayers_ > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = viewFormat != VK_FORMAT_UNDEFINED ? viewFormat : format_;
     viewInfo.subresourceRange.aspectMask = aspectMask;
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = mipLevels_;
+    viewInfo.subresourceRange.baseMipLevel = baseMipLevel;
+    viewInfo.subresourceRange.levelCount = levelCount;
     viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
+    viewInfo.subresourceRange.layerCount = arrayLayers_;
 
     VkImageView view;
     VkResult result = vkCreateImageView(device_->handle(), &viewInfo, nullptr, &view);
@@ -1,11 +1,15 @@
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/physical_device.hpp"
 #include "finevk/device/memory.hpp"
+#include "finevk/device/pipeline_cache.hpp"
+#include "finevk/device/sampler.hpp"
+#include "finevk/rendering/pipeline.hpp"
 #include "finevk/device/command.hpp"
 #include "finevk/core/surface.hpp"
 #include "finevk/core/logging.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <set>
 
@@ -19,14 +23,96 @@ Queue::Queue(VkQueue queue, uint32_t familyIndex, QueueType type)
     : queue_(queue), familyIndex_(familyIndex), type_(type) {
 }
 
-void Queue::submit(const VkSubmitInfo& submitInfo, VkFence fence) {
-    VkResult result = vkQueueSubmit(queue_, 1, &submitInfo, fence);
+uint64_t Queue::submit(const VkSubmitInfo& submitInfo, VkFence fence) {
+    return submit(&submitInfo, 1, fence);
+}
+
+uint64_t Queue::submit(const VkSubmitInfo* submitInfos, uint32_t count, VkFence fence) {
+    if (timeline_ == VK_NULL_HANDLE) {
+        VkResult result = vkQueueSubmit(queue_, count, submitInfos, fence);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit command buffer to queue");
+        }
+        return 0;
+    }
+
+    // A trailing empty batch signals the timeline: its signal operation
+    // covers every command earlier in submission order, and leaves the
+    // caller's pNext chain (which may hold its own timeline info) untouched
+    std::lock_guard<std::mutex> lock(submitMutex_);
+    uint64_t value = lastSubmitted_.load(std::memory_order_relaxed) + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &value;
+
+    VkSubmitInfo signal{};
+    signal.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    signal.pNext = &timelineInfo;
+    signal.signalSemaphoreCount = 1;
+    signal.pSignalSemaphores = &timeline_;
+
+    VkResult result;
+    if (count == 1) {
+        VkSubmitInfo batches[2] = {submitInfos[0], signal};
+        result = vkQueueSubmit(queue_, 2, batches, fence);
+    } else {
+        std::vector<VkSubmitInfo> batches(submitInfos, submitInfos + count);
+        batches.push_back(signal);
+        result = vkQueueSubmit(queue_, static_cast<uint32_t>(batches.size()), batches.data(), fence);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit command buffer to queue");
+    }
+    lastSubmitted_.store(value, std::memory_order_release);
+    return value;
+}
+
+uint64_t Queue::submit2(const VkSubmitInfo2KHR* submitInfos, uint32_t count, VkFence fence) {
+    if (!queueSubmit2_) {
+        throw std::runtime_error("Queue::submit2 requires VK_KHR_synchronization2 "
+                                 "(LogicalDeviceBuilder::enableSynchronization2)");
+    }
+    if (timeline_ == VK_NULL_HANDLE) {
+        if (queueSubmit2_(queue_, count, submitInfos, fence) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit command buffer to queue");
+        }
+        return 0;
+    }
+
+    // Same trailing-batch scheme as submit(); sync2 carries the value inline
+    std::lock_guard<std::mutex> lock(submitMutex_);
+    uint64_t value = lastSubmitted_.load(std::memory_order_relaxed) + 1;
+
+    VkSemaphoreSubmitInfoKHR timelineSignal{};
+    timelineSignal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineSignal.semaphore = timeline_;
+    timelineSignal.value = value;
+    timelineSignal.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+
+    VkSubmitInfo2KHR signal{};
+    signal.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR;
+    signal.signalSemaphoreInfoCount = 1;
+    signal.pSignalSemaphoreInfos = &timelineSignal;
+
+    VkResult result;
+    if (count == 1) {
+        VkSubmitInfo2KHR batches[2] = {submitInfos[0], signal};
+        result = queueSubmit2_(queue_, 2, batches, fence);
+    } else {
+        std::vector<VkSubmitInfo2KHR> batches(submitInfos, submitInfos + count);
+        batches.push_back(signal);
+        result = queueSubmit2_(queue_, static_cast<uint32_t>(batches.size()), batches.data(), fence);
+    }
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to submit command buffer to queue");
     }
+    lastSubmitted_.store(value, std::memory_order_release);
+    return value;
 }
 
-void Queue::submit(
+uint64_t Queue::submit(
     VkCommandBuffer commandBuffer,
     const std::vector<VkSemaphore>& waitSemaphores,
     const std::vector<VkPipelineStageFlags>& waitStages,
@@ -45,13 +131,119 @@ void Queue::submit(
     submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
     submitInfo.pSignalSemaphores = signalSemaphores.empty() ? nullptr : signalSemaphores.data();
 
-    submit(submitInfo, fence);
+    return submit(submitInfo, fence);
+}
+
+uint64_t Queue::submitAfter(
+    VkCommandBuffer commandBuffer,
+    const std::vector<TimelinePoint>& waitPoints,
+    VkPipelineStageFlags waitStages,
+    const std::vector<VkSemaphore>& waitSemaphores,
+    const std::vector<VkPipelineStageFlags>& semaphoreStages,
+    const std::vector<VkSemaphore>& signalSemaphores,
+    VkFence fence) {
+
+    if (semaphoreStages.size() != waitSemaphores.size()) {
+        throw std::runtime_error("Queue::submitAfter needs one stage mask per wait semaphore");
+    }
+
+    // Binary waits first; their values in the timeline info are ignored
+    std::vector<VkSemaphore> waits = waitSemaphores;
+    std::vector<VkPipelineStageFlags> stages = semaphoreStages;
+    std::vector<uint64_t> waitValues(waits.size(), 0);
+    for (const auto& point : waitPoints) {
+        if (point.isComplete() || point.queue->timeline() == VK_NULL_HANDLE) {
+            continue;
+        }
+        waits.push_back(point.queue->timeline());
+        stages.push_back(waitStages);
+        waitValues.push_back(point.value);
+    }
+    std::vector<uint64_t> signalValues(signalSemaphores.size(), 0);
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.empty() ? nullptr : waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.empty() ? nullptr : signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = waits.size() > waitSemaphores.size() ? &timelineInfo : nullptr;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waits.size());
+    submitInfo.pWaitSemaphores = waits.empty() ? nullptr : waits.data();
+    submitInfo.pWaitDstStageMask = stages.empty() ? nullptr : stages.data();
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.empty() ? nullptr : signalSemaphores.data();
+
+    return submit(submitInfo, fence);
 }
 
 void Queue::waitIdle() {
     vkQueueWaitIdle(queue_);
 }
 
+uint64_t Queue::completedValue() const {
+    if (timeline_ == VK_NULL_HANDLE) {
+        return 0;
+    }
+    uint64_t value = 0;
+    if (vkGetSemaphoreCounterValue(device_, timeline_, &value) != VK_SUCCESS) {
+        return completed_.load(std::memory_order_acquire);
+    }
+    // Keep the cache monotonic when several threads refresh it
+    uint64_t cached = completed_.load(std::memory_order_relaxed);
+    while (cached < value &&
+           !completed_.compare_exchange_weak(cached, value, std::memory_order_acq_rel)) {
+    }
+    return std::max(cached, value);
+}
+
+void Queue::waitFor(uint64_t value, uint64_t timeout) const {
+    if (timeline_ == VK_NULL_HANDLE || isComplete(value)) {
+        return;
+    }
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &timeline_;
+    waitInfo.pValues = &value;
+    VkResult result = vkWaitSemaphores(device_, &waitInfo, timeout);
+    if (result == VK_TIMEOUT) {
+        return;
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to wait for queue timeline");
+    }
+    completedValue();
+}
+
+void Queue::createTimeline(VkDevice device) {
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    createInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(device, &createInfo, nullptr, &timeline_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create queue timeline semaphore");
+    }
+    device_ = device;
+}
+
+void Queue::destroyTimeline() {
+    if (timeline_ != VK_NULL_HANDLE) {
+        vkDestroySemaphore(device_, timeline_, nullptr);
+        timeline_ = VK_NULL_HANDLE;
+    }
+}
+
 VkResult Queue::present(
     VkSwapchainKHR swapChain,
     uint32_t imageIndex,
@@ -85,7 +277,25 @@ LogicalDevice::LogicalDevice(LogicalDevice&& other) noexcept
     , computeQueue_(other.computeQueue_)
     , transferQueue_(other.transferQueue_)
     , allocator_(std::move(other.allocator_))
-    , defaultCommandPool_(std::move(other.defaultCommandPool_)) {
+    , pipelineCache_(std::move(other.pipelineCache_))
+    , samplerCache_(std::move(other.samplerCache_))
+    , pipelineRegistry_(std::move(other.pipelineRegistry_))
+    , defaultCommandPool_(std::move(other.defaultCommandPool_))
+    , framesInFlight_(other.framesInFlight_)
+    , maxFramesInFlight_(other.maxFramesInFlight_)
+    , enabledFeatures_(other.enabledFeatures_)
+    , enabledFeatures12_(other.enabledFeatures12_)
+    , memoryBudget_(other.memoryBudget_)
+    , multiview_(other.multiview_)
+    , cmdDrawMeshTasks_(other.cmdDrawMeshTasks_)
+    , waitForPresent_(other.waitForPresent_)
+    , cmdBeginRendering_(other.cmdBeginRendering_)
+    , cmdEndRendering_(other.cmdEndRendering_)
+    , queueSubmit2_(other.queueSubmit2_)
+    , cmdPipelineBarrier2_(other.cmdPipelineBarrier2_)
+    , cmdSetFragmentShadingRate_(other.cmdSetFragmentShadingRate_)
+    , copyMemoryToImage_(other.copyMemoryToImage_)
+    , transitionImageLayout_(other.transitionImageLayout_) {
     other.device_ = VK_NULL_HANDLE;
     other.graphicsQueue_ = nullptr;
     other.presentQueue_ = nullptr;
@@ -104,7 +314,25 @@ LogicalDevice& LogicalDevice::operator=(LogicalDevice&& other) noexcept {
         computeQueue_ = other.computeQueue_;
         transferQueue_ = other.transferQueue_;
         allocator_ = std::move(other.allocator_);
+        pipelineCache_ = std::move(other.pipelineCache_);
+        samplerCache_ = std::move(other.samplerCache_);
+        pipelineRegistry_ = std::move(other.pipelineRegistry_);
         defaultCommandPool_ = std::move(other.defaultCommandPool_);
+        framesInFlight_ = other.framesInFlight_;
+        maxFramesInFlight_ = other.maxFramesInFlight_;
+        enabledFeatures_ = other.enabledFeatures_;
+        enabledFeatures12_ = other.enabledFeatures12_;
+        memoryBudget_ = other.memoryBudget_;
+        multiview_ = other.multiview_;
+        cmdDrawMeshTasks_ = other.cmdDrawMeshTasks_;
+        waitForPresent_ = other.waitForPresent_;
+        cmdBeginRendering_ = other.cmdBeginRendering_;
+        cmdEndRendering_ = other.cmdEndRendering_;
+        queueSubmit2_ = other.queueSubmit2_;
+        cmdPipelineBarrier2_ = other.cmdPipelineBarrier2_;
+        cmdSetFragmentShadingRate_ = other.cmdSetFragmentShadingRate_;
+        copyMemoryToImage_ = other.copyMemoryToImage_;
+        transitionImageLayout_ = other.transitionImageLayout_;
         other.device_ = VK_NULL_HANDLE;
         other.graphicsQueue_ = nullptr;
         other.presentQueue_ = nullptr;
@@ -114,6 +342,19 @@ LogicalDevice& LogicalDevice::operator=(LogicalDevice&& other) noexcept {
     return *this;
 }
 
+void LogicalDevice::setFramesInFlight(uint32_t count) {
+    if (count == 0 || count > maxFramesInFlight_) {
+        throw std::runtime_error("Frames in flight must be between 1 and " +
+                                 std::to_string(maxFramesInFlight_));
+    }
+    if (count == framesInFlight_) {
+        return;
+    }
+    waitIdle();
+    framesInFlight_ = count;
+    FINEVK_INFO(LogCategory::Core, "Frames in flight set to " + std::to_string(count));
+}
+
 size_t LogicalDevice::onDestruction(DestructionCallback callback) {
     size_t id = nextCallbackId_++;
     destructionCallbacks_.emplace_back(id, std::move(callback));
@@ -144,10 +385,22 @@ void LogicalDevice::cleanup() {
         // Clear default resources
         defaultCommandPool_.reset();
 
+        // Shared pipelines (handles still referenced elsewhere are nulled)
+        pipelineRegistry_.reset();
+
+        // Saves the cache blob to disk if persistence is enabled
+        pipelineCache_.reset();
+
+        // Shared samplers (handles still referenced elsewhere are nulled)
+        samplerCache_.reset();
+
         // Clear allocator before destroying device
         allocator_.reset();
 
-        // Clear queues (they don't need explicit destruction)
+        // Queues themselves need no destruction, only their timelines
+        for (auto& queue : ownedQueues_) {
+            queue->destroyTimeline();
+        }
         ownedQueues_.clear();
 
         vkDestroyDevice(device_, nullptr);
@@ -196,8 +449,24 @@ LogicalDevicePtr LogicalDeviceBuilder::build() {
         throw std::runtime_error("No present queue family found");
     }
 
+    // Dedicated compute/transfer families are only used when they differ from graphics
+    auto computeFamily = caps.computeQueueFamily();
+    auto transferFamily = caps.transferQueueFamily();
+    if (computeFamily && *computeFamily == *graphicsFamily) {
+        computeFamily.reset();
+    }
+    if (transferFamily && *transferFamily == *graphicsFamily) {
+        transferFamily.reset();
+    }
+
     // Collect unique queue families
     std::set<uint32_t> uniqueFamilies = { *graphicsFamily, *presentFamily };
+    if (computeFamily) {
+        uniqueFamilies.insert(*computeFamily);
+    }
+    if (transferFamily) {
+        uniqueFamilies.insert(*transferFamily);
+    }
 
     // Create queue create infos
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
@@ -217,9 +486,89 @@ LogicalDevicePtr LogicalDeviceBuilder::build() {
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.pEnabledFeatures = &enabledFeatures_;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions_.size());
-    createInfo.ppEnabledExtensionNames = extensions_.data();
+    // Vulkan 1.2 features require the VkPhysicalDeviceFeatures2 chain
+    VkPhysicalDeviceVulkan12Features features12 = enabledFeatures12_;
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.pNext = nullptr;
+    // Queue timelines track GPU progress per submission, so always on when available
+    bool useFeatures12 = useFeatures12_;
+    if (caps.supportsTimelineSemaphore()) {
+        features12.timelineSemaphore = VK_TRUE;
+        useFeatures12 = true;
+    }
+    VkPhysicalDeviceMeshShaderFeaturesEXT meshFeatures{};
+    meshFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+    if (meshShader_) {
+        meshFeatures.taskShader = VK_TRUE;
+        meshFeatures.meshShader = VK_TRUE;
+        features12.pNext = &meshFeatures;
+    }
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    if (presentWait_) {
+        presentIdFeatures.presentId = VK_TRUE;
+        presentWaitFeatures.presentWait = VK_TRUE;
+        presentIdFeatures.pNext = &presentWaitFeatures;
+        presentWaitFeatures.pNext = features12.pNext;
+        features12.pNext = &presentIdFeatures;
+    }
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    if (dynamicRendering_) {
+        dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+        dynamicRenderingFeatures.pNext = features12.pNext;
+        features12.pNext = &dynamicRenderingFeatures;
+    }
+    VkPhysicalDeviceMultiviewFeatures multiviewFeatures{};
+    multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+    if (multiview_) {
+        multiviewFeatures.multiview = VK_TRUE;
+        multiviewFeatures.pNext = features12.pNext;
+        features12.pNext = &multiviewFeatures;
+    }
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+    synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+    if (synchronization2_) {
+        synchronization2Features.synchronization2 = VK_TRUE;
+        synchronization2Features.pNext = features12.pNext;
+        features12.pNext = &synchronization2Features;
+    }
+    VkPhysicalDeviceFragmentShadingRateFeaturesKHR fragmentShadingRateFeatures{};
+    fragmentShadingRateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+    if (fragmentShadingRate_) {
+        fragmentShadingRateFeatures.pipelineFragmentShadingRate = VK_TRUE;
+        fragmentShadingRateFeatures.pNext = features12.pNext;
+        features12.pNext = &fragmentShadingRateFeatures;
+    }
+    VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeatures{};
+    hostImageCopyFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+    if (hostImageCopy_) {
+        hostImageCopyFeatures.hostImageCopy = VK_TRUE;
+        hostImageCopyFeatures.pNext = features12.pNext;
+        features12.pNext = &hostImageCopyFeatures;
+    }
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.features = enabledFeatures_;
+    features2.pNext = &features12;
+    if (useFeatures12) {
+        createInfo.pNext = &features2;
+        createInfo.pEnabledFeatures = nullptr;
+    } else {
+        createInfo.pEnabledFeatures = &enabledFeatures_;
+    }
+    // Heap budgets let streaming back off before oversubscribing, so always on when available
+    std::vector<const char*> extensions = extensions_;
+    bool memoryBudget = caps.supportsMemoryBudget();
+    if (memoryBudget && std::none_of(extensions.begin(), extensions.end(), [](const char* name) {
+            return std::strcmp(name, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0;
+        })) {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     // Deprecated but some drivers still need it
     createInfo.enabledLayerCount = 0;
@@ -234,6 +583,54 @@ LogicalDevicePtr LogicalDeviceBuilder::build() {
     auto device = LogicalDevicePtr(new LogicalDevice());
     device->device_ = vkDevice;
     device->physical_ = physical_;
+    device->framesInFlight_ = framesInFlight_;
+    device->maxFramesInFlight_ = maxFramesInFlight_;
+    device->enabledFeatures_ = enabledFeatures_;
+    device->memoryBudget_ = memoryBudget;
+    device->multiview_ = multiview_;
+    if (useFeatures12) {
+        device->enabledFeatures12_ = features12;
+        device->enabledFeatures12_.pNext = nullptr;
+    }
+    if (meshShader_) {
+        device->cmdDrawMeshTasks_ = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(
+            vkGetDeviceProcAddr(vkDevice, "vkCmdDrawMeshTasksEXT"));
+    }
+    if (presentWait_) {
+        device->waitForPresent_ = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+            vkGetDeviceProcAddr(vkDevice, "vkWaitForPresentKHR"));
+    }
+    if (dynamicRendering_) {
+        device->cmdBeginRendering_ = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+            vkGetDeviceProcAddr(vkDevice, "vkCmdBeginRenderingKHR"));
+        device->cmdEndRendering_ = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+            vkGetDeviceProcAddr(vkDevice, "vkCmdEndRenderingKHR"));
+        if (!device->cmdEndRendering_) {
+            device->cmdBeginRendering_ = nullptr;
+        }
+    }
+    if (synchronization2_) {
+        device->queueSubmit2_ = reinterpret_cast<PFN_vkQueueSubmit2KHR>(
+            vkGetDeviceProcAddr(vkDevice, "vkQueueSubmit2KHR"));
+        device->cmdPipelineBarrier2_ = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(
+            vkGetDeviceProcAddr(vkDevice, "vkCmdPipelineBarrier2KHR"));
+        if (!device->cmdPipelineBarrier2_) {
+            device->queueSubmit2_ = nullptr;
+        }
+    }
+    if (fragmentShadingRate_) {
+        device->cmdSetFragmentShadingRate_ = reinterpret_cast<PFN_vkCmdSetFragmentShadingRateKHR>(
+            vkGetDeviceProcAddr(vkDevice, "vkCmdSetFragmentShadingRateKHR"));
+    }
+    if (hostImageCopy_) {
+        device->copyMemoryToImage_ = reinterpret_cast<PFN_vkCopyMemoryToImageEXT>(
+            vkGetDeviceProcAddr(vkDevice, "vkCopyMemoryToImageEXT"));
+        device->transitionImageLayout_ = reinterpret_cast<PFN_vkTransitionImageLayoutEXT>(
+            vkGetDeviceProcAddr(vkDevice, "vkTransitionImageLayoutEXT"));
+        if (!device->transitionImageLayout_) {
+            device->copyMemoryToImage_ = nullptr;
+        }
+    }
 
     // Get queues
     VkQueue vkGraphicsQueue;
@@ -252,9 +649,44 @@ LogicalDevicePtr LogicalDeviceBuilder::build() {
         device->presentQueue_ = device->ownedQueues_.back().get();
     }
 
+    if (computeFamily) {
+        VkQueue vkComputeQueue;
+        vkGetDeviceQueue(vkDevice, *computeFamily, 0, &vkComputeQueue);
+        device->ownedQueues_.push_back(
+            std::unique_ptr<Queue>(new Queue(vkComputeQueue, *computeFamily, QueueType::Compute)));
+        device->computeQueue_ = device->ownedQueues_.back().get();
+    }
+
+    if (transferFamily) {
+        if (computeFamily && *transferFamily == *computeFamily) {
+            device->transferQueue_ = device->computeQueue_;
+        } else {
+            VkQueue vkTransferQueue;
+            vkGetDeviceQueue(vkDevice, *transferFamily, 0, &vkTransferQueue);
+            device->ownedQueues_.push_back(
+                std::unique_ptr<Queue>(new Queue(vkTransferQueue, *transferFamily, QueueType::Transfer)));
+            device->transferQueue_ = device->ownedQueues_.back().get();
+        }
+    }
+
+    if (features12.timelineSemaphore) {
+        for (auto& queue : device->ownedQueues_) {
+            queue->createTimeline(vkDevice);
+        }
+    }
+    for (auto& queue : device->ownedQueues_) {
+        queue->queueSubmit2_ = device->queueSubmit2_;
+    }
+
     // Create memory allocator
     device->allocator_ = std::make_unique<MemoryAllocator>(device.get());
 
+    // Create pipeline cache (loads from disk if a directory was configured)
+    device->pipelineCache_ = std::make_unique<PipelineCache>(device.get(), pipelineCacheDirectory_);
+
+    device->samplerCache_ = std::make_unique<SamplerCache>(device.get());
+    device->pipelineRegistry_ = std::make_unique<PipelineRegistry>(device.get());
+
     FINEVK_INFO(LogCategory::Core, "Logical device created successfully");
 
     return device;
@@ -1,22 +1,118 @@
 #include "finevk/device/memory.hpp"
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/physical_device.hpp"
+#include "finevk/device/command.hpp"
 #include "finevk/core/logging.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace finevk {
 
+// ============================================================================
+// MemoryBlock implementation
+// ============================================================================
+
+namespace {
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return alignment > 1 ? (value + alignment - 1) & ~(alignment - 1) : value;
+}
+
+} // anonymous namespace
+
+const char* memoryCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::Other: return "other";
+        case MemoryCategory::Mesh: return "mesh";
+        case MemoryCategory::Texture: return "texture";
+        case MemoryCategory::Uniform: return "uniform";
+        case MemoryCategory::Staging: return "staging";
+        case MemoryCategory::Attachment: return "attachment";
+    }
+    return "other";
+}
+
+bool MemoryBlock::tryAllocate(VkDeviceSize reqSize, VkDeviceSize alignment,
+                              VkDeviceSize& outOffset) {
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        VkDeviceSize rangeStart = it->first;
+        VkDeviceSize rangeEnd = it->first + it->second;
+        VkDeviceSize alignedStart = alignUp(rangeStart, alignment);
+        if (alignedStart + reqSize > rangeEnd) {
+            continue;
+        }
+
+        // Split the free range into head padding and tail remainder
+        freeRanges.erase(it);
+        if (alignedStart > rangeStart) {
+            freeRanges[rangeStart] = alignedStart - rangeStart;
+        }
+        if (alignedStart + reqSize < rangeEnd) {
+            freeRanges[alignedStart + reqSize] = rangeEnd - (alignedStart + reqSize);
+        }
+
+        outOffset = alignedStart;
+        used += reqSize;
+        allocationCount++;
+        return true;
+    }
+    return false;
+}
+
+void MemoryBlock::release(VkDeviceSize offset, VkDeviceSize relSize) {
+    used -= relSize;
+    allocationCount--;
+
+    auto next = freeRanges.lower_bound(offset);
+
+    // Merge with the following free range
+    if (next != freeRanges.end() && offset + relSize == next->first) {
+        relSize += next->second;
+        next = freeRanges.erase(next);
+    }
+
+    // Merge with the preceding free range
+    if (next != freeRanges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += relSize;
+            return;
+        }
+    }
+
+    freeRanges[offset] = relSize;
+}
+
+// ============================================================================
+// MemoryAllocator implementation
+// ============================================================================
+
 MemoryAllocator::MemoryAllocator(LogicalDevice* device)
     : device_(device) {
 }
 
 MemoryAllocator::~MemoryAllocator() {
+    // The device is idle by now, so nothing can still use the moved-from handles
+    for (auto& retired : retiredMoves_) {
+        retired.destroy();
+        freeLocked(retired.allocation);
+    }
+    retiredMoves_.clear();
+
     if (allocationCount_ > 0) {
         FINEVK_WARN(LogCategory::Core,
             "MemoryAllocator destroyed with " + std::to_string(allocationCount_) +
             " allocations still active (" + std::to_string(totalAllocated_) + " bytes)");
     }
+
+    for (auto& block : blocks_) {
+        if (block->mappedBase) {
+            vkUnmapMemory(device_->handle(), block->memory);
+        }
+        vkFreeMemory(device_->handle(), block->memory, nullptr);
+    }
+    blocks_.clear();
 }
 
 VkMemoryPropertyFlags MemoryAllocator::getMemoryProperties(MemoryUsage usage) const {
@@ -28,15 +124,23 @@ VkMemoryPropertyFlags MemoryAllocator::getMemoryProperties(MemoryUsage usage) co
             return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 
+        // Cached memory is often only offered non-coherent; Buffer::invalidate() covers it
         case MemoryUsage::GpuToCpu:
             return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
                    VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
 
         case MemoryUsage::CpuOnly:
             return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
                    VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+        case MemoryUsage::Transient:
+            return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                   VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+        case MemoryUsage::GpuDirectWrite:
+            return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
     }
     return 0;
 }
@@ -53,9 +157,11 @@ uint32_t MemoryAllocator::findMemoryType(
         }
     }
 
-    // If we couldn't find an exact match for CpuToGpu/GpuToCpu, try without cached
-    if (properties & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) {
-        VkMemoryPropertyFlags fallback = properties & ~VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    // If we couldn't find an exact match for CpuToGpu/GpuToCpu, try without cached;
+    // Transient falls back to plain device-local memory on desktop GPUs
+    if (properties & (VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)) {
+        VkMemoryPropertyFlags fallback = properties &
+            ~(VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
         for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
             if ((typeFilter & (1 << i)) &&
                 (memProps.memoryTypes[i].propertyFlags & fallback) == fallback) {
@@ -67,16 +173,62 @@ uint32_t MemoryAllocator::findMemoryType(
     throw std::runtime_error("Failed to find suitable memory type");
 }
 
-AllocationInfo MemoryAllocator::allocate(
-    const VkMemoryRequirements& requirements,
-    MemoryUsage usage) {
+uint32_t MemoryAllocator::findDirectWriteType(uint32_t typeFilter, VkDeviceSize size) const {
+    const auto& memProps = device_->physicalDevice()->capabilities().memory;
+    VkMemoryPropertyFlags direct = getMemoryProperties(MemoryUsage::GpuDirectWrite);
 
-    VkMemoryPropertyFlags properties = getMemoryProperties(usage);
-    uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+    // A small BAR window is shared with the driver, so only take from a heap
+    // while its budget has room; otherwise write through system memory
+    std::vector<MemoryBudget> heapBudgets;
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) &&
+            (memProps.memoryTypes[i].propertyFlags & direct) == direct) {
+            if (heapBudgets.empty()) {
+                heapBudgets = budgets();
+            }
+            if (heapBudgets[memProps.memoryTypes[i].heapIndex].available() >= size) {
+                return i;
+            }
+        }
+    }
+    return findMemoryType(typeFilter, getMemoryProperties(MemoryUsage::CpuToGpu));
+}
+
+uint32_t MemoryAllocator::chooseMemoryType(uint32_t typeFilter, MemoryUsage usage, VkDeviceSize size) const {
+    if (usage == MemoryUsage::GpuDirectWrite) {
+        return findDirectWriteType(typeFilter, size);
+    }
+    return findMemoryType(typeFilter, getMemoryProperties(usage));
+}
+
+bool MemoryAllocator::supportsDirectWrite() const {
+    const auto& memProps = device_->physicalDevice()->capabilities().memory;
+    VkMemoryPropertyFlags direct = getMemoryProperties(MemoryUsage::GpuDirectWrite);
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+        if ((memProps.memoryTypes[i].propertyFlags & direct) == direct) {
+            return true;
+        }
+    }
+    return false;
+}
+
+VkDeviceSize MemoryAllocator::preferredBlockSize(uint32_t memoryType) const {
+    const auto& memProps = device_->physicalDevice()->capabilities().memory;
+    uint32_t heapIndex = memProps.memoryTypes[memoryType].heapIndex;
+    VkDeviceSize heapSize = memProps.memoryHeaps[heapIndex].size;
+
+    // Small heaps (e.g. the 256MB BAR window) shouldn't be eaten by one block
+    return std::min(blockSize_, std::max<VkDeviceSize>(heapSize / 8, 1));
+}
+
+AllocationInfo MemoryAllocator::allocateDedicated(
+    VkDeviceSize size, uint32_t memoryType, bool hostVisible,
+    const VkMemoryDedicatedAllocateInfo* resource) {
 
     VkMemoryAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = requirements.size;
+    allocInfo.pNext = resource;  // Lets the driver optimize for the one resource bound here
+    allocInfo.allocationSize = size;
     allocInfo.memoryTypeIndex = memoryType;
 
     VkDeviceMemory memory;
@@ -88,16 +240,231 @@ AllocationInfo MemoryAllocator::allocate(
     AllocationInfo info;
     info.memory = memory;
     info.offset = 0;
-    info.size = requirements.size;
+    info.size = size;
     info.mappedPtr = nullptr;
+    info.memoryType = memoryType;
 
     // Automatically map host-visible memory
-    if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-        vkMapMemory(device_->handle(), memory, 0, requirements.size, 0, &info.mappedPtr);
+    if (hostVisible) {
+        vkMapMemory(device_->handle(), memory, 0, size, 0, &info.mappedPtr);
+    }
+
+    deviceMemoryCount_++;
+    totalReserved_ += size;
+    trackReserved(memoryType, size, true);
+
+    return info;
+}
+
+MemoryBlock* MemoryAllocator::createBlock(
+    VkDeviceSize size, uint32_t memoryType, ResourceKind kind, bool hostVisible) {
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkDeviceMemory memory;
+    VkResult result = vkAllocateMemory(device_->handle(), &allocInfo, nullptr, &memory);
+    if (result != VK_SUCCESS) {
+        return nullptr;
+    }
+
+    auto block = std::make_unique<MemoryBlock>();
+    block->memory = memory;
+    block->size = size;
+    block->memoryType = memoryType;
+    block->kind = kind;
+    block->freeRanges[0] = size;
+
+    // Host-visible blocks stay mapped for their whole lifetime
+    if (hostVisible) {
+        result = vkMapMemory(device_->handle(), memory, 0, VK_WHOLE_SIZE, 0, &block->mappedBase);
+        if (result != VK_SUCCESS) {
+            vkFreeMemory(device_->handle(), memory, nullptr);
+            return nullptr;
+        }
+    }
+
+    deviceMemoryCount_++;
+    totalReserved_ += size;
+    trackReserved(memoryType, size, true);
+
+    FINEVK_DEBUG(LogCategory::Core,
+        "Allocated memory block: " + std::to_string(size) + " bytes, type " +
+        std::to_string(memoryType));
+
+    blocks_.push_back(std::move(block));
+    return blocks_.back().get();
+}
+
+void MemoryAllocator::destroyBlock(MemoryBlock* block) {
+    auto it = std::find_if(blocks_.begin(), blocks_.end(),
+        [block](const std::unique_ptr<MemoryBlock>& b) { return b.get() == block; });
+    if (it == blocks_.end()) {
+        return;
+    }
+
+    if (block->mappedBase) {
+        vkUnmapMemory(device_->handle(), block->memory);
+    }
+    vkFreeMemory(device_->handle(), block->memory, nullptr);
+
+    deviceMemoryCount_--;
+    totalReserved_ -= block->size;
+    trackReserved(block->memoryType, block->size, false);
+    blocks_.erase(it);
+}
+
+AllocationInfo MemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    MemoryUsage usage,
+    ResourceKind kind,
+    MemoryCategory category) {
+    return allocate(requirements, usage, kind, category, nullptr, false);
+}
+
+bool MemoryAllocator::wantsDedicated(const VkMemoryRequirements& requirements,
+                                     const VkMemoryDedicatedRequirements& dedicated) const {
+    if (dedicated.requiresDedicatedAllocation) {
+        return true;
     }
+    return dedicated.prefersDedicatedAllocation && requirements.size >= dedicatedThreshold_;
+}
+
+AllocationInfo MemoryAllocator::allocateForBuffer(
+    VkBuffer buffer,
+    MemoryUsage usage,
+    MemoryCategory category) {
+
+    VkBufferMemoryRequirementsInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+    info.buffer = buffer;
+
+    VkMemoryDedicatedRequirements dedicated{};
+    dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicated;
+    vkGetBufferMemoryRequirements2(device_->handle(), &info, &requirements);
+
+    VkMemoryDedicatedAllocateInfo resource{};
+    resource.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    resource.buffer = buffer;
+    return allocate(requirements.memoryRequirements, usage, ResourceKind::Linear, category,
+                    &resource, wantsDedicated(requirements.memoryRequirements, dedicated));
+}
+
+AllocationInfo MemoryAllocator::allocateForImage(
+    VkImage image,
+    MemoryUsage usage,
+    ResourceKind kind,
+    MemoryCategory category) {
+
+    VkImageMemoryRequirementsInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+    info.image = image;
+
+    VkMemoryDedicatedRequirements dedicated{};
+    dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicated;
+    vkGetImageMemoryRequirements2(device_->handle(), &info, &requirements);
+
+    VkMemoryDedicatedAllocateInfo resource{};
+    resource.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    resource.image = image;
+    return allocate(requirements.memoryRequirements, usage, kind, category,
+                    &resource, wantsDedicated(requirements.memoryRequirements, dedicated));
+}
+
+AllocationInfo MemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    MemoryUsage usage,
+    ResourceKind kind,
+    MemoryCategory category,
+    const VkMemoryDedicatedAllocateInfo* resource,
+    bool dedicated) {
+
+    VkMemoryPropertyFlags properties = getMemoryProperties(usage);
+    uint32_t memoryType = chooseMemoryType(requirements.memoryTypeBits, usage, requirements.size);
+    bool hostVisible = (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+
+    // Blocks are shared by every usage that lands in a memory type (on UMA
+    // GPUs GpuOnly and CpuToGpu often do), so map them by the type's flags
+    const auto& memProps = device_->physicalDevice()->capabilities().memory;
+    VkMemoryPropertyFlags typeFlags = memProps.memoryTypes[memoryType].propertyFlags;
+    bool mapBlock = (typeFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+
+    // Lazily allocated memory is committed per allocation as tiles spill, so
+    // sharing a block would only pin memory the attachment never touches
+    if (typeFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+        dedicated = true;
+    }
+
+    // Flushes and invalidations cover whole atoms, so neighbours in
+    // non-coherent memory must not share one
+    VkDeviceSize alignment = requirements.alignment;
+    if (mapBlock && !(typeFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        VkDeviceSize atom = device_->physicalDevice()->capabilities().properties.limits.nonCoherentAtomSize;
+        alignment = std::max(alignment, atom);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    VkDeviceSize blockSize = preferredBlockSize(memoryType);
+    if (dedicated || !poolingEnabled_ || requirements.size > blockSize / 2) {
+        AllocationInfo info = allocateDedicated(requirements.size, memoryType, hostVisible, resource);
+        info.alignment = alignment;
+        info.category = category;
+        totalAllocated_ += requirements.size;
+        allocationCount_++;
+        trackAllocated(memoryType, category, requirements.size, true);
+        return info;
+    }
+
+    // Try existing blocks of the same type and resource kind
+    MemoryBlock* target = nullptr;
+    VkDeviceSize offset = 0;
+    for (auto& block : blocks_) {
+        if (block->memoryType == memoryType && block->kind == kind &&
+            block->size - block->used >= requirements.size &&
+            block->tryAllocate(requirements.size, alignment, offset)) {
+            target = block.get();
+            break;
+        }
+    }
+
+    if (!target) {
+        target = createBlock(blockSize, memoryType, kind, mapBlock);
+        if (!target || !target->tryAllocate(requirements.size, alignment, offset)) {
+            // Out of room for a whole block; fall back to an exact-size allocation
+            AllocationInfo info = allocateDedicated(requirements.size, memoryType, hostVisible, resource);
+            info.alignment = alignment;
+            info.category = category;
+            totalAllocated_ += requirements.size;
+            allocationCount_++;
+            trackAllocated(memoryType, category, requirements.size, true);
+            return info;
+        }
+    }
+
+    AllocationInfo info;
+    info.memory = target->memory;
+    info.offset = offset;
+    info.size = requirements.size;
+    info.alignment = alignment;
+    info.mappedPtr = hostVisible && target->mappedBase
+        ? static_cast<char*>(target->mappedBase) + offset
+        : nullptr;
+    info.block = target;
+    info.memoryType = memoryType;
+    info.category = category;
 
     totalAllocated_ += requirements.size;
     allocationCount_++;
+    trackAllocated(memoryType, category, requirements.size, true);
 
     return info;
 }
@@ -107,14 +474,427 @@ void MemoryAllocator::free(const AllocationInfo& allocation) {
         return;
     }
 
+    std::lock_guard<std::mutex> lock(mutex_);
+    freeLocked(allocation);
+}
+
+void MemoryAllocator::freeLocked(const AllocationInfo& allocation) {
+    if (allocation.block) {
+        MemoryBlock* block = allocation.block;
+        block->release(allocation.offset, allocation.size);
+
+        // Keep one empty block per type/kind around to avoid churn
+        if (block->allocationCount == 0) {
+            bool hasOtherEmpty = std::any_of(blocks_.begin(), blocks_.end(),
+                [block](const std::unique_ptr<MemoryBlock>& b) {
+                    return b.get() != block && b->memoryType == block->memoryType &&
+                           b->kind == block->kind && b->allocationCount == 0;
+                });
+            if (hasOtherEmpty) {
+                destroyBlock(block);
+            }
+        }
+    } else {
+        if (allocation.mappedPtr) {
+            vkUnmapMemory(device_->handle(), allocation.memory);
+        }
+        vkFreeMemory(device_->handle(), allocation.memory, nullptr);
+        deviceMemoryCount_--;
+        totalReserved_ -= allocation.size;
+        trackReserved(allocation.memoryType, allocation.size, false);
+    }
+
+    totalAllocated_ -= allocation.size;
+    allocationCount_--;
+    trackAllocated(allocation.memoryType, allocation.category, allocation.size, false);
+}
+
+void* MemoryAllocator::map(AllocationInfo& allocation) {
     if (allocation.mappedPtr) {
+        return allocation.mappedPtr;
+    }
+
+    if (allocation.block) {
+        if (!allocation.block->mappedBase) {
+            throw std::runtime_error("Cannot map allocation in non-host-visible memory");
+        }
+        allocation.mappedPtr = static_cast<char*>(allocation.block->mappedBase) + allocation.offset;
+        return allocation.mappedPtr;
+    }
+
+    void* data;
+    VkResult result = vkMapMemory(device_->handle(), allocation.memory,
+                                  allocation.offset, allocation.size, 0, &data);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to map memory");
+    }
+
+    allocation.mappedPtr = data;
+    return data;
+}
+
+void MemoryAllocator::unmap(AllocationInfo& allocation) {
+    if (!allocation.mappedPtr) {
+        return;
+    }
+
+    // Sub-allocations share the block's persistent mapping
+    if (!allocation.block) {
         vkUnmapMemory(device_->handle(), allocation.memory);
     }
+    allocation.mappedPtr = nullptr;
+}
 
-    vkFreeMemory(device_->handle(), allocation.memory, nullptr);
+bool MemoryAllocator::isCoherent(const AllocationInfo& allocation) const {
+    const auto& memProps = device_->physicalDevice()->capabilities().memory;
+    return (memProps.memoryTypes[allocation.memoryType].propertyFlags &
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
 
-    totalAllocated_ -= allocation.size;
-    allocationCount_--;
+bool MemoryAllocator::mappedRange(const AllocationInfo& allocation, VkDeviceSize offset,
+                                  VkDeviceSize size, VkMappedMemoryRange& range) const {
+    if (allocation.memory == VK_NULL_HANDLE || isCoherent(allocation) || offset >= allocation.size) {
+        return false;
+    }
+
+    VkDeviceSize atom = device_->physicalDevice()->capabilities().properties.limits.nonCoherentAtomSize;
+    VkDeviceSize memorySize = allocation.block ? allocation.block->size : allocation.offset + allocation.size;
+
+    VkDeviceSize begin = allocation.offset + offset;
+    VkDeviceSize end = allocation.offset +
+        (size == VK_WHOLE_SIZE ? allocation.size : std::min(allocation.size, offset + size));
+    begin = begin / atom * atom;
+    end = std::min((end + atom - 1) / atom * atom, memorySize);
+
+    range = {};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = allocation.memory;
+    range.offset = begin;
+    range.size = end - begin;
+    return true;
+}
+
+void MemoryAllocator::flush(const AllocationInfo& allocation,
+                            VkDeviceSize offset, VkDeviceSize size) const {
+    VkMappedMemoryRange range;
+    if (mappedRange(allocation, offset, size, range) &&
+        vkFlushMappedMemoryRanges(device_->handle(), 1, &range) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to flush mapped memory");
+    }
+}
+
+void MemoryAllocator::invalidate(const AllocationInfo& allocation,
+                                 VkDeviceSize offset, VkDeviceSize size) const {
+    VkMappedMemoryRange range;
+    if (mappedRange(allocation, offset, size, range) &&
+        vkInvalidateMappedMemoryRanges(device_->handle(), 1, &range) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to invalidate mapped memory");
+    }
+}
+
+// ============================================================================
+// Statistics and budget
+// ============================================================================
+
+namespace {
+
+void addAllocated(MemoryStats& stats, VkDeviceSize size, bool add) {
+    if (add) {
+        stats.allocated += size;
+        stats.allocationCount++;
+        stats.peakAllocated = std::max(stats.peakAllocated, stats.allocated);
+    } else {
+        stats.allocated -= size;
+        stats.allocationCount--;
+    }
+}
+
+void addReserved(MemoryStats& stats, VkDeviceSize size, bool add) {
+    if (add) {
+        stats.reserved += size;
+        stats.peakReserved = std::max(stats.peakReserved, stats.reserved);
+    } else {
+        stats.reserved -= size;
+    }
+}
+
+} // anonymous namespace
+
+void MemoryAllocator::trackAllocated(uint32_t memoryType, MemoryCategory category,
+                                     VkDeviceSize size, bool add) {
+    addAllocated(typeStats_[memoryType], size, add);
+    addAllocated(heapStats_[heapIndex(memoryType)], size, add);
+    addAllocated(categoryStats_[static_cast<size_t>(category)], size, add);
+}
+
+void MemoryAllocator::trackReserved(uint32_t memoryType, VkDeviceSize size, bool add) {
+    addReserved(typeStats_[memoryType], size, add);
+    addReserved(heapStats_[heapIndex(memoryType)], size, add);
+}
+
+MemoryStats MemoryAllocator::heapStats(uint32_t heap) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return heap < heapStats_.size() ? heapStats_[heap] : MemoryStats{};
+}
+
+MemoryStats MemoryAllocator::typeStats(uint32_t memoryType) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memoryType < typeStats_.size() ? typeStats_[memoryType] : MemoryStats{};
+}
+
+MemoryStats MemoryAllocator::categoryStats(MemoryCategory category) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return categoryStats_[static_cast<size_t>(category)];
+}
+
+void MemoryAllocator::resetPeaks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto reset = [](auto& all) {
+        for (auto& stats : all) {
+            stats.peakAllocated = stats.allocated;
+            stats.peakReserved = stats.reserved;
+        }
+    };
+    reset(typeStats_);
+    reset(heapStats_);
+    reset(categoryStats_);
+}
+
+uint32_t MemoryAllocator::heapIndex(uint32_t memoryType) const {
+    return device_->physicalDevice()->capabilities().memory.memoryTypes[memoryType].heapIndex;
+}
+
+uint32_t MemoryAllocator::heapIndex(MemoryUsage usage) const {
+    return heapIndex(chooseMemoryType(~0u, usage, 0));
+}
+
+MemoryBudget MemoryAllocator::budget(uint32_t heap) const {
+    std::vector<MemoryBudget> all = budgets();
+    return heap < all.size() ? all[heap] : MemoryBudget{};
+}
+
+std::vector<MemoryBudget> MemoryAllocator::budgets() const {
+    const auto& memProps = device_->physicalDevice()->capabilities().memory;
+    bool fromDriver = device_->supportsMemoryBudget();
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProps{};
+    budgetProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    if (fromDriver) {
+        VkPhysicalDeviceMemoryProperties2 props2{};
+        props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        props2.pNext = &budgetProps;
+        vkGetPhysicalDeviceMemoryProperties2(device_->physicalDevice()->handle(), &props2);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<MemoryBudget> result(memProps.memoryHeapCount);
+    for (uint32_t i = 0; i < memProps.memoryHeapCount; i++) {
+        MemoryBudget& heap = result[i];
+        heap.heapSize = memProps.memoryHeaps[i].size;
+        heap.fromDriver = fromDriver;
+        if (fromDriver) {
+            heap.budget = budgetProps.heapBudget[i];
+            heap.usage = budgetProps.heapUsage[i];
+        } else {
+            heap.budget = heap.heapSize / 10 * 8;
+            heap.usage = heapStats_[i].reserved;
+        }
+    }
+    return result;
+}
+
+// ============================================================================
+// Defragmentation
+// ============================================================================
+
+void MemoryAllocator::registerRelocatable(Relocatable* resource) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    relocatables_.push_back(resource);
+}
+
+bool MemoryAllocator::unregisterRelocatable(Relocatable* resource) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    relocatables_.erase(std::remove(relocatables_.begin(), relocatables_.end(), resource),
+                        relocatables_.end());
+
+    for (auto it = pendingMoves_.begin(); it != pendingMoves_.end(); ++it) {
+        if (it->resource == resource) {
+            // The copy was recorded into a frame that may still be running
+            RetiredMove retired;
+            retired.allocation = it->target;
+            retired.destroy = resource->cancelMove();
+            retired.value = 0;
+            retired.framesLeft = device_->maxFramesInFlight();
+            retiredMoves_.push_back(std::move(retired));
+            pendingMoves_.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MemoryAllocator::transferRelocatable(Relocatable* from, Relocatable* to) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::replace(relocatables_.begin(), relocatables_.end(), from, to);
+    for (auto& move : pendingMoves_) {
+        if (move.resource == from) {
+            move.resource = to;
+        }
+    }
+}
+
+void MemoryAllocator::retire(std::function<void()> destroy, const AllocationInfo& allocation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RetiredMove retired;
+    retired.allocation = allocation;
+    retired.destroy = std::move(destroy);
+    retired.value = 0;
+    retired.framesLeft = device_->maxFramesInFlight();
+    retiredMoves_.push_back(std::move(retired));
+}
+
+bool MemoryAllocator::moveComplete(const Queue* queue, uint64_t& value, uint32_t& framesLeft) const {
+    if (queue && queue->timeline() != VK_NULL_HANDLE) {
+        if (value == 0) {
+            // The previous call's command buffer has been submitted since
+            value = queue->lastSubmitted();
+        }
+        return queue->isComplete(value);
+    }
+    return framesLeft == 0 || --framesLeft == 0;
+}
+
+DefragmentStats MemoryAllocator::defragment(CommandBuffer& cmd, Queue* queue,
+                                            const DefragmentLimits& limits) {
+    DefragmentStats stats;
+    uint32_t frameDelay = device_->maxFramesInFlight();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Moved-from handles and memory, once no frame in flight can use them
+    for (size_t i = 0; i < retiredMoves_.size();) {
+        RetiredMove& retired = retiredMoves_[i];
+        if (moveComplete(queue, retired.value, retired.framesLeft)) {
+            retired.destroy();
+            freeLocked(retired.allocation);
+            retiredMoves_[i] = std::move(retiredMoves_.back());
+            retiredMoves_.pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    // Copies the GPU has finished: switch resources over
+    if (!pendingMoves_.empty() && moveComplete(queue, pendingValue_, pendingFramesLeft_)) {
+        for (auto& move : pendingMoves_) {
+            RetiredMove retired;
+            retired.allocation = move.resource->allocation();
+            retired.destroy = move.resource->commitMove();
+            retired.value = 0;
+            retired.framesLeft = frameDelay;
+            retiredMoves_.push_back(std::move(retired));
+            stats.movesCommitted++;
+        }
+        pendingMoves_.clear();
+    }
+
+    if (pendingMoves_.empty()) {
+        recordMoves(cmd, limits, stats);
+        pendingValue_ = 0;
+        pendingFramesLeft_ = frameDelay;
+    }
+
+    stats.movesPending = static_cast<uint32_t>(pendingMoves_.size());
+    return stats;
+}
+
+void MemoryAllocator::recordMoves(CommandBuffer& cmd, const DefragmentLimits& limits,
+                                  DefragmentStats& stats) {
+    auto usage = [](const MemoryBlock* block) {
+        return static_cast<float>(block->used) / static_cast<float>(block->size);
+    };
+
+    // Sparse blocks holding relocatable resources, sparsest first
+    std::vector<MemoryBlock*> sources;
+    for (Relocatable* resource : relocatables_) {
+        MemoryBlock* block = resource->allocation().block;
+        if (block && usage(block) < limits.maxBlockUsage &&
+            std::find(sources.begin(), sources.end(), block) == sources.end()) {
+            sources.push_back(block);
+        }
+    }
+    std::sort(sources.begin(), sources.end(),
+        [&usage](const MemoryBlock* a, const MemoryBlock* b) { return usage(a) < usage(b); });
+
+    bool barrierRecorded = false;
+    for (MemoryBlock* source : sources) {
+        // Only fill blocks at least as full as the source, fullest first, so
+        // resources never move back and forth between passes
+        std::vector<MemoryBlock*> targets;
+        for (auto& block : blocks_) {
+            if (block.get() != source && block->memoryType == source->memoryType &&
+                block->kind == source->kind && usage(block.get()) >= usage(source)) {
+                targets.push_back(block.get());
+            }
+        }
+        std::sort(targets.begin(), targets.end(),
+            [&usage](const MemoryBlock* a, const MemoryBlock* b) { return usage(a) > usage(b); });
+
+        for (Relocatable* resource : relocatables_) {
+            const AllocationInfo& current = resource->allocation();
+            if (current.block != source) {
+                continue;
+            }
+            if (stats.movesRecorded >= limits.maxMovesPerPass ||
+                (stats.movesRecorded > 0 && stats.bytesRecorded + current.size > limits.maxBytesPerPass)) {
+                return;
+            }
+
+            for (MemoryBlock* target : targets) {
+                VkDeviceSize offset = 0;
+                if (target->size - target->used < current.size ||
+                    !target->tryAllocate(current.size, current.alignment, offset)) {
+                    continue;
+                }
+
+                AllocationInfo info;
+                info.memory = target->memory;
+                info.offset = offset;
+                info.size = current.size;
+                info.alignment = current.alignment;
+                info.mappedPtr = current.mappedPtr && target->mappedBase
+                    ? static_cast<char*>(target->mappedBase) + offset
+                    : nullptr;
+                info.block = target;
+                info.memoryType = current.memoryType;
+                info.category = current.category;
+
+                // Earlier writes to the resources must land before they are copied
+                if (!barrierRecorded) {
+                    cmd.memoryBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+                                      VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+                    barrierRecorded = true;
+                }
+                if (!resource->beginMove(cmd, info)) {
+                    target->release(offset, current.size);
+                    break;
+                }
+
+                totalAllocated_ += info.size;
+                allocationCount_++;
+                trackAllocated(info.memoryType, info.category, info.size, true);
+                pendingMoves_.push_back({resource, info});
+                stats.movesRecorded++;
+                stats.bytesRecorded += info.size;
+                break;
+            }
+        }
+
+        // One source block per pass keeps each pass's copies bounded
+        if (stats.movesRecorded > 0) {
+            return;
+        }
+    }
 }
 
 } // namespace finevk
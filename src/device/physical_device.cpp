@@ -30,6 +30,70 @@ bool DeviceCapabilities::supportsWideLines() const {
     return features.wideLines == VK_TRUE;
 }
 
+bool DeviceCapabilities::supportsDrawIndirectCount() const {
+    return features.multiDrawIndirect == VK_TRUE && features12.drawIndirectCount == VK_TRUE;
+}
+
+bool DeviceCapabilities::supportsDescriptorIndexing() const {
+    return features12.descriptorIndexing == VK_TRUE &&
+           features12.runtimeDescriptorArray == VK_TRUE &&
+           features12.shaderSampledImageArrayNonUniformIndexing == VK_TRUE &&
+           features12.descriptorBindingPartiallyBound == VK_TRUE &&
+           features12.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE;
+}
+
+bool DeviceCapabilities::supportsMeshShader() const {
+    return meshShader.taskShader == VK_TRUE && meshShader.meshShader == VK_TRUE;
+}
+
+bool DeviceCapabilities::supportsPresentWait() const {
+    return presentId.presentId == VK_TRUE && presentWait.presentWait == VK_TRUE;
+}
+
+bool DeviceCapabilities::supportsDynamicRendering() const {
+    return dynamicRendering.dynamicRendering == VK_TRUE;
+}
+
+bool DeviceCapabilities::supportsSynchronization2() const {
+    return synchronization2.synchronization2 == VK_TRUE;
+}
+
+bool DeviceCapabilities::supportsMultiview() const {
+    return multiview.multiview == VK_TRUE && multiviewProperties.maxMultiviewViewCount > 1;
+}
+
+bool DeviceCapabilities::supportsFragmentShadingRate() const {
+    return fragmentShadingRate.pipelineFragmentShadingRate == VK_TRUE;
+}
+
+bool DeviceCapabilities::supportsHostImageCopy() const {
+    // Textures are written straight into the layout they are sampled in
+    return hostImageCopy.hostImageCopy == VK_TRUE &&
+           std::find(hostImageCopyDstLayouts.begin(), hostImageCopyDstLayouts.end(),
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) != hostImageCopyDstLayouts.end();
+}
+
+bool DeviceCapabilities::supportsPipelineStatistics() const {
+    return features.pipelineStatisticsQuery == VK_TRUE && features.inheritedQueries == VK_TRUE;
+}
+
+bool DeviceCapabilities::supportsMemoryBudget() const {
+    return supportsExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+}
+
+bool DeviceCapabilities::supportsLazilyAllocatedMemory() const {
+    for (uint32_t i = 0; i < memory.memoryTypeCount; i++) {
+        if (memory.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DeviceCapabilities::supportsTimelineSemaphore() const {
+    return features12.timelineSemaphore == VK_TRUE;
+}
+
 VkSampleCountFlagBits DeviceCapabilities::maxSampleCount() const {
     VkSampleCountFlags counts = properties.limits.framebufferColorSampleCounts
                               & properties.limits.framebufferDepthSampleCounts;
@@ -137,6 +201,45 @@ bool DeviceCapabilities::supportsLinearTiling(
     return (props.linearTilingFeatures & features) == features;
 }
 
+bool DeviceCapabilities::supportsSampling(VkPhysicalDevice device, VkFormat format) const {
+    auto props = formatProperties(device, format);
+    return (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) &&
+           (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+}
+
+bool DeviceCapabilities::supportsHostImageTransfer(VkPhysicalDevice device, VkFormat format) const {
+    if (!supportsHostImageCopy()) {
+        return false;
+    }
+
+    VkFormatProperties3 props3{};
+    props3.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3;
+    VkFormatProperties2 props2{};
+    props2.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2;
+    props2.pNext = &props3;
+    vkGetPhysicalDeviceFormatProperties2(device, format, &props2);
+    if (!(props3.optimalTilingFeatures & VK_FORMAT_FEATURE_2_HOST_IMAGE_TRANSFER_BIT_EXT)) {
+        return false;
+    }
+
+    // Some drivers store host-transferable images in a layout the GPU samples more slowly
+    VkPhysicalDeviceImageFormatInfo2 imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_FORMAT_INFO_2;
+    imageInfo.format = format;
+    imageInfo.type = VK_IMAGE_TYPE_2D;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+    VkHostImageCopyDevicePerformanceQueryEXT performance{};
+    performance.sType = VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY_EXT;
+    VkImageFormatProperties2 imageProps{};
+    imageProps.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_PROPERTIES_2;
+    imageProps.pNext = &performance;
+    if (vkGetPhysicalDeviceImageFormatProperties2(device, &imageInfo, &imageProps) != VK_SUCCESS) {
+        return false;
+    }
+    return performance.optimalDeviceAccess == VK_TRUE;
+}
+
 VkSampleCountFlagBits DeviceCapabilities::selectMSAA(
     MSAAPreference pref, VkSampleCountFlagBits requested) const {
     switch (pref) {
@@ -214,6 +317,36 @@ void PhysicalDevice::queryCapabilities() {
     vkGetPhysicalDeviceFeatures(device_, &capabilities_.features);
     vkGetPhysicalDeviceMemoryProperties(device_, &capabilities_.memory);
 
+    // Vulkan 1.2 features (the instance requests 1.2 by default)
+    capabilities_.features12 = {};
+    capabilities_.features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    if (capabilities_.properties.apiVersion >= VK_API_VERSION_1_2) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &capabilities_.features12;
+        vkGetPhysicalDeviceFeatures2(device_, &features2);
+        capabilities_.features12.pNext = nullptr;
+    }
+
+    // Multiview is core since 1.1; the view limit comes from properties2
+    capabilities_.multiview = {};
+    capabilities_.multiview.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+    capabilities_.multiviewProperties = {};
+    capabilities_.multiviewProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_PROPERTIES;
+    if (capabilities_.properties.apiVersion >= VK_API_VERSION_1_1) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &capabilities_.multiview;
+        vkGetPhysicalDeviceFeatures2(device_, &features2);
+        capabilities_.multiview.pNext = nullptr;
+
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &capabilities_.multiviewProperties;
+        vkGetPhysicalDeviceProperties2(device_, &properties2);
+        capabilities_.multiviewProperties.pNext = nullptr;
+    }
+
     // Get queue families
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(device_, &queueFamilyCount, nullptr);
@@ -227,6 +360,107 @@ void PhysicalDevice::queryCapabilities() {
     capabilities_.extensions.resize(extensionCount);
     vkEnumerateDeviceExtensionProperties(device_, nullptr, &extensionCount,
                                          capabilities_.extensions.data());
+
+    // Mesh shader features need the extension (and features2) to be queried
+    capabilities_.meshShader = {};
+    capabilities_.meshShader.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+    if (capabilities_.properties.apiVersion >= VK_API_VERSION_1_2 &&
+        capabilities_.supportsExtension(VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &capabilities_.meshShader;
+        vkGetPhysicalDeviceFeatures2(device_, &features2);
+        capabilities_.meshShader.pNext = nullptr;
+    }
+
+    // Present wait needs both extensions; query them together
+    capabilities_.presentId = {};
+    capabilities_.presentId.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    capabilities_.presentWait = {};
+    capabilities_.presentWait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    if (capabilities_.properties.apiVersion >= VK_API_VERSION_1_2 &&
+        capabilities_.supportsExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        capabilities_.supportsExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &capabilities_.presentId;
+        capabilities_.presentId.pNext = &capabilities_.presentWait;
+        vkGetPhysicalDeviceFeatures2(device_, &features2);
+        capabilities_.presentId.pNext = nullptr;
+        capabilities_.presentWait.pNext = nullptr;
+    }
+
+    // Dynamic rendering is core in 1.3; on 1.2 its dependencies are already core
+    capabilities_.dynamicRendering = {};
+    capabilities_.dynamicRendering.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    if (capabilities_.properties.apiVersion >= VK_API_VERSION_1_2 &&
+        capabilities_.supportsExtension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &capabilities_.dynamicRendering;
+        vkGetPhysicalDeviceFeatures2(device_, &features2);
+        capabilities_.dynamicRendering.pNext = nullptr;
+    }
+
+    // Synchronization2 is core in 1.3 as well
+    capabilities_.synchronization2 = {};
+    capabilities_.synchronization2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+    if (capabilities_.properties.apiVersion >= VK_API_VERSION_1_2 &&
+        capabilities_.supportsExtension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &capabilities_.synchronization2;
+        vkGetPhysicalDeviceFeatures2(device_, &features2);
+        capabilities_.synchronization2.pNext = nullptr;
+    }
+
+    // Fragment shading rate depends on renderpass2, core in 1.2
+    capabilities_.fragmentShadingRate = {};
+    capabilities_.fragmentShadingRate.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+    capabilities_.fragmentShadingRateProperties = {};
+    capabilities_.fragmentShadingRateProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR;
+    if (capabilities_.properties.apiVersion >= VK_API_VERSION_1_2 &&
+        capabilities_.supportsExtension(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME)) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &capabilities_.fragmentShadingRate;
+        vkGetPhysicalDeviceFeatures2(device_, &features2);
+        capabilities_.fragmentShadingRate.pNext = nullptr;
+
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &capabilities_.fragmentShadingRateProperties;
+        vkGetPhysicalDeviceProperties2(device_, &properties2);
+        capabilities_.fragmentShadingRateProperties.pNext = nullptr;
+    }
+
+    // Host image copy needs copy_commands2 and format_feature_flags2 below 1.3
+    capabilities_.hostImageCopy = {};
+    capabilities_.hostImageCopy.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+    capabilities_.hostImageCopyDstLayouts.clear();
+    if (capabilities_.supportsExtension(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME) &&
+        (capabilities_.properties.apiVersion >= VK_API_VERSION_1_3 ||
+         (capabilities_.properties.apiVersion >= VK_API_VERSION_1_2 &&
+          capabilities_.supportsExtension(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME) &&
+          capabilities_.supportsExtension(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME)))) {
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &capabilities_.hostImageCopy;
+        vkGetPhysicalDeviceFeatures2(device_, &features2);
+        capabilities_.hostImageCopy.pNext = nullptr;
+
+        // First call counts the layouts, second fills them in
+        VkPhysicalDeviceHostImageCopyPropertiesEXT hostImageCopyProperties{};
+        hostImageCopyProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &hostImageCopyProperties;
+        vkGetPhysicalDeviceProperties2(device_, &properties2);
+        capabilities_.hostImageCopyDstLayouts.resize(hostImageCopyProperties.copyDstLayoutCount);
+        hostImageCopyProperties.pCopyDstLayouts = capabilities_.hostImageCopyDstLayouts.data();
+        vkGetPhysicalDeviceProperties2(device_, &properties2);
+        capabilities_.hostImageCopyDstLayouts.resize(hostImageCopyProperties.copyDstLayoutCount);
+    }
 }
 
 std::vector<PhysicalDevice> PhysicalDevice::enumerate(Instance* instance) {
@@ -293,8 +527,9 @@ PhysicalDevice PhysicalDevice::selectBest(
             }
         }
 
-        // Check for required extensions
-        if (!device.capabilities().supportsExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME)) {
+        // Check for required extensions (headless selection needs no swap chain)
+        if (vkSurface != VK_NULL_HANDLE &&
+            !device.capabilities().supportsExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME)) {
             continue;
         }
 
@@ -341,6 +576,15 @@ SwapChainSupport PhysicalDevice::querySwapChainSupport(VkSurfaceKHR surface) con
     return support;
 }
 
+VkFormat PhysicalDevice::selectSampledFormat(const std::vector<VkFormat>& candidates) const {
+    for (VkFormat format : candidates) {
+        if (capabilities_.supportsSampling(device_, format)) {
+            return format;
+        }
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
 LogicalDeviceBuilder PhysicalDevice::createLogicalDevice() {
     return LogicalDeviceBuilder(this);
 }
@@ -351,8 +595,10 @@ LogicalDeviceBuilder PhysicalDevice::createLogicalDevice() {
 
 LogicalDeviceBuilder::LogicalDeviceBuilder(PhysicalDevice* physical)
     : physical_(physical) {
-    // Always require swapchain extension
-    extensions_.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    // Swapchain extension wherever it exists; headless devices may lack it
+    if (physical_->capabilities().supportsExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME)) {
+        extensions_.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
 
 #ifdef VK_USE_PLATFORM_MACOS_MVK
     // MoltenVK portability subset
@@ -373,6 +619,42 @@ LogicalDeviceBuilder& LogicalDeviceBuilder::enableFeature(
     return *this;
 }
 
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableVulkan12Feature(
+    std::function<void(VkPhysicalDeviceVulkan12Features&)> enabler) {
+    enabler(enabledFeatures12_);
+    useFeatures12_ = true;
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableIndirectDraw() {
+    const auto& caps = physical_->capabilities();
+    if (caps.features.multiDrawIndirect) {
+        enabledFeatures_.multiDrawIndirect = VK_TRUE;
+    }
+    if (caps.supportsDrawIndirectCount()) {
+        enabledFeatures12_.drawIndirectCount = VK_TRUE;
+        useFeatures12_ = true;
+    }
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableDescriptorIndexing() {
+    const auto& caps = physical_->capabilities();
+    if (!caps.supportsDescriptorIndexing()) {
+        return *this;
+    }
+    enabledFeatures12_.descriptorIndexing = VK_TRUE;
+    enabledFeatures12_.runtimeDescriptorArray = VK_TRUE;
+    enabledFeatures12_.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    enabledFeatures12_.descriptorBindingPartiallyBound = VK_TRUE;
+    enabledFeatures12_.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    if (caps.features12.descriptorBindingUpdateUnusedWhilePending) {
+        enabledFeatures12_.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    }
+    useFeatures12_ = true;
+    return *this;
+}
+
 LogicalDeviceBuilder& LogicalDeviceBuilder::enableAnisotropy() {
     if (physical_->capabilities().supportsAnisotropy()) {
         enabledFeatures_.samplerAnisotropy = VK_TRUE;
@@ -387,9 +669,101 @@ LogicalDeviceBuilder& LogicalDeviceBuilder::enableSampleRateShading() {
     return *this;
 }
 
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableMeshShader() {
+    if (physical_->capabilities().supportsMeshShader() && !meshShader_) {
+        extensions_.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+        meshShader_ = true;
+        useFeatures12_ = true;  // Extension features chain through VkPhysicalDeviceFeatures2
+    }
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enablePresentWait() {
+    if (physical_->capabilities().supportsPresentWait() && !presentWait_) {
+        extensions_.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        extensions_.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        presentWait_ = true;
+        useFeatures12_ = true;
+    }
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableMultiview() {
+    if (physical_->capabilities().supportsMultiview()) {
+        multiview_ = true;
+        useFeatures12_ = true;
+    }
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableDynamicRendering() {
+    if (physical_->capabilities().supportsDynamicRendering() && !dynamicRendering_) {
+        extensions_.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        dynamicRendering_ = true;
+        useFeatures12_ = true;
+    }
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableSynchronization2() {
+    if (physical_->capabilities().supportsSynchronization2() && !synchronization2_) {
+        extensions_.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+        synchronization2_ = true;
+        useFeatures12_ = true;
+    }
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableFragmentShadingRate() {
+    if (physical_->capabilities().supportsFragmentShadingRate() && !fragmentShadingRate_) {
+        extensions_.push_back(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+        fragmentShadingRate_ = true;
+        useFeatures12_ = true;
+    }
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enableHostImageCopy() {
+    if (physical_->capabilities().supportsHostImageCopy() && !hostImageCopy_) {
+        extensions_.push_back(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME);
+        if (physical_->capabilities().properties.apiVersion < VK_API_VERSION_1_3) {
+            extensions_.push_back(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME);
+            extensions_.push_back(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME);
+        }
+        hostImageCopy_ = true;
+        useFeatures12_ = true;
+    }
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::enablePipelineStatistics() {
+    if (physical_->capabilities().supportsPipelineStatistics()) {
+        enabledFeatures_.pipelineStatisticsQuery = VK_TRUE;
+        enabledFeatures_.inheritedQueries = VK_TRUE;
+    }
+    return *this;
+}
+
 LogicalDeviceBuilder& LogicalDeviceBuilder::surface(Surface* surface) {
     surface_ = surface;
     return *this;
 }
 
+LogicalDeviceBuilder& LogicalDeviceBuilder::framesInFlight(uint32_t count, uint32_t maxCount) {
+    if (maxCount == 0) {
+        maxCount = std::max(count, 3u);
+    }
+    if (count == 0 || count > maxCount) {
+        throw std::runtime_error("Frames in flight must be between 1 and the maximum");
+    }
+    framesInFlight_ = count;
+    maxFramesInFlight_ = maxCount;
+    return *this;
+}
+
+LogicalDeviceBuilder& LogicalDeviceBuilder::pipelineCacheDirectory(const std::string& directory) {
+    pipelineCacheDirectory_ = directory;
+    return *this;
+}
+
 } // namespace finevk
@@ -0,0 +1,151 @@
+#include "finevk/device/pipeline_cache.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace finevk {
+
+PipelineCache::PipelineCache(LogicalDevice* device, const std::string& directory)
+    : device_(device) {
+
+    const auto& props = device_->physicalDevice()->capabilities().properties;
+
+    std::vector<uint8_t> blob;
+    if (!directory.empty()) {
+        filePath_ = directory + "/" + fileName(props);
+
+        std::ifstream file(filePath_, std::ios::binary | std::ios::ate);
+        if (file) {
+            blob.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+            if (!file || !isCompatible(blob)) {
+                FINEVK_WARN(LogCategory::Core, "Ignoring incompatible pipeline cache: " + filePath_);
+                blob.clear();
+            }
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = blob.size();
+    cacheInfo.pInitialData = blob.empty() ? nullptr : blob.data();
+
+    VkResult result = vkCreatePipelineCache(device_->handle(), &cacheInfo, nullptr, &cache_);
+    if (result != VK_SUCCESS && !blob.empty()) {
+        // Driver rejected the blob despite a valid header; start fresh
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        blob.clear();
+        result = vkCreatePipelineCache(device_->handle(), &cacheInfo, nullptr, &cache_);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache");
+    }
+
+    loadedFromDisk_ = !blob.empty();
+    if (loadedFromDisk_) {
+        FINEVK_INFO(LogCategory::Core, "Loaded pipeline cache: " + filePath_ +
+            " (" + std::to_string(blob.size()) + " bytes)");
+    }
+}
+
+PipelineCache::~PipelineCache() {
+    if (cache_ != VK_NULL_HANDLE) {
+        save();
+        vkDestroyPipelineCache(device_->handle(), cache_, nullptr);
+        cache_ = VK_NULL_HANDLE;
+    }
+}
+
+std::string PipelineCache::fileName(const VkPhysicalDeviceProperties& properties) {
+    char name[96];
+    std::snprintf(name, sizeof(name), "pipeline_cache_%04x_%04x_%08x.bin",
+                  properties.vendorID, properties.deviceID, properties.driverVersion);
+    return name;
+}
+
+bool PipelineCache::isCompatible(const std::vector<uint8_t>& blob) const {
+    // Layout of VkPipelineCacheHeaderVersionOne
+    constexpr size_t headerSize = 16 + VK_UUID_SIZE;
+    if (blob.size() < headerSize) {
+        return false;
+    }
+
+    uint32_t length, version, vendorID, deviceID;
+    std::memcpy(&length, blob.data() + 0, 4);
+    std::memcpy(&version, blob.data() + 4, 4);
+    std::memcpy(&vendorID, blob.data() + 8, 4);
+    std::memcpy(&deviceID, blob.data() + 12, 4);
+
+    const auto& props = device_->physicalDevice()->capabilities().properties;
+    return length >= headerSize &&
+           version == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           vendorID == props.vendorID &&
+           deviceID == props.deviceID &&
+           std::memcmp(blob.data() + 16, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<uint8_t> PipelineCache::data() const {
+    size_t size = 0;
+    vkGetPipelineCacheData(device_->handle(), cache_, &size, nullptr);
+
+    std::vector<uint8_t> blob(size);
+    if (size > 0 &&
+        vkGetPipelineCacheData(device_->handle(), cache_, &size, blob.data()) != VK_SUCCESS) {
+        return {};
+    }
+    blob.resize(size);
+    return blob;
+}
+
+bool PipelineCache::save() const {
+    if (filePath_.empty()) {
+        return false;
+    }
+    return save(filePath_);
+}
+
+bool PipelineCache::save(const std::string& path) const {
+    auto blob = data();
+    if (blob.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    // Write to a temp file first so a crash never leaves a truncated cache
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            FINEVK_WARN(LogCategory::Core, "Failed to write pipeline cache: " + path);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        FINEVK_WARN(LogCategory::Core, "Failed to write pipeline cache: " + path);
+        return false;
+    }
+
+    FINEVK_DEBUG(LogCategory::Core, "Saved pipeline cache: " + path +
+        " (" + std::to_string(blob.size()) + " bytes)");
+    return true;
+}
+
+} // namespace finevk
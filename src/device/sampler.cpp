@@ -2,6 +2,7 @@
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/physical_device.hpp"
 
+#include <cstring>
 #include <stdexcept>
 
 namespace finevk {
@@ -101,6 +102,10 @@ SamplerPtr Sampler::Builder::build() {
     return sampler;
 }
 
+SamplerRef Sampler::Builder::buildShared() {
+    return device_->samplerCache().get(*this);
+}
+
 // ============================================================================
 // Sampler implementation
 // ============================================================================
@@ -150,4 +155,93 @@ void Sampler::cleanup() {
     }
 }
 
+// ============================================================================
+// SamplerCache implementation
+// ============================================================================
+
+SamplerCache::SamplerCache(LogicalDevice* device)
+    : device_(device) {
+}
+
+SamplerCache::~SamplerCache() {
+    // Users may still hold references; their samplers must not outlive the device
+    for (auto& [key, sampler] : samplers_) {
+        sampler->cleanup();
+    }
+}
+
+SamplerCache::Key SamplerCache::makeKey(const VkSamplerCreateInfo& info) {
+    auto bits = [](float value) {
+        uint32_t result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    };
+    // pNext chains (e.g. YCbCr conversion, reduction mode) are not part of the key
+    return {
+        info.flags,
+        static_cast<uint32_t>(info.magFilter),
+        static_cast<uint32_t>(info.minFilter),
+        static_cast<uint32_t>(info.mipmapMode),
+        static_cast<uint32_t>(info.addressModeU),
+        static_cast<uint32_t>(info.addressModeV),
+        static_cast<uint32_t>(info.addressModeW),
+        bits(info.mipLodBias),
+        info.anisotropyEnable,
+        info.anisotropyEnable ? bits(info.maxAnisotropy) : 0u,
+        info.compareEnable,
+        info.compareEnable ? static_cast<uint32_t>(info.compareOp) : 0u,
+        bits(info.minLod),
+        bits(info.maxLod),
+        static_cast<uint32_t>(info.borderColor),
+        info.unnormalizedCoordinates,
+    };
+}
+
+SamplerRef SamplerCache::get(const Sampler::Builder& builder) {
+    return get(builder.createInfo());
+}
+
+SamplerRef SamplerCache::get(const VkSamplerCreateInfo& createInfo) {
+    if (createInfo.pNext) {
+        throw std::runtime_error("SamplerCache: samplers with a pNext chain are not cached");
+    }
+    Key key = makeKey(createInfo);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = samplers_.find(key);
+    if (it != samplers_.end()) {
+        return it->second;
+    }
+
+    VkSampler vkSampler;
+    if (vkCreateSampler(device_->handle(), &createInfo, nullptr, &vkSampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create sampler");
+    }
+    auto sampler = SamplerRef(new Sampler());
+    sampler->device_ = device_;
+    sampler->sampler_ = vkSampler;
+
+    samplers_.emplace(key, sampler);
+    return sampler;
+}
+
+size_t SamplerCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return samplers_.size();
+}
+
+size_t SamplerCache::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t destroyed = 0;
+    for (auto it = samplers_.begin(); it != samplers_.end();) {
+        if (it->second.use_count() == 1) {
+            it = samplers_.erase(it);
+            destroyed++;
+        } else {
+            ++it;
+        }
+    }
+    return destroyed;
+}
+
 } // namespace finevk
@@ -0,0 +1,192 @@
+#include "finevk/device/submit_batch.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/command.hpp"
+
+#include <stdexcept>
+
+namespace finevk {
+
+SubmitBatch::SubmitBatch(Queue* queue)
+    : queue_(queue) {
+    if (!queue_) {
+        throw std::runtime_error("SubmitBatch requires a queue");
+    }
+}
+
+SubmitBatch& SubmitBatch::next() {
+    Range range{};
+    range.commandBuffers = static_cast<uint32_t>(commandBuffers_.size());
+    range.waits = static_cast<uint32_t>(waits_.size());
+    range.signals = static_cast<uint32_t>(signals_.size());
+    batches_.push_back(range);
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::add(VkCommandBuffer commandBuffer) {
+    if (batches_.empty()) {
+        next();
+    }
+    VkCommandBufferSubmitInfoKHR info{};
+    info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR;
+    info.commandBuffer = commandBuffer;
+    commandBuffers_.push_back(info);
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::add(const CommandBuffer& commandBuffer) {
+    return add(commandBuffer.handle());
+}
+
+SubmitBatch& SubmitBatch::wait(VkSemaphore semaphore, VkPipelineStageFlags2KHR stages) {
+    if (batches_.empty()) {
+        next();
+    }
+    VkSemaphoreSubmitInfoKHR info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR;
+    info.semaphore = semaphore;
+    info.stageMask = stages;
+    waits_.push_back(info);
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::wait(const TimelinePoint& point, VkPipelineStageFlags2KHR stages) {
+    if (point.isComplete() || point.queue->timeline() == VK_NULL_HANDLE) {
+        return *this;
+    }
+    wait(point.queue->timeline(), stages);
+    waits_.back().value = point.value;
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::signal(VkSemaphore semaphore, VkPipelineStageFlags2KHR stages) {
+    if (batches_.empty()) {
+        next();
+    }
+    VkSemaphoreSubmitInfoKHR info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR;
+    info.semaphore = semaphore;
+    info.stageMask = stages;
+    signals_.push_back(info);
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::fence(VkFence fence) {
+    fence_ = fence;
+    return *this;
+}
+
+bool SubmitBatch::empty() const {
+    return commandBuffers_.empty() && waits_.empty() && signals_.empty() && fence_ == VK_NULL_HANDLE;
+}
+
+void SubmitBatch::clear() {
+    batches_.clear();
+    commandBuffers_.clear();
+    waits_.clear();
+    signals_.clear();
+    fence_ = VK_NULL_HANDLE;
+}
+
+uint64_t SubmitBatch::submit() {
+    if (empty()) {
+        clear();
+        return 0;
+    }
+    if (!queue_->supportsSubmit2()) {
+        return submitLegacy();
+    }
+
+    submits2_.clear();
+    for (size_t i = 0; i < batches_.size(); i++) {
+        const Range& begin = batches_[i];
+        Range end{};
+        if (i + 1 < batches_.size()) {
+            end = batches_[i + 1];
+        } else {
+            end.commandBuffers = static_cast<uint32_t>(commandBuffers_.size());
+            end.waits = static_cast<uint32_t>(waits_.size());
+            end.signals = static_cast<uint32_t>(signals_.size());
+        }
+
+        VkSubmitInfo2KHR info{};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR;
+        info.waitSemaphoreInfoCount = end.waits - begin.waits;
+        info.pWaitSemaphoreInfos = waits_.data() + begin.waits;
+        info.commandBufferInfoCount = end.commandBuffers - begin.commandBuffers;
+        info.pCommandBufferInfos = commandBuffers_.data() + begin.commandBuffers;
+        info.signalSemaphoreInfoCount = end.signals - begin.signals;
+        info.pSignalSemaphoreInfos = signals_.data() + begin.signals;
+        submits2_.push_back(info);
+    }
+
+    uint64_t value = queue_->submit2(submits2_.data(), static_cast<uint32_t>(submits2_.size()), fence_);
+    clear();
+    return value;
+}
+
+uint64_t SubmitBatch::submitLegacy() {
+    // Flatten into the original structures; each batch's slices are
+    // contiguous, so the arrays are filled once and then pointed into
+    handles_.clear();
+    for (const auto& info : commandBuffers_) {
+        handles_.push_back(info.commandBuffer);
+    }
+    semaphores_.clear();
+    stages_.clear();
+    values_.clear();
+    for (const auto& info : waits_) {
+        semaphores_.push_back(info.semaphore);
+        stages_.push_back(legacyStageMask(info.stageMask, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT));
+        values_.push_back(info.value);
+    }
+    for (const auto& info : signals_) {
+        semaphores_.push_back(info.semaphore);
+        values_.push_back(info.value);
+    }
+    uint32_t signalBase = static_cast<uint32_t>(waits_.size());
+
+    submits_.clear();
+    timelineInfos_.clear();
+    submits_.reserve(batches_.size());
+    timelineInfos_.reserve(batches_.size());
+    for (size_t i = 0; i < batches_.size(); i++) {
+        const Range& begin = batches_[i];
+        Range end{};
+        if (i + 1 < batches_.size()) {
+            end = batches_[i + 1];
+        } else {
+            end.commandBuffers = static_cast<uint32_t>(commandBuffers_.size());
+            end.waits = static_cast<uint32_t>(waits_.size());
+            end.signals = static_cast<uint32_t>(signals_.size());
+        }
+        uint32_t waitCount = end.waits - begin.waits;
+        uint32_t signalCount = end.signals - begin.signals;
+
+        // Values for binary semaphores are ignored, so every batch can carry one
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount = waitCount;
+        timelineInfo.pWaitSemaphoreValues = values_.data() + begin.waits;
+        timelineInfo.signalSemaphoreValueCount = signalCount;
+        timelineInfo.pSignalSemaphoreValues = values_.data() + signalBase + begin.signals;
+        timelineInfos_.push_back(timelineInfo);
+
+        VkSubmitInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.pNext = queue_->timeline() != VK_NULL_HANDLE ? &timelineInfos_.back() : nullptr;
+        info.waitSemaphoreCount = waitCount;
+        info.pWaitSemaphores = semaphores_.data() + begin.waits;
+        info.pWaitDstStageMask = stages_.data() + begin.waits;
+        info.commandBufferCount = end.commandBuffers - begin.commandBuffers;
+        info.pCommandBuffers = handles_.data() + begin.commandBuffers;
+        info.signalSemaphoreCount = signalCount;
+        info.pSignalSemaphores = semaphores_.data() + signalBase + begin.signals;
+        submits_.push_back(info);
+    }
+
+    uint64_t value = queue_->submit(submits_.data(), static_cast<uint32_t>(submits_.size()), fence_);
+    clear();
+    return value;
+}
+
+} // namespace finevk
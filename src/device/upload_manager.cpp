@@ -0,0 +1,369 @@
+#include "finevk/device/upload_manager.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/rendering/sync.hpp"
+#include "finevk/core/logging.hpp"
+#include "finevk/core/profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+// Covers texel block sizes of all common formats and the 4-byte copy rule
+constexpr VkDeviceSize StagingAlignment = 16;
+
+// Stages and accesses that consume uploaded data on the graphics queue
+constexpr VkPipelineStageFlags ConsumerStages =
+    VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+constexpr VkAccessFlags BufferConsumerAccess =
+    VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+    VK_ACCESS_INDEX_READ_BIT |
+    VK_ACCESS_UNIFORM_READ_BIT |
+    VK_ACCESS_SHADER_READ_BIT;
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+VkImageSubresourceRange subresourceRange(const VkImageSubresourceLayers& layers) {
+    VkImageSubresourceRange range{};
+    range.aspectMask = layers.aspectMask;
+    range.baseMipLevel = layers.mipLevel;
+    range.levelCount = 1;
+    range.baseArrayLayer = layers.baseArrayLayer;
+    range.layerCount = layers.layerCount;
+    return range;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// UploadManager::Builder implementation
+// ============================================================================
+
+UploadManager::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+UploadManager::Builder& UploadManager::Builder::ringSize(VkDeviceSize bytes) {
+    ringSize_ = bytes;
+    return *this;
+}
+
+UploadManager::Builder& UploadManager::Builder::useGraphicsQueue(bool enable) {
+    useGraphicsQueue_ = enable;
+    return *this;
+}
+
+UploadManagerPtr UploadManager::Builder::build() {
+    if (ringSize_ < StagingAlignment * 2) {
+        throw std::runtime_error("UploadManager ring size is too small");
+    }
+
+    Queue* graphicsQueue = device_->graphicsQueue();
+    Queue* transferQueue = useGraphicsQueue_ ? nullptr : device_->transferQueue();
+
+    auto manager = UploadManagerPtr(new UploadManager());
+    manager->device_ = device_;
+    manager->ownershipTransfer_ = transferQueue != nullptr &&
+        transferQueue->familyIndex() != graphicsQueue->familyIndex();
+
+    Queue* copyQueue = manager->ownershipTransfer_ ? transferQueue : graphicsQueue;
+    manager->transferPool_ = std::make_unique<CommandPool>(
+        device_, copyQueue, CommandPoolFlags::Transient);
+    if (manager->ownershipTransfer_) {
+        manager->graphicsPool_ = std::make_unique<CommandPool>(
+            device_, graphicsQueue, CommandPoolFlags::Transient);
+    }
+
+    manager->ring_ = Buffer::create(device_)
+        .size(ringSize_)
+        .usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+        .memoryUsage(MemoryUsage::CpuToGpu)
+        .build();
+    manager->ringSize_ = ringSize_;
+
+    FINEVK_DEBUG(LogCategory::Core,
+        "UploadManager created: " + std::to_string(ringSize_) + " byte ring, " +
+        (manager->ownershipTransfer_ ? "dedicated transfer queue" : "graphics queue"));
+
+    return manager;
+}
+
+// ============================================================================
+// UploadManager implementation
+// ============================================================================
+
+UploadManager::Builder UploadManager::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+UploadManager::~UploadManager() {
+    if (device_ != nullptr) {
+        waitIdle();
+    }
+}
+
+void UploadManager::uploadBuffer(Buffer& dst, const void* data, VkDeviceSize size,
+                                 VkDeviceSize dstOffset) {
+    if (size == 0) {
+        return;
+    }
+
+    VkDeviceSize srcOffset = 0;
+    VkBuffer src = stage(data, size, srcOffset);
+
+    BufferCopy copy{};
+    copy.src = src;
+    copy.dst = dst.handle();
+    copy.region.srcOffset = srcOffset;
+    copy.region.dstOffset = dstOffset;
+    copy.region.size = size;
+    pendingBuffers_.push_back(copy);
+}
+
+void UploadManager::uploadImage(Image& dst, const void* data, VkDeviceSize size,
+                                uint32_t mipLevel, uint32_t arrayLayer,
+                                VkImageLayout finalLayout) {
+    if (size == 0) {
+        return;
+    }
+
+    VkDeviceSize srcOffset = 0;
+    VkBuffer src = stage(data, size, srcOffset);
+
+    VkExtent3D extent = dst.extent();
+
+    ImageCopy copy{};
+    copy.src = src;
+    copy.dst = dst.handle();
+    copy.finalLayout = finalLayout;
+    copy.region.bufferOffset = srcOffset;
+    copy.region.bufferRowLength = 0;
+    copy.region.bufferImageHeight = 0;
+    copy.region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.region.imageSubresource.mipLevel = mipLevel;
+    copy.region.imageSubresource.baseArrayLayer = arrayLayer;
+    copy.region.imageSubresource.layerCount = 1;
+    copy.region.imageOffset = {0, 0, 0};
+    copy.region.imageExtent = {
+        std::max(1u, extent.width >> mipLevel),
+        std::max(1u, extent.height >> mipLevel),
+        std::max(1u, extent.depth >> mipLevel)
+    };
+    pendingImages_.push_back(copy);
+}
+
+VkBuffer UploadManager::stage(const void* data, VkDeviceSize size, VkDeviceSize& outOffset) {
+    FINEVK_PROFILE_SCOPE("UploadManager::stage");
+    pendingBytes_ += size;
+
+    // Oversized uploads would stall the ring; give them their own staging buffer
+    if (size > ringSize_ / 2) {
+        auto staging = Buffer::createStagingBuffer(device_, size);
+        std::memcpy(staging->mappedPtr(), data, size);
+        VkBuffer handle = staging->handle();
+        pendingStaging_.push_back(std::move(staging));
+        outOffset = 0;
+        return handle;
+    }
+
+    outOffset = reserve(size);
+    std::memcpy(static_cast<char*>(ring_->mappedPtr()) + outOffset, data, size);
+    return ring_->handle();
+}
+
+VkDeviceSize UploadManager::reserve(VkDeviceSize size) {
+    while (true) {
+        collect();
+
+        // The ring is [tail_, head_) in use; head_ == tail_ only when empty
+        VkDeviceSize start = alignUp(head_, StagingAlignment);
+        if (head_ >= tail_) {
+            if (start + size <= ringSize_) {
+                head_ = start + size;
+                return start;
+            }
+            if (size < tail_) {
+                head_ = size;
+                return 0;
+            }
+        } else if (start + size < tail_) {
+            head_ = start + size;
+            return start;
+        }
+
+        // Ring full: push queued copies out, then wait for the oldest batch
+        if (!pendingBuffers_.empty() || !pendingImages_.empty()) {
+            flush();
+        } else if (!inFlight_.empty()) {
+            FINEVK_PROFILE_SCOPE("UploadManager::waitRing");
+            inFlight_.front().ticket.wait();
+        } else {
+            throw std::runtime_error("UploadManager ring exhausted");
+        }
+    }
+}
+
+SubmitTicket UploadManager::flush() {
+    if (pendingBuffers_.empty() && pendingImages_.empty()) {
+        return SubmitTicket();
+    }
+    FINEVK_PROFILE_SCOPE("UploadManager::flush");
+
+    // Make this batch's ring writes visible (no-op in coherent memory)
+    if (head_ >= dirtyStart_) {
+        ring_->flush(dirtyStart_, head_ - dirtyStart_);
+    } else {
+        ring_->flush(dirtyStart_, ringSize_ - dirtyStart_);
+        ring_->flush(0, head_);
+    }
+    dirtyStart_ = head_;
+
+    uint32_t srcFamily = VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dstFamily = VK_QUEUE_FAMILY_IGNORED;
+    if (ownershipTransfer_) {
+        srcFamily = transferPool_->queue()->familyIndex();
+        dstFamily = graphicsPool_->queue()->familyIndex();
+    }
+
+    auto imm = transferPool_->beginImmediate();
+    CommandBuffer& cmd = imm.cmd();
+
+    // Prepare destination subresources for transfer writes
+    std::vector<VkImageMemoryBarrier> toTransfer;
+    toTransfer.reserve(pendingImages_.size());
+    for (const auto& copy : pendingImages_) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = copy.dst;
+        barrier.subresourceRange = subresourceRange(copy.region.imageSubresource);
+        toTransfer.push_back(barrier);
+    }
+    if (!toTransfer.empty()) {
+        cmd.pipelineBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            0, {}, {}, toTransfer);
+    }
+
+    for (const auto& copy : pendingBuffers_) {
+        vkCmdCopyBuffer(cmd.handle(), copy.src, copy.dst, 1, &copy.region);
+    }
+    for (const auto& copy : pendingImages_) {
+        vkCmdCopyBufferToImage(cmd.handle(), copy.src, copy.dst,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+    }
+
+    // Release (or, on a single queue, make visible) the written ranges.
+    // With an ownership transfer the same barriers are repeated as acquires.
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    bufferBarriers.reserve(pendingBuffers_.size());
+    for (const auto& copy : pendingBuffers_) {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = ownershipTransfer_ ? 0 : BufferConsumerAccess;
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        barrier.buffer = copy.dst;
+        barrier.offset = copy.region.dstOffset;
+        barrier.size = copy.region.size;
+        bufferBarriers.push_back(barrier);
+    }
+
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    imageBarriers.reserve(pendingImages_.size());
+    for (const auto& copy : pendingImages_) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = ownershipTransfer_ ? 0 : VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = copy.finalLayout;
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        barrier.image = copy.dst;
+        barrier.subresourceRange = subresourceRange(copy.region.imageSubresource);
+        imageBarriers.push_back(barrier);
+    }
+
+    SubmitTicket ticket;
+    if (ownershipTransfer_) {
+        cmd.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            0, {}, bufferBarriers, imageBarriers);
+
+        auto handoff = std::make_unique<Semaphore>(device_);
+        SubmitTicket transferTicket = imm.submitAsync({}, {}, {handoff->handle()});
+
+        for (auto& barrier : bufferBarriers) {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = BufferConsumerAccess;
+        }
+        for (auto& barrier : imageBarriers) {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        }
+
+        auto acquire = graphicsPool_->beginImmediate();
+        acquire.cmd().pipelineBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, ConsumerStages,
+                                      0, {}, bufferBarriers, imageBarriers);
+        ticket = acquire.submitAsync({handoff->handle()},
+                                     {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT}, {});
+
+        // The acquire waits on the transfer, so both retire together
+        ticket.keepAlive(transferTicket);
+        ticket.keepAlive(std::move(handoff));
+    } else {
+        cmd.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, ConsumerStages,
+                            0, {}, bufferBarriers, imageBarriers);
+        ticket = imm.submitAsync();
+    }
+
+    for (auto& staging : pendingStaging_) {
+        ticket.keepAlive(std::move(staging));
+    }
+    pendingStaging_.clear();
+    pendingBuffers_.clear();
+    pendingImages_.clear();
+    pendingBytes_ = 0;
+
+    inFlight_.push_back({ticket, head_});
+    return ticket;
+}
+
+void UploadManager::collect() {
+    while (!inFlight_.empty() && inFlight_.front().ticket.isComplete()) {
+        tail_ = inFlight_.front().ringEnd;
+        inFlight_.pop_front();
+    }
+
+    // Nothing in use: rewind so large uploads get a contiguous ring
+    if (inFlight_.empty() && pendingBuffers_.empty() && pendingImages_.empty()) {
+        head_ = 0;
+        tail_ = 0;
+    }
+}
+
+void UploadManager::waitIdle() {
+    flush();
+    for (auto& batch : inFlight_) {
+        batch.ticket.wait();
+    }
+    collect();
+}
+
+} // namespace finevk
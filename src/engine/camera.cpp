@@ -2,8 +2,95 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/norm.hpp>
 
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FINEVK_CAMERA_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FINEVK_CAMERA_NEON 1
+#endif
+
 namespace finevk {
 
+namespace {
+
+/// Six normalized planes (24 floats) from a column-major view-projection matrix
+void extractPlanes(const float* m, float* out) {
+#if defined(FINEVK_CAMERA_SSE)
+    // Structure of arrays: lane i of a column's vector holds plane i's
+    // coefficient; planes are row 3 +/- rows 0, 1 (first batch) and 2
+    const __m128 signs = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+    __m128 sides[4];
+    __m128 depths[4];
+    for (int c = 0; c < 4; c++) {
+        __m128 column = _mm_loadu_ps(m + 4 * c);
+        __m128 w = _mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3));
+        __m128 xxyy = _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 0, 0));
+        __m128 zzzz = _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2));
+        sides[c] = _mm_add_ps(w, _mm_mul_ps(xxyy, signs));
+        depths[c] = _mm_add_ps(w, _mm_mul_ps(zzzz, signs));
+    }
+    for (__m128* p : {sides, depths}) {
+        __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], p[0]), _mm_mul_ps(p[1], p[1])),
+                                     _mm_mul_ps(p[2], p[2]));
+        __m128 length = _mm_sqrt_ps(lengthSq);
+        for (int c = 0; c < 4; c++) {
+            p[c] = _mm_div_ps(p[c], length);
+        }
+        _MM_TRANSPOSE4_PS(p[0], p[1], p[2], p[3]);  // Back to one plane per vector
+    }
+    for (int i = 0; i < 4; i++) {
+        _mm_storeu_ps(out + 4 * i, sides[i]);
+    }
+    _mm_storeu_ps(out + 16, depths[0]);
+    _mm_storeu_ps(out + 20, depths[1]);
+#elif defined(FINEVK_CAMERA_NEON)
+    const float signValues[4] = {1.0f, -1.0f, 1.0f, -1.0f};
+    const float32x4_t signs = vld1q_f32(signValues);
+    float32x4x4_t sides;
+    float32x4x4_t depths;
+    for (int c = 0; c < 4; c++) {
+        float32x4_t column = vld1q_f32(m + 4 * c);
+        float32x4_t w = vdupq_laneq_f32(column, 3);
+        sides.val[c] = vfmaq_f32(w, vzip1q_f32(column, column), signs);
+        depths.val[c] = vfmaq_f32(w, vdupq_laneq_f32(column, 2), signs);
+    }
+    for (float32x4x4_t* p : {&sides, &depths}) {
+        float32x4_t lengthSq = vaddq_f32(vaddq_f32(vmulq_f32(p->val[0], p->val[0]),
+                                                   vmulq_f32(p->val[1], p->val[1])),
+                                         vmulq_f32(p->val[2], p->val[2]));
+        float32x4_t length = vsqrtq_f32(lengthSq);
+        for (int c = 0; c < 4; c++) {
+            p->val[c] = vdivq_f32(p->val[c], length);
+        }
+    }
+    vst4q_f32(out, sides);  // Interleaves back to one plane per 4 floats
+    float tail[16];
+    vst4q_f32(tail, depths);
+    std::memcpy(out + 16, tail, 8 * sizeof(float));
+#else
+    // Left, right, bottom, top, near, far: row 3 +/- rows 0, 1, 2
+    for (int i = 0; i < 6; i++) {
+        int row = i / 2;
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        float* plane = out + 4 * i;
+        for (int c = 0; c < 4; c++) {
+            plane[c] = m[4 * c + 3] + sign * m[4 * c + row];
+        }
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        for (int c = 0; c < 4; c++) {
+            plane[c] /= length;
+        }
+    }
+#endif
+}
+
+} // namespace
+
 // =============================================================================
 // AABB Implementation
 // =============================================================================
@@ -61,6 +148,15 @@ AABB AABB::fromMinMax(const glm::vec3& min, const glm::vec3& max) {
     return AABB{min, max};
 }
 
+// =============================================================================
+// Frustum Planes
+// =============================================================================
+
+void extractFrustumPlanes(const glm::mat4& viewProjection, std::array<glm::vec4, 6>& planes) {
+    static_assert(sizeof(glm::vec4) == 4 * sizeof(float), "planes are stored as packed floats");
+    extractPlanes(&viewProjection[0][0], &planes[0][0]);
+}
+
 // =============================================================================
 // Camera Implementation
 // =============================================================================
@@ -74,25 +170,27 @@ Camera::Camera() {
 // =============================================================================
 
 void Camera::setPerspective(float fovDegrees, float aspect, float nearPlane, float farPlane) {
+    if (hasProjection_ && isPerspective_ && fov_ == fovDegrees && aspect_ == aspect &&
+        nearPlane_ == nearPlane && farPlane_ == farPlane) {
+        return;  // Resize handlers often repeat the same projection
+    }
+    hasProjection_ = true;
     isPerspective_ = true;
     fov_ = fovDegrees;
     aspect_ = aspect;
     nearPlane_ = nearPlane;
     farPlane_ = farPlane;
-
-    state_.projection = glm::perspective(
-        glm::radians(fovDegrees),
-        aspect,
-        nearPlane,
-        farPlane
-    );
-
-    // Vulkan NDC: Y is flipped compared to OpenGL
-    state_.projection[1][1] *= -1;
+    projectionDirty_ = true;
 }
 
 void Camera::setOrthographic(float left, float right, float bottom, float top,
                             float nearPlane, float farPlane) {
+    if (hasProjection_ && !isPerspective_ && orthoLeft_ == left && orthoRight_ == right &&
+        orthoBottom_ == bottom && orthoTop_ == top &&
+        nearPlane_ == nearPlane && farPlane_ == farPlane) {
+        return;
+    }
+    hasProjection_ = true;
     isPerspective_ = false;
     orthoLeft_ = left;
     orthoRight_ = right;
@@ -100,11 +198,27 @@ void Camera::setOrthographic(float left, float right, float bottom, float top,
     orthoTop_ = top;
     nearPlane_ = nearPlane;
     farPlane_ = farPlane;
+    projectionDirty_ = true;
+}
 
-    state_.projection = glm::ortho(left, right, bottom, top, nearPlane, farPlane);
-
-    // Vulkan depth range is [0, 1]
-    state_.projection[2][2] *= -1;
+void Camera::updateProjection() {
+    if (isPerspective_) {
+        state_.projection = glm::perspective(
+            glm::radians(fov_),
+            aspect_,
+            nearPlane_,
+            farPlane_
+        );
+
+        // Vulkan NDC: Y is flipped compared to OpenGL
+        state_.projection[1][1] *= -1;
+    } else {
+        state_.projection = glm::ortho(orthoLeft_, orthoRight_, orthoBottom_, orthoTop_,
+                                       nearPlane_, farPlane_);
+
+        // Vulkan depth range is [0, 1]
+        state_.projection[2][2] *= -1;
+    }
 }
 
 // =============================================================================
@@ -112,23 +226,31 @@ void Camera::setOrthographic(float left, float right, float bottom, float top,
 // =============================================================================
 
 void Camera::move(const glm::vec3& delta) {
+    if (delta == glm::vec3(0.0f)) {
+        return;
+    }
     position_ += delta;
+    viewDirty_ = true;
 }
 
 void Camera::moveTo(const glm::vec3& position) {
+    if (position == position_) {
+        return;
+    }
     position_ = position;
+    viewDirty_ = true;
 }
 
 void Camera::moveForward(float distance) {
-    position_ += forward_ * distance;
+    move(forward_ * distance);
 }
 
 void Camera::moveRight(float distance) {
-    position_ += glm::cross(forward_, up_) * distance;
+    move(glm::cross(forward_, up_) * distance);
 }
 
 void Camera::moveUp(float distance) {
-    position_ += up_ * distance;
+    move(up_ * distance);
 }
 
 // =============================================================================
@@ -136,6 +258,10 @@ void Camera::moveUp(float distance) {
 // =============================================================================
 
 void Camera::rotate(float pitch, float yaw, float roll) {
+    if (pitch == 0.0f && yaw == 0.0f && roll == 0.0f) {
+        return;
+    }
+
     // Build rotation quaternion
     glm::quat qPitch = glm::angleAxis(glm::radians(pitch), right());
     glm::quat qYaw = glm::angleAxis(glm::radians(yaw), up_);
@@ -146,6 +272,7 @@ void Camera::rotate(float pitch, float yaw, float roll) {
     // Apply to forward and up vectors
     forward_ = glm::normalize(rotation * forward_);
     up_ = glm::normalize(rotation * up_);
+    viewDirty_ = true;
 }
 
 void Camera::rotatePitch(float degrees) {
@@ -166,6 +293,7 @@ void Camera::lookAt(const glm::vec3& target, const glm::vec3& worldUp) {
     // Recompute right and up vectors
     glm::vec3 right = glm::normalize(glm::cross(forward_, worldUp));
     up_ = glm::normalize(glm::cross(right, forward_));
+    viewDirty_ = true;
 }
 
 void Camera::setOrientation(const glm::vec3& forward, const glm::vec3& up) {
@@ -175,86 +303,34 @@ void Camera::setOrientation(const glm::vec3& forward, const glm::vec3& up) {
     // Ensure orthogonality
     glm::vec3 right = glm::cross(forward_, up_);
     up_ = glm::cross(right, forward_);
+    viewDirty_ = true;
 }
 
 // =============================================================================
 // State Update
 // =============================================================================
 
-void Camera::updateState() {
-    // Update position
-    state_.position = position_;
+bool Camera::updateState() {
+    if (!viewDirty_ && !projectionDirty_) {
+        return false;
+    }
 
-    // Compute view matrix
-    state_.view = glm::lookAt(position_, position_ + forward_, up_);
+    if (projectionDirty_) {
+        updateProjection();
+    }
+    if (viewDirty_) {
+        state_.position = position_;
+        state_.view = glm::lookAt(position_, position_ + forward_, up_);
+    }
 
-    // Compute view-projection matrix
+    // Both depend on view and projection
     state_.viewProjection = state_.projection * state_.view;
+    extractFrustumPlanes(state_.viewProjection, state_.frustumPlanes);
 
-    // Extract frustum planes
-    extractFrustumPlanes();
-}
-
-void Camera::extractFrustumPlanes() {
-    // Extract frustum planes from view-projection matrix
-    // Planes are in format: Ax + By + Cz + D = 0
-    // where (A, B, C) is the plane normal
-
-    const glm::mat4& m = state_.viewProjection;
-
-    // Left plane
-    state_.frustumPlanes[0] = glm::vec4(
-        m[0][3] + m[0][0],
-        m[1][3] + m[1][0],
-        m[2][3] + m[2][0],
-        m[3][3] + m[3][0]
-    );
-
-    // Right plane
-    state_.frustumPlanes[1] = glm::vec4(
-        m[0][3] - m[0][0],
-        m[1][3] - m[1][0],
-        m[2][3] - m[2][0],
-        m[3][3] - m[3][0]
-    );
-
-    // Bottom plane
-    state_.frustumPlanes[2] = glm::vec4(
-        m[0][3] + m[0][1],
-        m[1][3] + m[1][1],
-        m[2][3] + m[2][1],
-        m[3][3] + m[3][1]
-    );
-
-    // Top plane
-    state_.frustumPlanes[3] = glm::vec4(
-        m[0][3] - m[0][1],
-        m[1][3] - m[1][1],
-        m[2][3] - m[2][1],
-        m[3][3] - m[3][1]
-    );
-
-    // Near plane
-    state_.frustumPlanes[4] = glm::vec4(
-        m[0][3] + m[0][2],
-        m[1][3] + m[1][2],
-        m[2][3] + m[2][2],
-        m[3][3] + m[3][2]
-    );
-
-    // Far plane
-    state_.frustumPlanes[5] = glm::vec4(
-        m[0][3] - m[0][2],
-        m[1][3] - m[1][2],
-        m[2][3] - m[2][2],
-        m[3][3] - m[3][2]
-    );
-
-    // Normalize planes
-    for (auto& plane : state_.frustumPlanes) {
-        float length = glm::length(glm::vec3(plane));
-        plane /= length;
-    }
+    viewDirty_ = false;
+    projectionDirty_ = false;
+    state_.version++;
+    return true;
 }
 
 } // namespace finevk
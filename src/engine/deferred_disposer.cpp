@@ -1,5 +1,6 @@
 #include "finevk/engine/deferred_disposer.hpp"
 #include "finevk/core/logging.hpp"
+#include "finevk/core/profiler.hpp"
 
 namespace finevk {
 
@@ -8,99 +9,294 @@ DeferredDisposer& DeferredDisposer::global() {
     return instance;
 }
 
-void DeferredDisposer::dispose(std::function<void()> deleter, uint32_t frameDelay) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    pending_.push_back({std::move(deleter), frameDelay});
+DeferredDisposer::~DeferredDisposer() {
+    // Like dropping a container of deleters: captures are released, nothing runs
+    drainIncoming();
+    auto release = [](Node* list) {
+        while (list) {
+            Node* next = list->link;
+            delete list;
+            list = next;
+        }
+    };
+    for (Node* bucket : buckets_) {
+        release(bucket);
+    }
+    release(ready_);
+    release(conditional_);
+    release(untagged_);
+    release(timelineHead_);
 }
 
-void DeferredDisposer::processFrame() {
-    std::lock_guard<std::mutex> lock(mutex_);
+// ============================================================================
+// Incoming queue (wait-free producers, single consumer under processMutex_)
+// ============================================================================
+
+void DeferredDisposer::enqueue(Node* node, uint32_t frameDelay) {
+    node->readyFrame = frame_.load(std::memory_order_acquire) + frameDelay;
+    node->next.store(nullptr, std::memory_order_relaxed);
+    pendingCount_.fetch_add(1, std::memory_order_relaxed);
 
-    // Decrement frame counters
-    for (auto& disposal : pending_) {
-        if (disposal.framesRemaining > 0) {
-            disposal.framesRemaining--;
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+DeferredDisposer::Node* DeferredDisposer::popIncoming() const {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+        if (!next) {
+            return nullptr;
         }
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        tail_ = next;
+        return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+        return nullptr;  // A producer is between exchange and link; next drain gets it
     }
+
+    // tail is the last node: park the stub behind it so tail can be handed out
+    stub_.next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head_.exchange(&stub_, std::memory_order_acq_rel);
+    previous->next.store(&stub_, std::memory_order_release);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        tail_ = next;
+        return tail;
+    }
+    return nullptr;
 }
 
-bool DeferredDisposer::tryDisposeOne() {
-    std::function<void()> deleter;
+void DeferredDisposer::drainIncoming() const {
+    while (Node* node = popIncoming()) {
+        place(node);
+    }
+}
 
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        // Find first ready disposal (framesRemaining == 0)
-        for (size_t i = 0; i < pending_.size(); ++i) {
-            if (pending_[i].framesRemaining == 0) {
-                // Move deleter out before erasing
-                deleter = std::move(pending_[i].deleter);
-
-                // Remove from pending list (swap with last for O(1) removal)
-                if (i != pending_.size() - 1) {
-                    pending_[i] = std::move(pending_.back());
-                }
-                pending_.pop_back();
-                break;
+void DeferredDisposer::place(Node* node) const {
+    if (node->retire) {
+        if (retireQueue_) {
+            node->link = untagged_;
+            untagged_ = node;
+            return;
+        }
+        node->retire = false;
+        node->readyFrame = frame_.load(std::memory_order_relaxed) + defaultDelay_.load(std::memory_order_relaxed);
+    }
+
+    if (node->readyFrame > frame_.load(std::memory_order_relaxed)) {
+        Node*& bucket = buckets_[node->readyFrame & (kBucketCount - 1)];
+        node->link = bucket;
+        bucket = node;
+    } else if (node->isReady) {
+        node->link = conditional_;
+        conditional_ = node;
+    } else {
+        node->link = ready_;
+        ready_ = node;
+    }
+}
+
+// ============================================================================
+// Timeline retirement
+// ============================================================================
+
+void DeferredDisposer::retireOn(const Queue* queue) {
+    if (queue && queue->timeline() == VK_NULL_HANDLE) {
+        queue = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(processMutex_);
+    drainIncoming();
+    if (queue == retireQueue_) {
+        return;
+    }
+    releaseTimeline();
+    retireQueue_ = queue;
+}
+
+void DeferredDisposer::tagUntagged() {
+    if (!untagged_) {
+        return;
+    }
+
+    // Everything queued so far may be referenced by work submitted up to now.
+    // Values only grow, so appending keeps the list ordered.
+    uint64_t value = retireQueue_->lastSubmitted();
+    while (Node* node = untagged_) {
+        untagged_ = node->link;
+        node->link = nullptr;
+        node->retireValue = value;
+        if (value == 0) {
+            node->retire = false;  // Nothing was ever submitted
+            node->link = ready_;
+            ready_ = node;
+        } else if (timelineTail_) {
+            timelineTail_->link = node;
+            timelineTail_ = node;
+        } else {
+            timelineHead_ = timelineTail_ = node;
+        }
+    }
+}
+
+void DeferredDisposer::releaseTimeline() const {
+    // Without the old queue's timeline, fall back to counting frames
+    auto toFrames = [this](Node*& list) {
+        while (Node* node = list) {
+            list = node->link;
+            node->retire = false;
+            node->readyFrame = frame_.load(std::memory_order_relaxed) + defaultDelay_.load(std::memory_order_relaxed);
+            place(node);
+        }
+    };
+    toFrames(untagged_);
+    toFrames(timelineHead_);
+    timelineTail_ = nullptr;
+}
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+void DeferredDisposer::processFrame() {
+    FINEVK_PROFILE_SCOPE("DeferredDisposer::processFrame");
+    std::lock_guard<std::mutex> lock(processMutex_);
+    drainIncoming();
+    if (retireQueue_) {
+        tagUntagged();
+    }
+
+    uint64_t frame = frame_.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    // Nodes more than kBucketCount frames out stay for a later lap
+    Node* node = buckets_[frame & (kBucketCount - 1)];
+    buckets_[frame & (kBucketCount - 1)] = nullptr;
+    while (node) {
+        Node* next = node->link;
+        place(node);
+        node = next;
+    }
+}
+
+DeferredDisposer::Node* DeferredDisposer::takeReady() const {
+    if (Node* node = ready_) {
+        ready_ = node->link;
+        return node;
+    }
+
+    if (Node* node = timelineHead_) {
+        if (retireQueue_->isComplete(node->retireValue)) {
+            timelineHead_ = node->link;
+            if (!timelineHead_) {
+                timelineTail_ = nullptr;
             }
+            return node;
         }
     }
 
-    // Call deleter outside the lock to avoid holding mutex during destruction
-    if (deleter) {
-        try {
-            deleter();
-        } catch (const std::exception& e) {
-            FINEVK_ERROR(LogCategory::Core,
-                "Exception during deferred disposal: " + std::string(e.what()));
+    // Conditions (GPU fences) are only polled once nothing unconditional is left
+    for (Node** link = &conditional_; *link; link = &(*link)->link) {
+        Node* node = *link;
+        if (node->isReady()) {
+            *link = node->link;
+            return node;
         }
-        return true;
+    }
+    return nullptr;
+}
+
+void DeferredDisposer::run(Node* node, const char* what) {
+    try {
+        node->deleter();
+    } catch (const std::exception& e) {
+        FINEVK_ERROR(LogCategory::Core,
+            std::string("Exception during ") + what + ": " + e.what());
+    }
+    delete node;
+    pendingCount_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool DeferredDisposer::tryDisposeOne() {
+    Node* node;
+    {
+        std::lock_guard<std::mutex> lock(processMutex_);
+        drainIncoming();
+        node = takeReady();
     }
 
-    return false;
+    // Call deleter outside the lock to avoid holding mutex during destruction
+    if (!node) {
+        return false;
+    }
+    run(node, "deferred disposal");
+    return true;
 }
 
 void DeferredDisposer::disposeReady() {
+    FINEVK_PROFILE_SCOPE("DeferredDisposer::disposeReady");
     while (tryDisposeOne()) {
         // Keep disposing until none ready
     }
 }
 
 void DeferredDisposer::disposeAll() {
-    std::vector<PendingDisposal> toDispose;
+    FINEVK_PROFILE_SCOPE("DeferredDisposer::disposeAll");
+    Node* toDispose = nullptr;
 
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        toDispose = std::move(pending_);
-        pending_.clear();
+        std::lock_guard<std::mutex> lock(processMutex_);
+        drainIncoming();
+        auto take = [&toDispose](Node*& list) {
+            while (Node* node = list) {
+                list = node->link;
+                node->link = toDispose;
+                toDispose = node;
+            }
+        };
+        for (Node*& bucket : buckets_) {
+            take(bucket);
+        }
+        take(ready_);
+        take(conditional_);
+        take(untagged_);
+        take(timelineHead_);
+        timelineTail_ = nullptr;
     }
 
     // Dispose all outside the lock
-    for (auto& disposal : toDispose) {
-        try {
-            disposal.deleter();
-        } catch (const std::exception& e) {
-            FINEVK_ERROR(LogCategory::Core,
-                "Exception during forced disposal: " + std::string(e.what()));
-        }
+    size_t count = 0;
+    while (toDispose) {
+        Node* next = toDispose->link;
+        run(toDispose, "forced disposal");
+        toDispose = next;
+        count++;
     }
 
-    if (!toDispose.empty()) {
+    if (count > 0) {
         FINEVK_DEBUG(LogCategory::Core,
-            "Forced disposal of " + std::to_string(toDispose.size()) + " resources");
+            "Forced disposal of " + std::to_string(count) + " resources");
     }
 }
 
-size_t DeferredDisposer::pendingCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return pending_.size();
-}
-
 size_t DeferredDisposer::readyCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(processMutex_);
+    drainIncoming();
     size_t count = 0;
-    for (const auto& disposal : pending_) {
-        if (disposal.framesRemaining == 0) {
+    for (Node* node = ready_; node; node = node->link) {
+        count++;
+    }
+    for (Node* node = timelineHead_; node && retireQueue_->isComplete(node->retireValue);
+         node = node->link) {
+        count++;
+    }
+    for (Node* node = conditional_; node; node = node->link) {
+        if (node->isReady()) {
             count++;
         }
     }
@@ -48,4 +48,19 @@ void FrameClock::sleep(float seconds) {
     }
 }
 
+void FrameClock::sleepPrecise(float seconds, float spinSeconds) {
+    if (seconds <= 0.0f) {
+        return;
+    }
+    auto deadline = Clock::now() +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(seconds));
+
+    if (seconds > spinSeconds) {
+        std::this_thread::sleep_for(std::chrono::duration<float>(seconds - spinSeconds));
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
 } // namespace finevk
@@ -0,0 +1,241 @@
+#include "finevk/engine/frustum_cull.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FINEVK_CULL_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FINEVK_CULL_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FINEVK_CULL_NEON 1
+#endif
+
+namespace finevk {
+
+namespace {
+
+constexpr size_t PadTo = 8;
+
+/// Per-plane constants: which array (min or max) holds the positive vertex
+struct PlaneSelect {
+    float nx, ny, nz, d;
+    bool useMaxX, useMaxY, useMaxZ;
+};
+
+struct Arrays {
+    const float* minX;
+    const float* minY;
+    const float* minZ;
+    const float* maxX;
+    const float* maxY;
+    const float* maxZ;
+};
+
+/// Visibility bits for boxes [i, i + width); bit k set = box i + k visible
+inline uint32_t testScalar(const Arrays& a, const PlaneSelect* planes, size_t i, size_t width) {
+    uint32_t bits = 0;
+    for (size_t k = 0; k < width; k++) {
+        size_t b = i + k;
+        bool visible = true;
+        for (int p = 0; p < 6 && visible; p++) {
+            const PlaneSelect& pl = planes[p];
+            float x = pl.useMaxX ? a.maxX[b] : a.minX[b];
+            float y = pl.useMaxY ? a.maxY[b] : a.minY[b];
+            float z = pl.useMaxZ ? a.maxZ[b] : a.minZ[b];
+            visible = pl.nx * x + pl.ny * y + pl.nz * z + pl.d >= 0.0f;
+        }
+        bits |= static_cast<uint32_t>(visible) << k;
+    }
+    return bits;
+}
+
+#if defined(FINEVK_CULL_AVX)
+constexpr size_t Width = 8;
+
+inline uint32_t testBlock(const Arrays& a, const PlaneSelect* planes, size_t i) {
+    __m256 outside = _mm256_setzero_ps();
+    for (int p = 0; p < 6; p++) {
+        const PlaneSelect& pl = planes[p];
+        __m256 x = _mm256_loadu_ps((pl.useMaxX ? a.maxX : a.minX) + i);
+        __m256 y = _mm256_loadu_ps((pl.useMaxY ? a.maxY : a.minY) + i);
+        __m256 z = _mm256_loadu_ps((pl.useMaxZ ? a.maxZ : a.minZ) + i);
+        __m256 dist = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(pl.nx)),
+                          _mm256_mul_ps(y, _mm256_set1_ps(pl.ny))),
+            _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(pl.nz)),
+                          _mm256_set1_ps(pl.d)));
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, _mm256_setzero_ps(), _CMP_LT_OQ));
+    }
+    return ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFFu;
+}
+#elif defined(FINEVK_CULL_SSE)
+constexpr size_t Width = 4;
+
+inline uint32_t testBlock(const Arrays& a, const PlaneSelect* planes, size_t i) {
+    __m128 outside = _mm_setzero_ps();
+    for (int p = 0; p < 6; p++) {
+        const PlaneSelect& pl = planes[p];
+        __m128 x = _mm_loadu_ps((pl.useMaxX ? a.maxX : a.minX) + i);
+        __m128 y = _mm_loadu_ps((pl.useMaxY ? a.maxY : a.minY) + i);
+        __m128 z = _mm_loadu_ps((pl.useMaxZ ? a.maxZ : a.minZ) + i);
+        __m128 dist = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(pl.nx)), _mm_mul_ps(y, _mm_set1_ps(pl.ny))),
+            _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(pl.nz)), _mm_set1_ps(pl.d)));
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_setzero_ps()));
+    }
+    return ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xFu;
+}
+#elif defined(FINEVK_CULL_NEON)
+constexpr size_t Width = 4;
+
+inline uint32_t testBlock(const Arrays& a, const PlaneSelect* planes, size_t i) {
+    uint32x4_t outside = vdupq_n_u32(0);
+    for (int p = 0; p < 6; p++) {
+        const PlaneSelect& pl = planes[p];
+        float32x4_t x = vld1q_f32((pl.useMaxX ? a.maxX : a.minX) + i);
+        float32x4_t y = vld1q_f32((pl.useMaxY ? a.maxY : a.minY) + i);
+        float32x4_t z = vld1q_f32((pl.useMaxZ ? a.maxZ : a.minZ) + i);
+        float32x4_t dist = vdupq_n_f32(pl.d);
+        dist = vmlaq_n_f32(dist, x, pl.nx);
+        dist = vmlaq_n_f32(dist, y, pl.ny);
+        dist = vmlaq_n_f32(dist, z, pl.nz);
+        outside = vorrq_u32(outside, vcltq_f32(dist, vdupq_n_f32(0.0f)));
+    }
+    // Collapse lane masks to 4 bits
+    static const uint32_t laneBits[4] = {1u, 2u, 4u, 8u};
+    uint32x4_t bits = vandq_u32(outside, vld1q_u32(laneBits));
+    return ~vaddvq_u32(bits) & 0xFu;
+}
+#else
+constexpr size_t Width = 4;
+
+inline uint32_t testBlock(const Arrays& a, const PlaneSelect* planes, size_t i) {
+    return testScalar(a, planes, i, Width);
+}
+#endif
+
+inline void selectPlanes(const std::array<glm::vec4, 6>& frustumPlanes, PlaneSelect* planes) {
+    for (int p = 0; p < 6; p++) {
+        const glm::vec4& plane = frustumPlanes[p];
+        planes[p] = {plane.x, plane.y, plane.z, plane.w,
+                     plane.x >= 0.0f, plane.y >= 0.0f, plane.z >= 0.0f};
+    }
+}
+
+} // namespace
+
+void BoundsSoA::resize(size_t count) {
+    size_t padded = (count + PadTo - 1) / PadTo * PadTo;
+    for (auto* array : {&minX_, &minY_, &minZ_, &maxX_, &maxY_, &maxZ_}) {
+        array->resize(padded, 0.0f);
+    }
+    count_ = count;
+}
+
+void BoundsSoA::set(size_t index, const AABB& bounds) {
+    minX_[index] = bounds.min.x;
+    minY_[index] = bounds.min.y;
+    minZ_[index] = bounds.min.z;
+    maxX_[index] = bounds.max.x;
+    maxY_[index] = bounds.max.y;
+    maxZ_[index] = bounds.max.z;
+}
+
+AABB BoundsSoA::get(size_t index) const {
+    return AABB{{minX_[index], minY_[index], minZ_[index]},
+                {maxX_[index], maxY_[index], maxZ_[index]}};
+}
+
+void BoundsSoA::cull(const std::array<glm::vec4, 6>& frustumPlanes,
+                     std::vector<uint64_t>& mask) const {
+    mask.assign((count_ + 63) / 64, 0);
+    cull(frustumPlanes, mask, 0, count_);
+}
+
+void BoundsSoA::cull(const std::array<glm::vec4, 6>& frustumPlanes, std::vector<uint64_t>& mask,
+                     size_t begin, size_t end) const {
+    end = std::min(end, count_);
+    if (begin >= end) {
+        return;
+    }
+
+    PlaneSelect planes[6];
+    selectPlanes(frustumPlanes, planes);
+
+    Arrays arrays{minX_.data(), minY_.data(), minZ_.data(),
+                  maxX_.data(), maxY_.data(), maxZ_.data()};
+
+    // Width divides 64 and the arrays are padded, so blocks never straddle words
+    for (size_t i = begin; i < end; i += Width) {
+        uint64_t bits = testBlock(arrays, planes, i);
+        mask[i >> 6] |= bits << (i & 63);
+    }
+
+    // Clear padding boxes past the end
+    size_t tail = count_ & 63;
+    if (end == count_ && tail != 0) {
+        mask.back() &= (uint64_t{1} << tail) - 1;
+    }
+}
+
+void BoundsSoA::cullViews(const std::vector<std::array<glm::vec4, 6>>& frusta,
+                          std::vector<uint64_t>& anyMask, std::vector<uint32_t>& viewMasks) const {
+    anyMask.assign((count_ + 63) / 64, 0);
+    viewMasks.assign(count_, 0);
+    cullViews(frusta, anyMask, viewMasks, 0, count_);
+}
+
+void BoundsSoA::cullViews(const std::vector<std::array<glm::vec4, 6>>& frusta,
+                          std::vector<uint64_t>& anyMask, std::vector<uint32_t>& viewMasks,
+                          size_t begin, size_t end) const {
+    if (frusta.size() > MaxViews) {
+        throw std::invalid_argument("BoundsSoA::cullViews supports at most 32 views");
+    }
+    end = std::min(end, count_);
+    if (begin >= end) {
+        return;
+    }
+
+    PlaneSelect planes[MaxViews * 6];
+    size_t viewCount = frusta.size();
+    for (size_t v = 0; v < viewCount; v++) {
+        selectPlanes(frusta[v], planes + v * 6);
+    }
+
+    Arrays arrays{minX_.data(), minY_.data(), minZ_.data(),
+                  maxX_.data(), maxY_.data(), maxZ_.data()};
+
+    for (size_t i = begin; i < end; i += Width) {
+        // Boxes past end (padding or the next range) are masked off
+        uint32_t valid = end - i >= Width ? (1u << Width) - 1 : (1u << (end - i)) - 1;
+        uint64_t any = 0;
+        for (size_t v = 0; v < viewCount; v++) {
+            uint32_t bits = testBlock(arrays, planes + v * 6, i) & valid;
+            any |= bits;
+            for (size_t k = 0; bits != 0; k++, bits >>= 1) {
+                if (bits & 1u) {
+                    viewMasks[i + k] |= 1u << v;
+                }
+            }
+        }
+        anyMask[i >> 6] |= any << (i & 63);
+    }
+}
+
+const char* BoundsSoA::simdPath() {
+#if defined(FINEVK_CULL_AVX)
+    return "avx";
+#elif defined(FINEVK_CULL_SSE)
+    return "sse";
+#elif defined(FINEVK_CULL_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace finevk
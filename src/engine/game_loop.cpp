@@ -1,5 +1,7 @@
 #include "finevk/engine/game_loop.hpp"
 #include "finevk/core/logging.hpp"
+#include "finevk/core/profiler.hpp"
+#include <algorithm>
 #include <chrono>
 
 namespace finevk {
@@ -41,6 +43,17 @@ void GameLoop::setup() {
         this->handleResize(w, h);
     });
 
+    // Frames are submitted on the graphics queue, so its timeline retires disposals
+    if (LogicalDevice* device = renderTarget_->device()) {
+        disposer_->retireOn(device->graphicsQueue());
+        disposer_->setDefaultFrameDelay(device->framesInFlight());
+    }
+
+    // Resources replaced by a resize are freed with the rest instead of the window's list
+    window_->setRetireHandler([this](std::function<void()> destroy) {
+        disposer_->dispose(std::move(destroy));
+    });
+
     clock_.start();
     isSetup_ = true;
     isShutdown_ = false;  // Allow restart after shutdown
@@ -61,14 +74,21 @@ void GameLoop::run() {
     isRunning_ = true;
     shouldQuit_ = false;
     frameNumber_ = 0;
+    simTick_.store(0, std::memory_order_relaxed);
+
+    if (threadedSimulation_) {
+        startSimulation();
+    }
 
     FINEVK_INFO(LogCategory::Core, "GameLoop started");
+    FINEVK_PROFILE_THREAD("Main");
 
     while (!shouldQuit()) {
         try {
             float dt = clock_.tick();
             runFrame(dt);
             frameNumber_++;
+            FINEVK_PROFILE_FRAME();
         } catch (const std::exception& e) {
             if (!onError(e)) {
                 break;  // Exit loop on fatal error
@@ -76,6 +96,7 @@ void GameLoop::run() {
         }
     }
 
+    stopSimulation();
     isRunning_ = false;
     FINEVK_INFO(LogCategory::Core, "GameLoop exited");
 }
@@ -85,10 +106,21 @@ void GameLoop::shutdown() {
         return;  // Already shut down
     }
 
+    stopSimulation();
+
     // Unregister window callbacks
     if (window_) {
         window_->onResize(nullptr);
+        window_->setRetireHandler(nullptr);
+    }
+
+    // The disposer (often the global one) may outlive the device, so what
+    // was retired through the window must not wait for a later frame
+    if (LogicalDevice* device = renderTarget_->device()) {
+        device->waitIdle();
+        disposer_->disposeAll();
     }
+    disposer_->retireOn(nullptr);
 
     isSetup_ = false;  // Allow re-setup
     isShutdown_ = true;
@@ -100,8 +132,24 @@ void GameLoop::shutdown() {
 // =============================================================================
 
 void GameLoop::runFrame(float dt) {
+    auto frameStart = std::chrono::steady_clock::now();
+
+    // Low latency: do the GPU/display wait beginFrame() would do before input
+    if (lowLatency_ && window_->hasDevice()) {
+        try {
+            FINEVK_PROFILE_SCOPE("GameLoop::waitForFrame");
+            window_->waitForFrame(queuedPresents_);
+        } catch (const std::exception& e) {
+            if (!onError(e)) {
+                quit();
+                return;
+            }
+        }
+    }
+
     // Process events
     try {
+        FINEVK_PROFILE_SCOPE("GameLoop::processEvents");
         onProcessEvents();
     } catch (const std::exception& e) {
         if (!onError(e)) {
@@ -110,34 +158,44 @@ void GameLoop::runFrame(float dt) {
         }
     }
 
-    // Fixed timestep updates
-    accumulator_ += dt;
-    int updateCount = 0;
-
-    while (accumulator_ >= fixedTimestep_) {
-        try {
-            onFixedUpdate(fixedTimestep_);
-        } catch (const std::exception& e) {
-            if (!onError(e)) {
-                quit();
-                return;
-            }
+    // Fixed timestep updates (on the simulation thread when threaded)
+    if (simThread_.joinable()) {
+        if (!handleSimulationError()) {
+            quit();
+            return;
         }
+    } else {
+        accumulator_ += dt;
+        int updateCount = 0;
+
+        while (accumulator_ >= fixedTimestep_) {
+            try {
+                FINEVK_PROFILE_SCOPE("GameLoop::fixedUpdate");
+                onFixedUpdate(fixedTimestep_);
+            } catch (const std::exception& e) {
+                if (!onError(e)) {
+                    quit();
+                    return;
+                }
+            }
 
-        accumulator_ -= fixedTimestep_;
-        updateCount++;
+            accumulator_ -= fixedTimestep_;
+            updateCount++;
+            simTick_.fetch_add(1, std::memory_order_release);
 
-        // Prevent spiral of death
-        if (updateCount >= maxUpdatesPerFrame_) {
-            accumulator_ = 0.0f;
-            FINEVK_WARN(LogCategory::Core,
-                "GameLoop: Falling behind, skipping updates");
-            break;
+            // Prevent spiral of death
+            if (updateCount >= maxUpdatesPerFrame_) {
+                accumulator_ = 0.0f;
+                FINEVK_WARN(LogCategory::Core,
+                    "GameLoop: Falling behind, skipping updates");
+                break;
+            }
         }
     }
 
     // Variable rate update
     try {
+        FINEVK_PROFILE_SCOPE("GameLoop::update");
         onUpdate(dt);
     } catch (const std::exception& e) {
         if (!onError(e)) {
@@ -147,8 +205,10 @@ void GameLoop::runFrame(float dt) {
     }
 
     // Render with interpolation
-    float interpolation = accumulator_ / fixedTimestep_;
+    float interpolation = simThread_.joinable() ?
+        simulationInterpolation() : accumulator_ / fixedTimestep_;
     try {
+        FINEVK_PROFILE_SCOPE("GameLoop::render");
         onRender(dt, interpolation);
     } catch (const std::exception& e) {
         if (!onError(e)) {
@@ -159,6 +219,7 @@ void GameLoop::runFrame(float dt) {
 
     // Frame end
     try {
+        FINEVK_PROFILE_SCOPE("GameLoop::frameEnd");
         onFrameEnd();
     } catch (const std::exception& e) {
         if (!onError(e)) {
@@ -171,6 +232,7 @@ void GameLoop::runFrame(float dt) {
     if (gcInterval_ > 0 && ++gcCounter_ >= gcInterval_) {
         gcCounter_ = 0;
         try {
+            FINEVK_PROFILE_SCOPE("GameLoop::garbageCollect");
             onGarbageCollect();
         } catch (const std::exception& e) {
             if (!onError(e)) {
@@ -180,15 +242,113 @@ void GameLoop::runFrame(float dt) {
         }
     }
 
-    // Frame pacing
+    float elapsed = std::chrono::duration<float>(
+        std::chrono::steady_clock::now() - frameStart).count();
+    frameStats_.frame = frameNumber_;
+    frameStats_.cpuMilliseconds = elapsed * 1000.0;
+    if (statsRenderer_) {
+        frameStats_.render = statsRenderer_->frameStats();
+    }
+
+    // Frame pacing (elapsed excludes the previous frame's sleep, unlike dt)
     if (targetFrameTime_ > 0.0f) {
-        float sleepTime = onComputeSleep(targetFrameTime_, dt);
+        float sleepTime = onComputeSleep(targetFrameTime_, elapsed);
         if (sleepTime > 0.0f) {
-            FrameClock::sleep(sleepTime);
+            FINEVK_PROFILE_SCOPE("GameLoop::pacing");
+            FrameClock::sleepPrecise(sleepTime, pacingSpin_);
         }
     }
 }
 
+// =============================================================================
+// Threaded Simulation
+// =============================================================================
+
+void GameLoop::startSimulation() {
+    if (simThread_.joinable()) {
+        return;
+    }
+    simError_ = nullptr;
+    simTickTime_.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                       std::memory_order_relaxed);
+    simRunning_.store(true, std::memory_order_release);
+    simThread_ = std::thread([this]() { simulationLoop(); });
+    FINEVK_DEBUG(LogCategory::Core, "GameLoop simulation thread started");
+}
+
+void GameLoop::stopSimulation() {
+    if (!simThread_.joinable()) {
+        return;
+    }
+    simRunning_.store(false, std::memory_order_release);
+    simThread_.join();
+    FINEVK_DEBUG(LogCategory::Core, "GameLoop simulation thread stopped");
+}
+
+void GameLoop::simulationLoop() {
+    using Clock = std::chrono::steady_clock;
+    const auto step = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(fixedTimestep_));
+    const float fixedDt = fixedTimestep_;
+    const float spin = pacingSpin_;
+    const int maxBehind = std::max(maxUpdatesPerFrame_, 1);
+    auto nextTick = Clock::now() + step;
+    FINEVK_PROFILE_THREAD("Simulation");
+
+    while (simRunning_.load(std::memory_order_acquire)) {
+        auto now = Clock::now();
+        if (now < nextTick) {
+            FrameClock::sleepPrecise(std::chrono::duration<float>(nextTick - now).count(), spin);
+            continue;
+        }
+
+        try {
+            FINEVK_PROFILE_SCOPE("GameLoop::fixedUpdate");
+            onFixedUpdate(fixedDt);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(simErrorMutex_);
+            if (!simError_) {
+                simError_ = std::current_exception();
+            }
+        }
+
+        // The snapshot published by this tick describes the scheduled tick time
+        simTickTime_.store(nextTick.time_since_epoch().count(), std::memory_order_release);
+        simTick_.fetch_add(1, std::memory_order_release);
+        nextTick += step;
+
+        // Prevent spiral of death
+        if (Clock::now() - nextTick > step * maxBehind) {
+            nextTick = Clock::now() + step;
+            FINEVK_WARN(LogCategory::Core,
+                "GameLoop: Simulation falling behind, skipping updates");
+        }
+    }
+}
+
+float GameLoop::simulationInterpolation() const {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point tickTime(Clock::duration(simTickTime_.load(std::memory_order_acquire)));
+    float sinceTick = std::chrono::duration<float>(Clock::now() - tickTime).count();
+    return std::clamp(sinceTick / fixedTimestep_, 0.0f, 1.0f);
+}
+
+bool GameLoop::handleSimulationError() {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(simErrorMutex_);
+        std::swap(error, simError_);
+    }
+    if (!error) {
+        return true;
+    }
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        return onError(e);
+    }
+}
+
 // =============================================================================
 // Virtual Method Implementations (Default Behavior)
 // =============================================================================
@@ -247,6 +407,9 @@ bool GameLoop::onError(const std::exception& e) {
 void GameLoop::onGarbageCollect() {
     // Mark frame passed for deferred disposals
     if (disposer_) {
+        if (LogicalDevice* device = renderTarget_->device()) {
+            disposer_->setDefaultFrameDelay(device->framesInFlight());  // May change at runtime
+        }
         disposer_->processFrame();
     }
 
@@ -0,0 +1,462 @@
+#include "finevk/engine/gpu_culler.hpp"
+#include "finevk/engine/render_agent.hpp"
+#include "finevk/engine/hiz_pyramid.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+namespace finevk {
+
+// ============================================================================
+// GpuCuller::Builder implementation
+// ============================================================================
+
+GpuCuller::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+GpuCuller::Builder& GpuCuller::Builder::shader(ShaderModule* module) {
+    shader_ = module;
+    return *this;
+}
+
+GpuCuller::Builder& GpuCuller::Builder::framesInFlight(uint32_t count) {
+    framesInFlight_ = count;
+    return *this;
+}
+
+GpuCuller::Builder& GpuCuller::Builder::instanceBinding(uint32_t binding) {
+    instanceBinding_ = binding;
+    return *this;
+}
+
+GpuCuller::Builder& GpuCuller::Builder::occlusion(ShaderModule* module, HiZPyramid* pyramid) {
+    occlusionShader_ = module;
+    pyramid_ = pyramid;
+    return *this;
+}
+
+std::unique_ptr<GpuCuller> GpuCuller::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("GpuCuller requires a device");
+    }
+    bool occlusion = occlusionShader_ != nullptr || pyramid_ != nullptr;
+    if (occlusion && (!occlusionShader_ || !pyramid_)) {
+        throw std::runtime_error("GpuCuller occlusion() requires the gpu_cull_occlusion shader and a HiZPyramid");
+    }
+    if (!shader_ && !occlusion) {
+        throw std::runtime_error("GpuCuller requires the gpu_cull compute shader");
+    }
+    uint32_t framesInFlight = framesInFlight_ != 0 ? framesInFlight_ : device_->maxFramesInFlight();
+
+    auto culler = std::unique_ptr<GpuCuller>(new GpuCuller());
+    culler->device_ = device_;
+    culler->instanceBinding_ = instanceBinding_;
+    culler->pyramid_ = pyramid_;
+    culler->multiDraw_ = device_->enabledFeatures().multiDrawIndirect == VK_TRUE;
+    culler->useDrawCount_ = culler->multiDraw_ &&
+        device_->enabledVulkan12Features().drawIndirectCount == VK_TRUE;
+
+    if (occlusion) {
+        // Objects, group offsets, commands, counts, visibility, pyramid
+        culler->setLayout_ = DescriptorSetLayout::create(device_)
+            .storageBuffer(0, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(2, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(3, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(4, VK_SHADER_STAGE_COMPUTE_BIT)
+            .combinedImageSampler(5, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+        culler->descriptorPool_ = DescriptorPool::create(device_)
+            .maxSets(2 * framesInFlight)
+            .poolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 10 * framesInFlight)
+            .poolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 * framesInFlight)
+            .build();
+    } else {
+        culler->setLayout_ = DescriptorSetLayout::create(device_)
+            .storageBuffer(0, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(2, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(3, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+        culler->descriptorPool_ = DescriptorPool::create(device_)
+            .maxSets(framesInFlight)
+            .poolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * framesInFlight)
+            .build();
+    }
+
+    culler->pipelineLayout_ = PipelineLayout::create(device_)
+        .addDescriptorSetLayout(culler->setLayout_->handle())
+        .addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                              occlusion ? sizeof(OcclusionParams) : sizeof(CullParams))
+        .build();
+
+    culler->pipeline_ = ComputePipeline::create(device_, culler->pipelineLayout_.get())
+        .shader(occlusion ? occlusionShader_ : shader_)
+        .build();
+
+    culler->frames_.resize(framesInFlight);
+    for (auto& frame : culler->frames_) {
+        frame.descriptorSet = culler->descriptorPool_->allocate(culler->setLayout_.get());
+        if (occlusion) {
+            frame.lateSet = culler->descriptorPool_->allocate(culler->setLayout_.get());
+        }
+    }
+
+    FINEVK_DEBUG(LogCategory::Render, std::string("GpuCuller created (") +
+        (culler->useDrawCount_ ? "indirect count" : "indirect, no count") +
+        (occlusion ? ", two-phase occlusion" : "") + ")");
+
+    return culler;
+}
+
+// ============================================================================
+// GpuCuller implementation
+// ============================================================================
+
+GpuCuller::Builder GpuCuller::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+GpuCuller::~GpuCuller() = default;
+
+void GpuCuller::setScene(const std::vector<const Renderable*>& objects) {
+    objects_.clear();
+    transforms_.clear();
+    groups_.clear();
+    groupOffsets_.clear();
+    objects_.reserve(objects.size());
+    transforms_.reserve(objects.size());
+
+    // Group by everything that must be constant across one indirect draw
+    using GroupKey = std::tuple<const GraphicsPipeline*, const PipelineLayout*, const Material*,
+                                const Buffer*, const Buffer*, VkIndexType>;
+    std::map<GroupKey, uint32_t> groupIds;
+
+    for (const Renderable* renderable : objects) {
+        const Mesh* mesh = renderable->mesh;
+        if (!mesh) {
+            continue;
+        }
+
+        GroupKey key{renderable->pipeline, renderable->pipelineLayout, renderable->material,
+                     mesh->vertexBuffer(), mesh->indexBuffer(), mesh->indexType()};
+        auto it = groupIds.find(key);
+        if (it == groupIds.end()) {
+            it = groupIds.emplace(key, static_cast<uint32_t>(groups_.size())).first;
+            groups_.push_back({renderable, 0, 0});
+        }
+        uint32_t group = it->second;
+        groups_[group].count++;
+
+        // Buffers are bound at offset 0, so mesh offsets become draw parameters
+        uint32_t indexSize = mesh->indexType() == VK_INDEX_TYPE_UINT32 ? 4 : 2;
+        uint32_t stride = Vertex::stride(mesh->attributes());
+        if (mesh->vertexOffset() % stride != 0) {
+            throw std::runtime_error("GpuCuller::setScene() requires mesh vertex offsets "
+                                     "that are a multiple of the vertex stride");
+        }
+
+        AABB bounds = renderable->worldBounds();
+        CullObject object{};
+        object.boundsMin = glm::vec4(bounds.min, 0.0f);
+        object.boundsMax = glm::vec4(bounds.max, 0.0f);
+        const Mesh::Lod& lod = mesh->lod(renderable->lod);
+        object.indexCount = lod.indexCount;
+        object.firstIndex = static_cast<uint32_t>(mesh->indexOffset() / indexSize) + lod.firstIndex;
+        object.vertexOffset = static_cast<int32_t>(mesh->vertexOffset() / stride);
+        object.group = group;
+        objects_.push_back(object);
+        transforms_.push_back(renderable->transform);
+    }
+
+    // Command slot ranges, one per group
+    uint32_t offset = 0;
+    groupOffsets_.reserve(groups_.size());
+    for (auto& group : groups_) {
+        group.offset = offset;
+        groupOffsets_.push_back(offset);
+        offset += group.count;
+    }
+
+    version_++;
+}
+
+void GpuCuller::refresh(Frame& frame) {
+    size_t objectCount = std::max<size_t>(objects_.size(), 1);
+    size_t groupCount = std::max<size_t>(groups_.size(), 1);
+
+    // Grow (never shrink) buffers; this frame's old buffers are idle once its fence signaled
+    auto ensure = [this](BufferPtr& buffer, VkDeviceSize bytes, VkBufferUsageFlags usage,
+                         MemoryUsage memory) {
+        if (buffer && buffer->size() >= bytes) {
+            return false;
+        }
+        VkDeviceSize capacity = buffer ? buffer->size() : 0;
+        capacity = std::max<VkDeviceSize>(capacity * 2, bytes);
+        buffer = Buffer::create(device_)
+            .size(capacity)
+            .usage(usage)
+            .memoryUsage(memory)
+            .build();
+        return true;
+    };
+
+    bool rebind = false;
+    rebind |= ensure(frame.objects, objectCount * sizeof(CullObject),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryUsage::CpuToGpu);
+    rebind |= ensure(frame.groupOffsets, groupCount * sizeof(uint32_t),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryUsage::CpuToGpu);
+    ensure(frame.transforms, objectCount * sizeof(glm::mat4),
+           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, MemoryUsage::CpuToGpu);
+    rebind |= ensure(frame.commands, objectCount * sizeof(VkDrawIndexedIndirectCommand),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::GpuOnly);
+    rebind |= ensure(frame.counts, groupCount * sizeof(uint32_t),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::GpuOnly);
+    if (pyramid_) {
+        rebind |= ensure(frame.lateCommands, objectCount * sizeof(VkDrawIndexedIndirectCommand),
+                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                         VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::GpuOnly);
+        rebind |= ensure(frame.lateCounts, groupCount * sizeof(uint32_t),
+                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                         VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::GpuOnly);
+    }
+
+    if (!objects_.empty()) {
+        std::memcpy(frame.objects->map(), objects_.data(), objects_.size() * sizeof(CullObject));
+        std::memcpy(frame.transforms->map(), transforms_.data(), transforms_.size() * sizeof(glm::mat4));
+    }
+    if (!groupOffsets_.empty()) {
+        std::memcpy(frame.groupOffsets->map(), groupOffsets_.data(),
+                    groupOffsets_.size() * sizeof(uint32_t));
+    }
+
+    if (rebind) {
+        DescriptorWriter writer(device_);
+        writer.writeBuffer(frame.descriptorSet, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.objects)
+            .writeBuffer(frame.descriptorSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.groupOffsets)
+            .writeBuffer(frame.descriptorSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.commands)
+            .writeBuffer(frame.descriptorSet, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.counts);
+        if (pyramid_) {
+            writer.writeBuffer(frame.lateSet, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.objects)
+                .writeBuffer(frame.lateSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.groupOffsets)
+                .writeBuffer(frame.lateSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.lateCommands)
+                .writeBuffer(frame.lateSet, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.lateCounts);
+        }
+        writer.update();
+    }
+
+    frame.version = version_;
+}
+
+void GpuCuller::bindVisibility(Frame& frame) {
+    // Earlier frames may still read a replaced buffer; kept for framesInFlight culls
+    while (!retiredVisibility_.empty() &&
+           cullCount_ - retiredVisibility_.front().first >= frames_.size()) {
+        retiredVisibility_.erase(retiredVisibility_.begin());
+    }
+
+    VkDeviceSize bytes = std::max<size_t>(objects_.size(), 1) * sizeof(uint32_t);
+    if (!visibility_ || visibility_->size() < bytes) {
+        VkDeviceSize capacity = std::max<VkDeviceSize>(visibility_ ? visibility_->size() * 2 : 0, bytes);
+        if (visibility_) {
+            retiredVisibility_.emplace_back(cullCount_, std::move(visibility_));
+        }
+        visibility_ = Buffer::create(device_)
+            .size(capacity)
+            .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+            .memoryUsage(MemoryUsage::GpuOnly)
+            .build();
+        visibilityVersion_ = 0;  // Contents undefined
+    }
+
+    if (frame.visibility != visibility_.get()) {
+        DescriptorWriter(device_)
+            .writeBuffer(frame.descriptorSet, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *visibility_)
+            .writeBuffer(frame.lateSet, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *visibility_)
+            .update();
+        frame.visibility = visibility_.get();
+    }
+}
+
+void GpuCuller::cull(CommandBuffer& cmd, uint32_t frameIndex, const CameraState& camera) {
+    currentFrame_ = frameIndex % static_cast<uint32_t>(frames_.size());
+    Frame& frame = frames_[currentFrame_];
+    viewProjection_ = camera.viewProjection;
+
+    if (frame.version != version_) {
+        refresh(frame);
+    }
+    if (pyramid_) {
+        bindVisibility(frame);
+        cullCount_++;
+    }
+    if (objects_.empty()) {
+        return;
+    }
+
+    if (pyramid_) {
+        // The last frame's second phase wrote visibility and read the pyramid
+        cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT |
+                          VK_ACCESS_SHADER_WRITE_BIT);
+        cmd.fillBuffer(*frame.lateCounts, 0);
+        if (!useDrawCount_) {
+            cmd.fillBuffer(*frame.lateCommands, 0);
+        }
+        if (visibilityVersion_ != version_) {
+            cmd.fillBuffer(*visibility_, 0);  // New scene: everything is found by the second phase
+            visibilityVersion_ = version_;
+        }
+    }
+
+    // Previous indirect reads of this frame's buffers are complete (fence), so
+    // only the transfer -> compute -> indirect chain needs ordering
+    cmd.fillBuffer(*frame.counts, 0);
+    if (!useDrawCount_) {
+        cmd.fillBuffer(*frame.commands, 0);  // Culled slots become empty draws
+    }
+    cmd.memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    if (pyramid_) {
+        // No pyramid yet: the first phase draws nothing and the second finds everything
+        if (pyramid_->valid()) {
+            if (frame.earlyPyramid != pyramid_->view()) {
+                DescriptorWriter(device_)
+                    .writeImage(frame.descriptorSet, 5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                pyramid_->view(), pyramid_->sampler(), VK_IMAGE_LAYOUT_GENERAL)
+                    .update();
+                frame.earlyPyramid = pyramid_->view();
+            }
+            dispatchOcclusion(cmd, frame.descriptorSet, 0);
+        }
+    } else {
+        CullParams params{};
+        for (size_t i = 0; i < 6; i++) {
+            params.planes[i] = camera.frustumPlanes[i];
+        }
+        params.objectCount = objectCount();
+
+        pipeline_->bind(cmd.handle());
+        vkCmdBindDescriptorSets(cmd.handle(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pipelineLayout_->handle(), 0, 1, &frame.descriptorSet, 0, nullptr);
+        cmd.pushConstants(pipelineLayout_->handle(), VK_SHADER_STAGE_COMPUTE_BIT,
+                          0, sizeof(CullParams), &params);
+        cmd.dispatch((objectCount() + 63) / 64);
+    }
+
+    cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+                      VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+void GpuCuller::cullLate(CommandBuffer& cmd) {
+    if (!pyramid_) {
+        throw std::runtime_error("GpuCuller::cullLate() requires occlusion()");
+    }
+    if (objects_.empty()) {
+        return;
+    }
+    if (!pyramid_->valid()) {
+        throw std::runtime_error("GpuCuller::cullLate() requires HiZPyramid::record() first");
+    }
+
+    Frame& frame = frames_[currentFrame_];
+    if (frame.latePyramid != pyramid_->view()) {
+        DescriptorWriter(device_)
+            .writeImage(frame.lateSet, 5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                        pyramid_->view(), pyramid_->sampler(), VK_IMAGE_LAYOUT_GENERAL)
+            .update();
+        frame.latePyramid = pyramid_->view();
+    }
+
+    // HiZPyramid::record() made the pyramid visible to compute
+    dispatchOcclusion(cmd, frame.lateSet, 1);
+
+    cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+}
+
+void GpuCuller::dispatchOcclusion(CommandBuffer& cmd, VkDescriptorSet set, uint32_t phase) {
+    VkExtent2D depth = pyramid_->depthExtent();
+
+    OcclusionParams params{};
+    params.viewProjection = viewProjection_;
+    params.depthSize = glm::vec2(depth.width, depth.height);
+    params.objectCount = objectCount();
+    params.phase = phase;
+
+    pipeline_->bind(cmd.handle());
+    vkCmdBindDescriptorSets(cmd.handle(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                            pipelineLayout_->handle(), 0, 1, &set, 0, nullptr);
+    cmd.pushConstants(pipelineLayout_->handle(), VK_SHADER_STAGE_COMPUTE_BIT,
+                      0, sizeof(OcclusionParams), &params);
+    cmd.dispatch((objectCount() + 63) / 64);
+}
+
+void GpuCuller::draw(CommandBuffer& cmd) {
+    if (objects_.empty()) {
+        return;
+    }
+    Frame& frame = frames_[currentFrame_];
+    drawGroups(cmd, *frame.commands, *frame.counts);
+}
+
+void GpuCuller::drawLate(CommandBuffer& cmd) {
+    if (!pyramid_ || objects_.empty()) {
+        return;
+    }
+    Frame& frame = frames_[currentFrame_];
+    drawGroups(cmd, *frame.lateCommands, *frame.lateCounts);
+}
+
+void GpuCuller::drawGroups(CommandBuffer& cmd, Buffer& commands, Buffer& counts) {
+    Frame& frame = frames_[currentFrame_];
+    cmd.bindVertexBuffers(instanceBinding_, {frame.transforms->handle()}, {0});
+
+    constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    for (uint32_t g = 0; g < groupCount(); g++) {
+        const DrawGroup& group = groups_[g];
+        const Renderable& state = *group.first;
+
+        if (state.pipeline) {
+            state.pipeline->bind(cmd.handle());
+        }
+        if (state.material && state.pipelineLayout) {
+            state.material->bind(cmd, state.pipelineLayout->handle());
+        }
+        cmd.bindVertexBuffer(*state.mesh->vertexBuffer(), 0);
+        cmd.bindIndexBuffer(*state.mesh->indexBuffer(), state.mesh->indexType(), 0);
+
+        VkDeviceSize offset = static_cast<VkDeviceSize>(group.offset) * stride;
+        if (useDrawCount_) {
+            cmd.drawIndexedIndirectCount(commands, offset,
+                                         counts, g * sizeof(uint32_t),
+                                         group.count, stride);
+        } else if (multiDraw_) {
+            cmd.drawIndexedIndirect(commands, offset, group.count, stride);
+        } else {
+            for (uint32_t i = 0; i < group.count; i++) {
+                cmd.drawIndexedIndirect(commands, offset + i * stride, 1, stride);
+            }
+        }
+    }
+}
+
+} // namespace finevk
@@ -0,0 +1,354 @@
+#include "finevk/engine/hiz_pyramid.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/device/sampler.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+// Descriptor sets reserved per slot: one per level, enough for 65536 texels
+constexpr uint32_t MaxLevels = 16;
+
+uint32_t levelSize(uint32_t size, uint32_t level) {
+    return std::max(1u, size >> level);
+}
+
+} // namespace
+
+// ============================================================================
+// HiZPyramid::Builder implementation
+// ============================================================================
+
+HiZPyramid::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+HiZPyramid::Builder& HiZPyramid::Builder::shader(ShaderModule* module) {
+    shader_ = module;
+    return *this;
+}
+
+HiZPyramid::Builder& HiZPyramid::Builder::framesInFlight(uint32_t count) {
+    framesInFlight_ = count;
+    return *this;
+}
+
+HiZPyramid::Builder& HiZPyramid::Builder::readback(bool enable, uint32_t maxSize) {
+    readback_ = enable;
+    readbackSize_ = std::max(1u, maxSize);
+    return *this;
+}
+
+std::unique_ptr<HiZPyramid> HiZPyramid::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("HiZPyramid requires a device");
+    }
+    if (!shader_) {
+        throw std::runtime_error("HiZPyramid requires the hiz_build compute shader");
+    }
+    uint32_t framesInFlight = framesInFlight_ != 0 ? framesInFlight_ : device_->maxFramesInFlight();
+
+    auto pyramid = std::unique_ptr<HiZPyramid>(new HiZPyramid());
+    pyramid->device_ = device_;
+    pyramid->readbackEnabled_ = readback_;
+    pyramid->readbackSize_ = readbackSize_;
+
+    pyramid->setLayout_ = DescriptorSetLayout::create(device_)
+        .combinedImageSampler(0, VK_SHADER_STAGE_COMPUTE_BIT)
+        .storageImage(1, VK_SHADER_STAGE_COMPUTE_BIT)
+        .build();
+
+    uint32_t maxSets = framesInFlight * MaxLevels;
+    pyramid->descriptorPool_ = DescriptorPool::create(device_)
+        .maxSets(maxSets)
+        .poolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxSets)
+        .poolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxSets)
+        .build();
+
+    pyramid->pipelineLayout_ = PipelineLayout::create(device_)
+        .addDescriptorSetLayout(pyramid->setLayout_->handle())
+        .addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(BuildParams))
+        .build();
+
+    pyramid->pipeline_ = ComputePipeline::create(device_, pyramid->pipelineLayout_.get())
+        .shader(shader_)
+        .build();
+
+    // texelFetch only, but combined image samplers need one
+    pyramid->sampler_ = Sampler::create(device_)
+        .filter(VK_FILTER_NEAREST)
+        .mipmapMode(VK_SAMPLER_MIPMAP_MODE_NEAREST)
+        .addressMode(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE)
+        .buildShared();
+
+    pyramid->slots_.resize(framesInFlight);
+
+    FINEVK_DEBUG(LogCategory::Render, std::string("HiZPyramid created") +
+        (readback_ ? " (with readback)" : ""));
+
+    return pyramid;
+}
+
+// ============================================================================
+// HiZPyramid implementation
+// ============================================================================
+
+HiZPyramid::Builder HiZPyramid::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+HiZPyramid::~HiZPyramid() = default;
+
+VkImageView HiZPyramid::view() const {
+    return current_ ? current_->view->handle() : VK_NULL_HANDLE;
+}
+
+VkSampler HiZPyramid::sampler() const {
+    return sampler_->handle();
+}
+
+uint32_t HiZPyramid::levels() const {
+    return current_ ? current_->image->mipLevels() : 0;
+}
+
+VkExtent2D HiZPyramid::depthExtent() const {
+    return current_ ? current_->depthExtent : VkExtent2D{0, 0};
+}
+
+void HiZPyramid::resize(Slot& slot, VkExtent2D depthExtent) {
+    // The next frame may still sample the old pyramid; freed when the slot comes round
+    if (slot.image) {
+        slot.retiredImages.push_back(std::move(slot.image));
+        slot.retiredViews.push_back(std::move(slot.view));
+        for (auto& view : slot.levelViews) {
+            slot.retiredViews.push_back(std::move(view));
+        }
+    }
+    slot.levelViews.clear();
+
+    uint32_t width = std::max(1u, depthExtent.width / 2);
+    uint32_t height = std::max(1u, depthExtent.height / 2);
+    uint32_t levels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    if (levels > MaxLevels) {
+        throw std::runtime_error("HiZPyramid depth buffer is too large");
+    }
+
+    slot.image = Image::create(device_)
+        .extent(width, height)
+        .format(VK_FORMAT_R32_SFLOAT)
+        .usage(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+               VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+        .mipLevels(levels)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+    slot.view = slot.image->createView(VK_IMAGE_ASPECT_COLOR_BIT, 0, levels);
+    for (uint32_t level = 0; level < levels; level++) {
+        slot.levelViews.push_back(slot.image->createView(VK_IMAGE_ASPECT_COLOR_BIT, level, 1));
+    }
+    while (slot.levelSets.size() < levels) {
+        slot.levelSets.push_back(descriptorPool_->allocate(setLayout_.get()));
+    }
+    slot.depthExtent = depthExtent;
+    slot.depthImage = VK_NULL_HANDLE;  // Rewrite every level's set
+
+    if (readbackEnabled_) {
+        slot.readbackLevel = levels - 1;
+        for (uint32_t level = 0; level < levels; level++) {
+            if (levelSize(width, level) <= readbackSize_ && levelSize(height, level) <= readbackSize_) {
+                slot.readbackLevel = level;
+                break;
+            }
+        }
+        slot.readbackExtent = {levelSize(width, slot.readbackLevel),
+                               levelSize(height, slot.readbackLevel)};
+
+        VkDeviceSize bytes = static_cast<VkDeviceSize>(slot.readbackExtent.width) *
+                             slot.readbackExtent.height * sizeof(float);
+        if (!slot.readback || slot.readback->size() < bytes) {
+            slot.readback = Buffer::create(device_)
+                .size(bytes)
+                .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+                .memoryUsage(MemoryUsage::GpuToCpu)
+                .build();
+        }
+    }
+}
+
+void HiZPyramid::deliver(Slot& slot) {
+    if (!slot.readbackPending) {
+        return;
+    }
+    slot.readbackPending = false;
+
+    size_t texels = static_cast<size_t>(slot.readbackExtent.width) * slot.readbackExtent.height;
+    cpuDepth_.resize(texels);
+    void* mapped = slot.readback->map();
+    slot.readback->invalidate(0, texels * sizeof(float));
+    std::memcpy(cpuDepth_.data(), mapped, texels * sizeof(float));
+    cpuExtent_ = slot.readbackExtent;
+    cpuDepthExtent_ = slot.depthExtent;
+    cpuLevel_ = slot.readbackLevel;
+    readbackVersion_++;
+}
+
+void HiZPyramid::record(CommandBuffer& cmd, uint32_t frameIndex, Image& depth) {
+    if (depth.samples() != VK_SAMPLE_COUNT_1_BIT || depth.arrayLayers() != 1) {
+        throw std::runtime_error("HiZPyramid needs a single-sample, single-layer depth buffer");
+    }
+
+    Slot& slot = slots_[frameIndex % static_cast<uint32_t>(slots_.size())];
+
+    // This slot's last frame has completed: its readback is ready and the
+    // frame after it, which sampled the retired images, has completed too
+    deliver(slot);
+    slot.retiredImages.clear();
+    slot.retiredViews.clear();
+
+    bool created = false;
+    VkExtent2D depthExtent{depth.width(), depth.height()};
+    if (!slot.image || slot.depthExtent.width != depthExtent.width ||
+        slot.depthExtent.height != depthExtent.height) {
+        resize(slot, depthExtent);
+        created = true;
+    }
+    uint32_t levels = slot.image->mipLevels();
+
+    if (slot.depthImage != depth.handle()) {
+        if (slot.depthView) {
+            slot.retiredViews.push_back(std::move(slot.depthView));
+        }
+        slot.depthView = depth.createView(VK_IMAGE_ASPECT_DEPTH_BIT);
+        slot.depthImage = depth.handle();
+
+        DescriptorWriter writer(device_);
+        writer.reserve(levels * 2);
+        for (uint32_t level = 0; level < levels; level++) {
+            VkDescriptorSet set = slot.levelSets[level];
+            if (level == 0) {
+                writer.writeImage(set, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                  slot.depthView->handle(), sampler_->handle(),
+                                  VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+            } else {
+                writer.writeImage(set, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                  slot.levelViews[level - 1]->handle(), sampler_->handle(),
+                                  VK_IMAGE_LAYOUT_GENERAL);
+            }
+            writer.writeImage(set, 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                              slot.levelViews[level]->handle(), VK_NULL_HANDLE,
+                              VK_IMAGE_LAYOUT_GENERAL);
+        }
+        writer.update();
+    }
+
+    // Earlier frames' culling and readback copies of this image come before
+    // the rewrite; the depth buffer's writes were made visible by its pass
+    VkImageMemoryBarrier toWrite{};
+    toWrite.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toWrite.srcAccessMask = 0;
+    toWrite.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    toWrite.oldLayout = created ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_GENERAL;
+    toWrite.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    toWrite.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toWrite.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toWrite.image = slot.image->handle();
+    toWrite.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, levels, 0, 1};
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, {}, {}, {toWrite});
+
+    pipeline_->bind(cmd.handle());
+    for (uint32_t level = 0; level < levels; level++) {
+        BuildParams params{};
+        params.sourceSize = level == 0
+            ? glm::ivec2(depthExtent.width, depthExtent.height)
+            : glm::ivec2(levelSize(slot.image->width(), level - 1),
+                         levelSize(slot.image->height(), level - 1));
+        params.targetSize = glm::ivec2(levelSize(slot.image->width(), level),
+                                       levelSize(slot.image->height(), level));
+
+        if (level > 0) {
+            cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        }
+        vkCmdBindDescriptorSets(cmd.handle(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pipelineLayout_->handle(), 0, 1, &slot.levelSets[level], 0, nullptr);
+        cmd.pushConstants(pipelineLayout_->handle(), VK_SHADER_STAGE_COMPUTE_BIT,
+                          0, sizeof(BuildParams), &params);
+        cmd.dispatch((params.targetSize.x + 7) / 8, (params.targetSize.y + 7) / 8, 1);
+    }
+
+    // Culling and fragment shaders read the pyramid; depth writes after this
+    // (RenderTarget::resume()) must wait for level 0's reads
+    cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                      VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+                      VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+
+    if (readbackEnabled_) {
+        VkBufferImageCopy copy{};
+        copy.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, slot.readbackLevel, 0, 1};
+        copy.imageExtent = {slot.readbackExtent.width, slot.readbackExtent.height, 1};
+        vkCmdCopyImageToBuffer(cmd.handle(), slot.image->handle(), VK_IMAGE_LAYOUT_GENERAL,
+                               slot.readback->handle(), 1, &copy);
+        cmd.memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+        slot.readbackPending = true;
+    }
+
+    current_ = &slot;
+}
+
+bool HiZPyramid::isOccluded(const AABB& bounds, const glm::mat4& viewProjection) const {
+    if (cpuDepth_.empty()) {
+        return false;
+    }
+
+    // Mirrors isOccluded() in gpu_cull_occlusion.comp on one fixed level
+    glm::vec2 lo(1.0f);
+    glm::vec2 hi(0.0f);
+    float nearest = 1.0f;
+    for (int i = 0; i < 8; i++) {
+        glm::vec3 p((i & 1) ? bounds.max.x : bounds.min.x,
+                    (i & 2) ? bounds.max.y : bounds.min.y,
+                    (i & 4) ? bounds.max.z : bounds.min.z);
+        glm::vec4 clip = viewProjection * glm::vec4(p, 1.0f);
+        if (clip.w <= 1e-5f) {
+            return false;
+        }
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        glm::vec2 uv = glm::clamp(glm::vec2(ndc) * 0.5f + 0.5f, 0.0f, 1.0f);
+        lo = glm::min(lo, uv);
+        hi = glm::max(hi, uv);
+        nearest = std::min(nearest, ndc.z);
+    }
+
+    glm::vec2 depthSize(cpuDepthExtent_.width, cpuDepthExtent_.height);
+    auto texel = [&](float uv, float size, uint32_t count) {
+        uint32_t t = static_cast<uint32_t>(uv * size * 0.5f) >> cpuLevel_;
+        return std::min(t, count - 1);
+    };
+    uint32_t x0 = texel(lo.x, depthSize.x, cpuExtent_.width);
+    uint32_t x1 = texel(hi.x, depthSize.x, cpuExtent_.width);
+    uint32_t y0 = texel(lo.y, depthSize.y, cpuExtent_.height);
+    uint32_t y1 = texel(hi.y, depthSize.y, cpuExtent_.height);
+
+    float farthest = 0.0f;
+    for (uint32_t y = y0; y <= y1; y++) {
+        for (uint32_t x = x0; x <= x1; x++) {
+            farthest = std::max(farthest, cpuDepth_[static_cast<size_t>(y) * cpuExtent_.width + x]);
+        }
+    }
+    return nearest > farthest;
+}
+
+} // namespace finevk
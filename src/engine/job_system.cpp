@@ -0,0 +1,196 @@
+#include "finevk/engine/job_system.hpp"
+
+namespace finevk {
+
+namespace {
+
+// Identifies the worker the current thread is, if any
+thread_local const JobSystem* tlsSystem = nullptr;
+thread_local uint32_t tlsWorker = 0;
+
+} // namespace
+
+JobSystem::JobSystem(uint32_t threads) {
+    if (threads == 0) {
+        // The thread that waits takes part, so leave it a core
+        uint32_t hardware = std::thread::hardware_concurrency();
+        threads = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    for (uint32_t i = 0; i <= threads; i++) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    workers_.reserve(threads);
+    for (uint32_t i = 0; i < threads; i++) {
+        workers_.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+JobSystem& JobSystem::global() {
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+uint32_t JobSystem::localQueue() const {
+    return tlsSystem == this ? tlsWorker : static_cast<uint32_t>(workers_.size());
+}
+
+void JobSystem::run(Job job, Counter* counter) {
+    if (counter) {
+        counter->pending_.fetch_add(1, std::memory_order_relaxed);
+        job = [job = std::move(job), counter]() {
+            try {
+                job();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(counter->errorMutex_);
+                if (!counter->error_) {
+                    counter->error_ = std::current_exception();
+                }
+            }
+            counter->pending_.fetch_sub(1, std::memory_order_acq_rel);
+        };
+    }
+
+    Queue& queue = *queues_[localQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+
+    // Taking the sleep mutex orders this push before a sleeper's predicate check
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    wake_.notify_one();
+}
+
+bool JobSystem::tryRunOne() {
+    if (queued_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    uint32_t self = localQueue();
+    uint32_t queueCount = static_cast<uint32_t>(queues_.size());
+
+    Job job;
+    for (uint32_t i = 0; i < queueCount && !job; i++) {
+        uint32_t victim = (self + i) % queueCount;
+        Queue& queue = *queues_[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+
+        // Own queue LIFO, stolen work FIFO (oldest, usually the largest)
+        bool own = victim == self && tlsSystem == this;
+        if (own) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+    }
+
+    if (!job) {
+        return false;
+    }
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    job();
+    return true;
+}
+
+void JobSystem::wait(Counter& counter) {
+    while (!counter.done()) {
+        if (!tryRunOne()) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(counter.errorMutex_);
+        std::swap(error, counter.error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+    tlsSystem = this;
+    tlsWorker = index;
+
+    while (true) {
+        if (tryRunOne()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() {
+            return stopping_ || queued_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+            return;  // Stopping and drained
+        }
+    }
+}
+
+uint32_t JobSystem::parallelFor(size_t count, size_t grain,
+                                const std::function<void(size_t, size_t, uint32_t)>& fn) {
+    if (count == 0) {
+        return 0;
+    }
+
+    grain = std::max<size_t>(grain, 1);
+    uint32_t chunks = chunkCount(count, grain);
+    if (chunks == 1 || workers_.empty()) {
+        for (uint32_t c = 0; c < chunks; c++) {
+            fn(c * grain, std::min(count, (c + 1) * grain), c);
+        }
+        return chunks;
+    }
+
+    // Queue all but the first chunk, run the first here, then help with the rest
+    Counter counter;
+    for (uint32_t c = 1; c < chunks; c++) {
+        size_t begin = c * grain;
+        size_t end = std::min(count, begin + grain);
+        run([&fn, begin, end, c]() { fn(begin, end, c); }, &counter);
+    }
+
+    std::exception_ptr error;
+    try {
+        fn(0, std::min(count, grain), 0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // Always wait: queued chunks reference fn
+    try {
+        wait(counter);
+    } catch (...) {
+        if (!error) {
+            error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return chunks;
+}
+
+} // namespace finevk
@@ -0,0 +1,403 @@
+#include "finevk/engine/particle_system.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+// particle_update.comp modes
+constexpr uint32_t ModeReset = 0;
+constexpr uint32_t ModeBegin = 1;
+constexpr uint32_t ModeEmit = 2;
+constexpr uint32_t ModeSimulate = 3;
+
+// particle_sort.comp modes
+constexpr uint32_t SortHistogram = 0;
+constexpr uint32_t SortScan = 1;
+constexpr uint32_t SortScatter = 2;
+
+constexpr uint32_t UpdateGroupSize = 64;
+constexpr uint32_t SortBlockSize = 256;
+
+uint32_t groupsFor(uint32_t count, uint32_t groupSize) {
+    return (count + groupSize - 1) / groupSize;
+}
+
+BufferPtr storageBuffer(LogicalDevice* device, VkDeviceSize bytes, VkBufferUsageFlags extraUsage = 0) {
+    return Buffer::create(device)
+        .size(bytes)
+        .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | extraUsage)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+}
+
+} // namespace
+
+// ============================================================================
+// ParticleSystem::Builder implementation
+// ============================================================================
+
+ParticleSystem::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+ParticleSystem::Builder& ParticleSystem::Builder::updateShader(ShaderModule* module) {
+    updateShader_ = module;
+    return *this;
+}
+
+ParticleSystem::Builder& ParticleSystem::Builder::sortShader(ShaderModule* module) {
+    sortShader_ = module;
+    return *this;
+}
+
+ParticleSystem::Builder& ParticleSystem::Builder::maxParticles(uint32_t count) {
+    maxParticles_ = std::max(1u, count);
+    return *this;
+}
+
+ParticleSystem::Builder& ParticleSystem::Builder::verticesPerParticle(uint32_t count) {
+    verticesPerParticle_ = std::max(1u, count);
+    return *this;
+}
+
+ParticleSystem::Builder& ParticleSystem::Builder::gravity(const glm::vec3& acceleration) {
+    gravity_ = acceleration;
+    return *this;
+}
+
+ParticleSystem::Builder& ParticleSystem::Builder::drag(float perSecond) {
+    drag_ = std::max(0.0f, perSecond);
+    return *this;
+}
+
+ParticleSystem::Builder& ParticleSystem::Builder::maxStepsPerFrame(uint32_t count) {
+    maxStepsPerFrame_ = std::max(1u, count);
+    return *this;
+}
+
+ParticleSystem::Builder& ParticleSystem::Builder::disposer(DeferredDisposer* disposer) {
+    disposer_ = disposer;
+    return *this;
+}
+
+ParticleSystemPtr ParticleSystem::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("ParticleSystem requires a device");
+    }
+    if (!updateShader_) {
+        throw std::runtime_error("ParticleSystem requires the particle_update compute shader");
+    }
+    if (!disposer_) {
+        throw std::runtime_error("ParticleSystem requires a disposer");
+    }
+
+    auto system = ParticleSystemPtr(new ParticleSystem());
+    system->device_ = device_;
+    system->disposer_ = disposer_;
+    system->capacity_ = maxParticles_;
+    system->verticesPerParticle_ = verticesPerParticle_;
+    system->gravity_ = gravity_;
+    system->drag_ = drag_;
+    system->maxStepsPerFrame_ = maxStepsPerFrame_;
+
+    auto gpu = std::make_unique<Gpu>();
+    VkDeviceSize indices = static_cast<VkDeviceSize>(maxParticles_) * sizeof(uint32_t);
+    gpu->particles = storageBuffer(device_, static_cast<VkDeviceSize>(maxParticles_) * 6 * sizeof(glm::vec4));
+    gpu->deadList = storageBuffer(device_, indices);
+    gpu->aliveLists = storageBuffer(device_, 2 * indices);
+    gpu->counters = storageBuffer(device_, 6 * sizeof(uint32_t));
+    gpu->drawCommand = storageBuffer(device_, sizeof(VkDrawIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    gpu->sortKeys = storageBuffer(device_, indices);
+    gpu->drawList = storageBuffer(device_, indices);
+
+    // Particles, dead list, alive lists, counters, draw command, sort keys, draw list
+    gpu->updateLayout = DescriptorSetLayout::create(device_)
+        .storageBuffer(0, VK_SHADER_STAGE_COMPUTE_BIT)
+        .storageBuffer(1, VK_SHADER_STAGE_COMPUTE_BIT)
+        .storageBuffer(2, VK_SHADER_STAGE_COMPUTE_BIT)
+        .storageBuffer(3, VK_SHADER_STAGE_COMPUTE_BIT)
+        .storageBuffer(4, VK_SHADER_STAGE_COMPUTE_BIT)
+        .storageBuffer(5, VK_SHADER_STAGE_COMPUTE_BIT)
+        .storageBuffer(6, VK_SHADER_STAGE_COMPUTE_BIT)
+        .build();
+
+    gpu->descriptorPool = DescriptorPool::create(device_)
+        .maxSets(3)
+        .poolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 7 + 2 * 6)
+        .build();
+
+    gpu->updatePipelineLayout = PipelineLayout::create(device_)
+        .addDescriptorSetLayout(gpu->updateLayout->handle())
+        .addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(UpdateParams))
+        .build();
+
+    gpu->updatePipeline = ComputePipeline::create(device_, gpu->updatePipelineLayout.get())
+        .shader(updateShader_)
+        .build();
+
+    gpu->updateSet = gpu->descriptorPool->allocate(gpu->updateLayout.get());
+    DescriptorWriter writer(device_);
+    writer.writeBuffer(gpu->updateSet, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->particles)
+        .writeBuffer(gpu->updateSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->deadList)
+        .writeBuffer(gpu->updateSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->aliveLists)
+        .writeBuffer(gpu->updateSet, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->counters)
+        .writeBuffer(gpu->updateSet, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->drawCommand)
+        .writeBuffer(gpu->updateSet, 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->sortKeys)
+        .writeBuffer(gpu->updateSet, 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->drawList);
+
+    if (sortShader_) {
+        uint32_t blocks = groupsFor(maxParticles_, SortBlockSize);
+        gpu->scratchKeys = storageBuffer(device_, indices);
+        gpu->scratchValues = storageBuffer(device_, indices);
+        gpu->histogram = storageBuffer(device_, static_cast<VkDeviceSize>(blocks) * 256 * sizeof(uint32_t));
+
+        // Draw command, keys in, values in, keys out, values out, histogram
+        gpu->sortLayout = DescriptorSetLayout::create(device_)
+            .storageBuffer(0, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(2, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(3, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(4, VK_SHADER_STAGE_COMPUTE_BIT)
+            .storageBuffer(5, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+        gpu->sortPipelineLayout = PipelineLayout::create(device_)
+            .addDescriptorSetLayout(gpu->sortLayout->handle())
+            .addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SortParams))
+            .build();
+
+        gpu->sortPipeline = ComputePipeline::create(device_, gpu->sortPipelineLayout.get())
+            .shader(sortShader_)
+            .build();
+
+        // Even passes read the draw list, odd passes the scratch copy, so
+        // after four passes the sorted order is back in the draw list
+        Buffer* keys[2] = {gpu->sortKeys.get(), gpu->scratchKeys.get()};
+        Buffer* values[2] = {gpu->drawList.get(), gpu->scratchValues.get()};
+        for (uint32_t i = 0; i < 2; i++) {
+            VkDescriptorSet set = gpu->descriptorPool->allocate(gpu->sortLayout.get());
+            gpu->sortSets[i] = set;
+            writer.writeBuffer(set, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->drawCommand)
+                .writeBuffer(set, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *keys[i])
+                .writeBuffer(set, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *values[i])
+                .writeBuffer(set, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *keys[i ^ 1])
+                .writeBuffer(set, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *values[i ^ 1])
+                .writeBuffer(set, 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *gpu->histogram);
+        }
+    }
+    writer.update();
+    system->gpu_ = std::move(gpu);
+
+    FINEVK_DEBUG(LogCategory::Render, "ParticleSystem created (" + std::to_string(maxParticles_) +
+        " particles" + (sortShader_ ? ", sorted" : "") + ")");
+
+    return system;
+}
+
+// ============================================================================
+// ParticleSystem implementation
+// ============================================================================
+
+ParticleSystem::Builder ParticleSystem::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+ParticleSystem::~ParticleSystem() {
+    // Frames still in flight may read the buffers or run the pipelines
+    if (gpu_) {
+        disposer_->dispose([gpu = std::move(gpu_)]() mutable {
+            gpu.reset();
+        });
+    }
+}
+
+uint32_t ParticleSystem::addEmitter(const ParticleEmitter& emitter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(emitters_.begin(), emitters_.end(),
+                           [](const EmitterSlot& slot) { return !slot.active; });
+    if (it == emitters_.end()) {
+        it = emitters_.emplace(emitters_.end());
+    }
+    it->emitter = emitter;
+    it->carry = 0.0f;
+    it->active = true;
+    return static_cast<uint32_t>(it - emitters_.begin());
+}
+
+void ParticleSystem::setEmitter(uint32_t id, const ParticleEmitter& emitter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= emitters_.size() || !emitters_[id].active) {
+        throw std::invalid_argument("ParticleSystem: unknown emitter id");
+    }
+    emitters_[id].emitter = emitter;
+}
+
+void ParticleSystem::removeEmitter(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= emitters_.size() || !emitters_[id].active) {
+        throw std::invalid_argument("ParticleSystem: unknown emitter id");
+    }
+    emitters_[id].active = false;
+}
+
+void ParticleSystem::burst(const ParticleEmitter& emitter, uint32_t count) {
+    if (count == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    bursts_.push_back({emitter, std::min(count, capacity_)});
+}
+
+void ParticleSystem::fixedUpdate(float dt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Render thread fell behind (or isn't recording): fold into the last step
+    if (pending_.size() >= maxStepsPerFrame_) {
+        pending_.back().dt += dt;
+    } else {
+        pending_.emplace_back();
+        pending_.back().dt = dt;
+    }
+    Step& step = pending_.back();
+
+    for (EmitterSlot& slot : emitters_) {
+        if (!slot.active || slot.emitter.rate <= 0.0f) {
+            continue;
+        }
+        slot.carry += slot.emitter.rate * dt;
+        float whole = std::floor(slot.carry);
+        slot.carry -= whole;
+        if (whole >= 1.0f) {
+            uint32_t count = static_cast<uint32_t>(std::min(whole, static_cast<float>(capacity_)));
+            step.emits.push_back({slot.emitter, count});
+        }
+    }
+    step.emits.insert(step.emits.end(), bursts_.begin(), bursts_.end());
+    bursts_.clear();
+}
+
+void ParticleSystem::clear() {
+    needsReset_ = true;
+}
+
+void ParticleSystem::dispatchUpdate(CommandBuffer& cmd, UpdateParams& params, uint32_t mode, uint32_t groups) {
+    params.mode = mode;
+    cmd.pushConstants(gpu_->updatePipelineLayout->handle(), VK_SHADER_STAGE_COMPUTE_BIT,
+                      0, sizeof(UpdateParams), &params);
+    cmd.dispatch(groups);
+}
+
+void ParticleSystem::record(CommandBuffer& cmd, const CameraState& camera) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        recording_.clear();
+        std::swap(recording_, pending_);
+    }
+    bool reset = needsReset_;
+    if (!reset && recording_.empty()) {
+        return;
+    }
+    needsReset_ = false;
+
+    // The previous frame's draw() read the draw command, draw list and particles
+    cmd.memoryBarrier(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                      VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    auto computeBarrier = [&cmd]() {
+        cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    };
+
+    UpdateParams params{};
+    // View-space z is the view matrix's third row (glm is column-major)
+    const glm::mat4& view = camera.view;
+    params.viewRow = glm::vec4(view[0][2], view[1][2], view[2][2], view[3][2]);
+    params.gravityDrag = glm::vec4(gravity_, drag_);
+
+    cmd.bindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, gpu_->updatePipeline->handle());
+    cmd.bindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, gpu_->updatePipelineLayout->handle(),
+                           0, {gpu_->updateSet});
+
+    uint32_t particleGroups = groupsFor(capacity_, UpdateGroupSize);
+    if (reset) {
+        params.count = verticesPerParticle_;
+        dispatchUpdate(cmd, params, ModeReset, particleGroups);
+        computeBarrier();
+    }
+
+    for (const Step& step : recording_) {
+        params.dt = step.dt;
+        dispatchUpdate(cmd, params, ModeBegin, 1);
+        computeBarrier();
+
+        // Emits of one step only pop from the dead list, so they may overlap
+        for (const Emit& emit : step.emits) {
+            const ParticleEmitter& e = emit.emitter;
+            params.emitPosition = glm::vec4(e.position, e.radius);
+            params.emitVelocity = glm::vec4(e.velocity, e.spread);
+            params.startColor = e.startColor;
+            params.endColor = e.endColor;
+            params.lifeSize = glm::vec4(e.lifetime, e.lifetimeJitter, e.startSize, e.endSize);
+            params.count = emit.count;
+            params.seed = ++seed_;
+            dispatchUpdate(cmd, params, ModeEmit, groupsFor(emit.count, UpdateGroupSize));
+        }
+        if (!step.emits.empty()) {
+            computeBarrier();
+        }
+
+        dispatchUpdate(cmd, params, ModeSimulate, particleGroups);
+        computeBarrier();
+    }
+
+    if (gpu_->sortPipeline && !recording_.empty()) {
+        recordSort(cmd);
+    }
+
+    cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                      VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+}
+
+void ParticleSystem::recordSort(CommandBuffer& cmd) {
+    SortParams params{};
+    params.blocks = groupsFor(capacity_, SortBlockSize);
+    VkPipelineLayout layout = gpu_->sortPipelineLayout->handle();
+
+    auto dispatch = [&](uint32_t mode, uint32_t groups) {
+        params.mode = mode;
+        cmd.pushConstants(layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SortParams), &params);
+        cmd.dispatch(groups);
+        cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    };
+
+    cmd.bindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, gpu_->sortPipeline->handle());
+    for (uint32_t pass = 0; pass < 4; pass++) {
+        cmd.bindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, {gpu_->sortSets[pass & 1]});
+        params.shift = pass * 8;
+        dispatch(SortHistogram, params.blocks);
+        dispatch(SortScan, 1);
+        dispatch(SortScatter, params.blocks);
+    }
+}
+
+void ParticleSystem::draw(CommandBuffer& cmd) {
+    if (needsReset_) {
+        return;  // Never simulated, or cleared
+    }
+    cmd.drawIndirect(*gpu_->drawCommand, 0, 1);
+}
+
+} // namespace finevk
@@ -1,6 +1,14 @@
 #include "finevk/engine/render_agent.hpp"
+#include "finevk/engine/static_batch.hpp"
 #include "finevk/core/logging.hpp"
+#include "finevk/core/profiler.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/gpu_profiler.hpp"
 #include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 namespace finevk {
 
@@ -8,16 +16,302 @@ namespace finevk {
 // Geometry Management
 // =============================================================================
 
-void RenderAgent::add(const Renderable& renderable) {
-    renderables_.push_back(renderable);
-    needsRecompute_ = true;
+RenderableHandle RenderAgent::add(const Renderable& renderable) {
+    uint32_t slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        renderables_[slot] = renderable;
+        slots_[slot].alive = true;
+        slots_[slot].visible = true;
+    } else {
+        slot = static_cast<uint32_t>(renderables_.size());
+        renderables_.push_back(renderable);
+        slots_.emplace_back();
+        slots_.back().generation = generationBase_;
+    }
+
+    if (gpuCuller_ && !renderable.isTransparent) {
+        sceneDirty_ = true;
+    }
+    lodsDirty_ = true;
+    updateBounds(slot);
+    if (!needsRecompute_ && passesCull(slot)) {
+        listSlot(slot);
+    }
+    return {slot, slots_[slot].generation};
+}
+
+std::vector<RenderableHandle> RenderAgent::addBatch(const StaticBatch& batch) {
+    std::vector<RenderableHandle> handles;
+    handles.reserve(batch.renderables().size());
+    for (const Renderable& renderable : batch.renderables()) {
+        handles.push_back(add(renderable));
+    }
+    return handles;
+}
+
+void RenderAgent::remove(RenderableHandle handle) {
+    uint32_t slot = slotOf(handle);
+    if (slot == UINT32_MAX) {
+        return;
+    }
+
+    Slot& state = slots_[slot];
+    if (gpuCuller_ && !renderables_[slot].isTransparent) {
+        sceneDirty_ = true;
+    }
+    if (!needsRecompute_ && state.listing != Listing::None) {
+        unlistSlot(slot);
+    }
+    if (state.proxy != AABBTree::NullNode) {
+        spatialIndex_.remove(state.proxy);
+        state.proxy = AABBTree::NullNode;
+    }
+
+    state.alive = false;
+    state.listing = Listing::None;
+    state.generation++;
+    freeSlots_.push_back(slot);
+}
+
+void RenderAgent::setTransform(RenderableHandle handle, const glm::mat4& transform) {
+    uint32_t slot = slotOf(handle);
+    if (slot == UINT32_MAX) {
+        return;
+    }
+
+    renderables_[slot].transform = transform;
+    if (gpuCuller_ && !renderables_[slot].isTransparent) {
+        sceneDirty_ = true;
+    }
+    lodsDirty_ = true;
+    updateBounds(slot);
+    if (needsRecompute_) {
+        return;  // Full pass pending; it will pick up the new bounds
+    }
+
+    // Re-test only this object against the current frustum
+    Slot& state = slots_[slot];
+    bool shouldList = passesCull(slot);
+    if (state.listing != Listing::None && !shouldList) {
+        unlistSlot(slot);
+    } else if (state.listing == Listing::None && shouldList) {
+        listSlot(slot);
+    } else if (state.listing == Listing::Transparent) {
+        transparentDirty_ = true;  // Depth changed
+    }
+    if (state.listing != Listing::None) {
+        instancesPrepared_ = false;
+    }
+}
+
+void RenderAgent::setVisible(RenderableHandle handle, bool visible) {
+    uint32_t slot = slotOf(handle);
+    if (slot == UINT32_MAX || slots_[slot].visible == visible) {
+        return;
+    }
+
+    slots_[slot].visible = visible;
+    if (gpuCuller_ && !renderables_[slot].isTransparent) {
+        sceneDirty_ = true;
+    }
+    if (needsRecompute_) {
+        return;
+    }
+
+    if (!visible && slots_[slot].listing != Listing::None) {
+        unlistSlot(slot);
+    } else if (visible && passesCull(slot)) {
+        listSlot(slot);
+    }
+}
+
+bool RenderAgent::isVisible(RenderableHandle handle) const {
+    uint32_t slot = slotOf(handle);
+    return slot != UINT32_MAX && slots_[slot].visible;
+}
+
+bool RenderAgent::contains(RenderableHandle handle) const {
+    return slotOf(handle) != UINT32_MAX;
+}
+
+const Renderable* RenderAgent::find(RenderableHandle handle) const {
+    uint32_t slot = slotOf(handle);
+    return slot == UINT32_MAX ? nullptr : &renderables_[slot];
 }
 
 void RenderAgent::clear() {
+    // New slots start past every generation handed out, so old handles stay stale
+    for (const auto& slot : slots_) {
+        generationBase_ = std::max(generationBase_, slot.generation + 1);
+    }
+
     renderables_.clear();
+    slots_.clear();
+    freeSlots_.clear();
+    spatialIndex_.clear();
     opaqueVisible_.clear();
+    opaqueKeys_.clear();
     transparentSorted_.clear();
+    opaqueBatches_.clear();
+    transparentBatches_.clear();
+    needsRecompute_ = true;
+    sceneDirty_ = true;
+    boundsDirty_ = true;
+}
+
+void RenderAgent::setSpatialIndexEnabled(bool enabled) {
+    if (spatialIndexEnabled_ == enabled) {
+        return;
+    }
+
+    spatialIndexEnabled_ = enabled;
+    spatialIndex_.clear();
+    for (auto& slot : slots_) {
+        slot.proxy = AABBTree::NullNode;
+    }
     needsRecompute_ = true;
+    boundsDirty_ = true;
+}
+
+// =============================================================================
+// Instancing
+// =============================================================================
+
+void RenderAgent::enableInstancing(LogicalDevice* device, uint32_t framesInFlight, uint32_t binding) {
+    if (!device) {
+        throw std::runtime_error("RenderAgent::enableInstancing requires a device");
+    }
+    if (framesInFlight == 0) {
+        framesInFlight = device->maxFramesInFlight();
+    }
+
+    instanceDevice_ = device;
+    instanceBinding_ = binding;
+    instanceBuffers_.clear();
+    instanceBuffers_.resize(framesInFlight);
+    frameIndex_ = 0;
+    instancesPrepared_ = false;
+    needsRecompute_ = true;
+}
+
+void RenderAgent::disableInstancing() {
+    instanceDevice_ = nullptr;
+    instanceBuffers_.clear();
+    opaqueBatches_.clear();
+    transparentBatches_.clear();
+    instancesPrepared_ = false;
+}
+
+void RenderAgent::addInstanceAttributes(GraphicsPipeline::Builder& builder,
+                                        uint32_t binding, uint32_t firstLocation) {
+    builder.vertexBinding(binding, sizeof(glm::mat4), VK_VERTEX_INPUT_RATE_INSTANCE);
+    for (uint32_t column = 0; column < 4; column++) {
+        builder.vertexAttribute(firstLocation + column, binding,
+                                VK_FORMAT_R32G32B32A32_SFLOAT,
+                                column * static_cast<uint32_t>(sizeof(glm::vec4)));
+    }
+}
+
+void RenderAgent::enableGpuCulling(std::unique_ptr<GpuCuller> culler) {
+    gpuCuller_ = std::move(culler);
+    needsRecompute_ = true;
+    sceneDirty_ = true;
+    boundsDirty_ = true;
+}
+
+void RenderAgent::disableGpuCulling() {
+    gpuCuller_.reset();
+    needsRecompute_ = true;
+    boundsDirty_ = true;
+}
+
+void RenderAgent::recordCulling(CommandBuffer& cmd, uint32_t frameIndex) {
+    if (!gpuCuller_) {
+        return;
+    }
+    if (!cameraState_) {
+        FINEVK_WARN(LogCategory::Core, "RenderAgent: No camera set, skipping GPU culling");
+        return;
+    }
+
+    ensureCurrent();
+    GpuProfiler::Scope scope(cmd, "culling");
+    gpuCuller_->cull(cmd, frameIndex, *cameraState_);
+}
+
+void RenderAgent::recordLateCulling(CommandBuffer& cmd) {
+    if (!gpuCuller_ || !gpuCuller_->usesOcclusion() || !cameraState_) {
+        return;
+    }
+
+    GpuProfiler::Scope scope(cmd, "late culling");
+    gpuCuller_->cullLate(cmd);
+}
+
+void RenderAgent::setOcclusionCulling(const HiZPyramid* pyramid) {
+    occlusion_ = pyramid;
+    occlusionVersion_ = pyramid ? pyramid->readbackVersion() : 0;
+    needsRecompute_ = true;
+}
+
+void RenderAgent::beginFrame(uint32_t frameIndex) {
+    if (!instanceBuffers_.empty()) {
+        frameIndex_ = frameIndex % static_cast<uint32_t>(instanceBuffers_.size());
+    }
+    instancesPrepared_ = false;
+}
+
+void RenderAgent::prepareInstances() {
+    if (!instanceDevice_ || instancesPrepared_) {
+        return;
+    }
+
+    size_t count = opaqueVisible_.size() + transparentSorted_.size();
+    VkDeviceSize bytes = std::max<VkDeviceSize>(count, 1) * sizeof(glm::mat4);
+
+    // Grow by doubling; this frame's previous buffer is idle once its fence signaled
+    BufferPtr& buffer = instanceBuffers_[frameIndex_];
+    if (!buffer || buffer->size() < bytes) {
+        VkDeviceSize capacity = buffer ? buffer->size() : 64 * sizeof(glm::mat4);
+        while (capacity < bytes) {
+            capacity *= 2;
+        }
+        buffer = Buffer::create(instanceDevice_)
+            .size(capacity)
+            .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+            .memoryUsage(MemoryUsage::CpuToGpu)
+            .build();
+    }
+
+    // Instance i is list[i]: opaque first, then transparent
+    auto* dst = static_cast<glm::mat4*>(buffer->map());
+    for (const auto* renderable : opaqueVisible_) {
+        *dst++ = renderable->transform;
+    }
+    for (const auto* renderable : transparentSorted_) {
+        *dst++ = renderable->transform;
+    }
+
+    instancesPrepared_ = true;
+}
+
+void RenderAgent::buildBatches(const std::vector<const Renderable*>& list,
+                               std::vector<DrawBatch>& out) {
+    out.clear();
+    for (size_t i = 0; i < list.size(); i++) {
+        const Renderable& r = *list[i];
+        if (!out.empty()) {
+            const Renderable& prev = *list[out.back().first];
+            if (r.mesh == prev.mesh && r.lod == prev.lod && r.material == prev.material &&
+                r.pipeline == prev.pipeline && r.pipelineLayout == prev.pipelineLayout) {
+                out.back().count++;
+                continue;
+            }
+        }
+        out.push_back({static_cast<uint32_t>(i), 1});
+    }
 }
 
 // =============================================================================
@@ -25,8 +319,28 @@ void RenderAgent::clear() {
 // =============================================================================
 
 void RenderAgent::updateCamera(const CameraState& cameraState) {
+    if (!views_.empty()) {
+        views_.clear();
+        viewPlanes_.clear();
+        needsRecompute_ = true;
+    }
+    bool sameCamera = cameraState_ == &cameraState;
     cameraState_ = &cameraState;
 
+    // Versioned state (from Camera): redo culling, sorting and LODs only on change
+    if (cameraState.version != 0) {
+        if (sameCamera && cameraState.version == cameraVersion_) {
+            return;
+        }
+        cameraVersion_ = cameraState.version;
+        lastCameraPos_ = cameraState.position;
+        lodsDirty_ = true;
+        needsRecompute_ = true;
+        return;
+    }
+    cameraVersion_ = 0;
+    lodsDirty_ = true;
+
     // Check if camera moved significantly (triggers transparent resort)
     float distanceMoved = glm::distance(cameraState.position, lastCameraPos_);
     if (distanceMoved > 0.01f) {  // Threshold to avoid excessive resorting
@@ -35,10 +349,76 @@ void RenderAgent::updateCamera(const CameraState& cameraState) {
     }
 }
 
+void RenderAgent::updateViews(const std::vector<CameraState>& views) {
+    if (views.empty() || views.size() > BoundsSoA::MaxViews) {
+        throw std::invalid_argument("RenderAgent::updateViews needs 1 to 32 views");
+    }
+
+    views_ = views;
+    viewPlanes_.clear();
+    for (const auto& view : views_) {
+        viewPlanes_.push_back(view.frustumPlanes);
+    }
+    cameraState_ = &views_.front();
+    lastCameraPos_ = views_.front().position;
+    lodsDirty_ = true;
+    needsRecompute_ = true;  // Per-view visibility follows every frustum
+}
+
+uint32_t RenderAgent::viewMask(RenderableHandle handle) const {
+    uint32_t slot = slotOf(handle);
+    if (slot == UINT32_MAX || slots_[slot].listing == Listing::None) {
+        return 0;
+    }
+    return slots_[slot].views;
+}
+
+size_t RenderAgent::visibleInView(uint32_t view) const {
+    if (view >= viewCount()) {
+        return 0;
+    }
+    size_t count = 0;
+    for (const auto& slot : slots_) {
+        if (slot.listing != Listing::None && ((slot.views >> view) & 1u)) {
+            count++;
+        }
+    }
+    return count;
+}
+
 // =============================================================================
 // Rendering Phases
 // =============================================================================
 
+void RenderAgent::renderDepthPrepass(CommandBuffer& cmd) {
+    if (!cameraState_) {
+        FINEVK_WARN(LogCategory::Core, "RenderAgent: No camera set, skipping depth prepass");
+        return;
+    }
+
+    ensureCurrent();
+    if (gpuCuller_) {
+        return;
+    }
+
+    BindState state;
+    state.depthOnly = true;
+    if (instanceDevice_) {
+        prepareInstances();
+        drawBatches(cmd, opaqueVisible_, opaqueBatches_, 0, opaqueBatches_.size(), 0, state);
+        return;
+    }
+    for (const auto* renderable : opaqueVisible_) {
+        renderOne(cmd, *renderable, state);
+    }
+}
+
+void RenderAgent::configureForDepthPrepass(GraphicsPipeline::Builder& builder) {
+    builder.depthTest(true)
+        .depthWrite(false)
+        .depthCompareOp(VK_COMPARE_OP_EQUAL);
+}
+
 void RenderAgent::renderOpaque(CommandBuffer& cmd) {
     if (!cameraState_) {
         FINEVK_WARN(LogCategory::Core, "RenderAgent: No camera set, skipping opaque render");
@@ -46,13 +426,28 @@ void RenderAgent::renderOpaque(CommandBuffer& cmd) {
     }
 
     // Ensure culling/sorting is up to date
-    if (needsRecompute_) {
-        cullAndSort();
+    ensureCurrent();
+
+    if (gpuCuller_) {
+        gpuCuller_->draw(cmd);
+        return;
     }
 
-    // Render all visible opaque objects
+    // Render all visible opaque objects (state sorted)
+    BindState state;
+    if (instanceDevice_) {
+        prepareInstances();
+        drawBatches(cmd, opaqueVisible_, opaqueBatches_, 0, opaqueBatches_.size(), 0, state);
+        return;
+    }
     for (const auto* renderable : opaqueVisible_) {
-        renderOne(cmd, *renderable);
+        renderOne(cmd, *renderable, state);
+    }
+}
+
+void RenderAgent::renderOpaqueLate(CommandBuffer& cmd) {
+    if (gpuCuller_ && cameraState_) {
+        gpuCuller_->drawLate(cmd);
     }
 }
 
@@ -63,13 +458,18 @@ void RenderAgent::renderTransparent(CommandBuffer& cmd) {
     }
 
     // Ensure culling/sorting is up to date
-    if (needsRecompute_) {
-        cullAndSort();
-    }
+    ensureCurrent();
 
     // Render all visible transparent objects (already sorted back-to-front)
+    BindState state;
+    if (instanceDevice_) {
+        prepareInstances();
+        drawBatches(cmd, transparentSorted_, transparentBatches_, 0, transparentBatches_.size(),
+                    static_cast<uint32_t>(opaqueVisible_.size()), state);
+        return;
+    }
     for (const auto* renderable : transparentSorted_) {
-        renderOne(cmd, *renderable);
+        renderOne(cmd, *renderable, state);
     }
 }
 
@@ -79,9 +479,105 @@ void RenderAgent::renderUI(CommandBuffer& /* cmd */) {
 }
 
 void RenderAgent::render(CommandBuffer& cmd) {
-    renderOpaque(cmd);
-    renderTransparent(cmd);
-    renderUI(cmd);
+    if (depthPrepass_ && !gpuCuller_) {
+        GpuProfiler::Scope scope(cmd, "depth prepass");
+        renderDepthPrepass(cmd);
+    }
+    {
+        GpuProfiler::Scope scope(cmd, "opaque");
+        renderOpaque(cmd);
+    }
+    {
+        GpuProfiler::Scope scope(cmd, "transparent");
+        renderTransparent(cmd);
+    }
+    {
+        GpuProfiler::Scope scope(cmd, "ui");
+        renderUI(cmd);
+    }
+}
+
+void RenderAgent::render(CommandBuffer& primary, FrameCommandPools& pools, ThreadPool& threads) {
+    if (!cameraState_) {
+        FINEVK_WARN(LogCategory::Core, "RenderAgent: No camera set, skipping parallel render");
+        return;
+    }
+
+    // Cull once on this thread; workers only read the visible lists
+    ensureCurrent();
+
+    secondaries_.clear();
+    if (instanceDevice_) {
+        prepareInstances();
+    }
+
+    auto recordList = [this](const std::vector<const Renderable*>& list) {
+        return [this, &list](CommandBuffer& cmd, size_t begin, size_t end) {
+            BindState state;
+            for (size_t i = begin; i < end; i++) {
+                renderOne(cmd, *list[i], state);
+            }
+        };
+    };
+
+    // Depth prepass, ahead of the opaque chunks
+    if (depthPrepass_ && !gpuCuller_) {
+        size_t count = instanceDevice_ ? opaqueBatches_.size() : opaqueVisible_.size();
+        recordParallel(count,
+            [this](CommandBuffer& cmd, size_t begin, size_t end) {
+                BindState state;
+                state.depthOnly = true;
+                if (instanceDevice_) {
+                    drawBatches(cmd, opaqueVisible_, opaqueBatches_, begin, end, 0, state);
+                    return;
+                }
+                for (size_t i = begin; i < end; i++) {
+                    renderOne(cmd, *opaqueVisible_[i], state);
+                }
+            }, primary, pools, threads, secondaries_);
+    }
+
+    // Opaque
+    if (gpuCuller_) {
+        // GPU-culled opaque draws are a handful of indirect calls; record here
+        CommandBuffer& opaque = pools.acquire(0, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+        opaque.beginSecondary(primary);
+        gpuCuller_->draw(opaque);
+        opaque.end();
+        secondaries_.push_back(opaque.handle());
+    } else if (instanceDevice_) {
+        recordParallel(opaqueBatches_.size(),
+            [this](CommandBuffer& cmd, size_t begin, size_t end) {
+                BindState state;
+                drawBatches(cmd, opaqueVisible_, opaqueBatches_, begin, end, 0, state);
+            }, primary, pools, threads, secondaries_);
+    } else {
+        recordParallel(opaqueVisible_.size(), recordList(opaqueVisible_),
+                       primary, pools, threads, secondaries_);
+    }
+
+    // Transparent (chunks stay in back-to-front order)
+    if (instanceDevice_) {
+        uint32_t transparentBase = static_cast<uint32_t>(opaqueVisible_.size());
+        recordParallel(transparentBatches_.size(),
+            [this, transparentBase](CommandBuffer& cmd, size_t begin, size_t end) {
+                BindState state;
+                drawBatches(cmd, transparentSorted_, transparentBatches_, begin, end,
+                            transparentBase, state);
+            }, primary, pools, threads, secondaries_);
+    } else {
+        recordParallel(transparentSorted_.size(), recordList(transparentSorted_),
+                       primary, pools, threads, secondaries_);
+    }
+
+    // UI on the calling thread; slot 0 is free now that the workers are done
+    CommandBuffer& ui = pools.acquire(0, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    ui.beginSecondary(primary);
+    renderUI(ui);
+    ui.end();
+    secondaries_.push_back(ui.handle());
+
+    primary.executeCommands(secondaries_);
 }
 
 // =============================================================================
@@ -89,47 +585,589 @@ void RenderAgent::render(CommandBuffer& cmd) {
 // =============================================================================
 
 void RenderAgent::cullAndSort() {
+    FINEVK_PROFILE_SCOPE("RenderAgent::cullAndSort");
     opaqueVisible_.clear();
+    opaqueKeys_.clear();
     transparentSorted_.clear();
 
     if (!cameraState_) {
-        needsRecompute_ = false;
+        return;  // Stays pending until a camera is set
+    }
+
+    stateIds_.clear();
+
+    // Hierarchical path: query the tree, then visit only what it returned
+    if (usesSpatialIndex()) {
+        if (boundsDirty_) {
+            updateSpatialIndex();
+            boundsDirty_ = false;
+        }
+
+        for (auto& slot : slots_) {
+            slot.listing = Listing::None;
+            slot.views = 0;
+        }
+
+        // One query per view; each index is collected the first time it is seen
+        visibleIndices_.clear();
+        size_t viewCount = std::max<size_t>(viewPlanes_.size(), 1);
+        for (size_t v = 0; v < viewCount; v++) {
+            const auto& planes = viewPlanes_.empty() ? cameraState_->frustumPlanes : viewPlanes_[v];
+            spatialIndex_.queryFrustum(planes, [this, v](uint32_t index) {
+                if (slots_[index].views == 0) {
+                    visibleIndices_.push_back(index);
+                }
+                slots_[index].views |= 1u << v;
+            });
+        }
+
+        // Submission order independent of tree layout
+        std::sort(visibleIndices_.begin(), visibleIndices_.end());
+        for (uint32_t index : visibleIndices_) {
+            if (slots_[index].visible && !isOccluded(index)) {
+                appendSlot(index);
+            }
+        }
+    } else {
+        cullBruteForce();
+    }
+
+    // Sort opaque objects by state so equal pipeline/material/mesh are adjacent
+    if (!gpuCuller_ && (stateSortingEnabled_ || frontToBack_) && opaqueVisible_.size() > 1) {
+        auto& keyed = sortScratch_;
+        keyed.clear();
+        keyed.reserve(opaqueVisible_.size());
+        for (size_t i = 0; i < opaqueVisible_.size(); i++) {
+            keyed.emplace_back(opaqueKeys_[i], opaqueVisible_[i]);
+        }
+        auto byKey = [](const auto& a, const auto& b) { return a.first < b.first; };
+        if (runsParallel(keyed.size())) {
+            jobs_->parallelSort(keyed.begin(), keyed.end(), byKey, parallelGrain_);
+        } else {
+            std::sort(keyed.begin(), keyed.end(), byKey);
+        }
+        for (size_t i = 0; i < keyed.size(); i++) {
+            opaqueKeys_[i] = keyed[i].first;
+            opaqueVisible_[i] = keyed[i].second;
+        }
+    }
+
+    transparentDirty_ = true;
+    batchesDirty_ = true;
+    needsRecompute_ = false;
+}
+
+void RenderAgent::ensureCurrent() {
+    // A new occlusion readback changes what is hidden
+    if (occlusion_ && occlusion_->readbackVersion() != occlusionVersion_) {
+        occlusionVersion_ = occlusion_->readbackVersion();
+        needsRecompute_ = true;
+    }
+
+    if (needsRecompute_) {
+        cullAndSort();
+        if (needsRecompute_) {
+            return;  // No camera yet
+        }
+    }
+
+    if (transparentDirty_) {
+        sortTransparent();
+    }
+
+    if (lodSelection_ && lodsDirty_) {
+        selectLods();
+        lodsDirty_ = false;
+    }
+
+    // Hand changed geometry to the GPU culler (it groups by state itself)
+    if (gpuCuller_ && sceneDirty_) {
+        gpuCuller_->setScene(opaqueVisible_);
+        sceneDirty_ = false;
+    }
+
+    if (batchesDirty_) {
+        if (instanceDevice_) {
+            buildBatches(opaqueVisible_, opaqueBatches_);
+            buildBatches(transparentSorted_, transparentBatches_);
+            instancesPrepared_ = false;
+        }
+        batchesDirty_ = false;
+    }
+}
+
+void RenderAgent::setLodSelection(bool enabled, float maxError, float hysteresis) {
+    lodMaxError_ = maxError;
+    lodHysteresis_ = std::clamp(hysteresis, 0.0f, 0.9f);
+    if (enabled == lodSelection_) {
+        lodsDirty_ = true;
         return;
     }
 
-    // Separate opaque and transparent, apply frustum culling
-    for (const auto& renderable : renderables_) {
-        // Frustum culling (if enabled)
-        if (frustumCullingEnabled_) {
-            AABB worldBounds = renderable.worldBounds();
-            if (!worldBounds.intersectsFrustum(cameraState_->frustumPlanes)) {
+    lodSelection_ = enabled;
+    lodsDirty_ = true;
+    if (!enabled) {
+        for (auto& renderable : renderables_) {
+            renderable.lod = 0;
+        }
+        batchesDirty_ = true;
+        sceneDirty_ = true;
+    }
+}
+
+uint32_t RenderAgent::chooseLod(const Mesh& mesh, uint32_t current, float projectedSize) const {
+    uint32_t last = mesh.lodCount() - 1;
+    current = std::min(current, last);
+    auto projectedError = [&](uint32_t level) { return mesh.lod(level).error * projectedSize; };
+
+    // Refine once the current level is clearly too coarse
+    if (projectedError(current) > lodMaxError_ * (1.0f + lodHysteresis_)) {
+        while (current > 0 && projectedError(current) > lodMaxError_) {
+            current--;
+        }
+        return current;
+    }
+
+    // Coarsen only with margin to spare
+    while (current < last && projectedError(current + 1) <= lodMaxError_ * (1.0f - lodHysteresis_)) {
+        current++;
+    }
+    return current;
+}
+
+void RenderAgent::selectLods() {
+    if (!cameraState_) {
+        return;
+    }
+
+    // Bounding radius over distance, scaled to a fraction of the screen height
+    const glm::mat4& projection = cameraState_->projection;
+    bool perspective = projection[3][3] == 0.0f;
+    float scale = std::abs(projection[1][1]) * 0.5f;
+
+    bool changed = false;
+    for (size_t i = 0; i < renderables_.size(); i++) {
+        Renderable& renderable = renderables_[i];
+        if (slots_[i].listing == Listing::None || !renderable.mesh ||
+            renderable.mesh->lodCount() < 2) {
+            continue;
+        }
+
+        AABB bounds = renderable.worldBounds();
+        float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+        float projectedSize = radius * scale;
+        if (perspective) {
+            float distance = glm::distance(cameraState_->position, bounds.center());
+            projectedSize = distance > radius ? projectedSize / distance
+                                              : std::numeric_limits<float>::max();
+        }
+
+        uint32_t lod = chooseLod(*renderable.mesh, renderable.lod, projectedSize);
+        if (lod != renderable.lod) {
+            renderable.lod = lod;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        batchesDirty_ = true;
+        if (gpuCuller_) {
+            sceneDirty_ = true;
+        }
+    }
+}
+
+void RenderAgent::sortTransparent() {
+    // Inverted so ascending keys run far to near; the low 8 bits are dropped
+    // so jitter doesn't reorder near-equal depths (and radix skips a pass)
+    glm::vec3 cameraPos = cameraState_->position;
+    transparentKeys_.resize(transparentSorted_.size());
+    auto computeKeys = [this, cameraPos](size_t begin, size_t end, uint32_t) {
+        for (size_t i = begin; i < end; i++) {
+            const Renderable* renderable = transparentSorted_[i];
+            glm::vec3 center = glm::vec3(renderable->transform *
+                                         glm::vec4(renderable->localBounds.center(), 1.0f));
+            glm::vec3 offset = center - cameraPos;
+            uint32_t depth = sortableFloatBits(glm::dot(offset, offset));
+            transparentKeys_[i] = {~depth & ~0xFFu, renderable};
+        }
+    };
+    if (runsParallel(transparentKeys_.size())) {
+        jobs_->parallelFor(transparentKeys_.size(), parallelGrain_, computeKeys);
+    } else {
+        computeKeys(0, transparentKeys_.size(), 0);
+    }
+
+    // The list still holds last frame's order, which is usually nearly sorted
+    if (!insertionSortBounded(transparentKeys_, transparentKeys_.size() * 2)) {
+        radixSort(transparentKeys_, transparentScratch_);
+    }
+    for (size_t i = 0; i < transparentKeys_.size(); i++) {
+        transparentSorted_[i] = transparentKeys_[i].value;
+    }
+    transparentDirty_ = false;
+    batchesDirty_ = true;
+    instancesPrepared_ = false;
+}
+
+void RenderAgent::appendSlot(uint32_t slot) {
+    const Renderable& renderable = renderables_[slot];
+    if (renderable.isTransparent) {
+        transparentSorted_.push_back(&renderable);
+        slots_[slot].listing = Listing::Transparent;
+    } else {
+        uint64_t key = listKey(slot);
+        opaqueVisible_.push_back(&renderable);
+        opaqueKeys_.push_back(key);
+        slots_[slot].key = key;
+        slots_[slot].listing = Listing::Opaque;
+    }
+}
+
+void RenderAgent::cullBruteForce() {
+    size_t count = renderables_.size();
+    bool parallel = runsParallel(count);
+
+    // World bounds only change with geometry, not with the camera
+    if (boundsDirty_) {
+        worldBounds_.resize(count);
+        auto setBounds = [this](size_t begin, size_t end, uint32_t) {
+            for (size_t i = begin; i < end; i++) {
+                worldBounds_.set(i, renderables_[i].worldBounds());
+            }
+        };
+        if (parallel) {
+            jobs_->parallelFor(count, parallelGrain_, setBounds);
+        } else {
+            setBounds(0, count, 0);
+        }
+        boundsDirty_ = false;
+    }
+
+    // Each chunk tests its boxes and collects its visible slots; chunks only
+    // write their own mask words, slots and lists
+    visibleMask_.assign((count + 63) / 64, 0);
+    bool multiView = viewPlanes_.size() > 1;
+    if (multiView) {
+        viewBits_.assign(count, 0);
+    }
+    auto cullChunk = [this, multiView](size_t begin, size_t end, uint32_t chunk) {
+        if (frustumCullingEnabled_ && multiView) {
+            worldBounds_.cullViews(viewPlanes_, visibleMask_, viewBits_, begin, end);
+        } else if (frustumCullingEnabled_) {
+            worldBounds_.cull(cameraState_->frustumPlanes, visibleMask_, begin, end);
+        }
+
+        ChunkLists& lists = chunkLists_[chunk];
+        lists.opaque.clear();
+        lists.transparent.clear();
+        for (size_t i = begin; i < end; i++) {
+            Slot& slot = slots_[i];
+            slot.listing = Listing::None;
+            slot.views = 0;
+            if (!slot.alive || !slot.visible) {
+                continue;
+            }
+
+            // With GPU culling, all opaque geometry goes to the culler
+            bool transparent = renderables_[i].isTransparent;
+            bool cpuCulled = !gpuCuller_ || transparent;
+            if (cpuCulled && frustumCullingEnabled_ && !BoundsSoA::test(visibleMask_, i)) {
                 continue;  // Culled
             }
+            if (cpuCulled && isOccluded(static_cast<uint32_t>(i))) {
+                continue;
+            }
+            bool tested = cpuCulled && frustumCullingEnabled_;
+            slot.views = !tested ? allViews() : multiView ? viewBits_[i] : 1u;
+            (transparent ? lists.transparent : lists.opaque).push_back(static_cast<uint32_t>(i));
+        }
+    };
+
+    if (parallel) {
+        chunkLists_.resize(JobSystem::chunkCount(count, parallelGrain_));
+        jobs_->parallelFor(count, parallelGrain_, cullChunk);
+    } else {
+        chunkLists_.resize(1);
+        cullChunk(0, count, 0);
+    }
+
+    // Concatenate in chunk order (sort keys use shared IDs, so assign them here)
+    for (const auto& lists : chunkLists_) {
+        for (uint32_t slot : lists.opaque) {
+            appendSlot(slot);
         }
+        for (uint32_t slot : lists.transparent) {
+            appendSlot(slot);
+        }
+    }
+}
 
-        // Separate by transparency
-        if (renderable.isTransparent) {
-            transparentSorted_.push_back(&renderable);
+void RenderAgent::updateSpatialIndex() {
+    // Existing leaves only restructure the tree when they leave their fat box
+    for (uint32_t i = 0; i < slots_.size(); i++) {
+        Slot& slot = slots_[i];
+        if (!slot.alive) {
+            continue;
+        }
+        AABB bounds = renderables_[i].worldBounds();
+        if (slot.proxy == AABBTree::NullNode) {
+            slot.proxy = spatialIndex_.insert(bounds, i);
         } else {
-            opaqueVisible_.push_back(&renderable);
+            spatialIndex_.move(slot.proxy, bounds);
         }
     }
+}
 
-    // Sort transparent objects back-to-front (far to near)
-    std::sort(transparentSorted_.begin(), transparentSorted_.end(),
-        [cameraPos = cameraState_->position](const Renderable* a, const Renderable* b) {
-            float distA = a->distanceToCamera(cameraPos);
-            float distB = b->distanceToCamera(cameraPos);
-            return distA > distB;  // Farther objects first
-        });
+// =============================================================================
+// Incremental Updates
+// =============================================================================
 
-    needsRecompute_ = false;
+uint32_t RenderAgent::slotOf(RenderableHandle handle) const {
+    if (handle.index >= slots_.size()) {
+        return UINT32_MAX;
+    }
+    const Slot& slot = slots_[handle.index];
+    return slot.alive && slot.generation == handle.generation ? handle.index : UINT32_MAX;
+}
+
+void RenderAgent::updateBounds(uint32_t slot) {
+    if (boundsDirty_) {
+        return;  // Full rebuild pending
+    }
+
+    AABB bounds = renderables_[slot].worldBounds();
+    if (usesSpatialIndex()) {
+        Slot& state = slots_[slot];
+        if (state.proxy == AABBTree::NullNode) {
+            state.proxy = spatialIndex_.insert(bounds, slot);
+        } else {
+            spatialIndex_.move(state.proxy, bounds);
+        }
+    } else {
+        if (slot >= worldBounds_.size()) {
+            worldBounds_.resize(slot + 1);
+        }
+        worldBounds_.set(slot, bounds);
+    }
+}
+
+bool RenderAgent::passesCull(uint32_t slot) {
+    Slot& state = slots_[slot];
+    state.views = 0;
+    if (!state.alive || !state.visible) {
+        return false;
+    }
+
+    const Renderable& renderable = renderables_[slot];
+    if ((gpuCuller_ && !renderable.isTransparent) || !frustumCullingEnabled_) {
+        state.views = allViews();
+        return true;
+    }
+    AABB bounds = renderable.worldBounds();
+    if (viewPlanes_.size() > 1) {
+        for (size_t v = 0; v < viewPlanes_.size(); v++) {
+            if (bounds.intersectsFrustum(viewPlanes_[v])) {
+                state.views |= 1u << v;
+            }
+        }
+        return state.views != 0;
+    }
+    state.views = bounds.intersectsFrustum(cameraState_->frustumPlanes) &&
+                  !isOccluded(slot) ? 1u : 0u;
+    return state.views != 0;
+}
+
+bool RenderAgent::isOccluded(uint32_t slot) const {
+    if (!occlusion_ || viewPlanes_.size() > 1) {
+        return false;
+    }
+    const Renderable& renderable = renderables_[slot];
+    if (gpuCuller_ && !renderable.isTransparent) {
+        return false;  // Culled on the GPU instead
+    }
+    return occlusion_->isOccluded(renderable.worldBounds(), cameraState_->viewProjection);
+}
+
+uint64_t RenderAgent::listKey(uint32_t slot) {
+    if (gpuCuller_) {
+        return slot;
+    }
+    if (frontToBack_) {
+        // Top 16 bits of a positive float order like the float itself
+        float distance = renderables_[slot].distanceToCamera(cameraState_->position);
+        uint32_t bits;
+        std::memcpy(&bits, &distance, sizeof(bits));
+        uint64_t depth = (bits >> 15) & 0xFFFF;
+
+        if (!stateSortingEnabled_) {
+            return (depth << 32) | slot;
+        }
+        // Pipeline and material buckets first, then distance, then mesh
+        uint64_t key = stateKey(renderables_[slot]);
+        uint64_t pipeline = (key >> 42) & 0xFFFF;
+        uint64_t material = (key >> 21) & 0xFFFF;
+        uint64_t mesh = key & 0xFFFF;
+        return (pipeline << 48) | (material << 32) | (depth << 16) | mesh;
+    }
+    if (stateSortingEnabled_) {
+        return stateKey(renderables_[slot]);
+    }
+    return slot;
+}
+
+void RenderAgent::listSlot(uint32_t slot) {
+    const Renderable& renderable = renderables_[slot];
+    if (renderable.isTransparent) {
+        transparentSorted_.push_back(&renderable);
+        slots_[slot].listing = Listing::Transparent;
+        transparentDirty_ = true;
+    } else {
+        // Insert after equal keys to keep the list sorted
+        uint64_t key = listKey(slot);
+        auto pos = std::upper_bound(opaqueKeys_.begin(), opaqueKeys_.end(), key);
+        size_t at = static_cast<size_t>(pos - opaqueKeys_.begin());
+        opaqueKeys_.insert(pos, key);
+        opaqueVisible_.insert(opaqueVisible_.begin() + at, &renderable);
+        slots_[slot].key = key;
+        slots_[slot].listing = Listing::Opaque;
+    }
+    batchesDirty_ = true;
+    instancesPrepared_ = false;
+}
+
+void RenderAgent::unlistSlot(uint32_t slot) {
+    const Renderable* renderable = &renderables_[slot];
+    if (slots_[slot].listing == Listing::Opaque) {
+        // Only entries with an equal key can hold this renderable (the key it
+        // was listed with: distances move with the camera)
+        auto range = std::equal_range(opaqueKeys_.begin(), opaqueKeys_.end(), slots_[slot].key);
+        for (auto it = range.first; it != range.second; ++it) {
+            size_t at = static_cast<size_t>(it - opaqueKeys_.begin());
+            if (opaqueVisible_[at] == renderable) {
+                opaqueKeys_.erase(it);
+                opaqueVisible_.erase(opaqueVisible_.begin() + at);
+                break;
+            }
+        }
+    } else if (slots_[slot].listing == Listing::Transparent) {
+        // Erasing keeps the remaining back-to-front order
+        auto it = std::find(transparentSorted_.begin(), transparentSorted_.end(), renderable);
+        if (it != transparentSorted_.end()) {
+            transparentSorted_.erase(it);
+        }
+    }
+    slots_[slot].listing = Listing::None;
+    slots_[slot].views = 0;
+    batchesDirty_ = true;
+    instancesPrepared_ = false;
 }
 
 // =============================================================================
 // Rendering Helper
 // =============================================================================
 
+uint64_t RenderAgent::stateKey(const Renderable& renderable) {
+    // Pipeline, material and mesh share one ID space; IDs are assigned in
+    // first-seen order so the key is stable for an unchanged scene
+    auto idOf = [this](const void* ptr) -> uint64_t {
+        if (!ptr) {
+            return 0;
+        }
+        auto it = stateIds_.find(ptr);
+        if (it == stateIds_.end()) {
+            it = stateIds_.emplace(ptr, static_cast<uint32_t>(stateIds_.size() + 1)).first;
+        }
+        return it->second;
+    };
+
+    constexpr uint64_t MeshMask = (1ull << 21) - 1;
+    constexpr uint64_t MaterialMask = (1ull << 21) - 1;
+    constexpr uint64_t PipelineMask = (1ull << 22) - 1;
+
+    uint64_t pipeline = idOf(renderable.pipeline) & PipelineMask;
+    uint64_t material = idOf(renderable.material) & MaterialMask;
+    uint64_t mesh = idOf(renderable.mesh) & MeshMask;
+    return (pipeline << 42) | (material << 21) | mesh;
+}
+
+bool RenderAgent::bindState(CommandBuffer& cmd, const Renderable& renderable, BindState& state) {
+    if (!renderable.mesh) {
+        return false;  // Skip invalid renderables
+    }
+
+    const GraphicsPipeline* pipeline = renderable.pipeline;
+    if (state.depthOnly) {
+        pipeline = renderable.depthPipeline;
+        if (!pipeline) {
+            return false;  // Shaded with depth writes in the main pass
+        }
+    }
+    if (pipeline && pipeline != state.pipeline) {
+        pipeline->bind(cmd.handle());
+        state.pipeline = pipeline;
+    }
+
+    // A new pipeline layout may disturb set bindings, so rebind on layout change too
+    if (renderable.pipelineLayout) {
+        VkPipelineLayout layout = renderable.pipelineLayout->handle();
+        if (bindless_ && layout != state.layout) {
+            bindless_->bind(cmd, layout, bindlessSet_);
+        }
+        if (renderable.material && !renderable.material->isBindless() &&
+            (renderable.material != state.material || layout != state.layout)) {
+            renderable.material->bind(cmd, layout);
+            state.material = renderable.material;
+        }
+        state.layout = layout;
+    }
+
+    if (renderable.mesh != state.mesh) {
+        renderable.mesh->bind(cmd);
+        state.mesh = renderable.mesh;
+    }
+    return true;
+}
+
+void RenderAgent::pushObject(CommandBuffer& cmd, const Renderable& renderable) {
+    const PipelineLayout* layout = renderable.pipelineLayout;
+    if (!layout || !layout->hasObjectPushConstants()) {
+        return;
+    }
+
+    ObjectPushConstants object;
+    object.model = renderable.transform;
+    object.objectId = renderable.objectId;
+    if (renderable.material && renderable.material->isBindless()) {
+        object.materialIndex = renderable.material->bindlessIndex();
+    }
+    layout->pushObject(cmd.handle(), object);
+}
+
+void RenderAgent::renderOne(CommandBuffer& cmd, const Renderable& renderable, BindState& state) {
+    if (bindState(cmd, renderable, state)) {
+        pushObject(cmd, renderable);
+        renderable.mesh->drawLod(cmd, renderable.lod);
+    }
+}
+
+void RenderAgent::drawBatches(CommandBuffer& cmd, const std::vector<const Renderable*>& list,
+                              const std::vector<DrawBatch>& batches, size_t begin, size_t end,
+                              uint32_t instanceBase, BindState& state) {
+    if (!state.instancesBound && begin < end) {
+        cmd.bindVertexBuffers(instanceBinding_, {instanceBuffers_[frameIndex_]->handle()}, {0});
+        state.instancesBound = true;
+    }
+
+    for (size_t b = begin; b < end; b++) {
+        const DrawBatch& batch = batches[b];
+        const Renderable& renderable = *list[batch.first];
+        if (bindState(cmd, renderable, state)) {
+            renderable.mesh->drawLod(cmd, renderable.lod, batch.count, instanceBase + batch.first);
+        }
+    }
+}
+
 void RenderAgent::renderOne(CommandBuffer& cmd, const Renderable& renderable) {
     if (!renderable.mesh) {
         return;  // Skip invalid renderables
@@ -141,20 +1179,49 @@ void RenderAgent::renderOne(CommandBuffer& cmd, const Renderable& renderable) {
         renderable.pipeline->bind(vkCmd);
     }
 
-    // Bind material descriptors if provided
-    if (renderable.material && renderable.pipelineLayout) {
-        renderable.material->bind(cmd, renderable.pipelineLayout->handle());
+    // Bind material descriptors (or the bindless table) if provided
+    if (renderable.pipelineLayout) {
+        VkPipelineLayout layout = renderable.pipelineLayout->handle();
+        if (bindless_) {
+            bindless_->bind(cmd, layout, bindlessSet_);
+        }
+        if (renderable.material && !renderable.material->isBindless()) {
+            renderable.material->bind(cmd, layout);
+        }
     }
 
-    // Push transform as push constant
-    // Note: This assumes the pipeline uses push constants for MVP
-    // In practice, you might want to update a uniform buffer instead
-    // TODO: Define standard push constant layout or uniform buffer update pattern
-    // For now, this is left to the user's shader/pipeline configuration
+    // Per-object transform without a descriptor update
+    pushObject(cmd, renderable);
 
     // Bind and draw mesh
     renderable.mesh->bind(cmd);
-    renderable.mesh->draw(cmd);
+    renderable.mesh->drawLod(cmd, renderable.lod);
+}
+
+void RenderAgent::recordParallel(size_t count,
+                                 const std::function<void(CommandBuffer&, size_t, size_t)>& record,
+                                 const CommandBuffer& primary, FrameCommandPools& pools,
+                                 ThreadPool& threads, std::vector<VkCommandBuffer>& out) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t maxByBatch = (count + parallelBatchSize_ - 1) / parallelBatchSize_;
+    uint32_t maxChunks = static_cast<uint32_t>(
+        std::min<size_t>(maxByBatch, std::min(pools.threadCount(), threads.threadCount() + 1)));
+
+    // Chunks write their own slots of out; unused slots are dropped afterwards
+    size_t base = out.size();
+    out.resize(base + maxChunks, VK_NULL_HANDLE);
+    uint32_t chunks = threads.parallelFor(count,
+        [&](size_t begin, size_t end, uint32_t chunk) {
+            CommandBuffer& cmd = pools.acquire(chunk, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+            cmd.beginSecondary(primary);
+            record(cmd, begin, end);
+            cmd.end();
+            out[base + chunk] = cmd.handle();
+        }, maxChunks);
+    out.resize(base + chunks);
 }
 
 } // namespace finevk
@@ -0,0 +1,283 @@
+#include "finevk/engine/spatial_index.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace finevk {
+
+namespace {
+
+AABB combine(const AABB& a, const AABB& b) {
+    return AABB{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+}
+
+float surfaceArea(const AABB& box) {
+    glm::vec3 d = box.max - box.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+bool contains(const AABB& outer, const AABB& inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+           inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+} // namespace
+
+// ============================================================================
+// Node management
+// ============================================================================
+
+int32_t AABBTree::allocateNode() {
+    if (freeList_ == NullNode) {
+        nodes_.emplace_back();
+        nodes_.back().height = 0;
+        return static_cast<int32_t>(nodes_.size() - 1);
+    }
+
+    int32_t node = freeList_;
+    freeList_ = nodes_[node].parent;
+    nodes_[node] = Node{};
+    nodes_[node].height = 0;
+    return node;
+}
+
+void AABBTree::freeNode(int32_t node) {
+    nodes_[node].parent = freeList_;
+    nodes_[node].height = -1;
+    freeList_ = node;
+}
+
+void AABBTree::clear() {
+    nodes_.clear();
+    root_ = NullNode;
+    freeList_ = NullNode;
+    leafCount_ = 0;
+}
+
+// ============================================================================
+// Public operations
+// ============================================================================
+
+int32_t AABBTree::insert(const AABB& bounds, uint32_t userData) {
+    int32_t leaf = allocateNode();
+    glm::vec3 margin(margin_);
+    nodes_[leaf].bounds = AABB{bounds.min - margin, bounds.max + margin};
+    nodes_[leaf].userData = userData;
+    insertLeaf(leaf);
+    leafCount_++;
+    return leaf;
+}
+
+void AABBTree::remove(int32_t proxy) {
+    assert(proxy >= 0 && proxy < static_cast<int32_t>(nodes_.size()) && nodes_[proxy].isLeaf());
+    removeLeaf(proxy);
+    freeNode(proxy);
+    leafCount_--;
+}
+
+bool AABBTree::move(int32_t proxy, const AABB& bounds) {
+    if (contains(nodes_[proxy].bounds, bounds)) {
+        return false;  // Still inside the fat box
+    }
+
+    removeLeaf(proxy);
+    glm::vec3 margin(margin_);
+    nodes_[proxy].bounds = AABB{bounds.min - margin, bounds.max + margin};
+    insertLeaf(proxy);
+    return true;
+}
+
+AABBTree::Containment AABBTree::classify(const AABB& box, const std::array<glm::vec4, 6>& planes) {
+    bool inside = true;
+    for (const auto& plane : planes) {
+        // Positive vertex outside -> box outside; negative vertex outside -> straddles
+        glm::vec3 positive = box.min;
+        glm::vec3 negative = box.max;
+        if (plane.x >= 0) { positive.x = box.max.x; negative.x = box.min.x; }
+        if (plane.y >= 0) { positive.y = box.max.y; negative.y = box.min.y; }
+        if (plane.z >= 0) { positive.z = box.max.z; negative.z = box.min.z; }
+
+        glm::vec3 normal(plane);
+        if (glm::dot(normal, positive) + plane.w < 0) {
+            return Containment::Outside;
+        }
+        if (glm::dot(normal, negative) + plane.w < 0) {
+            inside = false;
+        }
+    }
+    return inside ? Containment::Inside : Containment::Intersects;
+}
+
+// ============================================================================
+// Tree maintenance
+// ============================================================================
+
+void AABBTree::insertLeaf(int32_t leaf) {
+    if (root_ == NullNode) {
+        root_ = leaf;
+        nodes_[root_].parent = NullNode;
+        return;
+    }
+
+    // Descend towards the sibling with the lowest surface-area cost
+    AABB leafBounds = nodes_[leaf].bounds;
+    int32_t index = root_;
+    while (!nodes_[index].isLeaf()) {
+        int32_t child1 = nodes_[index].child1;
+        int32_t child2 = nodes_[index].child2;
+
+        float area = surfaceArea(nodes_[index].bounds);
+        float combinedArea = surfaceArea(combine(nodes_[index].bounds, leafBounds));
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+        // Minimum cost of pushing the leaf further down
+        float inheritance = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int32_t child) {
+            AABB merged = combine(leafBounds, nodes_[child].bounds);
+            if (nodes_[child].isLeaf()) {
+                return surfaceArea(merged) + inheritance;
+            }
+            return surfaceArea(merged) - surfaceArea(nodes_[child].bounds) + inheritance;
+        };
+
+        float cost1 = childCost(child1);
+        float cost2 = childCost(child2);
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = nodes_[sibling].parent;
+    int32_t newParent = allocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].bounds = combine(leafBounds, nodes_[sibling].bounds);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].child1 = sibling;
+    nodes_[newParent].child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent == NullNode) {
+        root_ = newParent;
+    } else if (nodes_[oldParent].child1 == sibling) {
+        nodes_[oldParent].child1 = newParent;
+    } else {
+        nodes_[oldParent].child2 = newParent;
+    }
+
+    // Refit and rebalance up to the root
+    index = nodes_[leaf].parent;
+    while (index != NullNode) {
+        index = balance(index);
+        int32_t child1 = nodes_[index].child1;
+        int32_t child2 = nodes_[index].child2;
+        nodes_[index].height = 1 + std::max(nodes_[child1].height, nodes_[child2].height);
+        nodes_[index].bounds = combine(nodes_[child1].bounds, nodes_[child2].bounds);
+        index = nodes_[index].parent;
+    }
+}
+
+void AABBTree::removeLeaf(int32_t leaf) {
+    if (leaf == root_) {
+        root_ = NullNode;
+        return;
+    }
+
+    int32_t parent = nodes_[leaf].parent;
+    int32_t grandParent = nodes_[parent].parent;
+    int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent == NullNode) {
+        root_ = sibling;
+        nodes_[sibling].parent = NullNode;
+        freeNode(parent);
+        return;
+    }
+
+    // Replace the parent with the sibling
+    if (nodes_[grandParent].child1 == parent) {
+        nodes_[grandParent].child1 = sibling;
+    } else {
+        nodes_[grandParent].child2 = sibling;
+    }
+    nodes_[sibling].parent = grandParent;
+    freeNode(parent);
+
+    int32_t index = grandParent;
+    while (index != NullNode) {
+        index = balance(index);
+        int32_t child1 = nodes_[index].child1;
+        int32_t child2 = nodes_[index].child2;
+        nodes_[index].bounds = combine(nodes_[child1].bounds, nodes_[child2].bounds);
+        nodes_[index].height = 1 + std::max(nodes_[child1].height, nodes_[child2].height);
+        index = nodes_[index].parent;
+    }
+}
+
+int32_t AABBTree::balance(int32_t iA) {
+    // Rotate when one subtree is more than one level taller; returns the new subtree root
+    Node& A = nodes_[iA];
+    if (A.isLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    int32_t iB = A.child1;
+    int32_t iC = A.child2;
+    int32_t balanceFactor = nodes_[iC].height - nodes_[iB].height;
+
+    auto rotate = [this, iA](int32_t iUp, int32_t iOther, bool upIsChild2) {
+        // iUp (a child of A) becomes the parent of A
+        Node& up = nodes_[iUp];
+        int32_t iF = up.child1;
+        int32_t iG = up.child2;
+
+        up.child1 = iA;
+        up.parent = nodes_[iA].parent;
+        nodes_[iA].parent = iUp;
+
+        if (up.parent != NullNode) {
+            if (nodes_[up.parent].child1 == iA) {
+                nodes_[up.parent].child1 = iUp;
+            } else {
+                nodes_[up.parent].child2 = iUp;
+            }
+        } else {
+            root_ = iUp;
+        }
+
+        // Keep the taller grandchild under up; give the shorter one to A
+        int32_t keep = iF;
+        int32_t give = iG;
+        if (nodes_[iF].height < nodes_[iG].height) {
+            keep = iG;
+            give = iF;
+        }
+        up.child2 = keep;
+        if (upIsChild2) {
+            nodes_[iA].child2 = give;
+        } else {
+            nodes_[iA].child1 = give;
+        }
+        nodes_[give].parent = iA;
+
+        nodes_[iA].bounds = combine(nodes_[iOther].bounds, nodes_[give].bounds);
+        up.bounds = combine(nodes_[iA].bounds, nodes_[keep].bounds);
+        nodes_[iA].height = 1 + std::max(nodes_[iOther].height, nodes_[give].height);
+        up.height = 1 + std::max(nodes_[iA].height, nodes_[keep].height);
+        return iUp;
+    };
+
+    if (balanceFactor > 1 && !nodes_[iC].isLeaf()) {
+        return rotate(iC, iB, true);
+    }
+    if (balanceFactor < -1 && !nodes_[iB].isLeaf()) {
+        return rotate(iB, iC, false);
+    }
+    return iA;
+}
+
+} // namespace finevk
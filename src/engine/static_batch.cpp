@@ -0,0 +1,215 @@
+#include "finevk/engine/static_batch.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include <cfloat>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace finevk {
+
+// =============================================================================
+// StaticBatch::Builder
+// =============================================================================
+
+StaticBatch::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+StaticBatch::Builder& StaticBatch::Builder::clusterSize(float size) {
+    clusterSize_ = size > 0.0f ? size : 32.0f;
+    return *this;
+}
+
+StaticBatch::Builder& StaticBatch::Builder::maxClusterVertices(uint32_t count) {
+    maxClusterVertices_ = count ? count : 1;
+    return *this;
+}
+
+StaticBatch::Builder& StaticBatch::Builder::optimize(bool enable) {
+    optimize_ = enable;
+    return *this;
+}
+
+StaticBatch::Builder& StaticBatch::Builder::add(const Mesh::Builder& geometry, const Renderable& state) {
+    if (state.isTransparent) {
+        throw std::invalid_argument("StaticBatch: transparent renderables need per-object sorting");
+    }
+    if (!state.pipeline) {
+        throw std::invalid_argument("StaticBatch: renderable has no pipeline");
+    }
+    sources_.push_back({&geometry, state});
+    return *this;
+}
+
+StaticBatchPtr StaticBatch::Builder::merge(std::vector<Mesh::Builder>& clusters) const {
+    auto batch = StaticBatchPtr(new StaticBatch());
+    batch->sourceCount_ = sources_.size();
+
+    // Load each distinct load() builder once and measure its local bounds
+    struct Geometry {
+        const Mesh::Builder* builder;
+        AABB bounds;
+    };
+    std::unordered_map<const Mesh::Builder*, Mesh::Builder> loaded;
+    std::unordered_map<const Mesh::Builder*, Geometry> geometries;
+    auto resolve = [&](const Mesh::Builder* source) -> const Geometry& {
+        auto it = geometries.find(source);
+        if (it != geometries.end()) {
+            return it->second;
+        }
+        const Mesh::Builder* builder = source;
+        if (!source->loadPath_.empty() && source->vertices_.empty()) {
+            Mesh::Builder copy = *source;
+            copy.loadOBJ(copy.loadPath_);
+            builder = &loaded.emplace(source, std::move(copy)).first->second;
+        }
+        AABB bounds{glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX)};
+        for (const Vertex& v : builder->vertices_) {
+            bounds.min = glm::min(bounds.min, v.position);
+            bounds.max = glm::max(bounds.max, v.position);
+        }
+        return geometries.emplace(source, Geometry{builder, bounds}).first->second;
+    };
+
+    // State groups shared by every cluster drawn the same way
+    using StateKey = std::tuple<const GraphicsPipeline*, const GraphicsPipeline*,
+                                const PipelineLayout*, const Material*, uint32_t>;
+    std::map<StateKey, uint32_t> groups;
+
+    // Cluster currently filling per (group, grid cell)
+    using CellKey = std::tuple<uint32_t, int32_t, int32_t, int32_t>;
+    std::map<CellKey, size_t> openClusters;
+    std::vector<AABB> clusterBounds;
+
+    for (const Source& source : sources_) {
+        const Geometry& geometry = resolve(source.geometry);
+        const Mesh::Builder& mesh = *geometry.builder;
+        if (mesh.vertices_.empty() || mesh.indices_.empty()) {
+            FINEVK_WARN(LogCategory::Resource, "StaticBatch: skipping source without geometry");
+            continue;
+        }
+
+        const Renderable& state = source.state;
+        StateKey stateKey{state.pipeline, state.depthPipeline, state.pipelineLayout, state.material,
+                          static_cast<uint32_t>(mesh.attrs_)};
+        uint32_t group = groups.emplace(stateKey, static_cast<uint32_t>(groups.size())).first->second;
+
+        AABB world = geometry.bounds.transform(state.transform);
+        glm::vec3 cell = glm::floor(world.center() / clusterSize_);
+        CellKey cellKey{group, static_cast<int32_t>(cell.x), static_cast<int32_t>(cell.y),
+                        static_cast<int32_t>(cell.z)};
+
+        // Start a cluster for a new cell, or when the open one would overflow
+        auto open = openClusters.find(cellKey);
+        bool full = open != openClusters.end() && clusters[open->second].vertexCount() > 0 &&
+                    clusters[open->second].vertexCount() + mesh.vertices_.size() > maxClusterVertices_;
+        if (open == openClusters.end() || full) {
+            Mesh::Builder cluster(device_);
+            cluster.attributes(mesh.attrs_).optimize(optimize_);
+            clusters.push_back(std::move(cluster));
+            clusterBounds.push_back(world);
+
+            Renderable renderable;
+            renderable.material = state.material;
+            renderable.pipeline = state.pipeline;
+            renderable.depthPipeline = state.depthPipeline;
+            renderable.pipelineLayout = state.pipelineLayout;
+            batch->renderables_.push_back(renderable);
+
+            open = openClusters.insert_or_assign(cellKey, clusters.size() - 1).first;
+        }
+
+        size_t index = open->second;
+        Mesh::Builder& cluster = clusters[index];
+        AABB& bounds = clusterBounds[index];
+        bounds.min = glm::min(bounds.min, world.min);
+        bounds.max = glm::max(bounds.max, world.max);
+
+        // Bake the transform; mirroring flips winding and tangent handedness
+        const glm::mat4& transform = state.transform;
+        glm::mat3 linear(transform);
+        glm::mat3 normalMatrix = glm::inverseTranspose(linear);
+        bool mirrored = glm::determinant(linear) < 0.0f;
+
+        uint32_t base = static_cast<uint32_t>(cluster.vertexCount());
+        cluster.reserve(cluster.vertexCount() + mesh.vertices_.size(),
+                        cluster.indexCount() + mesh.indices_.size());
+        for (Vertex v : mesh.vertices_) {
+            v.position = glm::vec3(transform * glm::vec4(v.position, 1.0f));
+            glm::vec3 normal = normalMatrix * v.normal;
+            float normalLength = glm::length(normal);
+            v.normal = normalLength > 0.0f ? normal / normalLength : v.normal;
+            glm::vec3 tangent = linear * glm::vec3(v.tangent);
+            float tangentLength = glm::length(tangent);
+            if (tangentLength > 0.0f) {
+                v.tangent = glm::vec4(tangent / tangentLength, mirrored ? -v.tangent.w : v.tangent.w);
+            }
+            cluster.addVertex(v);
+        }
+
+        const auto& indices = mesh.indices_;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            if (mirrored) {
+                cluster.addTriangle(base + indices[i], base + indices[i + 2], base + indices[i + 1]);
+            } else {
+                cluster.addTriangle(base + indices[i], base + indices[i + 1], base + indices[i + 2]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < batch->renderables_.size(); i++) {
+        batch->renderables_[i].localBounds = clusterBounds[i];
+    }
+
+    FINEVK_DEBUG(LogCategory::Render, "StaticBatch: merged " + std::to_string(sources_.size()) +
+                 " objects into " + std::to_string(clusters.size()) + " clusters");
+    return batch;
+}
+
+StaticBatchPtr StaticBatch::Builder::build(CommandPool* commandPool) {
+    std::vector<Mesh::Builder> clusters;
+    auto batch = merge(clusters);
+
+    MeshBatch meshes(device_);
+    meshes.sharedBuffers();
+    for (auto& cluster : clusters) {
+        meshes.add(std::move(cluster));
+    }
+    batch->meshes_ = meshes.build(commandPool);
+    for (size_t i = 0; i < batch->meshes_.size(); i++) {
+        batch->renderables_[i].mesh = batch->meshes_[i].get();
+    }
+    return batch;
+}
+
+StaticBatchPtr StaticBatch::Builder::build(UploadManager& uploads) {
+    std::vector<Mesh::Builder> clusters;
+    auto batch = merge(clusters);
+
+    MeshBatch meshes(device_);
+    meshes.sharedBuffers();
+    for (auto& cluster : clusters) {
+        meshes.add(std::move(cluster));
+    }
+    batch->meshes_ = meshes.build(uploads);
+    batch->ticket_ = meshes.ticket();
+    for (size_t i = 0; i < batch->meshes_.size(); i++) {
+        batch->renderables_[i].mesh = batch->meshes_[i].get();
+    }
+    return batch;
+}
+
+// =============================================================================
+// StaticBatch
+// =============================================================================
+
+StaticBatch::Builder StaticBatch::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+} // namespace finevk
@@ -0,0 +1,370 @@
+#include "finevk/high/asset_loader.hpp"
+#include "finevk/high/texture_container.hpp"
+#include "finevk/high/format_utils.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/device/upload_manager.hpp"
+#include "finevk/core/thread_pool.hpp"
+#include "finevk/core/logging.hpp"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace finevk {
+
+// ============================================================================
+// AssetLoader::Builder implementation
+// ============================================================================
+
+AssetLoader::Builder::Builder(LogicalDevice* device, UploadManager* uploads)
+    : device_(device), uploads_(uploads) {
+}
+
+AssetLoader::Builder& AssetLoader::Builder::frameBudget(VkDeviceSize bytes) {
+    frameBudget_ = bytes;
+    return *this;
+}
+
+AssetLoader::Builder& AssetLoader::Builder::threads(ThreadPool* pool) {
+    threads_ = pool;
+    return *this;
+}
+
+AssetLoaderPtr AssetLoader::Builder::build() {
+    if (!device_ || !uploads_) {
+        throw std::runtime_error("AssetLoader requires a device and an UploadManager");
+    }
+
+    auto loader = AssetLoaderPtr(new AssetLoader());
+    loader->device_ = device_;
+    loader->uploads_ = uploads_;
+    loader->threads_ = threads_ ? threads_ : &ThreadPool::global();
+    loader->frameBudget_ = frameBudget_;
+    loader->inbox_ = std::make_shared<Inbox>();
+    return loader;
+}
+
+AssetLoader::Builder AssetLoader::create(LogicalDevice* device, UploadManager* uploads) {
+    return Builder(device, uploads);
+}
+
+// ============================================================================
+// AssetLoader implementation
+// ============================================================================
+
+AssetLoader::~AssetLoader() {
+    {
+        std::unique_lock<std::mutex> lock(inbox_->mutex);
+        inbox_->closed = true;
+        inbox_->prepared.clear();
+        // Jobs copying into images still use the device
+        inbox_->idle.wait(lock, [this] { return inbox_->hostCopies == 0; });
+    }
+
+    // Images and buffers must outlive their copies
+    for (auto& upload : uploading_) {
+        upload.ticket.wait();
+    }
+}
+
+AsyncTextureRef AssetLoader::load(const Texture::Builder& builder) {
+    auto target = std::make_shared<AsyncAsset<Texture>>();
+    pending_++;
+
+    bool fromFile = builder.sourceType_ == Texture::Builder::SourceType::File;
+    bool srgb = builder.srgb_;
+    bool generateMipmaps = builder.generateMipmaps_;
+    std::string path;
+    uint32_t width = builder.width_;
+    uint32_t height = builder.height_;
+    std::vector<uint8_t> pixels;
+    if (fromFile) {
+        path = builder.path_;
+        target->path_ = path;
+    } else if (builder.data_) {
+        // The caller's pointer need not outlive this call
+        const auto* data = static_cast<const uint8_t*>(builder.data_);
+        pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+    }
+
+    // The job owns its inbox reference, not the loader
+    std::shared_ptr<Inbox> inbox = inbox_;
+    LogicalDevice* device = device_;
+    threads_->submit([inbox, device, target, fromFile, path, width, height, srgb, generateMipmaps,
+                      pixels = std::move(pixels)]() mutable {
+        Prepared prepared;
+        prepared.texture = target;
+        prepared.width = width;
+        prepared.height = height;
+        bool hostCopy = false;
+
+        try {
+            if (fromFile && TextureContainer::isContainerPath(path)) {
+                // Baked mips as stored; generateMipmaps doesn't apply
+                auto container = TextureContainer::fromFile(path, srgb);
+                prepared.format = container.format;
+                prepared.width = container.width;
+                prepared.height = container.height;
+                for (uint32_t i = 0; i < container.mipLevels(); i++) {
+                    const uint8_t* level = container.levelData(i);
+                    prepared.mips.emplace_back(level, level + container.levels[i].size);
+                }
+            } else {
+                if (fromFile) {
+                    int w = 0, h = 0, channels = 0;
+                    stbi_uc* decoded = stbi_load(path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+                    if (!decoded) {
+                        throw std::runtime_error("Failed to load texture image: " + path);
+                    }
+                    prepared.width = static_cast<uint32_t>(w);
+                    prepared.height = static_cast<uint32_t>(h);
+                    pixels.assign(decoded, decoded + static_cast<size_t>(w) * h * 4);
+                    stbi_image_free(decoded);
+                } else if (pixels.empty() || width == 0 || height == 0) {
+                    throw std::runtime_error("Texture source has no pixels");
+                }
+
+                prepared.format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+                prepared.mips.push_back(std::move(pixels));
+
+                uint32_t w = prepared.width;
+                uint32_t h = prepared.height;
+                while (generateMipmaps && (w > 1 || h > 1)) {
+                    prepared.mips.push_back(downsampleRGBA8(prepared.mips.back(), w, h));
+                    w = std::max(1u, w / 2);
+                    h = std::max(1u, h / 2);
+                }
+            }
+            for (const auto& mip : prepared.mips) {
+                prepared.bytes += mip.size();
+            }
+
+            // Host image copy: fill the image here, update() only hands it out
+            if (canUploadFromHost(device, prepared.format)) {
+                {
+                    std::lock_guard<std::mutex> lock(inbox->mutex);
+                    if (inbox->closed) {
+                        return;
+                    }
+                    inbox->hostCopies++;
+                    hostCopy = true;
+                }
+                try {
+                    std::vector<const void*> levels;
+                    for (const auto& mip : prepared.mips) {
+                        levels.push_back(mip.data());
+                    }
+                    prepared.image = uploadFromHost(device, prepared.format,
+                                                    prepared.width, prepared.height, levels);
+                    prepared.mips.clear();
+                } catch (const std::exception& e) {
+                    FINEVK_WARN(LogCategory::Core, std::string("AssetLoader: host copy failed, ") +
+                                "falling back to the upload queue: " + e.what());
+                }
+            }
+        } catch (const std::exception& e) {
+            prepared.error = e.what();
+            prepared.mips.clear();
+        }
+
+        std::lock_guard<std::mutex> lock(inbox->mutex);
+        if (!inbox->closed) {
+            inbox->prepared.push_back(std::move(prepared));
+        }
+        if (hostCopy) {
+            prepared.image.reset();  // Dropped before the destructor can return
+            inbox->hostCopies--;
+            inbox->idle.notify_all();
+        }
+    });
+
+    return target;
+}
+
+AsyncMeshRef AssetLoader::load(const Mesh::Builder& builder) {
+    auto target = std::make_shared<AsyncAsset<Mesh>>();
+    target->path_ = builder.loadPath_;
+    pending_++;
+
+    // pack() loads and packs in place, so the job works on its own copy
+    auto copy = std::make_shared<Mesh::Builder>(builder);
+    std::shared_ptr<Inbox> inbox = inbox_;
+    threads_->submit([inbox, target, copy]() {
+        Prepared prepared;
+        prepared.mesh = target;
+        try {
+            prepared.packed = copy->pack();
+            prepared.bytes = prepared.packed.vertexBytes() + prepared.packed.indices.size() +
+                prepared.packed.meshlets.size() * sizeof(Mesh::GpuMeshlet) +
+                prepared.packed.meshletData.size() * sizeof(uint32_t);
+            prepared.builder = copy;
+        } catch (const std::exception& e) {
+            prepared.error = e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(inbox->mutex);
+        if (!inbox->closed) {
+            inbox->prepared.push_back(std::move(prepared));
+        }
+    });
+
+    return target;
+}
+
+void AssetLoader::update() {
+    // Mark finished uploads ready
+    for (size_t i = 0; i < uploading_.size();) {
+        if (uploading_[i].ticket.isComplete()) {
+            finish(uploading_[i]);
+            if (i + 1 != uploading_.size()) {
+                uploading_[i] = std::move(uploading_.back());
+            }
+            uploading_.pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(inbox_->mutex);
+        while (!inbox_->prepared.empty()) {
+            waiting_.push_back(std::move(inbox_->prepared.front()));
+            inbox_->prepared.pop_front();
+        }
+    }
+
+    // Queue uploads up to the budget, oldest first
+    VkDeviceSize spent = 0;
+    while (!waiting_.empty()) {
+        Prepared& next = waiting_.front();
+        if (next.error.empty() && next.texture && !canSample(next.format)) {
+            next.error = std::string("device can't sample ") + FormatUtils::formatName(next.format);
+        }
+        if (!next.error.empty()) {
+            fail(next);
+            waiting_.pop_front();
+            continue;
+        }
+        if (next.image) {
+            // Copied on the worker; nothing to upload
+            Upload upload;
+            upload.texture = std::move(next.texture);
+            upload.image = std::move(next.image);
+            finish(upload);
+            waiting_.pop_front();
+            continue;
+        }
+        if (spent > 0 && spent + next.bytes > frameBudget_) {
+            break;
+        }
+        spent += next.bytes;
+        startUpload(next);
+        waiting_.pop_front();
+    }
+    lastFrameBytes_ = spent;
+
+    if (spent > 0) {
+        SubmitTicket ticket = uploads_->flush();
+        for (auto& upload : uploading_) {
+            if (!upload.ticket.valid()) {
+                upload.ticket = ticket;
+            }
+        }
+    }
+}
+
+void AssetLoader::startUpload(Prepared& prepared) {
+    Upload upload;
+    if (prepared.texture) {
+        auto image = Image::create(device_)
+            .extent(prepared.width, prepared.height)
+            .format(prepared.format)
+            .usage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+            .mipLevels(static_cast<uint32_t>(prepared.mips.size()))
+            .memoryUsage(MemoryUsage::GpuOnly)
+            .build();
+
+        for (uint32_t level = 0; level < prepared.mips.size(); level++) {
+            const auto& mip = prepared.mips[level];
+            uploads_->uploadImage(*image, mip.data(), mip.size(), level);
+        }
+
+        upload.texture = std::move(prepared.texture);
+        upload.image = std::move(image);
+    } else {
+        upload.meshAsset = prepared.builder->upload(prepared.packed, *uploads_);
+        upload.mesh = std::move(prepared.mesh);
+    }
+    uploading_.push_back(std::move(upload));  // Ticket assigned after flush()
+}
+
+void AssetLoader::fail(Prepared& prepared) {
+    const std::string& path = prepared.texture ? prepared.texture->path_ : prepared.mesh->path_;
+    FINEVK_WARN(LogCategory::Core, "AssetLoader: failed to load " +
+                (path.empty() ? std::string("in-memory asset") : path) + ": " + prepared.error);
+
+    if (prepared.texture) {
+        prepared.texture->failed_ = true;
+        prepared.texture->error_ = std::move(prepared.error);
+        prepared.texture->callbacks_.clear();
+    } else {
+        prepared.mesh->failed_ = true;
+        prepared.mesh->error_ = std::move(prepared.error);
+        prepared.mesh->callbacks_.clear();
+    }
+    pending_--;
+}
+
+bool AssetLoader::canSample(VkFormat format) const {
+    auto* physical = device_->physicalDevice();
+    return physical->capabilities().supportsSampling(physical->handle(), format);
+}
+
+void AssetLoader::finish(Upload& upload) {
+    pending_--;
+
+    if (upload.texture) {
+        auto texture = TextureRef(new Texture());
+        texture->view_ = upload.image->createView(VK_IMAGE_ASPECT_COLOR_BIT);
+        texture->image_ = std::move(upload.image);
+
+        AsyncAsset<Texture>& target = *upload.texture;
+        target.asset_ = std::move(texture);
+        target.ready_ = true;
+        auto callbacks = std::move(target.callbacks_);
+        target.callbacks_.clear();
+        for (auto& callback : callbacks) {
+            callback(target.asset_);
+        }
+    } else {
+        AsyncAsset<Mesh>& target = *upload.mesh;
+        target.asset_ = std::move(upload.meshAsset);
+        target.ready_ = true;
+        auto callbacks = std::move(target.callbacks_);
+        target.callbacks_.clear();
+        for (auto& callback : callbacks) {
+            callback(target.asset_);
+        }
+    }
+}
+
+void AssetLoader::waitIdle() {
+    while (pending_ > 0) {
+        update();
+        if (pending_ == 0) {
+            break;
+        }
+        if (!uploading_.empty()) {
+            uploading_.front().ticket.wait();
+        } else {
+            std::this_thread::yield();  // Still loading
+        }
+    }
+}
+
+} // namespace finevk
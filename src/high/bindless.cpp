@@ -0,0 +1,266 @@
+#include "finevk/high/bindless.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/device/sampler.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/rendering/descriptors.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace finevk {
+
+// ============================================================================
+// BindlessTable::Builder implementation
+// ============================================================================
+
+BindlessTable::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+BindlessTable::Builder& BindlessTable::Builder::maxTextures(uint32_t count) {
+    maxTextures_ = count;
+    return *this;
+}
+
+BindlessTable::Builder& BindlessTable::Builder::materials(VkDeviceSize stride, uint32_t count) {
+    materialStride_ = stride;
+    maxMaterials_ = count;
+    return *this;
+}
+
+BindlessTable::Builder& BindlessTable::Builder::stages(VkShaderStageFlags stages) {
+    stages_ = stages;
+    return *this;
+}
+
+BindlessTablePtr BindlessTable::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("BindlessTable requires a device");
+    }
+
+    const auto& enabled = device_->enabledVulkan12Features();
+    if (!enabled.descriptorIndexing || !enabled.runtimeDescriptorArray ||
+        !enabled.descriptorBindingPartiallyBound ||
+        !enabled.descriptorBindingSampledImageUpdateAfterBind) {
+        throw std::runtime_error(
+            "BindlessTable requires descriptor indexing (LogicalDeviceBuilder::enableDescriptorIndexing)");
+    }
+    if (maxTextures_ == 0) {
+        throw std::runtime_error("BindlessTable requires at least one texture slot");
+    }
+    if (maxMaterials_ > 0 && materialStride_ == 0) {
+        throw std::runtime_error("BindlessTable requires a non-zero material stride");
+    }
+
+    // Update-after-bind limits live in the Vulkan 1.2 properties
+    VkPhysicalDeviceVulkan12Properties props12{};
+    props12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 props2{};
+    props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props2.pNext = &props12;
+    vkGetPhysicalDeviceProperties2(device_->physicalDevice()->handle(), &props2);
+
+    uint32_t limit = std::min({props12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                               props12.maxPerStageDescriptorUpdateAfterBindSamplers,
+                               props12.maxDescriptorSetUpdateAfterBindSampledImages,
+                               props12.maxDescriptorSetUpdateAfterBindSamplers});
+    uint32_t textures = maxTextures_;
+    if (limit > 0 && textures > limit) {
+        FINEVK_WARN(LogCategory::Core, "BindlessTable: clamping " + std::to_string(textures) +
+                    " texture slots to the device limit of " + std::to_string(limit));
+        textures = limit;
+    }
+
+    auto table = BindlessTablePtr(new BindlessTable());
+    table->device_ = device_;
+    table->maxTextures_ = textures;
+    table->textureUsed_.assign(textures, false);
+
+    VkDescriptorBindingFlags textureFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    if (enabled.descriptorBindingUpdateUnusedWhilePending) {
+        textureFlags |= VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    }
+
+    auto layoutBuilder = DescriptorSetLayout::create(device_)
+        .combinedImageSampler(0, stages_, textures)
+        .bindingFlags(0, textureFlags)
+        .updateAfterBindPool();
+    if (maxMaterials_ > 0) {
+        layoutBuilder.storageBuffer(1, stages_);
+    }
+    table->layout_ = layoutBuilder.build();
+
+    table->pool_ = DescriptorPool::fromLayout(table->layout_.get(), 1)
+        .updateAfterBind()
+        .build();
+    table->set_ = table->pool_->allocate(table->layout_.get());
+
+    if (maxMaterials_ > 0) {
+        VkDeviceSize size = materialStride_ * maxMaterials_;
+        const auto& limits = device_->physicalDevice()->capabilities().properties.limits;
+        if (size > limits.maxStorageBufferRange) {
+            throw std::runtime_error("BindlessTable: material buffer exceeds maxStorageBufferRange");
+        }
+
+        table->materialStride_ = materialStride_;
+        table->maxMaterials_ = maxMaterials_;
+        table->materialUsed_.assign(maxMaterials_, false);
+        table->materialBuffer_ = Buffer::create(device_)
+            .size(size)
+            .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+            .memoryUsage(MemoryUsage::CpuToGpu)
+            .build();
+        table->materialData_ = static_cast<uint8_t*>(table->materialBuffer_->map());
+        std::memset(table->materialData_, 0, static_cast<size_t>(size));
+
+        DescriptorWriter(device_)
+            .writeBuffer(table->set_, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                         table->materialBuffer_->handle(), 0, size)
+            .update();
+    }
+
+    return table;
+}
+
+BindlessTable::Builder BindlessTable::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+// ============================================================================
+// BindlessTable implementation
+// ============================================================================
+
+BindlessTable::~BindlessTable() = default;
+
+uint32_t BindlessTable::addTexture(ImageView* view, Sampler* sampler, VkImageLayout layout) {
+    if (!view || !sampler) {
+        throw std::runtime_error("BindlessTable::addTexture requires a view and a sampler");
+    }
+
+    uint32_t index;
+    if (!freeTextures_.empty()) {
+        index = freeTextures_.back();
+        freeTextures_.pop_back();
+    } else if (nextTexture_ < maxTextures_) {
+        index = nextTexture_++;
+    } else {
+        throw std::runtime_error("BindlessTable: texture array full (" +
+                                 std::to_string(maxTextures_) + " slots)");
+    }
+
+    writeTexture(index, view, sampler, layout);
+    textureUsed_[index] = true;
+    textureCount_++;
+    return index;
+}
+
+void BindlessTable::updateTexture(uint32_t index, ImageView* view, Sampler* sampler,
+                                  VkImageLayout layout) {
+    if (index >= nextTexture_ || !textureUsed_[index] || !view || !sampler) {
+        throw std::runtime_error("BindlessTable::updateTexture: invalid slot or resource");
+    }
+    writeTexture(index, view, sampler, layout);
+}
+
+void BindlessTable::removeTexture(uint32_t index) {
+    if (index >= nextTexture_ || !textureUsed_[index]) {
+        throw std::runtime_error("BindlessTable::removeTexture: slot " + std::to_string(index) +
+                                 " is not in use");
+    }
+    // The stale descriptor stays until reuse; PARTIALLY_BOUND allows that while unused
+    textureUsed_[index] = false;
+    freeTextures_.push_back(index);
+    textureCount_--;
+}
+
+void BindlessTable::releaseTexture(uint32_t index) noexcept {
+    if (index >= nextTexture_ || !textureUsed_[index]) {
+        FINEVK_WARN(LogCategory::Core, "BindlessTable: texture slot " + std::to_string(index) +
+                    " released but not in use (removed twice?)");
+        return;
+    }
+    textureUsed_[index] = false;
+    freeTextures_.push_back(index);
+    textureCount_--;
+}
+
+void BindlessTable::writeTexture(uint32_t index, ImageView* view, Sampler* sampler,
+                                 VkImageLayout layout) {
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = sampler->handle();
+    imageInfo.imageView = view->handle();
+    imageInfo.imageLayout = layout;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set_;
+    write.dstBinding = 0;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(device_->handle(), 1, &write, 0, nullptr);
+}
+
+uint32_t BindlessTable::addMaterial(const void* data, VkDeviceSize size) {
+    if (!materialData_) {
+        throw std::runtime_error("BindlessTable: no material buffer configured");
+    }
+    if (size > materialStride_) {
+        throw std::runtime_error("BindlessTable::addMaterial: parameters exceed the stride");
+    }
+
+    uint32_t index;
+    if (!freeMaterials_.empty()) {
+        index = freeMaterials_.back();
+        freeMaterials_.pop_back();
+    } else if (nextMaterial_ < maxMaterials_) {
+        index = nextMaterial_++;
+    } else {
+        throw std::runtime_error("BindlessTable: material buffer full (" +
+                                 std::to_string(maxMaterials_) + " slots)");
+    }
+
+    materialUsed_[index] = true;
+    updateMaterial(index, data, size);
+    return index;
+}
+
+void BindlessTable::updateMaterial(uint32_t index, const void* data, VkDeviceSize size) {
+    if (index >= nextMaterial_ || !materialUsed_[index] || size > materialStride_) {
+        throw std::runtime_error("BindlessTable::updateMaterial: invalid slot or size");
+    }
+    std::memcpy(materialData_ + index * materialStride_, data, static_cast<size_t>(size));
+}
+
+void BindlessTable::removeMaterial(uint32_t index) {
+    if (index >= nextMaterial_ || !materialUsed_[index]) {
+        throw std::runtime_error("BindlessTable::removeMaterial: slot " + std::to_string(index) +
+                                 " is not in use");
+    }
+    materialUsed_[index] = false;
+    freeMaterials_.push_back(index);
+}
+
+void BindlessTable::releaseMaterial(uint32_t index) noexcept {
+    if (index >= nextMaterial_ || !materialUsed_[index]) {
+        FINEVK_WARN(LogCategory::Core, "BindlessTable: material slot " + std::to_string(index) +
+                    " released but not in use (removed twice?)");
+        return;
+    }
+    materialUsed_[index] = false;
+    freeMaterials_.push_back(index);
+}
+
+void BindlessTable::bind(CommandBuffer& cmd, VkPipelineLayout pipelineLayout,
+                         uint32_t setIndex) const {
+    cmd.bindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, setIndex, {set_});
+}
+
+} // namespace finevk
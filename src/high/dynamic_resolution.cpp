@@ -0,0 +1,285 @@
+#include "finevk/high/dynamic_resolution.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/device/gpu_profiler.hpp"
+#include "finevk/rendering/swapchain.hpp"
+#include "finevk/window/window.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+// Weight of each new timing in the smoothed full resolution cost
+constexpr double CostSmoothing = 0.1;
+
+// Aim slightly below the target so noise doesn't push frames over it
+constexpr double Headroom = 0.95;
+
+// Smallest scale change worth a visible resolution switch
+constexpr float ScaleThreshold = 0.02f;
+
+} // anonymous namespace
+
+// ============================================================================
+// DynamicResolution::Builder implementation
+// ============================================================================
+
+DynamicResolution::Builder::Builder(Window* window)
+    : window_(window) {
+}
+
+DynamicResolution::Builder& DynamicResolution::Builder::scaleRange(float minScale, float maxScale) {
+    minScale_ = minScale;
+    maxScale_ = maxScale;
+    return *this;
+}
+
+DynamicResolution::Builder& DynamicResolution::Builder::targetFrameTime(double milliseconds) {
+    targetMilliseconds_ = milliseconds;
+    return *this;
+}
+
+DynamicResolution::Builder& DynamicResolution::Builder::colorFormat(VkFormat format) {
+    colorFormat_ = format;
+    return *this;
+}
+
+DynamicResolution::Builder& DynamicResolution::Builder::enableDepth() {
+    enableDepth_ = true;
+    depthFormat_ = VK_FORMAT_UNDEFINED;  // RenderTarget picks the default
+    return *this;
+}
+
+DynamicResolution::Builder& DynamicResolution::Builder::depthFormat(VkFormat format) {
+    enableDepth_ = true;
+    depthFormat_ = format;
+    return *this;
+}
+
+DynamicResolution::Builder& DynamicResolution::Builder::dynamicRendering(bool enable) {
+    dynamicRendering_ = enable;
+    return *this;
+}
+
+DynamicResolutionPtr DynamicResolution::Builder::build() {
+    if (!window_ || !window_->device() || !window_->swapChain()) {
+        throw std::runtime_error("DynamicResolution requires a window with a bound device");
+    }
+    if (!(minScale_ > 0.0f) || minScale_ > maxScale_ || maxScale_ > 1.0f) {
+        throw std::runtime_error("DynamicResolution scale range must satisfy 0 < min <= max <= 1");
+    }
+
+    LogicalDevice* device = window_->device();
+    SwapChain* swapChain = window_->swapChain();
+    if (!(swapChain->imageUsage() & VK_IMAGE_USAGE_TRANSFER_DST_BIT)) {
+        throw std::runtime_error("DynamicResolution needs swap chain images with transfer destination usage");
+    }
+
+    auto resolution = DynamicResolutionPtr(new DynamicResolution());
+    resolution->device_ = device;
+    resolution->window_ = window_;
+    resolution->colorFormat_ = colorFormat_ != VK_FORMAT_UNDEFINED ? colorFormat_ : swapChain->format().format;
+    resolution->depthFormat_ = depthFormat_;
+    resolution->enableDepth_ = enableDepth_;
+    resolution->dynamicRendering_ = dynamicRendering_;
+    resolution->minScale_ = minScale_;
+    resolution->maxScale_ = maxScale_;
+    resolution->scale_ = maxScale_;
+    resolution->targetMilliseconds_ = targetMilliseconds_;
+    std::fill(std::begin(resolution->scaleHistory_), std::end(resolution->scaleHistory_), maxScale_);
+
+    // vkCmdBlitImage needs blit support on both formats; linear filtering
+    // is optional for the source
+    VkFormatProperties source{};
+    VkFormatProperties destination{};
+    VkPhysicalDevice physical = device->physicalDevice()->handle();
+    vkGetPhysicalDeviceFormatProperties(physical, resolution->colorFormat_, &source);
+    vkGetPhysicalDeviceFormatProperties(physical, swapChain->format().format, &destination);
+    if (!(source.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT) ||
+        !(destination.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT)) {
+        throw std::runtime_error("DynamicResolution formats don't support blits");
+    }
+    if (!(source.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+        FINEVK_WARN(LogCategory::Render, "DynamicResolution color format can't be filtered, upscaling with nearest");
+        resolution->filter_ = VK_FILTER_NEAREST;
+    }
+
+    resolution->createTarget();
+    return resolution;
+}
+
+// ============================================================================
+// DynamicResolution implementation
+// ============================================================================
+
+DynamicResolution::Builder DynamicResolution::create(Window* window) {
+    return Builder(window);
+}
+
+DynamicResolution::~DynamicResolution() = default;
+
+void DynamicResolution::createTarget() {
+    extent_ = window_->swapChain()->extent();
+
+    colorImage_ = Image::create(device_)
+        .extent(extent_.width, extent_.height)
+        .format(colorFormat_)
+        .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+               VK_IMAGE_USAGE_SAMPLED_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+
+    auto builder = RenderTarget::create(device_)
+        .colorAttachment(colorImage_.get())
+        .dynamicRendering(dynamicRendering_);
+    if (enableDepth_) {
+        if (depthFormat_ != VK_FORMAT_UNDEFINED) {
+            builder.depthFormat(depthFormat_);
+        } else {
+            builder.enableDepth();
+        }
+    }
+    target_ = builder.build();
+    target_->setRenderScale(scale_);
+}
+
+void DynamicResolution::update(double gpuMilliseconds) {
+    if (!(gpuMilliseconds > 0.0) || !(targetMilliseconds_ > 0.0)) {
+        return;
+    }
+
+    // The timing belongs to the frame begun framesInFlight frames ago
+    uint64_t lag = std::max(device_->framesInFlight(), 1u);
+    float measuredScale = frameCount_ >= lag ? scaleHistory_[(frameCount_ - lag) % ScaleHistory] : scale_;
+    double fullCost = gpuMilliseconds / (static_cast<double>(measuredScale) * measuredScale);
+    fullCostMilliseconds_ = fullCostMilliseconds_ > 0.0 ?
+        fullCostMilliseconds_ + (fullCost - fullCostMilliseconds_) * CostSmoothing : fullCost;
+
+    float desired = static_cast<float>(std::sqrt(targetMilliseconds_ * Headroom / fullCostMilliseconds_));
+    desired = std::clamp(desired, minScale_, maxScale_);
+
+    // Small corrections are skipped, except to settle on a range bound
+    bool atBound = desired == minScale_ || desired == maxScale_;
+    if (std::abs(desired - scale_) >= ScaleThreshold || (atBound && desired != scale_)) {
+        scale_ = desired;
+    }
+}
+
+void DynamicResolution::update(const GpuProfiler& profiler) {
+    const GpuFrameTimings& timings = profiler.results();
+    if (timings.frame == 0 || timings.frame == profilerFrame_) {
+        return;
+    }
+    profilerFrame_ = timings.frame;
+    update(timings.totalMilliseconds);
+}
+
+void DynamicResolution::setScale(float scale) {
+    scale_ = std::clamp(scale, minScale_, maxScale_);
+}
+
+void DynamicResolution::begin(CommandBuffer& cmd, const ClearColor& clearColor, float clearDepth) {
+    VkExtent2D windowExtent = window_->swapChain()->extent();
+    if (windowExtent.width != extent_.width || windowExtent.height != extent_.height) {
+        // Frames in flight may still render to or blit from the old images
+        struct Retired {
+            RenderTargetPtr target;  // Destroyed first
+            ImagePtr colorImage;
+        };
+        auto retired = std::make_shared<Retired>();
+        retired->target = std::move(target_);
+        retired->colorImage = std::move(colorImage_);
+        window_->retire([retired]() mutable { retired.reset(); });
+        createTarget();
+        FINEVK_DEBUG(LogCategory::Render, "DynamicResolution target recreated");
+    }
+
+    scaleHistory_[frameCount_ % ScaleHistory] = scale_;
+    frameCount_++;
+
+    target_->setRenderScale(scale_);
+    target_->begin(cmd, clearColor, clearDepth);
+}
+
+void DynamicResolution::end(CommandBuffer& cmd) {
+    target_->end(cmd);
+}
+
+void DynamicResolution::upscale(CommandBuffer& cmd) {
+    SwapChain* swapChain = window_->swapChain();
+    uint32_t imageIndex = window_->currentImageIndex();
+    if (!swapChain || imageIndex >= swapChain->images().size()) {
+        throw std::runtime_error("No swap chain image available for DynamicResolution::upscale()");
+    }
+    VkImage swapImage = swapChain->images()[imageIndex];
+    VkExtent2D swapExtent = swapChain->extent();
+    VkExtent2D source = target_->renderExtent();
+
+    VkImageMemoryBarrier barriers[2]{};
+    for (auto& barrier : barriers) {
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    }
+
+    // Scene color into the blit; the swap chain image's old contents are
+    // discarded (the source stage chains with the acquire semaphore wait)
+    barriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].image = colorImage_->handle();
+    barriers[1].srcAccessMask = 0;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].image = swapImage;
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        0, {}, {}, {barriers[0], barriers[1]});
+
+    VkImageBlit blit{};
+    blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.srcOffsets[1] = {static_cast<int32_t>(source.width), static_cast<int32_t>(source.height), 1};
+    blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.dstOffsets[1] = {static_cast<int32_t>(swapExtent.width), static_cast<int32_t>(swapExtent.height), 1};
+    vkCmdBlitImage(cmd.handle(),
+                   colorImage_->handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   swapImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   1, &blit, filter_);
+
+    // Back to the layouts the render targets expect; a UI pass resumed on
+    // the window target loads the blitted image
+    barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                        0, {}, {}, {barriers[0], barriers[1]});
+}
+
+VkExtent2D DynamicResolution::renderExtent() const {
+    return target_->renderExtent();
+}
+
+float DynamicResolution::uvScaleX() const {
+    return static_cast<float>(target_->renderExtent().width) / static_cast<float>(extent_.width);
+}
+
+float DynamicResolution::uvScaleY() const {
+    return static_cast<float>(target_->renderExtent().height) / static_cast<float>(extent_.height);
+}
+
+} // namespace finevk
@@ -0,0 +1,275 @@
+#include "finevk/high/headless_renderer.hpp"
+#include "finevk/core/logging.hpp"
+#include "finevk/core/profiler.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/gpu_profiler.hpp"
+#include "finevk/device/submit_batch.hpp"
+#include "finevk/high/image_readback.hpp"
+#include "finevk/rendering/render_target.hpp"
+#include "finevk/rendering/sync.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace finevk {
+
+std::unique_ptr<HeadlessRenderer> HeadlessRenderer::create(
+    LogicalDevice* device, uint32_t width, uint32_t height,
+    const RendererConfig& config, VkFormat colorFormat) {
+
+    if (!device) {
+        throw std::runtime_error("HeadlessRenderer::create: device cannot be null");
+    }
+    if (width == 0 || height == 0) {
+        throw std::runtime_error("HeadlessRenderer::create: extent must be non-zero");
+    }
+
+    auto renderer = std::unique_ptr<HeadlessRenderer>(new HeadlessRenderer());
+    renderer->device_ = device;
+    renderer->config_ = config;
+    renderer->extent_ = {width, height};
+    renderer->colorFormat_ = colorFormat;
+
+    if (config.msaa != MSAALevel::Off) {
+        FINEVK_DEBUG(LogCategory::Core, "HeadlessRenderer renders without MSAA");
+    }
+
+    // Every slot up to the maximum, so frames in flight can change at runtime
+    uint32_t slots = device->maxFramesInFlight();
+    renderer->slots_.resize(slots);
+    for (auto& slot : renderer->slots_) {
+        slot.color = Image::create(device)
+            .extent(width, height)
+            .format(colorFormat)
+            .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                   VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                   VK_IMAGE_USAGE_SAMPLED_BIT)
+            .memoryUsage(MemoryUsage::GpuOnly)
+            .build();
+
+        auto builder = RenderTarget::create(device).colorAttachment(slot.color.get());
+        if (config.enableDepthBuffer) {
+            builder.enableDepth();
+        }
+        slot.target = builder.build();
+        slot.fence = std::make_unique<Fence>(device, true);  // Start signaled
+
+        if (!config.frameCommandPools) {
+            slot.cmd = device->defaultCommandPool()->allocate();
+        }
+    }
+
+    if (config.frameCommandPools) {
+        renderer->framePools_ = std::make_unique<FrameCommandPools>(
+            device, device->graphicsQueue(), slots, std::max(1u, config.recordingThreads));
+    }
+
+    renderer->frameSubmit_ = std::make_unique<SubmitBatch>(device->graphicsQueue());
+
+    if (config.gpuProfiling || config.pipelineStatistics) {
+        renderer->gpuProfiler_ = GpuProfiler::create(device)
+            .framesInFlight(slots)
+            .pipelineStatistics(config.pipelineStatistics)
+            .build();
+    }
+
+    renderer->deviceDestructionCallbackId_ = device->onDestruction(
+        [r = renderer.get()](LogicalDevice*) {
+            r->framePools_.reset();
+            r->gpuProfiler_.reset();
+            r->readback_.reset();
+            r->frameSubmit_.reset();
+            r->frameCmd_ = nullptr;
+            r->slots_.clear();
+            r->device_ = nullptr;
+            r->deviceDestructionCallbackId_ = 0;
+            FINEVK_DEBUG(LogCategory::Core, "HeadlessRenderer resources released (device destroying)");
+        });
+
+    FINEVK_INFO(LogCategory::Core, "HeadlessRenderer created: " +
+        std::to_string(width) + "x" + std::to_string(height) + ", " +
+        std::to_string(slots) + " frame slots");
+
+    return renderer;
+}
+
+RenderPass* HeadlessRenderer::renderPass() const {
+    return slots_.empty() ? nullptr : slots_[0].target->renderPass();
+}
+
+RenderTarget* HeadlessRenderer::renderTarget() const {
+    return slots_.empty() ? nullptr : slots_[currentSlot_].target.get();
+}
+
+Image* HeadlessRenderer::colorImage(uint32_t slot) const {
+    return slot < slots_.size() ? slots_[slot].color.get() : nullptr;
+}
+
+VkFormat HeadlessRenderer::depthFormat() const {
+    return slots_.empty() ? VK_FORMAT_UNDEFINED : slots_[0].target->depthFormat();
+}
+
+FrameBeginResult HeadlessRenderer::beginFrame() {
+    if (frameInProgress_) {
+        throw std::runtime_error("HeadlessRenderer::beginFrame called while a frame is in progress");
+    }
+
+    FrameBeginResult result{};
+
+    // The virtual frame ring: slots advance in order, wrapping at the
+    // current frames in flight
+    currentSlot_ = static_cast<uint32_t>(frameCount_ % framesInFlight());
+    Slot& slot = slots_[currentSlot_];
+    {
+        FINEVK_PROFILE_SCOPE("HeadlessRenderer::waitFence");
+        slot.fence->wait();
+    }
+    slot.fence->reset();
+
+    if (framePools_) {
+        framePools_->beginFrame(currentSlot_);
+        extraPrimaries_.clear();
+        frameCmd_ = &framePools_->acquire(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        frameCmd_->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    } else {
+        frameCmd_ = slot.cmd.get();
+        frameCmd_->reset();
+        frameCmd_->begin();
+    }
+    auto& cmd = *frameCmd_;
+
+    if (gpuProfiler_) {
+        gpuProfiler_->beginFrame(cmd, currentSlot_);
+        cmd.setProfiler(gpuProfiler_.get());
+    }
+    if (readback_) {
+        readback_->beginFrame(currentSlot_);
+    }
+
+    result.success = true;
+    result.imageIndex = currentSlot_;
+    result.commandBuffer = &cmd;
+    frameInProgress_ = true;
+
+    return result;
+}
+
+void HeadlessRenderer::beginRenderPass(const glm::vec4& clearColor) {
+    if (!frameInProgress_) {
+        return;
+    }
+    slots_[currentSlot_].target->begin(*frameCmd_,
+        ClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a));
+}
+
+void HeadlessRenderer::endRenderPass() {
+    if (!frameInProgress_) {
+        return;
+    }
+    slots_[currentSlot_].target->end(*frameCmd_);
+}
+
+bool HeadlessRenderer::endFrame() {
+    if (!frameInProgress_) {
+        return false;
+    }
+
+    auto& cmd = *frameCmd_;
+    if (gpuProfiler_) {
+        gpuProfiler_->endFrame(cmd);
+        cmd.setProfiler(nullptr);
+    }
+    cmd.end();
+
+    frameStats_.commands = framePools_ ? framePools_->stats() : cmd.stats();
+    if (gpuProfiler_) {
+        const auto& timings = gpuProfiler_->results();
+        frameStats_.gpuMilliseconds = timings.totalMilliseconds;
+        frameStats_.pipeline = timings.pipeline;
+        frameStats_.hasPipelineStatistics = timings.hasPipelineStatistics;
+    }
+
+    // Same single submission as SimpleRenderer, minus the swap chain semaphores
+    SubmitBatch& batch = *frameSubmit_;
+    batch.next();
+    for (size_t i = 0; i < frameWaits_.size(); i++) {
+        batch.wait(frameWaits_[i], frameWaitStages_[i]);
+    }
+    for (VkCommandBuffer primary : extraPrimaries_) {
+        batch.add(primary);
+    }
+    batch.add(cmd).fence(slots_[currentSlot_].fence->handle());
+    lastFrameValue_ = batch.submit();
+
+    frameInProgress_ = false;
+    frameCmd_ = nullptr;
+    extraPrimaries_.clear();
+    frameWaits_.clear();
+    frameWaitStages_.clear();
+    frameCount_++;
+
+    return true;
+}
+
+ImageReadback& HeadlessRenderer::readback() {
+    if (!readback_) {
+        readback_ = ImageReadback::create(device_).framesInFlight(maxFramesInFlight()).build();
+        if (frameInProgress_) {
+            readback_->beginFrame(currentSlot_);
+        }
+    }
+    return *readback_;
+}
+
+CommandBuffer& HeadlessRenderer::acquireCommandBuffer(uint32_t thread, VkCommandBufferLevel level) {
+    if (!framePools_) {
+        throw std::runtime_error("HeadlessRenderer::acquireCommandBuffer requires RendererConfig::frameCommandPools");
+    }
+    if (!frameInProgress_) {
+        throw std::runtime_error("HeadlessRenderer::acquireCommandBuffer called outside a frame");
+    }
+
+    CommandBuffer& cmd = framePools_->acquire(thread, level);
+    if (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY) {
+        extraPrimaries_.push_back(cmd.handle());
+    }
+    return cmd;
+}
+
+void HeadlessRenderer::waitFor(const TimelinePoint& point, VkPipelineStageFlags2KHR stages) {
+    if (!frameInProgress_) {
+        throw std::runtime_error("HeadlessRenderer::waitFor called outside a frame");
+    }
+    frameWaits_.push_back(point);
+    frameWaitStages_.push_back(stages);
+}
+
+SubmitBatch& HeadlessRenderer::submission() {
+    if (!frameInProgress_) {
+        throw std::runtime_error("HeadlessRenderer::submission called outside a frame");
+    }
+    return *frameSubmit_;
+}
+
+void HeadlessRenderer::waitIdle() {
+    for (uint32_t i = 0; i < slots_.size(); i++) {
+        // The recording frame's fence was reset and won't signal until endFrame()
+        if (!(frameInProgress_ && i == currentSlot_)) {
+            slots_[i].fence->wait();
+        }
+    }
+}
+
+HeadlessRenderer::~HeadlessRenderer() {
+    if (device_) {
+        if (deviceDestructionCallbackId_ != 0) {
+            device_->removeDestructionCallback(deviceDestructionCallbackId_);
+            deviceDestructionCallbackId_ = 0;
+        }
+        device_->waitIdle();
+    }
+}
+
+} // namespace finevk
@@ -0,0 +1,301 @@
+#include "finevk/high/image_readback.hpp"
+#include "finevk/high/format_utils.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/rendering/render_target.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+// Bytes per texel of the aspect a depth/stencil copy writes to the buffer
+uint32_t copyTexelSize(VkFormat format, VkImageAspectFlags aspect) {
+    if (aspect == VK_IMAGE_ASPECT_DEPTH_BIT) {
+        return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_D16_UNORM_S8_UINT ? 2 : 4;
+    }
+    return FormatUtils::bytesPerPixel(format);
+}
+
+// Where an image in this layout was last written, for the barrier into the copy
+void layoutAccess(VkImageLayout layout, VkPipelineStageFlags& stage, VkAccessFlags& access) {
+    switch (layout) {
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+            stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            break;
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+            stage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            break;
+        default:
+            stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            access = VK_ACCESS_MEMORY_WRITE_BIT;
+            break;
+    }
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// ImageReadback::Builder implementation
+// ============================================================================
+
+ImageReadback::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+ImageReadback::Builder& ImageReadback::Builder::initialSize(VkDeviceSize bytes) {
+    initialSize_ = bytes;
+    return *this;
+}
+
+ImageReadback::Builder& ImageReadback::Builder::framesInFlight(uint32_t count) {
+    framesInFlight_ = count;
+    return *this;
+}
+
+ImageReadbackPtr ImageReadback::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("ImageReadback requires a device");
+    }
+
+    auto readback = ImageReadbackPtr(new ImageReadback());
+    readback->device_ = device_;
+    readback->slots_.resize(framesInFlight_ != 0 ? framesInFlight_ : device_->maxFramesInFlight());
+    if (initialSize_ > 0) {
+        for (auto& slot : readback->slots_) {
+            slot.buffer = readback->createBuffer(initialSize_);
+        }
+    }
+    return readback;
+}
+
+ImageReadback::Builder ImageReadback::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+// ============================================================================
+// ImageReadback implementation
+// ============================================================================
+
+BufferPtr ImageReadback::createBuffer(VkDeviceSize size) const {
+    return Buffer::create(device_)
+        .size(size)
+        .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuToCpu)
+        .build();
+}
+
+void ImageReadback::deliver(Slot& slot) {
+    // Callbacks may start new readbacks, so take the list first
+    std::vector<Request> requests;
+    requests.swap(slot.requests);
+    for (auto& request : requests) {
+        request.buffer->invalidate(request.offset, request.size);
+        ReadbackView view;
+        view.data = static_cast<const uint8_t*>(request.buffer->mappedPtr()) + request.offset;
+        view.size = request.size;
+        view.extent = request.extent;
+        view.format = request.format;
+        view.rowPitch = request.rowPitch;
+        if (request.callback) {
+            request.callback(view);
+        }
+    }
+    slot.outgrown.clear();
+    slot.used = 0;
+}
+
+void ImageReadback::beginFrame(uint32_t frameIndex) {
+    Slot& slot = slots_[frameIndex % slots_.size()];
+    deliver(slot);
+    current_ = &slot;
+}
+
+void ImageReadback::read(CommandBuffer& cmd, Image& image, VkImageLayout layout,
+                         const VkRect2D& region, Callback callback) {
+    if (!current_) {
+        throw std::runtime_error("ImageReadback::read called before beginFrame");
+    }
+    if (!(image.usage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+        throw std::runtime_error("ImageReadback::read requires an image with TRANSFER_SRC usage");
+    }
+    if (image.samples() != VK_SAMPLE_COUNT_1_BIT) {
+        throw std::runtime_error("ImageReadback::read cannot copy a multisampled image");
+    }
+
+    // Clamp the region to the image
+    int32_t x = std::clamp(region.offset.x, 0, static_cast<int32_t>(image.width()));
+    int32_t y = std::clamp(region.offset.y, 0, static_cast<int32_t>(image.height()));
+    uint32_t width = std::min(region.extent.width, image.width() - static_cast<uint32_t>(x));
+    uint32_t height = std::min(region.extent.height, image.height() - static_cast<uint32_t>(y));
+    if (width == 0 || height == 0) {
+        FINEVK_WARN(LogCategory::Core, "ImageReadback::read: empty region, nothing copied");
+        return;
+    }
+
+    VkImageAspectFlags aspect = FormatUtils::hasDepth(image.format()) ?
+        VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+    uint32_t texelSize = copyTexelSize(image.format(), aspect);
+    uint32_t rowPitch = width * texelSize;
+    VkDeviceSize size = static_cast<VkDeviceSize>(rowPitch) * height;
+
+    // Copies must start on a texel (and, for depth, 4-byte) boundary
+    Slot& slot = *current_;
+    VkDeviceSize offset = (slot.used + 15) & ~VkDeviceSize(15);
+    if (!slot.buffer || offset + size > slot.buffer->size()) {
+        VkDeviceSize capacity = slot.buffer ? slot.buffer->size() : 0;
+        capacity = std::max({capacity * 2, offset + size, VkDeviceSize(64 * 1024)});
+        if (slot.buffer) {
+            slot.outgrown.push_back(std::move(slot.buffer));
+        }
+        slot.buffer = createBuffer(capacity);
+        offset = 0;
+    }
+    slot.used = offset + size;
+
+    VkImageSubresourceRange range{};
+    range.aspectMask = aspect;
+    range.baseMipLevel = 0;
+    range.levelCount = 1;
+    range.baseArrayLayer = 0;
+    range.layerCount = 1;
+
+    VkPipelineStageFlags writeStage;
+    VkAccessFlags writeAccess;
+    layoutAccess(layout, writeStage, writeAccess);
+
+    VkImageMemoryBarrier toTransfer{};
+    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.srcAccessMask = writeAccess;
+    toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    toTransfer.oldLayout = layout;
+    toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = image.handle();
+    toTransfer.subresourceRange = range;
+    cmd.pipelineBarrier(writeStage, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, {toTransfer});
+
+    VkBufferImageCopy copy{};
+    copy.bufferOffset = offset;
+    copy.bufferRowLength = 0;    // Tightly packed
+    copy.bufferImageHeight = 0;
+    copy.imageSubresource.aspectMask = aspect;
+    copy.imageSubresource.mipLevel = 0;
+    copy.imageSubresource.baseArrayLayer = 0;
+    copy.imageSubresource.layerCount = 1;
+    copy.imageOffset = {x, y, 0};
+    copy.imageExtent = {width, height, 1};
+    vkCmdCopyImageToBuffer(cmd.handle(), image.handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           slot.buffer->handle(), 1, &copy);
+
+    // Back to the caller's layout; later work in the frame sees the image unchanged
+    VkImageMemoryBarrier restore = toTransfer;
+    restore.srcAccessMask = 0;
+    restore.dstAccessMask = writeAccess | VK_ACCESS_SHADER_READ_BIT;
+    restore.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    restore.newLayout = layout;
+
+    VkBufferMemoryBarrier toHost{};
+    toHost.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    toHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    toHost.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toHost.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toHost.buffer = slot.buffer->handle();
+    toHost.offset = offset;
+    toHost.size = size;
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                        0, {}, {toHost}, {restore});
+
+    slot.requests.push_back({slot.buffer.get(), offset, size, {width, height},
+                             image.format(), rowPitch, std::move(callback)});
+}
+
+void ImageReadback::read(CommandBuffer& cmd, Image& image, VkImageLayout layout, Callback callback) {
+    read(cmd, image, layout, VkRect2D{{0, 0}, {image.width(), image.height()}}, std::move(callback));
+}
+
+void ImageReadback::read(CommandBuffer& cmd, const RenderTarget& target, Callback callback) {
+    Image* color = target.colorImage();
+    if (!color) {
+        throw std::runtime_error("ImageReadback::read: render target has no off-screen color image");
+    }
+    // Off-screen passes leave their color attachment in COLOR_ATTACHMENT_OPTIMAL
+    read(cmd, *color, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, std::move(callback));
+}
+
+namespace {
+
+// Callback that fills a promise with a copy of the pixels
+struct PromiseCallback {
+    std::shared_ptr<std::promise<ReadbackImage>> promise;
+
+    void operator()(const ReadbackView& view) const {
+        ReadbackImage image;
+        image.pixels.assign(view.data, view.data + view.size);
+        image.extent = view.extent;
+        image.format = view.format;
+        image.rowPitch = view.rowPitch;
+        promise->set_value(std::move(image));
+    }
+};
+
+} // anonymous namespace
+
+std::future<ReadbackImage> ImageReadback::read(CommandBuffer& cmd, Image& image, VkImageLayout layout,
+                                               const VkRect2D& region) {
+    auto promise = std::make_shared<std::promise<ReadbackImage>>();
+    auto future = promise->get_future();
+    read(cmd, image, layout, region, PromiseCallback{std::move(promise)});
+    return future;
+}
+
+std::future<ReadbackImage> ImageReadback::read(CommandBuffer& cmd, Image& image, VkImageLayout layout) {
+    return read(cmd, image, layout, VkRect2D{{0, 0}, {image.width(), image.height()}});
+}
+
+std::future<ReadbackImage> ImageReadback::read(CommandBuffer& cmd, const RenderTarget& target) {
+    auto promise = std::make_shared<std::promise<ReadbackImage>>();
+    auto future = promise->get_future();
+    read(cmd, target, PromiseCallback{std::move(promise)});
+    return future;
+}
+
+void ImageReadback::deliverAll() {
+    // Oldest first: the slot after the current one was recorded longest ago
+    size_t start = current_ ? static_cast<size_t>(current_ - slots_.data()) + 1 : 0;
+    for (size_t i = 0; i < slots_.size(); i++) {
+        deliver(slots_[(start + i) % slots_.size()]);
+    }
+}
+
+size_t ImageReadback::pendingCount() const {
+    size_t count = 0;
+    for (const auto& slot : slots_) {
+        count += slot.requests.size();
+    }
+    return count;
+}
+
+VkDeviceSize ImageReadback::memoryUsed() const {
+    VkDeviceSize total = 0;
+    for (const auto& slot : slots_) {
+        total += slot.buffer ? slot.buffer->size() : 0;
+        for (const auto& buffer : slot.outgrown) {
+            total += buffer->size();
+        }
+    }
+    return total;
+}
+
+} // namespace finevk
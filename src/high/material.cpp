@@ -1,5 +1,6 @@
 #include "finevk/high/material.hpp"
 #include "finevk/rendering/descriptors.hpp"
+#include "finevk/rendering/descriptor_allocator.hpp"
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/command.hpp"
 #include "finevk/device/buffer.hpp"
@@ -17,7 +18,7 @@ namespace finevk {
 
 Material::Builder::Builder(LogicalDevice* device, uint32_t framesInFlight)
     : device_(device)
-    , framesInFlight_(framesInFlight) {
+    , framesInFlight_((framesInFlight != 0 || !device) ? framesInFlight : device->maxFramesInFlight()) {
 }
 
 Material::Builder& Material::Builder::texture(uint32_t binding, VkShaderStageFlags stages) {
@@ -25,6 +26,16 @@ Material::Builder& Material::Builder::texture(uint32_t binding, VkShaderStageFla
     return *this;
 }
 
+Material::Builder& Material::Builder::allocator(DescriptorAllocator* allocator) {
+    allocator_ = allocator;
+    return *this;
+}
+
+Material::Builder& Material::Builder::layoutCache(DescriptorLayoutCache* cache) {
+    layoutCache_ = cache;
+    return *this;
+}
+
 void Material::Builder::addBinding(uint32_t binding, VkDescriptorType type,
                                    VkShaderStageFlags stages, size_t uniformSize) {
     bindings_.push_back({binding, type, stages, uniformSize});
@@ -39,24 +50,45 @@ MaterialPtr Material::Builder::build() {
     material->device_ = device_;
     material->framesInFlight_ = framesInFlight_;
 
-    // Create descriptor set layout
-    auto layoutBuilder = DescriptorSetLayout::create(device_);
-    for (const auto& b : bindings_) {
-        layoutBuilder.binding(b.binding, b.type, b.stages);
+    // Create (or share) descriptor set layout
+    if (layoutCache_) {
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+        for (const auto& b : bindings_) {
+            layoutBindings.push_back({b.binding, b.type, 1, b.stages, nullptr});
+        }
+        material->layoutRef_ = layoutCache_->get(layoutBindings);
+    } else {
+        auto layoutBuilder = DescriptorSetLayout::create(device_);
+        for (const auto& b : bindings_) {
+            layoutBuilder.binding(b.binding, b.type, b.stages);
+        }
+        material->layout_ = layoutBuilder.build();
+        material->layoutRef_ = material->layout_.get();
     }
-    material->layout_ = layoutBuilder.build();
 
-    // Create descriptor pool
-    auto poolBuilder = DescriptorPool::create(device_)
-        .maxSets(framesInFlight_);
-    for (const auto& b : bindings_) {
-        poolBuilder.poolSize(b.type, framesInFlight_);
+    // Allocate descriptor sets (one per frame) from the shared allocator or a private pool
+    if (allocator_) {
+        material->allocator_ = allocator_;
+        material->descriptorSets_ = allocator_->allocate(material->layoutRef_, framesInFlight_);
+    } else {
+        auto poolBuilder = DescriptorPool::create(device_)
+            .maxSets(framesInFlight_);
+        for (const auto& b : bindings_) {
+            poolBuilder.poolSize(b.type, framesInFlight_);
+        }
+        material->pool_ = poolBuilder.build();
+        material->descriptorSets_ = material->pool_->allocate(
+            material->layoutRef_, framesInFlight_);
     }
-    material->pool_ = poolBuilder.build();
 
-    // Allocate descriptor sets (one per frame)
-    material->descriptorSets_ = material->pool_->allocate(
-        material->layout_.get(), framesInFlight_);
+    // Packed per-frame descriptor arrays for the layout's update template
+    if (const DescriptorUpdateTemplate* tmpl = material->layoutRef_->updateTemplate()) {
+        material->descriptorData_.resize(static_cast<size_t>(framesInFlight_) * tmpl->descriptorCount());
+        material->written_.assign(tmpl->descriptorCount(), false);
+        material->unwritten_ = tmpl->descriptorCount();
+    }
+    material->frameInfos_.resize(framesInFlight_);
+    material->writes_.reserve(framesInFlight_);
 
     // Create uniform buffers for uniform bindings
     for (const auto& b : bindings_) {
@@ -73,22 +105,10 @@ MaterialPtr Material::Builder::build() {
 
             // Bind uniform buffers to all descriptor sets
             for (uint32_t i = 0; i < framesInFlight_; i++) {
-                VkDescriptorBufferInfo bufferInfo{};
-                bufferInfo.buffer = material->uniformBuffers_[b.binding][i]->handle();
-                bufferInfo.offset = 0;
-                bufferInfo.range = b.uniformSize;
-
-                VkWriteDescriptorSet write{};
-                write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                write.dstSet = material->descriptorSets_[i];
-                write.dstBinding = b.binding;
-                write.dstArrayElement = 0;
-                write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                write.descriptorCount = 1;
-                write.pBufferInfo = &bufferInfo;
-
-                vkUpdateDescriptorSets(device_->handle(), 1, &write, 0, nullptr);
+                material->frameInfos_[i].buffer = {
+                    material->uniformBuffers_[b.binding][i]->handle(), 0, b.uniformSize};
             }
+            material->writeBinding(b.binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
         }
     }
 
@@ -114,9 +134,23 @@ Material::Material(Material&& other) noexcept
     , framesInFlight_(other.framesInFlight_)
     , currentFrame_(other.currentFrame_)
     , layout_(std::move(other.layout_))
+    , layoutRef_(other.layoutRef_)
     , pool_(std::move(other.pool_))
+    , allocator_(other.allocator_)
     , descriptorSets_(std::move(other.descriptorSets_))
-    , uniformBuffers_(std::move(other.uniformBuffers_)) {
+    , uniformBuffers_(std::move(other.uniformBuffers_))
+    , descriptorData_(std::move(other.descriptorData_))
+    , written_(std::move(other.written_))
+    , unwritten_(other.unwritten_)
+    , frameInfos_(std::move(other.frameInfos_))
+    , writes_(std::move(other.writes_))
+    , bindlessTable_(other.bindlessTable_)
+    , bindlessIndex_(other.bindlessIndex_) {
+    other.unwritten_ = 0;
+    other.bindlessTable_ = nullptr;
+    other.bindlessIndex_ = BindlessTable::InvalidIndex;
+    other.layoutRef_ = nullptr;
+    other.allocator_ = nullptr;
     other.device_ = nullptr;
     other.framesInFlight_ = 0;
     other.currentFrame_ = 0;
@@ -129,9 +163,23 @@ Material& Material::operator=(Material&& other) noexcept {
         framesInFlight_ = other.framesInFlight_;
         currentFrame_ = other.currentFrame_;
         layout_ = std::move(other.layout_);
+        layoutRef_ = other.layoutRef_;
         pool_ = std::move(other.pool_);
+        allocator_ = other.allocator_;
         descriptorSets_ = std::move(other.descriptorSets_);
         uniformBuffers_ = std::move(other.uniformBuffers_);
+        descriptorData_ = std::move(other.descriptorData_);
+        written_ = std::move(other.written_);
+        unwritten_ = other.unwritten_;
+        frameInfos_ = std::move(other.frameInfos_);
+        writes_ = std::move(other.writes_);
+        bindlessTable_ = other.bindlessTable_;
+        bindlessIndex_ = other.bindlessIndex_;
+        other.unwritten_ = 0;
+        other.bindlessTable_ = nullptr;
+        other.bindlessIndex_ = BindlessTable::InvalidIndex;
+        other.layoutRef_ = nullptr;
+        other.allocator_ = nullptr;
         other.device_ = nullptr;
         other.framesInFlight_ = 0;
         other.currentFrame_ = 0;
@@ -140,10 +188,27 @@ Material& Material::operator=(Material&& other) noexcept {
 }
 
 void Material::cleanup() {
+    releaseBindless();
     uniformBuffers_.clear();
+    if (allocator_ && !descriptorSets_.empty()) {
+        allocator_->free(descriptorSets_);
+    }
+    allocator_ = nullptr;
     descriptorSets_.clear();
+    descriptorData_.clear();
+    written_.clear();
+    unwritten_ = 0;
     pool_.reset();
     layout_.reset();
+    layoutRef_ = nullptr;
+}
+
+void Material::releaseBindless() noexcept {
+    if (bindlessTable_) {
+        bindlessTable_->releaseMaterial(bindlessIndex_);
+        bindlessTable_ = nullptr;
+        bindlessIndex_ = BindlessTable::InvalidIndex;
+    }
 }
 
 VkDescriptorSet Material::descriptorSet(uint32_t frameIndex) const {
@@ -163,37 +228,59 @@ void Material::setTexture(uint32_t binding, Texture* texture, Sampler* sampler)
     }
 
     // Update all descriptor sets with the texture
-    VkDescriptorImageInfo imageInfo{};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = texture->view()->handle();
-    imageInfo.sampler = sampler->handle();
+    for (uint32_t i = 0; i < framesInFlight_; i++) {
+        frameInfos_[i].image = {sampler->handle(), texture->view()->handle(),
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    }
+    writeBinding(binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+}
+
+void Material::writeBinding(uint32_t binding, VkDescriptorType type) {
+    const DescriptorUpdateTemplate* tmpl = layoutRef_->updateTemplate();
+    if (tmpl) {
+        uint32_t index = tmpl->indexOf(binding);
+        uint32_t count = tmpl->descriptorCount();
+        for (uint32_t i = 0; i < framesInFlight_; i++) {
+            descriptorData_[static_cast<size_t>(i) * count + index] = frameInfos_[i];
+        }
+        if (!written_[index]) {
+            written_[index] = true;
+            unwritten_--;
+        }
 
+        // Templates write every descriptor, so only once all of them are valid
+        if (unwritten_ == 0) {
+            for (uint32_t i = 0; i < framesInFlight_; i++) {
+                tmpl->update(descriptorSets_[i], &descriptorData_[static_cast<size_t>(i) * count]);
+            }
+            return;
+        }
+    }
+
+    // One batched update across all frames
+    writes_.clear();
     for (uint32_t i = 0; i < framesInFlight_; i++) {
         VkWriteDescriptorSet write{};
         write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         write.dstSet = descriptorSets_[i];
         write.dstBinding = binding;
         write.dstArrayElement = 0;
-        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.descriptorType = type;
         write.descriptorCount = 1;
-        write.pImageInfo = &imageInfo;
-
-        vkUpdateDescriptorSets(device_->handle(), 1, &write, 0, nullptr);
+        if (type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
+            write.pImageInfo = &frameInfos_[i].image;
+        } else {
+            write.pBufferInfo = &frameInfos_[i].buffer;
+        }
+        writes_.push_back(write);
     }
+    vkUpdateDescriptorSets(device_->handle(), static_cast<uint32_t>(writes_.size()),
+                           writes_.data(), 0, nullptr);
 }
 
 void Material::bind(CommandBuffer& cmd, VkPipelineLayout pipelineLayout, uint32_t setIndex) {
-    VkDescriptorSet set = descriptorSet();
-    vkCmdBindDescriptorSets(
-        cmd.handle(),
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pipelineLayout,
-        setIndex,
-        1,
-        &set,
-        0,
-        nullptr
-    );
+    cmd.bindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, setIndex,
+                           {descriptorSet()});
 }
 
 } // namespace finevk
@@ -1,18 +1,202 @@
 #include "finevk/high/mesh.hpp"
+#include "finevk/high/mesh_optimizer.hpp"
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/buffer.hpp"
 #include "finevk/device/command.hpp"
+#include "finevk/device/upload_manager.hpp"
+#include "finevk/core/mapped_file.hpp"
+#include "finevk/core/asset_pack.hpp"
+#include "finevk/high/asset_loader.hpp"
 #include "finevk/core/logging.hpp"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
 #include <stdexcept>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <limits>
+#include <numeric>
+#include <thread>
 
 namespace finevk {
 
+namespace {
+
+// ============================================================================
+// Binary mesh cache format
+// ============================================================================
+
+// Header, then packed vertices (Vertex::stride(attributes) each), then
+// indices of every detail level, then the Mesh::Lod table. Native byte
+// order; any mismatch makes the cache stale.
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t attributes;    // VertexAttribute mask
+    uint32_t indexType;     // VkIndexType
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t flags;         // kCacheOptimized, kCacheLods
+    uint32_t lodCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint64_t vertexOffset;  // From the start of the file
+    uint64_t vertexBytes;
+    uint64_t indexOffset;
+    uint64_t indexBytes;
+    uint64_t lodOffset;
+};
+
+constexpr char kCacheMagic[4] = {'F', 'V', 'K', 'M'};
+constexpr uint32_t kCacheVersion = 3;
+constexpr uint32_t kCacheOptimized = 1u << 0;
+constexpr uint32_t kCacheLods = 1u << 1;
+
+const MeshCacheHeader* cacheHeader(ByteSpan file) {
+    if (file.size < sizeof(MeshCacheHeader)) {
+        return nullptr;
+    }
+    const auto* header = reinterpret_cast<const MeshCacheHeader*>(file.data);
+    if (std::memcmp(header->magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        header->version != kCacheVersion) {
+        return nullptr;
+    }
+
+    uint32_t indexSize;
+    if (header->indexType == VK_INDEX_TYPE_UINT16) {
+        indexSize = 2;
+    } else if (header->indexType == VK_INDEX_TYPE_UINT32) {
+        indexSize = 4;
+    } else {
+        return nullptr;
+    }
+    auto attrs = static_cast<VertexAttribute>(header->attributes);
+    if (header->vertexCount == 0 || header->indexCount == 0 ||
+        header->vertexBytes != static_cast<uint64_t>(header->vertexCount) * Vertex::stride(attrs) ||
+        header->indexBytes != static_cast<uint64_t>(header->indexCount) * indexSize ||
+        header->vertexOffset + header->vertexBytes > file.size ||
+        header->indexOffset + header->indexBytes > file.size ||
+        header->lodCount == 0 ||
+        header->lodOffset + static_cast<uint64_t>(header->lodCount) * sizeof(Mesh::Lod) > file.size) {
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < header->lodCount; i++) {
+        Mesh::Lod lod;
+        std::memcpy(&lod, file.data + header->lodOffset + i * sizeof(Mesh::Lod), sizeof(lod));
+        if (static_cast<uint64_t>(lod.firstIndex) + lod.indexCount > header->indexCount) {
+            return nullptr;
+        }
+    }
+    return header;
+}
+
+std::vector<Mesh::Lod> cacheLods(ByteSpan file, const MeshCacheHeader* header) {
+    std::vector<Mesh::Lod> lods(header->lodCount);
+    std::memcpy(lods.data(), file.data + header->lodOffset, lods.size() * sizeof(Mesh::Lod));
+    return lods;
+}
+
+// ============================================================================
+// Compact vertex encodings
+// ============================================================================
+
+uint16_t quantizeUnorm16(float value) {
+    return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+int16_t quantizeSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+// IEEE half, round to nearest even
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    if (magnitude >= 0x47800000) {
+        // Too large for a half: infinity, or NaN
+        return sign | (magnitude > 0x7F800000 ? 0x7E00 : 0x7C00);
+    }
+    if (magnitude < 0x38800000) {
+        // Half subnormal: units of 2^-24
+        float abs;
+        std::memcpy(&abs, &magnitude, sizeof(abs));
+        return sign | static_cast<uint16_t>(std::lrint(abs * 16777216.0f));
+    }
+    uint32_t half = (magnitude - 0x38000000) >> 13;  // Rebias exponent 127 -> 15
+    uint32_t rest = magnitude & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+        half++;  // A carry into the exponent is still correct
+    }
+    return sign | static_cast<uint16_t>(half);
+}
+
+// Unit vector onto the octahedron, lower half folded over the diagonals
+glm::vec2 octEncode(const glm::vec3& n) {
+    float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (sum == 0.0f) {
+        return glm::vec2(0.0f);
+    }
+    glm::vec2 e(n.x / sum, n.y / sum);
+    if (n.z < 0.0f) {
+        e = glm::vec2((1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f),
+                      (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return e;
+}
+
+// Finalizer so similar vertices don't cluster in the dedup table
+uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// One Builder index per OBJ face corner; positions are a good first guess
+// at the unique vertex count (seams add more, and the table grows)
+size_t countIndices(const std::vector<tinyobj::shape_t>& shapes) {
+    size_t count = 0;
+    for (const auto& shape : shapes) {
+        count += shape.mesh.indices.size();
+    }
+    return count;
+}
+
+// Meshlet builds read vertices from the mesh shader as well
+BufferPtr createMeshVertexBuffer(LogicalDevice* device, VkDeviceSize size, bool storage) {
+    if (!storage) {
+        return Buffer::createVertexBuffer(device, size);
+    }
+    return Buffer::create(device)
+        .size(size)
+        .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+               VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+}
+
+BufferPtr createMeshletBuffer(LogicalDevice* device, VkDeviceSize size) {
+    return Buffer::create(device)
+        .size(size)
+        .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // Vertex implementation
 // ============================================================================
@@ -40,43 +224,47 @@ std::vector<VkVertexInputAttributeDescription> Vertex::attributeDescriptions(
     uint32_t location = 0;
 
     if (attrs & VertexAttribute::Position) {
+        bool quantized = attrs & VertexAttribute::QuantizedPosition;
         VkVertexInputAttributeDescription desc{};
         desc.binding = 0;
         desc.location = location++;
-        desc.format = VK_FORMAT_R32G32B32_SFLOAT;
+        desc.format = quantized ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R32G32B32_SFLOAT;
         desc.offset = offset;
         descriptions.push_back(desc);
-        offset += sizeof(glm::vec3);
+        offset += quantized ? 4 * sizeof(uint16_t) : sizeof(glm::vec3);
     }
 
     if (attrs & VertexAttribute::Normal) {
+        bool oct = attrs & VertexAttribute::OctNormal;
         VkVertexInputAttributeDescription desc{};
         desc.binding = 0;
         desc.location = location++;
-        desc.format = VK_FORMAT_R32G32B32_SFLOAT;
+        desc.format = oct ? VK_FORMAT_R16G16_SNORM : VK_FORMAT_R32G32B32_SFLOAT;
         desc.offset = offset;
         descriptions.push_back(desc);
-        offset += sizeof(glm::vec3);
+        offset += oct ? 2 * sizeof(int16_t) : sizeof(glm::vec3);
     }
 
     if (attrs & VertexAttribute::TexCoord) {
+        bool half = attrs & VertexAttribute::HalfTexCoord;
         VkVertexInputAttributeDescription desc{};
         desc.binding = 0;
         desc.location = location++;
-        desc.format = VK_FORMAT_R32G32_SFLOAT;
+        desc.format = half ? VK_FORMAT_R16G16_SFLOAT : VK_FORMAT_R32G32_SFLOAT;
         desc.offset = offset;
         descriptions.push_back(desc);
-        offset += sizeof(glm::vec2);
+        offset += half ? 2 * sizeof(uint16_t) : sizeof(glm::vec2);
     }
 
     if (attrs & VertexAttribute::Color) {
+        bool color8 = attrs & VertexAttribute::Color8;
         VkVertexInputAttributeDescription desc{};
         desc.binding = 0;
         desc.location = location++;
-        desc.format = VK_FORMAT_R32G32B32_SFLOAT;
+        desc.format = color8 ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R32G32B32_SFLOAT;
         desc.offset = offset;
         descriptions.push_back(desc);
-        offset += sizeof(glm::vec3);
+        offset += color8 ? 4 * sizeof(uint8_t) : sizeof(glm::vec3);
     }
 
     if (attrs & VertexAttribute::Tangent) {
@@ -94,10 +282,18 @@ std::vector<VkVertexInputAttributeDescription> Vertex::attributeDescriptions(
 
 uint32_t Vertex::stride(VertexAttribute attrs) {
     uint32_t s = 0;
-    if (attrs & VertexAttribute::Position) s += sizeof(glm::vec3);
-    if (attrs & VertexAttribute::Normal) s += sizeof(glm::vec3);
-    if (attrs & VertexAttribute::TexCoord) s += sizeof(glm::vec2);
-    if (attrs & VertexAttribute::Color) s += sizeof(glm::vec3);
+    if (attrs & VertexAttribute::Position) {
+        s += (attrs & VertexAttribute::QuantizedPosition) ? 4 * sizeof(uint16_t) : sizeof(glm::vec3);
+    }
+    if (attrs & VertexAttribute::Normal) {
+        s += (attrs & VertexAttribute::OctNormal) ? 2 * sizeof(int16_t) : sizeof(glm::vec3);
+    }
+    if (attrs & VertexAttribute::TexCoord) {
+        s += (attrs & VertexAttribute::HalfTexCoord) ? 2 * sizeof(uint16_t) : sizeof(glm::vec2);
+    }
+    if (attrs & VertexAttribute::Color) {
+        s += (attrs & VertexAttribute::Color8) ? 4 * sizeof(uint8_t) : sizeof(glm::vec3);
+    }
     if (attrs & VertexAttribute::Tangent) s += sizeof(glm::vec4);
     return s;
 }
@@ -132,6 +328,7 @@ MeshRef Mesh::fromOBJ(
     auto builder = create(device)
         .attributes(attrs)
         .enableDeduplication(true);
+    builder.reserve(attrib.vertices.size() / 3, countIndices(shapes));
 
     for (const auto& shape : shapes) {
         for (const auto& index : shape.mesh.indices) {
@@ -179,13 +376,90 @@ MeshRef Mesh::fromOBJ(
     return builder.build(commandPool);
 }
 
+MeshRef Mesh::fromCache(LogicalDevice* device, const std::string& path, CommandPool* commandPool) {
+    MappedFile file(path);
+    return fromCache(device, file.span(), commandPool);
+}
+
+MeshRef Mesh::fromPack(LogicalDevice* device, const AssetPack& pack, const std::string& name,
+                       CommandPool* commandPool) {
+    const AssetPack::Entry& entry = pack.entry(name);
+    if (entry.kind != AssetPack::Kind::Mesh) {
+        throw std::runtime_error("Asset pack entry is not a mesh: " + name);
+    }
+    return fromCache(device, entry.bytes, commandPool);
+}
+
+MeshRef Mesh::fromCache(LogicalDevice* device, ByteSpan file, CommandPool* commandPool) {
+    if (!commandPool) {
+        throw std::runtime_error("Command pool required to build mesh");
+    }
+    const MeshCacheHeader* header = cacheHeader(file);
+    if (!header) {
+        throw std::runtime_error("Invalid mesh cache");
+    }
+
+    auto vertexBuffer = Buffer::createVertexBuffer(device, header->vertexBytes);
+    auto indexBuffer = Buffer::createIndexBuffer(device, header->indexBytes);
+
+    // Straight from the mapping into staging
+    auto staging = Buffer::createStagingBuffer(device, header->vertexBytes + header->indexBytes);
+    auto* dst = static_cast<char*>(staging->mappedPtr());
+    std::memcpy(dst, file.data + header->vertexOffset, header->vertexBytes);
+    std::memcpy(dst + header->vertexBytes, file.data + header->indexOffset, header->indexBytes);
+
+    auto imm = commandPool->beginImmediate();
+    imm.cmd().copyBuffer(*staging, *vertexBuffer, header->vertexBytes, 0, 0);
+    imm.cmd().copyBuffer(*staging, *indexBuffer, header->indexBytes, header->vertexBytes, 0);
+    imm.submit();
+
+    auto mesh = MeshRef(new Mesh());
+    mesh->vertexBuffer_ = std::move(vertexBuffer);
+    mesh->indexBuffer_ = std::move(indexBuffer);
+    mesh->lods_ = cacheLods(file, header);
+    mesh->indexCount_ = mesh->lods_[0].indexCount;
+    mesh->indexType_ = static_cast<VkIndexType>(header->indexType);
+    mesh->attributes_ = static_cast<VertexAttribute>(header->attributes);
+    mesh->boundsMin_ = glm::vec3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+    mesh->boundsMax_ = glm::vec3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+    return mesh;
+}
+
+glm::mat4 Mesh::dequantizeTransform() const {
+    glm::mat4 transform(1.0f);
+    if (attributes_ & VertexAttribute::QuantizedPosition) {
+        glm::vec3 extent = boundsMax_ - boundsMin_;
+        transform[0][0] = extent.x;
+        transform[1][1] = extent.y;
+        transform[2][2] = extent.z;
+        transform[3] = glm::vec4(boundsMin_, 1.0f);
+    }
+    return transform;
+}
+
 void Mesh::bind(CommandBuffer& cmd) const {
-    cmd.bindVertexBuffer(*vertexBuffer_);
-    cmd.bindIndexBuffer(*indexBuffer_, indexType_);
+    cmd.bindVertexBuffer(*vertexBuffer_, vertexOffset_);
+    cmd.bindIndexBuffer(*indexBuffer_, indexType_, indexOffset_);
+}
+
+void Mesh::draw(CommandBuffer& cmd, uint32_t instanceCount, uint32_t firstInstance) const {
+    cmd.drawIndexed(indexCount_, instanceCount, 0, 0, firstInstance);
+}
+
+void Mesh::drawLod(CommandBuffer& cmd, uint32_t level, uint32_t instanceCount,
+                   uint32_t firstInstance) const {
+    const Lod& range = lod(level);
+    cmd.drawIndexed(range.indexCount, instanceCount, range.firstIndex, 0, firstInstance);
 }
 
-void Mesh::draw(CommandBuffer& cmd, uint32_t instanceCount) const {
-    cmd.drawIndexed(indexCount_, instanceCount);
+void Mesh::drawMeshlets(CommandBuffer& cmd) const {
+    if (!hasMeshlets()) {
+        bind(cmd);
+        draw(cmd);
+        return;
+    }
+    uint32_t groups = (meshletCount_ + MeshletsPerTaskGroup - 1) / MeshletsPerTaskGroup;
+    cmdDrawMeshTasks_(cmd.handle(), groups, 1, 1);
 }
 
 // ============================================================================
@@ -217,6 +491,139 @@ Mesh::Builder& Mesh::Builder::use32BitIndices(bool use) {
     return *this;
 }
 
+Mesh::Builder& Mesh::Builder::cache(bool enable) {
+    cache_ = enable;
+    return *this;
+}
+
+Mesh::Builder& Mesh::Builder::optimize(bool enable) {
+    optimize_ = enable;
+    return *this;
+}
+
+Mesh::Builder& Mesh::Builder::generateLods(uint32_t levels, float reduction, float maxError) {
+    lodLevels_ = std::max(levels, 1u);
+    lodReduction_ = std::clamp(reduction, 0.01f, 0.99f);
+    lodMaxError_ = maxError;
+    return *this;
+}
+
+Mesh::Builder& Mesh::Builder::meshlets(bool enable, uint32_t maxVertices, uint32_t maxTriangles) {
+    meshlets_ = enable;
+    meshletVertices_ = std::clamp(maxVertices, 3u, 256u);
+    meshletTriangles_ = std::max(maxTriangles, 1u);
+    return *this;
+}
+
+bool Mesh::Builder::wantsMeshlets() const {
+    return meshlets_ && device_->supportsMeshShading();
+}
+
+bool Mesh::Builder::openCache(MappedFile& file) const {
+    if (!cache_ || loadPath_.empty() || !vertices_.empty() || wantsMeshlets()) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::string path = cachePath();
+    auto cacheTime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    auto sourceTime = std::filesystem::last_write_time(loadPath_, ec);
+    if (ec || sourceTime > cacheTime) {
+        return false;
+    }
+
+    try {
+        file = MappedFile(path);
+    } catch (const std::exception&) {
+        return false;
+    }
+    const MeshCacheHeader* header = cacheHeader(file.span());
+    if (!header || header->attributes != static_cast<uint32_t>(attrs_) ||
+        (use32BitIndices_ && header->indexType != VK_INDEX_TYPE_UINT32) ||
+        (cacheFlags() & ~header->flags) != 0) {
+        FINEVK_DEBUG(LogCategory::Core, "Mesh cache is stale: " + path);
+        return false;
+    }
+    return true;
+}
+
+bool Mesh::Builder::readCache(PackedData& packed) const {
+    MappedFile file;
+    if (!openCache(file)) {
+        return false;
+    }
+    const MeshCacheHeader* header = cacheHeader(file.span());
+    const uint8_t* vertices = file.data() + header->vertexOffset;
+    const uint8_t* indices = file.data() + header->indexOffset;
+
+    packed.vertices.assign(vertices, vertices + header->vertexBytes);
+    packed.indices.assign(indices, indices + header->indexBytes);
+    packed.indexType = static_cast<VkIndexType>(header->indexType);
+    packed.indexCount = header->indexCount;
+    packed.boundsMin = glm::vec3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+    packed.boundsMax = glm::vec3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+    packed.lods = cacheLods(file.span(), header);
+    return true;
+}
+
+uint32_t Mesh::Builder::cacheFlags() const {
+    return (optimize_ ? kCacheOptimized : 0) | (lodLevels_ > 1 ? kCacheLods : 0);
+}
+
+void Mesh::Builder::writeCache(const std::string& path) {
+    writeCache(pack(), attrs_, cacheFlags(), path);
+}
+
+void Mesh::Builder::writeCache(const PackedData& packed, VertexAttribute attrs, uint32_t flags,
+                               const std::string& path) {
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.attributes = static_cast<uint32_t>(attrs);
+    header.indexType = static_cast<uint32_t>(packed.indexType);
+    header.vertexCount = static_cast<uint32_t>(packed.vertexBytes() / Vertex::stride(attrs));
+    header.indexCount = packed.indexCount;
+    header.flags = flags;
+    header.lodCount = static_cast<uint32_t>(packed.lods.size());
+    for (int i = 0; i < 3; i++) {
+        header.boundsMin[i] = packed.boundsMin[i];
+        header.boundsMax[i] = packed.boundsMax[i];
+    }
+    header.vertexOffset = sizeof(MeshCacheHeader);
+    header.vertexBytes = packed.vertexBytes();
+    header.indexOffset = header.vertexOffset + header.vertexBytes;
+    header.indexBytes = packed.indices.size();
+    header.lodOffset = (header.indexOffset + header.indexBytes + 3) & ~uint64_t(3);
+
+    // Write beside the target and rename, so readers never map a partial file
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(packed.vertices.data()),
+                  static_cast<std::streamsize>(header.vertexBytes));
+        out.write(reinterpret_cast<const char*>(packed.indices.data()),
+                  static_cast<std::streamsize>(header.indexBytes));
+        const char padding[4] = {};
+        out.write(padding, static_cast<std::streamsize>(
+            header.lodOffset - header.indexOffset - header.indexBytes));
+        out.write(reinterpret_cast<const char*>(packed.lods.data()),
+                  static_cast<std::streamsize>(packed.lods.size() * sizeof(Mesh::Lod)));
+        if (!out) {
+            throw std::runtime_error("Failed to write mesh cache: " + path);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        throw std::runtime_error("Failed to write mesh cache: " + path);
+    }
+}
+
 uint32_t Mesh::Builder::addVertex(const Vertex& v) {
     uint32_t index = static_cast<uint32_t>(vertices_.size());
     vertices_.push_back(v);
@@ -228,33 +635,61 @@ uint32_t Mesh::Builder::addUniqueVertex(const Vertex& v) {
         return addVertex(v);
     }
 
-    // Simple hash-based deduplication using a single hash -> index map.
-    //
-    // Trade-off: In the rare case of hash collisions between non-equal vertices,
-    // we check equality with the stored vertex. If they don't match, we add the
-    // new vertex but overwrite the hash map entry. This means:
-    // - The mesh is always correct (no wrong indices)
-    // - Hash collisions may cause some duplicate vertices (reduced efficiency)
-    // - But we avoid the overhead of multimap/chaining for the common case
-    //
-    // Given typical mesh data and a good hash function, collisions are rare,
-    // making this trade-off worthwhile for performance.
-
-    size_t hash = std::hash<Vertex>{}(v);
-    auto it = vertexMap_.find(hash);
-    if (it != vertexMap_.end()) {
-        // Found hash - check for actual vertex equality (handles collisions)
-        if (vertices_[it->second] == v) {
-            return it->second;  // Exact match, reuse existing vertex
+    // Keep the load factor at or below 3/4
+    if ((dedupCount_ + 1) * 4 > dedupSlots_.size() * 3) {
+        growDedupTable(dedupCount_ + 1);
+    }
+
+    uint64_t hash = mixHash(std::hash<Vertex>{}(v));
+    auto tag = static_cast<uint32_t>(hash >> 32);
+    size_t mask = dedupSlots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        DedupSlot& slot = dedupSlots_[i];
+        if (slot.index == UINT32_MAX) {
+            slot.index = addVertex(v);
+            slot.hash = tag;
+            dedupCount_++;
+            return slot.index;
+        }
+        if (slot.hash == tag && vertices_[slot.index] == v) {
+            return slot.index;
         }
-        // Hash collision with different vertex - fall through to add new vertex
-        // Note: This overwrites the map entry, which may reduce deduplication
-        // effectiveness for the previous vertex, but keeps the mesh correct.
     }
+}
 
-    uint32_t index = addVertex(v);
-    vertexMap_[hash] = index;
-    return index;
+Mesh::Builder& Mesh::Builder::reserve(size_t vertices, size_t indices) {
+    vertices_.reserve(vertices);
+    indices_.reserve(indices);
+    if (vertices * 4 > dedupSlots_.size() * 3) {
+        growDedupTable(vertices);
+    }
+    return *this;
+}
+
+void Mesh::Builder::growDedupTable(size_t vertices) {
+    size_t capacity = 64;
+    while (capacity * 3 < vertices * 4) {
+        capacity *= 2;
+    }
+    if (capacity <= dedupSlots_.size()) {
+        capacity = dedupSlots_.size() * 2;
+    }
+
+    // Rehash from the stored vertices; the tags only hold the upper hash bits
+    std::vector<DedupSlot> slots(capacity);
+    size_t mask = capacity - 1;
+    for (const DedupSlot& old : dedupSlots_) {
+        if (old.index == UINT32_MAX) {
+            continue;
+        }
+        uint64_t hash = mixHash(std::hash<Vertex>{}(vertices_[old.index]));
+        size_t i = hash & mask;
+        while (slots[i].index != UINT32_MAX) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = old;
+    }
+    dedupSlots_ = std::move(slots);
 }
 
 Mesh::Builder& Mesh::Builder::addTriangle(uint32_t i0, uint32_t i1, uint32_t i2) {
@@ -296,36 +731,64 @@ Mesh::Builder& Mesh::Builder::addIndices(const std::vector<uint32_t>& indices) {
     return *this;
 }
 
-void Mesh::Builder::packVertexData(std::vector<float>& packed) const {
+void Mesh::Builder::packVertexData(std::vector<uint8_t>& packed, const glm::vec3& boundsMin,
+                                   const glm::vec3& boundsMax) const {
     uint32_t stride = Vertex::stride(attrs_);
-    packed.resize(vertices_.size() * stride / sizeof(float));
-
-    float* ptr = packed.data();
+    packed.resize(vertices_.size() * stride);
+
+    // Quantized positions span the bounds; flat axes map to 0
+    glm::vec3 extent = boundsMax - boundsMin;
+    glm::vec3 invExtent(extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+                        extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+                        extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+    uint8_t* ptr = packed.data();
+    auto write = [&ptr](const void* data, size_t size) {
+        std::memcpy(ptr, data, size);
+        ptr += size;
+    };
     for (const auto& v : vertices_) {
         if (attrs_ & VertexAttribute::Position) {
-            *ptr++ = v.position.x;
-            *ptr++ = v.position.y;
-            *ptr++ = v.position.z;
+            if (attrs_ & VertexAttribute::QuantizedPosition) {
+                glm::vec3 unit = (v.position - boundsMin) * invExtent;
+                uint16_t q[4] = {quantizeUnorm16(unit.x), quantizeUnorm16(unit.y),
+                                 quantizeUnorm16(unit.z), 65535};
+                write(q, sizeof(q));
+            } else {
+                write(&v.position, sizeof(glm::vec3));
+            }
         }
         if (attrs_ & VertexAttribute::Normal) {
-            *ptr++ = v.normal.x;
-            *ptr++ = v.normal.y;
-            *ptr++ = v.normal.z;
+            if (attrs_ & VertexAttribute::OctNormal) {
+                glm::vec2 e = octEncode(v.normal);
+                int16_t q[2] = {quantizeSnorm16(e.x), quantizeSnorm16(e.y)};
+                write(q, sizeof(q));
+            } else {
+                write(&v.normal, sizeof(glm::vec3));
+            }
         }
         if (attrs_ & VertexAttribute::TexCoord) {
-            *ptr++ = v.texCoord.x;
-            *ptr++ = v.texCoord.y;
+            if (attrs_ & VertexAttribute::HalfTexCoord) {
+                uint16_t h[2] = {floatToHalf(v.texCoord.x), floatToHalf(v.texCoord.y)};
+                write(h, sizeof(h));
+            } else {
+                write(&v.texCoord, sizeof(glm::vec2));
+            }
         }
         if (attrs_ & VertexAttribute::Color) {
-            *ptr++ = v.color.x;
-            *ptr++ = v.color.y;
-            *ptr++ = v.color.z;
+            if (attrs_ & VertexAttribute::Color8) {
+                uint8_t c[4] = {
+                    static_cast<uint8_t>(std::clamp(v.color.x, 0.0f, 1.0f) * 255.0f + 0.5f),
+                    static_cast<uint8_t>(std::clamp(v.color.y, 0.0f, 1.0f) * 255.0f + 0.5f),
+                    static_cast<uint8_t>(std::clamp(v.color.z, 0.0f, 1.0f) * 255.0f + 0.5f),
+                    255};
+                write(c, sizeof(c));
+            } else {
+                write(&v.color, sizeof(glm::vec3));
+            }
         }
         if (attrs_ & VertexAttribute::Tangent) {
-            *ptr++ = v.tangent.x;
-            *ptr++ = v.tangent.y;
-            *ptr++ = v.tangent.z;
-            *ptr++ = v.tangent.w;
+            write(&v.tangent, sizeof(glm::vec4));
         }
     }
 }
@@ -352,6 +815,7 @@ void Mesh::Builder::loadOBJ(const std::string& path) {
 
     // Enable deduplication for loaded meshes
     deduplicate_ = true;
+    reserve(attrib.vertices.size() / 3, countIndices(shapes));
 
     for (const auto& shape : shapes) {
         for (const auto& index : shape.mesh.indices) {
@@ -397,73 +861,451 @@ void Mesh::Builder::loadOBJ(const std::string& path) {
         std::to_string(indexCount()) + " indices)");
 }
 
-MeshRef Mesh::Builder::build(CommandPool* commandPool) {
+void Mesh::Builder::optimizeIndices() {
+    acmrBefore_ = MeshOptimizer::acmr(indices_, vertices_.size());
+    MeshOptimizer::optimizeVertexCache(indices_, vertices_.size());
+    MeshOptimizer::optimizeOverdraw(indices_, vertices_);
+    MeshOptimizer::optimizeVertexFetch(indices_, vertices_);
+    acmrAfter_ = MeshOptimizer::acmr(indices_, vertices_.size());
+
+    // Vertex numbering changed; later addUniqueVertex() calls start a fresh table
+    dedupSlots_.clear();
+    dedupCount_ = 0;
+
+    char stats[64];
+    std::snprintf(stats, sizeof(stats), "ACMR %.3f -> %.3f", acmrBefore_, acmrAfter_);
+    FINEVK_DEBUG(LogCategory::Core, "Optimized mesh (" + std::to_string(indices_.size() / 3) +
+        " triangles): " + stats);
+}
+
+void Mesh::Builder::buildLods(PackedData& packed, std::vector<uint32_t>& indices) const {
+    packed.lods = {{0, static_cast<uint32_t>(indices_.size()), 0.0f}};
+    float radius = glm::length(packed.boundsMax - packed.boundsMin) * 0.5f;
+    if (radius <= 0.0f) {
+        return;
+    }
+
+    // Each level is simplified from level 0 so errors don't compound
+    size_t previous = indices_.size();
+    for (uint32_t level = 1; level < lodLevels_; level++) {
+        size_t target = static_cast<size_t>(static_cast<float>(previous) * lodReduction_) / 3 * 3;
+        float error = 0.0f;
+        std::vector<uint32_t> lod = MeshOptimizer::simplify(indices_, vertices_, target,
+                                                           lodMaxError_ * radius, &error);
+        if (lod.empty() || lod.size() * 10 > previous * 9) {
+            break;  // Error limit or locked borders and seams reached
+        }
+        if (optimize_) {
+            MeshOptimizer::optimizeVertexCache(lod, vertices_.size());
+        }
+
+        packed.lods.push_back({static_cast<uint32_t>(indices.size()),
+                               static_cast<uint32_t>(lod.size()), error / radius});
+        indices.insert(indices.end(), lod.begin(), lod.end());
+        previous = lod.size();
+    }
+
+    std::string levels;
+    for (const auto& lod : packed.lods) {
+        levels += " " + std::to_string(lod.indexCount / 3);
+    }
+    FINEVK_DEBUG(LogCategory::Core, "Mesh LOD triangles:" + levels);
+}
+
+void Mesh::Builder::buildMeshlets(PackedData& packed) const {
+    auto result = MeshOptimizer::buildMeshlets(indices_, vertices_, meshletVertices_, meshletTriangles_);
+    uint32_t triangleBase = static_cast<uint32_t>(result.vertices.size());
+
+    packed.meshlets.resize(result.meshlets.size());
+    for (size_t i = 0; i < result.meshlets.size(); i++) {
+        const auto& meshlet = result.meshlets[i];
+        const auto& bounds = result.bounds[i];
+        auto& gpu = packed.meshlets[i];
+        std::memcpy(gpu.center, &bounds.center, sizeof(gpu.center));
+        gpu.radius = bounds.radius;
+        std::memcpy(gpu.coneAxis, &bounds.coneAxis, sizeof(gpu.coneAxis));
+        gpu.coneCutoff = bounds.coneCutoff;
+        gpu.vertexOffset = meshlet.vertexOffset;
+        gpu.triangleOffset = triangleBase + meshlet.triangleOffset;
+        gpu.vertexCount = meshlet.vertexCount;
+        gpu.triangleCount = meshlet.triangleCount;
+    }
+
+    size_t triangleCount = result.triangles.size() / 3;
+    packed.meshletData = std::move(result.vertices);
+    packed.meshletData.reserve(triangleBase + triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        const uint8_t* tri = &result.triangles[t * 3];
+        packed.meshletData.push_back(tri[0] | (tri[1] << 8) | (tri[2] << 16));
+    }
+
+    FINEVK_DEBUG(LogCategory::Core, "Mesh meshlets: " + std::to_string(packed.meshlets.size()) +
+        " for " + std::to_string(indices_.size() / 3) + " triangles");
+}
+
+Mesh::Builder::PackedData Mesh::Builder::pack() {
+    PackedData packed;
+    if (readCache(packed)) {
+        return packed;
+    }
+
     // If we have a deferred load path, load it now
+    bool loaded = false;
     if (!loadPath_.empty() && vertices_.empty()) {
         loadOBJ(loadPath_);
+        loaded = true;
     }
 
     if (vertices_.empty() || indices_.empty()) {
         throw std::runtime_error("Cannot build empty mesh");
     }
 
-    // Use provided command pool or fall back to stored one
-    if (!commandPool) {
-        commandPool = commandPool_;
-    }
-    if (!commandPool) {
-        throw std::runtime_error("Command pool required to build mesh");
+    if (optimize_) {
+        optimizeIndices();
     }
 
     // Determine index type
     bool need32Bit = use32BitIndices_ || vertices_.size() > 65535;
-    VkIndexType indexType = need32Bit ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
-
-    // Pack vertex data
-    std::vector<float> vertexData;
-    packVertexData(vertexData);
-
-    VkDeviceSize vertexBufferSize = vertexData.size() * sizeof(float);
-
-    // Create vertex buffer
-    auto vertexBuffer = Buffer::createVertexBuffer(device_, vertexBufferSize);
-    vertexBuffer->upload(vertexData.data(), vertexBufferSize, 0, commandPool);
+    packed.indexType = need32Bit ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+
+    // Bounds first: quantized positions and LOD errors are relative to them
+    calculateBounds(packed.boundsMin, packed.boundsMax);
+    packVertexData(packed.vertices, packed.boundsMin, packed.boundsMax);
+
+    // Coarser levels follow level 0 in the same index data
+    std::vector<uint32_t> lodIndices;
+    const std::vector<uint32_t>* indices = &indices_;
+    if (lodLevels_ > 1) {
+        lodIndices = indices_;
+        buildLods(packed, lodIndices);
+        indices = &lodIndices;
+    } else {
+        packed.lods = {{0, static_cast<uint32_t>(indices_.size()), 0.0f}};
+    }
+    packed.indexCount = static_cast<uint32_t>(indices->size());
 
-    // Create index buffer
-    VkDeviceSize indexBufferSize;
-    BufferPtr indexBuffer;
+    if (wantsMeshlets()) {
+        buildMeshlets(packed);
+    }
 
     if (need32Bit) {
-        indexBufferSize = indices_.size() * sizeof(uint32_t);
-        indexBuffer = Buffer::createIndexBuffer(device_, indexBufferSize);
-        indexBuffer->upload(indices_.data(), indexBufferSize, 0, commandPool);
+        packed.indices.resize(indices->size() * sizeof(uint32_t));
+        std::memcpy(packed.indices.data(), indices->data(), packed.indices.size());
     } else {
         // Convert to 16-bit indices
-        std::vector<uint16_t> indices16(indices_.size());
-        for (size_t i = 0; i < indices_.size(); i++) {
-            indices16[i] = static_cast<uint16_t>(indices_[i]);
+        packed.indices.resize(indices->size() * sizeof(uint16_t));
+        auto* indices16 = reinterpret_cast<uint16_t*>(packed.indices.data());
+        for (size_t i = 0; i < indices->size(); i++) {
+            indices16[i] = static_cast<uint16_t>((*indices)[i]);
+        }
+    }
+
+    if (loaded && cache_) {
+        // A missing cache only costs the next load a re-parse
+        try {
+            writeCache(packed, attrs_, cacheFlags(), cachePath());
+            FINEVK_DEBUG(LogCategory::Core, "Wrote mesh cache: " + cachePath());
+        } catch (const std::exception& e) {
+            FINEVK_WARN(LogCategory::Core, e.what());
         }
-        indexBufferSize = indices16.size() * sizeof(uint16_t);
-        indexBuffer = Buffer::createIndexBuffer(device_, indexBufferSize);
-        indexBuffer->upload(indices16.data(), indexBufferSize, 0, commandPool);
     }
 
-    // Calculate bounds
-    glm::vec3 boundsMin, boundsMax;
-    calculateBounds(boundsMin, boundsMax);
+    return packed;
+}
 
+MeshRef Mesh::Builder::finish(const PackedData& packed,
+                              std::shared_ptr<Buffer> vertexBuffer, VkDeviceSize vertexOffset,
+                              std::shared_ptr<Buffer> indexBuffer, VkDeviceSize indexOffset) const {
     auto mesh = MeshRef(new Mesh());
     mesh->vertexBuffer_ = std::move(vertexBuffer);
     mesh->indexBuffer_ = std::move(indexBuffer);
-    mesh->indexCount_ = static_cast<uint32_t>(indices_.size());
-    mesh->indexType_ = indexType;
+    mesh->vertexOffset_ = vertexOffset;
+    mesh->indexOffset_ = indexOffset;
+    mesh->lods_ = packed.lods;
+    mesh->indexCount_ = packed.lods[0].indexCount;
+    mesh->indexType_ = packed.indexType;
     mesh->attributes_ = attrs_;
-    mesh->boundsMin_ = boundsMin;
-    mesh->boundsMax_ = boundsMax;
+    mesh->boundsMin_ = packed.boundsMin;
+    mesh->boundsMax_ = packed.boundsMax;
+    if (!packed.meshlets.empty()) {
+        // Sized here; the caller uploads them with the rest of the mesh
+        mesh->meshletBuffer_ = createMeshletBuffer(device_,
+            packed.meshlets.size() * sizeof(GpuMeshlet));
+        mesh->meshletDataBuffer_ = createMeshletBuffer(device_,
+            packed.meshletData.size() * sizeof(uint32_t));
+        mesh->meshletCount_ = static_cast<uint32_t>(packed.meshlets.size());
+        mesh->cmdDrawMeshTasks_ = device_->cmdDrawMeshTasks();
+    }
+    return mesh;
+}
+
+MeshRef Mesh::Builder::build(CommandPool* commandPool) {
+    // Use provided command pool or fall back to stored one
+    if (!commandPool) {
+        commandPool = commandPool_;
+    }
+    if (!commandPool) {
+        throw std::runtime_error("Command pool required to build mesh");
+    }
+
+    MappedFile cached;
+    if (openCache(cached)) {
+        return Mesh::fromCache(device_, cached.span(), commandPool);
+    }
+
+    PackedData packed = pack();
+    VkDeviceSize vertexBufferSize = packed.vertexBytes();
+    VkDeviceSize indexBufferSize = packed.indices.size();
+    VkDeviceSize meshletBytes = packed.meshlets.size() * sizeof(GpuMeshlet);
+    VkDeviceSize meshletDataBytes = packed.meshletData.size() * sizeof(uint32_t);
+
+    std::shared_ptr<Buffer> vertexBuffer = createMeshVertexBuffer(device_, vertexBufferSize,
+                                                                  !packed.meshlets.empty());
+    std::shared_ptr<Buffer> indexBuffer = Buffer::createIndexBuffer(device_, indexBufferSize);
+    auto mesh = finish(packed, vertexBuffer, 0, indexBuffer, 0);
+
+    // One staging buffer and one submission for all mesh data
+    VkDeviceSize indexStart = vertexBufferSize;
+    VkDeviceSize meshletStart = indexStart + indexBufferSize;
+    VkDeviceSize meshletDataStart = meshletStart + meshletBytes;
+    auto staging = Buffer::createStagingBuffer(device_, meshletDataStart + meshletDataBytes);
+    auto* dst = static_cast<char*>(staging->mappedPtr());
+    std::memcpy(dst, packed.vertices.data(), vertexBufferSize);
+    std::memcpy(dst + indexStart, packed.indices.data(), indexBufferSize);
+
+    auto imm = commandPool->beginImmediate();
+    imm.cmd().copyBuffer(*staging, *vertexBuffer, vertexBufferSize, 0, 0);
+    imm.cmd().copyBuffer(*staging, *indexBuffer, indexBufferSize, indexStart, 0);
+    if (mesh->hasMeshlets()) {
+        std::memcpy(dst + meshletStart, packed.meshlets.data(), meshletBytes);
+        std::memcpy(dst + meshletDataStart, packed.meshletData.data(), meshletDataBytes);
+        imm.cmd().copyBuffer(*staging, *mesh->meshletBuffer(), meshletBytes, meshletStart, 0);
+        imm.cmd().copyBuffer(*staging, *mesh->meshletDataBuffer(), meshletDataBytes, meshletDataStart, 0);
+    }
+    imm.submit();
+
+    return mesh;
+}
+
+MeshRef Mesh::Builder::build(UploadManager& uploads) {
+    return upload(pack(), uploads);
+}
+
+AsyncMeshRef Mesh::Builder::buildAsync(AssetLoader& loader) const {
+    return loader.load(*this);
+}
+
+MeshRef Mesh::Builder::upload(const PackedData& packed, UploadManager& uploads) const {
+    VkDeviceSize vertexBufferSize = packed.vertexBytes();
+    VkDeviceSize indexBufferSize = packed.indices.size();
+
+    auto vertexBuffer = createMeshVertexBuffer(device_, vertexBufferSize, !packed.meshlets.empty());
+    auto indexBuffer = Buffer::createIndexBuffer(device_, indexBufferSize);
 
+    uploads.uploadBuffer(*vertexBuffer, packed.vertices.data(), vertexBufferSize);
+    uploads.uploadBuffer(*indexBuffer, packed.indices.data(), indexBufferSize);
+
+    auto mesh = finish(packed, std::move(vertexBuffer), 0, std::move(indexBuffer), 0);
+    if (mesh->hasMeshlets()) {
+        uploads.uploadBuffer(*mesh->meshletBuffer(), packed.meshlets.data(),
+                             packed.meshlets.size() * sizeof(GpuMeshlet));
+        uploads.uploadBuffer(*mesh->meshletDataBuffer(), packed.meshletData.data(),
+                             packed.meshletData.size() * sizeof(uint32_t));
+    }
     return mesh;
 }
 
+// ============================================================================
+// MeshBatch implementation
+// ============================================================================
+
+namespace {
+
+VkDeviceSize alignOffset(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Any alignment, not just powers of two (vertex strides)
+VkDeviceSize roundUpOffset(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // anonymous namespace
+
+MeshBatch::MeshBatch(LogicalDevice* device)
+    : device_(device) {
+}
+
+MeshBatch& MeshBatch::sharedBuffers(bool enable) {
+    sharedBuffers_ = enable;
+    return *this;
+}
+
+MeshBatch& MeshBatch::threads(uint32_t count) {
+    threads_ = count;
+    return *this;
+}
+
+size_t MeshBatch::add(Mesh::Builder builder) {
+    builders_.push_back(std::move(builder));
+    return builders_.size() - 1;
+}
+
+std::vector<Mesh::Builder::PackedData> MeshBatch::packAll() {
+    std::vector<Mesh::Builder::PackedData> packed(builders_.size());
+
+    uint32_t workerCount = threads_ ? threads_ : std::thread::hardware_concurrency();
+    workerCount = std::max(1u, std::min<uint32_t>(workerCount,
+                                                   static_cast<uint32_t>(builders_.size())));
+
+    if (workerCount <= 1) {
+        for (size_t i = 0; i < builders_.size(); i++) {
+            packed[i] = builders_[i].pack();
+        }
+        return packed;
+    }
+
+    // OBJ parsing and vertex packing are independent per builder
+    std::atomic<size_t> next{0};
+    std::vector<std::future<void>> workers;
+    workers.reserve(workerCount);
+    for (uint32_t w = 0; w < workerCount; w++) {
+        workers.push_back(std::async(std::launch::async, [&]() {
+            for (size_t i = next++; i < builders_.size(); i = next++) {
+                packed[i] = builders_[i].pack();
+            }
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.get();  // Rethrows the first loader exception
+    }
+
+    return packed;
+}
+
+std::vector<MeshRef> MeshBatch::createMeshes(const UploadFn& upload) {
+    std::vector<MeshRef> meshes;
+    if (builders_.empty()) {
+        return meshes;
+    }
+
+    auto packed = packAll();
+    meshes.reserve(builders_.size());
+
+    // Meshlet buffers are per mesh even when vertices and indices are shared
+    auto uploadMeshlets = [&](const Mesh& mesh, const Mesh::Builder::PackedData& data) {
+        if (mesh.hasMeshlets()) {
+            upload(*mesh.meshletBuffer(), data.meshlets.data(),
+                   data.meshlets.size() * sizeof(Mesh::GpuMeshlet), 0);
+            upload(*mesh.meshletDataBuffer(), data.meshletData.data(),
+                   data.meshletData.size() * sizeof(uint32_t), 0);
+        }
+    };
+
+    if (!sharedBuffers_) {
+        for (size_t i = 0; i < builders_.size(); i++) {
+            auto vertexBuffer = createMeshVertexBuffer(device_, packed[i].vertexBytes(),
+                                                       !packed[i].meshlets.empty());
+            auto indexBuffer = Buffer::createIndexBuffer(device_, packed[i].indices.size());
+            upload(*vertexBuffer, packed[i].vertices.data(), packed[i].vertexBytes(), 0);
+            upload(*indexBuffer, packed[i].indices.data(), packed[i].indices.size(), 0);
+            meshes.push_back(builders_[i].finish(packed[i],
+                std::move(vertexBuffer), 0, std::move(indexBuffer), 0));
+            uploadMeshlets(*meshes.back(), packed[i]);
+        }
+    } else {
+        // Mesh shaders bind their vertex range as a storage buffer
+        bool storage = std::any_of(packed.begin(), packed.end(),
+            [](const Mesh::Builder::PackedData& data) { return !data.meshlets.empty(); });
+        VkDeviceSize vertexAlignment = 16;
+        if (storage) {
+            vertexAlignment = std::max<VkDeviceSize>(vertexAlignment,
+                device_->physicalDevice()->capabilities().properties.limits.minStorageBufferOffsetAlignment);
+        }
+
+        // Lay every mesh out in one vertex buffer and one index buffer
+        std::vector<VkDeviceSize> vertexOffsets(builders_.size());
+        std::vector<VkDeviceSize> indexOffsets(builders_.size());
+        VkDeviceSize vertexTotal = 0;
+        VkDeviceSize indexTotal = 0;
+        for (size_t i = 0; i < packed.size(); i++) {
+            // Start on a whole vertex so the range can also be drawn with the
+            // buffer bound at 0 and vertexOffset = offset / stride (GpuCuller)
+            VkDeviceSize stride = Vertex::stride(builders_[i].attrs_);
+            VkDeviceSize alignment = vertexAlignment / std::gcd(vertexAlignment, stride) * stride;
+            vertexOffsets[i] = vertexTotal = roundUpOffset(vertexTotal, alignment);
+            vertexTotal += packed[i].vertexBytes();
+            indexOffsets[i] = indexTotal = alignOffset(indexTotal, 4);
+            indexTotal += packed[i].indices.size();
+        }
+
+        std::shared_ptr<Buffer> vertexBuffer = createMeshVertexBuffer(device_, vertexTotal, storage);
+        std::shared_ptr<Buffer> indexBuffer = Buffer::createIndexBuffer(device_, indexTotal);
+
+        for (size_t i = 0; i < packed.size(); i++) {
+            upload(*vertexBuffer, packed[i].vertices.data(), packed[i].vertexBytes(), vertexOffsets[i]);
+            upload(*indexBuffer, packed[i].indices.data(), packed[i].indices.size(), indexOffsets[i]);
+            meshes.push_back(builders_[i].finish(packed[i],
+                vertexBuffer, vertexOffsets[i], indexBuffer, indexOffsets[i]));
+            uploadMeshlets(*meshes.back(), packed[i]);
+        }
+
+        FINEVK_DEBUG(LogCategory::Core, "MeshBatch packed " + std::to_string(meshes.size()) +
+            " meshes into " + std::to_string(vertexTotal) + " vertex bytes, " +
+            std::to_string(indexTotal) + " index bytes");
+    }
+
+    builders_.clear();
+    return meshes;
+}
+
+std::vector<MeshRef> MeshBatch::build(UploadManager& uploads) {
+    auto meshes = createMeshes(
+        [&uploads](Buffer& dst, const void* data, VkDeviceSize size, VkDeviceSize offset) {
+            uploads.uploadBuffer(dst, data, size, offset);
+        });
+    ticket_ = uploads.flush();
+    return meshes;
+}
+
+std::vector<MeshRef> MeshBatch::build(CommandPool* commandPool) {
+    if (!commandPool) {
+        throw std::runtime_error("Command pool required to build mesh batch");
+    }
+
+    // Gather all data into one CPU blob, then stage and copy in a single submission
+    struct PendingCopy {
+        Buffer* dst;
+        VkDeviceSize srcOffset;
+        VkDeviceSize dstOffset;
+        VkDeviceSize size;
+    };
+    std::vector<PendingCopy> copies;
+    std::vector<char> blob;
+
+    auto meshes = createMeshes(
+        [&](Buffer& dst, const void* data, VkDeviceSize size, VkDeviceSize offset) {
+            VkDeviceSize srcOffset = alignOffset(blob.size(), 16);
+            blob.resize(srcOffset + size);
+            std::memcpy(blob.data() + srcOffset, data, size);
+            copies.push_back({&dst, srcOffset, offset, size});
+        });
+    if (copies.empty()) {
+        return meshes;
+    }
+
+    auto staging = Buffer::createStagingBuffer(device_, blob.size());
+    std::memcpy(staging->mappedPtr(), blob.data(), blob.size());
+
+    auto imm = commandPool->beginImmediate();
+    for (const auto& copy : copies) {
+        imm.cmd().copyBuffer(*staging, *copy.dst, copy.size, copy.srcOffset, copy.dstOffset);
+    }
+    imm.submit();
+
+    return meshes;
+}
+
 } // namespace finevk
 
 // Hash implementation for Vertex
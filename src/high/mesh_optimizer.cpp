@@ -0,0 +1,728 @@
+#include "finevk/high/mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace finevk {
+namespace MeshOptimizer {
+
+namespace {
+
+constexpr uint32_t kNone = UINT32_MAX;
+
+// Forsyth's scoring parameters (LRU cache model)
+constexpr uint32_t kScoreCacheSize = 32;
+constexpr uint32_t kScoreValences = 32;     // Higher valences share the last entry
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+struct ScoreTables {
+    float cache[kScoreCacheSize];
+    float valence[kScoreValences];
+
+    ScoreTables() {
+        for (uint32_t i = 0; i < kScoreCacheSize; i++) {
+            if (i < 3) {
+                // The last triangle's vertices score the same, so the next
+                // triangle isn't biased towards one of its edges
+                cache[i] = kLastTriangleScore;
+            } else {
+                float scale = 1.0f / static_cast<float>(kScoreCacheSize - 3);
+                cache[i] = std::pow(1.0f - static_cast<float>(i - 3) * scale, kCacheDecayPower);
+            }
+        }
+        valence[0] = 0.0f;
+        for (uint32_t i = 1; i < kScoreValences; i++) {
+            valence[i] = kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+        }
+    }
+};
+
+float vertexScore(const ScoreTables& tables, uint32_t cachePosition, uint32_t liveTriangles) {
+    if (liveTriangles == 0) {
+        return -1.0f;
+    }
+    float score = cachePosition == kNone ? 0.0f : tables.cache[cachePosition];
+    return score + tables.valence[std::min(liveTriangles, kScoreValences - 1)];
+}
+
+void checkIndices(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    if (indices.size() % 3 != 0) {
+        throw std::runtime_error("Mesh optimization needs a triangle list");
+    }
+    for (uint32_t index : indices) {
+        if (index >= vertexCount) {
+            throw std::runtime_error("Mesh index out of range");
+        }
+    }
+}
+
+// FIFO post-transform cache: a vertex hits if it missed within the last
+// size misses. reset() forgets everything in O(1).
+class FifoCache {
+public:
+    FifoCache(size_t vertexCount, uint32_t size)
+        : stamps_(vertexCount, 0), size_(size), time_(size) {}
+
+    /// Misses for one triangle
+    uint32_t triangle(const uint32_t* tri) {
+        uint32_t misses = 0;
+        for (int i = 0; i < 3; i++) {
+            uint32_t& stamp = stamps_[tri[i]];
+            if (time_ - stamp >= size_) {
+                stamp = ++time_;
+                misses++;
+            }
+        }
+        return misses;
+    }
+
+    void reset() { time_ += size_; }
+
+private:
+    std::vector<uint32_t> stamps_;
+    uint32_t size_;
+    uint32_t time_;
+};
+
+// Sum of squared distances to area-weighted planes (Garland-Heckbert)
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    double b0 = 0, b1 = 0, b2 = 0;
+    double c = 0;
+    double weight = 0;
+
+    void addPlane(const glm::vec3& normal, float distance, float area) {
+        double x = normal.x, y = normal.y, z = normal.z, d = distance, w = area;
+        a00 += w * x * x; a01 += w * x * y; a02 += w * x * z;
+        a11 += w * y * y; a12 += w * y * z; a22 += w * z * z;
+        b0 += w * d * x; b1 += w * d * y; b2 += w * d * z;
+        c += w * d * d;
+        weight += w;
+    }
+
+    Quadric& operator+=(const Quadric& o) {
+        a00 += o.a00; a01 += o.a01; a02 += o.a02; a11 += o.a11; a12 += o.a12; a22 += o.a22;
+        b0 += o.b0; b1 += o.b1; b2 += o.b2;
+        c += o.c;
+        weight += o.weight;
+        return *this;
+    }
+
+    /// Mean squared distance of p to the planes
+    double error(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a00 * x * x + a11 * y * y + a22 * z * z +
+                   2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                   2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return weight > 0.0 ? std::max(e, 0.0) / weight : 0.0;
+    }
+};
+
+} // anonymous namespace
+
+float acmr(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    checkIndices(indices, vertexCount);
+    if (indices.empty()) {
+        return 0.0f;
+    }
+
+    FifoCache cache(vertexCount, cacheSize);
+    uint64_t misses = 0;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        misses += cache.triangle(&indices[i]);
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+    checkIndices(indices, vertexCount);
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+    static const ScoreTables tables;
+
+    // Vertex -> live triangles, compacted as triangles are emitted
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (uint32_t index : indices) {
+        live[index]++;
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + live[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<uint32_t> cachePosition(vertexCount, kNone);
+    std::vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        scores[v] = vertexScore(tables, kNone, live[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    uint32_t best = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] +
+                            scores[indices[t * 3 + 2]];
+        if (triangleScores[t] > triangleScores[best]) {
+            best = static_cast<uint32_t>(t);
+        }
+    }
+
+    auto updateScore = [&](uint32_t v) {
+        float score = vertexScore(tables, cachePosition[v], live[v]);
+        float delta = score - scores[v];
+        scores[v] = score;
+        for (uint32_t i = 0; i < live[v]; i++) {
+            triangleScores[adjacency[offsets[v] + i]] += delta;
+        }
+    };
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    std::vector<bool> emitted(triangleCount, false);
+    uint32_t cache[kScoreCacheSize + 3];
+    uint32_t next[kScoreCacheSize + 3];
+    uint32_t cacheCount = 0;
+    size_t cursor = 0;
+
+    for (size_t n = 0; n < triangleCount; n++) {
+        if (best == kNone) {
+            // Nothing cached has triangles left: continue from the input order
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best = static_cast<uint32_t>(cursor);
+        }
+
+        const uint32_t* tri = &indices[best * 3];
+        output.insert(output.end(), tri, tri + 3);
+        emitted[best] = true;
+
+        for (int k = 0; k < 3; k++) {
+            uint32_t* list = &adjacency[offsets[tri[k]]];
+            uint32_t count = live[tri[k]];
+            auto* found = std::find(list, list + count, best);
+            *found = list[count - 1];
+            live[tri[k]]--;
+        }
+
+        // Most recently used first: this triangle, then the old cache order
+        uint32_t nextCount = 0;
+        for (int k = 0; k < 3; k++) {
+            if (std::find(next, next + nextCount, tri[k]) == next + nextCount) {
+                next[nextCount++] = tri[k];
+            }
+        }
+        for (uint32_t i = 0; i < cacheCount; i++) {
+            uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                next[nextCount++] = v;
+            }
+        }
+        for (uint32_t i = kScoreCacheSize; i < nextCount; i++) {
+            cachePosition[next[i]] = kNone;
+            updateScore(next[i]);
+        }
+        cacheCount = std::min(nextCount, kScoreCacheSize);
+        for (uint32_t i = 0; i < cacheCount; i++) {
+            cache[i] = next[i];
+            cachePosition[cache[i]] = i;
+            updateScore(cache[i]);
+        }
+
+        // Only triangles touching the cache change score
+        best = kNone;
+        float bestScore = std::numeric_limits<float>::lowest();
+        for (uint32_t i = 0; i < cacheCount; i++) {
+            uint32_t v = cache[i];
+            for (uint32_t j = 0; j < live[v]; j++) {
+                uint32_t t = adjacency[offsets[v] + j];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                      float threshold) {
+    checkIndices(indices, vertices.size());
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // Hard boundaries: triangles missing all three vertices start over anyway
+    FifoCache cache(vertices.size(), DefaultCacheSize);
+    std::vector<uint32_t> misses(triangleCount);
+    uint64_t totalMisses = 0;
+    std::vector<size_t> hard;
+    for (size_t t = 0; t < triangleCount; t++) {
+        misses[t] = cache.triangle(&indices[t * 3]);
+        totalMisses += misses[t];
+        if (t == 0 || misses[t] == 3) {
+            hard.push_back(t);
+        }
+    }
+    hard.push_back(triangleCount);
+
+    // Soft boundaries: split once a run's own reuse is within threshold of
+    // the whole hard cluster's, so reordering runs costs little
+    std::vector<size_t> clusters;
+    for (size_t c = 0; c + 1 < hard.size(); c++) {
+        size_t start = hard[c];
+        size_t end = hard[c + 1];
+        uint32_t clusterMisses = 0;
+        for (size_t t = start; t < end; t++) {
+            clusterMisses += misses[t];
+        }
+        float limit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+        clusters.push_back(start);
+        cache.reset();
+        uint32_t runMisses = 0;
+        uint32_t runTriangles = 0;
+        for (size_t t = start; t + 1 < end; t++) {
+            runMisses += cache.triangle(&indices[t * 3]);
+            runTriangles++;
+            if (static_cast<float>(runMisses) <= limit * static_cast<float>(runTriangles)) {
+                clusters.push_back(t + 1);
+                cache.reset();
+                runMisses = 0;
+                runTriangles = 0;
+            }
+        }
+    }
+    if (clusters.size() < 2) {
+        return;
+    }
+    clusters.push_back(triangleCount);
+
+    // Area-weighted centroid and summed normal per cluster
+    size_t clusterCount = clusters.size() - 1;
+    std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+    std::vector<float> areas(clusterCount, 0.0f);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; c++) {
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            const glm::vec3& p0 = vertices[indices[t * 3]].position;
+            const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal) * 0.5f;
+            centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+            normals[c] += normal;
+            areas[c] += area;
+        }
+        meshCentroid += centroids[c];
+        meshArea += areas[c];
+    }
+    if (meshArea <= 0.0f) {
+        return;
+    }
+    meshCentroid /= meshArea;
+
+    // Clusters facing outward from the centre are likely occluders: draw first
+    std::vector<float> keys(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; c++) {
+        float length = glm::length(normals[c]);
+        if (areas[c] > 0.0f && length > 0.0f) {
+            keys[c] = glm::dot(centroids[c] / areas[c] - meshCentroid, normals[c] / length);
+        }
+    }
+    std::vector<uint32_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++) {
+        order[c] = static_cast<uint32_t>(c);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (uint32_t c : order) {
+        sorted.insert(sorted.end(), indices.begin() + clusters[c] * 3,
+                      indices.begin() + clusters[c + 1] * 3);
+    }
+
+    float before = static_cast<float>(totalMisses) / static_cast<float>(triangleCount);
+    if (acmr(sorted, vertices.size()) <= before * threshold) {
+        indices.swap(sorted);
+    }
+}
+
+void optimizeVertexFetch(std::vector<uint32_t>& indices, std::vector<Vertex>& vertices) {
+    checkIndices(indices, vertices.size());
+
+    std::vector<uint32_t> remap(vertices.size(), kNone);
+    std::vector<Vertex> ordered;
+    ordered.reserve(vertices.size());
+    for (uint32_t& index : indices) {
+        if (remap[index] == kNone) {
+            remap[index] = static_cast<uint32_t>(ordered.size());
+            ordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(ordered);
+}
+
+std::vector<uint32_t> simplify(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                               size_t targetIndexCount, float maxError, float* resultError) {
+    checkIndices(indices, vertices.size());
+    std::vector<uint32_t> result = indices;
+    if (resultError) {
+        *resultError = 0.0f;
+    }
+    if (result.size() <= targetIndexCount) {
+        return result;
+    }
+    size_t vertexCount = vertices.size();
+
+    // Weld by position: canonical[v] is one vertex standing for v's position
+    std::vector<uint32_t> canonical(vertexCount);
+    {
+        std::vector<uint32_t> order(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) {
+            order[v] = static_cast<uint32_t>(v);
+        }
+        auto less = [&](uint32_t a, uint32_t b) {
+            const glm::vec3& p = vertices[a].position;
+            const glm::vec3& q = vertices[b].position;
+            return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z < q.z;
+        };
+        std::sort(order.begin(), order.end(), less);
+        for (size_t i = 0; i < vertexCount; i++) {
+            bool same = i > 0 && !less(order[i - 1], order[i]);
+            canonical[order[i]] = same ? canonical[order[i - 1]] : order[i];
+        }
+    }
+
+    // Lock seams (several referenced vertices at one position), open borders
+    // and non-manifold edges
+    std::vector<uint8_t> locked(vertexCount, 0);
+    {
+        std::vector<uint32_t> wedge(vertexCount, kNone);
+        for (uint32_t index : result) {
+            uint32_t& seen = wedge[canonical[index]];
+            if (seen == kNone) {
+                seen = index;
+            } else if (seen != index) {
+                locked[canonical[index]] = 1;
+            }
+        }
+
+        std::vector<uint64_t> edges;
+        edges.reserve(result.size());
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int e = 0; e < 3; e++) {
+                uint32_t a = canonical[result[i + e]];
+                uint32_t b = canonical[result[i + (e + 1) % 3]];
+                if (a != b) {
+                    edges.push_back((static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b));
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i;
+            while (j < edges.size() && edges[j] == edges[i]) {
+                j++;
+            }
+            if (j - i != 2) {
+                locked[edges[i] >> 32] = 1;
+                locked[edges[i] & 0xFFFFFFFF] = 1;
+            }
+            i = j;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < result.size(); i += 3) {
+        uint32_t c0 = canonical[result[i]];
+        uint32_t c1 = canonical[result[i + 1]];
+        uint32_t c2 = canonical[result[i + 2]];
+        const glm::vec3& p0 = vertices[c0].position;
+        glm::vec3 normal = glm::cross(vertices[c1].position - p0, vertices[c2].position - p0);
+        float length = glm::length(normal);
+        if (length == 0.0f) {
+            continue;
+        }
+        normal = normal / length;
+        float distance = -glm::dot(normal, p0);
+        float area = length * 0.5f;
+        quadrics[c0].addPlane(normal, distance, area);
+        quadrics[c1].addPlane(normal, distance, area);
+        quadrics[c2].addPlane(normal, distance, area);
+    }
+
+    struct Collapse {
+        uint32_t from;  // Vertex indices, not canonical
+        uint32_t to;
+        double cost;
+    };
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> offsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    double limit = static_cast<double>(maxError) * maxError;
+    double worst = 0.0;
+
+    // Each pass collapses non-overlapping edges, cheapest first
+    while (result.size() > targetIndexCount) {
+        size_t triangleCount = result.size() / 3;
+
+        // Canonical vertex -> triangles
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (uint32_t index : result) {
+            offsets[canonical[index] + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++) {
+                adjacency[fill[canonical[result[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // An interior edge shows up once per direction (once per triangle)
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int e = 0; e < 3; e++) {
+                uint32_t from = result[i + e];
+                uint32_t to = result[i + (e + 1) % 3];
+                uint32_t cf = canonical[from];
+                uint32_t ct = canonical[to];
+                if (cf == ct || locked[cf]) {
+                    continue;
+                }
+                Quadric merged = quadrics[cf];
+                merged += quadrics[ct];
+                collapses.push_back({from, to, merged.error(vertices[ct].position)});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        // Moving cf onto ct must not turn any of cf's other triangles over
+        auto flips = [&](uint32_t cf, uint32_t ct) {
+            const glm::vec3& target = vertices[ct].position;
+            for (uint32_t i = offsets[cf]; i < offsets[cf + 1]; i++) {
+                const uint32_t* tri = &result[adjacency[i] * 3];
+                glm::vec3 p[3];
+                bool shared = false;
+                int moved = 0;
+                for (int k = 0; k < 3; k++) {
+                    uint32_t c = canonical[tri[k]];
+                    shared = shared || c == ct;
+                    moved = c == cf ? k : moved;
+                    p[k] = vertices[c].position;
+                }
+                if (shared) {
+                    continue;  // Degenerates and is dropped
+                }
+                glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                p[moved] = target;
+                glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+                if (glm::dot(before, after) < 0.25f * glm::length(before) * glm::length(after)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (size_t v = 0; v < vertexCount; v++) {
+            remap[v] = static_cast<uint32_t>(v);
+        }
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t goal = triangleCount - targetIndexCount / 3;
+        size_t removed = 0;
+        for (const Collapse& collapse : collapses) {
+            if (collapse.cost > limit || removed >= goal) {
+                break;
+            }
+            uint32_t cf = canonical[collapse.from];
+            uint32_t ct = canonical[collapse.to];
+            if (touched[cf] || touched[ct] || flips(cf, ct)) {
+                continue;
+            }
+
+            remap[collapse.from] = collapse.to;
+            quadrics[ct] += quadrics[cf];
+            worst = std::max(worst, collapse.cost);
+
+            // Everything around cf changes; later collapses this pass stay clear of it
+            for (uint32_t i = offsets[cf]; i < offsets[cf + 1]; i++) {
+                const uint32_t* tri = &result[adjacency[i] * 3];
+                bool degenerate = false;
+                for (int k = 0; k < 3; k++) {
+                    touched[canonical[tri[k]]] = 1;
+                    degenerate = degenerate || canonical[tri[k]] == ct;
+                }
+                removed += degenerate ? 1 : 0;
+            }
+        }
+        if (removed == 0) {
+            break;  // Nothing left under the error limit
+        }
+
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            uint32_t a = remap[result[i]];
+            uint32_t b = remap[result[i + 1]];
+            uint32_t c = remap[result[i + 2]];
+            if (canonical[a] == canonical[b] || canonical[b] == canonical[c] ||
+                canonical[a] == canonical[c]) {
+                continue;
+            }
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (resultError) {
+        *resultError = static_cast<float>(std::sqrt(worst));
+    }
+    return result;
+}
+
+// ============================================================================
+// Meshlets
+// ============================================================================
+
+namespace {
+
+MeshletBounds meshletBounds(const Meshlets& result, const Meshlet& meshlet,
+                            const std::vector<Vertex>& vertices) {
+    MeshletBounds bounds;
+    const uint32_t* local = result.vertices.data() + meshlet.vertexOffset;
+
+    // Sphere around the box centre: not minimal, but cheap and tight enough
+    glm::vec3 lo = vertices[local[0]].position;
+    glm::vec3 hi = lo;
+    for (uint32_t i = 1; i < meshlet.vertexCount; i++) {
+        const glm::vec3& p = vertices[local[i]].position;
+        lo = glm::vec3(std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z));
+        hi = glm::vec3(std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z));
+    }
+    bounds.center = (lo + hi) * 0.5f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        bounds.radius = std::max(bounds.radius, glm::length(vertices[local[i]].position - bounds.center));
+    }
+
+    // Normal cone: axis is the mean face normal, cutoff from the widest face
+    std::vector<glm::vec3> normals;
+    normals.reserve(meshlet.triangleCount);
+    glm::vec3 sum(0.0f);
+    const uint8_t* tri = result.triangles.data() + meshlet.triangleOffset * 3;
+    for (uint32_t t = 0; t < meshlet.triangleCount; t++, tri += 3) {
+        const glm::vec3& a = vertices[local[tri[0]]].position;
+        const glm::vec3& b = vertices[local[tri[1]]].position;
+        const glm::vec3& c = vertices[local[tri[2]]].position;
+        glm::vec3 n = glm::cross(b - a, c - a);
+        float area = glm::length(n);
+        if (area > 0.0f) {
+            normals.push_back(n / area);
+            sum += normals.back();
+        }
+    }
+    float length = glm::length(sum);
+    if (normals.empty() || length <= 0.0f) {
+        return bounds;
+    }
+    bounds.coneAxis = sum / length;
+    float minDot = 1.0f;
+    for (const auto& n : normals) {
+        minDot = std::min(minDot, glm::dot(n, bounds.coneAxis));
+    }
+    // Normals spanning a hemisphere or more leave the cone uncullable
+    bounds.coneCutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    return bounds;
+}
+
+} // anonymous namespace
+
+Meshlets buildMeshlets(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                       uint32_t maxVertices, uint32_t maxTriangles) {
+    checkIndices(indices, vertices.size());
+    if (maxVertices < 3 || maxVertices > 256 || maxTriangles < 1) {
+        throw std::runtime_error("Meshlet limits need 3-256 vertices and at least one triangle");
+    }
+
+    Meshlets result;
+    size_t triangleCount = indices.size() / 3;
+    size_t estimate = triangleCount / maxTriangles + 1;
+    result.meshlets.reserve(estimate);
+    result.vertices.reserve(estimate * maxVertices);
+    result.triangles.reserve(indices.size());
+
+    // Local index of each mesh vertex in the open meshlet (kNone = absent)
+    std::vector<uint32_t> local(vertices.size(), kNone);
+    Meshlet current;
+
+    auto close = [&]() {
+        if (current.triangleCount == 0) {
+            return;
+        }
+        for (uint32_t i = 0; i < current.vertexCount; i++) {
+            local[result.vertices[current.vertexOffset + i]] = kNone;
+        }
+        result.meshlets.push_back(current);
+        current.vertexOffset += current.vertexCount;
+        current.triangleOffset += current.triangleCount;
+        current.vertexCount = 0;
+        current.triangleCount = 0;
+    };
+
+    for (size_t t = 0; t < triangleCount; t++) {
+        const uint32_t* tri = &indices[t * 3];
+        uint32_t added = (local[tri[0]] == kNone) + (local[tri[1]] == kNone) +
+                         (local[tri[2]] == kNone);
+        // Repeated indices in a degenerate triangle are counted twice; harmless
+        if (current.vertexCount + added > maxVertices || current.triangleCount == maxTriangles) {
+            close();
+        }
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = tri[k];
+            if (local[v] == kNone) {
+                local[v] = current.vertexCount++;
+                result.vertices.push_back(v);
+            }
+            result.triangles.push_back(static_cast<uint8_t>(local[v]));
+        }
+        current.triangleCount++;
+    }
+    close();
+
+    result.bounds.reserve(result.meshlets.size());
+    for (const auto& meshlet : result.meshlets) {
+        result.bounds.push_back(meshletBounds(result, meshlet, vertices));
+    }
+    return result;
+}
+
+} // namespace MeshOptimizer
+} // namespace finevk
@@ -0,0 +1,279 @@
+#include "finevk/high/mip_generator.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/rendering/descriptors.hpp"
+#include "finevk/rendering/pipeline.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+constexpr uint32_t kTileSize = 64;          // Source texels per workgroup side
+constexpr uint32_t kLevelsPerTile = 6;      // log2(kTileSize)
+constexpr uint32_t kMipBindings = MipGenerator::MaxLevelsPerDispatch + 1;
+
+} // namespace
+
+// Views and descriptors referenced by recorded commands
+struct MipGenerator::Batch {
+    DescriptorPoolPtr pool;
+    BufferPtr counters;
+    std::vector<ImageViewPtr> views;
+};
+
+// ============================================================================
+// MipGenerator::Builder implementation
+// ============================================================================
+
+MipGenerator::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+MipGenerator::Builder& MipGenerator::Builder::shader(ShaderModule* module) {
+    shader_ = module;
+    return *this;
+}
+
+MipGeneratorPtr MipGenerator::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("MipGenerator requires a device");
+    }
+    if (!shader_) {
+        throw std::runtime_error("MipGenerator requires the mip_downsample compute shader");
+    }
+
+    auto generator = MipGeneratorPtr(new MipGenerator());
+    generator->device_ = device_;
+
+    auto* physical = device_->physicalDevice();
+    auto props = physical->capabilities().formatProperties(physical->handle(),
+                                                           VK_FORMAT_R8G8B8A8_UNORM);
+    generator->storageSupported_ =
+        (props.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+
+    generator->setLayout_ = DescriptorSetLayout::create(device_)
+        .binding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, kMipBindings)
+        .storageBuffer(1, VK_SHADER_STAGE_COMPUTE_BIT)
+        .build();
+
+    generator->pipelineLayout_ = PipelineLayout::create(device_)
+        .addDescriptorSetLayout(generator->setLayout_->handle())
+        .addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Params))
+        .build();
+
+    generator->pipeline_ = ComputePipeline::create(device_, generator->pipelineLayout_.get())
+        .shader(shader_)
+        .build();
+
+    return generator;
+}
+
+MipGenerator::Builder MipGenerator::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+// ============================================================================
+// MipGenerator implementation
+// ============================================================================
+
+MipGenerator::~MipGenerator() = default;
+
+VkImageCreateFlags MipGenerator::requiredFlags(VkFormat format) {
+    // Storage views are UNORM; sRGB images need to allow the reinterpretation
+    return format == VK_FORMAT_R8G8B8A8_SRGB ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT : 0;
+}
+
+bool MipGenerator::supports(const Image& image) const {
+    if (!storageSupported_) {
+        return false;
+    }
+    if (image.format() != VK_FORMAT_R8G8B8A8_UNORM && image.format() != VK_FORMAT_R8G8B8A8_SRGB) {
+        return false;
+    }
+    if (image.arrayLayers() != 1) {
+        return false;
+    }
+    VkImageCreateFlags flags = requiredFlags(image.format());
+    return (image.usage() & RequiredUsage) == RequiredUsage &&
+           (image.flags() & flags) == flags;
+}
+
+std::vector<MipGenerator::Pass> MipGenerator::planPasses(const std::vector<Image*>& images) {
+    std::vector<Pass> passes;
+    for (Image* image : images) {
+        uint32_t base = 0;
+        uint32_t round = 0;
+        while (base + 1 < image->mipLevels()) {
+            // The last workgroup can only take over if level base+6 fits one tile
+            uint32_t width = std::max(1u, image->width() >> base);
+            uint32_t height = std::max(1u, image->height() >> base);
+            bool fitsTile = (width >> kLevelsPerTile) <= kTileSize &&
+                            (height >> kLevelsPerTile) <= kTileSize;
+            uint32_t count = std::min(fitsTile ? MaxLevelsPerDispatch : kLevelsPerTile,
+                                      image->mipLevels() - 1 - base);
+            passes.push_back({image, base, count, round++});
+            base += count;
+        }
+    }
+
+    std::stable_sort(passes.begin(), passes.end(),
+                     [](const Pass& a, const Pass& b) { return a.round < b.round; });
+    return passes;
+}
+
+MipGenerator::BatchRef MipGenerator::record(CommandBuffer& cmd, const std::vector<Image*>& images,
+                                            VkImageLayout oldLayout, VkImageLayout finalLayout) {
+    for (Image* image : images) {
+        if (!image || !supports(*image)) {
+            throw std::runtime_error("MipGenerator: image must be RGBA8 with storage usage "
+                                     "(and MUTABLE_FORMAT when sRGB)");
+        }
+    }
+
+    auto batch = std::make_shared<Batch>();
+    std::vector<Pass> passes = planPasses(images);
+    if (passes.empty()) {
+        return batch;
+    }
+    uint32_t passCount = static_cast<uint32_t>(passes.size());
+
+    batch->pool = DescriptorPool::create(device_)
+        .maxSets(passCount)
+        .poolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMipBindings * passCount)
+        .poolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, passCount)
+        .build();
+    batch->counters = Buffer::create(device_)
+        .size(sizeof(uint32_t) * passCount)
+        .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+
+    // One set per pass: views of the source level and each level it writes
+    std::vector<VkDescriptorSet> sets(passCount);
+    for (uint32_t i = 0; i < passCount; i++) {
+        const Pass& pass = passes[i];
+        sets[i] = batch->pool->allocate(setLayout_.get());
+
+        std::array<VkDescriptorImageInfo, kMipBindings> imageInfos{};
+        for (uint32_t level = 0; level < kMipBindings; level++) {
+            if (level <= pass.count) {
+                batch->views.push_back(pass.image->createView(
+                    VK_IMAGE_ASPECT_COLOR_BIT, pass.base + level, 1, VK_FORMAT_R8G8B8A8_UNORM));
+            }
+            // Unused slots repeat the last level; the shader never touches them
+            imageInfos[level].imageView = batch->views.back()->handle();
+            imageInfos[level].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = sets[i];
+        write.dstBinding = 0;
+        write.descriptorCount = kMipBindings;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        write.pImageInfo = imageInfos.data();
+        vkUpdateDescriptorSets(device_->handle(), 1, &write, 0, nullptr);
+
+        DescriptorWriter(device_)
+            .writeBuffer(sets[i], 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *batch->counters)
+            .update();
+    }
+
+    // Level 0 keeps its contents; later levels are discarded
+    std::vector<VkImageMemoryBarrier> toGeneral;
+    std::vector<VkImageMemoryBarrier> toFinal;
+    for (Image* image : images) {
+        if (image->mipLevels() <= 1) {
+            continue;
+        }
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image->handle();
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.layerCount = 1;
+
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        toGeneral.push_back(barrier);
+
+        barrier.srcAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.subresourceRange.baseMipLevel = 1;
+        barrier.subresourceRange.levelCount = image->mipLevels() - 1;
+        toGeneral.push_back(barrier);
+
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.newLayout = finalLayout;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = image->mipLevels();
+        toFinal.push_back(barrier);
+    }
+
+    cmd.fillBuffer(*batch->counters, 0);
+
+    VkMemoryBarrier counterBarrier{};
+    counterBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    counterBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    counterBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        0, {counterBarrier}, {}, toGeneral);
+
+    pipeline_->bind(cmd.handle());
+    for (uint32_t i = 0; i < passCount; i++) {
+        const Pass& pass = passes[i];
+        if (i > 0 && pass.round != passes[i - 1].round) {
+            // Later passes read the last level written by the previous round
+            cmd.memoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                              VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+        }
+
+        Params params{};
+        params.levelCount = pass.count;
+        params.srgb = pass.image->format() == VK_FORMAT_R8G8B8A8_SRGB ? 1u : 0u;
+        params.counterIndex = i;
+
+        vkCmdBindDescriptorSets(cmd.handle(), VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pipelineLayout_->handle(), 0, 1, &sets[i], 0, nullptr);
+        cmd.pushConstants(pipelineLayout_->handle(), VK_SHADER_STAGE_COMPUTE_BIT,
+                          0, sizeof(Params), &params);
+
+        uint32_t width = std::max(1u, pass.image->width() >> pass.base);
+        uint32_t height = std::max(1u, pass.image->height() >> pass.base);
+        cmd.dispatch((width + kTileSize - 1) / kTileSize, (height + kTileSize - 1) / kTileSize);
+    }
+
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        0, {}, {}, toFinal);
+
+    FINEVK_TRACE(LogCategory::Core, "MipGenerator: " + std::to_string(passCount) +
+                 " dispatches for " + std::to_string(images.size()) + " images");
+    return batch;
+}
+
+SubmitTicket MipGenerator::generate(CommandPool* pool, const std::vector<Image*>& images,
+                                    VkImageLayout oldLayout, VkImageLayout finalLayout) {
+    auto imm = pool->beginImmediate();
+    BatchRef batch = record(imm.cmd(), images, oldLayout, finalLayout);
+    SubmitTicket ticket = imm.submitAsync();
+    ticket.keepAlive(std::move(batch));
+    return ticket;
+}
+
+} // namespace finevk
@@ -2,11 +2,14 @@
 #include "finevk/core/instance.hpp"
 #include "finevk/core/surface.hpp"
 #include "finevk/core/logging.hpp"
+#include "finevk/core/small_vector.hpp"
 #include "finevk/device/physical_device.hpp"
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/image.hpp"
 #include "finevk/device/sampler.hpp"
 #include "finevk/device/command.hpp"
+#include "finevk/device/gpu_profiler.hpp"
+#include "finevk/device/submit_batch.hpp"
 #include "finevk/rendering/swapchain.hpp"
 #include "finevk/rendering/renderpass.hpp"
 #include "finevk/rendering/framebuffer.hpp"
@@ -80,12 +83,27 @@ std::unique_ptr<SimpleRenderer> SimpleRenderer::create(
     }
     renderer->createFramebuffers();
 
-    // Create command buffers for each frame in flight
-    uint32_t framesInFlight = window->framesInFlight();
-    renderer->commandBuffers_.reserve(framesInFlight);
-    for (uint32_t i = 0; i < framesInFlight; i++) {
-        renderer->commandBuffers_.push_back(
-            renderer->commandPool_->allocate());
+    // Create command buffers for every frame slot, so frames in flight can change
+    uint32_t framesInFlight = window->maxFramesInFlight();
+    if (config.frameCommandPools) {
+        renderer->framePools_ = std::make_unique<FrameCommandPools>(
+            renderer->device(), renderer->device()->graphicsQueue(),
+            framesInFlight, std::max(1u, config.recordingThreads));
+    } else {
+        renderer->commandBuffers_.reserve(framesInFlight);
+        for (uint32_t i = 0; i < framesInFlight; i++) {
+            renderer->commandBuffers_.push_back(
+                renderer->commandPool_->allocate());
+        }
+    }
+
+    renderer->frameSubmit_ = std::make_unique<SubmitBatch>(renderer->device()->graphicsQueue());
+
+    if (config.gpuProfiling || config.pipelineStatistics) {
+        renderer->gpuProfiler_ = GpuProfiler::create(renderer->device())
+            .framesInFlight(framesInFlight)
+            .pipelineStatistics(config.pipelineStatistics)
+            .build();
     }
 
     // Register for device destruction notification so we can clean up
@@ -94,6 +112,10 @@ std::unique_ptr<SimpleRenderer> SimpleRenderer::create(
         [r = renderer.get()](LogicalDevice*) {
             // Clean up all device-dependent resources
             r->commandBuffers_.clear();
+            r->framePools_.reset();
+            r->gpuProfiler_.reset();
+            r->readback_.reset();
+            r->frameCmd_ = nullptr;
             r->commandPool_ = nullptr;  // Non-owning, just clear the pointer
             r->framebuffers_.reset();
             r->colorView_.reset();
@@ -190,14 +212,13 @@ void SimpleRenderer::createFramebuffers() {
             renderPass_.get(),
             depthView_.get());
     }
+    swapChainGeneration_ = swapChain()->generation();
 }
 
 void SimpleRenderer::recreateResources() {
-    // Called when window resize is detected
-    // Wait for device idle before recreating
-    device()->waitIdle();
-
-    cleanupResources();
+    // Called when window resize is detected. Frames in flight may still use
+    // the old attachments, so they are retired instead of waited for.
+    retireResources();
 
     if (msaaSamples_ != VK_SAMPLE_COUNT_1_BIT) {
         createColorResources();
@@ -212,6 +233,24 @@ void SimpleRenderer::recreateResources() {
         std::to_string(extent().height));
 }
 
+void SimpleRenderer::retireResources() {
+    // Members destroy in reverse: framebuffers, then views, then images
+    struct Retired {
+        ImagePtr depthImage;
+        ImageViewPtr depthView;
+        ImagePtr colorImage;
+        ImageViewPtr colorView;
+        std::unique_ptr<SwapChainFramebuffers> framebuffers;
+    };
+    auto retired = std::make_shared<Retired>();
+    retired->framebuffers = std::move(framebuffers_);
+    retired->colorView = std::move(colorView_);
+    retired->colorImage = std::move(colorImage_);
+    retired->depthView = std::move(depthView_);
+    retired->depthImage = std::move(depthImage_);
+    window_->retire([retired]() mutable { retired.reset(); });
+}
+
 void SimpleRenderer::cleanupResources() {
     framebuffers_.reset();
     colorView_.reset();
@@ -233,6 +272,20 @@ uint32_t SimpleRenderer::framesInFlight() const {
     return window_->framesInFlight();
 }
 
+ImageReadback& SimpleRenderer::readback() {
+    if (!readback_) {
+        readback_ = ImageReadback::create(device()).framesInFlight(window_->maxFramesInFlight()).build();
+        if (frameInProgress_) {
+            readback_->beginFrame(currentFrameInfo_->frameIndex);
+        }
+    }
+    return *readback_;
+}
+
+uint32_t SimpleRenderer::maxFramesInFlight() const {
+    return window_->maxFramesInFlight();
+}
+
 uint32_t SimpleRenderer::currentFrame() const {
     return window_->currentFrame();
 }
@@ -260,21 +313,32 @@ FrameBeginResult SimpleRenderer::beginFrame() {
     currentFrameInfo_ = *frameOpt;
     currentImageIndex_ = currentFrameInfo_->imageIndex;
 
-    // Check if we need to recreate our resources
-    auto currentExtent = extent();
-    if (framebuffers_ && framebuffers_->count() > 0) {
-        // Check if size changed - if so, recreate
-        auto fbExtent = (*framebuffers_)[0].extent();
-        if (fbExtent.width != currentExtent.width ||
-            fbExtent.height != currentExtent.height) {
-            recreateResources();
-        }
+    // Recreate our resources if the swap chain was (resize or present mode switch)
+    if (framebuffers_ && swapChain()->generation() != swapChainGeneration_) {
+        recreateResources();
+    }
+
+    // Begin command buffer. In frame-ring mode the frame's fence has already
+    // been waited on by Window, so its pools can be reset wholesale.
+    if (framePools_) {
+        framePools_->beginFrame(currentFrameInfo_->frameIndex);
+        extraPrimaries_.clear();
+        frameCmd_ = &framePools_->acquire(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        frameCmd_->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    } else {
+        frameCmd_ = commandBuffers_[currentFrameInfo_->frameIndex].get();
+        frameCmd_->reset();
+        frameCmd_->begin();
     }
+    auto& cmd = *frameCmd_;
 
-    // Begin command buffer
-    auto& cmd = *commandBuffers_[currentFrameInfo_->frameIndex];
-    cmd.reset();
-    cmd.begin();
+    if (gpuProfiler_) {
+        gpuProfiler_->beginFrame(cmd, currentFrameInfo_->frameIndex);
+        cmd.setProfiler(gpuProfiler_.get());
+    }
+    if (readback_) {
+        readback_->beginFrame(currentFrameInfo_->frameIndex);
+    }
 
     result.success = true;
     result.imageIndex = currentImageIndex_;
@@ -284,15 +348,15 @@ FrameBeginResult SimpleRenderer::beginFrame() {
     return result;
 }
 
-void SimpleRenderer::beginRenderPass(const glm::vec4& clearColor) {
+void SimpleRenderer::beginRenderPass(const glm::vec4& clearColor, VkSubpassContents contents) {
     if (!frameInProgress_ || !currentFrameInfo_) {
         return;
     }
 
-    auto& cmd = *commandBuffers_[currentFrameInfo_->frameIndex];
+    auto& cmd = *frameCmd_;
     auto& framebuffer = (*framebuffers_)[currentImageIndex_];
 
-    std::vector<VkClearValue> clearValues;
+    SmallVector<VkClearValue, 3> clearValues;
 
     // Color clear (MSAA or direct)
     VkClearValue colorClear{};
@@ -315,19 +379,21 @@ void SimpleRenderer::beginRenderPass(const glm::vec4& clearColor) {
     renderArea.offset = {0, 0};
     renderArea.extent = currentFrameInfo_->extent;
 
-    cmd.beginRenderPass(
-        renderPass_->handle(),
-        framebuffer.handle(),
-        renderArea,
-        clearValues);
-
-    // Set viewport and scissor
+    // Set viewport and scissor before the pass: a subpass recorded with
+    // secondary contents allows no other commands in the primary
     cmd.setViewport(0, 0,
         static_cast<float>(currentFrameInfo_->extent.width),
         static_cast<float>(currentFrameInfo_->extent.height));
     cmd.setScissor(0, 0,
         currentFrameInfo_->extent.width,
         currentFrameInfo_->extent.height);
+
+    cmd.beginRenderPass(
+        renderPass_->handle(),
+        framebuffer.handle(),
+        renderArea,
+        clearValues,
+        contents);
 }
 
 void SimpleRenderer::endRenderPass() {
@@ -335,7 +401,7 @@ void SimpleRenderer::endRenderPass() {
         return;
     }
 
-    commandBuffers_[currentFrameInfo_->frameIndex]->endRenderPass();
+    frameCmd_->endRenderPass();
 }
 
 bool SimpleRenderer::endFrame() {
@@ -343,43 +409,82 @@ bool SimpleRenderer::endFrame() {
         return false;
     }
 
-    auto& cmd = *commandBuffers_[currentFrameInfo_->frameIndex];
+    auto& cmd = *frameCmd_;
+    if (gpuProfiler_) {
+        gpuProfiler_->endFrame(cmd);
+        cmd.setProfiler(nullptr);
+    }
     cmd.end();
 
-    // Submit to queue with sync objects from Window's FrameInfo
-    VkSemaphore waitSemaphores[] = {currentFrameInfo_->imageAvailable};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    VkSemaphore signalSemaphores[] = {currentFrameInfo_->renderFinished};
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
-    submitInfo.commandBufferCount = 1;
-    VkCommandBuffer cmdHandle = cmd.handle();
-    submitInfo.pCommandBuffers = &cmdHandle;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
-
-    VkResult result = vkQueueSubmit(
-        device()->graphicsQueue()->handle(),
-        1, &submitInfo,
-        currentFrameInfo_->inFlightFence);
+    frameStats_.commands = framePools_ ? framePools_->stats() : cmd.stats();
+    if (gpuProfiler_) {
+        const auto& timings = gpuProfiler_->results();
+        frameStats_.gpuMilliseconds = timings.totalMilliseconds;
+        frameStats_.pipeline = timings.pipeline;
+        frameStats_.hasPipelineStatistics = timings.hasPipelineStatistics;
+    }
 
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error("Failed to submit draw command buffer");
+    // One submission per frame: work queued through submission() first,
+    // then the frame's batch waiting on the swap chain image and waitFor()
+    // points, each at its own stage
+    SubmitBatch& batch = *frameSubmit_;
+    batch.next().wait(currentFrameInfo_->imageAvailable, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+    for (size_t i = 0; i < frameWaits_.size(); i++) {
+        batch.wait(frameWaits_[i], frameWaitStages_[i]);
+    }
+    for (VkCommandBuffer primary : extraPrimaries_) {
+        batch.add(primary);
     }
+    batch.add(cmd)
+         .signal(currentFrameInfo_->renderFinished, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR)
+         .fence(currentFrameInfo_->inFlightFence);
+
+    // Through Queue so the frame advances the graphics queue timeline
+    batch.submit();
 
     // Present via Window
     bool presented = window_->endFrame();
 
     frameInProgress_ = false;
+    frameCmd_ = nullptr;
+    extraPrimaries_.clear();
+    frameWaits_.clear();
+    frameWaitStages_.clear();
     currentFrameInfo_.reset();
 
     return presented;
 }
 
+CommandBuffer& SimpleRenderer::acquireCommandBuffer(uint32_t thread, VkCommandBufferLevel level) {
+    if (!framePools_) {
+        throw std::runtime_error("SimpleRenderer::acquireCommandBuffer requires RendererConfig::frameCommandPools");
+    }
+    if (!frameInProgress_) {
+        throw std::runtime_error("SimpleRenderer::acquireCommandBuffer called outside a frame");
+    }
+
+    CommandBuffer& cmd = framePools_->acquire(thread, level);
+    if (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY) {
+        extraPrimaries_.push_back(cmd.handle());
+    }
+    return cmd;
+}
+
+void SimpleRenderer::waitFor(const TimelinePoint& point, VkPipelineStageFlags2KHR stages) {
+    if (!frameInProgress_) {
+        throw std::runtime_error("SimpleRenderer::waitFor called outside a frame");
+    }
+    frameWaits_.push_back(point);
+    frameWaitStages_.push_back(stages);
+}
+
+SubmitBatch& SimpleRenderer::submission() {
+    if (!frameInProgress_) {
+        throw std::runtime_error("SimpleRenderer::submission called outside a frame");
+    }
+    return *frameSubmit_;
+}
+
 void SimpleRenderer::onResize() {
     recreateResources();
 }
@@ -406,7 +511,7 @@ Sampler* SimpleRenderer::defaultSampler() {
             builder.anisotropy(maxAnisotropy);
         }
 
-        defaultSampler_ = builder.build();
+        defaultSampler_ = builder.buildShared();
     }
     return defaultSampler_.get();
 }
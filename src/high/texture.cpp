@@ -1,4 +1,10 @@
 #include "finevk/high/texture.hpp"
+#include "finevk/high/bindless.hpp"
+#include "finevk/high/texture_container.hpp"
+#include "finevk/high/format_utils.hpp"
+#include "finevk/high/mip_generator.hpp"
+#include "finevk/high/asset_loader.hpp"
+#include "finevk/core/asset_pack.hpp"
 #include "finevk/device/logical_device.hpp"
 #include "finevk/device/physical_device.hpp"
 #include "finevk/device/buffer.hpp"
@@ -11,6 +17,7 @@
 #include <stdexcept>
 #include <cmath>
 #include <algorithm>
+#include <cstring>
 
 namespace finevk {
 
@@ -48,14 +55,24 @@ Texture::Builder& Texture::Builder::srgb(bool enable) {
     return *this;
 }
 
+Texture::Builder& Texture::Builder::mipGenerator(MipGenerator* generator) {
+    mipGenerator_ = generator;
+    return *this;
+}
+
 TextureRef Texture::Builder::build() {
     if (sourceType_ == SourceType::File) {
-        return Texture::fromFile(device_, path_, commandPool_, generateMipmaps_, srgb_);
+        return Texture::fromFile(device_, path_, commandPool_, generateMipmaps_, srgb_, mipGenerator_);
     } else {
-        return Texture::fromMemory(device_, data_, width_, height_, commandPool_, generateMipmaps_, srgb_);
+        return Texture::fromMemory(device_, data_, width_, height_, commandPool_, generateMipmaps_, srgb_,
+                                   mipGenerator_);
     }
 }
 
+AsyncTextureRef Texture::Builder::buildAsync(AssetLoader& loader) const {
+    return loader.load(*this);
+}
+
 Texture::Builder Texture::load(LogicalDevice* device, CommandPool* commandPool, const std::string& path) {
     return Builder(device, commandPool, path);
 }
@@ -73,6 +90,54 @@ uint32_t calculateMipLevels(uint32_t width, uint32_t height) {
     return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
 }
 
+std::vector<uint8_t> downsampleRGBA8(const std::vector<uint8_t>& src, uint32_t width, uint32_t height) {
+    uint32_t dstWidth = std::max(1u, width / 2);
+    uint32_t dstHeight = std::max(1u, height / 2);
+    std::vector<uint8_t> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+    for (uint32_t y = 0; y < dstHeight; y++) {
+        uint32_t y0 = std::min(y * 2, height - 1);
+        uint32_t y1 = std::min(y * 2 + 1, height - 1);
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            uint32_t x0 = std::min(x * 2, width - 1);
+            uint32_t x1 = std::min(x * 2 + 1, width - 1);
+            const uint8_t* p00 = &src[(static_cast<size_t>(y0) * width + x0) * 4];
+            const uint8_t* p01 = &src[(static_cast<size_t>(y0) * width + x1) * 4];
+            const uint8_t* p10 = &src[(static_cast<size_t>(y1) * width + x0) * 4];
+            const uint8_t* p11 = &src[(static_cast<size_t>(y1) * width + x1) * 4];
+            uint8_t* out = &dst[(static_cast<size_t>(y) * dstWidth + x) * 4];
+            for (int c = 0; c < 4; c++) {
+                out[c] = static_cast<uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+bool canUploadFromHost(LogicalDevice* device, VkFormat format) {
+    auto* physical = device->physicalDevice();
+    return device->supportsHostImageCopy() &&
+           physical->capabilities().supportsHostImageTransfer(physical->handle(), format);
+}
+
+ImagePtr uploadFromHost(LogicalDevice* device, VkFormat format, uint32_t width, uint32_t height,
+                        Span<const void* const> levels) {
+    auto image = Image::create(device)
+        .extent(width, height)
+        .format(format)
+        .usage(VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .mipLevels(static_cast<uint32_t>(levels.size()))
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+
+    // Written straight into the layout it is sampled in
+    image->transitionLayoutOnHost(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    for (uint32_t level = 0; level < levels.size(); level++) {
+        image->copyFromHost(levels[level], level, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    return image;
+}
+
 void generateMipmaps(
     CommandPool* commandPool,
     Image* image,
@@ -101,7 +166,7 @@ void generateMipmaps(
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = image->arrayLayers();
     barrier.subresourceRange.levelCount = 1;
 
     int32_t mipWidth = static_cast<int32_t>(width);
@@ -128,7 +193,7 @@ void generateMipmaps(
         blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         blit.srcSubresource.mipLevel = i - 1;
         blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
+        blit.srcSubresource.layerCount = image->arrayLayers();
         blit.dstOffsets[0] = {0, 0, 0};
         blit.dstOffsets[1] = {
             mipWidth > 1 ? mipWidth / 2 : 1,
@@ -138,7 +203,7 @@ void generateMipmaps(
         blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         blit.dstSubresource.mipLevel = i;
         blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
+        blit.dstSubresource.layerCount = image->arrayLayers();
 
         vkCmdBlitImage(cmd.handle(),
             image->handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
@@ -180,7 +245,16 @@ TextureRef Texture::fromFile(
     const std::string& path,
     CommandPool* commandPool,
     bool generateMips,
-    bool srgb) {
+    bool srgb,
+    MipGenerator* mipGenerator) {
+
+    if (TextureContainer::isContainerPath(path)) {
+        auto texture = fromContainer(device, TextureContainer::fromFile(path, srgb), commandPool);
+        FINEVK_DEBUG(LogCategory::Core, "Loaded texture: " + path + " (" +
+            FormatUtils::formatName(texture->format()) + ", " +
+            std::to_string(texture->mipLevels()) + " mips)");
+        return texture;
+    }
 
     int width, height, channels;
     stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
@@ -192,12 +266,64 @@ TextureRef Texture::fromFile(
     FINEVK_DEBUG(LogCategory::Core, "Loaded texture: " + path +
         " (" + std::to_string(width) + "x" + std::to_string(height) + ")");
 
-    auto texture = fromMemory(device, pixels, width, height, commandPool, generateMips, srgb);
+    auto texture = fromMemory(device, pixels, width, height, commandPool, generateMips, srgb,
+                              mipGenerator);
 
     stbi_image_free(pixels);
     return texture;
 }
 
+TextureRef Texture::fromEncoded(
+    LogicalDevice* device,
+    ByteSpan bytes,
+    CommandPool* commandPool,
+    bool generateMips,
+    bool srgb,
+    MipGenerator* mipGenerator) {
+
+    int width, height, channels;
+    stbi_uc* pixels = stbi_load_from_memory(bytes.data, static_cast<int>(bytes.size),
+                                            &width, &height, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        throw std::runtime_error(std::string("Failed to decode texture: ") + stbi_failure_reason());
+    }
+
+    TextureRef texture;
+    try {
+        texture = fromMemory(device, pixels, width, height, commandPool, generateMips, srgb, mipGenerator);
+    } catch (...) {
+        stbi_image_free(pixels);
+        throw;
+    }
+    stbi_image_free(pixels);
+    return texture;
+}
+
+TextureRef Texture::fromPack(
+    LogicalDevice* device,
+    const AssetPack& pack,
+    const std::string& name,
+    CommandPool* commandPool,
+    bool generateMips,
+    bool srgb,
+    MipGenerator* mipGenerator) {
+
+    const AssetPack::Entry& entry = pack.entry(name);
+    if (entry.kind != AssetPack::Kind::Texture) {
+        throw std::runtime_error("Asset pack entry is not a texture: " + name);
+    }
+
+    TextureRef texture;
+    if (TextureContainer::isContainerData(entry.bytes)) {
+        texture = fromContainer(device, TextureContainer::fromView(entry.bytes, srgb), commandPool);
+    } else {
+        texture = fromEncoded(device, entry.bytes, commandPool, generateMips, srgb, mipGenerator);
+    }
+    FINEVK_DEBUG(LogCategory::Core, "Loaded texture: " + name + " from " + pack.path() + " (" +
+        std::to_string(texture->width()) + "x" + std::to_string(texture->height()) + ")");
+    return texture;
+}
+
 TextureRef Texture::fromMemory(
     LogicalDevice* device,
     const void* data,
@@ -205,11 +331,37 @@ TextureRef Texture::fromMemory(
     uint32_t height,
     CommandPool* commandPool,
     bool generateMips,
-    bool srgb) {
+    bool srgb,
+    MipGenerator* mipGenerator) {
 
     VkFormat format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
     uint32_t mipLevels = generateMips ? calculateMipLevels(width, height) : 1;
     VkDeviceSize imageSize = width * height * 4;
+    bool computeMips = mipGenerator && mipLevels > 1;
+
+    // Host image copy: CPU mips, no staging buffer or submit
+    if (!computeMips && canUploadFromHost(device, format)) {
+        std::vector<std::vector<uint8_t>> mips;
+        std::vector<const void*> levels{data};
+        if (mipLevels > 1) {
+            mips.reserve(mipLevels);
+            const auto* pixels = static_cast<const uint8_t*>(data);
+            mips.emplace_back(pixels, pixels + imageSize);
+            uint32_t w = width;
+            uint32_t h = height;
+            for (uint32_t level = 1; level < mipLevels; level++) {
+                mips.push_back(downsampleRGBA8(mips.back(), w, h));
+                w = std::max(1u, w / 2);
+                h = std::max(1u, h / 2);
+                levels.push_back(mips.back().data());
+            }
+        }
+
+        auto texture = TextureRef(new Texture());
+        texture->image_ = uploadFromHost(device, format, width, height, levels);
+        texture->view_ = texture->image_->createView(VK_IMAGE_ASPECT_COLOR_BIT);
+        return texture;
+    }
 
     // Create staging buffer
     auto stagingBuffer = Buffer::createStagingBuffer(device, imageSize);
@@ -221,13 +373,16 @@ TextureRef Texture::fromMemory(
         .format(format)
         .usage(VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
                VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-               VK_IMAGE_USAGE_SAMPLED_BIT)
+               VK_IMAGE_USAGE_SAMPLED_BIT |
+               (computeMips ? MipGenerator::RequiredUsage : 0))
+        .flags(computeMips ? MipGenerator::requiredFlags(format) : 0)
         .mipLevels(mipLevels)
         .memoryUsage(MemoryUsage::GpuOnly)
         .build();
 
     // Transition to transfer destination and copy
     {
+        MipGenerator::BatchRef mipBatch;  // Outlives the submission below
         auto imm = commandPool->beginImmediate();
         imm.cmd().transitionImageLayout(
             *image,
@@ -236,10 +391,15 @@ TextureRef Texture::fromMemory(
         imm.cmd().copyBufferToImage(
             *stagingBuffer, *image,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        if (computeMips) {
+            mipBatch = mipGenerator->record(imm.cmd(), {image.get()});
+        }
     }
 
-    // Generate mipmaps or transition to shader read
-    if (generateMips && mipLevels > 1) {
+    // Generate mipmaps or transition to shader read (compute mips did both)
+    if (computeMips) {
+        // Nothing left to record
+    } else if (generateMips && mipLevels > 1) {
         generateMipmaps(commandPool, image.get(), format, width, height, mipLevels);
     } else {
         auto imm = commandPool->beginImmediate();
@@ -259,6 +419,103 @@ TextureRef Texture::fromMemory(
     return texture;
 }
 
+TextureRef Texture::fromContainer(
+    LogicalDevice* device,
+    const TextureContainer& container,
+    CommandPool* commandPool) {
+
+    auto* physical = device->physicalDevice();
+    if (!physical->capabilities().supportsSampling(physical->handle(), container.format)) {
+        throw std::runtime_error(std::string("Texture format not supported by this device: ") +
+                                 FormatUtils::formatName(container.format) + " (" +
+                                 std::to_string(static_cast<int>(container.format)) + ")");
+    }
+
+    if (canUploadFromHost(device, container.format)) {
+        std::vector<const void*> levels;
+        for (uint32_t i = 0; i < container.mipLevels(); i++) {
+            levels.push_back(container.levelData(i));
+        }
+        auto texture = TextureRef(new Texture());
+        texture->image_ = uploadFromHost(device, container.format, container.width, container.height, levels);
+        texture->view_ = texture->image_->createView(VK_IMAGE_ASPECT_COLOR_BIT);
+        return texture;
+    }
+
+    // Pack all levels into one staging buffer, one copy region each
+    auto stagingBuffer = Buffer::createStagingBuffer(device, container.dataSize());
+    auto* staging = static_cast<uint8_t*>(stagingBuffer->mappedPtr());
+
+    std::vector<VkBufferImageCopy> regions(container.mipLevels());
+    VkDeviceSize offset = 0;
+    for (uint32_t i = 0; i < container.mipLevels(); i++) {
+        const auto& level = container.levels[i];
+        std::memcpy(staging + offset, container.levelData(i), level.size);
+
+        auto& region = regions[i];
+        region.bufferOffset = offset;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = i;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {level.width, level.height, 1};
+        offset += level.size;
+    }
+
+    auto image = Image::create(device)
+        .extent(container.width, container.height)
+        .format(container.format)
+        .usage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .mipLevels(container.mipLevels())
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+
+    {
+        auto imm = commandPool->beginImmediate();
+        imm.cmd().transitionImageLayout(
+            *image,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        vkCmdCopyBufferToImage(imm.cmd().handle(), stagingBuffer->handle(), image->handle(),
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+        imm.cmd().transitionImageLayout(
+            *image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    auto texture = TextureRef(new Texture());
+    texture->view_ = image->createView(VK_IMAGE_ASPECT_COLOR_BIT);
+    texture->image_ = std::move(image);
+    return texture;
+}
+
+TextureRef Texture::fromCompressedVariants(
+    LogicalDevice* device,
+    const std::vector<std::string>& paths,
+    CommandPool* commandPool,
+    bool srgb) {
+
+    std::vector<VkFormat> formats;
+    formats.reserve(paths.size());
+    for (const auto& path : paths) {
+        formats.push_back(TextureContainer::peekFormat(path, srgb));
+    }
+
+    VkFormat chosen = device->physicalDevice()->selectSampledFormat(formats);
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (chosen != VK_FORMAT_UNDEFINED && formats[i] == chosen) {
+            return fromContainer(device, TextureContainer::fromFile(paths[i], srgb), commandPool);
+        }
+    }
+
+    std::string list;
+    for (const auto& path : paths) {
+        list += (list.empty() ? "" : ", ") + path;
+    }
+    throw std::runtime_error("No texture variant has a format this device can sample: " + list);
+}
+
 TextureRef Texture::createSolidColor(
     LogicalDevice* device,
     CommandPool* commandPool,
@@ -268,4 +525,50 @@ TextureRef Texture::createSolidColor(
     return fromMemory(device, pixels, 1, 1, commandPool, false, true);
 }
 
+Texture::~Texture() {
+    releaseBindless();
+}
+
+Texture::Texture(Texture&& other) noexcept
+    : image_(std::move(other.image_))
+    , view_(std::move(other.view_))
+    , bindlessTable_(other.bindlessTable_)
+    , bindlessIndex_(other.bindlessIndex_) {
+    other.bindlessTable_ = nullptr;
+    other.bindlessIndex_ = UINT32_MAX;
+}
+
+Texture& Texture::operator=(Texture&& other) noexcept {
+    if (this != &other) {
+        releaseBindless();
+        image_ = std::move(other.image_);
+        view_ = std::move(other.view_);
+        bindlessTable_ = other.bindlessTable_;
+        bindlessIndex_ = other.bindlessIndex_;
+        other.bindlessTable_ = nullptr;
+        other.bindlessIndex_ = UINT32_MAX;
+    }
+    return *this;
+}
+
+uint32_t Texture::registerBindless(BindlessTable& table, Sampler* sampler) {
+    if (bindlessTable_ == &table) {
+        table.updateTexture(bindlessIndex_, view_.get(), sampler);
+    } else {
+        uint32_t index = table.addTexture(view_.get(), sampler);
+        releaseBindless();
+        bindlessTable_ = &table;
+        bindlessIndex_ = index;
+    }
+    return bindlessIndex_;
+}
+
+void Texture::releaseBindless() noexcept {
+    if (bindlessTable_) {
+        bindlessTable_->releaseTexture(bindlessIndex_);
+        bindlessTable_ = nullptr;
+        bindlessIndex_ = UINT32_MAX;
+    }
+}
+
 } // namespace finevk
@@ -0,0 +1,331 @@
+#include "finevk/high/texture_array.hpp"
+#include "finevk/high/texture.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/core/logging.hpp"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+uint32_t roundUp(uint32_t value, uint32_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+std::vector<uint8_t> loadRgba(const std::string& path, uint32_t& width, uint32_t& height) {
+    int w = 0, h = 0, channels = 0;
+    stbi_uc* pixels = stbi_load(path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        throw std::runtime_error("Failed to load texture: " + path);
+    }
+    width = static_cast<uint32_t>(w);
+    height = static_cast<uint32_t>(h);
+    std::vector<uint8_t> texels(pixels, pixels + static_cast<size_t>(w) * h * 4);
+    stbi_image_free(pixels);
+    return texels;
+}
+
+// Copy staged regions into a new image, then build mips or make it shader-readable
+ImagePtr uploadRegions(LogicalDevice* device, CommandPool* commandPool, Buffer& staging,
+                       uint32_t width, uint32_t height, uint32_t layers, uint32_t mipLevels,
+                       VkFormat format, const std::vector<VkBufferImageCopy>& regions, bool clear) {
+    auto image = Image::create(device)
+        .extent(width, height)
+        .format(format)
+        .usage(VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+               VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+               VK_IMAGE_USAGE_SAMPLED_BIT)
+        .mipLevels(mipLevels)
+        .arrayLayers(layers)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+
+    {
+        auto imm = commandPool->beginImmediate();
+        imm.cmd().transitionImageLayout(
+            *image,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        if (clear) {
+            // Texels no region covers stay transparent black
+            VkClearColorValue black{};
+            VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layers};
+            vkCmdClearColorImage(imm.cmd().handle(), image->handle(),
+                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &black, 1, &range);
+            imm.cmd().memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        }
+        vkCmdCopyBufferToImage(imm.cmd().handle(), staging.handle(), image->handle(),
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    if (mipLevels > 1) {
+        generateMipmaps(commandPool, image.get(), format, width, height, mipLevels);
+    } else {
+        auto imm = commandPool->beginImmediate();
+        imm.cmd().transitionImageLayout(
+            *image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    return image;
+}
+
+} // namespace
+
+// ============================================================================
+// TextureArrayBuilder implementation
+// ============================================================================
+
+TextureArrayBuilder::TextureArrayBuilder(LogicalDevice* device, uint32_t width, uint32_t height)
+    : device_(device), width_(width), height_(height) {
+    if (width == 0 || height == 0) {
+        throw std::runtime_error("TextureArrayBuilder layer size must be non-zero");
+    }
+}
+
+TextureArrayBuilder& TextureArrayBuilder::srgb(bool enable) {
+    srgb_ = enable;
+    return *this;
+}
+
+TextureArrayBuilder& TextureArrayBuilder::generateMipmaps(bool enable) {
+    generateMipmaps_ = enable;
+    return *this;
+}
+
+uint32_t TextureArrayBuilder::add(const void* rgba) {
+    const auto* bytes = static_cast<const uint8_t*>(rgba);
+    layers_.emplace_back(bytes, bytes + static_cast<size_t>(width_) * height_ * 4);
+    return static_cast<uint32_t>(layers_.size() - 1);
+}
+
+uint32_t TextureArrayBuilder::addFile(const std::string& path) {
+    uint32_t width = 0, height = 0;
+    auto texels = loadRgba(path, width, height);
+    if (width != width_ || height != height_) {
+        throw std::runtime_error("TextureArrayBuilder: " + path + " is " + std::to_string(width) +
+                                 "x" + std::to_string(height) + ", expected " +
+                                 std::to_string(width_) + "x" + std::to_string(height_));
+    }
+    layers_.push_back(std::move(texels));
+    return static_cast<uint32_t>(layers_.size() - 1);
+}
+
+TextureRef TextureArrayBuilder::build(CommandPool* commandPool) {
+    if (layers_.empty()) {
+        throw std::runtime_error("TextureArrayBuilder has no layers");
+    }
+    uint32_t maxLayers = device_->physicalDevice()->capabilities().properties.limits.maxImageArrayLayers;
+    if (layers_.size() > maxLayers) {
+        throw std::runtime_error("TextureArrayBuilder: " + std::to_string(layers_.size()) +
+                                 " layers exceed maxImageArrayLayers (" + std::to_string(maxLayers) + ")");
+    }
+
+    // Layers are tightly packed, so one region covers them all
+    size_t layerSize = static_cast<size_t>(width_) * height_ * 4;
+    auto stagingBuffer = Buffer::createStagingBuffer(device_, layerSize * layers_.size());
+    auto* staging = static_cast<uint8_t*>(stagingBuffer->mappedPtr());
+    for (size_t i = 0; i < layers_.size(); i++) {
+        std::memcpy(staging + i * layerSize, layers_[i].data(), layerSize);
+    }
+
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = layerCount();
+    region.imageExtent = {width_, height_, 1};
+
+    VkFormat format = srgb_ ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    uint32_t mipLevels = generateMipmaps_ ? calculateMipLevels(width_, height_) : 1;
+    auto image = uploadRegions(device_, commandPool, *stagingBuffer, width_, height_, layerCount(),
+                               mipLevels, format, {region}, false);
+
+    FINEVK_DEBUG(LogCategory::Core, "Built texture array: " + std::to_string(layers_.size()) +
+                 " layers of " + std::to_string(width_) + "x" + std::to_string(height_));
+
+    auto texture = TextureRef(new Texture());
+    texture->view_ = image->createView(VK_IMAGE_ASPECT_COLOR_BIT);
+    texture->image_ = std::move(image);
+    return texture;
+}
+
+// ============================================================================
+// TextureAtlasBuilder implementation
+// ============================================================================
+
+TextureAtlasBuilder::TextureAtlasBuilder(LogicalDevice* device, uint32_t maxSize)
+    : device_(device), maxSize_(maxSize) {
+}
+
+TextureAtlasBuilder& TextureAtlasBuilder::srgb(bool enable) {
+    srgb_ = enable;
+    return *this;
+}
+
+TextureAtlasBuilder& TextureAtlasBuilder::generateMipmaps(bool enable) {
+    generateMipmaps_ = enable;
+    return *this;
+}
+
+TextureAtlasBuilder& TextureAtlasBuilder::padding(uint32_t texels) {
+    padding_ = texels;
+    return *this;
+}
+
+uint32_t TextureAtlasBuilder::add(const void* rgba, uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0) {
+        throw std::runtime_error("TextureAtlasBuilder image size must be non-zero");
+    }
+    const auto* bytes = static_cast<const uint8_t*>(rgba);
+    images_.push_back({width, height,
+                       std::vector<uint8_t>(bytes, bytes + static_cast<size_t>(width) * height * 4)});
+    return static_cast<uint32_t>(images_.size() - 1);
+}
+
+uint32_t TextureAtlasBuilder::addFile(const std::string& path) {
+    Source source;
+    source.texels = loadRgba(path, source.width, source.height);
+    images_.push_back(std::move(source));
+    return static_cast<uint32_t>(images_.size() - 1);
+}
+
+bool TextureAtlasBuilder::pack(uint32_t side, uint32_t align) {
+    std::vector<uint32_t> order(images_.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return images_[a].height > images_[b].height;
+    });
+
+    uint32_t cursorX = 0, shelfY = 0, shelfHeight = 0;
+    for (uint32_t index : order) {
+        uint32_t w = roundUp(images_[index].width + 2 * padding_, align);
+        uint32_t h = roundUp(images_[index].height + 2 * padding_, align);
+        if (w > side) {
+            return false;
+        }
+        if (cursorX + w > side) {
+            shelfY += shelfHeight;
+            cursorX = 0;
+            shelfHeight = 0;
+        }
+        if (shelfY + h > side) {
+            return false;
+        }
+
+        Region& region = regions_[index];
+        region.x = cursorX + padding_;
+        region.y = shelfY + padding_;
+        region.width = images_[index].width;
+        region.height = images_[index].height;
+        cursorX += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    return true;
+}
+
+TextureRef TextureAtlasBuilder::build(CommandPool* commandPool) {
+    if (images_.empty()) {
+        throw std::runtime_error("TextureAtlasBuilder has no images");
+    }
+
+    // Level k keeps padding >> k texels of clean border; stop before it runs out
+    uint32_t mipLevels = 1;
+    if (generateMipmaps_ && padding_ > 0) {
+        mipLevels = static_cast<uint32_t>(std::floor(std::log2(padding_))) + 1;
+    }
+    uint32_t align = 1u << (mipLevels - 1);
+
+    uint64_t area = 0;
+    uint32_t largest = 0;
+    for (const auto& image : images_) {
+        uint32_t w = roundUp(image.width + 2 * padding_, align);
+        uint32_t h = roundUp(image.height + 2 * padding_, align);
+        area += static_cast<uint64_t>(w) * h;
+        largest = std::max({largest, w, h});
+    }
+    uint32_t side = 1;
+    while (side < largest || static_cast<uint64_t>(side) * side < area) {
+        side *= 2;
+    }
+
+    regions_.assign(images_.size(), Region{});
+    while (side <= maxSize_ && !pack(side, align)) {
+        side *= 2;
+    }
+    if (side > maxSize_) {
+        throw std::runtime_error("TextureAtlasBuilder: images don't fit in " +
+                                 std::to_string(maxSize_) + "x" + std::to_string(maxSize_));
+    }
+    size_ = side;
+    mipLevels = std::min(mipLevels, calculateMipLevels(side, side));
+
+    // Stage each image with its padding, extruding edge texels outward
+    VkDeviceSize stagingSize = 0;
+    for (const auto& image : images_) {
+        stagingSize += static_cast<VkDeviceSize>(image.width + 2 * padding_) *
+                       (image.height + 2 * padding_) * 4;
+    }
+    auto stagingBuffer = Buffer::createStagingBuffer(device_, stagingSize);
+    auto* staging = static_cast<uint8_t*>(stagingBuffer->mappedPtr());
+
+    std::vector<VkBufferImageCopy> copies;
+    copies.reserve(images_.size());
+    VkDeviceSize offset = 0;
+    for (size_t i = 0; i < images_.size(); i++) {
+        const Source& source = images_[i];
+        Region& region = regions_[i];
+        uint32_t w = source.width + 2 * padding_;
+        uint32_t h = source.height + 2 * padding_;
+
+        uint8_t* dst = staging + offset;
+        for (uint32_t y = 0; y < h; y++) {
+            uint32_t sy = std::min(y > padding_ ? y - padding_ : 0u, source.height - 1);
+            for (uint32_t x = 0; x < w; x++) {
+                uint32_t sx = std::min(x > padding_ ? x - padding_ : 0u, source.width - 1);
+                std::memcpy(dst + (static_cast<size_t>(y) * w + x) * 4,
+                            &source.texels[(static_cast<size_t>(sy) * source.width + sx) * 4], 4);
+            }
+        }
+
+        VkBufferImageCopy copy{};
+        copy.bufferOffset = offset;
+        copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy.imageSubresource.layerCount = 1;
+        copy.imageOffset = {static_cast<int32_t>(region.x - padding_),
+                            static_cast<int32_t>(region.y - padding_), 0};
+        copy.imageExtent = {w, h, 1};
+        copies.push_back(copy);
+        offset += static_cast<VkDeviceSize>(w) * h * 4;
+
+        float scale = 1.0f / static_cast<float>(side);
+        region.uvMin[0] = region.x * scale;
+        region.uvMin[1] = region.y * scale;
+        region.uvMax[0] = (region.x + region.width) * scale;
+        region.uvMax[1] = (region.y + region.height) * scale;
+    }
+
+    VkFormat format = srgb_ ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    auto image = uploadRegions(device_, commandPool, *stagingBuffer, side, side, 1, mipLevels,
+                               format, copies, true);
+
+    FINEVK_DEBUG(LogCategory::Core, "Built texture atlas: " + std::to_string(images_.size()) +
+                 " images in " + std::to_string(side) + "x" + std::to_string(side));
+
+    auto texture = TextureRef(new Texture());
+    texture->view_ = image->createView(VK_IMAGE_ASPECT_COLOR_BIT);
+    texture->image_ = std::move(image);
+    return texture;
+}
+
+} // namespace finevk
@@ -0,0 +1,351 @@
+#include "finevk/high/texture_container.hpp"
+#include "finevk/high/format_utils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+constexpr uint8_t kKtx2Identifier[12] = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+constexpr uint32_t fourCC(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+constexpr uint32_t kDdsMagic = fourCC('D', 'D', 'S', ' ');
+constexpr size_t kDdsHeaderSize = 128;        // Magic + DDS_HEADER
+constexpr size_t kDdsDx10HeaderSize = 20;
+constexpr size_t kKtx2HeaderSize = 80;        // Up to the level index
+constexpr size_t kKtx2LevelEntrySize = 24;
+
+constexpr uint32_t kDdpfFourCC = 0x4;
+constexpr uint32_t kDdpfRgb = 0x40;
+constexpr uint32_t kDdsCaps2Cubemap = 0x200;
+constexpr uint32_t kDdsCaps2Volume = 0x200000;
+
+// Containers are little-endian, as is every platform we target
+template<typename T>
+T read(const uint8_t* data, size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+VkFormat formatFromDxgi(uint32_t dxgi) {
+    switch (dxgi) {
+        case 28: return VK_FORMAT_R8G8B8A8_UNORM;
+        case 29: return VK_FORMAT_R8G8B8A8_SRGB;
+        case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        case 74: return VK_FORMAT_BC2_UNORM_BLOCK;
+        case 75: return VK_FORMAT_BC2_SRGB_BLOCK;
+        case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+        case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+        case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+        case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+        case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+        case 87: return VK_FORMAT_B8G8R8A8_UNORM;
+        case 91: return VK_FORMAT_B8G8R8A8_SRGB;
+        case 95: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+        case 96: return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+        case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+        case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+        default: return VK_FORMAT_UNDEFINED;
+    }
+}
+
+// Legacy (pre-DX10) pixel format block at offset 76
+VkFormat formatFromLegacyDds(const uint8_t* data, bool srgb) {
+    uint32_t flags = read<uint32_t>(data, 80);
+    uint32_t code = read<uint32_t>(data, 84);
+
+    if (flags & kDdpfFourCC) {
+        switch (code) {
+            case fourCC('D', 'X', 'T', '1'):
+                return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case fourCC('D', 'X', 'T', '2'):
+            case fourCC('D', 'X', 'T', '3'):
+                return srgb ? VK_FORMAT_BC2_SRGB_BLOCK : VK_FORMAT_BC2_UNORM_BLOCK;
+            case fourCC('D', 'X', 'T', '4'):
+            case fourCC('D', 'X', 'T', '5'):
+                return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            case fourCC('A', 'T', 'I', '1'):
+            case fourCC('B', 'C', '4', 'U'):
+                return VK_FORMAT_BC4_UNORM_BLOCK;
+            case fourCC('B', 'C', '4', 'S'):
+                return VK_FORMAT_BC4_SNORM_BLOCK;
+            case fourCC('A', 'T', 'I', '2'):
+            case fourCC('B', 'C', '5', 'U'):
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+            case fourCC('B', 'C', '5', 'S'):
+                return VK_FORMAT_BC5_SNORM_BLOCK;
+            default:
+                return VK_FORMAT_UNDEFINED;
+        }
+    }
+
+    if ((flags & kDdpfRgb) && read<uint32_t>(data, 88) == 32) {
+        uint32_t redMask = read<uint32_t>(data, 92);
+        uint32_t blueMask = read<uint32_t>(data, 100);
+        if (redMask == 0x000000FF && blueMask == 0x00FF0000) {
+            return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        }
+        if (redMask == 0x00FF0000 && blueMask == 0x000000FF) {
+            return srgb ? VK_FORMAT_B8G8R8A8_SRGB : VK_FORMAT_B8G8R8A8_UNORM;
+        }
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+bool isKtx2(const uint8_t* data, size_t size) {
+    return size >= sizeof(kKtx2Identifier) &&
+           std::memcmp(data, kKtx2Identifier, sizeof(kKtx2Identifier)) == 0;
+}
+
+bool isDds(const uint8_t* data, size_t size) {
+    return size >= 4 && read<uint32_t>(data, 0) == kDdsMagic;
+}
+
+bool isDx10(const uint8_t* data, size_t size) {
+    return size >= kDdsHeaderSize &&
+           (read<uint32_t>(data, 80) & kDdpfFourCC) &&
+           read<uint32_t>(data, 84) == fourCC('D', 'X', '1', '0');
+}
+
+void checkFormat(VkFormat format) {
+    if (format == VK_FORMAT_UNDEFINED || FormatUtils::bytesPerBlock(format) == 0) {
+        throw std::runtime_error("Texture container: unsupported pixel format " +
+                                 std::to_string(static_cast<int>(format)));
+    }
+}
+
+/// Levels in a full mip chain: floor(log2(max(width, height))) + 1
+uint32_t fullMipChain(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size >>= 1) {
+        levels++;
+    }
+    return levels;
+}
+
+/// Reject level counts beyond the mip chain before anything is sized from them
+void checkLevelCount(const char* container, uint32_t levelCount, uint32_t width, uint32_t height) {
+    if (levelCount > fullMipChain(width, height)) {
+        throw std::runtime_error(std::string(container) + ": " + std::to_string(levelCount) +
+                                 " levels exceed the mip chain of a " + std::to_string(width) +
+                                 "x" + std::to_string(height) + " image");
+    }
+}
+
+void parseKtx2(TextureContainer& out, const uint8_t* data, size_t size) {
+    if (size < kKtx2HeaderSize) {
+        throw std::runtime_error("KTX2: truncated header");
+    }
+
+    out.format = static_cast<VkFormat>(read<uint32_t>(data, 12));
+    out.width = read<uint32_t>(data, 20);
+    out.height = std::max(1u, read<uint32_t>(data, 24));
+    uint32_t depth = read<uint32_t>(data, 28);
+    uint32_t layers = read<uint32_t>(data, 32);
+    uint32_t faces = read<uint32_t>(data, 36);
+    uint32_t levelCount = std::max(1u, read<uint32_t>(data, 40));
+    uint32_t supercompression = read<uint32_t>(data, 44);
+
+    if (out.width == 0) {
+        throw std::runtime_error("KTX2: zero-sized image");
+    }
+    checkLevelCount("KTX2", levelCount, out.width, out.height);
+    if (out.format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error("KTX2: Basis Universal payloads must be transcoded offline");
+    }
+    if (supercompression != 0) {
+        throw std::runtime_error("KTX2: supercompressed files are not supported");
+    }
+    if (depth > 1 || layers > 1 || faces != 1) {
+        throw std::runtime_error("KTX2: only single-layer 2D textures are supported");
+    }
+    checkFormat(out.format);
+
+    if (size < kKtx2HeaderSize + levelCount * kKtx2LevelEntrySize) {
+        throw std::runtime_error("KTX2: truncated level index");
+    }
+
+    out.levels.resize(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        size_t entry = kKtx2HeaderSize + i * kKtx2LevelEntrySize;
+        uint64_t offset = read<uint64_t>(data, entry);
+        uint64_t length = read<uint64_t>(data, entry + 8);
+
+        auto& level = out.levels[i];
+        level.width = std::max(1u, out.width >> i);
+        level.height = std::max(1u, out.height >> i);
+        level.offset = static_cast<size_t>(offset);
+        level.size = static_cast<size_t>(length);
+
+        if (length != FormatUtils::levelSize(out.format, level.width, level.height)) {
+            throw std::runtime_error("KTX2: level " + std::to_string(i) + " has an unexpected size");
+        }
+        if (offset > size || length > size - offset) {
+            throw std::runtime_error("KTX2: level " + std::to_string(i) + " lies outside the file");
+        }
+    }
+}
+
+void parseDds(TextureContainer& out, const uint8_t* data, size_t size, bool srgb) {
+    if (size < kDdsHeaderSize || read<uint32_t>(data, 4) != 124) {
+        throw std::runtime_error("DDS: truncated or invalid header");
+    }
+
+    out.height = read<uint32_t>(data, 12);
+    out.width = read<uint32_t>(data, 16);
+    uint32_t levelCount = std::max(1u, read<uint32_t>(data, 28));
+    if (out.width == 0 || out.height == 0) {
+        throw std::runtime_error("DDS: zero-sized image");
+    }
+    checkLevelCount("DDS", levelCount, out.width, out.height);
+    uint32_t caps2 = read<uint32_t>(data, 112);
+    if (caps2 & (kDdsCaps2Cubemap | kDdsCaps2Volume)) {
+        throw std::runtime_error("DDS: only 2D textures are supported");
+    }
+
+    size_t offset = kDdsHeaderSize;
+    if (isDx10(data, size)) {
+        if (size < kDdsHeaderSize + kDdsDx10HeaderSize) {
+            throw std::runtime_error("DDS: truncated DX10 header");
+        }
+        out.format = formatFromDxgi(read<uint32_t>(data, 128));
+        uint32_t dimension = read<uint32_t>(data, 132);
+        uint32_t arraySize = read<uint32_t>(data, 140);
+        if (dimension != 3 || arraySize > 1) {  // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+            throw std::runtime_error("DDS: only single-layer 2D textures are supported");
+        }
+        offset += kDdsDx10HeaderSize;
+    } else {
+        out.format = formatFromLegacyDds(data, srgb);
+    }
+    checkFormat(out.format);
+
+    // Levels follow the header back to back, largest first
+    out.levels.resize(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        auto& level = out.levels[i];
+        level.width = std::max(1u, out.width >> i);
+        level.height = std::max(1u, out.height >> i);
+        level.offset = offset;
+        level.size = static_cast<size_t>(FormatUtils::levelSize(out.format, level.width, level.height));
+        if (level.size > size - offset) {
+            throw std::runtime_error("DDS: level " + std::to_string(i) + " lies outside the file");
+        }
+        offset += level.size;
+    }
+}
+
+void parse(TextureContainer& out, const uint8_t* data, size_t size, bool srgb) {
+    if (isKtx2(data, size)) {
+        parseKtx2(out, data, size);
+    } else if (isDds(data, size)) {
+        parseDds(out, data, size, srgb);
+    } else {
+        throw std::runtime_error("Texture container: not a KTX2 or DDS file");
+    }
+
+    if (out.width == 0) {
+        throw std::runtime_error("Texture container: zero-sized image");
+    }
+}
+
+} // namespace
+
+size_t TextureContainer::dataSize() const {
+    size_t total = 0;
+    for (const auto& level : levels) {
+        total += level.size;
+    }
+    return total;
+}
+
+TextureContainer TextureContainer::fromMemory(std::vector<uint8_t> bytes, bool srgb) {
+    TextureContainer container;
+    container.bytes = std::move(bytes);
+    parse(container, container.bytes.data(), container.bytes.size(), srgb);
+    return container;
+}
+
+TextureContainer TextureContainer::fromView(ByteSpan bytes, bool srgb) {
+    TextureContainer container;
+    container.source = bytes;
+    parse(container, bytes.data, bytes.size, srgb);
+    return container;
+}
+
+bool TextureContainer::isContainerData(ByteSpan bytes) {
+    return isKtx2(bytes.data, bytes.size) || isDds(bytes.data, bytes.size);
+}
+
+TextureContainer TextureContainer::fromFile(const std::string& path, bool srgb) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open texture: " + path);
+    }
+
+    std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to read texture: " + path);
+    }
+
+    try {
+        return fromMemory(std::move(bytes), srgb);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string(e.what()) + " (" + path + ")");
+    }
+}
+
+VkFormat TextureContainer::peekFormat(const std::string& path, bool srgb) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    uint8_t header[kDdsHeaderSize + kDdsDx10HeaderSize] = {};
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    size_t size = static_cast<size_t>(file.gcount());
+
+    if (isKtx2(header, size) && size >= 16) {
+        return static_cast<VkFormat>(read<uint32_t>(header, 12));
+    }
+    if (isDds(header, size) && size >= kDdsHeaderSize) {
+        if (isDx10(header, size)) {
+            return size >= kDdsHeaderSize + kDdsDx10HeaderSize
+                ? formatFromDxgi(read<uint32_t>(header, 128))
+                : VK_FORMAT_UNDEFINED;
+        }
+        return formatFromLegacyDds(header, srgb);
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+bool TextureContainer::isContainerPath(const std::string& path) {
+    auto dot = path.find_last_of('.');
+    if (dot == std::string::npos) {
+        return false;
+    }
+    std::string ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == "ktx2" || ext == "dds";
+}
+
+} // namespace finevk
@@ -0,0 +1,326 @@
+#include "finevk/high/texture_streamer.hpp"
+#include "finevk/high/texture.hpp"
+#include "finevk/high/texture_container.hpp"
+#include "finevk/high/format_utils.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/device/upload_manager.hpp"
+#include "finevk/core/thread_pool.hpp"
+#include "finevk/core/logging.hpp"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace finevk {
+
+// ============================================================================
+// StreamedTexture implementation
+// ============================================================================
+
+void StreamedTexture::onReady(std::function<void(const TextureRef&)> callback) {
+    if (ready_) {
+        callback(texture_);
+    } else {
+        callbacks_.push_back(std::move(callback));
+    }
+}
+
+// ============================================================================
+// TextureStreamer::Builder implementation
+// ============================================================================
+
+TextureStreamer::Builder::Builder(LogicalDevice* device, UploadManager* uploads)
+    : device_(device), uploads_(uploads) {
+}
+
+TextureStreamer::Builder& TextureStreamer::Builder::frameBudget(VkDeviceSize bytes) {
+    frameBudget_ = bytes;
+    return *this;
+}
+
+TextureStreamer::Builder& TextureStreamer::Builder::threads(ThreadPool* pool) {
+    threads_ = pool;
+    return *this;
+}
+
+TextureStreamer::Builder& TextureStreamer::Builder::placeholder(TextureRef texture) {
+    placeholder_ = std::move(texture);
+    return *this;
+}
+
+TextureStreamer::Builder& TextureStreamer::Builder::commandPool(CommandPool* pool) {
+    commandPool_ = pool;
+    return *this;
+}
+
+TextureStreamerPtr TextureStreamer::Builder::build() {
+    if (!device_ || !uploads_) {
+        throw std::runtime_error("TextureStreamer requires a device and an UploadManager");
+    }
+
+    auto streamer = TextureStreamerPtr(new TextureStreamer());
+    streamer->device_ = device_;
+    streamer->uploads_ = uploads_;
+    streamer->threads_ = threads_ ? threads_ : &ThreadPool::global();
+    streamer->frameBudget_ = frameBudget_;
+    streamer->inbox_ = std::make_shared<Inbox>();
+
+    streamer->placeholder_ = placeholder_;
+    if (!streamer->placeholder_) {
+        CommandPool* pool = commandPool_ ? commandPool_ : device_->defaultCommandPool();
+        streamer->placeholder_ = Texture::createSolidColor(device_, pool, 128, 128, 128);
+    }
+
+    return streamer;
+}
+
+TextureStreamer::Builder TextureStreamer::create(LogicalDevice* device, UploadManager* uploads) {
+    return Builder(device, uploads);
+}
+
+// ============================================================================
+// TextureStreamer implementation
+// ============================================================================
+
+TextureStreamer::~TextureStreamer() {
+    {
+        std::unique_lock<std::mutex> lock(inbox_->mutex);
+        inbox_->closed = true;
+        inbox_->decoded.clear();
+        // Jobs copying into images still use the device
+        inbox_->idle.wait(lock, [this] { return inbox_->hostCopies == 0; });
+    }
+
+    // Images must outlive their copies
+    for (auto& upload : uploading_) {
+        upload.ticket.wait();
+    }
+}
+
+StreamedTextureRef TextureStreamer::load(const std::string& path, bool srgb, bool generateMipmaps) {
+    auto target = std::make_shared<StreamedTexture>();
+    target->path_ = path;
+    target->placeholder_ = placeholder_;
+    pending_++;
+
+    // The job owns its inbox reference, not the streamer
+    std::shared_ptr<Inbox> inbox = inbox_;
+    LogicalDevice* device = device_;
+    threads_->submit([inbox, device, target, path, srgb, generateMipmaps]() {
+        Decoded decoded;
+        decoded.target = target;
+        decoded.srgb = srgb;
+        bool hostCopy = false;
+
+        int width = 0, height = 0, channels = 0;
+        stbi_uc* pixels = nullptr;
+        if (TextureContainer::isContainerPath(path)) {
+            // Baked mips as stored; generateMipmaps doesn't apply
+            try {
+                auto container = TextureContainer::fromFile(path, srgb);
+                decoded.format = container.format;
+                decoded.width = container.width;
+                decoded.height = container.height;
+                for (uint32_t i = 0; i < container.mipLevels(); i++) {
+                    const uint8_t* level = container.levelData(i);
+                    decoded.mips.emplace_back(level, level + container.levels[i].size);
+                }
+                decoded.bytes = container.dataSize();
+            } catch (const std::exception& e) {
+                FINEVK_WARN(LogCategory::Core, std::string("TextureStreamer: ") + e.what());
+                decoded.failed = true;
+            }
+        } else if (!(pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha))) {
+            decoded.failed = true;
+        } else {
+            decoded.width = static_cast<uint32_t>(width);
+            decoded.height = static_cast<uint32_t>(height);
+            size_t size = static_cast<size_t>(width) * height * 4;
+            decoded.mips.emplace_back(pixels, pixels + size);
+            stbi_image_free(pixels);
+
+            uint32_t w = decoded.width;
+            uint32_t h = decoded.height;
+            while (generateMipmaps && (w > 1 || h > 1)) {
+                decoded.mips.push_back(downsampleRGBA8(decoded.mips.back(), w, h));
+                w = std::max(1u, w / 2);
+                h = std::max(1u, h / 2);
+            }
+            for (const auto& mip : decoded.mips) {
+                decoded.bytes += mip.size();
+            }
+        }
+
+        // Host image copy: fill the image here, update() only swaps it in
+        VkFormat format = decoded.format != VK_FORMAT_UNDEFINED ? decoded.format
+            : (srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM);
+        if (!decoded.failed && canUploadFromHost(device, format)) {
+            {
+                std::lock_guard<std::mutex> lock(inbox->mutex);
+                if (inbox->closed) {
+                    return;
+                }
+                inbox->hostCopies++;
+                hostCopy = true;
+            }
+            try {
+                std::vector<const void*> levels;
+                for (const auto& mip : decoded.mips) {
+                    levels.push_back(mip.data());
+                }
+                decoded.image = uploadFromHost(device, format, decoded.width, decoded.height, levels);
+                decoded.mips.clear();
+            } catch (const std::exception& e) {
+                FINEVK_WARN(LogCategory::Core, std::string("TextureStreamer: host copy failed, ") +
+                            "falling back to the upload queue: " + e.what());
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(inbox->mutex);
+        if (!inbox->closed) {
+            inbox->decoded.push_back(std::move(decoded));
+        }
+        if (hostCopy) {
+            decoded.image.reset();  // Dropped before the destructor can return
+            inbox->hostCopies--;
+            inbox->idle.notify_all();
+        }
+    });
+
+    return target;
+}
+
+void TextureStreamer::update() {
+    // Swap in finished uploads
+    for (size_t i = 0; i < uploading_.size();) {
+        if (uploading_[i].ticket.isComplete()) {
+            finish(uploading_[i]);
+            if (i + 1 != uploading_.size()) {
+                uploading_[i] = std::move(uploading_.back());
+            }
+            uploading_.pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(inbox_->mutex);
+        while (!inbox_->decoded.empty()) {
+            waiting_.push_back(std::move(inbox_->decoded.front()));
+            inbox_->decoded.pop_front();
+        }
+    }
+
+    // Queue uploads up to the budget, oldest first
+    VkDeviceSize spent = 0;
+    while (!waiting_.empty()) {
+        Decoded& next = waiting_.front();
+        if (next.failed) {
+            FINEVK_WARN(LogCategory::Core, "TextureStreamer: failed to load " + next.target->path_);
+            next.target->failed_ = true;
+            pending_--;
+            waiting_.pop_front();
+            continue;
+        }
+        if (next.format != VK_FORMAT_UNDEFINED && !canSample(next.format)) {
+            FINEVK_WARN(LogCategory::Core, std::string("TextureStreamer: device can't sample ") +
+                        FormatUtils::formatName(next.format) + " in " + next.target->path_);
+            next.target->failed_ = true;
+            pending_--;
+            waiting_.pop_front();
+            continue;
+        }
+        if (next.image) {
+            // Copied on the worker; nothing to upload
+            Upload upload;
+            upload.target = std::move(next.target);
+            upload.image = std::move(next.image);
+            finish(upload);
+            waiting_.pop_front();
+            continue;
+        }
+        if (spent > 0 && spent + next.bytes > frameBudget_) {
+            break;
+        }
+        spent += next.bytes;
+        startUpload(next);
+        waiting_.pop_front();
+    }
+    lastFrameBytes_ = spent;
+
+    if (spent > 0) {
+        SubmitTicket ticket = uploads_->flush();
+        for (auto& upload : uploading_) {
+            if (!upload.ticket.valid()) {
+                upload.ticket = ticket;
+            }
+        }
+    }
+}
+
+void TextureStreamer::startUpload(Decoded& decoded) {
+    VkFormat format = decoded.format;
+    if (format == VK_FORMAT_UNDEFINED) {
+        format = decoded.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    }
+    auto image = Image::create(device_)
+        .extent(decoded.width, decoded.height)
+        .format(format)
+        .usage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .mipLevels(static_cast<uint32_t>(decoded.mips.size()))
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+
+    for (uint32_t level = 0; level < decoded.mips.size(); level++) {
+        const auto& mip = decoded.mips[level];
+        uploads_->uploadImage(*image, mip.data(), mip.size(), level);
+    }
+
+    Upload upload;
+    upload.target = std::move(decoded.target);
+    upload.image = std::move(image);
+    uploading_.push_back(std::move(upload));  // Ticket assigned after flush()
+}
+
+bool TextureStreamer::canSample(VkFormat format) const {
+    auto* physical = device_->physicalDevice();
+    return physical->capabilities().supportsSampling(physical->handle(), format);
+}
+
+void TextureStreamer::finish(Upload& upload) {
+    auto texture = TextureRef(new Texture());
+    texture->view_ = upload.image->createView(VK_IMAGE_ASPECT_COLOR_BIT);
+    texture->image_ = std::move(upload.image);
+
+    StreamedTexture& target = *upload.target;
+    target.texture_ = std::move(texture);
+    target.ready_ = true;
+    pending_--;
+
+    auto callbacks = std::move(target.callbacks_);
+    target.callbacks_.clear();
+    for (auto& callback : callbacks) {
+        callback(target.texture_);
+    }
+}
+
+void TextureStreamer::waitIdle() {
+    while (pending_ > 0) {
+        update();
+        if (pending_ == 0) {
+            break;
+        }
+        if (!uploading_.empty()) {
+            uploading_.front().ticket.wait();
+        } else {
+            std::this_thread::yield();  // Still decoding
+        }
+    }
+}
+
+} // namespace finevk
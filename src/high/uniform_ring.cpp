@@ -0,0 +1,113 @@
+#include "finevk/high/uniform_ring.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/rendering/descriptors.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace finevk {
+
+// ============================================================================
+// UniformRing::Builder implementation
+// ============================================================================
+
+UniformRing::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+UniformRing::Builder& UniformRing::Builder::frameSize(VkDeviceSize bytes) {
+    frameSize_ = bytes;
+    return *this;
+}
+
+UniformRing::Builder& UniformRing::Builder::framesInFlight(uint32_t count) {
+    framesInFlight_ = count;
+    return *this;
+}
+
+UniformRingPtr UniformRing::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("UniformRing requires a device");
+    }
+    if (frameSize_ == 0) {
+        throw std::runtime_error("UniformRing requires a non-zero frame size");
+    }
+    uint32_t framesInFlight = framesInFlight_ != 0 ? framesInFlight_ : device_->maxFramesInFlight();
+
+    auto ring = UniformRingPtr(new UniformRing());
+
+    const auto& limits = device_->physicalDevice()->capabilities().properties.limits;
+    ring->alignment_ = std::max<VkDeviceSize>(limits.minUniformBufferOffsetAlignment, 16);
+
+    // Frame regions start aligned so every offset in them can be
+    ring->frameSize_ = (frameSize_ + ring->alignment_ - 1) / ring->alignment_ * ring->alignment_;
+    ring->framesInFlight_ = framesInFlight;
+
+    VkDeviceSize total = ring->frameSize_ * framesInFlight;
+    if (total > UINT32_MAX) {
+        throw std::runtime_error("UniformRing: total size exceeds 32-bit dynamic offsets");
+    }
+
+    ring->buffer_ = Buffer::create(device_)
+        .size(total)
+        .usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+        .memoryUsage(MemoryUsage::GpuDirectWrite)
+        .build();
+    ring->mapped_ = static_cast<uint8_t*>(ring->buffer_->map());
+
+    return ring;
+}
+
+UniformRing::Builder UniformRing::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+// ============================================================================
+// UniformRing implementation
+// ============================================================================
+
+void UniformRing::beginFrame(uint32_t frameIndex) {
+    frameStart_ = (frameIndex % framesInFlight_) * frameSize_;
+    head_ = frameStart_;
+    flushed_ = frameStart_;
+}
+
+void UniformRing::flush() {
+    if (head_ > flushed_) {
+        buffer_->flush(flushed_, head_ - flushed_);
+        flushed_ = head_;
+    }
+}
+
+UniformRing::Allocation UniformRing::allocate(VkDeviceSize size) {
+    VkDeviceSize aligned = (size + alignment_ - 1) / alignment_ * alignment_;
+    if (head_ + aligned > frameStart_ + frameSize_) {
+        throw std::runtime_error("UniformRing: frame region exhausted (" +
+                                 std::to_string(frameSize_) + " bytes)");
+    }
+
+    Allocation allocation;
+    allocation.data = mapped_ + head_;
+    allocation.offset = static_cast<uint32_t>(head_);
+    allocation.size = size;
+    head_ += aligned;
+    return allocation;
+}
+
+void UniformRing::write(DescriptorWriter& writer, VkDescriptorSet set, uint32_t binding,
+                        VkDeviceSize range) const {
+    writer.writeBuffer(set, binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                       buffer_->handle(), 0, range);
+}
+
+VkDescriptorBufferInfo UniformRing::descriptorInfo(VkDeviceSize range) const {
+    VkDescriptorBufferInfo info{};
+    info.buffer = buffer_->handle();
+    info.offset = 0;
+    info.range = range;
+    return info;
+}
+
+} // namespace finevk
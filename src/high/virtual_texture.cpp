@@ -0,0 +1,623 @@
+#include "finevk/high/virtual_texture.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/image.hpp"
+#include "finevk/device/sampler.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/rendering/descriptors.hpp"
+#include "finevk/core/thread_pool.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace finevk {
+
+namespace {
+
+constexpr VkShaderStageFlags kStages = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+bool isPowerOfTwo(uint32_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+uint32_t log2u(uint32_t value) {
+    uint32_t result = 0;
+    while (value >>= 1) {
+        result++;
+    }
+    return result;
+}
+
+// Entry fields, see VirtualTexture::entry()
+uint32_t entryLevel(uint32_t entry) { return (entry >> 16) & 0xFF; }
+bool entryValid(uint32_t entry) { return (entry >> 24) != 0; }
+
+} // namespace
+
+// ============================================================================
+// VirtualTexture::Builder implementation
+// ============================================================================
+
+VirtualTexture::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::virtualSize(uint32_t texels) {
+    size_ = texels;
+    return *this;
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::pageSize(uint32_t texels, uint32_t border) {
+    pageSize_ = texels;
+    border_ = border;
+    return *this;
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::cacheSlots(uint32_t columns, uint32_t rows) {
+    cacheColumns_ = columns;
+    cacheRows_ = rows;
+    return *this;
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::srgb(bool enable) {
+    srgb_ = enable;
+    return *this;
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::provider(PageProvider provider) {
+    provider_ = std::move(provider);
+    return *this;
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::threads(ThreadPool* pool) {
+    threads_ = pool;
+    return *this;
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::uploadsPerFrame(uint32_t count) {
+    uploadsPerFrame_ = count;
+    return *this;
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::feedbackCapacity(uint32_t count) {
+    feedbackCapacity_ = count;
+    return *this;
+}
+
+VirtualTexture::Builder& VirtualTexture::Builder::framesInFlight(uint32_t count) {
+    framesInFlight_ = count;
+    return *this;
+}
+
+VirtualTexturePtr VirtualTexture::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("VirtualTexture requires a device");
+    }
+    if (!provider_) {
+        throw std::runtime_error("VirtualTexture requires a page provider");
+    }
+    if (pageSize_ == 0 || size_ % pageSize_ != 0 || !isPowerOfTwo(size_ / pageSize_)) {
+        throw std::runtime_error("VirtualTexture size must be the page size times a power of two");
+    }
+    uint32_t pageCount = size_ / pageSize_;
+    uint32_t levelCount = log2u(pageCount) + 1;
+    if (levelCount > MaxLevels) {
+        throw std::runtime_error("VirtualTexture has more than " + std::to_string(MaxLevels) +
+                                 " levels; use larger pages");
+    }
+    if (border_ * 2 >= pageSize_) {
+        throw std::runtime_error("VirtualTexture page border must be less than half the page size");
+    }
+    if (cacheColumns_ == 0 || cacheRows_ == 0 || cacheColumns_ > 256 || cacheRows_ > 256 ||
+        cacheColumns_ * cacheRows_ < 2) {
+        throw std::runtime_error("VirtualTexture cache needs 2 to 256x256 slots");
+    }
+    if (uploadsPerFrame_ == 0 || feedbackCapacity_ == 0) {
+        throw std::runtime_error("VirtualTexture upload and feedback counts must be non-zero");
+    }
+    uint32_t framesInFlight = framesInFlight_ != 0 ? framesInFlight_ : device_->maxFramesInFlight();
+    if (!device_->enabledFeatures().fragmentStoresAndAtomics) {
+        throw std::runtime_error("VirtualTexture feedback requires fragmentStoresAndAtomics");
+    }
+
+    uint32_t slotSize = pageSize_ + 2 * border_;
+    const auto& limits = device_->physicalDevice()->capabilities().properties.limits;
+    if (cacheColumns_ * slotSize > limits.maxImageDimension2D ||
+        cacheRows_ * slotSize > limits.maxImageDimension2D) {
+        throw std::runtime_error("VirtualTexture cache exceeds maxImageDimension2D (" +
+                                 std::to_string(limits.maxImageDimension2D) + ")");
+    }
+
+    auto vt = VirtualTexturePtr(new VirtualTexture());
+    vt->device_ = device_;
+    vt->provider_ = std::move(provider_);
+    vt->threads_ = threads_ ? threads_ : &ThreadPool::global();
+    vt->pageSize_ = pageSize_;
+    vt->border_ = border_;
+    vt->cacheColumns_ = cacheColumns_;
+    vt->uploadsPerFrame_ = uploadsPerFrame_;
+    vt->feedbackCapacity_ = feedbackCapacity_;
+    vt->maxLoading_ = uploadsPerFrame_ * 4;
+    vt->inbox_ = std::make_shared<Inbox>();
+    vt->slots_.resize(static_cast<size_t>(cacheColumns_) * cacheRows_);
+
+    Params params{};
+    params.cacheSize = glm::vec2(cacheColumns_ * slotSize, cacheRows_ * slotSize);
+    params.virtualSize = static_cast<float>(size_);
+    params.pageCount = pageCount;
+    params.pageSize = pageSize_;
+    params.border = border_;
+    params.levelCount = levelCount;
+    params.feedbackCapacity = feedbackCapacity_;
+
+    // Page table per level and each level's range in the stamp buffer
+    uint32_t tableEntries = 0;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        Level l{};
+        l.pages = pageCount >> level;
+        l.table.assign(static_cast<size_t>(l.pages) * l.pages, 0);
+        l.dirtyMinX = l.dirtyMinY = UINT32_MAX;
+        l.dirtyMaxX = l.dirtyMaxY = 0;
+        params.levelOffsets[level / 4][level % 4] = tableEntries;
+        tableEntries += l.pages * l.pages;
+        vt->levels_.push_back(std::move(l));
+    }
+
+    vt->cache_ = Image::create(device_)
+        .extent(cacheColumns_ * slotSize, cacheRows_ * slotSize)
+        .format(srgb_ ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM)
+        .usage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+    vt->indirection_ = Image::create(device_)
+        .extent(pageCount, pageCount)
+        .format(VK_FORMAT_R8G8B8A8_UINT)
+        .mipLevels(levelCount)
+        .usage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+
+    // Borders make clamp-to-edge bilinear filtering safe inside the atlas
+    vt->cacheSampler_ = Sampler::create(device_)
+        .filter(VK_FILTER_LINEAR)
+        .addressMode(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE)
+        .mipmapMode(VK_SAMPLER_MIPMAP_MODE_NEAREST)
+        .mipLod(0.0f, 0.0f)
+        .build();
+    vt->indirectionSampler_ = Sampler::create(device_)
+        .filter(VK_FILTER_NEAREST)
+        .addressMode(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE)
+        .mipmapMode(VK_SAMPLER_MIPMAP_MODE_NEAREST)
+        .mipLod(0.0f, static_cast<float>(levelCount))
+        .build();
+
+    vt->params_ = Buffer::create(device_)
+        .size(sizeof(Params))
+        .usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+        .memoryUsage(MemoryUsage::CpuToGpu)
+        .build();
+    std::memcpy(vt->params_->mappedPtr(), &params, sizeof(Params));
+
+    vt->stamps_ = Buffer::create(device_)
+        .size(sizeof(uint32_t) * tableEntries)
+        .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+
+    vt->layout_ = DescriptorSetLayout::create(device_)
+        .combinedImageSampler(0, kStages)
+        .combinedImageSampler(1, kStages)
+        .uniformBuffer(2, kStages)
+        .storageBuffer(3, kStages)
+        .storageBuffer(4, kStages)
+        .build();
+    vt->pool_ = DescriptorPool::create(device_)
+        .maxSets(framesInFlight)
+        .poolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 * framesInFlight)
+        .poolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, framesInFlight)
+        .poolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * framesInFlight)
+        .build();
+
+    // Staging holds a frame's tiles plus, at worst, the whole page table
+    VkDeviceSize slotBytes = static_cast<VkDeviceSize>(slotSize) * slotSize * 4;
+    VkDeviceSize stagingSize = slotBytes * uploadsPerFrame_ + sizeof(uint32_t) * tableEntries;
+    VkDeviceSize feedbackSize = sizeof(FeedbackHeader) + sizeof(uint32_t) * feedbackCapacity_;
+
+    vt->frames_.resize(framesInFlight);
+    for (auto& frame : vt->frames_) {
+        frame.feedback = Buffer::create(device_)
+            .size(feedbackSize)
+            .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+            .memoryUsage(MemoryUsage::GpuToCpu)
+            .build();
+        std::memset(frame.feedback->mappedPtr(), 0, sizeof(FeedbackHeader));
+        frame.feedback->flush(0, sizeof(FeedbackHeader));
+        frame.staging = Buffer::create(device_)
+            .size(stagingSize)
+            .usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+            .memoryUsage(MemoryUsage::CpuToGpu)
+            .build();
+
+        frame.set = vt->pool_->allocate(vt->layout_.get());
+        DescriptorWriter(device_)
+            .writeImage(frame.set, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                        vt->cache_->view(), vt->cacheSampler_.get())
+            .writeImage(frame.set, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                        vt->indirection_->view(), vt->indirectionSampler_.get())
+            .writeBuffer(frame.set, 2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, *vt->params_)
+            .writeBuffer(frame.set, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *frame.feedback)
+            .writeBuffer(frame.set, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, *vt->stamps_)
+            .update();
+    }
+
+    // The single top-level page is loaded now and never evicted, so every
+    // lookup resolves to something from the first frame on
+    uint32_t top = pack(levelCount - 1, 0, 0);
+    std::vector<uint8_t> texels(slotBytes);
+    if (!vt->provider_(unpack(top), texels.data())) {
+        throw std::runtime_error("VirtualTexture provider failed for the top-level page");
+    }
+    vt->makeResident(top, 0);
+    vt->slots_[0].pinned = true;
+
+    {
+        auto imm = device_->defaultCommandPool()->beginImmediate();
+        imm.cmd().fillBuffer(*vt->stamps_, 0);
+        imm.cmd().memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+        vt->recordUploads(imm.cmd(), *vt->frames_[0].staging, {{0, texels.data()}}, true);
+    }
+
+    FINEVK_DEBUG(LogCategory::Core, "VirtualTexture: " + std::to_string(size_) + "^2 texels, " +
+                 std::to_string(levelCount) + " levels, " + std::to_string(vt->slots_.size()) +
+                 " cache slots");
+    return vt;
+}
+
+VirtualTexture::Builder VirtualTexture::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+// ============================================================================
+// VirtualTexture implementation
+// ============================================================================
+
+VirtualTexture::~VirtualTexture() {
+    std::lock_guard<std::mutex> lock(inbox_->mutex);
+    inbox_->closed = true;
+    inbox_->loaded.clear();
+}
+
+void VirtualTexture::update(CommandBuffer& cmd, uint32_t frameIndex) {
+    if (frameIndex >= frames_.size()) {
+        throw std::runtime_error("VirtualTexture: frame index out of range");
+    }
+    frameCounter_++;
+    Frame& frame = frames_[frameIndex];
+
+    readFeedback(frame);
+    startLoads();
+
+    {
+        std::lock_guard<std::mutex> lock(inbox_->mutex);
+        while (!inbox_->loaded.empty()) {
+            ready_.push_back(std::move(inbox_->loaded.front()));
+            inbox_->loaded.pop_front();
+        }
+    }
+
+    std::vector<Loaded> batch;
+    while (!ready_.empty() && batch.size() < uploadsPerFrame_) {
+        Loaded loaded = std::move(ready_.front());
+        ready_.pop_front();
+        if (!loaded.ok) {
+            // Requested again if still visible
+            loading_.erase(loaded.page);
+            FINEVK_DEBUG(LogCategory::Core, "VirtualTexture: provider failed for page " +
+                         std::to_string(loaded.page));
+            continue;
+        }
+        batch.push_back(std::move(loaded));
+    }
+
+    // Pages that find no slot wait for one; everything cached was used this frame
+    std::vector<uint32_t> slots = collectSlots(batch.size());
+    for (size_t i = batch.size(); i-- > slots.size();) {
+        ready_.push_front(std::move(batch[i]));
+    }
+    batch.resize(slots.size());
+
+    std::vector<Upload> uploads;
+    uploads.reserve(batch.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+        if (slots_[slots[i]].page != kNoPage) {
+            evict(slots[i]);
+        }
+        loading_.erase(batch[i].page);
+        makeResident(batch[i].page, slots[i]);
+        uploads.push_back({slots[i], batch[i].texels.data()});
+    }
+    recordUploads(cmd, *frame.staging, uploads, false);
+
+    // The frame recorded next stamps pages with this counter
+    auto* header = static_cast<FeedbackHeader*>(frame.feedback->mappedPtr());
+    header->count = 0;
+    header->frame = static_cast<uint32_t>(frameCounter_);
+    frame.feedback->flush(0, sizeof(FeedbackHeader));
+}
+
+void VirtualTexture::bind(CommandBuffer& cmd, VkPipelineLayout pipelineLayout, uint32_t setIndex,
+                          uint32_t frameIndex) const {
+    cmd.bindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, setIndex,
+                           {frames_[frameIndex].set});
+}
+
+void VirtualTexture::readFeedback(Frame& frame) {
+    frame.feedback->invalidate();
+    const auto* header = static_cast<const FeedbackHeader*>(frame.feedback->mappedPtr());
+    const auto* pages = reinterpret_cast<const uint32_t*>(header + 1);
+    uint32_t count = std::min(header->count, feedbackCapacity_);
+    lastRequests_ = count;
+
+    std::unordered_set<uint32_t> missing;
+    for (uint32_t i = 0; i < count; i++) {
+        PageRequest page = unpack(pages[i]);
+        if (page.level >= levels_.size() || page.x >= levels_[page.level].pages ||
+            page.y >= levels_[page.level].pages) {
+            continue;
+        }
+
+        // A missing page is drawn from its nearest resident ancestor;
+        // queue the chain down to it so detail refines coarse to fine
+        for (uint32_t level = page.level; level < levels_.size(); level++) {
+            uint32_t shift = level - page.level;
+            uint32_t ancestor = pack(level, page.x >> shift, page.y >> shift);
+            if (touch(ancestor)) {
+                break;
+            }
+            missing.insert(ancestor);
+        }
+    }
+
+    wanted_.assign(missing.begin(), missing.end());
+    std::sort(wanted_.begin(), wanted_.end(), [](uint32_t a, uint32_t b) { return a > b; });
+}
+
+void VirtualTexture::startLoads() {
+    size_t texelBytes = static_cast<size_t>(slotSize()) * slotSize() * 4;
+
+    // wanted_ is sorted coarsest level first
+    for (uint32_t page : wanted_) {
+        if (loading_.size() >= maxLoading_) {
+            break;
+        }
+        if (!loading_.insert(page).second) {
+            continue;
+        }
+
+        // The job owns its inbox reference, not the texture
+        std::shared_ptr<Inbox> inbox = inbox_;
+        PageProvider provider = provider_;
+        threads_->submit([inbox, provider, page, texelBytes]() {
+            Loaded loaded{page, std::vector<uint8_t>(texelBytes), false};
+            try {
+                loaded.ok = provider(unpack(page), loaded.texels.data());
+            } catch (const std::exception& e) {
+                FINEVK_WARN(LogCategory::Core, std::string("VirtualTexture provider: ") + e.what());
+            }
+
+            std::lock_guard<std::mutex> lock(inbox->mutex);
+            if (!inbox->closed) {
+                inbox->loaded.push_back(std::move(loaded));
+            }
+        });
+    }
+}
+
+bool VirtualTexture::touch(uint32_t page) {
+    auto it = resident_.find(page);
+    if (it == resident_.end()) {
+        return false;
+    }
+    slots_[it->second].lastUsed = frameCounter_;
+    return true;
+}
+
+std::vector<uint32_t> VirtualTexture::collectSlots(size_t count) {
+    std::vector<uint32_t> result;
+    if (count == 0) {
+        return result;
+    }
+
+    std::vector<uint32_t> candidates;
+    for (uint32_t slot = 0; slot < slots_.size(); slot++) {
+        if (slots_[slot].page == kNoPage) {
+            result.push_back(slot);
+            if (result.size() == count) {
+                return result;
+            }
+        } else if (!slots_[slot].pinned && slots_[slot].lastUsed < frameCounter_) {
+            candidates.push_back(slot);
+        }
+    }
+
+    // Least recently used pages not requested this frame
+    size_t take = std::min(count - result.size(), candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + take, candidates.end(),
+                      [this](uint32_t a, uint32_t b) { return slots_[a].lastUsed < slots_[b].lastUsed; });
+    result.insert(result.end(), candidates.begin(), candidates.begin() + take);
+    return result;
+}
+
+void VirtualTexture::makeResident(uint32_t page, uint32_t slot) {
+    slots_[slot].page = page;
+    slots_[slot].lastUsed = frameCounter_;
+    resident_[page] = slot;
+
+    // Take over every entry under the page still drawn from a coarser level
+    setEntries(page, kNoPage, entry(slot % cacheColumns_, slot / cacheColumns_, unpack(page).level));
+}
+
+void VirtualTexture::evict(uint32_t slot) {
+    uint32_t page = slots_[slot].page;
+    PageRequest p = unpack(page);
+    resident_.erase(page);
+    slots_[slot].page = kNoPage;
+
+    // Entries that used this slot fall back to the nearest resident ancestor
+    uint32_t fallback = p.level + 1 < levels_.size() ? resolve(p.level + 1, p.x >> 1, p.y >> 1) : 0;
+    setEntries(page, entry(slot % cacheColumns_, slot / cacheColumns_, p.level), fallback);
+}
+
+uint32_t VirtualTexture::resolve(uint32_t level, uint32_t x, uint32_t y) const {
+    for (uint32_t l = level; l < levels_.size(); l++) {
+        uint32_t shift = l - level;
+        auto it = resident_.find(pack(l, x >> shift, y >> shift));
+        if (it != resident_.end()) {
+            return entry(it->second % cacheColumns_, it->second / cacheColumns_, l);
+        }
+    }
+    return 0;
+}
+
+void VirtualTexture::setEntries(uint32_t page, uint32_t match, uint32_t value) {
+    PageRequest p = unpack(page);
+    for (uint32_t l = 0; l <= p.level; l++) {
+        Level& level = levels_[l];
+        uint32_t shift = p.level - l;
+        uint32_t x0 = p.x << shift, x1 = ((p.x + 1) << shift) - 1;
+        uint32_t y0 = p.y << shift, y1 = ((p.y + 1) << shift) - 1;
+
+        bool changed = false;
+        for (uint32_t y = y0; y <= y1; y++) {
+            uint32_t* row = &level.table[static_cast<size_t>(y) * level.pages];
+            for (uint32_t x = x0; x <= x1; x++) {
+                // kNoPage: replace entries that are empty or drawn from a coarser page
+                bool replace = match == kNoPage
+                    ? !entryValid(row[x]) || entryLevel(row[x]) > p.level
+                    : row[x] == match;
+                if (replace && row[x] != value) {
+                    row[x] = value;
+                    changed = true;
+                }
+            }
+        }
+
+        if (changed) {
+            level.dirtyMinX = std::min(level.dirtyMinX, x0);
+            level.dirtyMinY = std::min(level.dirtyMinY, y0);
+            level.dirtyMaxX = std::max(level.dirtyMaxX, x1);
+            level.dirtyMaxY = std::max(level.dirtyMaxY, y1);
+        }
+    }
+}
+
+void VirtualTexture::recordUploads(CommandBuffer& cmd, Buffer& staging,
+                                   const std::vector<Upload>& uploads, bool initial) {
+    auto* dst = static_cast<uint8_t*>(staging.mappedPtr());
+    VkDeviceSize offset = 0;
+
+    uint32_t slot = slotSize();
+    size_t slotBytes = static_cast<size_t>(slot) * slot * 4;
+    std::vector<VkBufferImageCopy> tileRegions;
+    for (const auto& upload : uploads) {
+        std::memcpy(dst + offset, upload.texels, slotBytes);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {static_cast<int32_t>((upload.slot % cacheColumns_) * slot),
+                              static_cast<int32_t>((upload.slot / cacheColumns_) * slot), 0};
+        region.imageExtent = {slot, slot, 1};
+        tileRegions.push_back(region);
+        offset += slotBytes;
+    }
+
+    // One region per level: the bounding rect of its changed entries
+    std::vector<VkBufferImageCopy> tableRegions;
+    for (uint32_t l = 0; l < levels_.size(); l++) {
+        Level& level = levels_[l];
+        if (level.dirtyMinX > level.dirtyMaxX) {
+            continue;
+        }
+        uint32_t width = level.dirtyMaxX - level.dirtyMinX + 1;
+        uint32_t height = level.dirtyMaxY - level.dirtyMinY + 1;
+        for (uint32_t y = 0; y < height; y++) {
+            const uint32_t* row = &level.table[static_cast<size_t>(level.dirtyMinY + y) * level.pages +
+                                               level.dirtyMinX];
+            std::memcpy(dst + offset + static_cast<size_t>(y) * width * 4, row, width * 4);
+        }
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.bufferRowLength = width;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = l;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {static_cast<int32_t>(level.dirtyMinX),
+                              static_cast<int32_t>(level.dirtyMinY), 0};
+        region.imageExtent = {width, height, 1};
+        tableRegions.push_back(region);
+        offset += static_cast<VkDeviceSize>(width) * height * 4;
+
+        level.dirtyMinX = level.dirtyMinY = UINT32_MAX;
+        level.dirtyMaxX = level.dirtyMaxY = 0;
+    }
+
+    if (tileRegions.empty() && tableRegions.empty()) {
+        return;
+    }
+
+    // Existing contents stay valid; only the copied regions change
+    std::vector<Image*> targets;
+    if (!tileRegions.empty()) {
+        targets.push_back(cache_.get());
+    }
+    if (!tableRegions.empty()) {
+        targets.push_back(indirection_.get());
+    }
+    std::vector<VkImageMemoryBarrier> toTransfer;
+    for (Image* image : targets) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = initial ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image->handle();
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = image->mipLevels();
+        barrier.subresourceRange.layerCount = 1;
+        toTransfer.push_back(barrier);
+    }
+    cmd.pipelineBarrier(VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, toTransfer);
+
+    if (!tileRegions.empty()) {
+        vkCmdCopyBufferToImage(cmd.handle(), staging.handle(), cache_->handle(),
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(tileRegions.size()), tileRegions.data());
+    }
+    if (!tableRegions.empty()) {
+        vkCmdCopyBufferToImage(cmd.handle(), staging.handle(), indirection_->handle(),
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(tableRegions.size()), tableRegions.data());
+    }
+
+    for (Image* image : targets) {
+        cmd.transitionImageLayout(*image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    FINEVK_TRACE(LogCategory::Core, "VirtualTexture: " + std::to_string(tileRegions.size()) +
+                 " pages, " + std::to_string(tableRegions.size()) + " table regions uploaded");
+}
+
+} // namespace finevk
@@ -0,0 +1,330 @@
+#include "finevk/rendering/descriptor_allocator.hpp"
+#include "finevk/rendering/descriptors.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace finevk {
+
+namespace {
+
+bool isPoolExhausted(VkResult result) {
+    return result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL;
+}
+
+// Descriptors per transient set, by type; generous for typical material layouts
+struct TransientRatio {
+    VkDescriptorType type;
+    uint32_t perSet;
+};
+
+constexpr TransientRatio kTransientRatios[] = {
+    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2},
+    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1},
+    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+    {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2},
+    {VK_DESCRIPTOR_TYPE_SAMPLER, 1},
+    {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
+    {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1},
+};
+
+} // namespace
+
+// ============================================================================
+// DescriptorLayoutCache implementation
+// ============================================================================
+
+DescriptorLayoutCache::DescriptorLayoutCache(LogicalDevice* device)
+    : device_(device) {
+}
+
+DescriptorLayoutCache::~DescriptorLayoutCache() = default;
+
+DescriptorSetLayout* DescriptorLayoutCache::get(
+    const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+
+    std::vector<VkDescriptorSetLayoutBinding> sorted = bindings;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) { return a.binding < b.binding; });
+
+    std::vector<uint32_t> key;
+    key.reserve(sorted.size() * 4);
+    for (const auto& b : sorted) {
+        if (b.pImmutableSamplers) {
+            throw std::runtime_error("DescriptorLayoutCache: immutable samplers are not cached");
+        }
+        key.push_back(b.binding);
+        key.push_back(static_cast<uint32_t>(b.descriptorType));
+        key.push_back(b.descriptorCount);
+        key.push_back(b.stageFlags);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = layouts_.find(key);
+    if (it != layouts_.end()) {
+        return it->second.get();
+    }
+
+    auto builder = DescriptorSetLayout::create(device_);
+    for (const auto& b : sorted) {
+        builder.binding(b.binding, b.descriptorType, b.stageFlags, b.descriptorCount);
+    }
+    DescriptorSetLayout* layout = builder.build().release();
+    layouts_.emplace(std::move(key), DescriptorSetLayoutPtr(layout));
+    return layout;
+}
+
+size_t DescriptorLayoutCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return layouts_.size();
+}
+
+void DescriptorLayoutCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    layouts_.clear();
+}
+
+// ============================================================================
+// DescriptorAllocator::Builder implementation
+// ============================================================================
+
+DescriptorAllocator::Builder::Builder(LogicalDevice* device)
+    : device_(device) {
+}
+
+DescriptorAllocator::Builder& DescriptorAllocator::Builder::setsPerPool(uint32_t count) {
+    setsPerPool_ = count;
+    return *this;
+}
+
+DescriptorAllocator::Builder& DescriptorAllocator::Builder::maxSetsPerPool(uint32_t count) {
+    maxSetsPerPool_ = count;
+    return *this;
+}
+
+DescriptorAllocator::Builder& DescriptorAllocator::Builder::framesInFlight(uint32_t count) {
+    framesInFlight_ = count;
+    return *this;
+}
+
+DescriptorAllocator::Builder& DescriptorAllocator::Builder::transientSetsPerPool(uint32_t count) {
+    transientSetsPerPool_ = count;
+    return *this;
+}
+
+DescriptorAllocatorPtr DescriptorAllocator::Builder::build() {
+    if (!device_) {
+        throw std::runtime_error("DescriptorAllocator requires a device");
+    }
+    if (setsPerPool_ == 0 || transientSetsPerPool_ == 0) {
+        throw std::runtime_error("DescriptorAllocator requires non-zero pool sizes");
+    }
+    uint32_t framesInFlight = framesInFlight_ != 0 ? framesInFlight_ : device_->maxFramesInFlight();
+
+    auto allocator = DescriptorAllocatorPtr(new DescriptorAllocator());
+    allocator->device_ = device_;
+    allocator->setsPerPool_ = setsPerPool_;
+    allocator->maxSetsPerPool_ = std::max(maxSetsPerPool_, setsPerPool_);
+    allocator->transientSetsPerPool_ = transientSetsPerPool_;
+    allocator->frames_.resize(framesInFlight);
+    return allocator;
+}
+
+DescriptorAllocator::Builder DescriptorAllocator::create(LogicalDevice* device) {
+    return Builder(device);
+}
+
+// ============================================================================
+// DescriptorAllocator implementation
+// ============================================================================
+
+DescriptorAllocator::~DescriptorAllocator() = default;
+
+std::vector<uint32_t> DescriptorAllocator::signatureOf(const DescriptorSetLayout& layout) {
+    // (type, count) pairs, merged per type and sorted by type
+    std::map<uint32_t, uint32_t> counts;
+    for (const auto& b : layout.bindings()) {
+        counts[static_cast<uint32_t>(b.descriptorType)] += b.descriptorCount;
+    }
+
+    std::vector<uint32_t> signature;
+    signature.reserve(counts.size() * 2);
+    for (const auto& [type, count] : counts) {
+        signature.push_back(type);
+        signature.push_back(count);
+    }
+    return signature;
+}
+
+DescriptorPoolPtr DescriptorAllocator::createFamilyPool(PoolFamily& family) {
+    uint32_t sets = family.nextSets;
+    family.nextSets = std::min(sets * 2, maxSetsPerPool_);
+
+    auto builder = DescriptorPool::create(device_)
+        .maxSets(sets)
+        .allowFree();
+    for (const auto& size : family.perSet) {
+        builder.poolSize(size.type, size.descriptorCount * sets);
+    }
+    return builder.build();
+}
+
+DescriptorPoolPtr DescriptorAllocator::createTransientPool() {
+    auto builder = DescriptorPool::create(device_).maxSets(transientSetsPerPool_);
+    for (const auto& ratio : kTransientRatios) {
+        builder.poolSize(ratio.type, ratio.perSet * transientSetsPerPool_);
+    }
+    return builder.build();
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(DescriptorSetLayout* layout) {
+    return allocate(layout, 1)[0];
+}
+
+std::vector<VkDescriptorSet> DescriptorAllocator::allocate(DescriptorSetLayout* layout,
+                                                           uint32_t count) {
+    if (!layout || count == 0) {
+        throw std::runtime_error("DescriptorAllocator::allocate requires a layout and a count");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(count, layout->handle());
+    std::vector<VkDescriptorSet> sets(count, VK_NULL_HANDLE);
+
+    if (count > maxSetsPerPool_) {
+        throw std::runtime_error("DescriptorAllocator: " + std::to_string(count) +
+                                 " sets exceed maxSetsPerPool");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto signature = signatureOf(*layout);
+    PoolFamily& family = families_[signature];
+    if (family.nextSets == 0) {
+        for (size_t i = 0; i < signature.size(); i += 2) {
+            family.perSet.push_back({static_cast<VkDescriptorType>(signature[i]), signature[i + 1]});
+        }
+        family.nextSets = setsPerPool_;
+    }
+
+    // Current pool first, then any pool freed sets may have room in
+    DescriptorPool* owner = nullptr;
+    for (size_t i = 0; i < family.pools.size() && !owner; i++) {
+        size_t index = (family.current + i) % family.pools.size();
+        VkResult result = family.pools[index]->tryAllocate(layouts.data(), count, sets.data());
+        if (result == VK_SUCCESS) {
+            owner = family.pools[index].get();
+            family.current = index;
+        } else if (!isPoolExhausted(result)) {
+            throw std::runtime_error("Failed to allocate descriptor set");
+        }
+    }
+
+    // All full: grow until a pool is large enough for the request
+    while (!owner) {
+        uint32_t poolSets = family.nextSets;
+        family.pools.push_back(createFamilyPool(family));
+        family.current = family.pools.size() - 1;
+        VkResult result = family.pools.back()->tryAllocate(layouts.data(), count, sets.data());
+        if (result == VK_SUCCESS) {
+            owner = family.pools.back().get();
+        } else if (!isPoolExhausted(result) || poolSets >= count) {
+            throw std::runtime_error("Failed to allocate descriptor set");
+        }
+    }
+
+    for (VkDescriptorSet set : sets) {
+        owners_[set] = owner;
+    }
+    return sets;
+}
+
+void DescriptorAllocator::free(VkDescriptorSet set) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = owners_.find(set);
+    if (it == owners_.end()) {
+        FINEVK_WARN(LogCategory::Core, "DescriptorAllocator::free: set was not allocated here");
+        return;
+    }
+    it->second->free(set);
+    owners_.erase(it);
+}
+
+void DescriptorAllocator::free(const std::vector<VkDescriptorSet>& sets) {
+    for (VkDescriptorSet set : sets) {
+        free(set);
+    }
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frameIndex) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frameIndex_ = frameIndex % static_cast<uint32_t>(frames_.size());
+
+    FramePools& frame = frames_[frameIndex_];
+    for (auto& pool : frame.pools) {
+        pool->reset();
+    }
+    frame.current = 0;
+}
+
+VkDescriptorSet DescriptorAllocator::allocateTransient(DescriptorSetLayout* layout) {
+    if (!layout) {
+        throw std::runtime_error("DescriptorAllocator::allocateTransient requires a layout");
+    }
+
+    VkDescriptorSetLayout handle = layout->handle();
+    VkDescriptorSet set = VK_NULL_HANDLE;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    FramePools& frame = frames_[frameIndex_];
+
+    // Pools before current are full for this frame; reuse those after, then grow
+    while (true) {
+        bool created = false;
+        if (frame.current == frame.pools.size()) {
+            frame.pools.push_back(createTransientPool());
+            created = true;
+        }
+        VkResult result = frame.pools[frame.current]->tryAllocate(&handle, 1, &set);
+        if (result == VK_SUCCESS) {
+            return set;
+        }
+        if (!isPoolExhausted(result)) {
+            throw std::runtime_error("Failed to allocate transient descriptor set");
+        }
+        if (created) {
+            // A fresh pool that can't fit one set never will
+            throw std::runtime_error("DescriptorAllocator: layout does not fit a transient pool");
+        }
+        frame.current++;
+    }
+}
+
+size_t DescriptorAllocator::poolCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& [signature, family] : families_) {
+        count += family.pools.size();
+    }
+    return count;
+}
+
+size_t DescriptorAllocator::transientPoolCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& frame : frames_) {
+        count += frame.pools.size();
+    }
+    return count;
+}
+
+size_t DescriptorAllocator::allocatedSets() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return owners_.size();
+}
+
+} // namespace finevk
@@ -1,6 +1,7 @@
 #include "finevk/rendering/descriptors.hpp"
 #include "finevk/rendering/pipeline.hpp"
 #include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
 #include "finevk/device/buffer.hpp"
 #include "finevk/device/image.hpp"
 #include "finevk/device/sampler.hpp"
@@ -10,7 +11,9 @@
 
 #include <unordered_map>
 
+#include <algorithm>
 #include <stdexcept>
+#include <string>
 
 namespace finevk {
 
@@ -34,6 +37,7 @@ DescriptorSetLayout::Builder& DescriptorSetLayout::Builder::binding(
     layoutBinding.pImmutableSamplers = nullptr;
 
     bindings_.push_back(layoutBinding);
+    bindingFlags_.push_back(0);
     return *this;
 }
 
@@ -57,11 +61,44 @@ DescriptorSetLayout::Builder& DescriptorSetLayout::Builder::storageImage(
     return this->binding(binding, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, stageFlags);
 }
 
+DescriptorSetLayout::Builder& DescriptorSetLayout::Builder::bindingFlags(
+    uint32_t binding, VkDescriptorBindingFlags flags) {
+    for (size_t i = 0; i < bindings_.size(); i++) {
+        if (bindings_[i].binding == binding) {
+            bindingFlags_[i] = flags;
+            return *this;
+        }
+    }
+    throw std::runtime_error("DescriptorSetLayout::Builder::bindingFlags: binding " +
+                             std::to_string(binding) + " not added");
+}
+
+DescriptorSetLayout::Builder& DescriptorSetLayout::Builder::updateAfterBindPool(bool enable) {
+    updateAfterBindPool_ = enable;
+    return *this;
+}
+
 DescriptorSetLayoutPtr DescriptorSetLayout::Builder::build() {
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layoutInfo.bindingCount = static_cast<uint32_t>(bindings_.size());
     layoutInfo.pBindings = bindings_.empty() ? nullptr : bindings_.data();
+    if (updateAfterBindPool_) {
+        layoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    }
+
+    // Only chain binding flags when some are set (core in Vulkan 1.2)
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+    bool anyFlags = false;
+    for (VkDescriptorBindingFlags flags : bindingFlags_) {
+        anyFlags = anyFlags || flags != 0;
+    }
+    if (anyFlags) {
+        flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags_.size());
+        flagsInfo.pBindingFlags = bindingFlags_.data();
+        layoutInfo.pNext = &flagsInfo;
+    }
 
     VkDescriptorSetLayout vkLayout;
     VkResult result = vkCreateDescriptorSetLayout(device_->handle(), &layoutInfo, nullptr, &vkLayout);
@@ -73,6 +110,9 @@ DescriptorSetLayoutPtr DescriptorSetLayout::Builder::build() {
     layout->device_ = device_;
     layout->layout_ = vkLayout;
     layout->bindings_ = bindings_;  // Store bindings for pool auto-sizing
+    if (DescriptorUpdateTemplate::isSupported(device_, bindings_)) {
+        layout->updateTemplate_ = DescriptorUpdateTemplate::create(layout.get());
+    }
 
     return layout;
 }
@@ -92,7 +132,8 @@ DescriptorSetLayout::~DescriptorSetLayout() {
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout&& other) noexcept
     : device_(other.device_)
     , layout_(other.layout_)
-    , bindings_(std::move(other.bindings_)) {
+    , bindings_(std::move(other.bindings_))
+    , updateTemplate_(std::move(other.updateTemplate_)) {
     other.layout_ = VK_NULL_HANDLE;
 }
 
@@ -102,12 +143,14 @@ DescriptorSetLayout& DescriptorSetLayout::operator=(DescriptorSetLayout&& other)
         device_ = other.device_;
         layout_ = other.layout_;
         bindings_ = std::move(other.bindings_);
+        updateTemplate_ = std::move(other.updateTemplate_);
         other.layout_ = VK_NULL_HANDLE;
     }
     return *this;
 }
 
 void DescriptorSetLayout::cleanup() {
+    updateTemplate_.reset();
     if (layout_ != VK_NULL_HANDLE && device_ != nullptr) {
         vkDestroyDescriptorSetLayout(device_->handle(), layout_, nullptr);
         layout_ = VK_NULL_HANDLE;
@@ -140,6 +183,11 @@ DescriptorPool::Builder& DescriptorPool::Builder::allowFree(bool allow) {
     return *this;
 }
 
+DescriptorPool::Builder& DescriptorPool::Builder::updateAfterBind(bool enable) {
+    updateAfterBind_ = enable;
+    return *this;
+}
+
 DescriptorPoolPtr DescriptorPool::Builder::build() {
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -147,7 +195,10 @@ DescriptorPoolPtr DescriptorPool::Builder::build() {
     poolInfo.pPoolSizes = poolSizes_.empty() ? nullptr : poolSizes_.data();
     poolInfo.maxSets = maxSets_;
     if (allowFree_) {
-        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        poolInfo.flags |= VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    }
+    if (updateAfterBind_) {
+        poolInfo.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
     }
 
     VkDescriptorPool vkPool;
@@ -250,6 +301,16 @@ std::vector<VkDescriptorSet> DescriptorPool::allocate(DescriptorSetLayout* layou
     return sets;
 }
 
+VkResult DescriptorPool::tryAllocate(const VkDescriptorSetLayout* layouts, uint32_t count,
+                                     VkDescriptorSet* out) {
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = pool_;
+    allocInfo.descriptorSetCount = count;
+    allocInfo.pSetLayouts = layouts;
+    return vkAllocateDescriptorSets(device_->handle(), &allocInfo, out);
+}
+
 std::vector<VkDescriptorSet> DescriptorPool::allocate(
     const std::vector<DescriptorSetLayout*>& layouts) {
 
@@ -290,12 +351,20 @@ DescriptorWriter::DescriptorWriter(LogicalDevice* device)
     : device_(device) {
 }
 
+DescriptorWriter& DescriptorWriter::reserve(size_t writes) {
+    writes_.reserve(writes);
+    bufferInfos_.reserve(writes);
+    imageInfos_.reserve(writes);
+    infoIndices_.reserve(writes);
+    return *this;
+}
+
 DescriptorWriter& DescriptorWriter::writeBuffer(
     VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
     VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
 
+    uint32_t bufferIndex = static_cast<uint32_t>(bufferInfos_.size());
     bufferInfos_.push_back({buffer, offset, range});
-    int bufferIndex = static_cast<int>(bufferInfos_.size() - 1);
 
     VkWriteDescriptorSet write{};
     write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -308,8 +377,7 @@ DescriptorWriter& DescriptorWriter::writeBuffer(
     write.pBufferInfo = nullptr;
 
     writes_.push_back(write);
-    bufferInfoIndices_.push_back(bufferIndex);
-    imageInfoIndices_.push_back(-1);
+    infoIndices_.push_back(bufferIndex);
     return *this;
 }
 
@@ -322,8 +390,8 @@ DescriptorWriter& DescriptorWriter::writeImage(
     VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
     VkImageView imageView, VkSampler sampler, VkImageLayout layout) {
 
+    uint32_t imageIndex = static_cast<uint32_t>(imageInfos_.size());
     imageInfos_.push_back({sampler, imageView, layout});
-    int imageIndex = static_cast<int>(imageInfos_.size() - 1);
 
     VkWriteDescriptorSet write{};
     write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -336,8 +404,7 @@ DescriptorWriter& DescriptorWriter::writeImage(
     write.pImageInfo = nullptr;
 
     writes_.push_back(write);
-    bufferInfoIndices_.push_back(-1);
-    imageInfoIndices_.push_back(imageIndex);
+    infoIndices_.push_back(imageIndex | ImageInfoBit);
     return *this;
 }
 
@@ -351,11 +418,11 @@ void DescriptorWriter::fixupPointers() {
     // Now that all writes are added, we can safely assign pointers
     // since the vectors won't reallocate anymore
     for (size_t i = 0; i < writes_.size(); i++) {
-        if (bufferInfoIndices_[i] >= 0) {
-            writes_[i].pBufferInfo = &bufferInfos_[bufferInfoIndices_[i]];
-        }
-        if (imageInfoIndices_[i] >= 0) {
-            writes_[i].pImageInfo = &imageInfos_[imageInfoIndices_[i]];
+        uint32_t index = infoIndices_[i];
+        if (index & ImageInfoBit) {
+            writes_[i].pImageInfo = &imageInfos_[index & ~ImageInfoBit];
+        } else {
+            writes_[i].pBufferInfo = &bufferInfos_[index];
         }
     }
 }
@@ -376,8 +443,111 @@ void DescriptorWriter::clear() {
     writes_.clear();
     bufferInfos_.clear();
     imageInfos_.clear();
-    bufferInfoIndices_.clear();
-    imageInfoIndices_.clear();
+    infoIndices_.clear();
+}
+
+// ============================================================================
+// DescriptorUpdateTemplate implementation
+// ============================================================================
+
+bool DescriptorUpdateTemplate::isSupported(const LogicalDevice* device,
+                                           const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+    // Core in Vulkan 1.1
+    if (!device || device->physicalDevice()->capabilities().properties.apiVersion < VK_API_VERSION_1_1) {
+        return false;
+    }
+    for (const auto& binding : bindings) {
+        switch (binding.descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                break;
+            default:
+                return false;  // Inline uniform blocks, acceleration structures, ...
+        }
+    }
+    return true;
+}
+
+DescriptorUpdateTemplatePtr DescriptorUpdateTemplate::create(const DescriptorSetLayout* layout) {
+    if (!layout || !isSupported(layout->device(), layout->bindings())) {
+        throw std::runtime_error("DescriptorUpdateTemplate not supported for this layout");
+    }
+
+    auto tmpl = DescriptorUpdateTemplatePtr(new DescriptorUpdateTemplate());
+    tmpl->device_ = layout->device();
+
+    // Bindings in order, each a run of its array elements
+    auto bindings = layout->bindings();
+    std::sort(bindings.begin(), bindings.end(),
+              [](const auto& a, const auto& b) { return a.binding < b.binding; });
+
+    std::vector<VkDescriptorUpdateTemplateEntry> entries;
+    entries.reserve(bindings.size());
+    for (const auto& binding : bindings) {
+        if (binding.descriptorCount == 0) {
+            continue;
+        }
+        VkDescriptorUpdateTemplateEntry entry{};
+        entry.dstBinding = binding.binding;
+        entry.dstArrayElement = 0;
+        entry.descriptorCount = binding.descriptorCount;
+        entry.descriptorType = binding.descriptorType;
+        entry.offset = static_cast<size_t>(tmpl->descriptorCount_) * sizeof(DescriptorInfo);
+        entry.stride = sizeof(DescriptorInfo);
+        entries.push_back(entry);
+
+        tmpl->ranges_.push_back({binding.binding, tmpl->descriptorCount_, binding.descriptorCount});
+        tmpl->descriptorCount_ += binding.descriptorCount;
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+    createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+    createInfo.pDescriptorUpdateEntries = entries.empty() ? nullptr : entries.data();
+    createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    createInfo.descriptorSetLayout = layout->handle();
+
+    if (vkCreateDescriptorUpdateTemplate(tmpl->device_->handle(), &createInfo, nullptr,
+                                         &tmpl->template_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor update template");
+    }
+    return tmpl;
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate() {
+    if (template_ != VK_NULL_HANDLE && device_ != nullptr) {
+        vkDestroyDescriptorUpdateTemplate(device_->handle(), template_, nullptr);
+    }
+}
+
+uint32_t DescriptorUpdateTemplate::indexOf(uint32_t binding, uint32_t arrayElement) const {
+    auto it = std::lower_bound(ranges_.begin(), ranges_.end(), binding,
+                               [](const Range& range, uint32_t b) { return range.binding < b; });
+    if (it == ranges_.end() || it->binding != binding || arrayElement >= it->count) {
+        throw std::runtime_error("DescriptorUpdateTemplate::indexOf: no descriptor at binding " +
+                                 std::to_string(binding) + "[" + std::to_string(arrayElement) + "]");
+    }
+    return it->first + arrayElement;
+}
+
+void DescriptorUpdateTemplate::update(VkDescriptorSet set, const DescriptorInfo* data) const {
+    vkUpdateDescriptorSetWithTemplate(device_->handle(), set, template_, data);
+}
+
+void DescriptorUpdateTemplate::update(VkDescriptorSet set, const std::vector<DescriptorInfo>& data) const {
+    if (data.size() < descriptorCount_) {
+        throw std::runtime_error("DescriptorUpdateTemplate::update: data has fewer than descriptorCount() elements");
+    }
+    update(set, data.data());
 }
 
 // ============================================================================
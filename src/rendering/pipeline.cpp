@@ -2,13 +2,37 @@
 #include "finevk/rendering/renderpass.hpp"
 #include "finevk/rendering/render_target.hpp"
 #include "finevk/device/logical_device.hpp"
+#include "finevk/device/pipeline_cache.hpp"
 #include "finevk/core/logging.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
 
 namespace finevk {
 
+namespace {
+
+constexpr uint64_t FnvOffset = 14695981039346656037ull;
+constexpr uint64_t FnvPrime = 1099511628211ull;
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = FnvOffset) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FnvPrime;
+    }
+    return hash;
+}
+
+uint64_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // ShaderModule implementation
 // ============================================================================
@@ -29,6 +53,7 @@ ShaderModulePtr ShaderModule::fromSPIRV(LogicalDevice* device,
     auto module = ShaderModulePtr(new ShaderModule());
     module->device_ = device;
     module->module_ = vkModule;
+    module->codeHash_ = hashBytes(spirv.data(), spirv.size() * sizeof(uint32_t));
 
     return module;
 }
@@ -58,7 +83,8 @@ ShaderModule::~ShaderModule() {
 
 ShaderModule::ShaderModule(ShaderModule&& other) noexcept
     : device_(other.device_)
-    , module_(other.module_) {
+    , module_(other.module_)
+    , codeHash_(other.codeHash_) {
     other.module_ = VK_NULL_HANDLE;
 }
 
@@ -67,6 +93,7 @@ ShaderModule& ShaderModule::operator=(ShaderModule&& other) noexcept {
         cleanup();
         device_ = other.device_;
         module_ = other.module_;
+        codeHash_ = other.codeHash_;
         other.module_ = VK_NULL_HANDLE;
     }
     return *this;
@@ -79,6 +106,61 @@ void ShaderModule::cleanup() {
     }
 }
 
+// ============================================================================
+// SpecializationConstants implementation
+// ============================================================================
+
+SpecializationConstants& SpecializationConstants::setRaw(uint32_t constantId, uint32_t bits) {
+    for (size_t i = 0; i < entries_.size(); i++) {
+        if (entries_[i].constantID == constantId) {
+            data_[i] = bits;
+            return *this;
+        }
+    }
+
+    VkSpecializationMapEntry entry{};
+    entry.constantID = constantId;
+    entry.offset = static_cast<uint32_t>(data_.size() * sizeof(uint32_t));
+    entry.size = sizeof(uint32_t);
+    entries_.push_back(entry);
+    data_.push_back(bits);
+    return *this;
+}
+
+SpecializationConstants& SpecializationConstants::set(uint32_t constantId, uint32_t value) {
+    return setRaw(constantId, value);
+}
+
+SpecializationConstants& SpecializationConstants::set(uint32_t constantId, int32_t value) {
+    return setRaw(constantId, static_cast<uint32_t>(value));
+}
+
+SpecializationConstants& SpecializationConstants::set(uint32_t constantId, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return setRaw(constantId, bits);
+}
+
+SpecializationConstants& SpecializationConstants::set(uint32_t constantId, bool value) {
+    return setRaw(constantId, value ? VK_TRUE : VK_FALSE);
+}
+
+SpecializationConstants& SpecializationConstants::merge(const SpecializationConstants& other) {
+    for (size_t i = 0; i < other.entries_.size(); i++) {
+        setRaw(other.entries_[i].constantID, other.data_[i]);
+    }
+    return *this;
+}
+
+VkSpecializationInfo SpecializationConstants::info() const {
+    VkSpecializationInfo info{};
+    info.mapEntryCount = static_cast<uint32_t>(entries_.size());
+    info.pMapEntries = entries_.data();
+    info.dataSize = data_.size() * sizeof(uint32_t);
+    info.pData = data_.data();
+    return info;
+}
+
 // ============================================================================
 // PipelineLayout::Builder implementation
 // ============================================================================
@@ -103,6 +185,15 @@ PipelineLayout::Builder& PipelineLayout::Builder::addPushConstantRange(
     return *this;
 }
 
+PipelineLayout::Builder& PipelineLayout::Builder::addObjectPushConstants(
+    VkShaderStageFlags stages) {
+    if (stages == 0) {
+        throw std::runtime_error("addObjectPushConstants requires at least one shader stage");
+    }
+    objectStages_ |= stages;
+    return addPushConstantRange(stages, 0, sizeof(ObjectPushConstants));
+}
+
 PipelineLayoutPtr PipelineLayout::Builder::build() {
     VkPipelineLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -120,6 +211,7 @@ PipelineLayoutPtr PipelineLayout::Builder::build() {
     auto layout = PipelineLayoutPtr(new PipelineLayout());
     layout->device_ = device_;
     layout->layout_ = vkLayout;
+    layout->objectStages_ = objectStages_;
 
     return layout;
 }
@@ -138,7 +230,8 @@ PipelineLayout::~PipelineLayout() {
 
 PipelineLayout::PipelineLayout(PipelineLayout&& other) noexcept
     : device_(other.device_)
-    , layout_(other.layout_) {
+    , layout_(other.layout_)
+    , objectStages_(other.objectStages_) {
     other.layout_ = VK_NULL_HANDLE;
 }
 
@@ -147,6 +240,7 @@ PipelineLayout& PipelineLayout::operator=(PipelineLayout&& other) noexcept {
         cleanup();
         device_ = other.device_;
         layout_ = other.layout_;
+        objectStages_ = other.objectStages_;
         other.layout_ = VK_NULL_HANDLE;
     }
     return *this;
@@ -168,28 +262,80 @@ GraphicsPipeline::Builder::Builder(LogicalDevice* device, RenderPass* renderPass
     : device_(device), renderPass_(renderPass), layout_(layout) {
 }
 
-GraphicsPipeline::Builder& GraphicsPipeline::Builder::vertexShader(
-    ShaderModule* module, const char* entryPoint) {
+void GraphicsPipeline::Builder::addStage(std::vector<VkPipelineShaderStageCreateInfo>& stages,
+                                         VkShaderStageFlagBits stage, ShaderModule* module,
+                                         const char* entryPoint) {
     VkPipelineShaderStageCreateInfo stageInfo{};
     stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stageInfo.stage = stage;
     stageInfo.module = module->handle();
     stageInfo.pName = entryPoint;
-    shaderStages_.push_back(stageInfo);
+    stages.push_back(stageInfo);
+    moduleHashes_.emplace_back(module->handle(), module->codeHash());
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::vertexShader(
+    ShaderModule* module, const char* entryPoint) {
+    addStage(shaderStages_, VK_SHADER_STAGE_VERTEX_BIT, module, entryPoint);
     return *this;
 }
 
 GraphicsPipeline::Builder& GraphicsPipeline::Builder::fragmentShader(
     ShaderModule* module, const char* entryPoint) {
-    VkPipelineShaderStageCreateInfo stageInfo{};
-    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    stageInfo.module = module->handle();
-    stageInfo.pName = entryPoint;
-    shaderStages_.push_back(stageInfo);
+    addStage(shaderStages_, VK_SHADER_STAGE_FRAGMENT_BIT, module, entryPoint);
     return *this;
 }
 
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::taskShader(
+    ShaderModule* module, const char* entryPoint) {
+    addStage(meshStages_, VK_SHADER_STAGE_TASK_BIT_EXT, module, entryPoint);
+    return *this;
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::meshShader(
+    ShaderModule* module, const char* entryPoint) {
+    addStage(meshStages_, VK_SHADER_STAGE_MESH_BIT_EXT, module, entryPoint);
+    return *this;
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::specialization(
+    VkShaderStageFlags stages, const SpecializationConstants& constants) {
+    for (uint32_t bit = 1; bit != 0 && bit <= stages; bit <<= 1) {
+        if (!(stages & bit)) {
+            continue;
+        }
+        auto stage = static_cast<VkShaderStageFlagBits>(bit);
+        auto it = std::find_if(constants_.begin(), constants_.end(),
+            [stage](const auto& entry) { return entry.first == stage; });
+        if (it == constants_.end()) {
+            constants_.emplace_back(stage, constants);
+        } else {
+            it->second.merge(constants);
+        }
+    }
+    return *this;
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::constant(
+    VkShaderStageFlags stages, uint32_t constantId, uint32_t value) {
+    return specialization(stages, SpecializationConstants().set(constantId, value));
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::constant(
+    VkShaderStageFlags stages, uint32_t constantId, int32_t value) {
+    return specialization(stages, SpecializationConstants().set(constantId, value));
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::constant(
+    VkShaderStageFlags stages, uint32_t constantId, float value) {
+    return specialization(stages, SpecializationConstants().set(constantId, value));
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::constant(
+    VkShaderStageFlags stages, uint32_t constantId, bool value) {
+    return specialization(stages, SpecializationConstants().set(constantId, value));
+}
+
 GraphicsPipeline::Builder& GraphicsPipeline::Builder::vertexBinding(
     uint32_t binding, uint32_t stride, VkVertexInputRate inputRate) {
     VkVertexInputBindingDescription desc{};
@@ -326,12 +472,91 @@ GraphicsPipeline::Builder& GraphicsPipeline::Builder::dynamicViewportAndScissor(
     return *this;
 }
 
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::dynamicFragmentShadingRate() {
+    if (device_->supportsFragmentShadingRate()) {
+        dynamicStates_.push_back(VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR);
+    }
+    return *this;
+}
+
 GraphicsPipeline::Builder& GraphicsPipeline::Builder::subpass(uint32_t index) {
     subpass_ = index;
     return *this;
 }
 
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::renderingFormats(
+    const std::vector<VkFormat>& colorFormats, VkFormat depthFormat, VkFormat stencilFormat) {
+    dynamicRendering_ = true;
+    colorFormats_ = colorFormats;
+    depthFormat_ = depthFormat;
+    stencilFormat_ = stencilFormat;
+    return *this;
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::viewMask(uint32_t mask) {
+    viewMask_ = mask;
+    return *this;
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::colorAttachmentCount(uint32_t count) {
+    colorAttachmentCount_ = count;
+    return *this;
+}
+
+GraphicsPipeline::Builder& GraphicsPipeline::Builder::cache(VkPipelineCache cache) {
+    cache_ = cache;
+    useDeviceCache_ = false;
+    return *this;
+}
+
 GraphicsPipelinePtr GraphicsPipeline::Builder::build() {
+    if (dynamicRendering_ && !device_->supportsDynamicRendering()) {
+        throw std::runtime_error("Rendering formats set but dynamic rendering not enabled on this device");
+    }
+    if (!dynamicRendering_ && !renderPass_) {
+        throw std::runtime_error("Graphics pipeline needs a render pass or rendering formats");
+    }
+
+    // Task/mesh stages replace the vertex stage where the device has them
+    bool hasMeshStage = std::any_of(meshStages_.begin(), meshStages_.end(),
+        [](const VkPipelineShaderStageCreateInfo& stage) {
+            return stage.stage == VK_SHADER_STAGE_MESH_BIT_EXT;
+        });
+    if (!hasMeshStage && !meshStages_.empty()) {
+        throw std::runtime_error("Task shader needs a mesh shader");
+    }
+    bool useMesh = hasMeshStage && device_->supportsMeshShading();
+    std::vector<VkPipelineShaderStageCreateInfo> stages;
+    for (const auto& stage : shaderStages_) {
+        if (!useMesh || stage.stage != VK_SHADER_STAGE_VERTEX_BIT) {
+            stages.push_back(stage);
+        }
+    }
+    if (useMesh) {
+        stages.insert(stages.begin(), meshStages_.begin(), meshStages_.end());
+    } else if (hasMeshStage) {
+        bool hasVertexStage = std::any_of(stages.begin(), stages.end(),
+            [](const VkPipelineShaderStageCreateInfo& stage) {
+                return stage.stage == VK_SHADER_STAGE_VERTEX_BIT;
+            });
+        if (!hasVertexStage) {
+            throw std::runtime_error("Mesh shading unavailable and no vertex shader fallback set");
+        }
+        FINEVK_DEBUG(LogCategory::Core, "Mesh shading unavailable, using vertex shader fallback");
+    }
+
+    // Specialization infos point into constants_, which outlives the create call
+    std::vector<VkSpecializationInfo> specializationInfos;
+    specializationInfos.reserve(stages.size());
+    for (auto& stage : stages) {
+        for (const auto& [constantStage, constants] : constants_) {
+            if (constantStage == stage.stage && !constants.empty()) {
+                specializationInfos.push_back(constants.info());
+                stage.pSpecializationInfo = &specializationInfos.back();
+            }
+        }
+    }
+
     // Vertex input state
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -397,11 +622,14 @@ GraphicsPipelinePtr GraphicsPipeline::Builder::build() {
     colorBlendAttachment.dstAlphaBlendFactor = dstAlphaBlendFactor_;
     colorBlendAttachment.alphaBlendOp = alphaBlendOp_;
 
+    std::vector<VkPipelineColorBlendAttachmentState> blendAttachments(
+        dynamicRendering_ ? colorFormats_.size() : colorAttachmentCount_, colorBlendAttachment);
+
     VkPipelineColorBlendStateCreateInfo colorBlending{};
     colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
     colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
+    colorBlending.attachmentCount = static_cast<uint32_t>(blendAttachments.size());
+    colorBlending.pAttachments = blendAttachments.empty() ? nullptr : blendAttachments.data();
 
     // Dynamic state
     VkPipelineDynamicStateCreateInfo dynamicState{};
@@ -412,10 +640,10 @@ GraphicsPipelinePtr GraphicsPipeline::Builder::build() {
     // Create pipeline
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages_.size());
-    pipelineInfo.pStages = shaderStages_.data();
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
+    pipelineInfo.pStages = stages.data();
+    pipelineInfo.pVertexInputState = useMesh ? nullptr : &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = useMesh ? nullptr : &inputAssembly;
     pipelineInfo.pViewportState = &viewportState;
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
@@ -423,12 +651,28 @@ GraphicsPipelinePtr GraphicsPipeline::Builder::build() {
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = dynamicStates_.empty() ? nullptr : &dynamicState;
     pipelineInfo.layout = layout_->handle();
-    pipelineInfo.renderPass = renderPass_->handle();
-    pipelineInfo.subpass = subpass_;
+
+    // Dynamic rendering names attachment formats instead of a render pass
+    VkPipelineRenderingCreateInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    if (dynamicRendering_) {
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorFormats_.size());
+        renderingInfo.pColorAttachmentFormats = colorFormats_.empty() ? nullptr : colorFormats_.data();
+        renderingInfo.depthAttachmentFormat = depthFormat_;
+        renderingInfo.stencilAttachmentFormat = stencilFormat_;
+        renderingInfo.viewMask = viewMask_;
+        pipelineInfo.pNext = &renderingInfo;
+        pipelineInfo.renderPass = VK_NULL_HANDLE;
+        pipelineInfo.subpass = 0;
+    } else {
+        pipelineInfo.renderPass = renderPass_->handle();
+        pipelineInfo.subpass = subpass_;
+    }
 
     VkPipeline vkPipeline;
+    VkPipelineCache cache = useDeviceCache_ ? device_->pipelineCache().handle() : cache_;
     VkResult result = vkCreateGraphicsPipelines(
-        device_->handle(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &vkPipeline);
+        device_->handle(), cache, 1, &pipelineInfo, nullptr, &vkPipeline);
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to create graphics pipeline");
     }
@@ -436,12 +680,110 @@ GraphicsPipelinePtr GraphicsPipeline::Builder::build() {
     auto pipeline = GraphicsPipelinePtr(new GraphicsPipeline());
     pipeline->device_ = device_;
     pipeline->pipeline_ = vkPipeline;
+    pipeline->usesMeshShader_ = useMesh;
+    std::vector<uint64_t> key = stateKey();
+    pipeline->stateHash_ = hashBytes(key.data(), key.size() * sizeof(uint64_t));
 
     FINEVK_DEBUG(LogCategory::Core, "Graphics pipeline created");
 
     return pipeline;
 }
 
+GraphicsPipelineRef GraphicsPipeline::Builder::buildShared() {
+    return device_->pipelineRegistry().get(*this);
+}
+
+std::vector<uint64_t> GraphicsPipeline::Builder::stateKey() const {
+    std::vector<uint64_t> key;
+    key.reserve(64);
+
+    auto addStages = [&](const std::vector<VkPipelineShaderStageCreateInfo>& stages) {
+        key.push_back(stages.size());
+        for (const auto& stage : stages) {
+            auto module = std::find_if(moduleHashes_.begin(), moduleHashes_.end(),
+                [&stage](const auto& entry) { return entry.first == stage.module; });
+            key.push_back(stage.stage);
+            key.push_back(module != moduleHashes_.end() ? module->second : 0);
+            key.push_back(hashBytes(stage.pName, std::strlen(stage.pName)));
+        }
+    };
+    addStages(shaderStages_);
+    addStages(meshStages_);
+
+    // Constants in ID order, so the order they were set in doesn't matter
+    key.push_back(constants_.size());
+    auto sortedConstants = constants_;
+    std::sort(sortedConstants.begin(), sortedConstants.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [stage, constants] : sortedConstants) {
+        VkSpecializationInfo info = constants.info();
+        std::vector<std::pair<uint32_t, uint32_t>> values;
+        for (uint32_t i = 0; i < info.mapEntryCount; i++) {
+            uint32_t value;
+            std::memcpy(&value, static_cast<const uint8_t*>(info.pData) + info.pMapEntries[i].offset,
+                        sizeof(value));
+            values.emplace_back(info.pMapEntries[i].constantID, value);
+        }
+        std::sort(values.begin(), values.end());
+        key.push_back(stage);
+        key.push_back(values.size());
+        for (const auto& [id, value] : values) {
+            key.push_back((static_cast<uint64_t>(id) << 32) | value);
+        }
+    }
+
+    key.push_back(vertexBindings_.size());
+    for (const auto& binding : vertexBindings_) {
+        key.push_back(binding.binding);
+        key.push_back(binding.stride);
+        key.push_back(binding.inputRate);
+    }
+    key.push_back(vertexAttributes_.size());
+    for (const auto& attribute : vertexAttributes_) {
+        key.push_back(attribute.location);
+        key.push_back(attribute.binding);
+        key.push_back(attribute.format);
+        key.push_back(attribute.offset);
+    }
+
+    key.insert(key.end(), {
+        static_cast<uint64_t>(topology_), primitiveRestart_,
+        static_cast<uint64_t>(polygonMode_), cullMode_, static_cast<uint64_t>(frontFace_),
+        floatBits(lineWidth_), depthBiasEnable_,
+        floatBits(depthBiasConstant_), floatBits(depthBiasClamp_), floatBits(depthBiasSlope_),
+        static_cast<uint64_t>(samples_), sampleShadingEnable_, floatBits(minSampleShading_),
+        depthTestEnable_, depthWriteEnable_, static_cast<uint64_t>(depthCompareOp_),
+        depthBoundsTestEnable_, floatBits(depthBoundsMin_), floatBits(depthBoundsMax_),
+        blendEnable_,
+        static_cast<uint64_t>(srcColorBlendFactor_), static_cast<uint64_t>(dstColorBlendFactor_),
+        static_cast<uint64_t>(colorBlendOp_),
+        static_cast<uint64_t>(srcAlphaBlendFactor_), static_cast<uint64_t>(dstAlphaBlendFactor_),
+        static_cast<uint64_t>(alphaBlendOp_),
+    });
+
+    key.push_back(dynamicStates_.size());
+    for (VkDynamicState state : dynamicStates_) {
+        key.push_back(state);
+    }
+
+    key.push_back(reinterpret_cast<uint64_t>(layout_ ? layout_->handle() : VK_NULL_HANDLE));
+    key.push_back(dynamicRendering_);
+    if (dynamicRendering_) {
+        key.push_back(colorFormats_.size());
+        for (VkFormat format : colorFormats_) {
+            key.push_back(format);
+        }
+        key.push_back(depthFormat_);
+        key.push_back(stencilFormat_);
+        key.push_back(viewMask_);
+    } else {
+        key.push_back(renderPass_ ? renderPass_->compatibilityHash() : 0);
+        key.push_back(subpass_);
+        key.push_back(colorAttachmentCount_);
+    }
+    return key;
+}
+
 // ============================================================================
 // GraphicsPipeline implementation
 // ============================================================================
@@ -453,8 +795,18 @@ GraphicsPipeline::Builder GraphicsPipeline::create(
 
 GraphicsPipeline::Builder GraphicsPipeline::create(
     LogicalDevice* device, RenderTarget* renderTarget, PipelineLayout* layout) {
-    // Create builder with render pass from target
+    // Create builder with render pass (or attachment formats) from target
     auto builder = Builder(device, renderTarget->renderPass(), layout);
+    if (renderTarget->usesDynamicRendering()) {
+        std::vector<VkFormat> colorFormats;
+        if (renderTarget->hasColor()) {
+            colorFormats.push_back(renderTarget->colorFormat());
+        }
+        builder.renderingFormats(colorFormats, renderTarget->depthFormat(), renderTarget->stencilFormat());
+        builder.viewMask(renderTarget->viewMask());
+    } else if (!renderTarget->hasColor()) {
+        builder.colorAttachmentCount(0);
+    }
 
     // Auto-configure MSAA from render target
     builder.samples(renderTarget->msaaSamples());
@@ -468,7 +820,8 @@ GraphicsPipeline::~GraphicsPipeline() {
 
 GraphicsPipeline::GraphicsPipeline(GraphicsPipeline&& other) noexcept
     : device_(other.device_)
-    , pipeline_(other.pipeline_) {
+    , pipeline_(other.pipeline_)
+    , usesMeshShader_(other.usesMeshShader_) {
     other.pipeline_ = VK_NULL_HANDLE;
 }
 
@@ -477,6 +830,7 @@ GraphicsPipeline& GraphicsPipeline::operator=(GraphicsPipeline&& other) noexcept
         cleanup();
         device_ = other.device_;
         pipeline_ = other.pipeline_;
+        usesMeshShader_ = other.usesMeshShader_;
         other.pipeline_ = VK_NULL_HANDLE;
     }
     return *this;
@@ -490,4 +844,159 @@ void GraphicsPipeline::cleanup() {
     }
 }
 
+// ============================================================================
+// PipelineRegistry implementation
+// ============================================================================
+
+PipelineRegistry::PipelineRegistry(LogicalDevice* device)
+    : device_(device) {
+}
+
+PipelineRegistry::~PipelineRegistry() {
+    // Users may still hold references; their pipelines must not outlive the device
+    for (auto& [key, pipeline] : pipelines_) {
+        pipeline->cleanup();
+    }
+}
+
+GraphicsPipelineRef PipelineRegistry::get(GraphicsPipeline::Builder& builder) {
+    Key key = builder.stateKey();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pipelines_.find(key);
+        if (it != pipelines_.end()) {
+            hits_++;
+            return it->second;
+        }
+    }
+
+    // Compile without the lock; if another thread won the race, keep its pipeline
+    GraphicsPipelineRef pipeline = builder.build();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = pipelines_.emplace(std::move(key), pipeline);
+    if (!inserted) {
+        hits_++;
+    }
+    return it->second;
+}
+
+size_t PipelineRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pipelines_.size();
+}
+
+uint64_t PipelineRegistry::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t PipelineRegistry::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t destroyed = 0;
+    for (auto it = pipelines_.begin(); it != pipelines_.end();) {
+        if (it->second.use_count() == 1) {
+            it = pipelines_.erase(it);
+            destroyed++;
+        } else {
+            ++it;
+        }
+    }
+    return destroyed;
+}
+
+// ============================================================================
+// ComputePipeline::Builder implementation
+// ============================================================================
+
+ComputePipeline::Builder::Builder(LogicalDevice* device, PipelineLayout* layout)
+    : device_(device), layout_(layout) {
+}
+
+ComputePipeline::Builder& ComputePipeline::Builder::shader(ShaderModule* module, const char* entryPoint) {
+    module_ = module;
+    entryPoint_ = entryPoint;
+    return *this;
+}
+
+ComputePipeline::Builder& ComputePipeline::Builder::cache(VkPipelineCache cache) {
+    cache_ = cache;
+    useDeviceCache_ = false;
+    return *this;
+}
+
+ComputePipelinePtr ComputePipeline::Builder::build() {
+    if (!module_) {
+        throw std::runtime_error("Compute pipeline requires a shader");
+    }
+    if (!layout_) {
+        throw std::runtime_error("Compute pipeline requires a pipeline layout");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module_->handle();
+    pipelineInfo.stage.pName = entryPoint_;
+    pipelineInfo.layout = layout_->handle();
+
+    VkSpecializationInfo specializationInfo = constants_.info();
+    if (!constants_.empty()) {
+        pipelineInfo.stage.pSpecializationInfo = &specializationInfo;
+    }
+
+    VkPipeline vkPipeline;
+    VkPipelineCache cache = useDeviceCache_ ? device_->pipelineCache().handle() : cache_;
+    VkResult result = vkCreateComputePipelines(
+        device_->handle(), cache, 1, &pipelineInfo, nullptr, &vkPipeline);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create compute pipeline");
+    }
+
+    auto pipeline = ComputePipelinePtr(new ComputePipeline());
+    pipeline->device_ = device_;
+    pipeline->pipeline_ = vkPipeline;
+
+    FINEVK_DEBUG(LogCategory::Core, "Compute pipeline created");
+
+    return pipeline;
+}
+
+// ============================================================================
+// ComputePipeline implementation
+// ============================================================================
+
+ComputePipeline::Builder ComputePipeline::create(LogicalDevice* device, PipelineLayout* layout) {
+    return Builder(device, layout);
+}
+
+ComputePipeline::~ComputePipeline() {
+    cleanup();
+}
+
+ComputePipeline::ComputePipeline(ComputePipeline&& other) noexcept
+    : device_(other.device_)
+    , pipeline_(other.pipeline_) {
+    other.pipeline_ = VK_NULL_HANDLE;
+}
+
+ComputePipeline& ComputePipeline::operator=(ComputePipeline&& other) noexcept {
+    if (this != &other) {
+        cleanup();
+        device_ = other.device_;
+        pipeline_ = other.pipeline_;
+        other.pipeline_ = VK_NULL_HANDLE;
+    }
+    return *this;
+}
+
+void ComputePipeline::cleanup() {
+    if (pipeline_ != VK_NULL_HANDLE && device_ != nullptr) {
+        vkDestroyPipeline(device_->handle(), pipeline_, nullptr);
+        pipeline_ = VK_NULL_HANDLE;
+        FINEVK_DEBUG(LogCategory::Core, "Compute pipeline destroyed");
+    }
+}
+
 } // namespace finevk
@@ -0,0 +1,125 @@
+#include "finevk/rendering/pipeline_batch.hpp"
+#include "finevk/core/logging.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace finevk {
+
+// ============================================================================
+// PipelineHandle implementation
+// ============================================================================
+
+bool PipelineHandle::ready() const {
+    return state_ && state_->done.load(std::memory_order_acquire);
+}
+
+bool PipelineHandle::failed() const {
+    return ready() && state_->error != nullptr;
+}
+
+GraphicsPipeline* PipelineHandle::get() const {
+    if (!ready()) {
+        return nullptr;
+    }
+    return state_->pipeline.get();
+}
+
+GraphicsPipeline& PipelineHandle::wait() const {
+    if (!state_) {
+        throw std::runtime_error("Waiting on an empty pipeline handle");
+    }
+    state_->future.wait();
+    if (state_->error) {
+        std::rethrow_exception(state_->error);
+    }
+    if (!state_->pipeline) {
+        throw std::runtime_error("Pipeline was already taken from this handle");
+    }
+    return *state_->pipeline;
+}
+
+GraphicsPipelinePtr PipelineHandle::take() {
+    wait();
+    return std::move(state_->pipeline);
+}
+
+// ============================================================================
+// PipelineBatch implementation
+// ============================================================================
+
+PipelineBatch::PipelineBatch(uint32_t threads)
+    : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+PipelineBatch::~PipelineBatch() {
+    wait();
+}
+
+PipelineHandle PipelineBatch::add(GraphicsPipeline::Builder builder) {
+    auto state = std::make_shared<PipelineHandle::State>();
+    state->future = state->promise.get_future().share();
+
+    queued_.push_back({std::move(builder), state});
+
+    PipelineHandle handle;
+    handle.state_ = std::move(state);
+    return handle;
+}
+
+void PipelineBatch::runJobs(std::shared_ptr<std::vector<Job>> jobs,
+                            std::shared_ptr<std::atomic<size_t>> next) {
+    for (size_t i = (*next)++; i < jobs->size(); i = (*next)++) {
+        Job& job = (*jobs)[i];
+        try {
+            job.state->pipeline = job.builder.build();
+        } catch (...) {
+            job.state->error = std::current_exception();
+        }
+        job.state->done.store(true, std::memory_order_release);
+        job.state->promise.set_value();
+    }
+}
+
+void PipelineBatch::compile() {
+    if (queued_.empty()) {
+        return;
+    }
+
+    auto jobs = std::make_shared<std::vector<Job>>(std::move(queued_));
+    queued_.clear();
+    auto next = std::make_shared<std::atomic<size_t>>(0);
+
+    for (const auto& job : *jobs) {
+        inFlight_.push_back(job.state);
+    }
+
+    uint32_t workerCount = std::min<uint32_t>(threads_, static_cast<uint32_t>(jobs->size()));
+    FINEVK_DEBUG(LogCategory::Render, "Compiling " + std::to_string(jobs->size()) +
+        " pipelines on " + std::to_string(workerCount) + " threads");
+
+    for (uint32_t w = 0; w < workerCount; w++) {
+        workers_.push_back(std::async(std::launch::async, &PipelineBatch::runJobs, this, jobs, next));
+    }
+}
+
+void PipelineBatch::wait() {
+    for (auto& worker : workers_) {
+        worker.wait();
+    }
+    workers_.clear();
+    inFlight_.clear();
+}
+
+size_t PipelineBatch::pendingCount() const {
+    size_t count = queued_.size();
+    for (const auto& state : inFlight_) {
+        if (!state->done.load(std::memory_order_acquire)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace finevk
@@ -0,0 +1,732 @@
+#include "finevk/rendering/render_graph.hpp"
+#include "finevk/device/logical_device.hpp"
+#include "finevk/device/command.hpp"
+#include "finevk/device/buffer.hpp"
+#include "finevk/device/image.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace finevk {
+
+namespace {
+
+struct AccessInfo {
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+    VkImageLayout layout;           // VK_IMAGE_LAYOUT_UNDEFINED: buffers only
+    VkImageUsageFlags usage;
+};
+
+AccessInfo accessInfo(GraphAccess access) {
+    constexpr VkPipelineStageFlags shaderStages =
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    constexpr VkPipelineStageFlags depthStages =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+    switch (access) {
+        case GraphAccess::ColorAttachment:
+            return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT};
+        case GraphAccess::DepthAttachment:
+            return {depthStages,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+        case GraphAccess::DepthRead:
+            return {depthStages, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+        case GraphAccess::SampledFragment:
+            return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT};
+        case GraphAccess::SampledCompute:
+            return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT};
+        case GraphAccess::Storage:
+            return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT};
+        case GraphAccess::TransferSrc:
+            return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+        case GraphAccess::TransferDst:
+            return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+        case GraphAccess::VertexInput:
+            return {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                    VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED, 0};
+        case GraphAccess::Indirect:
+            return {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED, 0};
+        case GraphAccess::Uniform:
+            return {shaderStages, VK_ACCESS_UNIFORM_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, 0};
+    }
+    return {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+            VK_IMAGE_LAYOUT_GENERAL, 0};
+}
+
+VkImageAspectFlags aspectsOf(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        case VK_FORMAT_S8_UINT:
+            return VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
+bool overlaps(const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
+    return a.first <= b.second && b.first <= a.second;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// RenderGraph::Context implementation
+// ============================================================================
+
+VkImage RenderGraph::Context::image(GraphImage handle) const {
+    return graph_.images_.at(handle.index).image;
+}
+
+VkImageView RenderGraph::Context::view(GraphImage handle) const {
+    return graph_.images_.at(handle.index).view;
+}
+
+VkExtent2D RenderGraph::Context::extent(GraphImage handle) const {
+    const auto& desc = graph_.images_.at(handle.index).desc;
+    return {desc.width, desc.height};
+}
+
+VkFormat RenderGraph::Context::format(GraphImage handle) const {
+    return graph_.images_.at(handle.index).desc.format;
+}
+
+VkBuffer RenderGraph::Context::buffer(GraphBuffer handle) const {
+    return graph_.buffers_.at(handle.index).buffer;
+}
+
+// ============================================================================
+// RenderGraph::PassBuilder implementation
+// ============================================================================
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(GraphImage image, GraphAccess access) {
+    graph_->use(pass_, image.index, true, access, false);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(GraphImage image, GraphAccess access) {
+    graph_->use(pass_, image.index, true, access, true);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(GraphBuffer buffer, GraphAccess access) {
+    graph_->use(pass_, buffer.index, false, access, false);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(GraphBuffer buffer, GraphAccess access) {
+    graph_->use(pass_, buffer.index, false, access, true);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::sideEffect() {
+    graph_->passes_[pass_].sideEffect = true;
+    return *this;
+}
+
+// ============================================================================
+// RenderGraph implementation
+// ============================================================================
+
+RenderGraph::RenderGraph(LogicalDevice* device)
+    : device_(device) {
+    if (!device_) {
+        throw std::runtime_error("RenderGraph requires a device");
+    }
+}
+
+RenderGraph::~RenderGraph() {
+    destroyPhysical(physical_);
+    for (auto& retired : retired_) {
+        destroyPhysical(retired.physical);
+    }
+}
+
+void RenderGraph::reset() {
+    passes_.clear();
+    images_.clear();
+    buffers_.clear();
+    compiled_ = false;
+}
+
+GraphImage RenderGraph::createImage(const char* name, const GraphImageDesc& desc) {
+    if (desc.width == 0 || desc.height == 0 || desc.format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error("RenderGraph image needs an extent and a format");
+    }
+    ImageResource resource{};
+    resource.name = name;
+    resource.desc = desc;
+    images_.push_back(std::move(resource));
+    return {static_cast<uint32_t>(images_.size() - 1)};
+}
+
+GraphImage RenderGraph::importImage(const char* name, Image& image,
+                                    VkImageLayout currentLayout, VkImageLayout finalLayout) {
+    GraphImage handle = importImage(name, image.handle(), image.view()->handle(), image.format(),
+                                    {image.width(), image.height()}, currentLayout, finalLayout);
+    images_[handle.index].desc.samples = image.samples();
+    images_[handle.index].desc.mipLevels = image.mipLevels();
+    images_[handle.index].arrayLayers = image.arrayLayers();
+    return handle;
+}
+
+GraphImage RenderGraph::importImage(const char* name, VkImage image, VkImageView view,
+                                    VkFormat format, VkExtent2D extent,
+                                    VkImageLayout currentLayout, VkImageLayout finalLayout) {
+    ImageResource resource{};
+    resource.name = name;
+    resource.desc.width = extent.width;
+    resource.desc.height = extent.height;
+    resource.desc.format = format;
+    resource.imported = true;
+    resource.image = image;
+    resource.view = view;
+    resource.initialLayout = currentLayout;
+    resource.finalLayout = finalLayout;
+    images_.push_back(std::move(resource));
+    return {static_cast<uint32_t>(images_.size() - 1)};
+}
+
+GraphBuffer RenderGraph::importBuffer(const char* name, Buffer& buffer) {
+    BufferResource resource{};
+    resource.name = name;
+    resource.buffer = buffer.handle();
+    buffers_.push_back(std::move(resource));
+    return {static_cast<uint32_t>(buffers_.size() - 1)};
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const char* name, ExecuteFn execute) {
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    passes_.push_back(std::move(pass));
+    compiled_ = false;
+    return PassBuilder(this, static_cast<uint32_t>(passes_.size() - 1));
+}
+
+void RenderGraph::use(uint32_t pass, uint32_t resource, bool image, GraphAccess access, bool write) {
+    if (image ? resource >= images_.size() : resource >= buffers_.size()) {
+        throw std::runtime_error("RenderGraph: invalid resource handle");
+    }
+    AccessInfo info = accessInfo(access);
+    if (image && info.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        throw std::runtime_error("RenderGraph: buffer-only access used on an image");
+    }
+    if (image && !images_[resource].imported) {
+        images_[resource].usage |= info.usage;
+    }
+
+    // Merge repeated uses of one resource within the pass
+    auto& uses = passes_[pass].uses;
+    for (auto& existing : uses) {
+        if (existing.resource == resource && existing.image == image) {
+            if (image && existing.layout != info.layout) {
+                throw std::runtime_error(std::string("RenderGraph: pass ") + passes_[pass].name +
+                                         " uses an image in two layouts");
+            }
+            existing.read = existing.read || !write;
+            existing.write = existing.write || write;
+            existing.stages |= info.stages;
+            existing.access |= info.access;
+            return;
+        }
+    }
+    uses.push_back({resource, image, !write, write, info.stages, info.access,
+                    image ? info.layout : VK_IMAGE_LAYOUT_UNDEFINED});
+    compiled_ = false;
+}
+
+// ============================================================================
+// Compilation
+// ============================================================================
+
+void RenderGraph::cull() {
+    for (auto& image : images_) {
+        image.writers.clear();
+        image.refCount = image.imported ? 1 : 0;  // Imported resources are outputs
+    }
+    for (auto& buffer : buffers_) {
+        buffer.writers.clear();
+        buffer.refCount = 1;
+    }
+
+    for (uint32_t i = 0; i < passes_.size(); i++) {
+        Pass& pass = passes_[i];
+        pass.culled = false;
+        pass.refCount = 0;
+        for (const auto& use : pass.uses) {
+            uint32_t& refCount = use.image ? images_[use.resource].refCount : buffers_[use.resource].refCount;
+            if (use.write) {
+                pass.refCount++;
+                (use.image ? images_[use.resource].writers : buffers_[use.resource].writers).push_back(i);
+            }
+            if (use.read) {
+                refCount++;
+            }
+        }
+    }
+
+    // Flood back from unread resources: a pass whose outputs all go unread
+    // is culled and stops reading its inputs
+    std::vector<uint32_t> unread;
+    auto cullPass = [this, &unread](Pass& pass) {
+        pass.culled = true;
+        for (const auto& use : pass.uses) {
+            if (use.read && use.image && --images_[use.resource].refCount == 0) {
+                unread.push_back(use.resource);
+            }
+        }
+    };
+
+    for (auto& pass : passes_) {
+        if (pass.refCount == 0 && !pass.sideEffect) {
+            cullPass(pass);
+        }
+    }
+    for (uint32_t i = 0; i < images_.size(); i++) {
+        if (images_[i].refCount == 0) {
+            unread.push_back(i);
+        }
+    }
+    while (!unread.empty()) {
+        uint32_t resource = unread.back();
+        unread.pop_back();
+        for (uint32_t writer : images_[resource].writers) {
+            Pass& pass = passes_[writer];
+            if (!pass.culled && --pass.refCount == 0 && !pass.sideEffect) {
+                cullPass(pass);
+            }
+        }
+    }
+}
+
+void RenderGraph::compile() {
+    // Each compile() starts a frame: release physical images no frame uses anymore
+    for (size_t i = 0; i < retired_.size();) {
+        if (--retired_[i].framesLeft == 0) {
+            destroyPhysical(retired_[i].physical);
+            retired_[i] = std::move(retired_.back());
+            retired_.pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    cull();
+
+    stats_ = {};
+    for (auto& image : images_) {
+        image.firstPass = UINT32_MAX;
+        image.lastPass = 0;
+    }
+    uint32_t ordinal = 0;
+    for (const auto& pass : passes_) {
+        if (pass.culled) {
+            stats_.culledPasses++;
+            continue;
+        }
+        for (const auto& use : pass.uses) {
+            if (use.image) {
+                ImageResource& image = images_[use.resource];
+                image.firstPass = std::min(image.firstPass, ordinal);
+                image.lastPass = ordinal;
+            }
+        }
+        ordinal++;
+    }
+    stats_.passes = ordinal;
+
+    std::vector<uint32_t> transients;
+    std::vector<Plan> plan;
+    for (uint32_t i = 0; i < images_.size(); i++) {
+        const ImageResource& image = images_[i];
+        if (!image.imported && image.firstPass != UINT32_MAX) {
+            transients.push_back(i);
+            plan.push_back({image.desc, image.usage, image.firstPass, image.lastPass});
+        }
+    }
+
+    if (!(plan == physical_.plan)) {
+        if (!physical_.images.empty()) {
+            retired_.push_back({std::move(physical_), device_->maxFramesInFlight()});
+            physical_ = {};
+        }
+        buildPhysical(transients, std::move(plan));
+    }
+
+    for (uint32_t k = 0; k < transients.size(); k++) {
+        ImageResource& image = images_[transients[k]];
+        image.physical = k;
+        image.image = physical_.images[k].image;
+        image.view = physical_.images[k].view;
+    }
+    for (const auto& slot : physical_.slots) {
+        stats_.transientMemory += slot.requirements.size;
+    }
+    stats_.transientRequested = physical_.requested;
+    compiled_ = true;
+}
+
+void RenderGraph::buildPhysical(const std::vector<uint32_t>& transients, std::vector<Plan> plan) {
+    VkDevice device = device_->handle();
+    physical_.plan = std::move(plan);
+    physical_.images.resize(transients.size());
+
+    std::vector<VkMemoryRequirements> requirements(transients.size());
+    for (size_t k = 0; k < transients.size(); k++) {
+        const Plan& entry = physical_.plan[k];
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent = {entry.desc.width, entry.desc.height, 1};
+        imageInfo.mipLevels = entry.desc.mipLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = entry.desc.format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = entry.usage;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.samples = entry.desc.samples;
+
+        if (vkCreateImage(device, &imageInfo, nullptr, &physical_.images[k].image) != VK_SUCCESS) {
+            destroyPhysical(physical_);
+            throw std::runtime_error(std::string("RenderGraph: failed to create image ") +
+                                     images_[transients[k]].name);
+        }
+        vkGetImageMemoryRequirements(device, physical_.images[k].image, &requirements[k]);
+    }
+
+    // Largest first, each into the first slot it fits without overlapping
+    // a lifetime already there
+    std::vector<uint32_t> order(transients.size());
+    for (uint32_t k = 0; k < order.size(); k++) {
+        order[k] = k;
+    }
+    std::stable_sort(order.begin(), order.end(), [&requirements](uint32_t a, uint32_t b) {
+        return requirements[a].size > requirements[b].size;
+    });
+
+    for (uint32_t k : order) {
+        const VkMemoryRequirements& required = requirements[k];
+        std::pair<uint32_t, uint32_t> lifetime{physical_.plan[k].firstPass, physical_.plan[k].lastPass};
+        physical_.requested += required.size;
+
+        uint32_t chosen = UINT32_MAX;
+        for (uint32_t s = 0; s < physical_.slots.size() && chosen == UINT32_MAX; s++) {
+            const Slot& slot = physical_.slots[s];
+            if ((slot.requirements.memoryTypeBits & required.memoryTypeBits) == 0 ||
+                required.size > slot.requirements.size) {
+                continue;
+            }
+            bool free = std::none_of(slot.lifetimes.begin(), slot.lifetimes.end(),
+                [&lifetime](const std::pair<uint32_t, uint32_t>& other) { return overlaps(lifetime, other); });
+            if (free) {
+                chosen = s;
+            }
+        }
+        if (chosen == UINT32_MAX) {
+            chosen = static_cast<uint32_t>(physical_.slots.size());
+            physical_.slots.emplace_back();
+            physical_.slots.back().requirements = required;
+        }
+
+        Slot& slot = physical_.slots[chosen];
+        slot.requirements.memoryTypeBits &= required.memoryTypeBits;
+        slot.requirements.alignment = std::max(slot.requirements.alignment, required.alignment);
+        slot.lifetimes.push_back(lifetime);
+        physical_.images[k].slot = chosen;
+    }
+
+    try {
+        for (auto& slot : physical_.slots) {
+            slot.allocation = device_->allocator().allocate(slot.requirements, MemoryUsage::GpuOnly,
+                                                            ResourceKind::Optimal, MemoryCategory::Attachment);
+        }
+    } catch (...) {
+        destroyPhysical(physical_);
+        throw;
+    }
+
+    for (size_t k = 0; k < transients.size(); k++) {
+        PhysicalImage& image = physical_.images[k];
+        const AllocationInfo& allocation = physical_.slots[image.slot].allocation;
+        if (vkBindImageMemory(device, image.image, allocation.memory, allocation.offset) != VK_SUCCESS) {
+            destroyPhysical(physical_);
+            throw std::runtime_error("RenderGraph: failed to bind image memory");
+        }
+
+        const Plan& entry = physical_.plan[k];
+        VkImageAspectFlags aspects = aspectsOf(entry.desc.format);
+        if ((entry.usage & VK_IMAGE_USAGE_SAMPLED_BIT) && (aspects & VK_IMAGE_ASPECT_DEPTH_BIT)) {
+            aspects = VK_IMAGE_ASPECT_DEPTH_BIT;  // Sampled views take one aspect
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = image.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = entry.desc.format;
+        viewInfo.subresourceRange = {aspects, 0, entry.desc.mipLevels, 0, 1};
+        if (vkCreateImageView(device, &viewInfo, nullptr, &image.view) != VK_SUCCESS) {
+            destroyPhysical(physical_);
+            throw std::runtime_error("RenderGraph: failed to create image view");
+        }
+    }
+}
+
+void RenderGraph::destroyPhysical(Physical& physical) {
+    VkDevice device = device_->handle();
+    for (auto& image : physical.images) {
+        if (image.view != VK_NULL_HANDLE) {
+            vkDestroyImageView(device, image.view, nullptr);
+        }
+        if (image.image != VK_NULL_HANDLE) {
+            vkDestroyImage(device, image.image, nullptr);
+        }
+    }
+    for (auto& slot : physical.slots) {
+        device_->allocator().free(slot.allocation);
+    }
+    physical = {};
+}
+
+bool RenderGraph::isActive(const char* passName) const {
+    for (const auto& pass : passes_) {
+        if (std::strcmp(pass.name, passName) == 0) {
+            return compiled_ && !pass.culled;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+void RenderGraph::syncImage(ImageResource& resource, const Use& use) {
+    State& state = resource.state;
+    VkImageLayout oldLayout = state.layout;
+    VkPipelineStageFlags srcStages = 0;
+    VkAccessFlags srcAccess = 0;
+    bool barrier = false;
+
+    if (!state.touched) {
+        state.touched = true;
+        if (!resource.imported) {
+            // Contents are discarded; wait for the memory's previous occupant
+            // (an aliased image, or this image in the previous frame)
+            Slot& slot = physical_.slots[physical_.images[resource.physical].slot];
+            oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            srcStages = slot.stages;
+            srcAccess = slot.writeAccess;
+            slot.stages = 0;
+            slot.writeAccess = 0;
+            barrier = true;
+        } else if (resource.initialLayout != use.layout) {
+            oldLayout = resource.initialLayout;
+            srcStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            srcAccess = oldLayout == VK_IMAGE_LAYOUT_UNDEFINED ? 0 : VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier = true;
+        } else {
+            oldLayout = resource.initialLayout;
+        }
+    } else if (state.layout != use.layout) {
+        srcStages = state.writeStages | state.readStages;
+        srcAccess = state.writeAccess;
+        barrier = true;
+    } else if (use.write) {
+        // Write after write or after read
+        srcStages = state.writeStages | state.readStages;
+        srcAccess = state.writeAccess;
+        barrier = srcStages != 0;
+    } else if (state.writeStages != 0 &&
+               ((use.stages & ~state.readStages) != 0 || (use.access & ~state.readAccess) != 0)) {
+        // First read of the last write at this stage
+        srcStages = state.writeStages;
+        srcAccess = state.writeAccess;
+        barrier = true;
+    }
+
+    if (barrier) {
+        VkImageMemoryBarrier imageBarrier{};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcAccessMask = srcAccess;
+        imageBarrier.dstAccessMask = use.access;
+        imageBarrier.oldLayout = oldLayout;
+        imageBarrier.newLayout = use.layout;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = resource.image;
+        imageBarrier.subresourceRange = {aspectsOf(resource.desc.format), 0, VK_REMAINING_MIP_LEVELS,
+                                         0, VK_REMAINING_ARRAY_LAYERS};
+        imageBarriers_.push_back(imageBarrier);
+        srcStages_ |= srcStages;
+        dstStages_ |= use.stages;
+    }
+
+    if (use.write) {
+        state.writeStages = use.stages;
+        state.writeAccess = use.access;
+        state.readStages = 0;
+        state.readAccess = 0;
+    } else if (barrier && oldLayout != use.layout) {
+        // Later readers chain onto the transition
+        state.writeStages = use.stages;
+        state.writeAccess = 0;
+        state.readStages = use.stages;
+        state.readAccess = use.access;
+    } else {
+        state.readStages |= use.stages;
+        state.readAccess |= use.access;
+    }
+    state.layout = use.layout;
+
+    if (!resource.imported) {
+        Slot& slot = physical_.slots[physical_.images[resource.physical].slot];
+        slot.stages |= use.stages;
+        if (use.write) {
+            slot.writeAccess |= use.access;
+        }
+    }
+}
+
+void RenderGraph::syncBuffer(BufferResource& resource, const Use& use) {
+    State& state = resource.state;
+    VkPipelineStageFlags srcStages = 0;
+    VkAccessFlags srcAccess = 0;
+
+    if (use.write) {
+        srcStages = state.writeStages | state.readStages;
+        srcAccess = state.writeAccess;
+    } else if (state.writeStages != 0 &&
+               ((use.stages & ~state.readStages) != 0 || (use.access & ~state.readAccess) != 0)) {
+        srcStages = state.writeStages;
+        srcAccess = state.writeAccess;
+    }
+
+    if (srcStages != 0) {
+        VkBufferMemoryBarrier bufferBarrier{};
+        bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.srcAccessMask = srcAccess;
+        bufferBarrier.dstAccessMask = use.access;
+        bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.buffer = resource.buffer;
+        bufferBarrier.offset = 0;
+        bufferBarrier.size = VK_WHOLE_SIZE;
+        bufferBarriers_.push_back(bufferBarrier);
+        srcStages_ |= srcStages;
+        dstStages_ |= use.stages;
+    }
+
+    if (use.write) {
+        state.writeStages = use.stages;
+        state.writeAccess = use.access;
+        state.readStages = 0;
+        state.readAccess = 0;
+    } else {
+        state.readStages |= use.stages;
+        state.readAccess |= use.access;
+    }
+}
+
+void RenderGraph::flushBarriers(CommandBuffer& cmd) {
+    if (imageBarriers_.empty() && bufferBarriers_.empty()) {
+        return;
+    }
+    cmd.pipelineBarrier(srcStages_ ? srcStages_ : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        dstStages_ ? dstStages_ : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        0, {}, bufferBarriers_, imageBarriers_);
+    stats_.barriers++;
+    stats_.imageBarriers += static_cast<uint32_t>(imageBarriers_.size());
+    stats_.bufferBarriers += static_cast<uint32_t>(bufferBarriers_.size());
+    imageBarriers_.clear();
+    bufferBarriers_.clear();
+    srcStages_ = 0;
+    dstStages_ = 0;
+}
+
+void RenderGraph::execute(CommandBuffer& cmd) {
+    if (!compiled_) {
+        throw std::runtime_error("RenderGraph::execute() called before compile()");
+    }
+    stats_.barriers = 0;
+    stats_.imageBarriers = 0;
+    stats_.bufferBarriers = 0;
+    for (auto& image : images_) {
+        image.state = {};
+    }
+    for (auto& buffer : buffers_) {
+        buffer.state = {};
+    }
+
+    Context context(*this, cmd);
+    for (auto& pass : passes_) {
+        if (pass.culled) {
+            continue;
+        }
+        for (const auto& use : pass.uses) {
+            if (use.image) {
+                syncImage(images_[use.resource], use);
+            } else {
+                syncBuffer(buffers_[use.resource], use);
+            }
+        }
+        flushBarriers(cmd);
+        if (pass.execute) {
+            pass.execute(context);
+        }
+    }
+
+    // Hand imported images back in the layout the caller asked for
+    for (auto& image : images_) {
+        State& state = image.state;
+        if (!image.imported || !state.touched ||
+            image.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED || image.finalLayout == state.layout) {
+            continue;
+        }
+        bool present = image.finalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        VkImageMemoryBarrier imageBarrier{};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcAccessMask = state.writeAccess;
+        imageBarrier.dstAccessMask = present ? 0 : VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        imageBarrier.oldLayout = state.layout;
+        imageBarrier.newLayout = image.finalLayout;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = image.image;
+        imageBarrier.subresourceRange = {aspectsOf(image.desc.format), 0, VK_REMAINING_MIP_LEVELS,
+                                         0, VK_REMAINING_ARRAY_LAYERS};
+        imageBarriers_.push_back(imageBarrier);
+        srcStages_ |= state.writeStages | state.readStages;
+        dstStages_ |= present ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        state.layout = image.finalLayout;
+    }
+    flushBarriers(cmd);
+}
+
+} // namespace finevk
@@ -2,16 +2,30 @@
 #include "finevk/rendering/renderpass.hpp"
 #include "finevk/rendering/framebuffer.hpp"
 #include "finevk/device/logical_device.hpp"
+#include "finevk/device/physical_device.hpp"
 #include "finevk/device/image.hpp"
 #include "finevk/device/command.hpp"
 #include "finevk/window/window.hpp"
 #include "finevk/rendering/swapchain.hpp"
 #include "finevk/core/logging.hpp"
+#include "finevk/core/small_vector.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 namespace finevk {
 
+namespace {
+
+bool hasStencilAspect(VkFormat format) {
+    return format == VK_FORMAT_D16_UNORM_S8_UINT ||
+           format == VK_FORMAT_D24_UNORM_S8_UINT ||
+           format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
+} // namespace
+
 // ============================================================================
 // RenderTarget::Builder implementation
 // ============================================================================
@@ -63,17 +77,61 @@ RenderTarget::Builder& RenderTarget::Builder::msaa(VkSampleCountFlagBits samples
     return *this;
 }
 
+RenderTarget::Builder& RenderTarget::Builder::sampledDepth(bool enable) {
+    sampledDepth_ = enable;
+    if (enable && !enableDepth_) {
+        enableDepth();
+    }
+    return *this;
+}
+
+RenderTarget::Builder& RenderTarget::Builder::dynamicRendering(bool enable) {
+    dynamicRendering_ = enable;
+    return *this;
+}
+
+RenderTarget::Builder& RenderTarget::Builder::multiview(uint32_t viewCount) {
+    viewCount_ = viewCount;
+    return *this;
+}
+
 RenderTargetPtr RenderTarget::Builder::build() {
-    if (!window_ && !colorImage_) {
-        throw std::runtime_error("RenderTarget requires either a window or color attachment");
+    if (!window_ && !colorImage_ && !depthImage_) {
+        throw std::runtime_error("RenderTarget requires a window, color attachment or depth attachment");
+    }
+    if (viewCount_ > 1) {
+        if (window_) {
+            throw std::runtime_error("Multiview RenderTarget must be off-screen");
+        }
+        if (!device_->supportsMultiview()) {
+            throw std::runtime_error("Multiview RenderTarget needs LogicalDeviceBuilder::enableMultiview()");
+        }
+        if (viewCount_ > device_->physicalDevice()->capabilities().multiviewProperties.maxMultiviewViewCount) {
+            throw std::runtime_error("Multiview RenderTarget exceeds the device's view count limit");
+        }
+        if ((colorImage_ && colorImage_->arrayLayers() < viewCount_) ||
+            (depthImage_ && depthImage_->arrayLayers() < viewCount_)) {
+            throw std::runtime_error("Multiview RenderTarget attachments need an array layer per view");
+        }
+    }
+
+    if (sampledDepth_ && !depthImage_ && msaaSamples_ != VK_SAMPLE_COUNT_1_BIT) {
+        throw std::runtime_error("RenderTarget sampledDepth() needs a single-sample depth buffer");
     }
 
     auto target = RenderTargetPtr(new RenderTarget());
     target->device_ = device_;
     target->window_ = window_;
     target->colorImage_ = colorImage_;
+    target->externalDepth_ = depthImage_;
     target->msaaSamples_ = msaaSamples_;
+    target->viewMask_ = viewCount_ > 1 ? (viewCount_ >= 32 ? ~0u : (1u << viewCount_) - 1) : 0;
     target->depthFormat_ = enableDepth_ ? depthFormat_ : VK_FORMAT_UNDEFINED;
+    target->sampledDepth_ = sampledDepth_ && !depthImage_;
+    target->dynamicRendering_ = dynamicRendering_ && device_->supportsDynamicRendering();
+    if (dynamicRendering_ && !target->dynamicRendering_) {
+        FINEVK_DEBUG(LogCategory::Render, "Dynamic rendering unavailable, RenderTarget using a render pass");
+    }
 
     // Determine extent and color format
     if (window_) {
@@ -83,9 +141,12 @@ RenderTargetPtr RenderTarget::Builder::build() {
         }
         target->extent_ = swapChain->extent();
         target->colorFormat_ = swapChain->format().format;
-    } else {
+        target->swapChainGeneration_ = swapChain->generation();
+    } else if (colorImage_) {
         target->extent_ = {colorImage_->width(), colorImage_->height()};
         target->colorFormat_ = colorImage_->format();
+    } else {
+        target->extent_ = {depthImage_->width(), depthImage_->height()};  // Depth-only
     }
 
     // Use provided depth image or create one
@@ -93,12 +154,15 @@ RenderTargetPtr RenderTarget::Builder::build() {
         // External depth buffer - we don't own it
         // Note: We still store depthFormat_ but don't create depthImage_
         target->depthFormat_ = depthImage_->format();
+        target->msaaSamples_ = depthImage_->samples();
     }
 
     // Create resources
     target->createDepthResources();
-    target->createRenderPass();
-    target->createFramebuffers();
+    if (!target->dynamicRendering_) {
+        target->createRenderPass();
+        target->createFramebuffers();
+    }
 
     // Set up resize callback for window targets
     if (window_) {
@@ -136,7 +200,9 @@ RenderTarget::RenderTarget(RenderTarget&& other) noexcept
     : device_(other.device_)
     , window_(other.window_)
     , colorImage_(other.colorImage_)
+    , externalDepth_(other.externalDepth_)
     , renderPass_(std::move(other.renderPass_))
+    , resumePass_(std::move(other.resumePass_))
     , framebuffers_(std::move(other.framebuffers_))
     , depthImage_(std::move(other.depthImage_))
     , msaaColorImage_(std::move(other.msaaColorImage_))
@@ -144,6 +210,11 @@ RenderTarget::RenderTarget(RenderTarget&& other) noexcept
     , colorFormat_(other.colorFormat_)
     , depthFormat_(other.depthFormat_)
     , msaaSamples_(other.msaaSamples_)
+    , dynamicRendering_(other.dynamicRendering_)
+    , sampledDepth_(other.sampledDepth_)
+    , viewMask_(other.viewMask_)
+    , renderScale_(other.renderScale_)
+    , swapChainGeneration_(other.swapChainGeneration_)
     , resizeCallbackId_(other.resizeCallbackId_) {
     other.device_ = nullptr;
     other.window_ = nullptr;
@@ -156,7 +227,9 @@ RenderTarget& RenderTarget::operator=(RenderTarget&& other) noexcept {
         device_ = other.device_;
         window_ = other.window_;
         colorImage_ = other.colorImage_;
+        externalDepth_ = other.externalDepth_;
         renderPass_ = std::move(other.renderPass_);
+        resumePass_ = std::move(other.resumePass_);
         framebuffers_ = std::move(other.framebuffers_);
         depthImage_ = std::move(other.depthImage_);
         msaaColorImage_ = std::move(other.msaaColorImage_);
@@ -164,6 +237,11 @@ RenderTarget& RenderTarget::operator=(RenderTarget&& other) noexcept {
         colorFormat_ = other.colorFormat_;
         depthFormat_ = other.depthFormat_;
         msaaSamples_ = other.msaaSamples_;
+        dynamicRendering_ = other.dynamicRendering_;
+        sampledDepth_ = other.sampledDepth_;
+        viewMask_ = other.viewMask_;
+        renderScale_ = other.renderScale_;
+        swapChainGeneration_ = other.swapChainGeneration_;
         resizeCallbackId_ = other.resizeCallbackId_;
         other.device_ = nullptr;
         other.window_ = nullptr;
@@ -180,8 +258,9 @@ void RenderTarget::cleanup() {
     depthImage_.reset();
     msaaColorImage_.reset();
 
-    // Clear render pass
+    // Clear render passes
     renderPass_.reset();
+    resumePass_.reset();
 
     // Note: We don't unregister resize callback here because Window handles cleanup
 }
@@ -210,9 +289,52 @@ Framebuffer* RenderTarget::framebuffer(size_t index) const {
     return nullptr;
 }
 
+uint32_t RenderTarget::viewCount() const {
+    uint32_t count = 0;
+    for (uint32_t mask = viewMask_; mask != 0; mask &= mask - 1) {
+        count++;
+    }
+    return count > 0 ? count : 1;
+}
+
+void RenderTarget::setRenderScale(float scale) {
+    if (!(scale > 0.0f) || scale > 1.0f) {
+        throw std::runtime_error("RenderTarget render scale must be in (0, 1]");
+    }
+    renderScale_ = scale;
+}
+
+VkExtent2D RenderTarget::renderExtent() const {
+    if (renderScale_ >= 1.0f) {
+        return extent_;
+    }
+    auto scaled = [this](uint32_t size) {
+        uint32_t value = static_cast<uint32_t>(std::ceil(static_cast<float>(size) * renderScale_));
+        return std::max(1u, std::min(value, size));
+    };
+    return {scaled(extent_.width), scaled(extent_.height)};
+}
+
+VkFormat RenderTarget::stencilFormat() const {
+    return hasStencilAspect(depthFormat_) ? depthFormat_ : VK_FORMAT_UNDEFINED;
+}
+
 void RenderTarget::begin(CommandBuffer& cmd, const ClearColor& clearColor, float clearDepth) {
-    std::vector<VkClearValue> clearValues;
-    clearValues.push_back(clearColor.toVkClearValue());
+    // Resizes and present mode switches replace the swap chain images
+    if (window_ && window_->swapChain() &&
+        window_->swapChain()->generation() != swapChainGeneration_) {
+        recreate();
+    }
+
+    if (dynamicRendering_) {
+        beginDynamic(cmd, clearColor, clearDepth, false);
+        return;
+    }
+
+    SmallVector<VkClearValue, 2> clearValues;
+    if (hasColor()) {
+        clearValues.push_back(clearColor.toVkClearValue());
+    }
 
     if (hasDepth()) {
         VkClearValue depthClear{};
@@ -227,7 +349,7 @@ void RenderTarget::begin(CommandBuffer& cmd, const ClearColor& clearColor, float
 
     VkRect2D renderArea{};
     renderArea.offset = {0, 0};
-    renderArea.extent = extent_;
+    renderArea.extent = renderExtent();
 
     cmd.beginRenderPass(
         renderPass_->handle(),
@@ -236,11 +358,165 @@ void RenderTarget::begin(CommandBuffer& cmd, const ClearColor& clearColor, float
         clearValues);
 
     // Set viewport and scissor for dynamic state
-    cmd.setViewportAndScissor(extent_.width, extent_.height);
+    cmd.setViewportAndScissor(renderArea.extent.width, renderArea.extent.height);
+}
+
+void RenderTarget::resume(CommandBuffer& cmd) {
+    if (hasDepth() && !storesDepth()) {
+        throw std::runtime_error("RenderTarget::resume() needs a stored depth buffer (sampledDepth() or depthAttachment())");
+    }
+
+    if (dynamicRendering_) {
+        beginDynamic(cmd, ClearColor{}, 1.0f, true);
+        return;
+    }
+
+    Framebuffer* fb = currentFramebuffer();
+    if (!fb) {
+        throw std::runtime_error("No framebuffer available for render target");
+    }
+
+    VkRect2D renderArea{};
+    renderArea.offset = {0, 0};
+    renderArea.extent = renderExtent();
+
+    // Compatible with renderPass_ (only load ops and layouts differ)
+    cmd.beginRenderPass(resumePass_->handle(), fb->handle(), renderArea, {});
+    cmd.setViewportAndScissor(renderArea.extent.width, renderArea.extent.height);
+}
+
+void RenderTarget::beginDynamic(CommandBuffer& cmd, const ClearColor& clearColor, float clearDepth,
+                                bool load) {
+    VkImage colorImage = VK_NULL_HANDLE;
+    VkImageView colorView = VK_NULL_HANDLE;
+    if (window_) {
+        auto* swapChain = window_->swapChain();
+        uint32_t imageIndex = window_->currentImageIndex();
+        if (!swapChain || imageIndex >= swapChain->images().size()) {
+            throw std::runtime_error("No swap chain image available for render target");
+        }
+        colorImage = swapChain->images()[imageIndex];
+        colorView = swapChain->imageViews()[imageIndex]->handle();
+    } else if (colorImage_) {
+        colorImage = colorImage_->handle();
+        colorView = colorImage_->view()->handle();
+    }
+    Image* depth = depthTarget();
+
+    // The layout transitions and external dependency a render pass would do.
+    // Cleared contents discard the old layout; loaded ones come from the
+    // layouts end() left. The source scope covers earlier sampling of a
+    // stored depth image.
+    SmallVector<VkImageMemoryBarrier, 2> barriers;
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, VK_REMAINING_ARRAY_LAYERS};
+    if (colorImage != VK_NULL_HANDLE) {
+        barrier.srcAccessMask = load ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : 0;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                (load ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT : 0);
+        barrier.oldLayout = !load ? VK_IMAGE_LAYOUT_UNDEFINED :
+                            window_ ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR :
+                            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.image = colorImage;
+        barriers.push_back(barrier);
+    }
+    if (depth) {
+        barrier.oldLayout = load ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        barrier.image = depth->handle();
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (hasStencilAspect(depthFormat_)) {
+            barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        barriers.push_back(barrier);
+    }
+
+    VkPipelineStageFlags attachmentStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    cmd.pipelineBarrier(attachmentStages | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, attachmentStages,
+                        0, {}, {}, barriers);
+
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = colorView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue = clearColor.toVkClearValue();
+
+    VkRenderingAttachmentInfoKHR depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    if (depth) {
+        depthAttachment.imageView = depth->view()->handle();
+        depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depthAttachment.loadOp = load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.storeOp = storesDepth() ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.clearValue.depthStencil = {clearDepth, 0};
+    }
+
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea = {{0, 0}, renderExtent()};
+    renderingInfo.layerCount = 1;
+    renderingInfo.viewMask = viewMask_;
+    renderingInfo.colorAttachmentCount = colorView != VK_NULL_HANDLE ? 1 : 0;
+    renderingInfo.pColorAttachments = colorView != VK_NULL_HANDLE ? &colorAttachment : nullptr;
+    renderingInfo.pDepthAttachment = depth ? &depthAttachment : nullptr;
+    renderingInfo.pStencilAttachment = depth && hasStencilAspect(depthFormat_) ? &depthAttachment : nullptr;
+
+    cmd.beginRendering(renderingInfo);
+    cmd.setViewportAndScissor(renderingInfo.renderArea.extent.width, renderingInfo.renderArea.extent.height);
 }
 
 void RenderTarget::end(CommandBuffer& cmd) {
-    cmd.endRenderPass();
+    if (!dynamicRendering_) {
+        cmd.endRenderPass();
+        return;
+    }
+    cmd.endRendering();
+
+    // Final layouts of the render pass path; off-screen color stays in
+    // COLOR_ATTACHMENT_OPTIMAL
+    SmallVector<VkImageMemoryBarrier, 2> barriers;
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    if (window_) {
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        barrier.image = window_->swapChain()->images()[window_->currentImageIndex()];
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        barriers.push_back(barrier);
+    }
+    if (storesDepth()) {
+        barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        barrier.image = depthTarget()->handle();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, VK_REMAINING_ARRAY_LAYERS};
+        if (hasStencilAspect(depthFormat_)) {
+            barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        barriers.push_back(barrier);
+    }
+    if (!barriers.empty()) {
+        cmd.pipelineBarrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            0, {}, {}, barriers);
+    }
 }
 
 void RenderTarget::recreate() {
@@ -249,51 +525,111 @@ void RenderTarget::recreate() {
         auto* swapChain = window_->swapChain();
         if (swapChain) {
             extent_ = swapChain->extent();
+            swapChainGeneration_ = swapChain->generation();
         }
     } else if (colorImage_) {
         extent_ = {colorImage_->width(), colorImage_->height()};
+    } else if (externalDepth_) {
+        extent_ = {externalDepth_->width(), externalDepth_->height()};
     }
 
-    // Recreate depth resources if we own them
-    if (depthImage_) {
+    // Window frames in flight may still use the old depth image and
+    // framebuffers, so hand them to the window rather than destroy them
+    if (window_) {
+        struct Retired {
+            ImagePtr depthImage;
+            std::vector<FramebufferPtr> framebuffers;  // Destroyed first
+        };
+        auto retired = std::make_shared<Retired>();
+        retired->depthImage = std::move(depthImage_);
+        retired->framebuffers = std::move(framebuffers_);
+        bool ownsDepth = retired->depthImage != nullptr;
+        window_->retire([retired]() mutable { retired.reset(); });
+        framebuffers_.clear();
+        if (ownsDepth) {
+            createDepthResources();
+        }
+    } else if (depthImage_) {
         depthImage_.reset();
         createDepthResources();
     }
 
-    // Recreate framebuffers
-    framebuffers_.clear();
-    createFramebuffers();
+    // Recreate framebuffers (dynamic rendering has none; views are picked per begin())
+    if (!dynamicRendering_) {
+        framebuffers_.clear();
+        createFramebuffers();
+    }
 
     FINEVK_DEBUG(LogCategory::Render, "RenderTarget recreated");
 }
 
 void RenderTarget::createRenderPass() {
+    renderPass_ = buildRenderPass(false);
+    if (storesDepth() || !hasDepth()) {
+        resumePass_ = buildRenderPass(true);
+    }
+}
+
+RenderPassPtr RenderTarget::buildRenderPass(bool load) const {
     auto builder = RenderPass::create(device_);
+    uint32_t attachment = 0;
 
     // Color attachment
-    VkImageLayout finalLayout = window_ ?
-        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR :
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    if (hasColor()) {
+        VkImageLayout finalLayout = window_ ?
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR :
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-    builder.addColorAttachment(
-        colorFormat_,
-        msaaSamples_,
-        VK_ATTACHMENT_LOAD_OP_CLEAR,
-        VK_ATTACHMENT_STORE_OP_STORE,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        finalLayout);
+        builder.addColorAttachment(
+            colorFormat_,
+            msaaSamples_,
+            load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
+            VK_ATTACHMENT_STORE_OP_STORE,
+            load ? finalLayout : VK_IMAGE_LAYOUT_UNDEFINED,
+            finalLayout);
 
-    builder.subpassColorAttachment(0);
+        builder.subpassColorAttachment(attachment++);
+    }
 
-    // Depth attachment
+    // Depth attachment (an attached or sampledDepth() image is kept for
+    // sampling, e.g. shadow maps or a Hi-Z pyramid)
     if (hasDepth()) {
-        builder.addDepthAttachment(
-            depthFormat_,
-            msaaSamples_,
-            VK_ATTACHMENT_LOAD_OP_CLEAR,
-            VK_ATTACHMENT_STORE_OP_DONT_CARE);
+        if (storesDepth()) {
+            builder.addDepthAttachment(
+                depthFormat_,
+                msaaSamples_,
+                load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
+                VK_ATTACHMENT_STORE_OP_STORE,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                load ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED);
+
+            VkSubpassDependency toSampling{};
+            toSampling.srcSubpass = 0;
+            toSampling.dstSubpass = VK_SUBPASS_EXTERNAL;
+            toSampling.srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            toSampling.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            toSampling.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            toSampling.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            builder.addDependency(toSampling);
+
+            VkSubpassDependency afterSampling{};
+            afterSampling.srcSubpass = VK_SUBPASS_EXTERNAL;
+            afterSampling.dstSubpass = 0;
+            afterSampling.srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            afterSampling.srcAccessMask = 0;
+            afterSampling.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+            afterSampling.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            builder.addDependency(afterSampling);
+        } else {
+            builder.addDepthAttachment(
+                depthFormat_,
+                msaaSamples_,
+                VK_ATTACHMENT_LOAD_OP_CLEAR,
+                VK_ATTACHMENT_STORE_OP_DONT_CARE);
+        }
 
-        builder.subpassDepthAttachment(1);
+        builder.subpassDepthAttachment(attachment);
     }
 
     // Add presentation dependency for window targets
@@ -301,11 +637,27 @@ void RenderTarget::createRenderPass() {
         builder.addPresentationDependency();
     }
 
-    renderPass_ = builder.build();
+    if (viewMask_ != 0) {
+        builder.multiview(viewMask_);
+    }
+
+    return builder.build();
 }
 
 void RenderTarget::createDepthResources() {
-    if (!hasDepth() || depthFormat_ == VK_FORMAT_UNDEFINED) {
+    if (!hasDepth() || externalDepth_) {
+        return;
+    }
+
+    if (sampledDepth_) {
+        // Stored and sampled after the pass, so it needs real memory
+        depthImage_ = Image::create(device_)
+            .extent(extent_.width, extent_.height)
+            .format(depthFormat_)
+            .usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+            .arrayLayers(viewCount())
+            .memoryUsage(MemoryUsage::GpuOnly)
+            .build();
         return;
     }
 
@@ -314,6 +666,8 @@ void RenderTarget::createDepthResources() {
         .format(depthFormat_)
         .usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
         .samples(msaaSamples_)
+        .arrayLayers(viewCount())
+        .memoryUsage(MemoryUsage::Transient)  // Only read inside the pass (store op DONT_CARE)
         .build();
 }
 
@@ -328,20 +682,22 @@ void RenderTarget::createFramebuffers() {
                 .attachment(imageViews[i]->handle())
                 .extent(extent_.width, extent_.height);
 
-            if (depthImage_) {
-                builder.attachment(depthImage_->view());
+            if (Image* depth = depthTarget()) {
+                builder.attachment(depth->view());
             }
 
             framebuffers_.push_back(builder.build());
         }
     } else {
-        // Off-screen: single framebuffer
+        // Off-screen: single framebuffer (multiview keeps 1 layer; the views cover the array)
         auto builder = Framebuffer::create(device_, renderPass_.get())
-            .attachment(colorImage_->view())
             .extent(extent_.width, extent_.height);
 
-        if (depthImage_) {
-            builder.attachment(depthImage_->view());
+        if (colorImage_) {
+            builder.attachment(colorImage_->view());
+        }
+        if (Image* depth = depthTarget()) {
+            builder.attachment(depth->view());
         }
 
         framebuffers_.push_back(builder.build());
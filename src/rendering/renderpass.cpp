@@ -3,9 +3,24 @@
 #include "finevk/core/logging.hpp"
 
 #include <stdexcept>
+#include <vector>
 
 namespace finevk {
 
+namespace {
+
+uint64_t hashWords(const std::vector<uint64_t>& words) {
+    uint64_t hash = 14695981039346656037ull;
+    for (uint64_t word : words) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            hash = (hash ^ ((word >> shift) & 0xFF)) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // RenderPass::Builder implementation
 // ============================================================================
@@ -41,7 +56,9 @@ RenderPass::Builder& RenderPass::Builder::addDepthAttachment(
     VkFormat format,
     VkSampleCountFlagBits samples,
     VkAttachmentLoadOp loadOp,
-    VkAttachmentStoreOp storeOp) {
+    VkAttachmentStoreOp storeOp,
+    VkImageLayout finalLayout,
+    VkImageLayout initialLayout) {
 
     VkAttachmentDescription attachment{};
     attachment.format = format;
@@ -50,8 +67,8 @@ RenderPass::Builder& RenderPass::Builder::addDepthAttachment(
     attachment.storeOp = storeOp;
     attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    attachment.initialLayout = initialLayout;
+    attachment.finalLayout = finalLayout;
 
     attachments_.push_back(attachment);
     return *this;
@@ -125,6 +142,12 @@ RenderPass::Builder& RenderPass::Builder::addPresentationDependency() {
     return *this;
 }
 
+RenderPass::Builder& RenderPass::Builder::multiview(uint32_t viewMask, uint32_t correlationMask) {
+    viewMask_ = viewMask;
+    correlationMask_ = correlationMask;
+    return *this;
+}
+
 RenderPassPtr RenderPass::Builder::build() {
     if (attachments_.empty()) {
         throw std::runtime_error("Render pass must have at least one attachment");
@@ -148,15 +171,57 @@ RenderPassPtr RenderPass::Builder::build() {
     renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies_.size());
     renderPassInfo.pDependencies = dependencies_.empty() ? nullptr : dependencies_.data();
 
+    // One view mask for the single subpass
+    VkRenderPassMultiviewCreateInfo multiviewInfo{};
+    multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+    if (viewMask_ != 0) {
+        if (!device_->supportsMultiview()) {
+            throw std::runtime_error("Multiview render pass needs LogicalDeviceBuilder::enableMultiview()");
+        }
+        multiviewInfo.subpassCount = 1;
+        multiviewInfo.pViewMasks = &viewMask_;
+        multiviewInfo.correlationMaskCount = correlationMask_ != 0 ? 1 : 0;
+        multiviewInfo.pCorrelationMasks = correlationMask_ != 0 ? &correlationMask_ : nullptr;
+        renderPassInfo.pNext = &multiviewInfo;
+    }
+
     VkRenderPass vkRenderPass;
     VkResult result = vkCreateRenderPass(device_->handle(), &renderPassInfo, nullptr, &vkRenderPass);
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to create render pass");
     }
 
+    // Load/store ops and layouts don't affect pipeline compatibility
+    std::vector<uint64_t> compatibility;
+    for (const auto& attachment : attachments_) {
+        compatibility.push_back(attachment.format);
+        compatibility.push_back(attachment.samples);
+    }
+    compatibility.push_back(colorRefs_.size());
+    for (const auto& ref : colorRefs_) {
+        compatibility.push_back(ref.attachment);
+    }
+    compatibility.push_back(resolveRefs_.size());
+    for (const auto& ref : resolveRefs_) {
+        compatibility.push_back(ref.attachment);
+    }
+    compatibility.push_back(hasDepth_ ? depthRef_.attachment : VK_ATTACHMENT_UNUSED);
+    compatibility.push_back(dependencies_.size());
+    for (const auto& dependency : dependencies_) {
+        compatibility.insert(compatibility.end(), {
+            dependency.srcSubpass, dependency.dstSubpass,
+            dependency.srcStageMask, dependency.dstStageMask,
+            dependency.srcAccessMask, dependency.dstAccessMask,
+            dependency.dependencyFlags,
+        });
+    }
+    compatibility.push_back(viewMask_);
+    compatibility.push_back(correlationMask_);
+
     auto renderPass = RenderPassPtr(new RenderPass());
     renderPass->device_ = device_;
     renderPass->renderPass_ = vkRenderPass;
+    renderPass->compatibilityHash_ = hashWords(compatibility);
 
     FINEVK_DEBUG(LogCategory::Core, "Render pass created");
 
@@ -224,7 +289,8 @@ RenderPass::~RenderPass() {
 
 RenderPass::RenderPass(RenderPass&& other) noexcept
     : device_(other.device_)
-    , renderPass_(other.renderPass_) {
+    , renderPass_(other.renderPass_)
+    , compatibilityHash_(other.compatibilityHash_) {
     other.renderPass_ = VK_NULL_HANDLE;
 }
 
@@ -233,6 +299,7 @@ RenderPass& RenderPass::operator=(RenderPass&& other) noexcept {
         cleanup();
         device_ = other.device_;
         renderPass_ = other.renderPass_;
+        compatibilityHash_ = other.compatibilityHash_;
         other.renderPass_ = VK_NULL_HANDLE;
     }
     return *this;
@@ -10,6 +10,60 @@
 
 namespace finevk {
 
+namespace {
+
+bool hasPresentMode(const std::vector<VkPresentModeKHR>& available, VkPresentModeKHR mode) {
+    return std::find(available.begin(), available.end(), mode) != available.end();
+}
+
+// Preferred mode, else the closest available: the other uncapped mode for
+// MAILBOX/IMMEDIATE, plain FIFO (always supported) for FIFO_RELAXED
+VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR>& available,
+                                   VkPresentModeKHR preferred) {
+    if (hasPresentMode(available, preferred)) {
+        return preferred;
+    }
+    if (preferred == VK_PRESENT_MODE_MAILBOX_KHR && hasPresentMode(available, VK_PRESENT_MODE_IMMEDIATE_KHR)) {
+        return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    }
+    if (preferred == VK_PRESENT_MODE_IMMEDIATE_KHR && hasPresentMode(available, VK_PRESENT_MODE_MAILBOX_KHR)) {
+        return VK_PRESENT_MODE_MAILBOX_KHR;
+    }
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+uint32_t chooseImageCount(const VkSurfaceCapabilitiesKHR& capabilities, uint32_t requested,
+                          VkPresentModeKHR mode) {
+    uint32_t count = requested != 0 ? requested : SwapChain::recommendedImageCount(mode);
+    count = std::max(count, capabilities.minImageCount);
+    if (capabilities.maxImageCount > 0) {
+        count = std::min(count, capabilities.maxImageCount);
+    }
+    return count;
+}
+
+// Color attachment, plus transfer destination where the surface allows it
+// (blits into the image, e.g. DynamicResolution::upscale())
+VkImageUsageFlags chooseImageUsage(const VkSurfaceCapabilitiesKHR& capabilities) {
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+        usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+    return usage;
+}
+
+const char* presentModeName(VkPresentModeKHR mode) {
+    switch (mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return "immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR: return "mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR: return "fifo";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "fifo relaxed";
+        default: return "other";
+    }
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // SwapChain::Builder implementation
 // ============================================================================
@@ -66,14 +120,7 @@ SwapChainPtr SwapChain::Builder::build() {
         }
     }
 
-    // Choose present mode
-    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR; // Always available
-    for (const auto& mode : support.presentModes) {
-        if (mode == preferredPresentMode_) {
-            presentMode = mode;
-            break;
-        }
-    }
+    VkPresentModeKHR presentMode = choosePresentMode(support.presentModes, preferredPresentMode_);
 
     // Choose swap extent
     VkExtent2D extent;
@@ -89,11 +136,7 @@ SwapChainPtr SwapChain::Builder::build() {
             support.capabilities.maxImageExtent.height);
     }
 
-    // Choose image count
-    uint32_t imageCount = std::max(imageCount_, support.capabilities.minImageCount);
-    if (support.capabilities.maxImageCount > 0) {
-        imageCount = std::min(imageCount, support.capabilities.maxImageCount);
-    }
+    uint32_t imageCount = chooseImageCount(support.capabilities, imageCount_, presentMode);
 
     // Create swap chain
     VkSwapchainCreateInfoKHR createInfo{};
@@ -104,7 +147,7 @@ SwapChainPtr SwapChain::Builder::build() {
     createInfo.imageColorSpace = surfaceFormat.colorSpace;
     createInfo.imageExtent = extent;
     createInfo.imageArrayLayers = 1;
-    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    createInfo.imageUsage = chooseImageUsage(support.capabilities);
 
     // Handle queue family indices
     Queue* graphicsQueue = device_->graphicsQueue();
@@ -144,6 +187,8 @@ SwapChainPtr SwapChain::Builder::build() {
     swapChain->format_ = surfaceFormat;
     swapChain->extent_ = extent;
     swapChain->presentMode_ = presentMode;
+    swapChain->imageUsage_ = createInfo.imageUsage;
+    swapChain->requestedImageCount_ = imageCount_;
 
     // Get swap chain images
     uint32_t actualImageCount;
@@ -156,7 +201,7 @@ SwapChainPtr SwapChain::Builder::build() {
 
     FINEVK_INFO(LogCategory::Core, "Swap chain created: " +
         std::to_string(extent.width) + "x" + std::to_string(extent.height) +
-        ", " + std::to_string(actualImageCount) + " images");
+        ", " + std::to_string(actualImageCount) + " images, " + presentModeName(presentMode));
 
     return swapChain;
 }
@@ -180,6 +225,10 @@ SwapChain::SwapChain(SwapChain&& other) noexcept
     , format_(other.format_)
     , extent_(other.extent_)
     , presentMode_(other.presentMode_)
+    , imageUsage_(other.imageUsage_)
+    , requestedImageCount_(other.requestedImageCount_)
+    , generation_(other.generation_)
+    , lastPresentId_(other.lastPresentId_)
     , images_(std::move(other.images_))
     , imageViews_(std::move(other.imageViews_))
     , needsRecreation_(other.needsRecreation_) {
@@ -195,6 +244,10 @@ SwapChain& SwapChain::operator=(SwapChain&& other) noexcept {
         format_ = other.format_;
         extent_ = other.extent_;
         presentMode_ = other.presentMode_;
+        imageUsage_ = other.imageUsage_;
+        requestedImageCount_ = other.requestedImageCount_;
+        generation_ = other.generation_;
+        lastPresentId_ = other.lastPresentId_;
         images_ = std::move(other.images_);
         imageViews_ = std::move(other.imageViews_);
         needsRecreation_ = other.needsRecreation_;
@@ -279,7 +332,19 @@ VkResult SwapChain::present(Queue* queue, uint32_t imageIndex, VkSemaphore waitS
     presentInfo.pSwapchains = swapChains;
     presentInfo.pImageIndices = &imageIndex;
 
+    VkPresentIdKHR presentId{};
+    uint64_t id = lastPresentId_ + 1;
+    if (device_->supportsPresentWait()) {
+        presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentId.swapchainCount = 1;
+        presentId.pPresentIds = &id;
+        presentInfo.pNext = &presentId;
+    }
+
     VkResult result = vkQueuePresentKHR(queue->handle(), &presentInfo);
+    if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+        lastPresentId_ = id;
+    }
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
         needsRecreation_ = true;
@@ -288,10 +353,79 @@ VkResult SwapChain::present(Queue* queue, uint32_t imageIndex, VkSemaphore waitS
     return result;
 }
 
+bool SwapChain::waitForPresent(uint64_t presentId, uint64_t timeout) {
+    if (presentId == 0 || !device_->supportsPresentWait()) {
+        return false;
+    }
+    VkResult result = device_->waitForPresent()(device_->handle(), swapChain_, presentId, timeout);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        needsRecreation_ = true;
+        return false;
+    }
+    return result == VK_SUCCESS;
+}
+
+uint32_t SwapChain::recommendedImageCount(VkPresentModeKHR mode) {
+    // MAILBOX needs a spare image to replace queued frames; the others
+    // queue at most one frame, so a third image only adds latency
+    return mode == VK_PRESENT_MODE_MAILBOX_KHR ? 3 : 2;
+}
+
+bool SwapChain::supportsPresentMode(VkPresentModeKHR mode) const {
+    SwapChainSupport support = device_->physicalDevice()->querySwapChainSupport(surface_->handle());
+    return hasPresentMode(support.presentModes, mode);
+}
+
+VkPresentModeKHR SwapChain::setPresentMode(VkPresentModeKHR mode, uint32_t imageCount) {
+    SwapChainSupport support = device_->physicalDevice()->querySwapChainSupport(surface_->handle());
+    VkPresentModeKHR chosen = choosePresentMode(support.presentModes, mode);
+    if (chosen != mode) {
+        FINEVK_WARN(LogCategory::Core, std::string("Present mode ") + presentModeName(mode) +
+                    " not supported, using " + presentModeName(chosen));
+    }
+    if (chosen == presentMode_ && imageCount == requestedImageCount_) {
+        return chosen;
+    }
+
+    presentMode_ = chosen;
+    requestedImageCount_ = imageCount;
+    recreate(extent_.width, extent_.height);
+    return chosen;
+}
+
 void SwapChain::recreate(uint32_t width, uint32_t height) {
     device_->waitIdle();
 
-    // Store old swap chain for chaining
+    VkSwapchainKHR oldSwapChain = swapChain_;
+    std::vector<ImageViewPtr> oldViews = createReplacement(width, height);
+
+    oldViews.clear();
+    vkDestroySwapchainKHR(device_->handle(), oldSwapChain, nullptr);
+}
+
+std::function<void()> SwapChain::recreateDeferred(uint32_t width, uint32_t height) {
+    // Owns the old chain so it is destroyed even if the callable is dropped unrun
+    struct Retired {
+        VkDevice device;
+        VkSwapchainKHR swapChain;
+        std::vector<ImageViewPtr> views;
+        ~Retired() {
+            views.clear();
+            vkDestroySwapchainKHR(device, swapChain, nullptr);
+        }
+    };
+
+    VkSwapchainKHR oldSwapChain = swapChain_;
+    std::vector<ImageViewPtr> oldViews = createReplacement(width, height);
+
+    auto retired = std::make_shared<Retired>();
+    retired->device = device_->handle();
+    retired->swapChain = oldSwapChain;
+    retired->views = std::move(oldViews);
+    return [retired]() mutable { retired.reset(); };
+}
+
+std::vector<ImageViewPtr> SwapChain::createReplacement(uint32_t width, uint32_t height) {
     VkSwapchainKHR oldSwapChain = swapChain_;
 
     // Query updated support
@@ -315,12 +449,12 @@ void SwapChain::recreate(uint32_t width, uint32_t height) {
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
     createInfo.surface = surface_->handle();
-    createInfo.minImageCount = static_cast<uint32_t>(images_.size());
+    createInfo.minImageCount = chooseImageCount(support.capabilities, requestedImageCount_, presentMode_);
     createInfo.imageFormat = format_.format;
     createInfo.imageColorSpace = format_.colorSpace;
     createInfo.imageExtent = newExtent;
     createInfo.imageArrayLayers = 1;
-    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    createInfo.imageUsage = chooseImageUsage(support.capabilities);
     createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
     createInfo.preTransform = support.capabilities.currentTransform;
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
@@ -348,15 +482,17 @@ void SwapChain::recreate(uint32_t width, uint32_t height) {
         throw std::runtime_error("Failed to recreate swap chain");
     }
 
-    // Clean up old resources
-    imageViews_.clear();
+    // The old images stay valid until the old swap chain is destroyed
+    std::vector<ImageViewPtr> oldViews = std::move(imageViews_);
     images_.clear();
-    vkDestroySwapchainKHR(device_->handle(), oldSwapChain, nullptr);
 
     // Update state
     swapChain_ = newSwapChain;
     extent_ = newExtent;
+    imageUsage_ = createInfo.imageUsage;
     needsRecreation_ = false;
+    lastPresentId_ = 0;  // Present ids are per VkSwapchainKHR
+    generation_++;
 
     // Get new images
     uint32_t imageCount;
@@ -369,6 +505,7 @@ void SwapChain::recreate(uint32_t width, uint32_t height) {
 
     FINEVK_INFO(LogCategory::Core, "Swap chain recreated: " +
         std::to_string(newExtent.width) + "x" + std::to_string(newExtent.height));
+    return oldViews;
 }
 
 } // namespace finevk
@@ -6,12 +6,23 @@
 #include "finevk/rendering/swapchain.hpp"
 #include "finevk/rendering/sync.hpp"
 #include "finevk/core/logging.hpp"
+#include "finevk/core/profiler.hpp"
 
 #include <GLFW/glfw3.h>
 #include <stdexcept>
 
 namespace finevk {
 
+namespace {
+
+/// Exponential moving average over roughly the last ten samples
+void smoothLatency(float& average, std::chrono::steady_clock::duration sample, uint64_t count) {
+    float seconds = std::chrono::duration<float>(sample).count();
+    average = count <= 1 ? seconds : average + (seconds - average) * 0.1f;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // Builder implementation
 // ============================================================================
@@ -46,11 +57,26 @@ Window::Builder& Window::Builder::vsync(bool enabled) {
     return *this;
 }
 
+Window::Builder& Window::Builder::presentMode(VkPresentModeKHR mode) {
+    config_.presentMode = mode;
+    return *this;
+}
+
+Window::Builder& Window::Builder::swapChainImages(uint32_t count) {
+    config_.swapChainImages = count;
+    return *this;
+}
+
 Window::Builder& Window::Builder::framesInFlight(uint32_t count) {
     config_.framesInFlight = count;
     return *this;
 }
 
+Window::Builder& Window::Builder::resizeDebounce(std::chrono::milliseconds delay) {
+    config_.resizeDebounce = delay;
+    return *this;
+}
+
 WindowPtr Window::Builder::build() {
     auto window = WindowPtr(new Window());
     window->instance_ = instance_;
@@ -126,6 +152,13 @@ Window::Window(Window&& other) noexcept
     , currentFrameIndex_(other.currentFrameIndex_)
     , currentImageIndex_(other.currentImageIndex_)
     , framebufferResized_(other.framebufferResized_)
+    , resizeTime_(other.resizeTime_)
+    , retired_(std::move(other.retired_))
+    , retireHandler_(std::move(other.retireHandler_))
+    , lastPollTime_(other.lastPollTime_)
+    , presentPollTimes_(other.presentPollTimes_)
+    , displayedPresentId_(other.displayedPresentId_)
+    , latency_(other.latency_)
     , resizeCallback_(std::move(other.resizeCallback_))
     , keyCallback_(std::move(other.keyCallback_))
     , mouseButtonCallback_(std::move(other.mouseButtonCallback_))
@@ -155,6 +188,13 @@ Window& Window::operator=(Window&& other) noexcept {
         currentFrameIndex_ = other.currentFrameIndex_;
         currentImageIndex_ = other.currentImageIndex_;
         framebufferResized_ = other.framebufferResized_;
+        resizeTime_ = other.resizeTime_;
+        retired_ = std::move(other.retired_);
+        retireHandler_ = std::move(other.retireHandler_);
+        lastPollTime_ = other.lastPollTime_;
+        presentPollTimes_ = other.presentPollTimes_;
+        displayedPresentId_ = other.displayedPresentId_;
+        latency_ = other.latency_;
         resizeCallback_ = std::move(other.resizeCallback_);
         keyCallback_ = std::move(other.keyCallback_);
         mouseButtonCallback_ = std::move(other.mouseButtonCallback_);
@@ -184,6 +224,7 @@ void Window::releaseDeviceResources() {
 
     // Wait for device before cleanup
     device_->waitIdle();
+    releaseRetired(true);
 
     // Cleanup sync objects first (they depend on device)
     inFlightFences_.clear();
@@ -207,6 +248,7 @@ void Window::cleanup() {
     } else {
         // Device already gone (destroyed before window) - just clear our handles
         // The sync objects and swap chain are already invalid, just clear the pointers
+        retired_.clear();
         inFlightFences_.clear();
         renderFinishedSemaphores_.clear();
         imageAvailableSemaphores_.clear();
@@ -231,18 +273,22 @@ void Window::createSurface() {
 }
 
 void Window::createSwapChain() {
-    swapChain_ = SwapChain::create(device_, *surface_)
-        .vsync(config_.vsync)
-        .imageCount(config_.framesInFlight + 1)
-        .build();
+    auto builder = SwapChain::create(device_, *surface_);
+    builder.vsync(config_.vsync).imageCount(config_.swapChainImages);
+    if (config_.presentMode != VK_PRESENT_MODE_MAX_ENUM_KHR) {
+        builder.preferredPresentMode(config_.presentMode);
+    }
+    swapChain_ = builder.build();
 }
 
 void Window::createSyncObjects() {
-    imageAvailableSemaphores_.resize(config_.framesInFlight);
-    renderFinishedSemaphores_.resize(config_.framesInFlight);
-    inFlightFences_.resize(config_.framesInFlight);
+    // Every slot up to the maximum, so frames in flight can change without reallocating
+    uint32_t slots = device_->maxFramesInFlight();
+    imageAvailableSemaphores_.resize(slots);
+    renderFinishedSemaphores_.resize(slots);
+    inFlightFences_.resize(slots);
 
-    for (uint32_t i = 0; i < config_.framesInFlight; i++) {
+    for (uint32_t i = 0; i < slots; i++) {
         imageAvailableSemaphores_[i] = std::make_unique<Semaphore>(device_);
         renderFinishedSemaphores_[i] = std::make_unique<Semaphore>(device_);
         inFlightFences_[i] = std::make_unique<Fence>(device_, true);  // Start signaled
@@ -250,9 +296,6 @@ void Window::createSyncObjects() {
 }
 
 void Window::recreateSwapChain() {
-    // Wait for device idle before recreating
-    device_->waitIdle();
-
     // Get new size
     int width, height;
     glfwGetFramebufferSize(window_, &width, &height);
@@ -263,12 +306,80 @@ void Window::recreateSwapChain() {
         glfwWaitEvents();
     }
 
-    // Recreate swap chain
-    swapChain_->recreate(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    // Frames in flight drain into the old swap chain, which is retired
+    // rather than waited for (present ids restart with the new one)
+    retire(swapChain_->recreateDeferred(static_cast<uint32_t>(width), static_cast<uint32_t>(height)));
+    displayedPresentId_ = 0;
 
     FINEVK_INFO(LogCategory::Core, "Swap chain recreated: " + std::to_string(width) + "x" + std::to_string(height));
 }
 
+void Window::retire(std::function<void()> destroy) {
+    if (!destroy) {
+        return;
+    }
+    if (retireHandler_) {
+        retireHandler_(std::move(destroy));
+        return;
+    }
+    if (!device_) {
+        destroy();
+        return;
+    }
+    // One more frame than slots, so the last frame's present has also been queued
+    retired_.push_back({std::move(destroy), device_->graphicsQueue()->lastSubmitted(),
+                        device_->maxFramesInFlight() + 1});
+}
+
+void Window::releaseRetired(bool all) {
+    for (size_t i = 0; i < retired_.size();) {
+        Retired& retired = retired_[i];
+        if (!all) {
+            if (retired.framesLeft > 0) {
+                retired.framesLeft--;
+            }
+            if (retired.framesLeft > 0 || !device_->graphicsQueue()->isComplete(retired.value)) {
+                i++;
+                continue;
+            }
+        }
+        std::function<void()> destroy = std::move(retired.destroy);
+        retired_[i] = std::move(retired_.back());
+        retired_.pop_back();
+        destroy();
+    }
+}
+
+VkPresentModeKHR Window::setPresentMode(VkPresentModeKHR mode) {
+    config_.presentMode = mode;
+    if (!swapChain_) {
+        return mode;
+    }
+
+    // Recreation waits for the device, so frames in flight finish first
+    VkPresentModeKHR previous = swapChain_->presentMode();
+    VkPresentModeKHR chosen = swapChain_->setPresentMode(mode, config_.swapChainImages);
+    if (chosen != previous) {
+        displayedPresentId_ = 0;
+    }
+    return chosen;
+}
+
+VkPresentModeKHR Window::presentMode() const {
+    if (swapChain_) {
+        return swapChain_->presentMode();
+    }
+    if (config_.presentMode != VK_PRESENT_MODE_MAX_ENUM_KHR) {
+        return config_.presentMode;
+    }
+    return config_.vsync ? VK_PRESENT_MODE_FIFO_KHR : VK_PRESENT_MODE_MAILBOX_KHR;
+}
+
+void Window::setVsync(bool enabled) {
+    config_.vsync = enabled;
+    setPresentMode(enabled ? VK_PRESENT_MODE_FIFO_KHR : VK_PRESENT_MODE_MAILBOX_KHR);
+}
+
 void Window::setupCallbacks() {
     glfwSetKeyCallback(window_, glfwKeyCallback);
     glfwSetMouseButtonCallback(window_, glfwMouseButtonCallback);
@@ -345,6 +456,12 @@ void Window::bindDevice(LogicalDevice& device) {
         throw std::runtime_error("Window already bound to a device");
     }
 
+    // The device holds the one frames-in-flight setting; a window-level
+    // request just changes it
+    if (config_.framesInFlight != 0) {
+        device.setFramesInFlight(config_.framesInFlight);
+    }
+
     device_ = &device;
 
     // Register for device destruction notification so we can clean up
@@ -353,6 +470,7 @@ void Window::bindDevice(LogicalDevice& device) {
         [this](LogicalDevice*) {
             // Don't call releaseDeviceResources() here because the device
             // is about to call waitIdle() itself. Just clean up our handles.
+            releaseRetired(true);
             inFlightFences_.clear();
             renderFinishedSemaphores_.clear();
             imageAvailableSemaphores_.clear();
@@ -382,14 +500,27 @@ std::optional<FrameInfo> Window::beginFrame() {
         return std::nullopt;
     }
 
+    // Frames in flight shrank (the device waited idle, so any slot is free)
+    if (currentFrameIndex_ >= device_->framesInFlight()) {
+        currentFrameIndex_ = 0;
+    }
+
     // Wait for this frame's fence
-    inFlightFences_[currentFrameIndex_]->wait();
+    {
+        FINEVK_PROFILE_SCOPE("Window::waitFence");
+        inFlightFences_[currentFrameIndex_]->wait();
+    }
+    releaseRetired(false);
 
     // Get sync objects for this frame
     VkSemaphore imageAvailable = imageAvailableSemaphores_[currentFrameIndex_]->handle();
 
     // Acquire next image
-    auto result = swapChain_->acquireNextImage(imageAvailable);
+    AcquireResult result;
+    {
+        FINEVK_PROFILE_SCOPE("Window::acquire");
+        result = swapChain_->acquireNextImage(imageAvailable);
+    }
 
     if (result.outOfDate) {
         recreateSwapChain();
@@ -420,12 +551,28 @@ bool Window::endFrame() {
     }
 
     VkSemaphore renderFinished = renderFinishedSemaphores_[currentFrameIndex_]->handle();
-    auto result = swapChain_->present(device_->presentQueue(), currentImageIndex_, renderFinished);
+    uint64_t previousId = swapChain_->lastPresentId();
+    VkResult result;
+    {
+        FINEVK_PROFILE_SCOPE("Window::present");
+        result = swapChain_->present(device_->presentQueue(), currentImageIndex_, renderFinished);
+    }
+
+    uint64_t presentId = swapChain_->lastPresentId();
+    if (presentId != previousId && lastPollTime_ != Clock::time_point{}) {
+        presentPollTimes_[presentId % kLatencyHistory] = lastPollTime_;
+        latency_.presents++;
+        smoothLatency(latency_.inputToPresent, Clock::now() - lastPollTime_, latency_.presents);
+    }
 
     // Advance frame index
-    currentFrameIndex_ = (currentFrameIndex_ + 1) % config_.framesInFlight;
+    currentFrameIndex_ = (currentFrameIndex_ + 1) % device_->framesInFlight();
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized_) {
+    // Out of date must be handled now; suboptimal and resize events can wait
+    // for the resize to settle
+    bool settled = Clock::now() - resizeTime_ >= config_.resizeDebounce;
+    if (result == VK_ERROR_OUT_OF_DATE_KHR ||
+        ((result == VK_SUBOPTIMAL_KHR || framebufferResized_) && settled)) {
         framebufferResized_ = false;
         recreateSwapChain();
         return false;
@@ -434,6 +581,49 @@ bool Window::endFrame() {
     return result == VK_SUCCESS;
 }
 
+void Window::waitForFrame(uint32_t queuedPresents) {
+    if (!device_) {
+        throw std::runtime_error("Window not bound to a device. Call bindDevice() first.");
+    }
+    if (currentFrameIndex_ >= device_->framesInFlight()) {
+        currentFrameIndex_ = 0;
+    }
+
+    FINEVK_PROFILE_SCOPE("Window::waitForFrame");
+    auto start = Clock::now();
+
+    // Bounded, since a hidden or minimized window may never display the frame
+    constexpr uint64_t presentTimeout = 100'000'000;  // 100 ms
+    uint64_t lastId = swapChain_->lastPresentId();
+    if (hasPresentWait() && lastId > queuedPresents && !isMinimized()) {
+        uint64_t waitId = lastId - queuedPresents;
+        if (waitId > displayedPresentId_ && swapChain_->waitForPresent(waitId, presentTimeout)) {
+            displayedPresentId_ = waitId;
+            // Older entries of the history have been overwritten
+            if (lastId - waitId < kLatencyHistory) {
+                smoothLatency(latency_.inputToDisplay,
+                              Clock::now() - presentPollTimes_[waitId % kLatencyHistory],
+                              waitId);
+            }
+        }
+    }
+
+    inFlightFences_[currentFrameIndex_]->wait();
+    smoothLatency(latency_.frameWait, Clock::now() - start, latency_.presents + 1);
+}
+
+uint32_t Window::framesInFlight() const {
+    return device_ ? device_->framesInFlight() : config_.framesInFlight;
+}
+
+uint32_t Window::maxFramesInFlight() const {
+    return device_ ? device_->maxFramesInFlight() : config_.framesInFlight;
+}
+
+bool Window::hasPresentWait() const {
+    return device_ && device_->supportsPresentWait();
+}
+
 void Window::waitIdle() {
     if (device_) {
         device_->waitIdle();
@@ -446,10 +636,12 @@ void Window::waitIdle() {
 
 void Window::pollEvents() {
     glfwPollEvents();
+    lastPollTime_ = Clock::now();
 }
 
 void Window::waitEvents() {
     glfwWaitEvents();
+    lastPollTime_ = Clock::now();
 }
 
 bool Window::isKeyPressed(Key key) const {
@@ -527,6 +719,7 @@ void Window::glfwFramebufferSizeCallback(GLFWwindow* glfwWindow, int width, int
     auto* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
     if (window) {
         window->framebufferResized_ = true;
+        window->resizeTime_ = Clock::now();
         if (window->resizeCallback_) {
             window->resizeCallback_(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
         }
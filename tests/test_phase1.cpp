@@ -7,6 +7,9 @@
  * - Surface creation from GLFW window
  * - Debug messenger setup
  * - Proper cleanup on destruction
+ * - ThreadPool and CPU profiler
+ * - Lazy log macros and the asynchronous logger
+ * - SmallVector, Span and the allocation counter
  */
 
 #include <finevk/finevk.hpp>
@@ -15,6 +18,11 @@
 
 #include <iostream>
 #include <cassert>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace finevk;
 
@@ -117,6 +125,192 @@ void test_multiple_instances() {
     std::cout << "PASSED\n";
 }
 
+void test_thread_pool() {
+    std::cout << "Testing: ThreadPool parallelFor... ";
+
+    ThreadPool pool(3);
+    assert(pool.threadCount() == 3);
+
+    auto future = pool.submit([] { return 42; });
+    assert(future.get() == 42);
+
+    // Every index visited exactly once, chunks contiguous and dense
+    std::vector<int> hits(1000, 0);
+    std::vector<int> chunkSeen(4, 0);
+    uint32_t chunks = pool.parallelFor(hits.size(),
+        [&](size_t begin, size_t end, uint32_t chunk) {
+            chunkSeen[chunk]++;
+            for (size_t i = begin; i < end; i++) {
+                hits[i]++;
+            }
+        }, 4);
+    assert(chunks == 4);
+    for (int h : hits) {
+        assert(h == 1);
+    }
+    for (uint32_t c = 0; c < chunks; c++) {
+        assert(chunkSeen[c] == 1);
+    }
+
+    // Exceptions propagate to the caller
+    bool threw = false;
+    try {
+        pool.parallelFor(8, [](size_t begin, size_t, uint32_t) {
+            if (begin == 0) throw std::runtime_error("chunk failed");
+        }, 2);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "PASSED\n";
+}
+
+void test_profiler() {
+    std::cout << "Testing: CPU profiler... ";
+
+    Profiler& profiler = Profiler::global();
+    profiler.clear();
+
+    // Disabled scopes record nothing
+    Profiler::setEnabled(false);
+    { ProfileScope scope("disabled"); }
+    assert(profiler.collect().empty());
+
+    Profiler::setEnabled(true);
+    Profiler::setThreadName("Test");
+    { ProfileScope scope("enabled"); }
+    std::thread([] { ProfileScope scope("worker"); }).join();
+    Profiler::setEnabled(false);
+
+    auto events = profiler.collect();
+    assert(events.size() == 2);
+    assert(std::string(events[0].name) == "enabled" || std::string(events[1].name) == "enabled");
+    assert(events[0].thread != events[1].thread);
+    assert(profiler.threadNames().size() >= 2);
+
+    // Ring keeps only the newest events
+    Profiler::setEnabled(true);
+    for (size_t i = 0; i < Profiler::EventsPerThread + 10; i++) {
+        ProfileScope scope("spin");
+    }
+    Profiler::setEnabled(false);
+    assert(profiler.collect().size() <= Profiler::EventsPerThread + 1);
+
+    // Percentiles of known frame times aren't testable with a real clock,
+    // but they must be ordered
+    profiler.resetFrameStats();
+    for (int i = 0; i < 20; i++) {
+        Profiler::markFrame();
+    }
+    FrameTimeStats stats = profiler.frameStats();
+    assert(stats.frames == 19);
+    assert(stats.p50 <= stats.p90 && stats.p90 <= stats.p99 && stats.p99 <= stats.max);
+
+    profiler.clear();
+    assert(profiler.collect().empty());
+
+    std::cout << "PASSED\n";
+}
+
+void test_small_vector_span() {
+    std::cout << "Testing: SmallVector and Span... ";
+
+    SmallVector<uint32_t, 4> values;
+    for (uint32_t i = 0; i < 4; i++) {
+        values.push_back(i);
+    }
+    assert(values.isInline() && values.size() == 4);
+
+    // Refilling the inline room doesn't touch the heap
+    uint64_t before = Profiler::allocationCount();
+    values.clear();
+    for (uint32_t i = 0; i < 4; i++) {
+        values.push_back(i * 2);
+    }
+    assert(Profiler::allocationCount() == before);
+
+    // One more spills to the heap and keeps the elements
+    values.push_back(8);
+    assert(!values.isInline() && values.size() == 5);
+    for (uint32_t i = 0; i < 5; i++) {
+        assert(values[i] == i * 2);
+    }
+    if (Profiler::countsAllocations()) {
+        assert(Profiler::allocationCount() > before);
+    }
+
+    // Moving steals the heap storage
+    const uint32_t* storage = values.data();
+    SmallVector<uint32_t, 4> moved(std::move(values));
+    assert(moved.data() == storage && moved.size() == 5);
+    assert(values.empty() && values.isInline());
+
+    // Span views any contiguous source without copying
+    std::vector<uint32_t> vec = {1, 2, 3};
+    uint32_t array[] = {4, 5};
+    Span<const uint32_t> fromVector = vec;
+    Span<const uint32_t> fromArray = array;
+    Span<const uint32_t> fromSmall = moved;
+    assert(fromVector.size() == 3 && fromVector.data() == vec.data());
+    assert(fromArray.size() == 2 && fromArray[1] == 5);
+    assert(fromSmall.size() == 5 && fromSmall.back() == 8);
+    assert(fromSmall.subspan(3).size() == 2 && fromSmall.subspan(9).empty());
+
+    auto sum = [](Span<const uint32_t> span) {
+        uint32_t total = 0;
+        for (uint32_t value : span) {
+            total += value;
+        }
+        return total;
+    };
+    assert(sum({1, 2, 3}) == 6);
+    assert(sum({}) == 0);
+    assert(sum({array, 1}) == 4);
+
+    std::cout << "PASSED\n";
+}
+
+void test_async_logger() {
+    std::cout << "Testing: Async logger... ";
+
+    Logger& logger = Logger::global();
+    LogLevel previous = logger.minLevel();
+
+    // Filtered messages are never built
+    int evaluated = 0;
+    auto message = [&evaluated]() {
+        evaluated++;
+        return std::string("built");
+    };
+    logger.setMinLevel(LogLevel::Error);
+    FINEVK_WARN(LogCategory::Core, message());
+    FINEVK_ERROR(LogCategory::Core, message());
+    assert(evaluated == 1);
+
+    // Messages from several threads all arrive (or are counted as dropped)
+    logger.setAsync(true);
+    assert(logger.isAsync());
+    uint64_t droppedBefore = logger.droppedCount();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t]() {
+            Logger::global().error(LogCategory::Core, "async logger test, thread " + std::to_string(t) +
+                                                      std::string(Logger::InlineMessageSize, '.'));
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+    assert(logger.droppedCount() == droppedBefore);
+    logger.setAsync(false);
+    assert(!logger.isAsync());
+
+    logger.setMinLevel(previous);
+    std::cout << "PASSED\n";
+}
+
 int main() {
     std::cout << "\n========================================\n";
     std::cout << "FineStructure Vulkan - Phase 1 Tests\n";
@@ -142,6 +336,10 @@ int main() {
         test_surface_creation();
         test_instance_move();
         test_multiple_instances();
+        test_thread_pool();
+        test_profiler();
+        test_small_vector_span();
+        test_async_logger();
 
         std::cout << "\n========================================\n";
         std::cout << "All Phase 1 tests PASSED!\n";
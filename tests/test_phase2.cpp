@@ -6,10 +6,18 @@
  * - Physical device enumeration and selection
  * - Logical device creation with queues
  * - Memory allocation
+ * - Defragmentation of GPU-only buffers, including writes between passes
+ *   and pending moves carried by C++ moves or cut short by destruction
  * - Buffer creation and uploads
+ * - Direct writes into device-local host-visible memory
+ * - Flush/invalidate of cached, possibly non-coherent memory
  * - Image and ImageView creation
- * - Sampler creation
+ * - Sampler creation and the shared sampler cache
  * - Command pool and buffer operations
+ * - GPU timestamp profiling
+ * - Async compute with timeline waits
+ * - Batched submission and synchronization2 barriers
+ * - Host image copies (VK_EXT_host_image_copy)
  */
 
 #include <finevk/finevk.hpp>
@@ -17,8 +25,11 @@
 #include <GLFW/glfw3.h>
 
 #include <iostream>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <stdexcept>
+#include <vector>
 
 using namespace finevk;
 
@@ -63,6 +74,8 @@ void setup_test_context() {
     ctx.logicalDevice = ctx.physicalDevice.createLogicalDevice()
         .surface(ctx.surface.get())
         .enableAnisotropy()
+        .enableSynchronization2()
+        .enableHostImageCopy()
         .build();
 
     std::cout << "  Logical device created\n\n";
@@ -173,6 +186,359 @@ void test_memory_allocator() {
     std::cout << "PASSED\n";
 }
 
+void test_memory_suballocation() {
+    std::cout << "Testing: Memory sub-allocation... ";
+
+    auto& allocator = ctx.logicalDevice->allocator();
+
+    VkMemoryRequirements memReq{};
+    memReq.size = 1000;
+    memReq.alignment = 256;
+    memReq.memoryTypeBits = 0xFFFFFFFF;
+
+    size_t memoryCountBefore = allocator.deviceMemoryCount();
+
+    auto a = allocator.allocate(memReq, MemoryUsage::CpuToGpu);
+    auto b = allocator.allocate(memReq, MemoryUsage::CpuToGpu);
+
+    // Both come from the same block, aligned and non-overlapping
+    assert(a.memory == b.memory);
+    assert(a.offset % memReq.alignment == 0);
+    assert(b.offset % memReq.alignment == 0);
+    assert(a.offset + a.size <= b.offset || b.offset + b.size <= a.offset);
+    assert(static_cast<char*>(b.mappedPtr) - static_cast<char*>(a.mappedPtr) ==
+           static_cast<ptrdiff_t>(b.offset) - static_cast<ptrdiff_t>(a.offset));
+    assert(allocator.deviceMemoryCount() <= memoryCountBefore + 1);
+
+    allocator.free(a);
+    allocator.free(b);
+
+    std::cout << "PASSED\n";
+}
+
+void test_dedicated_allocation() {
+    std::cout << "Testing: Dedicated allocation routing... ";
+
+    auto& allocator = ctx.logicalDevice->allocator();
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = 256;
+    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkBuffer buffer;
+    assert(vkCreateBuffer(ctx.logicalDevice->handle(), &bufferInfo, nullptr, &buffer) == VK_SUCCESS);
+
+    // Small buffers share blocks
+    auto allocation = allocator.allocateForBuffer(buffer, MemoryUsage::CpuToGpu);
+    assert(allocation.block != nullptr);
+    assert(vkBindBufferMemory(ctx.logicalDevice->handle(), buffer, allocation.memory,
+                              allocation.offset) == VK_SUCCESS);
+    vkDestroyBuffer(ctx.logicalDevice->handle(), buffer, nullptr);
+    allocator.free(allocation);
+
+    // Attachments bind wherever the driver routed them
+    auto depth = Image::createDepthBuffer(ctx.logicalDevice.get(), 1024, 1024);
+    assert(depth->handle() != VK_NULL_HANDLE);
+
+    std::cout << "PASSED\n";
+}
+
+void test_memory_stats() {
+    std::cout << "Testing: Memory stats and budget... ";
+
+    auto& allocator = ctx.logicalDevice->allocator();
+    MemoryStats meshBefore = allocator.categoryStats(MemoryCategory::Mesh);
+    uint32_t heap = allocator.heapIndex(MemoryUsage::GpuOnly);
+    MemoryStats heapBefore = allocator.heapStats(heap);
+
+    {
+        auto vertexBuffer = Buffer::createVertexBuffer(ctx.logicalDevice.get(), 4096);
+        MemoryStats mesh = allocator.categoryStats(MemoryCategory::Mesh);
+        assert(mesh.allocationCount == meshBefore.allocationCount + 1);
+        assert(mesh.allocated >= meshBefore.allocated + 4096);
+        assert(mesh.peakAllocated >= mesh.allocated);
+        assert(allocator.heapStats(heap).allocated > heapBefore.allocated);
+    }
+
+    MemoryStats meshAfter = allocator.categoryStats(MemoryCategory::Mesh);
+    assert(meshAfter.allocated == meshBefore.allocated);
+    assert(meshAfter.peakAllocated > meshAfter.allocated);
+    allocator.resetPeaks();
+    assert(allocator.categoryStats(MemoryCategory::Mesh).peakAllocated == meshAfter.allocated);
+
+    MemoryBudget budget = allocator.budget(MemoryUsage::GpuOnly);
+    assert(budget.heapSize > 0);
+    assert(budget.budget > 0);
+    assert(allocator.budgets().size() > heap);
+
+    std::cout << "PASSED\n";
+}
+
+// Eight 16 KB relocatable GPU-only buffers filled with i + 1, of which 0, 1,
+// 5, 6 and 7 are freed to leave sparse blocks; empty if GPU-only memory is
+// host-visible here (unified memory), which is never relocated
+std::vector<BufferPtr> make_sparse_buffers(CommandPool& cmdPool) {
+    std::vector<BufferPtr> buffers;
+    for (uint32_t i = 0; i < 8; i++) {
+        auto buffer = Buffer::create(ctx.logicalDevice.get())
+            .size(16 * 1024)
+            .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+            .memoryUsage(MemoryUsage::GpuOnly)
+            .relocatable()
+            .build();
+        if (!buffer->isRelocatable()) {
+            return {};
+        }
+        std::vector<unsigned char> data(16 * 1024, static_cast<unsigned char>(i + 1));
+        buffer->upload(data.data(), data.size(), 0, &cmdPool);
+        buffers.push_back(std::move(buffer));
+    }
+
+    for (uint32_t i : {0u, 1u, 5u, 6u, 7u}) {
+        buffers[i].reset();
+    }
+    return buffers;
+}
+
+std::vector<unsigned char> read_back(Buffer& buffer, CommandPool& cmdPool) {
+    auto readback = Buffer::create(ctx.logicalDevice.get())
+        .size(buffer.size())
+        .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuToCpu)
+        .build();
+    readback->copyFrom(buffer, buffer.size(), &cmdPool);
+    readback->invalidate();
+    const auto* bytes = static_cast<const unsigned char*>(readback->mappedPtr());
+    return std::vector<unsigned char>(bytes, bytes + buffer.size());
+}
+
+bool filled_with(const std::vector<unsigned char>& bytes, unsigned char value) {
+    return std::all_of(bytes.begin(), bytes.end(), [value](unsigned char b) { return b == value; });
+}
+
+void test_defragmentation() {
+    std::cout << "Testing: Defragmentation... ";
+
+    auto& allocator = ctx.logicalDevice->allocator();
+    VkDeviceSize oldBlockSize = allocator.blockSize();
+    allocator.setBlockSize(64 * 1024);
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+
+    // Host-visible buffers are never moved
+    auto mapped = Buffer::create(ctx.logicalDevice.get())
+        .size(1024)
+        .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+        .memoryUsage(MemoryUsage::CpuToGpu)
+        .relocatable()
+        .build();
+    assert(!mapped->isRelocatable());
+    mapped.reset();
+
+    std::vector<BufferPtr> buffers = make_sparse_buffers(cmdPool);
+    if (buffers.empty()) {
+        allocator.setBlockSize(oldBlockSize);
+        std::cout << "SKIPPED (GPU-only memory is host-visible)\n";
+        return;
+    }
+
+    uint32_t relocated = 0;
+    for (auto& buffer : buffers) {
+        if (buffer) {
+            buffer->setRelocationCallback([&relocated](Buffer&) { relocated++; });
+        }
+    }
+
+    uint32_t recorded = 0;
+    uint32_t committed = 0;
+    for (uint32_t pass = 0; pass < 32; pass++) {
+        auto imm = cmdPool.beginImmediate();
+        DefragmentStats stats = allocator.defragment(imm.cmd(), ctx.logicalDevice->graphicsQueue());
+        recorded += stats.movesRecorded;
+        committed += stats.movesCommitted;
+        if (stats.movesRecorded == 0 && stats.movesPending == 0) {
+            break;
+        }
+    }
+    ctx.logicalDevice->graphicsQueue()->waitIdle();
+
+    // Every recorded move finished and contents came along
+    assert(committed == recorded);
+    assert(relocated == committed);
+    for (uint32_t i : {2u, 3u, 4u}) {
+        assert(!buffers[i]->movePending());
+        assert(filled_with(read_back(*buffers[i], cmdPool), static_cast<unsigned char>(i + 1)));
+    }
+
+    buffers.clear();
+    allocator.setBlockSize(oldBlockSize);
+
+    std::cout << "PASSED\n";
+}
+
+void test_defragmentation_writes() {
+    std::cout << "Testing: Defragmentation with writes between passes... ";
+
+    auto& allocator = ctx.logicalDevice->allocator();
+    VkDeviceSize oldBlockSize = allocator.blockSize();
+    allocator.setBlockSize(64 * 1024);
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+
+    std::vector<BufferPtr> buffers = make_sparse_buffers(cmdPool);
+    if (buffers.empty()) {
+        allocator.setBlockSize(oldBlockSize);
+        std::cout << "SKIPPED (GPU-only memory is host-visible)\n";
+        return;
+    }
+
+    // Rewrite every buffer before each pass; writes during a pending move
+    // must be refused rather than silently dropped at the commit
+    std::vector<unsigned char> expected(buffers.size(), 0);
+    for (uint32_t i : {2u, 3u, 4u}) {
+        expected[i] = static_cast<unsigned char>(i + 1);
+    }
+
+    uint32_t recorded = 0;
+    uint32_t committed = 0;
+    uint32_t rejected = 0;
+    for (uint32_t pass = 0; pass < 32; pass++) {
+        for (uint32_t i : {2u, 3u, 4u}) {
+            auto value = static_cast<unsigned char>((pass * 3 + i) % 250 + 10);
+            std::vector<unsigned char> data(16 * 1024, value);
+            if (buffers[i]->movePending()) {
+                bool threw = false;
+                try {
+                    buffers[i]->upload(data.data(), data.size(), 0, &cmdPool);
+                } catch (const std::runtime_error&) {
+                    threw = true;
+                }
+                assert(threw);
+                rejected++;
+            } else {
+                buffers[i]->upload(data.data(), data.size(), 0, &cmdPool);
+                expected[i] = value;
+            }
+        }
+
+        auto imm = cmdPool.beginImmediate();
+        DefragmentStats stats = allocator.defragment(imm.cmd(), ctx.logicalDevice->graphicsQueue());
+        recorded += stats.movesRecorded;
+        committed += stats.movesCommitted;
+        if (stats.movesRecorded == 0 && stats.movesPending == 0) {
+            break;
+        }
+    }
+    ctx.logicalDevice->graphicsQueue()->waitIdle();
+
+    // Each buffer holds its last accepted write, moved or not
+    assert(committed == recorded);
+    assert(recorded == 0 || rejected > 0);
+    for (uint32_t i : {2u, 3u, 4u}) {
+        assert(filled_with(read_back(*buffers[i], cmdPool), expected[i]));
+    }
+
+    buffers.clear();
+    allocator.setBlockSize(oldBlockSize);
+
+    std::cout << "PASSED\n";
+}
+
+void test_defragmentation_pending_moves() {
+    std::cout << "Testing: Defragmentation with pending moves moved or destroyed... ";
+
+    auto& allocator = ctx.logicalDevice->allocator();
+    VkDeviceSize oldBlockSize = allocator.blockSize();
+    allocator.setBlockSize(64 * 1024);
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+    Queue* queue = ctx.logicalDevice->graphicsQueue();
+
+    // Record passes until some buffer has a move in flight; -1 if none ever does
+    auto recordUntilPending = [&](std::vector<BufferPtr>& buffers, uint32_t& recorded) {
+        for (uint32_t pass = 0; pass < 8; pass++) {
+            auto imm = cmdPool.beginImmediate();
+            recorded += allocator.defragment(imm.cmd(), queue).movesRecorded;
+            for (size_t i = 0; i < buffers.size(); i++) {
+                if (buffers[i] && buffers[i]->movePending()) {
+                    return static_cast<int>(i);
+                }
+            }
+        }
+        return -1;
+    };
+    auto finish = [&](uint32_t& recorded, uint32_t& committed) {
+        for (uint32_t pass = 0; pass < 32; pass++) {
+            auto imm = cmdPool.beginImmediate();
+            DefragmentStats stats = allocator.defragment(imm.cmd(), queue);
+            recorded += stats.movesRecorded;
+            committed += stats.movesCommitted;
+            if (stats.movesRecorded == 0 && stats.movesPending == 0) {
+                break;
+            }
+        }
+        queue->waitIdle();
+    };
+
+    std::vector<BufferPtr> buffers = make_sparse_buffers(cmdPool);
+    if (buffers.empty()) {
+        allocator.setBlockSize(oldBlockSize);
+        std::cout << "SKIPPED (GPU-only memory is host-visible)\n";
+        return;
+    }
+
+    // A C++ move carries the pending move along, which then commits normally
+    uint32_t recorded = 0;
+    uint32_t committed = 0;
+    int moving = recordUntilPending(buffers, recorded);
+    if (moving >= 0) {
+        BufferPtr moved(new Buffer(std::move(*buffers[moving])));
+        assert(moved->movePending() && moved->isRelocatable());
+        assert(!buffers[moving]->movePending() && !buffers[moving]->isRelocatable());
+        buffers[moving] = std::move(moved);
+    }
+    finish(recorded, committed);
+    assert(committed == recorded);
+    for (uint32_t i : {2u, 3u, 4u}) {
+        assert(filled_with(read_back(*buffers[i], cmdPool), static_cast<unsigned char>(i + 1)));
+    }
+    buffers.clear();
+
+    // Destroying a buffer mid-move retires both its handles instead of freeing them under the copy
+    buffers = make_sparse_buffers(cmdPool);
+    recorded = 0;
+    committed = 0;
+    moving = recordUntilPending(buffers, recorded);
+    if (moving >= 0) {
+        buffers[moving].reset();
+        auto reuse = Buffer::create(ctx.logicalDevice.get())
+            .size(16 * 1024)
+            .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+            .memoryUsage(MemoryUsage::GpuOnly)
+            .build();
+        assert(reuse->handle() != VK_NULL_HANDLE);
+    }
+    finish(recorded, committed);
+    assert(committed + (moving >= 0 ? 1u : 0u) == recorded);
+    for (uint32_t i : {2u, 3u, 4u}) {
+        if (static_cast<int>(i) != moving) {
+            assert(filled_with(read_back(*buffers[i], cmdPool), static_cast<unsigned char>(i + 1)));
+        }
+    }
+
+    buffers.clear();
+    allocator.setBlockSize(oldBlockSize);
+
+    std::cout << "PASSED\n";
+}
+
 void test_buffer_creation() {
     std::cout << "Testing: Buffer creation... ";
 
@@ -238,6 +604,98 @@ void test_buffer_staging_upload() {
     std::cout << "PASSED\n";
 }
 
+void test_direct_write_buffer() {
+    std::cout << "Testing: Direct write buffer... ";
+
+    auto& allocator = ctx.logicalDevice->allocator();
+
+    // Device local + host visible where present, else plain host visible
+    auto buffer = Buffer::create(ctx.logicalDevice.get())
+        .size(1024)
+        .usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+        .memoryUsage(MemoryUsage::GpuDirectWrite)
+        .build();
+    assert(buffer->isMappable());
+
+    VkMemoryRequirements memReq{};
+    memReq.size = 1024;
+    memReq.alignment = 256;
+    memReq.memoryTypeBits = 0xFFFFFFFF;
+    auto allocation = allocator.allocate(memReq, MemoryUsage::GpuDirectWrite);
+    const auto& memProps = ctx.physicalDevice.capabilities().memory;
+    VkMemoryPropertyFlags flags = memProps.memoryTypes[allocation.memoryType].propertyFlags;
+    assert(allocation.mappedPtr != nullptr);
+    assert(flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    if (allocator.supportsDirectWrite() && (flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        std::cout << "(device local) ";
+    }
+    allocator.free(allocation);
+
+    // Written in place, no staging
+    float vertices[] = {-0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f};
+    buffer->upload(vertices, sizeof(vertices));
+    assert(std::memcmp(buffer->mappedPtr(), vertices, sizeof(vertices)) == 0);
+
+    std::cout << "PASSED\n";
+}
+
+void test_cached_readback_buffer() {
+    std::cout << "Testing: Cached readback buffer... ";
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+
+    // Cached memory, possibly non-coherent; sizes off the atom size on purpose
+    auto source = Buffer::create(ctx.logicalDevice.get())
+        .size(100)
+        .usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+        .memoryUsage(MemoryUsage::CpuOnly)
+        .build();
+    auto readback = Buffer::create(ctx.logicalDevice.get())
+        .size(100)
+        .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuToCpu)
+        .build();
+    assert(source->isMappable() && readback->isMappable());
+
+    // Neighbours in non-coherent memory never share an atom
+    auto& allocator = ctx.logicalDevice->allocator();
+    VkMemoryRequirements memReq{};
+    memReq.size = 100;
+    memReq.alignment = 4;
+    memReq.memoryTypeBits = 0xFFFFFFFF;
+    auto first = allocator.allocate(memReq, MemoryUsage::GpuToCpu);
+    auto second = allocator.allocate(memReq, MemoryUsage::GpuToCpu);
+    if (!allocator.isCoherent(first)) {
+        VkDeviceSize atom = ctx.physicalDevice.capabilities().properties.limits.nonCoherentAtomSize;
+        assert(first.offset % atom == 0 && second.offset % atom == 0);
+        std::cout << "(non-coherent) ";
+    }
+    allocator.free(first);
+    allocator.free(second);
+
+    uint8_t data[100];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    std::memcpy(source->mappedPtr(), data, sizeof(data));
+    source->flush(3, 90);
+    source->flush();
+
+    auto imm = cmdPool.beginImmediate();
+    imm.cmd().copyBuffer(*source, *readback, sizeof(data));
+    imm.cmd().memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+    imm.submit();
+
+    readback->invalidate(5, 1);
+    readback->invalidate();
+    assert(std::memcmp(readback->mappedPtr(), data, sizeof(data)) == 0);
+
+    std::cout << "PASSED\n";
+}
+
 void test_image_creation() {
     std::cout << "Testing: Image creation... ";
 
@@ -256,6 +714,21 @@ void test_image_creation() {
     assert(depthBuffer != nullptr);
     assert(depthBuffer->width() == 800);
     assert(depthBuffer->height() == 600);
+    assert(depthBuffer->usage() & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
+
+    // Transient memory is attachment-only
+    bool threw = false;
+    try {
+        Image::create(ctx.logicalDevice.get())
+            .extent(64, 64)
+            .format(VK_FORMAT_R8G8B8A8_UNORM)
+            .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+            .memoryUsage(MemoryUsage::Transient)
+            .build();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
 
     std::cout << "PASSED\n";
 }
@@ -309,6 +782,47 @@ void test_sampler_creation() {
     std::cout << "PASSED\n";
 }
 
+void test_sampler_cache() {
+    std::cout << "Testing: Sampler cache... ";
+
+    auto& cache = ctx.logicalDevice->samplerCache();
+    size_t before = cache.size();
+
+    auto clampBuilder = [] {
+        return Sampler::create(ctx.logicalDevice.get())
+            .filter(VK_FILTER_LINEAR)
+            .addressMode(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE)
+            .mipLod(0.0f, 4.0f);
+    };
+
+    // Identical state shares one sampler
+    SamplerRef a = clampBuilder().buildShared();
+    SamplerRef b = clampBuilder().buildShared();
+    assert(a != nullptr);
+    assert(a->handle() != VK_NULL_HANDLE);
+    assert(a == b);
+
+    // Any difference in state is a different sampler
+    SamplerRef compare = clampBuilder().compareOp(VK_COMPARE_OP_LESS_OR_EQUAL).buildShared();
+    SamplerRef lod = clampBuilder().mipLod(0.0f, 4.0f, 0.5f).buildShared();
+    assert(compare != a);
+    assert(lod != a);
+    assert(lod != compare);
+    assert(cache.size() == before + 3);
+
+    // trim() keeps referenced samplers
+    a.reset();
+    assert(cache.trim() == 0);
+    b.reset();
+    compare.reset();
+    assert(cache.trim() == 2);
+    assert(cache.size() == before + 1);
+    lod.reset();
+    cache.trim();
+
+    std::cout << "PASSED\n";
+}
+
 void test_command_pool() {
     std::cout << "Testing: Command pool... ";
 
@@ -407,6 +921,48 @@ void test_image_layout_transition() {
     std::cout << "PASSED\n";
 }
 
+void test_host_image_copy() {
+    std::cout << "Testing: Host image copy... ";
+
+    const auto& caps = ctx.physicalDevice.capabilities();
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    if (!ctx.logicalDevice->supportsHostImageCopy() ||
+        !caps.supportsHostImageTransfer(ctx.physicalDevice.handle(), format)) {
+        std::cout << "SKIPPED (no host image copy)\n";
+        return;
+    }
+
+    std::vector<uint8_t> level0(64 * 64 * 4, 0x40);
+    std::vector<uint8_t> level1(32 * 32 * 4, 0x80);
+
+    auto image = Image::create(ctx.logicalDevice.get())
+        .extent(64, 64)
+        .format(format)
+        .usage(VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .mipLevels(2)
+        .build();
+    image->transitionLayoutOnHost(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    image->copyFromHost(level0.data(), 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    image->copyFromHost(level1.data(), 1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // Same thing through the texture helper, no command pool involved
+    auto uploaded = uploadFromHost(ctx.logicalDevice.get(), format, 64, 64,
+                                   {level0.data(), level1.data()});
+    assert(uploaded->mipLevels() == 2);
+
+    // Images without host transfer usage are rejected
+    auto plain = Image::createTexture2D(ctx.logicalDevice.get(), 64, 64, format);
+    bool threw = false;
+    try {
+        plain->copyFromHost(level0.data(), 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "PASSED\n";
+}
+
 void test_buffer_copy() {
     std::cout << "Testing: Buffer copy command... ";
 
@@ -428,6 +984,211 @@ void test_buffer_copy() {
     std::cout << "PASSED\n";
 }
 
+void test_gpu_profiler() {
+    std::cout << "Testing: GPU profiler... ";
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+
+    auto profiler = GpuProfiler::create(ctx.logicalDevice.get())
+        .framesInFlight(1)
+        .maxScopes(2)
+        .build();
+    if (!profiler->isSupported()) {
+        std::cout << "SKIPPED (no timestamp support)\n";
+        return;
+    }
+
+    auto srcBuffer = Buffer::createStagingBuffer(ctx.logicalDevice.get(), 256);
+    auto dstBuffer = Buffer::createVertexBuffer(ctx.logicalDevice.get(), 256);
+
+    // Two frames on one slot: the second reads back the first
+    for (int frame = 0; frame < 2; frame++) {
+        auto imm = cmdPool.beginImmediate();
+        profiler->beginFrame(imm.cmd(), 0);
+        imm.cmd().setProfiler(profiler.get());
+        {
+            GpuProfiler::Scope outer(imm.cmd(), "copy");
+            GpuProfiler::Scope inner(imm.cmd(), "inner");
+            GpuProfiler::Scope dropped(imm.cmd(), "dropped");  // Over maxScopes
+            imm.cmd().copyBuffer(*srcBuffer, *dstBuffer, 256);
+        }
+        profiler->endFrame(imm.cmd());
+    }
+
+    const auto& results = profiler->results();
+    assert(results.frame == 1);
+    assert(results.scopes.size() == 2);
+    assert(std::strcmp(results.scopes[0].name, "copy") == 0);
+    assert(results.scopes[0].depth == 0 && results.scopes[0].parent == -1);
+    assert(results.scopes[1].depth == 1 && results.scopes[1].parent == 0);
+    assert(results.totalMilliseconds >= results.scopes[0].milliseconds);
+    assert(results.milliseconds("inner") == results.scopes[1].milliseconds);
+
+    std::cout << "PASSED\n";
+}
+
+void test_command_stats() {
+    std::cout << "Testing: Command stats... ";
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Resettable);
+
+    auto srcBuffer = Buffer::createStagingBuffer(ctx.logicalDevice.get(), 256);
+    auto dstBuffer = Buffer::createVertexBuffer(ctx.logicalDevice.get(), 256);
+
+    auto cmd = cmdPool.allocate();
+    cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    cmd->copyBuffer(*srcBuffer, *dstBuffer, 128);
+    cmd->copyBuffer(*srcBuffer, *dstBuffer, 64, 128, 128);
+    cmd->memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    cmd->end();
+
+    assert(cmd->stats().transfers == 2);
+    assert(cmd->stats().transferBytes == 192);
+    assert(cmd->stats().barriers == 1);
+    assert(cmd->stats().draws == 0);
+
+    // Counters restart with each recording
+    cmd->reset();
+    cmd->begin();
+    cmd->end();
+    assert(cmd->stats().transfers == 0 && cmd->stats().barriers == 0);
+
+    std::cout << "PASSED\n";
+}
+
+void test_async_compute() {
+    std::cout << "Testing: Async compute... ";
+
+    auto compute = AsyncCompute::create(ctx.logicalDevice.get())
+        .framesInFlight(2)
+        .build();
+    Queue* graphics = ctx.logicalDevice->graphicsQueue();
+    assert(compute->isAsync() == (compute->queue() != graphics));
+
+    auto dstBuffer = Buffer::create(ctx.logicalDevice.get())
+        .size(256)
+        .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+               VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+    auto readback = Buffer::create(ctx.logicalDevice.get())
+        .size(256)
+        .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuToCpu)
+        .build();
+
+    // Compute batch fills the buffer and hands it to graphics
+    CommandBuffer& cmd = compute->begin();
+    cmd.fillBuffer(*dstBuffer, 0xABABABAB);
+    compute->release(cmd, *dstBuffer, QueueHandoff::ComputeToGraphics,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    TimelinePoint filled = compute->submit();
+
+    // Graphics waits for it on the GPU, not the CPU
+    CommandPool cmdPool(ctx.logicalDevice.get(), graphics, CommandPoolFlags::Transient);
+    auto graphicsCmd = cmdPool.allocate();
+    graphicsCmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    compute->acquire(*graphicsCmd, *dstBuffer, QueueHandoff::ComputeToGraphics,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+    graphicsCmd->copyBuffer(*dstBuffer, *readback, 256);
+    graphicsCmd->end();
+    uint64_t copied = graphics->submitAfter(graphicsCmd->handle(), {filled},
+                                            VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    graphics->waitFor(copied);
+    if (graphics->timeline() != VK_NULL_HANDLE) {
+        assert(filled.isComplete());
+    } else {
+        graphics->waitIdle();
+    }
+    readback->invalidate();
+    assert(static_cast<const uint8_t*>(readback->mappedPtr())[255] == 0xAB);
+
+    // begin() without submit() is reported instead of silently discarded
+    compute->begin();
+    bool threw = false;
+    try {
+        compute->begin();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    compute->submit();
+    compute->waitIdle();
+
+    std::cout << "PASSED\n";
+}
+
+void test_submit_batch() {
+    std::cout << "Testing: Batched submission... ";
+
+    Queue* graphics = ctx.logicalDevice->graphicsQueue();
+    CommandPool cmdPool(ctx.logicalDevice.get(), graphics, CommandPoolFlags::Transient);
+
+    auto gpuBuffer = Buffer::create(ctx.logicalDevice.get())
+        .size(256)
+        .usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuOnly)
+        .build();
+    auto readback = Buffer::create(ctx.logicalDevice.get())
+        .size(256)
+        .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .memoryUsage(MemoryUsage::GpuToCpu)
+        .build();
+
+    // Fill in one command buffer, copy out in another, ordered by a barrier
+    // with sync2 stage masks (recorded with the original command without sync2)
+    auto fill = cmdPool.allocate();
+    fill->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    fill->fillBuffer(*gpuBuffer, 0x5A5A5A5A);
+    BarrierBatch barriers;
+    barriers.buffer(*gpuBuffer, VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                    VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+    assert(!barriers.empty());
+    barriers.record(*fill);
+    assert(barriers.empty());
+    fill->end();
+    assert(fill->stats().barriers == 1);
+
+    auto copy = cmdPool.allocate();
+    copy->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    copy->copyBuffer(*gpuBuffer, *readback, 256);
+    copy->memoryBarrier2(VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                         VK_PIPELINE_STAGE_2_HOST_BIT_KHR, VK_ACCESS_2_HOST_READ_BIT_KHR);
+    copy->end();
+
+    // Two batches, one queue submission, one timeline value
+    SubmitBatch batch(graphics);
+    assert(batch.empty());
+    uint64_t before = graphics->lastSubmitted();
+    batch.add(*fill);
+    batch.next()
+         .wait(graphics->lastSubmittedPoint(), VK_PIPELINE_STAGE_2_COPY_BIT_KHR)
+         .add(*copy);
+    assert(batch.batchCount() == 2 && batch.commandBufferCount() == 2);
+    uint64_t value = batch.submit();
+    assert(batch.empty());
+
+    if (graphics->timeline() != VK_NULL_HANDLE) {
+        assert(value == before + 1);
+        graphics->waitFor(value);
+    } else {
+        graphics->waitIdle();
+    }
+    readback->invalidate();
+    assert(static_cast<const uint8_t*>(readback->mappedPtr())[128] == 0x5A);
+
+    // Nothing collected: nothing submitted
+    assert(batch.submit() == 0);
+
+    std::cout << "PASSED\n";
+}
+
 void test_device_wait_idle() {
     std::cout << "Testing: Device wait idle... ";
 
@@ -469,11 +1230,19 @@ int main() {
 
         // Memory tests
         test_memory_allocator();
+        test_memory_suballocation();
+        test_dedicated_allocation();
+        test_memory_stats();
+        test_defragmentation();
+        test_defragmentation_writes();
+        test_defragmentation_pending_moves();
 
         // Buffer tests
         test_buffer_creation();
         test_buffer_upload();
         test_buffer_staging_upload();
+        test_direct_write_buffer();
+        test_cached_readback_buffer();
 
         // Image tests
         test_image_creation();
@@ -481,6 +1250,7 @@ int main() {
 
         // Sampler tests
         test_sampler_creation();
+        test_sampler_cache();
 
         // Command tests
         test_command_pool();
@@ -488,9 +1258,14 @@ int main() {
         test_command_buffer_recording();
         test_immediate_commands();
         test_image_layout_transition();
+        test_host_image_copy();
         test_buffer_copy();
+        test_gpu_profiler();
+        test_command_stats();
 
         // Final test
+        test_async_compute();
+        test_submit_batch();
         test_device_wait_idle();
 
         cleanup_test_context();
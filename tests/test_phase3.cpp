@@ -7,8 +7,16 @@
  * - Render pass creation
  * - Framebuffer creation
  * - Pipeline layout and graphics pipeline creation
+ * - Specialization constants for shader variants
+ * - Pipeline state keys for the shared pipeline registry
  * - Synchronization primitives
- * - Descriptor sets
+ * - Descriptor sets and update templates
+ * - Growable descriptor allocator and layout cache
+ * - Render graph culling, barriers and transient aliasing
+ * - Dynamic rendering targets (render pass fallback without it)
+ * - Depth-only and multiview render targets
+ * - Sampled depth buffers and resumed passes (Hi-Z builds)
+ * - Render scale (partial render area for dynamic resolution)
  */
 
 #include <finevk/finevk.hpp>
@@ -17,6 +25,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstring>
 #include <fstream>
 
 using namespace finevk;
@@ -63,6 +72,8 @@ void setup_test_context() {
     ctx.logicalDevice = ctx.physicalDevice.createLogicalDevice()
         .surface(ctx.surface.get())
         .enableAnisotropy()
+        .enableDynamicRendering()
+        .enableMultiview()
         .build();
 
     // Create swap chain
@@ -105,6 +116,57 @@ void test_swapchain_creation() {
     std::cout << "PASSED\n";
 }
 
+void test_swapchain_present_mode() {
+    std::cout << "Testing: SwapChain present mode switch... ";
+
+    // vsync(true) asked for FIFO, which every surface supports
+    assert(ctx.swapChain->presentMode() == VK_PRESENT_MODE_FIFO_KHR);
+    assert(ctx.swapChain->supportsPresentMode(VK_PRESENT_MODE_FIFO_KHR));
+
+    uint64_t generation = ctx.swapChain->generation();
+    VkPresentModeKHR mode = ctx.swapChain->setPresentMode(VK_PRESENT_MODE_MAILBOX_KHR);
+    assert(mode == ctx.swapChain->presentMode());
+    assert(mode == VK_PRESENT_MODE_MAILBOX_KHR ||
+           mode == VK_PRESENT_MODE_IMMEDIATE_KHR ||
+           mode == VK_PRESENT_MODE_FIFO_KHR);
+    if (mode != VK_PRESENT_MODE_FIFO_KHR) {
+        assert(ctx.swapChain->generation() == generation + 1);
+    }
+
+    // Back to FIFO; the same mode again is a no-op
+    assert(ctx.swapChain->setPresentMode(VK_PRESENT_MODE_FIFO_KHR) == VK_PRESENT_MODE_FIFO_KHR);
+    generation = ctx.swapChain->generation();
+    ctx.swapChain->setPresentMode(VK_PRESENT_MODE_FIFO_KHR);
+    assert(ctx.swapChain->generation() == generation);
+
+    assert(ctx.swapChain->imageViews().size() == ctx.swapChain->imageCount());
+    assert(SwapChain::recommendedImageCount(VK_PRESENT_MODE_MAILBOX_KHR) == 3);
+    assert(SwapChain::recommendedImageCount(VK_PRESENT_MODE_FIFO_KHR) == 2);
+
+    std::cout << "PASSED\n";
+}
+
+void test_swapchain_recreate_deferred() {
+    std::cout << "Testing: SwapChain deferred recreation... ";
+
+    VkSwapchainKHR oldHandle = ctx.swapChain->handle();
+    uint64_t generation = ctx.swapChain->generation();
+    VkExtent2D extent = ctx.swapChain->extent();
+
+    auto destroyOld = ctx.swapChain->recreateDeferred(extent.width, extent.height);
+    assert(destroyOld);
+    assert(ctx.swapChain->handle() != VK_NULL_HANDLE);
+    assert(ctx.swapChain->handle() != oldHandle);
+    assert(ctx.swapChain->generation() == generation + 1);
+    assert(ctx.swapChain->imageViews().size() == ctx.swapChain->imageCount());
+
+    // Nothing was submitted against the old chain, so it can go right away
+    ctx.logicalDevice->waitIdle();
+    destroyOld();
+
+    std::cout << "PASSED\n";
+}
+
 void test_renderpass_simple() {
     std::cout << "Testing: RenderPass simple creation... ";
 
@@ -216,6 +278,96 @@ void test_pipeline_layout_with_push_constants() {
 
     assert(layout != nullptr);
     assert(layout->handle() != VK_NULL_HANDLE);
+    assert(!layout->hasObjectPushConstants());
+
+    std::cout << "PASSED\n";
+}
+
+void test_pipeline_layout_object_push_constants() {
+    std::cout << "Testing: PipelineLayout with object push constants... ";
+
+    VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    auto layout = PipelineLayout::create(ctx.logicalDevice.get())
+        .addObjectPushConstants(stages)
+        .build();
+
+    assert(layout != nullptr);
+    assert(layout->hasObjectPushConstants());
+    assert(layout->objectPushConstantStages() == stages);
+
+    // Survives a move
+    PipelineLayout moved = std::move(*layout);
+    assert(moved.objectPushConstantStages() == stages);
+
+    std::cout << "PASSED\n";
+}
+
+void test_specialization_constants() {
+    std::cout << "Testing: Specialization constants... ";
+
+    SpecializationConstants constants;
+    assert(constants.empty());
+    constants.set(0, 4u)
+             .set(1, true)
+             .set(2, 0.5f)
+             .set(3, -2);
+
+    // Setting an ID again replaces its value in place
+    constants.set(0, 8u);
+    assert(constants.size() == 4);
+
+    VkSpecializationInfo info = constants.info();
+    assert(info.mapEntryCount == 4);
+    assert(info.dataSize == 4 * sizeof(uint32_t));
+    const auto* data = static_cast<const uint32_t*>(info.pData);
+    assert(data[info.pMapEntries[0].offset / 4] == 8u);
+    assert(data[info.pMapEntries[1].offset / 4] == VK_TRUE);
+    float half;
+    std::memcpy(&half, &data[info.pMapEntries[2].offset / 4], sizeof(float));
+    assert(half == 0.5f);
+    assert(static_cast<int32_t>(data[info.pMapEntries[3].offset / 4]) == -2);
+
+    SpecializationConstants overrides;
+    overrides.set(1, false).set(7, 16u);
+    constants.merge(overrides);
+    assert(constants.size() == 5);
+    info = constants.info();
+    assert(static_cast<const uint32_t*>(info.pData)[info.pMapEntries[1].offset / 4] == VK_FALSE);
+
+    std::cout << "PASSED\n";
+}
+
+void test_pipeline_state_key() {
+    std::cout << "Testing: Pipeline state keys and render pass compatibility... ";
+
+    VkFormat format = ctx.swapChain->format().format;
+    auto presentPass = RenderPass::createSimple(ctx.logicalDevice.get(), format,
+                                                VK_FORMAT_D32_SFLOAT, VK_SAMPLE_COUNT_1_BIT, true);
+    auto offscreenPass = RenderPass::createSimple(ctx.logicalDevice.get(), format,
+                                                  VK_FORMAT_D32_SFLOAT, VK_SAMPLE_COUNT_1_BIT, false);
+    auto colorOnlyPass = RenderPass::createSimple(ctx.logicalDevice.get(), format,
+                                                  VK_FORMAT_UNDEFINED, VK_SAMPLE_COUNT_1_BIT, true);
+
+    // Final layouts differ, attachments don't: pipelines are interchangeable
+    assert(presentPass->compatibilityHash() == offscreenPass->compatibilityHash());
+    assert(presentPass->compatibilityHash() != colorOnlyPass->compatibilityHash());
+
+    auto layout = PipelineLayout::create(ctx.logicalDevice.get()).build();
+    auto key = [&](RenderPass* pass, VkCullModeFlags cull, uint32_t lights) {
+        return GraphicsPipeline::create(ctx.logicalDevice.get(), pass, layout.get())
+            .enableDepth()
+            .cullMode(cull)
+            .constant(VK_SHADER_STAGE_FRAGMENT_BIT, 0, lights)
+            .stateKey();
+    };
+    auto base = key(presentPass.get(), VK_CULL_MODE_BACK_BIT, 4u);
+    assert(base == key(offscreenPass.get(), VK_CULL_MODE_BACK_BIT, 4u));
+    assert(base != key(colorOnlyPass.get(), VK_CULL_MODE_BACK_BIT, 4u));
+    assert(base != key(presentPass.get(), VK_CULL_MODE_NONE, 4u));
+    assert(base != key(presentPass.get(), VK_CULL_MODE_BACK_BIT, 8u));
+
+    // Nothing built shared yet
+    assert(ctx.logicalDevice->pipelineRegistry().size() == 0);
 
     std::cout << "PASSED\n";
 }
@@ -353,6 +505,347 @@ void test_descriptor_writer() {
     std::cout << "PASSED\n";
 }
 
+void test_descriptor_update_template() {
+    std::cout << "Testing: DescriptorUpdateTemplate... ";
+
+    auto layout = DescriptorSetLayout::create(ctx.logicalDevice.get())
+        .uniformBuffer(2, VK_SHADER_STAGE_FRAGMENT_BIT)
+        .uniformBuffer(0, VK_SHADER_STAGE_VERTEX_BIT)
+        .build();
+
+    const DescriptorUpdateTemplate* tmpl = layout->updateTemplate();
+    if (ctx.physicalDevice.capabilities().properties.apiVersion < VK_API_VERSION_1_1) {
+        assert(tmpl == nullptr);
+        std::cout << "SKIPPED (Vulkan 1.0 device)\n";
+        return;
+    }
+    assert(tmpl != nullptr);
+    assert(tmpl->handle() != VK_NULL_HANDLE);
+    assert(tmpl->descriptorCount() == 2);
+
+    // Packed in binding order, whatever the declaration order
+    assert(tmpl->indexOf(0) == 0);
+    assert(tmpl->indexOf(2) == 1);
+    bool threw = false;
+    try {
+        tmpl->indexOf(1);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    auto pool = DescriptorPool::create(ctx.logicalDevice.get())
+        .maxSets(1)
+        .poolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2)
+        .build();
+    VkDescriptorSet set = pool->allocate(layout.get());
+
+    auto uniformBuffer = Buffer::createUniformBuffer(ctx.logicalDevice.get(), 512);
+    std::vector<DescriptorInfo> data(tmpl->descriptorCount());
+    data[tmpl->indexOf(0)].buffer = {uniformBuffer->handle(), 0, 256};
+    data[tmpl->indexOf(2)].buffer = {uniformBuffer->handle(), 256, 256};
+    tmpl->update(set, data);
+
+    std::cout << "PASSED\n";
+}
+
+void test_descriptor_allocator() {
+    std::cout << "Testing: DescriptorAllocator and layout cache... ";
+
+    DescriptorLayoutCache cache(ctx.logicalDevice.get());
+    DescriptorSetLayout* first = cache.get({
+        {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr},
+        {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+    });
+    DescriptorSetLayout* second = cache.get({
+        {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr},
+        {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr},
+    });
+    assert(first == second);
+    assert(cache.size() == 1);
+
+    // A tiny first pool forces growth instead of failure
+    auto allocator = DescriptorAllocator::create(ctx.logicalDevice.get())
+        .setsPerPool(2)
+        .framesInFlight(2)
+        .transientSetsPerPool(2)
+        .build();
+
+    std::vector<VkDescriptorSet> sets;
+    for (int i = 0; i < 10; i++) {
+        sets.push_back(allocator->allocate(first));
+        assert(sets.back() != VK_NULL_HANDLE);
+    }
+    assert(allocator->poolCount() > 1);
+    assert(allocator->allocatedSets() == 10);
+
+    allocator->free(sets);
+    assert(allocator->allocatedSets() == 0);
+
+    // Transient pools grow within a frame and are reused after reset
+    allocator->beginFrame(0);
+    for (int i = 0; i < 5; i++) {
+        assert(allocator->allocateTransient(first) != VK_NULL_HANDLE);
+    }
+    size_t transientPools = allocator->transientPoolCount();
+    allocator->beginFrame(0);
+    for (int i = 0; i < 5; i++) {
+        allocator->allocateTransient(first);
+    }
+    assert(allocator->transientPoolCount() == transientPools);
+
+    std::cout << "PASSED\n";
+}
+
+void test_render_graph() {
+    std::cout << "Testing: RenderGraph culling, barriers and aliasing... ";
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+    auto target = Image::create(ctx.logicalDevice.get())
+        .extent(256, 256)
+        .format(VK_FORMAT_R8G8B8A8_UNORM)
+        .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .build();
+
+    RenderGraph graph(ctx.logicalDevice.get());
+    uint32_t executed = 0;
+    auto count = [&executed](RenderGraph::Context&) { executed++; };
+
+    for (int frame = 0; frame < 2; frame++) {
+        graph.reset();
+        GraphImageDesc desc{256, 256, VK_FORMAT_R8G8B8A8_UNORM};
+        auto a = graph.createImage("a", desc);
+        auto b = graph.createImage("b", desc);
+        auto c = graph.createImage("c", desc);
+        auto unused = graph.createImage("unused", desc);
+        auto output = graph.importImage("output", *target, VK_IMAGE_LAYOUT_UNDEFINED,
+                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        graph.addPass("first", count).write(a, GraphAccess::ColorAttachment);
+        graph.addPass("second", count)
+            .read(a, GraphAccess::SampledFragment)
+            .write(b, GraphAccess::ColorAttachment);
+        graph.addPass("third", count)
+            .read(b, GraphAccess::SampledFragment)
+            .write(c, GraphAccess::ColorAttachment);
+        graph.addPass("orphan", count).write(unused, GraphAccess::ColorAttachment);
+        graph.addPass("final", count)
+            .read(c, GraphAccess::SampledFragment)
+            .write(output, GraphAccess::ColorAttachment);
+
+        graph.compile();
+        assert(!graph.isActive("orphan"));
+        assert(graph.isActive("first"));
+
+        {
+            auto imm = cmdPool.beginImmediate();
+            graph.execute(imm.cmd());
+        }
+
+        const auto& stats = graph.stats();
+        assert(stats.passes == 4);
+        assert(stats.culledPasses == 1);
+        assert(stats.barriers >= 4);     // One batch per pass plus the final transition
+        // a and c never live at the same time
+        assert(stats.transientMemory < stats.transientRequested);
+    }
+    assert(executed == 8);
+    ctx.logicalDevice->graphicsQueue()->waitIdle();
+
+    std::cout << "PASSED\n";
+}
+
+void test_dynamic_rendering() {
+    std::cout << "Testing: RenderTarget dynamic rendering... ";
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+    auto color = Image::create(ctx.logicalDevice.get())
+        .extent(128, 128)
+        .format(VK_FORMAT_R8G8B8A8_UNORM)
+        .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .build();
+
+    auto target = RenderTarget::create(ctx.logicalDevice.get())
+        .colorAttachment(color)
+        .enableDepth()
+        .dynamicRendering()
+        .build();
+
+    // Without the extension the same target falls back to a render pass
+    bool dynamic = ctx.logicalDevice->supportsDynamicRendering();
+    assert(target->usesDynamicRendering() == dynamic);
+    assert((target->renderPass() == nullptr) == dynamic);
+    assert((target->framebufferCount() == 0) == dynamic);
+
+    {
+        auto imm = cmdPool.beginImmediate();
+        target->begin(imm.cmd(), {0.1f, 0.2f, 0.3f, 1.0f});
+        target->end(imm.cmd());
+        assert(imm.cmd().stats().renderPasses == 1);
+    }
+
+    target->recreate();
+    assert((target->framebufferCount() == 0) == dynamic);
+    ctx.logicalDevice->graphicsQueue()->waitIdle();
+
+    std::cout << "PASSED\n";
+}
+
+void test_multiview_target() {
+    std::cout << "Testing: RenderTarget depth-only and multiview... ";
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+    constexpr uint32_t kCascades = 4;
+    auto shadowMap = Image::create(ctx.logicalDevice.get())
+        .extent(256, 256)
+        .format(VK_FORMAT_D32_SFLOAT)
+        .usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .arrayLayers(kCascades)
+        .build();
+
+    // One layer: a plain depth-only shadow map target
+    auto single = RenderTarget::create(ctx.logicalDevice.get())
+        .depthAttachment(shadowMap)
+        .build();
+    assert(!single->hasColor());
+    assert(single->hasDepth());
+    assert(single->viewCount() == 1);
+
+    if (!ctx.logicalDevice->supportsMultiview()) {
+        bool threw = false;
+        try {
+            RenderTarget::create(ctx.logicalDevice.get()).depthAttachment(shadowMap).multiview(kCascades).build();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "PASSED (multiview unsupported)\n";
+        return;
+    }
+
+    auto cascades = RenderTarget::create(ctx.logicalDevice.get())
+        .depthAttachment(shadowMap)
+        .multiview(kCascades)
+        .build();
+    assert(cascades->viewCount() == kCascades);
+    assert(cascades->viewMask() == 0xF);
+
+    {
+        auto imm = cmdPool.beginImmediate();
+        cascades->begin(imm.cmd(), ClearColor{});
+        cascades->end(imm.cmd());
+        assert(imm.cmd().stats().renderPasses == 1);  // Every cascade in one pass
+    }
+
+    // Too few layers for the requested views
+    bool threw = false;
+    try {
+        RenderTarget::create(ctx.logicalDevice.get()).depthAttachment(shadowMap).multiview(kCascades + 1).build();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    ctx.logicalDevice->graphicsQueue()->waitIdle();
+
+    std::cout << "PASSED\n";
+}
+
+void test_sampled_depth_target() {
+    std::cout << "Testing: RenderTarget sampled depth and resume... ";
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+    auto color = Image::create(ctx.logicalDevice.get())
+        .extent(128, 128)
+        .format(VK_FORMAT_R8G8B8A8_UNORM)
+        .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+        .build();
+
+    auto target = RenderTarget::create(ctx.logicalDevice.get())
+        .colorAttachment(color)
+        .sampledDepth()
+        .build();
+    assert(target->hasDepth());
+    assert(target->storesDepth());
+    assert(target->depthImage() != nullptr);
+
+    {
+        // First pass, depth read between passes, second pass on top
+        auto imm = cmdPool.beginImmediate();
+        target->begin(imm.cmd(), {0.0f, 0.0f, 0.0f, 1.0f});
+        target->end(imm.cmd());
+        target->resume(imm.cmd());
+        target->end(imm.cmd());
+        assert(imm.cmd().stats().renderPasses == 2);
+    }
+
+    // A multisampled depth buffer can't be sampled as is
+    bool threw = false;
+    try {
+        RenderTarget::create(ctx.logicalDevice.get())
+            .colorAttachment(color)
+            .msaa(VK_SAMPLE_COUNT_4_BIT)
+            .sampledDepth()
+            .build();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    ctx.logicalDevice->graphicsQueue()->waitIdle();
+
+    std::cout << "PASSED\n";
+}
+
+void test_render_scale() {
+    std::cout << "Testing: RenderTarget render scale... ";
+
+    CommandPool cmdPool(ctx.logicalDevice.get(),
+                        ctx.logicalDevice->graphicsQueue(),
+                        CommandPoolFlags::Transient);
+    auto color = Image::create(ctx.logicalDevice.get())
+        .extent(101, 64)
+        .format(VK_FORMAT_R8G8B8A8_UNORM)
+        .usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+        .build();
+
+    auto target = RenderTarget::create(ctx.logicalDevice.get())
+        .colorAttachment(color)
+        .enableDepth()
+        .build();
+    assert(target->renderScale() == 1.0f);
+    assert(target->renderExtent().width == 101 && target->renderExtent().height == 64);
+
+    // Rounded up, attachments keep their size
+    target->setRenderScale(0.5f);
+    assert(target->renderExtent().width == 51 && target->renderExtent().height == 32);
+    assert(target->extent().width == 101 && target->extent().height == 64);
+
+    {
+        auto imm = cmdPool.beginImmediate();
+        target->begin(imm.cmd(), {0.0f, 0.0f, 0.0f, 1.0f});
+        target->end(imm.cmd());
+    }
+
+    bool threw = false;
+    try {
+        target->setRenderScale(0.0f);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(target->renderScale() == 0.5f);
+    ctx.logicalDevice->graphicsQueue()->waitIdle();
+
+    std::cout << "PASSED\n";
+}
+
 void test_swapchain_acquire() {
     std::cout << "Testing: SwapChain acquire... ";
 
@@ -435,6 +928,8 @@ int main() {
 
         // SwapChain tests
         test_swapchain_creation();
+        test_swapchain_present_mode();
+        test_swapchain_recreate_deferred();
         test_swapchain_acquire();
 
         // RenderPass tests
@@ -449,7 +944,10 @@ int main() {
         // Pipeline layout tests
         test_pipeline_layout_empty();
         test_pipeline_layout_with_push_constants();
+        test_pipeline_layout_object_push_constants();
         test_pipeline_layout_with_descriptor();
+        test_specialization_constants();
+        test_pipeline_state_key();
 
         // Synchronization tests
         test_semaphore();
@@ -461,6 +959,17 @@ int main() {
         test_descriptor_pool();
         test_descriptor_allocation();
         test_descriptor_writer();
+        test_descriptor_update_template();
+        test_descriptor_allocator();
+
+        // Render graph
+        test_render_graph();
+
+        // Render targets
+        test_dynamic_rendering();
+        test_multiview_target();
+        test_sampled_depth_target();
+        test_render_scale();
 
         // Move semantics
         test_move_semantics();
@@ -5,19 +5,60 @@
  * This test verifies:
  * - Texture loading from memory
  * - Mesh building with vertex attributes
+ * - Compact (quantized) vertex encodings
  * - Vertex deduplication
+ * - Binary mesh cache round trip and OBJ cache invalidation
+ * - AssetPack entries, alignment and loading from the mapping
+ * - MeshOptimizer vertex cache, overdraw and vertex fetch passes
+ * - Mesh LOD chain generation and cache round trip
+ * - Meshlet generation, bounds and normal cones
  * - UniformBuffer creation and update
+ * - UniformBuffer versioned updates skipping unchanged data
+ * - UniformRing dynamic offset allocation
+ * - BindlessTable slot allocation, double-remove rejection and non-throwing release on destruction
+ * - TextureStreamer placeholder and failure handling
+ * - AssetLoader async textures and meshes
+ * - TextureContainer KTX2/DDS parsing and compressed upload
+ * - MipGenerator image requirements and per-level views
+ * - VirtualTexture configuration and pinned top-level page
+ * - TextureArrayBuilder layers and TextureAtlasBuilder packing
  * - FormatUtils functions
  * - SimpleRenderer creation (requires window)
+ * - HeadlessRenderer frame ring without a swap chain
+ * - ImageReadback delivery through callbacks and futures
+ * - BoundsSoA SIMD frustum culling against AABB::intersectsFrustum (with finevk-engine)
+ * - DeferredDisposer delays past the bucket ring, conditions, concurrent producers,
+ *   heap-stored deleters, disposeAll() and destruction (with finevk-engine)
+ * - JobSystem parallelFor coverage, nesting, exceptions and shutdown (with finevk-engine)
+ * - radixSort stability, float keys and skipped passes; insertionSortBounded budget (with finevk-engine)
  */
 
 #include <finevk/finevk.hpp>
+#if defined(FINEVK_TEST_ENGINE)
+#include <finevk/engine/frustum_cull.hpp>
+#include <finevk/engine/deferred_disposer.hpp>
+#include <finevk/engine/job_system.hpp>
+#include <finevk/engine/radix_sort.hpp>
+#endif
 
 #include <GLFW/glfw3.h>
 
 #include <iostream>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 using namespace finevk;
 
@@ -59,6 +100,7 @@ void setup_test_context() {
         .surface(ctx.window->surface())
         .addExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME)
         .enableAnisotropy()
+        .enableDescriptorIndexing()
         .build();
 
     // Bind device to window (creates swap chain and sync objects)
@@ -171,6 +213,136 @@ void test_format_utils_component_count() {
     std::cout << "PASSED\n";
 }
 
+void test_format_utils_block_sizes() {
+    std::cout << "Test: FormatUtils - Compressed block sizes... ";
+
+    assert(FormatUtils::isCompressed(VK_FORMAT_BC7_SRGB_BLOCK));
+    assert(FormatUtils::isCompressed(VK_FORMAT_ASTC_6x6_UNORM_BLOCK));
+    assert(!FormatUtils::isCompressed(VK_FORMAT_R8G8B8A8_SRGB));
+
+    assert(FormatUtils::blockExtent(VK_FORMAT_BC1_RGBA_UNORM_BLOCK).width == 4);
+    assert(FormatUtils::blockExtent(VK_FORMAT_ASTC_8x5_SRGB_BLOCK).width == 8);
+    assert(FormatUtils::blockExtent(VK_FORMAT_ASTC_8x5_SRGB_BLOCK).height == 5);
+    assert(FormatUtils::blockExtent(VK_FORMAT_R8G8B8A8_UNORM).width == 1);
+
+    assert(FormatUtils::bytesPerBlock(VK_FORMAT_BC1_RGB_UNORM_BLOCK) == 8);
+    assert(FormatUtils::bytesPerBlock(VK_FORMAT_BC4_UNORM_BLOCK) == 8);
+    assert(FormatUtils::bytesPerBlock(VK_FORMAT_BC7_UNORM_BLOCK) == 16);
+    assert(FormatUtils::bytesPerBlock(VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK) == 8);
+    assert(FormatUtils::bytesPerBlock(VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK) == 16);
+    assert(FormatUtils::bytesPerBlock(VK_FORMAT_ASTC_12x12_SRGB_BLOCK) == 16);
+    assert(FormatUtils::bytesPerBlock(VK_FORMAT_R8G8B8A8_UNORM) == 4);
+
+    // Partial blocks round up; small mips still take one whole block
+    assert(FormatUtils::levelSize(VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 256, 256) == 64 * 64 * 8);
+    assert(FormatUtils::levelSize(VK_FORMAT_BC7_UNORM_BLOCK, 5, 3) == 2 * 1 * 16);
+    assert(FormatUtils::levelSize(VK_FORMAT_BC7_UNORM_BLOCK, 1, 1) == 16);
+    assert(FormatUtils::levelSize(VK_FORMAT_ASTC_6x6_UNORM_BLOCK, 12, 13) == 2 * 3 * 16);
+    assert(FormatUtils::levelSize(VK_FORMAT_R8G8B8A8_UNORM, 4, 2) == 32);
+
+    std::cout << "PASSED\n";
+}
+
+// ============================================================================
+// TextureContainer Tests
+// ============================================================================
+
+// Minimal uncompressed KTX2: no DFD/KVD, levels stored smallest first
+static std::vector<uint8_t> make_test_ktx2(VkFormat format, uint32_t width, uint32_t height,
+                                           uint32_t levels) {
+    const uint8_t identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB,
+                                    0x0D, 0x0A, 0x1A, 0x0A};
+    std::vector<uint8_t> file(80 + 24 * levels);
+    std::memcpy(file.data(), identifier, sizeof(identifier));
+    uint32_t header[9] = {static_cast<uint32_t>(format), 1, width, height, 0, 0, 1, levels, 0};
+    std::memcpy(file.data() + 12, header, sizeof(header));
+
+    for (uint32_t i = levels; i-- > 0;) {
+        uint64_t size = FormatUtils::levelSize(format, std::max(1u, width >> i),
+                                               std::max(1u, height >> i));
+        uint64_t entry[3] = {file.size(), size, size};
+        std::memcpy(file.data() + 80 + 24 * i, entry, sizeof(entry));
+        file.resize(file.size() + size, static_cast<uint8_t>(0x10 * (i + 1)));
+    }
+    return file;
+}
+
+void test_texture_container_parsing() {
+    std::cout << "Test: TextureContainer - KTX2 and DDS parsing... ";
+
+    // KTX2 BC7, 8x4 with 3 levels: 2x1, 1x1, 1x1 blocks
+    auto ktx = TextureContainer::fromMemory(make_test_ktx2(VK_FORMAT_BC7_SRGB_BLOCK, 8, 4, 3));
+    assert(ktx.format == VK_FORMAT_BC7_SRGB_BLOCK);
+    assert(ktx.width == 8 && ktx.height == 4);
+    assert(ktx.mipLevels() == 3);
+    assert(ktx.levels[0].size == 32);
+    assert(ktx.levels[2].width == 2 && ktx.levels[2].height == 1 && ktx.levels[2].size == 16);
+    assert(ktx.levelData(1)[0] == 0x20);
+    assert(ktx.dataSize() == 64);
+
+    // Supercompressed KTX2 is rejected
+    auto zstd = make_test_ktx2(VK_FORMAT_BC7_SRGB_BLOCK, 8, 4, 1);
+    zstd[44] = 2;
+    bool threw = false;
+    try {
+        TextureContainer::fromMemory(zstd);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Legacy DXT5 DDS, 4x4 with 2 levels
+    std::vector<uint8_t> dds(128 + 16 + 16, 0);
+    uint32_t magic = 0x20534444;  // "DDS "
+    uint32_t headerSize = 124, height = 4, width = 4, mips = 2;
+    uint32_t pfFlags = 0x4, fourcc = 0x35545844;  // "DXT5"
+    std::memcpy(&dds[0], &magic, 4);
+    std::memcpy(&dds[4], &headerSize, 4);
+    std::memcpy(&dds[12], &height, 4);
+    std::memcpy(&dds[16], &width, 4);
+    std::memcpy(&dds[28], &mips, 4);
+    std::memcpy(&dds[80], &pfFlags, 4);
+    std::memcpy(&dds[84], &fourcc, 4);
+
+    auto bc3 = TextureContainer::fromMemory(dds, false);
+    assert(bc3.format == VK_FORMAT_BC3_UNORM_BLOCK);
+    assert(bc3.mipLevels() == 2);
+    assert(bc3.levels[1].offset == 144 && bc3.levels[1].size == 16);
+    assert(TextureContainer::fromMemory(dds, true).format == VK_FORMAT_BC3_SRGB_BLOCK);
+
+    // Level counts beyond the mip chain and zero widths are rejected from the header
+    auto rejects = [](std::vector<uint8_t> bytes) {
+        try {
+            TextureContainer::fromMemory(std::move(bytes));
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    auto hugeDds = dds;
+    uint32_t hugeMips = 0xFFFFFFFFu;
+    std::memcpy(&hugeDds[28], &hugeMips, 4);
+    assert(rejects(hugeDds));
+    auto longDds = dds;
+    uint32_t longMips = 4;  // 4x4 has 3 levels
+    std::memcpy(&longDds[28], &longMips, 4);
+    assert(rejects(longDds));
+
+    auto longKtx = make_test_ktx2(VK_FORMAT_BC7_SRGB_BLOCK, 8, 4, 4);  // Full chain: 8, 4, 2, 1
+    assert(TextureContainer::fromMemory(longKtx).mipLevels() == 4);
+    longKtx[40] = 5;
+    assert(rejects(longKtx));
+    auto flatKtx = make_test_ktx2(VK_FORMAT_BC7_SRGB_BLOCK, 8, 4, 1);
+    std::memset(&flatKtx[20], 0, 4);
+    assert(rejects(flatKtx));
+
+    assert(TextureContainer::isContainerPath("textures/rock.KTX2"));
+    assert(TextureContainer::isContainerPath("rock.dds"));
+    assert(!TextureContainer::isContainerPath("rock.png"));
+
+    std::cout << "PASSED\n";
+}
+
 // ============================================================================
 // Vertex Tests
 // ============================================================================
@@ -197,6 +369,44 @@ void test_vertex_stride() {
         VertexAttribute::TexCoord | VertexAttribute::Color | VertexAttribute::Tangent);
     assert(stride4 == sizeof(glm::vec3) * 3 + sizeof(glm::vec2) + sizeof(glm::vec4));  // 56 bytes
 
+    // Compact encodings halve the common layout; encodings alone add nothing
+    auto common = VertexAttribute::Position | VertexAttribute::Normal | VertexAttribute::TexCoord;
+    assert(Vertex::stride(common | VertexAttribute::Compact) == 16);
+    assert(Vertex::stride(VertexAttribute::Position | VertexAttribute::OctNormal) == sizeof(glm::vec3));
+
+    std::cout << "PASSED\n";
+}
+
+void test_vertex_compact_encodings() {
+    std::cout << "Test: Vertex - Compact encodings... ";
+
+    auto attrs = VertexAttribute::Position | VertexAttribute::Normal |
+                 VertexAttribute::TexCoord | VertexAttribute::Color | VertexAttribute::Compact;
+    auto descs = Vertex::attributeDescriptions(attrs);
+    assert(descs.size() == 4);
+    assert(descs[0].format == VK_FORMAT_R16G16B16A16_UNORM && descs[0].offset == 0);
+    assert(descs[1].format == VK_FORMAT_R16G16_SNORM && descs[1].offset == 8);
+    assert(descs[2].format == VK_FORMAT_R16G16_SFLOAT && descs[2].offset == 12);
+    assert(descs[3].format == VK_FORMAT_R8G8B8A8_UNORM && descs[3].offset == 16);
+    assert(Vertex::stride(attrs) == 20);
+
+    auto builder = Mesh::create(ctx.logicalDevice.get()).attributes(attrs);
+    Vertex v0{}, v1{}, v2{};
+    v0.position = {-2.0f, 0.0f, 1.0f};
+    v1.position = {2.0f, 4.0f, 1.0f};
+    v2.position = {0.0f, 1.0f, 3.0f};
+    builder.addTriangle(v0, v1, v2);
+    auto mesh = builder.build(ctx.commandPool.get());
+
+    // Unit cube corners map back to the bounds
+    glm::mat4 dequantize = mesh->dequantizeTransform();
+    assert(glm::vec3(dequantize * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)) == glm::vec3(-2.0f, 0.0f, 1.0f));
+    assert(glm::vec3(dequantize * glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)) == glm::vec3(2.0f, 4.0f, 3.0f));
+
+    auto floats = Mesh::create(ctx.logicalDevice.get()).attributes(VertexAttribute::Position);
+    floats.addTriangle(v0, v1, v2);
+    assert(floats.build(ctx.commandPool.get())->dequantizeTransform() == glm::mat4(1.0f));
+
     std::cout << "PASSED\n";
 }
 
@@ -332,6 +542,342 @@ void test_mesh_builder_deduplication() {
     assert(builder.vertexCount() == 3);
     assert(builder.indexCount() == 6);
 
+    // Same position, different color is a different vertex
+    Vertex tinted = v0;
+    tinted.color = {1.0f, 0.0f, 0.0f};
+    builder.addTriangle(tinted, v1, v2);
+    assert(builder.vertexCount() == 4);
+
+    // Enough vertices to grow the table several times, each added twice
+    auto grid = Mesh::create(ctx.logicalDevice.get())
+        .attributes(VertexAttribute::Position)
+        .enableDeduplication(true)
+        .reserve(16);
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < 1000; i++) {
+            Vertex v{};
+            v.position = {static_cast<float>(i % 40), static_cast<float>(i / 40), 0.0f};
+            assert(grid.addUniqueVertex(v) == static_cast<uint32_t>(i));
+        }
+    }
+    assert(grid.vertexCount() == 1000);
+
+    std::cout << "PASSED\n";
+}
+
+void test_mesh_cache() {
+    std::cout << "Test: Mesh cache - Write, map and invalidate... ";
+
+    auto dir = std::filesystem::temp_directory_path() / "finevk_test_mesh_cache";
+    std::filesystem::create_directories(dir);
+
+    // Explicit cache of a built mesh
+    auto builder = Mesh::create(ctx.logicalDevice.get())
+        .attributes(VertexAttribute::Position | VertexAttribute::TexCoord);
+    Vertex v0{}, v1{}, v2{};
+    v0.position = {0.0f, 2.0f, 0.0f};
+    v1.position = {-1.0f, -1.0f, 0.0f};
+    v2.position = {1.0f, -1.0f, 3.0f};
+    builder.addTriangle(v0, v1, v2);
+    std::string cachePath = (dir / "triangle.fvkmesh").string();
+    builder.writeCache(cachePath);
+
+    auto mesh = Mesh::fromCache(ctx.logicalDevice.get(), cachePath, ctx.commandPool.get());
+    assert(mesh->indexCount() == 3);
+    assert(mesh->indexType() == VK_INDEX_TYPE_UINT16);
+    assert(mesh->attributes() == (VertexAttribute::Position | VertexAttribute::TexCoord));
+    assert(mesh->boundsMin() == glm::vec3(-1.0f, -1.0f, 0.0f));
+    assert(mesh->boundsMax() == glm::vec3(1.0f, 2.0f, 3.0f));
+
+    // Automatic cache beside an OBJ
+    std::string objPath = (dir / "quad.obj").string();
+    {
+        std::ofstream obj(objPath);
+        obj << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3\nf 1 3 4\n";
+    }
+    std::string objCache = objPath + Mesh::CacheExtension;
+    std::filesystem::remove(objCache);
+
+    auto first = Mesh::load(ctx.logicalDevice.get(), ctx.commandPool.get(), objPath)
+        .attributes(VertexAttribute::Position)
+        .cache()
+        .build();
+    assert(std::filesystem::exists(objCache));
+    auto second = Mesh::load(ctx.logicalDevice.get(), ctx.commandPool.get(), objPath)
+        .attributes(VertexAttribute::Position)
+        .cache()
+        .build();
+    assert(second->indexCount() == first->indexCount());
+    assert(second->boundsMax() == first->boundsMax());
+
+    // Garbage is rejected rather than uploaded
+    {
+        std::ofstream bad(cachePath, std::ios::binary | std::ios::trunc);
+        bad << "not a mesh";
+    }
+    bool threw = false;
+    try {
+        Mesh::fromCache(ctx.logicalDevice.get(), cachePath, ctx.commandPool.get());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::filesystem::remove_all(dir);
+    std::cout << "PASSED\n";
+}
+
+void test_asset_pack() {
+    std::cout << "Test: AssetPack - Write, map and load entries... ";
+
+    auto dir = std::filesystem::temp_directory_path() / "finevk_test_asset_pack";
+    std::filesystem::create_directories(dir);
+
+    auto builder = Mesh::create(ctx.logicalDevice.get())
+        .attributes(VertexAttribute::Position);
+    Vertex v0{}, v1{}, v2{};
+    v0.position = {0.0f, 1.0f, 0.0f};
+    v1.position = {-1.0f, -1.0f, 0.0f};
+    v2.position = {1.0f, -1.0f, 0.0f};
+    builder.addTriangle(v0, v1, v2);
+    std::string meshPath = (dir / "triangle.fvkmesh").string();
+    builder.writeCache(meshPath);
+
+    auto ktx = make_test_ktx2(VK_FORMAT_R8G8B8A8_UNORM, 4, 4, 1);
+    const char raw[] = "hello";
+
+    std::string packPath = (dir / (std::string("assets") + AssetPack::Extension)).string();
+    AssetPack::Writer()
+        .add("triangle", AssetPack::Kind::Mesh, meshPath)
+        .add("checker", AssetPack::Kind::Texture, ktx.data(), ktx.size())
+        .add("greeting", AssetPack::Kind::Raw, raw, sizeof(raw))
+        .write(packPath);
+
+    AssetPack pack(packPath);
+    assert(pack.size() == 3);
+    assert(pack.entries()[0].name == "triangle");
+    assert(!pack.contains("missing"));
+    for (const auto& entry : pack.entries()) {
+        auto offset = static_cast<size_t>(entry.bytes.data - pack.entries()[0].bytes.data);
+        assert(offset % AssetPack::EntryAlignment == 0);
+    }
+
+    const auto& greeting = pack.entry("greeting");
+    assert(greeting.kind == AssetPack::Kind::Raw);
+    assert(greeting.bytes.size == sizeof(raw));
+    assert(std::memcmp(greeting.bytes.data, raw, sizeof(raw)) == 0);
+
+    // Loaders read straight from the mapping
+    auto mesh = Mesh::fromPack(ctx.logicalDevice.get(), pack, "triangle", ctx.commandPool.get());
+    assert(mesh->indexCount() == 3);
+    assert(mesh->boundsMax() == glm::vec3(1.0f, 1.0f, 0.0f));
+
+    auto texture = Texture::fromPack(ctx.logicalDevice.get(), pack, "checker", ctx.commandPool.get());
+    assert(texture->width() == 4 && texture->height() == 4);
+    assert(texture->format() == VK_FORMAT_R8G8B8A8_UNORM);
+
+    // Wrong kind and missing entries are rejected
+    bool threw = false;
+    try {
+        Mesh::fromPack(ctx.logicalDevice.get(), pack, "checker", ctx.commandPool.get());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    threw = false;
+    try {
+        pack.entry("missing");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::filesystem::remove_all(dir);
+    std::cout << "PASSED\n";
+}
+
+void test_mesh_optimizer() {
+    std::cout << "Test: MeshOptimizer - Cache reordering and vertex fetch... ";
+
+    // 32x32 grid with its triangles in scrambled order
+    const uint32_t n = 32;
+    std::vector<Vertex> vertices;
+    for (uint32_t y = 0; y <= n; y++) {
+        for (uint32_t x = 0; x <= n; x++) {
+            Vertex v{};
+            v.position = {static_cast<float>(x), static_cast<float>(y), 0.0f};
+            vertices.push_back(v);
+        }
+    }
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < n * n; i++) {
+        uint32_t cell = (i * 389) % (n * n);  // 389 is coprime with 1024
+        uint32_t a = (cell / n) * (n + 1) + cell % n;
+        uint32_t quad[6] = {a, a + 1, a + n + 2, a, a + n + 2, a + n + 1};
+        indices.insert(indices.end(), quad, quad + 6);
+    }
+    std::vector<uint32_t> original = indices;
+
+    float before = MeshOptimizer::acmr(indices, vertices.size());
+    MeshOptimizer::optimizeVertexCache(indices, vertices.size());
+    MeshOptimizer::optimizeOverdraw(indices, vertices);
+    float after = MeshOptimizer::acmr(indices, vertices.size());
+    assert(before >= 2.0f);  // Only the two halves of each quad share vertices
+    assert(after < 1.0f);
+
+    // Fetch order: first use is sequential, triangles are unchanged
+    std::vector<Vertex> reordered = vertices;
+    std::vector<uint32_t> remapped = indices;
+    MeshOptimizer::optimizeVertexFetch(remapped, reordered);
+    assert(reordered.size() == vertices.size());
+    uint32_t nextNew = 0;
+    for (size_t i = 0; i < remapped.size(); i++) {
+        assert(remapped[i] <= nextNew);
+        if (remapped[i] == nextNew) {
+            nextNew++;
+        }
+        assert(reordered[remapped[i]].position == vertices[indices[i]].position);
+    }
+    assert(MeshOptimizer::acmr(remapped, reordered.size()) == after);
+    std::vector<uint32_t> sortedOriginal = original;
+    std::sort(sortedOriginal.begin(), sortedOriginal.end());
+    std::sort(indices.begin(), indices.end());
+    assert(sortedOriginal == indices);
+
+    // Builder stage reports both measurements
+    auto builder = Mesh::create(ctx.logicalDevice.get())
+        .attributes(VertexAttribute::Position)
+        .optimize();
+    for (const auto& v : vertices) {
+        builder.addVertex(v);
+    }
+    builder.addIndices(original);
+    auto mesh = builder.build(ctx.commandPool.get());
+    assert(mesh->indexCount() == original.size());
+    assert(builder.acmrAfter() > 0.0f && builder.acmrAfter() < builder.acmrBefore());
+
+    std::cout << "PASSED\n";
+}
+
+void test_mesh_lods() {
+    std::cout << "Test: Mesh LODs - Simplification and index ranges... ";
+
+    // Flat grid: interior collapses cost nothing, the border stays put
+    const uint32_t n = 16;
+    std::vector<Vertex> grid;
+    for (uint32_t y = 0; y <= n; y++) {
+        for (uint32_t x = 0; x <= n; x++) {
+            Vertex v{};
+            v.position = {static_cast<float>(x), 0.0f, static_cast<float>(y)};
+            grid.push_back(v);
+        }
+    }
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < n; y++) {
+        for (uint32_t x = 0; x < n; x++) {
+            uint32_t a = y * (n + 1) + x;
+            uint32_t quad[6] = {a, a + n + 1, a + 1, a + 1, a + n + 1, a + n + 2};
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+    float error = -1.0f;
+    auto simplified = MeshOptimizer::simplify(indices, grid, indices.size() / 4, 0.01f, &error);
+    assert(simplified.size() % 3 == 0);
+    assert(simplified.size() < indices.size() / 2);
+    assert(error >= 0.0f && error < 1e-3f);
+
+    // Builder appends the levels after level 0
+    auto builder = Mesh::create(ctx.logicalDevice.get())
+        .attributes(VertexAttribute::Position)
+        .generateLods(3, 0.5f, 0.1f);
+    for (const auto& v : grid) {
+        builder.addVertex(v);
+    }
+    builder.addIndices(indices);
+    auto mesh = builder.build(ctx.commandPool.get());
+    assert(mesh->lodCount() >= 2);
+    assert(mesh->indexCount() == indices.size());
+    assert(mesh->lod(0).firstIndex == 0 && mesh->lod(0).indexCount == indices.size());
+    assert(mesh->lod(1).firstIndex == indices.size());
+    assert(mesh->lod(1).indexCount < mesh->lod(0).indexCount);
+    assert(mesh->lod(99).indexCount == mesh->lod(mesh->lodCount() - 1).indexCount);
+
+    // Levels survive the binary cache
+    auto dir = std::filesystem::temp_directory_path() / "finevk_test_mesh_lods";
+    std::filesystem::create_directories(dir);
+    std::string cachePath = (dir / "grid.fvkmesh").string();
+    builder.writeCache(cachePath);
+    auto cached = Mesh::fromCache(ctx.logicalDevice.get(), cachePath, ctx.commandPool.get());
+    assert(cached->lodCount() == mesh->lodCount());
+    assert(cached->lod(1).indexCount == mesh->lod(1).indexCount);
+    assert(cached->indexCount() == mesh->indexCount());
+    std::filesystem::remove_all(dir);
+
+    std::cout << "PASSED\n";
+}
+
+void test_mesh_meshlets() {
+    std::cout << "Test: Meshlets - Limits, coverage and cone culling... ";
+
+    // Flat grid facing +Y
+    const uint32_t n = 32;
+    std::vector<Vertex> grid;
+    for (uint32_t y = 0; y <= n; y++) {
+        for (uint32_t x = 0; x <= n; x++) {
+            Vertex v{};
+            v.position = {static_cast<float>(x), 0.0f, static_cast<float>(y)};
+            v.normal = {0.0f, 1.0f, 0.0f};
+            grid.push_back(v);
+        }
+    }
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < n; y++) {
+        for (uint32_t x = 0; x < n; x++) {
+            uint32_t a = y * (n + 1) + x;
+            uint32_t quad[6] = {a, a + n + 1, a + 1, a + 1, a + n + 1, a + n + 2};
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+    MeshOptimizer::optimizeVertexCache(indices, grid.size());
+
+    auto result = MeshOptimizer::buildMeshlets(indices, grid);
+    assert(result.bounds.size() == result.meshlets.size());
+    size_t triangles = 0;
+    for (const auto& meshlet : result.meshlets) {
+        assert(meshlet.vertexCount <= MeshOptimizer::DefaultMeshletVertices);
+        assert(meshlet.triangleCount <= MeshOptimizer::DefaultMeshletTriangles);
+        // Local indices resolve back to the original triangles, in order
+        for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++) {
+            uint32_t local = result.triangles[meshlet.triangleOffset * 3 + i];
+            assert(local < meshlet.vertexCount);
+            assert(result.vertices[meshlet.vertexOffset + local] == indices[meshlet.triangleOffset * 3 + i]);
+        }
+        triangles += meshlet.triangleCount;
+    }
+    assert(triangles * 3 == indices.size());
+    assert(result.meshlets.size() < indices.size() / 3 / 64);
+
+    // A flat patch is culled from below, never from above
+    const auto& bounds = result.bounds[0];
+    assert(bounds.radius > 0.0f);
+    assert(bounds.coneAxis.y > 0.99f && bounds.coneCutoff < 0.01f);
+    for (float height : {100.0f, -100.0f}) {
+        glm::vec3 toCenter = bounds.center - glm::vec3(bounds.center.x, height, bounds.center.z);
+        bool culled = glm::dot(toCenter, bounds.coneAxis) >=
+                      bounds.coneCutoff * glm::length(toCenter) + bounds.radius;
+        assert(culled == (height < 0.0f));
+    }
+
+    // Without mesh shading the builder keeps the indexed path
+    auto builder = Mesh::create(ctx.logicalDevice.get()).meshlets();
+    for (const auto& v : grid) {
+        builder.addVertex(v);
+    }
+    builder.addIndices(indices);
+    auto mesh = builder.build(ctx.commandPool.get());
+    assert(mesh->hasMeshlets() == ctx.logicalDevice->supportsMeshShading());
+    assert(mesh->indexCount() == indices.size());
+
     std::cout << "PASSED\n";
 }
 
@@ -481,6 +1027,28 @@ void test_uniform_buffer_update() {
     std::cout << "PASSED\n";
 }
 
+void test_uniform_buffer_versioned_update() {
+    std::cout << "Test: UniformBuffer - Versioned update... ";
+
+    auto ub = UniformBuffer<MVPUniform>::create(ctx.logicalDevice.get(), 2);
+    MVPUniform data{};
+
+    // Each frame copy uploads once per version
+    assert(ub->update(0, data, 1));
+    assert(!ub->update(0, data, 1));
+    assert(ub->update(1, data, 1));
+    assert(ub->update(0, data, 2));
+    assert(!ub->update(2, data, 3));  // Out of range
+
+    // Version 0 (unversioned) always uploads, and so does the next version after it
+    assert(ub->update(0, data, 0));
+    assert(ub->update(0, data, 0));
+    ub->update(1, data);
+    assert(ub->update(1, data, 1));
+
+    std::cout << "PASSED\n";
+}
+
 void test_uniform_buffer_common_types() {
     std::cout << "Test: UniformBuffer - Common uniform types... ";
 
@@ -494,10 +1062,361 @@ void test_uniform_buffer_common_types() {
     std::cout << "PASSED\n";
 }
 
+void test_uniform_ring() {
+    std::cout << "Test: UniformRing - Aligned per-frame allocation... ";
+
+    auto ring = UniformRing::create(ctx.logicalDevice.get())
+        .frameSize(4096)
+        .framesInFlight(2)
+        .build();
+
+    VkDeviceSize alignment = ring->alignment();
+    assert(ring->frameSize() % alignment == 0);
+    assert(ring->buffer()->size() == ring->frameSize() * 2);
+
+    // Offsets are aligned, increasing, and inside the frame's region
+    ring->beginFrame(1);
+    uint32_t first = ring->push(glm::mat4(1.0f));
+    uint32_t second = ring->push(glm::mat4(2.0f));
+    assert(first == ring->frameSize());
+    assert(second % alignment == 0);
+    assert(second >= first + sizeof(glm::mat4));
+    assert(ring->used() == second + ((sizeof(glm::mat4) + alignment - 1) / alignment * alignment) - first);
+
+    // Starting the frame again rewinds its region
+    ring->beginFrame(1);
+    assert(ring->used() == 0);
+    assert(ring->push(glm::mat4(1.0f)) == first);
+
+    // Exhausting a region throws
+    bool threw = false;
+    try {
+        ring->allocate(ring->frameSize() + 1);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    auto info = ring->descriptorInfo(sizeof(glm::mat4));
+    assert(info.buffer == ring->buffer()->handle());
+    assert(info.offset == 0);
+    assert(info.range == sizeof(glm::mat4));
+
+    std::cout << "PASSED\n";
+}
+
+void test_texture_streamer() {
+    std::cout << "Test: TextureStreamer - Placeholder until loaded... ";
+
+    auto uploads = UploadManager::create(ctx.logicalDevice.get()).build();
+    auto streamer = TextureStreamer::create(ctx.logicalDevice.get(), uploads.get())
+        .commandPool(ctx.commandPool.get())
+        .build();
+
+    // Missing files fail without throwing and keep the placeholder
+    auto missing = streamer->load("does_not_exist.png");
+    assert(!missing->isReady());
+    assert(missing->texture() == streamer->placeholder());
+    assert(streamer->pendingCount() == 1);
+
+    streamer->waitIdle();
+    assert(missing->failed());
+    assert(!missing->isReady());
+    assert(missing->texture() == streamer->placeholder());
+    assert(streamer->pendingCount() == 0);
+
+    std::cout << "PASSED\n";
+}
+
+void test_asset_loader() {
+    std::cout << "Test: AssetLoader - Async textures and meshes... ";
+
+    auto uploads = UploadManager::create(ctx.logicalDevice.get()).build();
+    auto loader = AssetLoader::create(ctx.logicalDevice.get(), uploads.get()).build();
+
+    // Memory sources are copied, so the pixels can go away right after
+    std::vector<uint8_t> pixels(8 * 8 * 4, 200);
+    auto texture = Texture::load(ctx.logicalDevice.get(), ctx.commandPool.get(), pixels.data(), 8, 8)
+        .generateMipmaps()
+        .srgb()
+        .buildAsync(*loader);
+    pixels.clear();
+
+    Vertex v0{}, v1{}, v2{};
+    v0.position = {0.0f, 0.5f, 0.0f};
+    v1.position = {-0.5f, -0.5f, 0.0f};
+    v2.position = {0.5f, -0.5f, 0.0f};
+    auto mesh = Mesh::create(ctx.logicalDevice.get())
+        .attributes(VertexAttribute::Position)
+        .addTriangle(v0, v1, v2)
+        .buildAsync(*loader);
+
+    // Missing files fail without throwing
+    auto missing = Texture::load(ctx.logicalDevice.get(), ctx.commandPool.get(), "does_not_exist.png")
+        .buildAsync(*loader);
+
+    bool meshCallback = false;
+    mesh->onReady([&](const MeshRef& m) { meshCallback = m != nullptr; });
+    assert(!texture->isReady() && texture->get() == nullptr);
+    assert(loader->pendingCount() == 3);
+
+    loader->waitIdle();
+    assert(loader->pendingCount() == 0);
+
+    assert(texture->isReady() && !texture->failed());
+    assert(texture->get()->width() == 8);
+    assert(texture->get()->mipLevels() == 4);
+    assert(texture->get()->format() == VK_FORMAT_R8G8B8A8_SRGB);
+
+    assert(mesh->isReady() && meshCallback);
+    assert(mesh->get()->indexCount() == 3);
+
+    assert(missing->failed() && !missing->isReady());
+    assert(missing->get() == nullptr);
+    assert(!missing->error().empty());
+    assert(missing->path() == "does_not_exist.png");
+
+    std::cout << "PASSED\n";
+}
+
+void test_bindless_table() {
+    std::cout << "Test: BindlessTable - Material slot allocation... ";
+
+    if (!ctx.logicalDevice->enabledVulkan12Features().descriptorIndexing) {
+        // Without descriptor indexing the table refuses to build
+        bool threw = false;
+        try {
+            BindlessTable::create(ctx.logicalDevice.get()).build();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "SKIPPED (no descriptor indexing)\n";
+        return;
+    }
+
+    auto table = BindlessTable::create(ctx.logicalDevice.get())
+        .maxTextures(64)
+        .materials<glm::vec4>(2)
+        .build();
+
+    assert(table->layout() != nullptr);
+    assert(table->descriptorSet() != VK_NULL_HANDLE);
+    assert(table->maxTextures() <= 64);
+    assert(table->materialStride() == sizeof(glm::vec4));
+
+    uint32_t first = table->addMaterial(glm::vec4(1.0f));
+    uint32_t second = table->addMaterial(glm::vec4(2.0f));
+    assert(first == 0 && second == 1);
+
+    // Full until a slot is returned, which is then reused
+    bool threw = false;
+    try {
+        table->addMaterial(glm::vec4(3.0f));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    table->removeMaterial(first);
+    assert(table->addMaterial(glm::vec4(4.0f)) == first);
+
+    // A slot already on the free list cannot be removed again
+    table->removeMaterial(second);
+    threw = false;
+    try {
+        table->removeMaterial(second);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Textures keep their slot across re-registration and return it when destroyed
+    auto sampler = Sampler::createLinear(ctx.logicalDevice.get());
+    {
+        auto texture = Texture::createSolidColor(
+            ctx.logicalDevice.get(), ctx.commandPool.get(), 255, 255, 255, 255);
+        uint32_t index = texture->registerBindless(*table, sampler.get());
+        assert(table->textureCount() == 1);
+        assert(texture->registerBindless(*table, sampler.get()) == index);
+        assert(table->textureCount() == 1);
+    }
+    assert(table->textureCount() == 0);
+
+    // A slot removed by hand before destruction only warns, it doesn't throw from the destructor
+    {
+        auto texture = Texture::createSolidColor(
+            ctx.logicalDevice.get(), ctx.commandPool.get(), 0, 0, 0, 255);
+        table->removeTexture(texture->registerBindless(*table, sampler.get()));
+        assert(table->textureCount() == 0);
+    }
+    assert(table->textureCount() == 0);
+    table->releaseMaterial(second);  // Already free: warns
+
+    std::cout << "PASSED\n";
+}
+
 // ============================================================================
 // Mipmap Calculation Test
 // ============================================================================
 
+void test_texture_from_container() {
+    std::cout << "Test: Texture - From KTX2 container with baked mips... ";
+
+    auto container = TextureContainer::fromMemory(
+        make_test_ktx2(VK_FORMAT_R8G8B8A8_UNORM, 8, 8, 4));
+    auto texture = Texture::fromContainer(ctx.logicalDevice.get(), container, ctx.commandPool.get());
+
+    assert(texture != nullptr);
+    assert(texture->format() == VK_FORMAT_R8G8B8A8_UNORM);
+    assert(texture->width() == 8);
+    assert(texture->mipLevels() == 4);
+
+    // The device picks the first variant it can sample; RGBA8 always qualifies
+    VkFormat chosen = ctx.physicalDevice.selectSampledFormat(
+        {VK_FORMAT_UNDEFINED, VK_FORMAT_R8G8B8A8_UNORM});
+    assert(chosen == VK_FORMAT_R8G8B8A8_UNORM);
+
+    std::cout << "PASSED\n";
+}
+
+void test_mip_generator_requirements() {
+    std::cout << "Test: MipGenerator - Image requirements... ";
+
+    assert(MipGenerator::requiredFlags(VK_FORMAT_R8G8B8A8_SRGB) == VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT);
+    assert(MipGenerator::requiredFlags(VK_FORMAT_R8G8B8A8_UNORM) == 0);
+
+    // The compute shader is mandatory
+    bool threw = false;
+    try {
+        MipGenerator::create(ctx.logicalDevice.get()).build();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Per-level UNORM storage views of an sRGB image
+    auto image = Image::create(ctx.logicalDevice.get())
+        .extent(64, 64)
+        .format(VK_FORMAT_R8G8B8A8_SRGB)
+        .usage(VK_IMAGE_USAGE_SAMPLED_BIT | MipGenerator::RequiredUsage)
+        .flags(MipGenerator::requiredFlags(VK_FORMAT_R8G8B8A8_SRGB))
+        .mipLevels(calculateMipLevels(64, 64))
+        .build();
+    assert(image->mipLevels() == 7);
+    assert(image->flags() == VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT);
+    assert((image->usage() & VK_IMAGE_USAGE_STORAGE_BIT) != 0);
+
+    auto levelView = image->createView(VK_IMAGE_ASPECT_COLOR_BIT, 3, 1, VK_FORMAT_R8G8B8A8_UNORM);
+    assert(levelView != nullptr);
+
+    std::cout << "PASSED\n";
+}
+
+void test_virtual_texture() {
+    std::cout << "Test: VirtualTexture - Configuration and top-level page... ";
+
+    auto provider = [](const VirtualTexture::PageRequest& page, uint8_t* texels) {
+        std::memset(texels, static_cast<int>(page.level * 16), (128 + 8) * (128 + 8) * 4);
+        return true;
+    };
+
+    // Size must be the page size times a power of two
+    bool threw = false;
+    try {
+        VirtualTexture::create(ctx.logicalDevice.get())
+            .virtualSize(128 * 3)
+            .provider(provider)
+            .build();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    if (!ctx.logicalDevice->enabledFeatures().fragmentStoresAndAtomics) {
+        std::cout << "SKIPPED (no fragmentStoresAndAtomics)\n";
+        return;
+    }
+
+    auto vt = VirtualTexture::create(ctx.logicalDevice.get())
+        .virtualSize(128 * 64)
+        .pageSize(128, 4)
+        .cacheSlots(8, 8)
+        .provider(provider)
+        .build();
+    assert(vt->levelCount() == 7);
+    assert(vt->slotSize() == 136);
+    assert(vt->residentPages() == 1);
+    assert(vt->cache()->width() == 8 * 136);
+    assert(vt->indirection()->mipLevels() == 7);
+
+    // No feedback yet: nothing requested, the pinned page stays
+    {
+        auto imm = ctx.commandPool->beginImmediate();
+        vt->update(imm.cmd(), 0);
+    }
+    assert(vt->lastRequestCount() == 0);
+    assert(vt->residentPages() == 1);
+
+    std::cout << "PASSED\n";
+}
+
+void test_texture_array_and_atlas() {
+    std::cout << "Test: TextureArrayBuilder / TextureAtlasBuilder... ";
+
+    std::vector<uint8_t> red(16 * 16 * 4, 0), green(16 * 16 * 4, 0);
+    for (size_t i = 0; i < red.size(); i += 4) {
+        red[i] = 255;
+        green[i + 1] = 255;
+    }
+
+    TextureArrayBuilder layers(ctx.logicalDevice.get(), 16, 16);
+    assert(layers.add(red.data()) == 0);
+    assert(layers.add(green.data()) == 1);
+    auto array = layers.generateMipmaps().build(ctx.commandPool.get());
+    assert(array->layers() == 2);
+    assert(array->mipLevels() == 5);
+    assert(array->view() != nullptr);
+
+    // Mixed sizes; regions must not overlap, padding included
+    TextureAtlasBuilder atlas(ctx.logicalDevice.get(), 256);
+    std::vector<uint8_t> texels(64 * 32 * 4, 128);
+    uint32_t a = atlas.add(texels.data(), 64, 32);
+    uint32_t b = atlas.add(texels.data(), 16, 16);
+    uint32_t c = atlas.add(texels.data(), 30, 20);
+    auto atlasTexture = atlas.padding(2).build(ctx.commandPool.get());
+    assert(atlasTexture->width() == atlas.size());
+    assert(atlas.size() == 128);
+
+    uint32_t handles[] = {a, b, c};
+    for (uint32_t i : handles) {
+        const auto& r = atlas.region(i);
+        assert(r.x >= 2 && r.y >= 2);
+        assert(r.x + r.width + 2 <= atlas.size() && r.y + r.height + 2 <= atlas.size());
+        assert(r.uvMax[0] > r.uvMin[0] && r.uvMax[1] > r.uvMin[1]);
+        for (uint32_t j : handles) {
+            if (i == j) continue;
+            const auto& o = atlas.region(j);
+            bool apart = r.x + r.width + 2 <= o.x - 2 || o.x + o.width + 2 <= r.x - 2 ||
+                         r.y + r.height + 2 <= o.y - 2 || o.y + o.height + 2 <= r.y - 2;
+            assert(apart);
+        }
+    }
+
+    // Too large for the limit
+    TextureAtlasBuilder tiny(ctx.logicalDevice.get(), 32);
+    tiny.add(texels.data(), 64, 32);
+    bool threw = false;
+    try {
+        tiny.build(ctx.commandPool.get());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "PASSED\n";
+}
+
 void test_mip_level_calculation() {
     std::cout << "Test: calculateMipLevels... ";
 
@@ -605,6 +1524,523 @@ void test_simple_renderer_msaa() {
     std::cout << "PASSED\n";
 }
 
+void test_headless_renderer() {
+    std::cout << "Test: HeadlessRenderer - Frame ring... ";
+
+    auto renderer = HeadlessRenderer::create(ctx.logicalDevice, 64, 64);
+    assert(renderer->extent().width == 64 && renderer->extent().height == 64);
+    assert(renderer->renderPass() != nullptr);
+    assert(FormatUtils::hasDepth(renderer->depthFormat()));
+    assert(renderer->maxFramesInFlight() == ctx.logicalDevice->maxFramesInFlight());
+
+    // More frames than slots, so every slot is waited on and reused
+    uint32_t frames = renderer->framesInFlight() * 2 + 1;
+    for (uint32_t i = 0; i < frames; i++) {
+        auto result = renderer->beginFrame();
+        assert(result.success);
+        assert(result.commandBuffer != nullptr);
+        assert(result.imageIndex == i % renderer->framesInFlight());
+        assert(renderer->currentColorImage() == renderer->colorImage(result.imageIndex));
+
+        renderer->beginRenderPass({0.1f, 0.2f, 0.3f, 1.0f});
+        renderer->endRenderPass();
+        assert(renderer->endFrame());
+    }
+    assert(renderer->frameCount() == frames);
+    assert(!renderer->endFrame());  // No frame in progress
+
+    renderer->waitIdle();
+    assert(renderer->lastFrame().isComplete());
+
+    std::cout << "PASSED\n";
+}
+
+void test_image_readback() {
+    std::cout << "Test: ImageReadback - Async frame readback... ";
+
+    auto renderer = HeadlessRenderer::create(ctx.logicalDevice, 16, 8);
+    ImageReadback& readback = renderer->readback();
+    assert(readback.framesInFlight() == renderer->maxFramesInFlight());
+
+    // Whole image through a callback, one texel through a future
+    bool delivered = false;
+    auto frame = renderer->beginFrame();
+    renderer->beginRenderPass({1.0f, 0.0f, 0.0f, 1.0f});
+    renderer->endRenderPass();
+    readback.read(*frame.commandBuffer, *renderer->renderTarget(), [&](const ReadbackView& view) {
+        assert(view.extent.width == 16 && view.extent.height == 8);
+        assert(view.rowPitch == 16 * 4);
+        assert(view.size == 16 * 8 * 4);
+        for (VkDeviceSize i = 0; i < view.size; i += 4) {
+            assert(view.data[i] == 255 && view.data[i + 1] == 0 && view.data[i + 2] == 0 && view.data[i + 3] == 255);
+        }
+        delivered = true;
+    });
+    auto texel = readback.read(*frame.commandBuffer, *renderer->currentColorImage(),
+                               VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VkRect2D{{15, 7}, {4, 4}});
+    renderer->endFrame();
+    assert(readback.pendingCount() == 2);
+
+    // Delivered when the slot comes round again, after its fence was waited on
+    for (uint32_t i = 0; i < renderer->framesInFlight() && !delivered; i++) {
+        renderer->beginFrame();
+        renderer->endFrame();
+    }
+    assert(delivered);
+    ReadbackImage pixel = texel.get();
+    assert(pixel.extent.width == 1 && pixel.extent.height == 1);  // Clamped to the image
+    assert(pixel.pixels.size() == 4 && pixel.pixels[0] == 255 && pixel.pixels[1] == 0);
+
+    // Anything left over is handed out once the GPU is idle
+    frame = renderer->beginFrame();
+    renderer->beginRenderPass({0.0f, 0.0f, 1.0f, 1.0f});
+    renderer->endRenderPass();
+    auto last = readback.read(*frame.commandBuffer, *renderer->renderTarget());
+    renderer->endFrame();
+    renderer->waitIdle();
+    readback.deliverAll();
+    assert(readback.pendingCount() == 0);
+    ReadbackImage blue = last.get();
+    assert(blue.pixels[0] == 0 && blue.pixels[2] == 255);
+
+    std::cout << "PASSED\n";
+}
+
+// ============================================================================
+// Frustum Culling Tests (finevk-engine)
+// ============================================================================
+
+#if defined(FINEVK_TEST_ENGINE)
+// True if a box's positive vertex lies within epsilon of a plane, where the
+// kernels' different summation order may round either way
+bool onFrustumBoundary(const AABB& box, const std::array<glm::vec4, 6>& planes) {
+    for (const auto& plane : planes) {
+        glm::vec3 p = glm::mix(box.min, box.max, glm::greaterThanEqual(glm::vec3(plane), glm::vec3(0.0f)));
+        if (std::abs(glm::dot(glm::vec3(plane), p) + plane.w) < 1e-3f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void test_bounds_soa_matches_aabb() {
+    std::cout << "Test: BoundsSoA - SIMD cull matches AABB::intersectsFrustum ("
+              << BoundsSoA::simdPath() << ")... ";
+
+    std::mt19937 rng(20240611);
+    std::uniform_real_distribution<float> coord(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> extent(0.0f, 6.0f);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+
+    // Not a multiple of 8 or 64, so the padded tail and partial words are covered
+    constexpr size_t boxCount = 1003;
+    std::vector<AABB> boxes(boxCount);
+    BoundsSoA bounds;
+    bounds.resize(boxCount);
+    for (size_t i = 0; i < boxCount; i++) {
+        glm::vec3 center(coord(rng), coord(rng), coord(rng));
+        glm::vec3 half(extent(rng), extent(rng), extent(rng));
+        boxes[i] = AABB::fromCenterExtents(center, half);
+        bounds.set(i, boxes[i]);
+    }
+
+    std::vector<std::array<glm::vec4, 6>> frusta;
+    for (int f = 0; f < 64; f++) {
+        Camera camera;
+        if (f % 4 == 3) {
+            camera.setOrthographic(-30.0f, 30.0f, -20.0f, 20.0f, 0.1f, 80.0f);
+        } else {
+            camera.setPerspective(30.0f + 10.0f * (f % 7), 16.0f / 9.0f, 0.1f, 40.0f + f);
+        }
+        camera.moveTo(glm::vec3(coord(rng), coord(rng), coord(rng)) * 0.5f);
+        camera.rotate(angle(rng) * 0.5f, angle(rng), angle(rng) * 0.25f);
+        camera.updateState();
+        frusta.push_back(camera.state().frustumPlanes);
+    }
+
+    std::vector<uint64_t> mask;
+    for (const auto& planes : frusta) {
+        bounds.cull(planes, mask);
+        for (size_t i = 0; i < boxCount; i++) {
+            if (!onFrustumBoundary(boxes[i], planes)) {
+                assert(BoundsSoA::test(mask, i) == boxes[i].intersectsFrustum(planes));
+            }
+        }
+    }
+
+    // Ranged and multi-view passes agree with the same reference
+    std::vector<uint64_t> ranged((boxCount + 63) / 64, 0);
+    bounds.cull(frusta[0], ranged, 0, 512);
+    bounds.cull(frusta[0], ranged, 512, boxCount);
+    for (size_t i = 0; i < boxCount; i++) {
+        if (!onFrustumBoundary(boxes[i], frusta[0])) {
+            assert(BoundsSoA::test(ranged, i) == boxes[i].intersectsFrustum(frusta[0]));
+        }
+    }
+
+    std::vector<std::array<glm::vec4, 6>> views(frusta.begin(), frusta.begin() + BoundsSoA::MaxViews);
+    std::vector<uint64_t> anyMask;
+    std::vector<uint32_t> viewMasks;
+    bounds.cullViews(views, anyMask, viewMasks);
+    for (size_t i = 0; i < boxCount; i++) {
+        uint32_t expected = 0;
+        uint32_t checked = 0;  // Views where the box is clear of every plane
+        for (size_t v = 0; v < views.size(); v++) {
+            expected |= static_cast<uint32_t>(boxes[i].intersectsFrustum(views[v])) << v;
+            checked |= static_cast<uint32_t>(!onFrustumBoundary(boxes[i], views[v])) << v;
+        }
+        assert((viewMasks[i] & checked) == (expected & checked));
+        assert(BoundsSoA::test(anyMask, i) == (viewMasks[i] != 0));
+    }
+
+    std::cout << "PASSED\n";
+}
+
+// ============================================================================
+// DeferredDisposer Tests (finevk-engine, CPU only)
+// ============================================================================
+
+void test_deferred_disposer_delays() {
+    std::cout << "Test: DeferredDisposer - Frame delays, laps and conditions... ";
+
+    DeferredDisposer disposer;
+    disposer.setDefaultFrameDelay(2);
+    std::vector<int> ran;
+
+    // Delay 0 is ready before any frame passes
+    disposer.dispose([&ran]() { ran.push_back(0); }, 0);
+    assert(disposer.pendingCount() == 1);
+    assert(disposer.readyCount() == 1);
+    assert(disposer.tryDisposeOne());
+    assert(!disposer.tryDisposeOne());
+    assert(ran == std::vector<int>{0});
+
+    // Plain dispose() without a retire queue counts defaultFrameDelay() frames;
+    // 20 and 21 frames are beyond the bucket ring and are re-placed each lap
+    disposer.dispose([&ran]() { ran.push_back(2); });
+    disposer.dispose([&ran]() { ran.push_back(20); }, 20);
+    disposer.dispose([&ran]() { ran.push_back(21); }, 21);
+
+    // The condition is only polled past its delay, and runs once it holds
+    bool flag = false;
+    uint32_t polls = 0;
+    disposer.disposeWhen([&]() { polls++; return flag; }, [&ran]() { ran.push_back(-1); }, 3);
+
+    for (int frame = 1; frame <= 21; frame++) {
+        disposer.processFrame();
+        disposer.disposeReady();
+        if (frame < 3) {
+            assert(polls == 0);
+        }
+        if (frame == 9) {
+            assert(polls > 0);
+            flag = true;
+        }
+        switch (frame) {
+            case 1: assert(ran.size() == 1); break;
+            case 2: assert(ran.back() == 2); break;
+            case 10: assert(ran.back() == -1); break;
+            case 19: assert(ran.size() == 3); break;
+            case 20: assert(ran.back() == 20); break;
+            case 21: assert(ran.back() == 21); break;
+            default: break;
+        }
+    }
+    assert((ran == std::vector<int>{0, 2, -1, 20, 21}));
+    assert(disposer.pendingCount() == 0);
+
+    std::cout << "PASSED\n";
+}
+
+void test_deferred_disposer_concurrent() {
+    std::cout << "Test: DeferredDisposer - Concurrent producers... ";
+
+    DeferredDisposer disposer;
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 5000;
+    std::vector<std::atomic<int>> runs(kThreads * kPerThread);
+    std::atomic<int> executed{0};
+
+    // Producers queue while this thread keeps processing
+    std::atomic<int> producing{kThreads};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < kPerThread; i++) {
+                int id = t * kPerThread + i;
+                disposer.dispose([&runs, &executed, id]() { runs[id]++; executed++; },
+                                 static_cast<uint32_t>(id % 40));
+            }
+            producing--;
+        });
+    }
+    while (producing > 0) {
+        disposer.processFrame();
+        disposer.disposeReady();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(disposer.pendingCount() == static_cast<size_t>(kThreads * kPerThread - executed));
+
+    // 40 more frames retire the longest delays queued at the last frame
+    for (int frame = 0; frame < 41; frame++) {
+        disposer.processFrame();
+        disposer.disposeReady();
+    }
+    assert(disposer.pendingCount() == 0);
+    for (auto& count : runs) {
+        assert(count == 1);
+    }
+
+    std::cout << "PASSED\n";
+}
+
+void test_deferred_disposer_storage() {
+    std::cout << "Test: DeferredDisposer - Heap deleters, disposeAll and destruction... ";
+
+    // Deleters over the 48-byte inline buffer are kept on the heap
+    auto token = std::make_shared<int>(0);
+    {
+        DeferredDisposer disposer;
+        std::array<uint64_t, 16> big{};
+        big[15] = 7;
+        int sum = 0;
+        disposer.dispose([big, &sum]() { sum += static_cast<int>(big[15]); }, 0);
+        disposer.disposeReady();
+        assert(sum == 7);
+
+        // disposeAll() ignores delays and conditions
+        int forced = 0;
+        disposer.dispose([&forced]() { forced++; }, 100);
+        disposer.dispose([&forced, big]() { forced += static_cast<int>(big[15]); }, 5);
+        disposer.disposeWhen([]() { return false; }, [&forced]() { forced++; });
+        disposer.dispose([&forced]() { forced++; });
+        assert(disposer.pendingCount() == 4);
+        disposer.disposeAll();
+        assert(forced == 10);
+        assert(disposer.pendingCount() == 0);
+
+        // The destructor releases captures (inline and heap) without running them
+        disposer.dispose([token]() { *token = 1; }, 100);
+        disposer.dispose([token, big]() { *token = 2; }, 100);
+        disposer.dispose([token]() { *token = 3; }, 0);
+        assert(token.use_count() == 4);
+    }
+    assert(token.use_count() == 1);
+    assert(*token == 0);
+
+    std::cout << "PASSED\n";
+}
+
+// ============================================================================
+// JobSystem Tests (finevk-engine, CPU only)
+// ============================================================================
+
+void test_job_system_parallel_for() {
+    std::cout << "Test: JobSystem - parallelFor chunk coverage and nesting... ";
+
+    JobSystem jobs(3);
+
+    // Every index once, chunks dense from 0 and grain-aligned
+    constexpr size_t kCount = 10007;
+    constexpr size_t kGrain = 64;
+    std::vector<std::atomic<int>> visits(kCount);
+    std::vector<std::atomic<int>> chunkVisits(JobSystem::chunkCount(kCount, kGrain));
+    uint32_t chunks = jobs.parallelFor(kCount, kGrain, [&](size_t begin, size_t end, uint32_t chunk) {
+        assert(chunk < chunkVisits.size());
+        assert(begin == chunk * kGrain && end == std::min(kCount, begin + kGrain));
+        chunkVisits[chunk]++;
+        for (size_t i = begin; i < end; i++) {
+            visits[i]++;
+        }
+    });
+    assert(chunks == JobSystem::chunkCount(kCount, kGrain));
+    for (auto& count : visits) {
+        assert(count == 1);
+    }
+    for (auto& count : chunkVisits) {
+        assert(count == 1);
+    }
+    assert(jobs.parallelFor(0, kGrain, [](size_t, size_t, uint32_t) { assert(false); }) == 0);
+
+    // parallelFor from inside chunks, which run on workers as well as here
+    std::atomic<size_t> total{0};
+    jobs.parallelFor(16, 1, [&](size_t, size_t, uint32_t) {
+        uint32_t inner = jobs.parallelFor(1000, 10, [&](size_t begin, size_t end, uint32_t) {
+            total += end - begin;
+        });
+        assert(inner == 100);
+    });
+    assert(total == 16 * 1000);
+
+    std::cout << "PASSED\n";
+}
+
+void test_job_system_exceptions() {
+    std::cout << "Test: JobSystem - Chunk exceptions rethrown after all chunks... ";
+
+    JobSystem jobs(3);
+    constexpr uint32_t kChunks = 32;
+
+    // Chunk 0 runs on the calling thread, the others come from the queues
+    for (uint32_t throwing : {0u, kChunks - 1}) {
+        std::atomic<uint32_t> finished{0};
+        bool caught = false;
+        try {
+            jobs.parallelFor(kChunks, 1, [&](size_t, size_t, uint32_t chunk) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                if (chunk == throwing) {
+                    throw std::runtime_error("chunk failed");
+                }
+                finished++;
+            });
+        } catch (const std::runtime_error& e) {
+            caught = std::string(e.what()) == "chunk failed";
+        }
+        assert(caught);
+        assert(finished == kChunks - 1);
+    }
+
+    // The system stays usable afterwards
+    std::atomic<uint32_t> after{0};
+    jobs.parallelFor(kChunks, 1, [&](size_t, size_t, uint32_t) { after++; });
+    assert(after == kChunks);
+
+    std::cout << "PASSED\n";
+}
+
+void test_job_system_shutdown() {
+    std::cout << "Test: JobSystem - Destruction finishes queued work... ";
+
+    std::atomic<uint32_t> ran{0};
+    {
+        JobSystem jobs(2);
+        for (uint32_t i = 0; i < 1000; i++) {
+            jobs.run([&ran, &jobs, i]() {
+                // Some jobs queue follow-ups while the system is stopping
+                if (i % 100 == 0) {
+                    jobs.run([&ran]() { ran++; });
+                }
+                ran++;
+            });
+        }
+    }
+    assert(ran == 1010);
+
+    std::cout << "PASSED\n";
+}
+
+// ============================================================================
+// Radix Sort Tests (finevk-engine, CPU only)
+// ============================================================================
+
+void test_radix_sort() {
+    std::cout << "Test: radixSort - Stability, float keys and skipped passes... ";
+
+    std::mt19937 rng(1234);
+    std::vector<SortItem<uint32_t>> items;
+    std::vector<SortItem<uint32_t>> scratch;
+
+    auto sortedStably = [](const std::vector<SortItem<uint32_t>>& sorted,
+                           std::vector<SortItem<uint32_t>> input) {
+        std::stable_sort(input.begin(), input.end(),
+            [](const SortItem<uint32_t>& a, const SortItem<uint32_t>& b) { return a.key < b.key; });
+        for (size_t i = 0; i < input.size(); i++) {
+            if (sorted[i].key != input[i].key || sorted[i].value != input[i].value) {
+                return false;
+            }
+        }
+        return sorted.size() == input.size();
+    };
+
+    // Many equal keys spread over all four bytes; values record input order
+    for (uint32_t i = 0; i < 5000; i++) {
+        auto r = static_cast<uint32_t>(rng());
+        items.push_back({((r & 7u) << 24) | ((r >> 3) & 3u) << 8 | ((r >> 5) & 1u), i});
+    }
+    auto input = items;
+    radixSort(items, scratch);
+    assert(sortedStably(items, input));
+
+    // Negative and positive floats order like the floats themselves
+    std::vector<float> floats = {-1e30f, -1000.0f, -1.5f, -0.0f, 0.0f, 1e-30f, 2.5f, 1e30f,
+                                 -std::numeric_limits<float>::infinity(),
+                                 std::numeric_limits<float>::infinity()};
+    std::uniform_real_distribution<float> distribution(-1e4f, 1e4f);
+    for (int i = 0; i < 1000; i++) {
+        floats.push_back(distribution(rng));
+    }
+    items.clear();
+    for (uint32_t i = 0; i < floats.size(); i++) {
+        items.push_back({sortableFloatBits(floats[i]), i});
+    }
+    radixSort(items, scratch);
+    for (size_t i = 1; i < items.size(); i++) {
+        assert(floats[items[i - 1].value] <= floats[items[i].value]);
+    }
+    assert(sortableFloatBits(-0.0f) < sortableFloatBits(0.0f));
+
+    // Keys sharing bytes 0, 2 and 3 take one scatter pass, so the result
+    // lands in scratch and must be swapped back; then three passes (byte 2 shared)
+    for (uint32_t varying : {0x0000FF00u, 0xFF00FFFFu}) {
+        items.clear();
+        for (uint32_t i = 0; i < 3000; i++) {
+            items.push_back({(static_cast<uint32_t>(rng()) & varying) | (0x12345678u & ~varying), i});
+        }
+        input = items;
+        radixSort(items, scratch);
+        assert(sortedStably(items, input));
+    }
+
+    // Every byte shared: nothing moves
+    items.assign(100, SortItem<uint32_t>{0xABCDEF01u, 0});
+    for (uint32_t i = 0; i < items.size(); i++) {
+        items[i].value = i;
+    }
+    radixSort(items, scratch);
+    for (uint32_t i = 0; i < items.size(); i++) {
+        assert(items[i].value == i);
+    }
+
+    std::cout << "PASSED\n";
+}
+
+void test_insertion_sort_bounded() {
+    std::cout << "Test: insertionSortBounded - Move budget... ";
+
+    // Nearly sorted input fits the budget and sorts stably
+    std::vector<SortItem<uint32_t>> items;
+    for (uint32_t i = 0; i < 100; i++) {
+        items.push_back({i / 2, i});
+    }
+    std::swap(items[10], items[11]);
+    std::swap(items[50], items[53]);
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(),
+        [](const SortItem<uint32_t>& a, const SortItem<uint32_t>& b) { return a.key < b.key; });
+    assert(insertionSortBounded(items, 16));
+    for (size_t i = 0; i < items.size(); i++) {
+        assert(items[i].key == expected[i].key && items[i].value == expected[i].value);
+    }
+
+    // Reversed input exceeds it: false, with every item still present once
+    items.clear();
+    for (uint32_t i = 0; i < 100; i++) {
+        items.push_back({100 - i, i});
+    }
+    assert(!insertionSortBounded(items, 50));
+    std::vector<bool> seen(100, false);
+    for (const auto& item : items) {
+        assert(item.value < 100 && !seen[item.value]);
+        assert(item.key == 100 - item.value);
+        seen[item.value] = true;
+    }
+
+    std::cout << "PASSED\n";
+}
+#endif
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -635,9 +2071,12 @@ int main() {
         test_format_utils_bytes_per_pixel(); passed++;
         test_format_utils_aspect_flags(); passed++;
         test_format_utils_component_count(); passed++;
+        test_format_utils_block_sizes(); passed++;
+        test_texture_container_parsing(); passed++;
 
         // Vertex tests
         test_vertex_stride(); passed++;
+        test_vertex_compact_encodings(); passed++;
         test_vertex_binding_description(); passed++;
         test_vertex_attribute_descriptions(); passed++;
         test_vertex_equality(); passed++;
@@ -646,6 +2085,11 @@ int main() {
         test_mesh_builder_basic(); passed++;
         test_mesh_builder_quad(); passed++;
         test_mesh_builder_deduplication(); passed++;
+        test_mesh_cache(); passed++;
+        test_asset_pack(); passed++;
+        test_mesh_optimizer(); passed++;
+        test_mesh_lods(); passed++;
+        test_mesh_meshlets(); passed++;
         test_mesh_builder_bounds(); passed++;
 
         // Texture tests
@@ -656,11 +2100,39 @@ int main() {
         // UniformBuffer tests
         test_uniform_buffer_creation(); passed++;
         test_uniform_buffer_update(); passed++;
+        test_uniform_buffer_versioned_update(); passed++;
         test_uniform_buffer_common_types(); passed++;
+        test_uniform_ring(); passed++;
+        test_bindless_table(); passed++;
+        test_texture_streamer(); passed++;
+        test_asset_loader(); passed++;
+        test_texture_from_container(); passed++;
+        test_mip_generator_requirements(); passed++;
+        test_virtual_texture(); passed++;
+        test_texture_array_and_atlas(); passed++;
 
         // Mipmap calculation test
         test_mip_level_calculation(); passed++;
 
+#if defined(FINEVK_TEST_ENGINE)
+        // Frustum culling tests
+        test_bounds_soa_matches_aabb(); passed++;
+
+        // DeferredDisposer tests
+        test_deferred_disposer_delays(); passed++;
+        test_deferred_disposer_concurrent(); passed++;
+        test_deferred_disposer_storage(); passed++;
+
+        // JobSystem tests
+        test_job_system_parallel_for(); passed++;
+        test_job_system_exceptions(); passed++;
+        test_job_system_shutdown(); passed++;
+
+        // Radix sort tests
+        test_radix_sort(); passed++;
+        test_insertion_sort_bounded(); passed++;
+#endif
+
         // SimpleRenderer tests (need fresh surface)
         cleanup_test_context();
         setup_test_context();
@@ -679,6 +2151,11 @@ int main() {
         test_simple_renderer_msaa(); passed++;
 
         cleanup_test_context();
+        setup_test_context();
+        test_headless_renderer(); passed++;
+        test_image_readback(); passed++;
+
+        cleanup_test_context();
 
     } catch (const std::exception& e) {
         std::cerr << "\nEXCEPTION: " << e.what() << "\n";